@@ -0,0 +1,336 @@
+// Replays IMU traces through the tracker. Every trace runs through the float SensorFusionEkf the
+// app uses and the double instantiation (CARDBOARD_INSTANTIATE_DOUBLE) side by side: compares
+// their orientations with each other and, for the synthetic traces, the tilt with the true one,
+// and times both per update. Then the trace plays through a simulated IMU FIFO (stub/host_imu.cc)
+// into the app's tracking loop (main_loop.cc), which reports how old each sample is when the
+// cursor move it goes into is sent.
+//
+//   make -C airmouse/test run
+//   ./imu_replay trace.txt ...   replays recorded traces instead, one sample per line:
+//                                t_ns ax ay az gx gy gz (m/s^2 and rad/s, sensor axes)
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include <furi.h>
+
+#include "main_loop.h"
+#include "sensors/sensor_fusion_ekf.h"
+#include "host_imu.h"
+
+using namespace cardboard;
+
+#define RATE_HZ 400 // BMI160 output data rate
+#define PERIOD_NS (1000000000ull / RATE_HZ)
+#define WARMUP_NS 2000000000ull // the filter settling from its initial state
+#define LOOP_DELAY_MS 3 // the mouse views' loop around tracking_step()
+// now and then sending the move takes a while, e.g. waiting for a Bluetooth connection event
+#define STALL_EVERY 50
+#define STALL_MS 40
+
+#define MAX_FLOAT_ERROR_DEG 0.5
+#define MAX_TILT_ERROR_DEG 3.0
+// the oldest sample of a batch waits for the watermark, then for the loop to come round
+#define MAX_LATENCY_NS \
+    (IMU_FIFO_WATERMARK * PERIOD_NS + (LOOP_DELAY_MS + STALL_MS) * 1000000ull)
+#define CURSOR_PER_QUARTER_TURN 1024 // CURSOR_SPEED in main_loop.cc
+#define FLICKS 30
+
+struct Trace {
+    std::string name;
+    std::vector<HostImuSample> samples;
+    std::vector<Vector<4, double>> truth; // sensor from world, empty for recorded traces
+    int32_t cursor_travel; // horizontal, -1 if not known
+};
+
+static uint32_t failures;
+
+static void fail(const char* what) {
+    printf("FAIL %s\n", what);
+    failures++;
+}
+
+static Vector<4, double> quat_mul(const Vector<4, double>& a, const Vector<4, double>& b) {
+    return Vector<4, double>(
+        a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1],
+        a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0],
+        a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3],
+        a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2]);
+}
+
+static Vector<4, double> quat_conj(const Vector<4, double>& q) {
+    return Vector<4, double>(-q[0], -q[1], -q[2], q[3]);
+}
+
+static Vector<3, double> quat_rotate(const Vector<4, double>& q, const Vector<3, double>& v) {
+    Vector<4, double> r = quat_mul(quat_mul(q, Vector<4, double>(v[0], v[1], v[2], 0)), quat_conj(q));
+    return Vector<3, double>(r[0], r[1], r[2]);
+}
+
+static double quat_angle_deg(const Vector<4, double>& a, const Vector<4, double>& b) {
+    double dot = std::fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+    return 2 * std::acos(std::min(1.0, dot)) * 180 / M_PI;
+}
+
+// angle between the up directions, in the sensor frame, of two sensor from world rotations
+static double tilt_deg(const Vector<4, double>& a, const Vector<4, double>& b) {
+    Vector<3, double> up_a = quat_rotate(a, Vector<3, double>(0, 0, 1));
+    Vector<3, double> up_b = quat_rotate(b, Vector<3, double>(0, 0, 1));
+    double dot = up_a[0] * up_b[0] + up_a[1] * up_b[1] + up_a[2] * up_b[2];
+    return std::acos(std::max(-1.0, std::min(1.0, dot))) * 180 / M_PI;
+}
+
+// Integrates an angular velocity profile (rad/s in sensor axes) into a trace with noisy gyro and
+// accelerometer readings, the gyro offset by a constant bias
+template <typename Profile>
+static Trace
+    synthesize(const char* name, double seconds, double bias, int32_t travel, Profile profile) {
+    Trace trace = {name, {}, {}, travel};
+    std::mt19937 rng(1);
+    std::normal_distribution<double> noise(0, 1);
+    Vector<4, double> q(0, 0, 0, 1);
+
+    for (uint64_t i = 0; i < seconds * RATE_HZ; i++) {
+        double s = (double)i / RATE_HZ;
+        Vector<3, double> w = profile(s);
+        double half = std::sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]) / RATE_HZ / 2;
+        double k = half > 0 ? std::sin(half) / half / RATE_HZ / 2 : 0;
+        q = quat_mul(q, Vector<4, double>(w[0] * k, w[1] * k, w[2] * k, std::cos(half)));
+
+        Vector<3, double> g = quat_rotate(quat_conj(q), Vector<3, double>(0, 0, 9.81));
+        HostImuSample sample;
+        sample.t_ns = i * PERIOD_NS;
+        for (int axis = 0; axis < 3; axis++) {
+            sample.acc[axis] = g[axis] + 0.1 * noise(rng);
+            sample.gyr[axis] = w[axis] + bias + 0.01 * noise(rng);
+        }
+        trace.samples.push_back(sample);
+        trace.truth.push_back(quat_conj(q));
+    }
+    return trace;
+}
+
+static std::vector<Trace> synthetic_traces(void) {
+    std::vector<Trace> traces;
+    traces.push_back(
+        synthesize("rest", 30, 0.01, 0, [](double) { return Vector<3, double>(0, 0, 0); }));
+    traces.push_back(synthesize("wave", 120, 0, -1, [](double s) {
+        return Vector<3, double>(0.8 * std::sin(s), 0.5 * std::cos(0.7 * s), 0.3 * std::sin(1.3 * s));
+    }));
+    // a quarter turn in 0.3 s every 2 s, back and forth
+    traces.push_back(synthesize("flicks", FLICKS * 2, 0, FLICKS * CURSOR_PER_QUARTER_TURN, [](double s) {
+        double phase = std::fmod(s, 2);
+        double rate = phase < 0.3 ? M_PI / 4 / 0.3 * M_PI / 2 * std::sin(phase / 0.3 * M_PI) : 0;
+        return Vector<3, double>(0, 0, std::fmod(s, 4) < 2 ? rate : -rate);
+    }));
+    return traces;
+}
+
+static bool load_trace(const char* path, Trace* trace) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    trace->name = path;
+    trace->cursor_travel = -1;
+    HostImuSample sample;
+    unsigned long long t;
+    while (fscanf(
+              file,
+              "%llu %f %f %f %f %f %f",
+              &t,
+              &sample.acc[0],
+              &sample.acc[1],
+              &sample.acc[2],
+              &sample.gyr[0],
+              &sample.gyr[1],
+              &sample.gyr[2]) == 7) {
+        sample.t_ns = t - (trace->samples.empty() ? t : trace->samples[0].t_ns);
+        trace->samples.push_back(sample);
+    }
+    fclose(file);
+    return !trace->samples.empty();
+}
+
+template <typename T>
+struct Filter {
+    SensorFusionEkfT<T> ekf;
+    double seconds = 0;
+
+    Filter() {
+        ekf.SetBiasEstimationEnabled(true);
+    }
+
+    Vector<4, double> step(const HostImuSample& sample) {
+        AccelerometerDataT<T> acc = {
+            .system_timestamp = sample.t_ns,
+            .sensor_timestamp_ns = sample.t_ns,
+            .data = Vector<3, T>(sample.acc[0], sample.acc[1], sample.acc[2])};
+        GyroscopeDataT<T> gyr = {
+            .system_timestamp = sample.t_ns,
+            .sensor_timestamp_ns = sample.t_ns,
+            .data = Vector<3, T>(sample.gyr[0], sample.gyr[1], sample.gyr[2])};
+
+        auto start = std::chrono::steady_clock::now();
+        ekf.ProcessAccelerometerSample(acc);
+        ekf.ProcessGyroscopeSample(gyr);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        Vector<4, T> q = ekf.GetLatestPoseState().sensor_from_start_rotation.GetQuaternion();
+        return Vector<4, double>(q[0], q[1], q[2], q[3]);
+    }
+};
+
+static void compare_filters(const Trace& trace) {
+    Filter<float> single;
+    Filter<double> precise;
+    double max_error = 0, sum_error = 0, tilt_single = 0, tilt_precise = 0;
+    uint32_t compared = 0;
+
+    for (size_t i = 0; i < trace.samples.size(); i++) {
+        Vector<4, double> q_single = single.step(trace.samples[i]);
+        Vector<4, double> q_precise = precise.step(trace.samples[i]);
+        if (trace.samples[i].t_ns < WARMUP_NS) continue;
+
+        double error = quat_angle_deg(q_single, q_precise);
+        max_error = std::max(max_error, error);
+        sum_error += error;
+        compared++;
+        if (!trace.truth.empty()) {
+            tilt_single = std::max(tilt_single, tilt_deg(q_single, trace.truth[i]));
+            tilt_precise = std::max(tilt_precise, tilt_deg(q_precise, trace.truth[i]));
+        }
+    }
+
+    printf(
+        "%-8s %7zu %9.4f %9.4f %7.2f %7.2f %8.0f %8.0f\n",
+        trace.name.c_str(),
+        trace.samples.size(),
+        max_error,
+        compared ? sum_error / compared : 0,
+        tilt_single,
+        tilt_precise,
+        single.seconds / trace.samples.size() * 1e9,
+        precise.seconds / trace.samples.size() * 1e9);
+
+    if (max_error > MAX_FLOAT_ERROR_DEG) fail("float orientation differs from double");
+    if (tilt_single > MAX_TILT_ERROR_DEG) fail("float tilt error");
+}
+
+struct Cursor {
+    uint32_t moves;
+    uint32_t samples;
+    double latency_ns;
+    double max_latency_ns;
+    int32_t x;
+    int32_t y;
+    int32_t travel_x;
+    int32_t travel_y;
+};
+
+static bool mouse_move(int8_t x, int8_t y, void* context) {
+    Cursor* cursor = (Cursor*)context;
+    cursor->moves++;
+    for (uint64_t t : host_imu_batch) {
+        double latency = host_now_ns - t;
+        cursor->samples++;
+        cursor->latency_ns += latency;
+        cursor->max_latency_ns = std::max(cursor->max_latency_ns, latency);
+    }
+    cursor->x += x;
+    cursor->y += y;
+    cursor->travel_x += std::abs(x);
+    cursor->travel_y += std::abs(y);
+    return true;
+}
+
+static void run_tracking(const Trace& trace) {
+    Cursor cursor = {};
+    host_imu_play(trace.samples);
+    tracking_begin();
+    const uint64_t end = host_now_ns + trace.samples.back().t_ns + 100000000ull;
+    for (uint32_t step = 1; host_now_ns < end; step++) {
+        tracking_step(mouse_move, &cursor);
+        furi_delay_ms(step % STALL_EVERY ? LOOP_DELAY_MS : STALL_MS);
+    }
+    tracking_end();
+
+    double mean_ms = cursor.samples ? cursor.latency_ns / cursor.samples / 1e6 : 0;
+    printf(
+        "%-8s %7u %7u %7.2f %7.2f %7d %7d %8d %8d\n",
+        trace.name.c_str(),
+        host_imu_delivered,
+        cursor.moves,
+        mean_ms,
+        cursor.max_latency_ns / 1e6,
+        cursor.x,
+        cursor.y,
+        cursor.travel_x,
+        cursor.travel_y);
+
+    if (trace.samples.size() - host_imu_delivered >= IMU_FIFO_WATERMARK) fail("samples not read");
+    if (cursor.max_latency_ns > MAX_LATENCY_NS) fail("latency");
+    if (trace.cursor_travel >= 0 &&
+       std::abs(cursor.travel_x - trace.cursor_travel) > 64 + trace.cursor_travel / 10) {
+        fail("cursor travel");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<Trace> traces;
+    for (int i = 1; i < argc; i++) {
+        Trace trace;
+        if (!load_trace(argv[i], &trace)) {
+            printf("cannot read %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+        traces.push_back(trace);
+    }
+    if (traces.empty()) traces = synthetic_traces();
+
+    printf("float vs double EKF, after %.0f s, errors in degrees:\n", WARMUP_NS / 1e9);
+    printf(
+        "%-8s %7s %9s %9s %7s %7s %8s %8s\n",
+        "trace",
+        "samples",
+        "max diff",
+        "mean diff",
+        "tilt f",
+        "tilt d",
+        "ns f",
+        "ns d");
+    for (const Trace& trace : traces) {
+        compare_filters(trace);
+    }
+
+    printf(
+        "\ntracking loop, %u Hz FIFO with a watermark of %u, %u ms loop delay, every %uth %u ms:\n",
+        RATE_HZ,
+        IMU_FIFO_WATERMARK,
+        LOOP_DELAY_MS,
+        STALL_EVERY,
+        STALL_MS);
+    printf(
+        "%-8s %7s %7s %7s %7s %7s %7s %8s %8s\n",
+        "trace",
+        "samples",
+        "moves",
+        "mean ms",
+        "max ms",
+        "x",
+        "y",
+        "travel x",
+        "travel y");
+    for (const Trace& trace : traces) {
+        run_tracking(trace);
+    }
+
+    if (failures) {
+        printf("FAILED: %u checks\n", failures);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
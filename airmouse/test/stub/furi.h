@@ -0,0 +1,19 @@
+#pragma once
+
+// Just enough of the Furi API to build the tracker on the host, see host_imu.cc
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#define UNUSED(x) (void)(x)
+
+#define FURI_LOG_I(tag, format, ...)          \
+    do {                                      \
+        UNUSED(tag);                          \
+        if (0) printf(format, ##__VA_ARGS__); \
+    } while (0)
+#define FURI_LOG_E FURI_LOG_I
+
+void furi_delay_ms(uint32_t ms);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <furi.h>
+
+// The cycle counter follows the simulated clock, see host_imu.h
+typedef struct {
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern DWT_Type host_dwt;
+#define DWT (&host_dwt)
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
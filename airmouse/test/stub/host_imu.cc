@@ -0,0 +1,67 @@
+#include <furi_hal.h>
+
+#include "host_imu.h"
+
+DWT_Type host_dwt;
+uint64_t host_now_ns;
+std::vector<uint64_t> host_imu_batch;
+uint32_t host_imu_delivered;
+
+static const std::vector<HostImuSample>* trace;
+static size_t next;
+static uint64_t start_ns;
+
+void host_advance(uint64_t ns) {
+    host_now_ns += ns;
+    host_dwt.CYCCNT = (uint32_t)(host_now_ns * HOST_CPU_MHZ / 1000);
+}
+
+void furi_delay_ms(uint32_t ms) {
+    host_advance((uint64_t)ms * 1000000);
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return HOST_CPU_MHZ;
+}
+
+void host_imu_play(const std::vector<HostImuSample>& samples) {
+    trace = &samples;
+    next = 0;
+    start_ns = host_now_ns;
+    host_imu_batch.clear();
+    host_imu_delivered = 0;
+}
+
+bool host_imu_done(void) {
+    return !trace || next == trace->size();
+}
+
+int imu_read(double* vec) {
+    UNUSED(vec);
+    return 0;
+}
+
+int imu_read_fifo(ImuSample* samples, int max_samples) {
+    host_imu_batch.clear();
+    if (!trace) return 0;
+
+    size_t available = next;
+    while (available < trace->size() && start_ns + (*trace)[available].t_ns <= host_now_ns) {
+        available++;
+    }
+    available -= next;
+    if (available < IMU_FIFO_WATERMARK) return 0;
+
+    int count = std::min<size_t>(available, max_samples);
+    for (int i = 0; i < count; i++) {
+        const HostImuSample& sample = (*trace)[next++];
+        const uint64_t t = start_ns + sample.t_ns;
+        samples[i].flags = ACC_DATA_READY | GYR_DATA_READY;
+        samples[i].age_ns = host_now_ns - t;
+        std::copy(sample.acc, sample.acc + 3, samples[i].acc);
+        std::copy(sample.gyr, sample.gyr + 3, samples[i].gyr);
+        host_imu_batch.push_back(t);
+    }
+    host_imu_delivered += count;
+    return count;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// A simulated IMU playing back a trace through imu_read_fifo(), on a simulated clock
+
+#include <cstdint>
+#include <vector>
+
+#include "imu/imu.h"
+
+#define HOST_CPU_MHZ 64
+
+struct HostImuSample {
+    uint64_t t_ns;
+    float acc[3];
+    float gyr[3];
+};
+
+// Simulated time, furi_delay_ms() and host_advance() move it and DWT->CYCCNT along
+extern uint64_t host_now_ns;
+void host_advance(uint64_t ns);
+
+// Samples enter the FIFO at their timestamps, relative to the current time
+void host_imu_play(const std::vector<HostImuSample>& trace);
+bool host_imu_done(void);
+
+// Timestamps of the samples the last imu_read_fifo() returned, and of all returned so far
+extern std::vector<uint64_t> host_imu_batch;
+extern uint32_t host_imu_delivered;
@@ -0,0 +1,3 @@
+#pragma once
+
+#define EXT_PATH(path) "/ext/" path
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <furi.h>
+
+// No calibration is stored on the host, the tracker starts from a zero gyro offset
+static inline bool saved_struct_load(
+    const char* path,
+    void* data,
+    size_t size,
+    uint8_t magic,
+    uint8_t version) {
+    UNUSED(path);
+    UNUSED(data);
+    UNUSED(size);
+    UNUSED(magic);
+    UNUSED(version);
+    return false;
+}
+
+static inline bool saved_struct_save(
+    const char* path,
+    void* data,
+    size_t size,
+    uint8_t magic,
+    uint8_t version) {
+    UNUSED(path);
+    UNUSED(data);
+    UNUSED(size);
+    UNUSED(magic);
+    UNUSED(version);
+    return true;
+}
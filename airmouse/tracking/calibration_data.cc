@@ -75,11 +75,14 @@ void CalibrationData::calcDelta()
 
     FURI_LOG_I(TAG,
         "M[x] = { %f ... %f }  //  median = %f  //  avg = %f  //  delta = %f  //  sigma = %f",
-        low[0], high[0], median[0], mean[0], delta[0], sigma[0]);
+        (double)low[0], (double)high[0], (double)median[0], (double)mean[0],
+        (double)delta[0], (double)sigma[0]);
     FURI_LOG_I(TAG,
         "M[y] = { %f ... %f }  //  median = %f  //  avg = %f  //  delta = %f  //  sigma = %f",
-        low[1], high[1], median[1], mean[1], delta[1], sigma[1]);
+        (double)low[1], (double)high[1], (double)median[1], (double)mean[1],
+        (double)delta[1], (double)sigma[1]);
     FURI_LOG_I(TAG,
         "M[z] = { %f ... %f }  //  median = %f  //  avg = %f  //  delta = %f  //  sigma = %f",
-        low[2], high[2], median[2], mean[2], delta[2], sigma[2]);
+        (double)low[2], (double)high[2], (double)median[2], (double)mean[2],
+        (double)delta[2], (double)sigma[2]);
 }
\ No newline at end of file
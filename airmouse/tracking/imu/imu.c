@@ -3,10 +3,12 @@
 
 bool bmi160_begin();
 int bmi160_read(double* vec);
+int bmi160_read_fifo(ImuSample* samples, int max_samples);
 
 bool lsm6ds3trc_begin();
 void lsm6ds3trc_end();
 int lsm6ds3trc_read(double* vec);
+int lsm6ds3trc_read_fifo(ImuSample* samples, int max_samples);
 
 bool imu_begin() {
     furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
@@ -27,3 +29,10 @@ int imu_read(double* vec) {
     furi_hal_i2c_release(&furi_hal_i2c_handle_external);
     return ret;
 }
+
+int imu_read_fifo(ImuSample* samples, int max_samples) {
+    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
+    int ret = bmi160_read_fifo(samples, max_samples); // lsm6ds3trc_read_fifo(...);
+    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
+    return ret;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -9,10 +10,26 @@ extern "C" {
 #define ACC_DATA_READY (1 << 0)
 #define GYR_DATA_READY (1 << 1)
 
+// Number of samples the IMU FIFO collects before imu_read_fifo() returns them.
+#define IMU_FIFO_WATERMARK 4
+// Maximum number of samples returned by a single imu_read_fifo() call.
+#define IMU_FIFO_MAX_SAMPLES 16
+
+typedef struct {
+    int flags; // ACC_DATA_READY and/or GYR_DATA_READY
+    uint32_t age_ns; // Time elapsed between the sample and the end of the read
+    float acc[3]; // Same axes and units as imu_read() vec[0..2]
+    float gyr[3]; // Same axes and units as imu_read() vec[3..5], rad/s
+} ImuSample;
+
 bool imu_begin();
 void imu_end();
 int imu_read(double* vec);
 
+// Drains up to max_samples samples from the IMU FIFO, oldest first. Returns 0
+// until the FIFO has reached the watermark, so each call processes a batch.
+int imu_read_fifo(ImuSample* samples, int max_samples);
+
 #ifdef __cplusplus
 }
 #endif
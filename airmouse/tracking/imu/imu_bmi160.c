@@ -8,6 +8,10 @@
 
 #define BMI160_DEV_ADDR (0x69 << 1)
 
+// Header-less FIFO frame with gyro and accel enabled: gyro x/y/z then accel x/y/z.
+#define BMI160_FIFO_FRAME_SIZE BMI160_FIFO_GA_LENGTH
+#define BMI160_SAMPLE_PERIOD_NS 2500000 // 400 Hz
+
 static const double DEG_TO_RAD = 0.017453292519943295769236907684886;
 static const double G = 9.81;
 
@@ -15,6 +19,11 @@ struct bmi160_dev bmi160dev;
 struct bmi160_sensor_data bmi160_accel;
 struct bmi160_sensor_data bmi160_gyro;
 
+uint8_t bmi160_fifo_buffer[IMU_FIFO_MAX_SAMPLES * BMI160_FIFO_FRAME_SIZE];
+struct bmi160_fifo_frame bmi160_fifo;
+struct bmi160_sensor_data bmi160_fifo_accel[IMU_FIFO_MAX_SAMPLES];
+struct bmi160_sensor_data bmi160_fifo_gyro[IMU_FIFO_MAX_SAMPLES];
+
 int8_t bmi160_write_i2c(uint8_t dev_addr, uint8_t reg_addr, uint8_t* data, uint16_t len) {
     if(furi_hal_i2c_write_mem(&furi_hal_i2c_handle_external, dev_addr, reg_addr, data, len, 50))
         return BMI160_OK;
@@ -64,6 +73,19 @@ bool bmi160_begin() {
         return false;
     }
 
+    // Header-less FIFO of accel and gyro frames, the watermark is in units of 4 bytes.
+    bmi160_fifo.data = bmi160_fifo_buffer;
+    bmi160dev.fifo = &bmi160_fifo;
+    if(bmi160_set_fifo_config(BMI160_FIFO_HEADER, BMI160_DISABLE, &bmi160dev) != BMI160_OK ||
+       bmi160_set_fifo_config(BMI160_FIFO_GYRO | BMI160_FIFO_ACCEL, BMI160_ENABLE, &bmi160dev) !=
+           BMI160_OK ||
+       bmi160_set_fifo_wm(IMU_FIFO_WATERMARK * BMI160_FIFO_FRAME_SIZE / 4, &bmi160dev) !=
+           BMI160_OK ||
+       bmi160_set_fifo_flush(&bmi160dev) != BMI160_OK) {
+        FURI_LOG_E(TAG, "FIFO configuration failure!");
+        return false;
+    }
+
     FURI_LOG_I(TAG, "Initialization success!");
     FURI_LOG_I(TAG, "Chip ID 0x%X", bmi160dev.chip_id);
 
@@ -86,3 +108,45 @@ int bmi160_read(double* vec) {
 
     return ACC_DATA_READY | GYR_DATA_READY;
 }
+
+int bmi160_read_fifo(ImuSample* samples, int max_samples) {
+    uint8_t level[2];
+    if(bmi160_get_regs(BMI160_FIFO_LENGTH_ADDR, level, 2, &bmi160dev) != BMI160_OK) {
+        return 0;
+    }
+    uint16_t bytes = ((uint16_t)(level[1] & BMI160_FIFO_BYTE_COUNTER_MASK) << 8) | level[0];
+    if(bytes < IMU_FIFO_WATERMARK * BMI160_FIFO_FRAME_SIZE) {
+        return 0;
+    }
+
+    if(max_samples > IMU_FIFO_MAX_SAMPLES) {
+        max_samples = IMU_FIFO_MAX_SAMPLES;
+    }
+
+    // Frames that do not fit stay in the FIFO for the next call.
+    bmi160_fifo.length = max_samples * BMI160_FIFO_FRAME_SIZE;
+    if(bmi160_get_fifo_data(&bmi160dev) != BMI160_OK) {
+        return 0;
+    }
+
+    uint8_t accel_count = max_samples;
+    uint8_t gyro_count = max_samples;
+    bmi160_extract_accel(bmi160_fifo_accel, &accel_count, &bmi160dev);
+    bmi160_extract_gyro(bmi160_fifo_gyro, &gyro_count, &bmi160dev);
+
+    const float acc_scale = (float)(4 * G / 32768);
+    const float gyr_scale = (float)(2000 * DEG_TO_RAD / 32768);
+    int count = MIN(accel_count, gyro_count);
+    for(int i = 0; i < count; i++) {
+        samples[i].flags = ACC_DATA_READY | GYR_DATA_READY;
+        samples[i].age_ns = (uint32_t)(count - 1 - i) * BMI160_SAMPLE_PERIOD_NS;
+        samples[i].acc[0] = bmi160_fifo_accel[i].x * acc_scale;
+        samples[i].acc[1] = bmi160_fifo_accel[i].y * acc_scale;
+        samples[i].acc[2] = bmi160_fifo_accel[i].z * acc_scale;
+        samples[i].gyr[0] = bmi160_fifo_gyro[i].x * gyr_scale;
+        samples[i].gyr[1] = bmi160_fifo_gyro[i].y * gyr_scale;
+        samples[i].gyr[2] = bmi160_fifo_gyro[i].z * gyr_scale;
+    }
+
+    return count;
+}
@@ -8,10 +8,16 @@
 
 #define LSM6DS3_ADDRESS (0x6A << 1)
 
+// FIFO pattern with both sensors at the same rate: gyro x/y/z then accel x/y/z words.
+#define LSM6DS3_FIFO_PATTERN_WORDS 6
+#define LSM6DS3_SAMPLE_PERIOD_NS 9615385 // 104 Hz
+
 static const double DEG_TO_RAD = 0.017453292519943295769236907684886;
 
 stmdev_ctx_t lsm6ds3trc_ctx;
 
+int16_t lsm6ds3trc_fifo_buffer[IMU_FIFO_MAX_SAMPLES * LSM6DS3_FIFO_PATTERN_WORDS];
+
 int32_t lsm6ds3trc_write_i2c(void* handle, uint8_t reg_addr, const uint8_t* data, uint16_t len) {
     if(furi_hal_i2c_write_mem(handle, LSM6DS3_ADDRESS, reg_addr, (uint8_t*)data, len, 50))
         return 0;
@@ -49,6 +55,11 @@ bool lsm6ds3trc_begin() {
 
     lsm6ds3tr_c_block_data_update_set(&lsm6ds3trc_ctx, PROPERTY_ENABLE);
     lsm6ds3tr_c_fifo_mode_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_BYPASS_MODE);
+    lsm6ds3tr_c_fifo_xl_batch_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_FIFO_XL_NO_DEC);
+    lsm6ds3tr_c_fifo_gy_batch_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_FIFO_GY_NO_DEC);
+    lsm6ds3tr_c_fifo_data_rate_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_FIFO_104Hz);
+    lsm6ds3tr_c_fifo_watermark_set(
+        &lsm6ds3trc_ctx, IMU_FIFO_WATERMARK * LSM6DS3_FIFO_PATTERN_WORDS);
 
     lsm6ds3tr_c_xl_data_rate_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_XL_ODR_104Hz);
     lsm6ds3tr_c_xl_full_scale_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_4g);
@@ -59,11 +70,14 @@ bool lsm6ds3trc_begin() {
     lsm6ds3tr_c_gy_power_mode_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_GY_HIGH_PERFORMANCE);
     lsm6ds3tr_c_gy_band_pass_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_LP2_ONLY);
 
+    lsm6ds3tr_c_fifo_mode_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_STREAM_MODE);
+
     FURI_LOG_I(TAG, "Init OK");
     return true;
 }
 
 void lsm6ds3trc_end() {
+    lsm6ds3tr_c_fifo_mode_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_BYPASS_MODE);
     lsm6ds3tr_c_xl_data_rate_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_XL_ODR_OFF);
     lsm6ds3tr_c_gy_data_rate_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_GY_ODR_OFF);
 }
@@ -92,3 +106,61 @@ int lsm6ds3trc_read(double* vec) {
 
     return ret;
 }
+
+int lsm6ds3trc_read_fifo(ImuSample* samples, int max_samples) {
+    uint8_t watermark = 0;
+    lsm6ds3tr_c_fifo_wtm_flag_get(&lsm6ds3trc_ctx, &watermark);
+    if(!watermark) {
+        return 0;
+    }
+
+    uint16_t words = 0;
+    uint16_t pattern = 0;
+    lsm6ds3tr_c_fifo_data_level_get(&lsm6ds3trc_ctx, &words);
+    lsm6ds3tr_c_fifo_pattern_get(&lsm6ds3trc_ctx, &pattern);
+
+    // Realign on the gyro x word if a previous read stopped mid-pattern.
+    if(pattern != 0 && pattern < LSM6DS3_FIFO_PATTERN_WORDS) {
+        uint16_t skip = LSM6DS3_FIFO_PATTERN_WORDS - pattern;
+        if(skip > words) {
+            return 0;
+        }
+        lsm6ds3tr_c_fifo_raw_data_get(
+            &lsm6ds3trc_ctx, (uint8_t*)lsm6ds3trc_fifo_buffer, skip * sizeof(int16_t));
+        words -= skip;
+    }
+
+    if(max_samples > IMU_FIFO_MAX_SAMPLES) {
+        max_samples = IMU_FIFO_MAX_SAMPLES;
+    }
+    int count = MIN(words / LSM6DS3_FIFO_PATTERN_WORDS, max_samples);
+    if(count == 0) {
+        return 0;
+    }
+
+    if(lsm6ds3tr_c_fifo_raw_data_get(
+           &lsm6ds3trc_ctx,
+           (uint8_t*)lsm6ds3trc_fifo_buffer,
+           count * LSM6DS3_FIFO_PATTERN_WORDS * sizeof(int16_t)) != 0) {
+        return 0;
+    }
+
+    // Same axis mapping and units as lsm6ds3trc_read().
+    for(int i = 0; i < count; i++) {
+        const int16_t* gyr = &lsm6ds3trc_fifo_buffer[i * LSM6DS3_FIFO_PATTERN_WORDS];
+        const int16_t* acc = gyr + 3;
+        samples[i].flags = ACC_DATA_READY | GYR_DATA_READY;
+        samples[i].age_ns = (uint32_t)(count - 1 - i) * LSM6DS3_SAMPLE_PERIOD_NS;
+        samples[i].acc[2] = lsm6ds3tr_c_from_fs2g_to_mg(acc[0]) / 1000;
+        samples[i].acc[0] = lsm6ds3tr_c_from_fs2g_to_mg(acc[1]) / 1000;
+        samples[i].acc[1] = lsm6ds3tr_c_from_fs2g_to_mg(acc[2]) / 1000;
+        samples[i].gyr[2] =
+            lsm6ds3tr_c_from_fs2000dps_to_mdps(gyr[0]) * (float)(DEG_TO_RAD / 1000);
+        samples[i].gyr[0] =
+            lsm6ds3tr_c_from_fs2000dps_to_mdps(gyr[1]) * (float)(DEG_TO_RAD / 1000);
+        samples[i].gyr[1] =
+            lsm6ds3tr_c_from_fs2000dps_to_mdps(gyr[2]) * (float)(DEG_TO_RAD / 1000);
+    }
+
+    return count;
+}
@@ -23,6 +23,9 @@ private:
     CalibrationData calibration;
     cardboard::OrientationTracker tracker;
     uint64_t ippus, ippus2;
+    uint64_t cycles;
+    uint32_t lastCycles;
+    ImuSample samples[IMU_FIFO_MAX_SAMPLES];
 
 private:
     float clamp(float val) {
@@ -80,6 +83,15 @@ private:
         }
     }
 
+    // DWT->CYCCNT wraps around within a minute, extend it to keep the sample
+    // timestamps monotonic.
+    uint64_t timestampNs() {
+        const uint32_t now = DWT->CYCCNT;
+        cycles += (uint32_t)(now - lastCycles);
+        lastCycles = now;
+        return (cycles * 1000llu + ippus2) / ippus;
+    }
+
     void onOrientation(cardboard::Vector4& quaternion) {
         float q1 = quaternion[0]; // X * sin(T/2)
         float q2 = quaternion[1]; // Y * sin(T/2)
@@ -122,7 +134,9 @@ public:
         , dPitch(0)
         , firstRead(true)
         , stabilize(true)
-        , tracker(10000000l) { // 10 ms / 100 Hz
+        , tracker(10000000l) // 10 ms / 100 Hz
+        , cycles(0)
+        , lastCycles(0) {
         ippus = furi_hal_cortex_instructions_per_microsecond();
         ippus2 = ippus / 2;
     }
@@ -168,29 +182,39 @@ public:
 
     void beginTracking() {
         loadCalibration();
+        // Drop the samples queued up while the tracker was not running.
+        while (imu_read_fifo(samples, IMU_FIFO_MAX_SAMPLES) == IMU_FIFO_MAX_SAMPLES) {
+        }
         tracker.Resume();
     }
 
     void stepTracking(MouseMoveCallback mouse_move, void *context) {
-        double vec[6];
-        int ret = imu_read(vec);
-        if (ret != 0) {
-            uint64_t t = (DWT->CYCCNT * 1000llu + ippus2) / ippus;
-            if (ret & ACC_DATA_READY) {
+        int count = imu_read_fifo(samples, IMU_FIFO_MAX_SAMPLES);
+        if (count <= 0) {
+            return;
+        }
+
+        // Every sample of the batch is fed to the filter at the time it was taken,
+        // the cursor is only moved once per batch.
+        const uint64_t now = timestampNs();
+        for (int i = 0; i < count; i++) {
+            const ImuSample& sample = samples[i];
+            const uint64_t t = now - sample.age_ns;
+            if (sample.flags & ACC_DATA_READY) {
                 cardboard::AccelerometerData adata
                     = { .system_timestamp = t, .sensor_timestamp_ns = t,
-                        .data = cardboard::Vector3(vec[0], vec[1], vec[2]) };
+                        .data = cardboard::Vector3(sample.acc[0], sample.acc[1], sample.acc[2]) };
                 tracker.OnAccelerometerData(adata);
             }
-            if (ret & GYR_DATA_READY) {
+            if (sample.flags & GYR_DATA_READY) {
                 cardboard::GyroscopeData gdata
                     = { .system_timestamp = t, .sensor_timestamp_ns = t,
-                        .data = cardboard::Vector3(vec[3], vec[4], vec[5]) };
+                        .data = cardboard::Vector3(sample.gyr[0], sample.gyr[1], sample.gyr[2]) };
                 cardboard::Vector4 pose = tracker.OnGyroscopeData(gdata);
                 onOrientation(pose);
-                sendCurrentState(mouse_move, context);
             }
         }
+        sendCurrentState(mouse_move, context);
     }
 
     void stopTracking() {
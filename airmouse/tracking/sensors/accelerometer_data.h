@@ -20,7 +20,8 @@
 
 namespace cardboard {
 
-struct AccelerometerData {
+template <typename T>
+struct AccelerometerDataT {
     // System wall time.
     uint64_t system_timestamp;
 
@@ -30,9 +31,11 @@ struct AccelerometerData {
     // Acceleration force along the x,y,z axes in m/s^2. This follows android
     // specification
     // (https://developer.android.com/guide/topics/sensors/sensors_overview.html#sensors-coords).
-    Vector3 data;
+    Vector<3, T> data;
 };
 
+typedef AccelerometerDataT<Scalar> AccelerometerData;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_SENSORS_ACCELEROMETER_DATA_H_
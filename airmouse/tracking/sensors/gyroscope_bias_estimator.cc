@@ -70,7 +70,8 @@ namespace cardboard {
 
 // A helper class to keep track of whether some signal can be considered static
 // over specified number of frames.
-class GyroscopeBiasEstimator::IsStaticCounter {
+template <typename T>
+class GyroscopeBiasEstimatorT<T>::IsStaticCounter {
 public:
     // Initializes a counter with the number of consecutive frames we require
     // the signal to be static before IsRecentlyStatic returns true.
@@ -108,7 +109,8 @@ private:
     int consecutive_static_frames_;
 };
 
-GyroscopeBiasEstimator::GyroscopeBiasEstimator()
+template <typename T>
+GyroscopeBiasEstimatorT<T>::GyroscopeBiasEstimatorT()
     : accelerometer_lowpass_filter_(kAccelerometerLowPassCutOffFrequencyHz)
     , simulated_gyroscope_from_accelerometer_lowpass_filter_(
           kRotationVelocityBasedAccelerometerLowPassCutOffFrequencyHz)
@@ -116,7 +118,7 @@ GyroscopeBiasEstimator::GyroscopeBiasEstimator()
     , gyroscope_bias_lowpass_filter_(kGyroscopeBiasLowPassCutOffFrequencyHz)
     , accelerometer_static_counter_(new IsStaticCounter(kStaticFrameDetectionThreshold))
     , gyroscope_static_counter_(new IsStaticCounter(kStaticFrameDetectionThreshold))
-    , current_accumulated_weights_gyroscope_bias_(0.f)
+    , current_accumulated_weights_gyroscope_bias_(0)
     , mean_filter_(kFilterWindowSize)
     , median_filter_(kFilterWindowSize)
     , last_mean_filtered_accelerometer_value_({ 0, 0, 0 })
@@ -124,9 +126,11 @@ GyroscopeBiasEstimator::GyroscopeBiasEstimator()
     Reset();
 }
 
-GyroscopeBiasEstimator::~GyroscopeBiasEstimator() { }
+template <typename T>
+GyroscopeBiasEstimatorT<T>::~GyroscopeBiasEstimatorT() { }
 
-void GyroscopeBiasEstimator::Reset()
+template <typename T>
+void GyroscopeBiasEstimatorT<T>::Reset()
 {
     accelerometer_lowpass_filter_.Reset();
     gyroscope_lowpass_filter_.Reset();
@@ -135,8 +139,9 @@ void GyroscopeBiasEstimator::Reset()
     gyroscope_static_counter_->Reset();
 }
 
-void GyroscopeBiasEstimator::ProcessGyroscope(
-    const Vector3& gyroscope_sample, uint64_t timestamp_ns)
+template <typename T>
+void GyroscopeBiasEstimatorT<T>::ProcessGyroscope(
+    const Vector<3, T>& gyroscope_sample, uint64_t timestamp_ns)
 {
     // Update gyroscope and gyroscope delta low-pass filters.
     gyroscope_lowpass_filter_.AddSample(gyroscope_sample, timestamp_ns);
@@ -145,7 +150,7 @@ void GyroscopeBiasEstimator::ProcessGyroscope(
         = gyroscope_sample - gyroscope_lowpass_filter_.GetFilteredData();
 
     gyroscope_static_counter_->AppendFrame(
-        Length(smoothed_gyroscope_delta) < kGyroscopeDeltaStaticThreshold);
+        Length(smoothed_gyroscope_delta) < T(kGyroscopeDeltaStaticThreshold));
 
     // Only update the bias if the gyroscope and accelerometer signals have been
     // relatively static recently.
@@ -163,8 +168,9 @@ void GyroscopeBiasEstimator::ProcessGyroscope(
     }
 }
 
-void GyroscopeBiasEstimator::ProcessAccelerometer(
-    const Vector3& accelerometer_sample, uint64_t timestamp_ns)
+template <typename T>
+void GyroscopeBiasEstimatorT<T>::ProcessAccelerometer(
+    const Vector<3, T>& accelerometer_sample, uint64_t timestamp_ns)
 {
     // Get current state of the filter.
     const uint64_t previous_accel_timestamp_ns
@@ -178,7 +184,7 @@ void GyroscopeBiasEstimator::ProcessAccelerometer(
         = accelerometer_sample - accelerometer_lowpass_filter_.GetFilteredData();
 
     accelerometer_static_counter_->AppendFrame(
-        Length(smoothed_accelerometer_delta) < kAccelerometerDeltaStaticThreshold);
+        Length(smoothed_accelerometer_delta) < T(kAccelerometerDeltaStaticThreshold));
 
     // Rotation from accel cannot be differentiated with only one sample.
     if (!is_low_pass_filter_init) {
@@ -207,16 +213,18 @@ void GyroscopeBiasEstimator::ProcessAccelerometer(
 
     // Compute a mock gyroscope value from accelerometer.
     const int64_t diff = timestamp_ns - previous_accel_timestamp_ns;
-    const double timestep = static_cast<double>(diff);
+    const T timestep = static_cast<T>(diff);
 
     simulated_gyroscope_from_accelerometer_lowpass_filter_.AddSample(
         ComputeAngularVelocityFromLatestAccelerometer(timestep), timestamp_ns);
     last_mean_filtered_accelerometer_value_ = mean_filter_.GetFilteredData();
 }
 
-Vector3 GyroscopeBiasEstimator::ComputeAngularVelocityFromLatestAccelerometer(double timestep) const
+template <typename T>
+Vector<3, T> GyroscopeBiasEstimatorT<T>::ComputeAngularVelocityFromLatestAccelerometer(
+    T timestep) const
 {
-    if (timestep < kMinTimestep) {
+    if (timestep < T(kMinTimestep)) {
         return { 0, 0, 0 };
     }
 
@@ -225,27 +233,24 @@ Vector3 GyroscopeBiasEstimator::ComputeAngularVelocityFromLatestAccelerometer(do
     // Compute an incremental rotation between the last state and the current
     // state.
     //
-    // Note that we switch to double precision here because of precision problem
-    // with small rotation.
-    const auto incremental_rotation = Rotation::RotateInto(
-        Vector3(last_mean_filtered_accelerometer_value_[0],
-            last_mean_filtered_accelerometer_value_[1], last_mean_filtered_accelerometer_value_[2]),
-        Vector3(mean_of_median[0], mean_of_median[1], mean_of_median[2]));
+    // Note that RotationT::GetAxisAndAngle keeps small rotations precise even
+    // in single precision.
+    const auto incremental_rotation
+        = RotationT<T>::RotateInto(last_mean_filtered_accelerometer_value_, mean_of_median);
 
     // We use axis angle here because this is how gyroscope values are stored.
-    Vector3 incremental_rotation_axis;
-    double incremental_rotation_angle;
+    Vector<3, T> incremental_rotation_axis;
+    T incremental_rotation_angle;
     incremental_rotation.GetAxisAndAngle(&incremental_rotation_axis, &incremental_rotation_angle);
 
     incremental_rotation_axis *= incremental_rotation_angle / timestep;
 
-    return { static_cast<float>(incremental_rotation_axis[0]),
-        static_cast<float>(incremental_rotation_axis[1]),
-        static_cast<float>(incremental_rotation_axis[2]) };
+    return incremental_rotation_axis;
 }
 
-bool GyroscopeBiasEstimator::UpdateGyroscopeBias(
-    const Vector3& gyroscope_sample, uint64_t timestamp_ns)
+template <typename T>
+bool GyroscopeBiasEstimatorT<T>::UpdateGyroscopeBias(
+    const Vector<3, T>& gyroscope_sample, uint64_t timestamp_ns)
 {
     // Gyroscope values that are too big are potentially dangerous as they could
     // originate from slow and steady head rotations.
@@ -260,13 +265,13 @@ bool GyroscopeBiasEstimator::UpdateGyroscopeBias(
 
     // If magnitude is too big, don't update the filter at all so that we don't
     // artificially increase the number of samples accumulated by the filter.
-    const float gyroscope_sample_norm2 = Length(gyroscope_sample);
-    if (gyroscope_sample_norm2 >= kGyroscopeForBiasThreshold) {
+    const T gyroscope_sample_norm2 = Length(gyroscope_sample);
+    if (gyroscope_sample_norm2 >= T(kGyroscopeForBiasThreshold)) {
         return false;
     }
 
-    float update_weight
-        = std::max(0.0f, 1 - gyroscope_sample_norm2 / kGyroscopeForBiasThreshold);
+    T update_weight
+        = std::max(T(0), 1 - gyroscope_sample_norm2 / T(kGyroscopeForBiasThreshold));
     update_weight *= update_weight;
     gyroscope_bias_lowpass_filter_.AddWeightedSample(
         gyroscope_lowpass_filter_.GetFilteredData(), timestamp_ns, update_weight);
@@ -278,12 +283,14 @@ bool GyroscopeBiasEstimator::UpdateGyroscopeBias(
     return true;
 }
 
-Vector3 GyroscopeBiasEstimator::GetGyroscopeBias() const
+template <typename T>
+Vector<3, T> GyroscopeBiasEstimatorT<T>::GetGyroscopeBias() const
 {
     return gyroscope_bias_lowpass_filter_.GetFilteredData();
 }
 
-bool GyroscopeBiasEstimator::IsCurrentEstimateValid() const
+template <typename T>
+bool GyroscopeBiasEstimatorT<T>::IsCurrentEstimateValid() const
 {
     // Remove any bias component along the gravity because they cannot be
     // evaluated from accelerometer.
@@ -298,10 +305,10 @@ bool GyroscopeBiasEstimator::IsCurrentEstimateValid() const
     const auto gyro_from_accel
         = simulated_gyroscope_from_accelerometer_lowpass_filter_.GetFilteredData();
     const bool isGyroscopeBiasCorrelatedWithSimulatedGyro
-        = (Length(gyro_from_accel) * kRatioBetweenGyroBiasAndAccel
-            > (Length(off_gravity_gyro_bias) + kEpsilon));
+        = (Length(gyro_from_accel) * T(kRatioBetweenGyroBiasAndAccel)
+            > (Length(off_gravity_gyro_bias) + T(kEpsilon)));
     const bool hasEnoughSamples
-        = current_accumulated_weights_gyroscope_bias_ > kMinSumOfWeightsGyroBiasThreshold;
+        = current_accumulated_weights_gyroscope_bias_ > T(kMinSumOfWeightsGyroBiasThreshold);
     const bool areCountersStatic = gyroscope_static_counter_->IsRecentlyStatic()
         && accelerometer_static_counter_->IsRecentlyStatic();
 
@@ -310,4 +317,7 @@ bool GyroscopeBiasEstimator::IsCurrentEstimateValid() const
     return isStatic;
 }
 
+#define INSTANTIATE_GYROSCOPE_BIAS_ESTIMATOR(T) template class GyroscopeBiasEstimatorT<T>;
+CARDBOARD_INSTANTIATE(INSTANTIATE_GYROSCOPE_BIAS_ESTIMATOR)
+
 } // namespace cardboard
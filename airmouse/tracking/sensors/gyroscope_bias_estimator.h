@@ -46,10 +46,11 @@ namespace cardboard {
 // for a Virtual Reality Application. Sensor and Transducers Journal, 2012.
 //
 // which is a combination of a IIR filter, a median and a mean filter.
-class GyroscopeBiasEstimator {
+template <typename T>
+class GyroscopeBiasEstimatorT {
 public:
-    GyroscopeBiasEstimator();
-    virtual ~GyroscopeBiasEstimator();
+    GyroscopeBiasEstimatorT();
+    virtual ~GyroscopeBiasEstimatorT();
 
     // Updates the estimator with a gyroscope event.
     //
@@ -58,7 +59,7 @@ public:
     // @param timestamp_ns the nanosecond at which the event occurred. Only
     //     guaranteed to be comparable with timestamps from other PocessGyroscope
     //     invocations.
-    virtual void ProcessGyroscope(const Vector3& gyroscope_sample, uint64_t timestamp_ns);
+    virtual void ProcessGyroscope(const Vector<3, T>& gyroscope_sample, uint64_t timestamp_ns);
 
     // Processes accelerometer samples to estimate if device is
     // stable or not.
@@ -76,13 +77,14 @@ public:
     // @param timestamp_ns the nanosecond at which the event occurred. Only
     //     guaranteed to be comparable with timestamps from other
     //     ProcessAccelerometer invocations.
-    virtual void ProcessAccelerometer(const Vector3& accelerometer_sample, uint64_t timestamp_ns);
+    virtual void ProcessAccelerometer(
+        const Vector<3, T>& accelerometer_sample, uint64_t timestamp_ns);
 
     // Returns the estimated gyroscope bias.
     //
     // @return Estimated gyroscope bias. A vector with zeros is returned if no
     //     estimate has been computed.
-    virtual Vector3 GetGyroscopeBias() const;
+    virtual Vector<3, T> GetGyroscopeBias() const;
 
     // Resets the estimator state.
     void Reset();
@@ -100,35 +102,37 @@ private:
     // Updates gyroscope bias estimation.
     //
     // @return false if the current sample is too large.
-    bool UpdateGyroscopeBias(const Vector3& gyroscope_sample, uint64_t timestamp_ns);
+    bool UpdateGyroscopeBias(const Vector<3, T>& gyroscope_sample, uint64_t timestamp_ns);
 
     // Returns device angular velocity (rad/s) from the latest accelerometer data.
     //
     // @param timestep in seconds between the last two samples.
     // @return rotation velocity from latest accelerometer. This can be
     // interpreted as an gyroscope.
-    Vector3 ComputeAngularVelocityFromLatestAccelerometer(double timestep) const;
+    Vector<3, T> ComputeAngularVelocityFromLatestAccelerometer(T timestep) const;
 
-    LowpassFilter accelerometer_lowpass_filter_;
-    LowpassFilter simulated_gyroscope_from_accelerometer_lowpass_filter_;
-    LowpassFilter gyroscope_lowpass_filter_;
-    LowpassFilter gyroscope_bias_lowpass_filter_;
+    LowpassFilterT<T> accelerometer_lowpass_filter_;
+    LowpassFilterT<T> simulated_gyroscope_from_accelerometer_lowpass_filter_;
+    LowpassFilterT<T> gyroscope_lowpass_filter_;
+    LowpassFilterT<T> gyroscope_bias_lowpass_filter_;
 
     std::unique_ptr<IsStaticCounter> accelerometer_static_counter_;
     std::unique_ptr<IsStaticCounter> gyroscope_static_counter_;
 
     // Sum of the weight of sample used for gyroscope filtering.
-    float current_accumulated_weights_gyroscope_bias_;
+    T current_accumulated_weights_gyroscope_bias_;
 
     // Set of filters for accelerometer data to estimate a rotation
     // based only on accelerometer.
-    MeanFilter mean_filter_;
-    MedianFilter median_filter_;
+    MeanFilterT<T> mean_filter_;
+    MedianFilterT<T> median_filter_;
 
     // Last computed filter accelerometer value used for finite differences.
-    Vector3 last_mean_filtered_accelerometer_value_;
+    Vector<3, T> last_mean_filtered_accelerometer_value_;
 };
 
+typedef GyroscopeBiasEstimatorT<Scalar> GyroscopeBiasEstimator;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_SENSORS_GYROSCOPE_BIAS_ESTIMATOR_H_
@@ -20,7 +20,8 @@
 
 namespace cardboard {
 
-struct GyroscopeData {
+template <typename T>
+struct GyroscopeDataT {
     // System wall time.
     uint64_t system_timestamp;
 
@@ -30,9 +31,11 @@ struct GyroscopeData {
     // Rate of rotation around the x,y,z axes in rad/s. This follows android
     // specification
     // (https://developer.android.com/guide/topics/sensors/sensors_overview.html#sensors-coords).
-    Vector3 data;
+    Vector<3, T> data;
 };
 
+typedef GyroscopeDataT<Scalar> GyroscopeData;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_SENSORS_GYROSCOPE_DATA_H_
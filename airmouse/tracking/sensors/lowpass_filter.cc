@@ -31,19 +31,23 @@ const double kMaxTimestepS = 1.00f;
 
 namespace cardboard {
 
-LowpassFilter::LowpassFilter(double cutoff_freq_hz)
-    : cutoff_time_constant_(1 / (2 * (double)M_PI * cutoff_freq_hz))
+template <typename T>
+LowpassFilterT<T>::LowpassFilterT(T cutoff_freq_hz)
+    : cutoff_time_constant_(1 / (2 * T(M_PI) * cutoff_freq_hz))
     , initialized_(false)
 {
     Reset();
 }
 
-void LowpassFilter::AddSample(const Vector3& sample, uint64_t timestamp_ns)
+template <typename T>
+void LowpassFilterT<T>::AddSample(const Vector<3, T>& sample, uint64_t timestamp_ns)
 {
-    AddWeightedSample(sample, timestamp_ns, 1.0);
+    AddWeightedSample(sample, timestamp_ns, 1);
 }
 
-void LowpassFilter::AddWeightedSample(const Vector3& sample, uint64_t timestamp_ns, double weight)
+template <typename T>
+void LowpassFilterT<T>::AddWeightedSample(
+    const Vector<3, T>& sample, uint64_t timestamp_ns, T weight)
 {
     if (!initialized_) {
         // Initialize filter state
@@ -58,16 +62,16 @@ void LowpassFilter::AddWeightedSample(const Vector3& sample, uint64_t timestamp_
         return;
     }
 
-    const double delta_s = static_cast<double>(timestamp_ns - timestamp_most_recent_update_ns_)
-        * kSecondsFromNanoseconds;
-    if (delta_s <= kMinTimestepS || delta_s > kMaxTimestepS) {
+    const T delta_s = static_cast<T>(timestamp_ns - timestamp_most_recent_update_ns_)
+        * T(kSecondsFromNanoseconds);
+    if (delta_s <= T(kMinTimestepS) || delta_s > T(kMaxTimestepS)) {
         timestamp_most_recent_update_ns_ = timestamp_ns;
         return;
     }
 
-    const double weighted_delta_secs = weight * delta_s;
+    const T weighted_delta_secs = weight * delta_s;
 
-    const double alpha = weighted_delta_secs / (cutoff_time_constant_ + weighted_delta_secs);
+    const T alpha = weighted_delta_secs / (cutoff_time_constant_ + weighted_delta_secs);
 
     for (int i = 0; i < 3; ++i) {
         filtered_data_[i] = (1 - alpha) * filtered_data_[i] + alpha * sample[i];
@@ -75,10 +79,14 @@ void LowpassFilter::AddWeightedSample(const Vector3& sample, uint64_t timestamp_
     timestamp_most_recent_update_ns_ = timestamp_ns;
 }
 
-void LowpassFilter::Reset()
+template <typename T>
+void LowpassFilterT<T>::Reset()
 {
     initialized_ = false;
     filtered_data_ = { 0, 0, 0 };
 }
 
+#define INSTANTIATE_LOWPASS_FILTER(T) template class LowpassFilterT<T>;
+CARDBOARD_INSTANTIATE(INSTANTIATE_LOWPASS_FILTER)
+
 } // namespace cardboard
@@ -26,10 +26,11 @@ namespace cardboard {
 // Implements an IIR, first order, low pass filter over vectors of the given
 // dimension = 3.
 // See http://en.wikipedia.org/wiki/Low-pass_filter
-class LowpassFilter {
+template <typename T>
+class LowpassFilterT {
 public:
     // Initializes a filter with the given cutoff frequency in Hz.
-    explicit LowpassFilter(double cutoff_freq_hz);
+    explicit LowpassFilterT(T cutoff_freq_hz);
 
     // Updates the filter with the given sample. Note that samples with
     // non-monotonic timestamps and successive samples with a time steps below 1
@@ -37,7 +38,7 @@ public:
     //
     // @param sample current sample data.
     // @param timestamp_ns timestamp associated to this sample in nanoseconds.
-    void AddSample(const Vector3& sample, uint64_t timestamp_ns);
+    void AddSample(const Vector<3, T>& sample, uint64_t timestamp_ns);
 
     // Updates the filter with the given weighted sample.
     //
@@ -47,11 +48,11 @@ public:
     //     sample. A weight of 1 corresponds to calling AddSample. A weight of 0
     //     makes the update no-op. The first initial sample is not affected by
     //     this.
-    void AddWeightedSample(const Vector3& sample, uint64_t timestamp_ns, double weight);
+    void AddWeightedSample(const Vector<3, T>& sample, uint64_t timestamp_ns, T weight);
 
     // Returns the filtered value. A vector with zeros is returned if no samples
     // have been added.
-    Vector3 GetFilteredData() const {
+    Vector<3, T> GetFilteredData() const {
         return filtered_data_;
     }
 
@@ -69,13 +70,15 @@ public:
     void Reset();
 
 private:
-    const double cutoff_time_constant_;
+    const T cutoff_time_constant_;
     uint64_t timestamp_most_recent_update_ns_;
     bool initialized_;
 
-    Vector3 filtered_data_;
+    Vector<3, T> filtered_data_;
 };
 
+typedef LowpassFilterT<Scalar> LowpassFilter;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_SENSORS_LOWPASS_FILTER_H_
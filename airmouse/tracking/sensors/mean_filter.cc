@@ -17,12 +17,14 @@
 
 namespace cardboard {
 
-MeanFilter::MeanFilter(size_t filter_size)
+template <typename T>
+MeanFilterT<T>::MeanFilterT(size_t filter_size)
     : filter_size_(filter_size)
 {
 }
 
-void MeanFilter::AddSample(const Vector3& sample)
+template <typename T>
+void MeanFilterT<T>::AddSample(const Vector<3, T>& sample)
 {
     buffer_.push_back(sample);
     if (buffer_.size() > filter_size_) {
@@ -30,17 +32,22 @@ void MeanFilter::AddSample(const Vector3& sample)
     }
 }
 
-bool MeanFilter::IsValid() const { return buffer_.size() == filter_size_; }
+template <typename T>
+bool MeanFilterT<T>::IsValid() const { return buffer_.size() == filter_size_; }
 
-Vector3 MeanFilter::GetFilteredData() const
+template <typename T>
+Vector<3, T> MeanFilterT<T>::GetFilteredData() const
 {
     // Compute mean of the samples stored in buffer_.
-    Vector3 mean = Vector3::Zero();
+    Vector<3, T> mean = Vector<3, T>::Zero();
     for (auto sample : buffer_) {
         mean += sample;
     }
 
-    return mean / static_cast<double>(filter_size_);
+    return mean / static_cast<T>(filter_size_);
 }
 
+#define INSTANTIATE_MEAN_FILTER(T) template class MeanFilterT<T>;
+CARDBOARD_INSTANTIATE(INSTANTIATE_MEAN_FILTER)
+
 } // namespace cardboard
@@ -16,6 +16,7 @@
 #ifndef CARDBOARD_SDK_SENSORS_MEAN_FILTER_H_
 #define CARDBOARD_SDK_SENSORS_MEAN_FILTER_H_
 
+#include <cstddef>
 #include <deque>
 
 #include "../util/vector.h"
@@ -23,26 +24,29 @@
 namespace cardboard {
 
 // Fixed window FIFO mean filter for vectors of the given dimension.
-class MeanFilter {
+template <typename T>
+class MeanFilterT {
 public:
     // Create a mean filter of size filter_size.
     // @param filter_size size of the internal filter.
-    explicit MeanFilter(size_t filter_size);
+    explicit MeanFilterT(size_t filter_size);
 
     // Add sample to buffer_ if buffer_ is full it drop the oldest sample.
-    void AddSample(const Vector3& sample);
+    void AddSample(const Vector<3, T>& sample);
 
     // Returns true if buffer has filter_size_ sample, false otherwise.
     bool IsValid() const;
 
     // Returns the mean of values stored in the internal buffer.
-    Vector3 GetFilteredData() const;
+    Vector<3, T> GetFilteredData() const;
 
 private:
     const size_t filter_size_;
-    std::deque<Vector3> buffer_;
+    std::deque<Vector<3, T>> buffer_;
 };
 
+typedef MeanFilterT<Scalar> MeanFilter;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_SENSORS_MEAN_FILTER_H_
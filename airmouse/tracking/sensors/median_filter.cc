@@ -23,12 +23,14 @@
 
 namespace cardboard {
 
-MedianFilter::MedianFilter(size_t filter_size)
+template <typename T>
+MedianFilterT<T>::MedianFilterT(size_t filter_size)
     : filter_size_(filter_size)
 {
 }
 
-void MedianFilter::AddSample(const Vector3& sample)
+template <typename T>
+void MedianFilterT<T>::AddSample(const Vector<3, T>& sample)
 {
     buffer_.push_back(sample);
     norms_.push_back(Length(sample));
@@ -38,15 +40,17 @@ void MedianFilter::AddSample(const Vector3& sample)
     }
 }
 
-bool MedianFilter::IsValid() const { return buffer_.size() == filter_size_; }
+template <typename T>
+bool MedianFilterT<T>::IsValid() const { return buffer_.size() == filter_size_; }
 
-Vector3 MedianFilter::GetFilteredData() const
+template <typename T>
+Vector<3, T> MedianFilterT<T>::GetFilteredData() const
 {
-    std::vector<float> norms(norms_.begin(), norms_.end());
+    std::vector<T> norms(norms_.begin(), norms_.end());
 
     // Get median of value of the norms.
     std::nth_element(norms.begin(), norms.begin() + filter_size_ / 2, norms.end());
-    const float median_norm = norms[filter_size_ / 2];
+    const T median_norm = norms[filter_size_ / 2];
 
     // Get median value based on their norm.
     auto median_it = buffer_.begin();
@@ -60,10 +64,14 @@ Vector3 MedianFilter::GetFilteredData() const
     return *median_it;
 }
 
-void MedianFilter::Reset()
+template <typename T>
+void MedianFilterT<T>::Reset()
 {
     buffer_.clear();
     norms_.clear();
 }
 
+#define INSTANTIATE_MEDIAN_FILTER(T) template class MedianFilterT<T>;
+CARDBOARD_INSTANTIATE(INSTANTIATE_MEDIAN_FILTER)
+
 } // namespace cardboard
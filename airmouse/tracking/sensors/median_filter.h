@@ -16,6 +16,7 @@
 #ifndef CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
 #define CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
 
+#include <cstddef>
 #include <deque>
 
 #include "../util/vector.h"
@@ -23,31 +24,34 @@
 namespace cardboard {
 
 // Fixed window FIFO median filter for vectors of the given dimension = 3.
-class MedianFilter {
+template <typename T>
+class MedianFilterT {
 public:
     // Creates a median filter of size filter_size.
     // @param filter_size size of the internal filter.
-    explicit MedianFilter(size_t filter_size);
+    explicit MedianFilterT(size_t filter_size);
 
     // Adds sample to buffer_ if buffer_ is full it drops the oldest sample.
-    void AddSample(const Vector3& sample);
+    void AddSample(const Vector<3, T>& sample);
 
     // Returns true if buffer has filter_size_ sample, false otherwise.
     bool IsValid() const;
 
     // Returns the median of values store in the internal buffer.
-    Vector3 GetFilteredData() const;
+    Vector<3, T> GetFilteredData() const;
 
     // Resets the filter, removing all samples that have been added.
     void Reset();
 
 private:
     const size_t filter_size_;
-    std::deque<Vector3> buffer_;
+    std::deque<Vector<3, T>> buffer_;
     // Contains norms of the elements stored in buffer_.
-    std::deque<float> norms_;
+    std::deque<T> norms_;
 };
 
+typedef MedianFilterT<Scalar> MedianFilter;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
@@ -28,44 +28,55 @@ namespace {
 
 namespace pose_prediction {
 
-    Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value, double timestep_s)
+    template <typename T>
+    RotationT<T> GetRotationFromGyroscope(const Vector<3, T>& gyroscope_value, T timestep_s)
     {
-        const double velocity = Length(gyroscope_value);
+        const T velocity = Length(gyroscope_value);
 
         // When there is no rotation data return an identity rotation.
-        if (velocity < kEpsilon) {
+        if (velocity < T(kEpsilon)) {
             CARDBOARD_LOGI("PosePrediction::GetRotationFromGyroscope: Velocity really small, "
                            "returning identity rotation.");
-            return Rotation::Identity();
+            return RotationT<T>::Identity();
         }
         // Since the gyroscope_value is a start from sensor transformation we need to
         // invert it to have a sensor from start transformation, hence the minus sign.
         // For more info:
         // http://developer.android.com/guide/topics/sensors/sensors_motion.html#sensors-motion-gyro
-        return Rotation::FromAxisAndAngle(gyroscope_value / velocity, -timestep_s * velocity);
+        return RotationT<T>::FromAxisAndAngle(
+            gyroscope_value / velocity, -timestep_s * velocity);
     }
 
-    Rotation PredictPose(int64_t requested_pose_timestamp, const PoseState& current_state)
+    template <typename T>
+    RotationT<T> PredictPose(int64_t requested_pose_timestamp, const PoseStateT<T>& current_state)
     {
         // Subtracting unsigned numbers is bad when the result is negative.
         const int64_t diff = requested_pose_timestamp - current_state.timestamp;
-        const double timestep_s = diff * 1.0e-9;
+        const T timestep_s = static_cast<T>(diff) * T(1.0e-9);
 
-        const Rotation update = GetRotationFromGyroscope(
+        const RotationT<T> update = GetRotationFromGyroscope(
             current_state.sensor_from_start_rotation_velocity, timestep_s);
         return update * current_state.sensor_from_start_rotation;
     }
 
-    Rotation PredictPoseInv(int64_t requested_pose_timestamp, const PoseState& current_state)
+    template <typename T>
+    RotationT<T> PredictPoseInv(
+        int64_t requested_pose_timestamp, const PoseStateT<T>& current_state)
     {
         // Subtracting unsigned numbers is bad when the result is negative.
         const int64_t diff = requested_pose_timestamp - current_state.timestamp;
-        const double timestep_s = diff * 1.0e-9;
+        const T timestep_s = static_cast<T>(diff) * T(1.0e-9);
 
-        const Rotation update = GetRotationFromGyroscope(
+        const RotationT<T> update = GetRotationFromGyroscope(
             current_state.sensor_from_start_rotation_velocity, timestep_s);
         return current_state.sensor_from_start_rotation * (-update);
     }
 
+#define INSTANTIATE_POSE_PREDICTION(T)                                                        \
+    template RotationT<T> GetRotationFromGyroscope(const Vector<3, T>& value, T timestep_s); \
+    template RotationT<T> PredictPose(int64_t timestamp, const PoseStateT<T>& state);        \
+    template RotationT<T> PredictPoseInv(int64_t timestamp, const PoseStateT<T>& state);
+    CARDBOARD_INSTANTIATE(INSTANTIATE_POSE_PREDICTION)
+
 } // namespace pose_prediction
 } // namespace cardboard
@@ -32,7 +32,8 @@ namespace pose_prediction {
 // @param timestep_s integration period in seconds.
 // @return Integration of the gyroscope value the rotation is from Start to
 //         Sensor Space.
-Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value, double timestep_s);
+template <typename T>
+RotationT<T> GetRotationFromGyroscope(const Vector<3, T>& gyroscope_value, T timestep_s);
 
 // Gets a predicted pose for a given time in the future (e.g. rendering time)
 // based on a linear prediction model. This uses the system current state
@@ -43,11 +44,14 @@ Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value, double timeste
 // @param current_state current state that stores the pose and linear model at a
 //        given time prior to requested_pose_timestamp_ns.
 // @return pose from Start to Sensor Space.
-Rotation PredictPose(int64_t requested_pose_timestamp, const PoseState& current_state);
+template <typename T>
+RotationT<T> PredictPose(int64_t requested_pose_timestamp, const PoseStateT<T>& current_state);
 
 // Equivalent to PredictPose, but for use with poses relative to Start Space
 // rather than sensor space.
-Rotation PredictPoseInv(int64_t requested_pose_timestamp, const PoseState& current_state);
+template <typename T>
+RotationT<T> PredictPoseInv(
+    int64_t requested_pose_timestamp, const PoseStateT<T>& current_state);
 
 } // namespace pose_prediction
 } // namespace cardboard
@@ -28,29 +28,32 @@ enum {
 };
 
 // Stores a head pose pose plus derivatives. This can be used for prediction.
-struct PoseState {
+template <typename T>
+struct PoseStateT {
     // System wall time.
     int64_t timestamp;
 
     // Rotation from Sensor Space to Start Space.
-    Rotation sensor_from_start_rotation;
+    RotationT<T> sensor_from_start_rotation;
 
     // First derivative of the rotation.
-    Vector3 sensor_from_start_rotation_velocity;
+    Vector<3, T> sensor_from_start_rotation_velocity;
 
     // Current gyroscope bias in rad/s.
-    Vector3 bias;
+    Vector<3, T> bias;
 
     // The position of the headset.
-    Vector3 position = Vector3(0, 0, 0);
+    Vector<3, T> position = Vector<3, T>(0, 0, 0);
 
     // In the same coordinate frame as the position.
-    Vector3 velocity = Vector3(0, 0, 0);
+    Vector<3, T> velocity = Vector<3, T>(0, 0, 0);
 
     // Flags indicating the status of the pose.
     uint64_t flags = 0U;
 };
 
+typedef PoseStateT<Scalar> PoseState;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_SENSORS_POSE_STATE_H_
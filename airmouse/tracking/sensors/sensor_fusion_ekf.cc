@@ -27,7 +27,12 @@ namespace cardboard {
 
 namespace {
 
-    const double kFiniteDifferencingEpsilon = 1.0e-7;
+    // Step of the numerical differentiation of the measurement Jacobian. In
+    // single precision a 1e-7 rad perturbation is lost to rounding once it is
+    // composed with the current pose, so float needs a much coarser step.
+    template <typename T> constexpr T FiniteDifferencingEpsilon();
+    template <> constexpr double FiniteDifferencingEpsilon<double>() { return 1.0e-7; }
+    template <> constexpr float FiniteDifferencingEpsilon<float>() { return 1.0e-3f; }
     const double kEpsilon = 1.0e-15;
     // Default gyroscope frequency. This corresponds to 100 Hz.
     const double kDefaultGyroscopeTimestep_s = 0.01f;
@@ -53,25 +58,30 @@ namespace {
     const int kTimestepFilterMinSamples = 10;
 
     // Z direction in start space.
-    const Vector3 kCanonicalZDirection(0.0, 0.0, 1.0);
+    template <typename T> constexpr Vector<3, T> CanonicalZDirection()
+    {
+        return Vector<3, T>(0, 0, 1);
+    }
 
     // Computes an axis-angle rotation from the input vector.
     // angle = norm(a)
     // axis = a.normalized()
     // If norm(a) == 0, it returns an identity rotation.
-    static inline void RotationFromVector(const Vector3& a, Rotation& r)
+    template <typename T>
+    static inline void RotationFromVector(const Vector<3, T>& a, RotationT<T>& r)
     {
-        const double norm_a = Length(a);
-        if (norm_a < kEpsilon) {
-            r = Rotation::Identity();
+        const T norm_a = Length(a);
+        if (norm_a < T(kEpsilon)) {
+            r = RotationT<T>::Identity();
             return;
         }
-        r = Rotation::FromAxisAndAngle(a / norm_a, norm_a);
+        r = RotationT<T>::FromAxisAndAngle(a / norm_a, norm_a);
     }
 
 } // namespace
 
-SensorFusionEkf::SensorFusionEkf()
+template <typename T>
+SensorFusionEkfT<T>::SensorFusionEkfT()
     : execute_reset_with_next_accelerometer_sample_(false)
     , bias_estimation_enabled_(true)
     , gyroscope_bias_estimate_({ 0, 0, 0 })
@@ -79,29 +89,31 @@ SensorFusionEkf::SensorFusionEkf()
     ResetState();
 }
 
-void SensorFusionEkf::Reset() { execute_reset_with_next_accelerometer_sample_ = true; }
+template <typename T>
+void SensorFusionEkfT<T>::Reset() { execute_reset_with_next_accelerometer_sample_ = true; }
 
-void SensorFusionEkf::ResetState()
+template <typename T>
+void SensorFusionEkfT<T>::ResetState()
 {
-    current_state_.sensor_from_start_rotation = Rotation::Identity();
-    current_state_.sensor_from_start_rotation_velocity = Vector3::Zero();
+    current_state_.sensor_from_start_rotation = RotationT<T>::Identity();
+    current_state_.sensor_from_start_rotation_velocity = Vector<3, T>::Zero();
 
     current_gyroscope_sensor_timestamp_ns_ = 0;
     current_accelerometer_sensor_timestamp_ns_ = 0;
 
-    state_covariance_ = Matrix3x3::Identity() * kInitialStateCovarianceValue;
-    process_covariance_ = Matrix3x3::Identity() * kInitialProcessCovarianceValue;
+    state_covariance_ = Matrix3x3T<T>::Identity() * T(kInitialStateCovarianceValue);
+    process_covariance_ = Matrix3x3T<T>::Identity() * T(kInitialProcessCovarianceValue);
     accelerometer_measurement_covariance_
-        = Matrix3x3::Identity() * kMinAccelNoiseSigma * kMinAccelNoiseSigma;
-    innovation_covariance_ = Matrix3x3::Identity();
+        = Matrix3x3T<T>::Identity() * T(kMinAccelNoiseSigma * kMinAccelNoiseSigma);
+    innovation_covariance_ = Matrix3x3T<T>::Identity();
 
-    accelerometer_measurement_jacobian_ = Matrix3x3::Zero();
-    kalman_gain_ = Matrix3x3::Zero();
-    innovation_ = Vector3::Zero();
-    accelerometer_measurement_ = Vector3::Zero();
-    prediction_ = Vector3::Zero();
-    control_input_ = Vector3::Zero();
-    state_update_ = Vector3::Zero();
+    accelerometer_measurement_jacobian_ = Matrix3x3T<T>::Zero();
+    kalman_gain_ = Matrix3x3T<T>::Zero();
+    innovation_ = Vector<3, T>::Zero();
+    accelerometer_measurement_ = Vector<3, T>::Zero();
+    prediction_ = Vector<3, T>::Zero();
+    control_input_ = Vector<3, T>::Zero();
+    state_update_ = Vector<3, T>::Zero();
 
     moving_average_accelerometer_norm_change_ = 0.0;
 
@@ -117,9 +129,11 @@ void SensorFusionEkf::ResetState()
 // Here I am doing something wrong relative to time stamps. The state timestamps
 // always correspond to the gyrostamps because it would require additional
 // extrapolation if I wanted to do otherwise.
-PoseState SensorFusionEkf::GetLatestPoseState() const { return current_state_; }
+template <typename T>
+PoseStateT<T> SensorFusionEkfT<T>::GetLatestPoseState() const { return current_state_; }
 
-void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample)
+template <typename T>
+void SensorFusionEkfT<T>::ProcessGyroscopeSample(const GyroscopeDataT<T>& sample)
 {
     // Don't accept gyroscope sample when waiting for a reset.
     if (execute_reset_with_next_accelerometer_sample_) {
@@ -134,16 +148,14 @@ void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample)
 
     // Checks that we received at least one gyroscope sample in the past.
     if (current_gyroscope_sensor_timestamp_ns_ != 0) {
-        double current_timestep_s = std::chrono::duration_cast<std::chrono::duration<double>>(
-            std::chrono::nanoseconds(
-                sample.sensor_timestamp_ns - current_gyroscope_sensor_timestamp_ns_))
-                                        .count();
-        if (current_timestep_s > kMaximumGyroscopeSampleDelay_s) {
+        T current_timestep_s = static_cast<T>(
+            sample.sensor_timestamp_ns - current_gyroscope_sensor_timestamp_ns_) * T(1.0e-9);
+        if (current_timestep_s > T(kMaximumGyroscopeSampleDelay_s)) {
             if (is_gyroscope_filter_valid_) {
                 // Replaces the delta timestamp by the filtered estimates of the delta time.
                 current_timestep_s = filtered_gyroscope_timestep_s_;
             } else {
-                current_timestep_s = kDefaultGyroscopeTimestep_s;
+                current_timestep_s = T(kDefaultGyroscopeTimestep_s);
             }
         } else {
             FilterGyroscopeTimestep(current_timestep_s);
@@ -161,8 +173,8 @@ void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample)
 
         // Only integrate after receiving an accelerometer sample.
         if (is_aligned_with_gravity_) {
-            const Rotation rotation_from_gyroscope = pose_prediction::GetRotationFromGyroscope(
-                { sample.data[0] - gyroscope_bias_estimate_[0],
+            const RotationT<T> rotation_from_gyroscope = pose_prediction::GetRotationFromGyroscope(
+                Vector<3, T> { sample.data[0] - gyroscope_bias_estimate_[0],
                     sample.data[1] - gyroscope_bias_estimate_[1],
                     sample.data[2] - gyroscope_bias_estimate_[2] },
                 current_timestep_s);
@@ -182,37 +194,40 @@ void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample)
         sample.data[2] - gyroscope_bias_estimate_[2]);
 }
 
-Vector3 SensorFusionEkf::ComputeInnovation(const Rotation& pose)
+template <typename T>
+Vector<3, T> SensorFusionEkfT<T>::ComputeInnovation(const RotationT<T>& pose)
 {
-    const Vector3 predicted_down_direction = pose * kCanonicalZDirection;
+    const Vector<3, T> predicted_down_direction = pose * CanonicalZDirection<T>();
 
-    const Rotation rotation
-        = Rotation::RotateInto(predicted_down_direction, accelerometer_measurement_);
-    Vector3 axis;
-    double angle;
+    const RotationT<T> rotation
+        = RotationT<T>::RotateInto(predicted_down_direction, accelerometer_measurement_);
+    Vector<3, T> axis;
+    T angle;
     rotation.GetAxisAndAngle(&axis, &angle);
     return axis * angle;
 }
 
-void SensorFusionEkf::ComputeMeasurementJacobian()
+template <typename T>
+void SensorFusionEkfT<T>::ComputeMeasurementJacobian()
 {
     for (int dof = 0; dof < 3; dof++) {
-        Vector3 delta = Vector3::Zero();
-        delta[dof] = kFiniteDifferencingEpsilon;
+        Vector<3, T> delta = Vector<3, T>::Zero();
+        delta[dof] = FiniteDifferencingEpsilon<T>();
 
-        Rotation epsilon_rotation;
+        RotationT<T> epsilon_rotation;
         RotationFromVector(delta, epsilon_rotation);
-        const Vector3 delta_rotation
+        const Vector<3, T> delta_rotation
             = ComputeInnovation(epsilon_rotation * current_state_.sensor_from_start_rotation);
 
-        const Vector3 col = (innovation_ - delta_rotation) / kFiniteDifferencingEpsilon;
+        const Vector<3, T> col = (innovation_ - delta_rotation) / FiniteDifferencingEpsilon<T>();
         accelerometer_measurement_jacobian_(0, dof) = col[0];
         accelerometer_measurement_jacobian_(1, dof) = col[1];
         accelerometer_measurement_jacobian_(2, dof) = col[2];
     }
 }
 
-void SensorFusionEkf::ProcessAccelerometerSample(const AccelerometerData& sample)
+template <typename T>
+void SensorFusionEkfT<T>::ProcessAccelerometerSample(const AccelerometerDataT<T>& sample)
 {
     // Discard outdated samples.
     if (current_accelerometer_sensor_timestamp_ns_ >= sample.sensor_timestamp_ns) {
@@ -236,7 +251,7 @@ void SensorFusionEkf::ProcessAccelerometerSample(const AccelerometerData& sample
         // This is the first accelerometer measurement so it initializes the
         // orientation estimate.
         current_state_.sensor_from_start_rotation
-            = Rotation::RotateInto(kCanonicalZDirection, accelerometer_measurement_);
+            = RotationT<T>::RotateInto(CanonicalZDirection<T>(), accelerometer_measurement_);
         is_aligned_with_gravity_ = true;
 
         previous_accelerometer_norm_ = Length(accelerometer_measurement_);
@@ -261,11 +276,12 @@ void SensorFusionEkf::ProcessAccelerometerSample(const AccelerometerData& sample
     state_update_ = kalman_gain_ * innovation_;
 
     // P = (I - K * H) * P;
-    state_covariance_ = (Matrix3x3::Identity() - kalman_gain_ * accelerometer_measurement_jacobian_)
+    state_covariance_
+        = (Matrix3x3T<T>::Identity() - kalman_gain_ * accelerometer_measurement_jacobian_)
         * state_covariance_;
 
     // Updates pose and associate covariance matrix.
-    Rotation rotation_from_state_update;
+    RotationT<T> rotation_from_state_update;
     RotationFromVector(state_update_, rotation_from_state_update);
 
     current_state_.sensor_from_start_rotation
@@ -273,12 +289,14 @@ void SensorFusionEkf::ProcessAccelerometerSample(const AccelerometerData& sample
     UpdateStateCovariance(RotationMatrixNH(rotation_from_state_update));
 }
 
-void SensorFusionEkf::UpdateStateCovariance(const Matrix3x3& motion_update)
+template <typename T>
+void SensorFusionEkfT<T>::UpdateStateCovariance(const Matrix3x3T<T>& motion_update)
 {
     state_covariance_ = motion_update * state_covariance_ * Transpose(motion_update);
 }
 
-void SensorFusionEkf::FilterGyroscopeTimestep(double gyroscope_timestep_s)
+template <typename T>
+void SensorFusionEkfT<T>::FilterGyroscopeTimestep(T gyroscope_timestep_s)
 {
     if (!is_timestep_filter_initialized_) {
         // Initializes the filter.
@@ -289,8 +307,8 @@ void SensorFusionEkf::FilterGyroscopeTimestep(double gyroscope_timestep_s)
     }
 
     // Computes the IIR filter response.
-    filtered_gyroscope_timestep_s_ = kTimestepFilterCoeff * filtered_gyroscope_timestep_s_
-        + (1 - kTimestepFilterCoeff) * gyroscope_timestep_s;
+    filtered_gyroscope_timestep_s_ = T(kTimestepFilterCoeff) * filtered_gyroscope_timestep_s_
+        + (1 - T(kTimestepFilterCoeff)) * gyroscope_timestep_s;
     ++num_gyroscope_timestep_samples_;
 
     if (num_gyroscope_timestep_samples_ > kTimestepFilterMinSamples) {
@@ -298,33 +316,38 @@ void SensorFusionEkf::FilterGyroscopeTimestep(double gyroscope_timestep_s)
     }
 }
 
-void SensorFusionEkf::UpdateMeasurementCovariance()
+template <typename T>
+void SensorFusionEkfT<T>::UpdateMeasurementCovariance()
 {
-    const double current_accelerometer_norm = Length(accelerometer_measurement_);
+    const T current_accelerometer_norm = Length(accelerometer_measurement_);
     // Norm change between current and previous accel readings.
-    const double current_accelerometer_norm_change
+    const T current_accelerometer_norm_change
         = std::abs(current_accelerometer_norm - previous_accelerometer_norm_);
     previous_accelerometer_norm_ = current_accelerometer_norm;
 
-    moving_average_accelerometer_norm_change_ = kSmoothingFactor * current_accelerometer_norm_change
-        + (1 - kSmoothingFactor) * moving_average_accelerometer_norm_change_;
+    moving_average_accelerometer_norm_change_
+        = T(kSmoothingFactor) * current_accelerometer_norm_change
+        + (1 - T(kSmoothingFactor)) * moving_average_accelerometer_norm_change_;
 
     // If we hit the accel norm change threshold, we use the maximum noise sigma
     // for the accel covariance. For anything below that, we use a linear
     // combination between min and max sigma values.
-    const double norm_change_ratio
-        = moving_average_accelerometer_norm_change_ / kMaxAccelNormChange;
-    const double accelerometer_noise_sigma = std::min(kMaxAccelNoiseSigma,
-        kMinAccelNoiseSigma + norm_change_ratio * (kMaxAccelNoiseSigma - kMinAccelNoiseSigma));
+    const T norm_change_ratio
+        = moving_average_accelerometer_norm_change_ / T(kMaxAccelNormChange);
+    const T accelerometer_noise_sigma = std::min(T(kMaxAccelNoiseSigma),
+        T(kMinAccelNoiseSigma)
+            + norm_change_ratio * T(kMaxAccelNoiseSigma - kMinAccelNoiseSigma));
 
     // Updates the accel covariance matrix with the new sigma value.
     accelerometer_measurement_covariance_
-        = Matrix3x3::Identity() * accelerometer_noise_sigma * accelerometer_noise_sigma;
+        = Matrix3x3T<T>::Identity() * accelerometer_noise_sigma * accelerometer_noise_sigma;
 }
 
-bool SensorFusionEkf::IsBiasEstimationEnabled() const { return bias_estimation_enabled_; }
+template <typename T>
+bool SensorFusionEkfT<T>::IsBiasEstimationEnabled() const { return bias_estimation_enabled_; }
 
-void SensorFusionEkf::SetBiasEstimationEnabled(bool enable)
+template <typename T>
+void SensorFusionEkfT<T>::SetBiasEstimationEnabled(bool enable)
 {
     if (bias_estimation_enabled_ != enable) {
         bias_estimation_enabled_ = enable;
@@ -333,4 +356,7 @@ void SensorFusionEkf::SetBiasEstimationEnabled(bool enable)
     }
 }
 
+#define INSTANTIATE_SENSOR_FUSION_EKF(T) template class SensorFusionEkfT<T>;
+CARDBOARD_INSTANTIATE(INSTANTIATE_SENSOR_FUSION_EKF)
+
 } // namespace cardboard
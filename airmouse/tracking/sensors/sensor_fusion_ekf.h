@@ -37,9 +37,10 @@ namespace cardboard {
 //
 // To learn more about Kalman filtering one can read this article which is a
 // good introduction: https://en.wikipedia.org/wiki/Kalman_filter
-class SensorFusionEkf {
+template <typename T>
+class SensorFusionEkfT {
 public:
-    SensorFusionEkf();
+    SensorFusionEkfT();
 
     // Resets the state of the sensor fusion. It sets the velocity for
     // prediction to zero. The reset will happen with the next
@@ -49,21 +50,21 @@ public:
 
     // Gets the PoseState representing the latest pose and  derivatives at a
     // particular timestamp as estimated by SensorFusion.
-    PoseState GetLatestPoseState() const;
+    PoseStateT<T> GetLatestPoseState() const;
 
     // Processes one gyroscope sample event. This updates the pose of the system
     // and the prediction model. The gyroscope data is assumed to be in axis angle
     // form. Angle = ||v|| and Axis = v / ||v||, with v = [v_x, v_y, v_z]^T.
     //
     // @param sample gyroscope sample data.
-    void ProcessGyroscopeSample(const GyroscopeData& sample);
+    void ProcessGyroscopeSample(const GyroscopeDataT<T>& sample);
 
     // Processes one accelerometer sample event. This updates the pose of the
     // system. If the Accelerometer norm changes too much between sample it is not
     // trusted as much.
     //
     // @param sample accelerometer sample data.
-    void ProcessAccelerometerSample(const AccelerometerData& sample);
+    void ProcessAccelerometerSample(const AccelerometerDataT<T>& sample);
 
     // Enables or disables the drift correction by estimating the gyroscope bias.
     //
@@ -76,7 +77,7 @@ public:
     bool IsBiasEstimationEnabled() const;
 
     // Returns the current gyroscope bias estimate from GyroscopeBiasEstimator.
-    Vector3 GetGyroscopeBias() const {
+    Vector<3, T> GetGyroscopeBias() const {
         return {
             gyroscope_bias_estimate_[0], gyroscope_bias_estimate_[1], gyroscope_bias_estimate_[2]};
     }
@@ -88,16 +89,16 @@ public:
 
 private:
     // Estimates the average timestep between gyroscope event.
-    void FilterGyroscopeTimestep(double gyroscope_timestep);
+    void FilterGyroscopeTimestep(T gyroscope_timestep);
 
     // Updates the state covariance with an incremental motion. It changes the
     // space of the quadric.
-    void UpdateStateCovariance(const Matrix3x3& motion_update);
+    void UpdateStateCovariance(const Matrix3x3T<T>& motion_update);
 
     // Computes the innovation vector of the Kalman based on the input pose.
     // It uses the latest measurement vector (i.e. accelerometer data), which must
     // be set prior to calling this function.
-    Vector3 ComputeInnovation(const Rotation& pose);
+    Vector<3, T> ComputeInnovation(const RotationT<T>& pose);
 
     // This computes the measurement_jacobian_ via numerical differentiation based
     // on the current value of sensor_from_start_rotation_.
@@ -116,7 +117,7 @@ private:
 
     // Current transformation from Sensor Space to Start Space.
     // x_sensor = sensor_from_start_rotation_ * x_start;
-    PoseState current_state_;
+    PoseStateT<T> current_state_;
 
     // Filtering of the gyroscope timestep started?
     bool is_timestep_filter_initialized_;
@@ -128,28 +129,28 @@ private:
     std::atomic<bool> is_aligned_with_gravity_;
 
     // Covariance of Kalman filter state (P in common formulation).
-    Matrix3x3 state_covariance_;
+    Matrix3x3T<T> state_covariance_;
     // Covariance of the process noise (Q in common formulation).
-    Matrix3x3 process_covariance_;
+    Matrix3x3T<T> process_covariance_;
     // Covariance of the accelerometer measurement (R in common formulation).
-    Matrix3x3 accelerometer_measurement_covariance_;
+    Matrix3x3T<T> accelerometer_measurement_covariance_;
     // Covariance of innovation (S in common formulation).
-    Matrix3x3 innovation_covariance_;
+    Matrix3x3T<T> innovation_covariance_;
     // Jacobian of the measurements (H in common formulation).
-    Matrix3x3 accelerometer_measurement_jacobian_;
+    Matrix3x3T<T> accelerometer_measurement_jacobian_;
     // Gain of the Kalman filter (K in common formulation).
-    Matrix3x3 kalman_gain_;
+    Matrix3x3T<T> kalman_gain_;
     // Parameter update a.k.a. innovation vector. (\nu in common formulation).
-    Vector3 innovation_;
+    Vector<3, T> innovation_;
     // Measurement vector (z in common formulation).
-    Vector3 accelerometer_measurement_;
+    Vector<3, T> accelerometer_measurement_;
     // Current prediction vector (g in common formulation).
-    Vector3 prediction_;
+    Vector<3, T> prediction_;
     // Control input, currently this is only the gyroscope data (\mu in common
     // formulation).
-    Vector3 control_input_;
+    Vector<3, T> control_input_;
     // Update of the state vector. (x in common formulation).
-    Vector3 state_update_;
+    Vector<3, T> state_update_;
 
     // Sensor time of the last gyroscope processed event.
     uint64_t current_gyroscope_sensor_timestamp_ns_;
@@ -157,14 +158,14 @@ private:
     uint64_t current_accelerometer_sensor_timestamp_ns_;
 
     // Estimates of the timestep between gyroscope event in seconds.
-    double filtered_gyroscope_timestep_s_;
+    T filtered_gyroscope_timestep_s_;
     // Number of timestep samples processed so far by the filter.
     uint32_t num_gyroscope_timestep_samples_;
     // Norm of the accelerometer for the previous measurement.
-    double previous_accelerometer_norm_;
+    T previous_accelerometer_norm_;
     // Moving average of the accelerometer norm changes. It is computed for every
     // sensor datum.
-    double moving_average_accelerometer_norm_change_;
+    T moving_average_accelerometer_norm_change_;
 
     // Flag indicating if a state reset should be executed with the next
     // accelerometer sample.
@@ -174,15 +175,17 @@ private:
     std::atomic<bool> bias_estimation_enabled_;
 
     // Bias estimator and static device detector.
-    GyroscopeBiasEstimator gyroscope_bias_estimator_;
+    GyroscopeBiasEstimatorT<T> gyroscope_bias_estimator_;
 
     // Current bias estimate_;
-    Vector3 gyroscope_bias_estimate_;
+    Vector<3, T> gyroscope_bias_estimate_;
 
-    SensorFusionEkf(const SensorFusionEkf&) = delete;
-    SensorFusionEkf& operator=(const SensorFusionEkf&) = delete;
+    SensorFusionEkfT(const SensorFusionEkfT&) = delete;
+    SensorFusionEkfT& operator=(const SensorFusionEkfT&) = delete;
 };
 
+typedef SensorFusionEkfT<Scalar> SensorFusionEkf;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_SENSORS_SENSOR_FUSION_EKF_H_
@@ -17,13 +17,15 @@
 
 namespace cardboard {
 
-Matrix3x3::Matrix3x3(double m00, double m01, double m02, double m10, double m11, double m12,
-    double m20, double m21, double m22)
+template <typename T>
+Matrix3x3T<T>::Matrix3x3T(T m00, T m01, T m02, T m10, T m11, T m12,
+    T m20, T m21, T m22)
     : elem_ { { { m00, m01, m02 }, { m10, m11, m12 }, { m20, m21, m22 } } }
 {
 }
 
-Matrix3x3::Matrix3x3()
+template <typename T>
+Matrix3x3T<T>::Matrix3x3T()
 {
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col)
@@ -31,22 +33,25 @@ Matrix3x3::Matrix3x3()
     }
 }
 
-Matrix3x3 Matrix3x3::Zero()
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::Zero()
 {
-    Matrix3x3 result;
+    Matrix3x3T<T> result;
     return result;
 }
 
-Matrix3x3 Matrix3x3::Identity()
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::Identity()
 {
-    Matrix3x3 result;
+    Matrix3x3T<T> result;
     for (int row = 0; row < 3; ++row) {
         result.elem_[row][row] = 1;
     }
     return result;
 }
 
-void Matrix3x3::MultiplyScalar(double s)
+template <typename T>
+void Matrix3x3T<T>::MultiplyScalar(T s)
 {
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col)
@@ -54,9 +59,10 @@ void Matrix3x3::MultiplyScalar(double s)
     }
 }
 
-Matrix3x3 Matrix3x3::Negation() const
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::Negation() const
 {
-    Matrix3x3 result;
+    Matrix3x3T<T> result;
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col)
             result.elem_[row][col] = -elem_[row][col];
@@ -64,9 +70,10 @@ Matrix3x3 Matrix3x3::Negation() const
     return result;
 }
 
-Matrix3x3 Matrix3x3::Scale(const Matrix3x3& m, double s)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::Scale(const Matrix3x3T<T>& m, T s)
 {
-    Matrix3x3 result;
+    Matrix3x3T<T> result;
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col)
             result.elem_[row][col] = m.elem_[row][col] * s;
@@ -74,9 +81,10 @@ Matrix3x3 Matrix3x3::Scale(const Matrix3x3& m, double s)
     return result;
 }
 
-Matrix3x3 Matrix3x3::Addition(const Matrix3x3& lhs, const Matrix3x3& rhs)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::Addition(const Matrix3x3T<T>& lhs, const Matrix3x3T<T>& rhs)
 {
-    Matrix3x3 result;
+    Matrix3x3T<T> result;
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col)
             result.elem_[row][col] = lhs.elem_[row][col] + rhs.elem_[row][col];
@@ -84,9 +92,10 @@ Matrix3x3 Matrix3x3::Addition(const Matrix3x3& lhs, const Matrix3x3& rhs)
     return result;
 }
 
-Matrix3x3 Matrix3x3::Subtraction(const Matrix3x3& lhs, const Matrix3x3& rhs)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::Subtraction(const Matrix3x3T<T>& lhs, const Matrix3x3T<T>& rhs)
 {
-    Matrix3x3 result;
+    Matrix3x3T<T> result;
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col)
             result.elem_[row][col] = lhs.elem_[row][col] - rhs.elem_[row][col];
@@ -94,9 +103,10 @@ Matrix3x3 Matrix3x3::Subtraction(const Matrix3x3& lhs, const Matrix3x3& rhs)
     return result;
 }
 
-Matrix3x3 Matrix3x3::Product(const Matrix3x3& m0, const Matrix3x3& m1)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::Product(const Matrix3x3T<T>& m0, const Matrix3x3T<T>& m1)
 {
-    Matrix3x3 result;
+    Matrix3x3T<T> result;
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col) {
             result.elem_[row][col] = 0;
@@ -107,7 +117,8 @@ Matrix3x3 Matrix3x3::Product(const Matrix3x3& m0, const Matrix3x3& m1)
     return result;
 }
 
-bool Matrix3x3::AreEqual(const Matrix3x3& m0, const Matrix3x3& m1)
+template <typename T>
+bool Matrix3x3T<T>::AreEqual(const Matrix3x3T<T>& m0, const Matrix3x3T<T>& m1)
 {
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col) {
@@ -118,4 +129,7 @@ bool Matrix3x3::AreEqual(const Matrix3x3& m0, const Matrix3x3& m1)
     return true;
 }
 
+#define INSTANTIATE_MATRIX_3X3(T) template class Matrix3x3T<T>;
+CARDBOARD_INSTANTIATE(INSTANTIATE_MATRIX_3X3)
+
 } // namespace cardboard
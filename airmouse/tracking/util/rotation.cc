@@ -15,6 +15,7 @@
  */
 #include "rotation.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -22,83 +23,90 @@
 
 namespace cardboard {
 
-void Rotation::SetAxisAndAngle(const VectorType& axis, double angle)
+template <typename T>
+void RotationT<T>::SetAxisAndAngle(const VectorType& axis, T angle)
 {
     VectorType unit_axis = axis;
     if (!Normalize(&unit_axis)) {
         *this = Identity();
     } else {
-        double a = angle / 2;
-        const double s = sin(a);
+        T a = angle / 2;
+        const T s = std::sin(a);
         const VectorType v(unit_axis * s);
-        SetQuaternion(QuaternionType(v[0], v[1], v[2], cos(a)));
+        SetQuaternion(QuaternionType(v[0], v[1], v[2], std::cos(a)));
     }
 }
 
-Rotation Rotation::FromRotationMatrix(const Matrix3x3& mat)
+template <typename T>
+RotationT<T> RotationT<T>::FromRotationMatrix(const Matrix3x3T<T>& mat)
 {
-    static const double kOne = 1.0;
-    static const double kFour = 4.0;
+    static const T kOne = 1;
+    static const T kFour = 4;
 
-    const double d0 = mat(0, 0), d1 = mat(1, 1), d2 = mat(2, 2);
-    const double ww = kOne + d0 + d1 + d2;
-    const double xx = kOne + d0 - d1 - d2;
-    const double yy = kOne - d0 + d1 - d2;
-    const double zz = kOne - d0 - d1 + d2;
+    const T d0 = mat(0, 0), d1 = mat(1, 1), d2 = mat(2, 2);
+    const T ww = kOne + d0 + d1 + d2;
+    const T xx = kOne + d0 - d1 - d2;
+    const T yy = kOne - d0 + d1 - d2;
+    const T zz = kOne - d0 - d1 + d2;
 
-    const double max = std::max(ww, std::max(xx, std::max(yy, zz)));
+    const T max = std::max(ww, std::max(xx, std::max(yy, zz)));
     if (ww == max) {
-        const double w4 = sqrt(ww * kFour);
-        return Rotation::FromQuaternion(QuaternionType((mat(2, 1) - mat(1, 2)) / w4,
+        const T w4 = std::sqrt(ww * kFour);
+        return RotationT::FromQuaternion(QuaternionType((mat(2, 1) - mat(1, 2)) / w4,
             (mat(0, 2) - mat(2, 0)) / w4, (mat(1, 0) - mat(0, 1)) / w4, w4 / kFour));
     }
 
     if (xx == max) {
-        const double x4 = sqrt(xx * kFour);
-        return Rotation::FromQuaternion(QuaternionType(x4 / kFour, (mat(0, 1) + mat(1, 0)) / x4,
+        const T x4 = std::sqrt(xx * kFour);
+        return RotationT::FromQuaternion(QuaternionType(x4 / kFour, (mat(0, 1) + mat(1, 0)) / x4,
             (mat(0, 2) + mat(2, 0)) / x4, (mat(2, 1) - mat(1, 2)) / x4));
     }
 
     if (yy == max) {
-        const double y4 = sqrt(yy * kFour);
-        return Rotation::FromQuaternion(QuaternionType((mat(0, 1) + mat(1, 0)) / y4, y4 / kFour,
+        const T y4 = std::sqrt(yy * kFour);
+        return RotationT::FromQuaternion(QuaternionType((mat(0, 1) + mat(1, 0)) / y4, y4 / kFour,
             (mat(1, 2) + mat(2, 1)) / y4, (mat(0, 2) - mat(2, 0)) / y4));
     }
 
     // zz is the largest component.
-    const double z4 = sqrt(zz * kFour);
-    return Rotation::FromQuaternion(QuaternionType((mat(0, 2) + mat(2, 0)) / z4,
+    const T z4 = std::sqrt(zz * kFour);
+    return RotationT::FromQuaternion(QuaternionType((mat(0, 2) + mat(2, 0)) / z4,
         (mat(1, 2) + mat(2, 1)) / z4, z4 / kFour, (mat(1, 0) - mat(0, 1)) / z4));
 }
 
-void Rotation::GetAxisAndAngle(VectorType* axis, double* angle) const
+template <typename T>
+void RotationT<T>::GetAxisAndAngle(VectorType* axis, T* angle) const
 {
     VectorType vec(quat_[0], quat_[1], quat_[2]);
-    if (Normalize(&vec)) {
-        *angle = 2 * acos(quat_[3]);
-        *axis = vec;
+    const T sin_half_angle = Length(vec);
+    if (sin_half_angle > 0) {
+        // atan2 keeps full precision for small angles, where acos(w) of a w
+        // rounded to 1 collapses to zero (most visibly in single precision).
+        *angle = 2 * std::atan2(sin_half_angle, quat_[3]);
+        *axis = vec / sin_half_angle;
     } else {
         *axis = VectorType(1, 0, 0);
-        *angle = 0.0;
+        *angle = 0;
     }
 }
 
-Rotation Rotation::RotateInto(const VectorType& from, const VectorType& to)
+template <typename T>
+RotationT<T> RotationT<T>::RotateInto(const VectorType& from, const VectorType& to)
 {
-    static const double kTolerance = std::numeric_limits<double>::epsilon() * 100;
+    static const T kTolerance = std::numeric_limits<T>::epsilon() * 100;
 
     // Directly build the quaternion using the following technique:
     // http://lolengine.net/blog/2014/02/24/quaternion-from-two-vectors-final
-    const double norm_u_norm_v = sqrt(LengthSquared(from) * LengthSquared(to));
-    double real_part = norm_u_norm_v + Dot(from, to);
+    const T norm_u_norm_v = std::sqrt(LengthSquared(from) * LengthSquared(to));
+    T real_part = norm_u_norm_v + Dot(from, to);
     VectorType w;
     if (real_part < kTolerance * norm_u_norm_v) {
         // If |from| and |to| are exactly opposite, rotate 180 degrees around an
         // arbitrary orthogonal axis. Axis normalization can happen later, when we
         // normalize the quaternion.
-        real_part = 0.0;
-        w = (abs(from[0]) > abs(from[2])) ? VectorType(-from[1], from[0], 0)
-                                          : VectorType(0, -from[2], from[1]);
+        real_part = 0;
+        w = (std::abs(from[0]) > std::abs(from[2])) ? VectorType(-from[1], from[0], 0)
+                                                    : VectorType(0, -from[2], from[1]);
     } else {
         // Otherwise, build the quaternion the standard way.
         w = Cross(from, to);
@@ -106,12 +114,16 @@ Rotation Rotation::RotateInto(const VectorType& from, const VectorType& to)
 
     // Build and return a normalized quaternion.
     // Note that Rotation::FromQuaternion automatically performs normalization.
-    return Rotation::FromQuaternion(QuaternionType(w[0], w[1], w[2], real_part));
+    return RotationT::FromQuaternion(QuaternionType(w[0], w[1], w[2], real_part));
 }
 
-Rotation::VectorType Rotation::operator*(const Rotation::VectorType& v) const
+template <typename T>
+typename RotationT<T>::VectorType RotationT<T>::operator*(const VectorType& v) const
 {
     return ApplyToVector(v);
 }
 
+#define INSTANTIATE_ROTATION(T) template class RotationT<T>;
+CARDBOARD_INSTANTIATE(INSTANTIATE_ROTATION)
+
 } // namespace cardboard
@@ -22,22 +22,23 @@
 
 namespace cardboard {
 
-// The Rotation class represents a rotation around a 3-dimensional axis. It
-// uses normalized quaternions internally to make the math robust.
-class Rotation {
+// The RotationT class represents a rotation around a 3-dimensional axis. It
+// uses normalized quaternions of type T internally to make the math robust.
+template <typename T>
+class RotationT {
 public:
     // Convenience typedefs for vector of the correct type.
-    typedef Vector<3> VectorType;
-    typedef Vector<4> QuaternionType;
+    typedef Vector<3, T> VectorType;
+    typedef Vector<4, T> QuaternionType;
 
     // The default constructor creates an identity Rotation, which has no effect.
-    Rotation() {
+    RotationT() {
         quat_.Set(0, 0, 0, 1);
     }
 
     // Returns an identity Rotation, which has no effect.
-    static Rotation Identity() {
-        return Rotation();
+    static RotationT Identity() {
+        return RotationT();
     }
 
     // Sets the Rotation from a quaternion (4D vector), which is first normalized.
@@ -53,37 +54,37 @@ public:
     // Sets the Rotation to rotate by the given angle around the given axis,
     // following the right-hand rule. The axis does not need to be unit
     // length. If it is zero length, this results in an identity Rotation.
-    void SetAxisAndAngle(const VectorType& axis, double angle);
+    void SetAxisAndAngle(const VectorType& axis, T angle);
 
     // Returns the right-hand rule axis and angle corresponding to the
     // Rotation. If the Rotation is the identity rotation, this returns the +X
     // axis and an angle of 0.
-    void GetAxisAndAngle(VectorType* axis, double* angle) const;
+    void GetAxisAndAngle(VectorType* axis, T* angle) const;
 
     // Convenience function that constructs and returns a Rotation given an axis
     // and angle.
-    static Rotation FromAxisAndAngle(const VectorType& axis, double angle) {
-        Rotation r;
+    static RotationT FromAxisAndAngle(const VectorType& axis, T angle) {
+        RotationT r;
         r.SetAxisAndAngle(axis, angle);
         return r;
     }
 
     // Convenience function that constructs and returns a Rotation given a
     // quaternion.
-    static Rotation FromQuaternion(const QuaternionType& quat) {
-        Rotation r;
+    static RotationT FromQuaternion(const QuaternionType& quat) {
+        RotationT r;
         r.SetQuaternion(quat);
         return r;
     }
 
     // Convenience function that constructs and returns a Rotation given a
     // rotation matrix R with $R^\top R = I && det(R) = 1$.
-    static Rotation FromRotationMatrix(const Matrix3x3& mat);
+    static RotationT FromRotationMatrix(const Matrix3x3T<T>& mat);
 
     // Convenience function that constructs and returns a Rotation given Euler
     // angles that are applied in the order of rotate-Z by roll, rotate-X by
     // pitch, rotate-Y by yaw (same as GetRollPitchYaw).
-    static Rotation FromRollPitchYaw(double roll, double pitch, double yaw) {
+    static RotationT FromRollPitchYaw(T roll, T pitch, T yaw) {
         VectorType x(1, 0, 0), y(0, 1, 0), z(0, 0, 1);
         return FromAxisAndAngle(z, roll) * (FromAxisAndAngle(x, pitch) * FromAxisAndAngle(y, yaw));
     }
@@ -91,7 +92,7 @@ public:
     // Convenience function that constructs and returns a Rotation given Euler
     // angles that are applied in the order of rotate-Y by yaw, rotate-X by
     // pitch, rotate-Z by roll (same as GetYawPitchRoll).
-    static Rotation FromYawPitchRoll(double yaw, double pitch, double roll) {
+    static RotationT FromYawPitchRoll(T yaw, T pitch, T roll) {
         VectorType x(1, 0, 0), y(0, 1, 0), z(0, 0, 1);
         return FromAxisAndAngle(y, yaw) * (FromAxisAndAngle(x, pitch) * FromAxisAndAngle(z, roll));
     }
@@ -99,17 +100,17 @@ public:
     // Constructs and returns a Rotation that rotates one vector to another along
     // the shortest arc. This returns an identity rotation if either vector has
     // zero length.
-    static Rotation RotateInto(const VectorType& from, const VectorType& to);
+    static RotationT RotateInto(const VectorType& from, const VectorType& to);
 
     // The negation operator returns the inverse rotation.
-    friend Rotation operator-(const Rotation& r) {
+    friend RotationT operator-(const RotationT& r) {
         // Because we store normalized quaternions, the inverse is found by
         // negating the vector part.
-        return Rotation(-r.quat_[0], -r.quat_[1], -r.quat_[2], r.quat_[3]);
+        return RotationT(-r.quat_[0], -r.quat_[1], -r.quat_[2], r.quat_[3]);
     }
 
     // Appends a rotation to this one.
-    Rotation& operator*=(const Rotation& r) {
+    RotationT& operator*=(const RotationT& r) {
         const QuaternionType& qr = r.quat_;
         QuaternionType& qt = quat_;
         SetQuaternion(QuaternionType(
@@ -121,8 +122,8 @@ public:
     }
 
     // Binary multiplication operator - returns a composite Rotation.
-    friend const Rotation operator*(const Rotation& r0, const Rotation& r1) {
-        Rotation r = r0;
+    friend const RotationT operator*(const RotationT& r0, const RotationT& r1) {
+        RotationT r = r0;
         r *= r1;
         return r;
     }
@@ -132,7 +133,7 @@ public:
 
 private:
     // Private constructor that builds a Rotation from quaternion components.
-    Rotation(double q0, double q1, double q2, double q3)
+    RotationT(T q0, T q1, T q2, T q3)
         : quat_(q0, q1, q2, q3) {
     }
 
@@ -140,7 +141,7 @@ private:
     // http://blog.molecular-matters.com/2013/05/24/a-faster-quaternion-vector-multiplication/
     VectorType ApplyToVector(const VectorType& v) const {
         VectorType im(quat_[0], quat_[1], quat_[2]);
-        VectorType temp = 2.0 * Cross(im, v);
+        VectorType temp = T(2) * Cross(im, v);
         return v + quat_[3] * temp + Cross(im, temp);
     }
 
@@ -151,6 +152,8 @@ private:
     QuaternionType quat_;
 };
 
+typedef RotationT<Scalar> Rotation;
+
 } // namespace cardboard
 
 #endif // CARDBOARD_SDK_UTIL_ROTATION_H_
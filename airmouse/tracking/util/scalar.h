@@ -0,0 +1,37 @@
+/*
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_SCALAR_H_
+#define CARDBOARD_SDK_UTIL_SCALAR_H_
+
+namespace cardboard {
+
+// Scalar type the tracking math runs on. The Cortex-M4 FPU only handles single
+// precision, double arithmetic falls back to software emulation.
+typedef float Scalar;
+
+} // namespace cardboard
+
+// Expands macro(T) for every scalar type the templated classes and functions
+// are explicitly instantiated for. The double instantiation is only built when
+// CARDBOARD_INSTANTIATE_DOUBLE is defined (e.g. to replay sensor traces on a
+// host), so the firmware does not carry code it never runs.
+#ifdef CARDBOARD_INSTANTIATE_DOUBLE
+#define CARDBOARD_INSTANTIATE(macro) macro(float) macro(double)
+#else
+#define CARDBOARD_INSTANTIATE(macro) macro(float)
+#endif
+
+#endif // CARDBOARD_SDK_UTIL_SCALAR_H_
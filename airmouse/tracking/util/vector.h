@@ -18,34 +18,36 @@
 
 #include <array>
 
+#include "scalar.h"
+
 namespace cardboard {
 
-// Geometric N-dimensional Vector class.
-template <int Dimension>
+// Geometric N-dimensional Vector class with elements of type T.
+template <int Dimension, typename T = Scalar>
 class Vector {
 public:
     // The default constructor zero-initializes all elements.
     Vector();
 
     // Dimension-specific constructors that are passed individual element values.
-    constexpr Vector(double e0, double e1, double e2);
-    constexpr Vector(double e0, double e1, double e2, double e3);
+    constexpr Vector(T e0, T e1, T e2);
+    constexpr Vector(T e0, T e1, T e2, T e3);
 
     // Constructor for a Vector of dimension N from a Vector of dimension N-1 and
     // a scalar of the correct type, assuming N is at least 2.
-    // constexpr Vector(const Vector<Dimension - 1>& v, double s);
+    // constexpr Vector(const Vector<Dimension - 1, T>& v, T s);
 
-    void Set(double e0, double e1, double e2); // Only when Dimension == 3.
-    void Set(double e0, double e1, double e2,
-             double e3); // Only when Dimension == 4.
+    void Set(T e0, T e1, T e2); // Only when Dimension == 3.
+    void Set(T e0, T e1, T e2,
+             T e3); // Only when Dimension == 4.
 
     // Mutable element accessor.
-    double& operator[](int index) {
+    T& operator[](int index) {
         return elem_[index];
     }
 
     // Element accessor.
-    double operator[](int index) const {
+    T operator[](int index) const {
         return elem_[index];
     }
 
@@ -59,10 +61,10 @@ public:
     void operator-=(const Vector& v) {
         Subtract(v);
     }
-    void operator*=(double s) {
+    void operator*=(T s) {
         Multiply(s);
     }
-    void operator/=(double s) {
+    void operator/=(T s) {
         Divide(s);
     }
 
@@ -78,16 +80,16 @@ public:
     friend Vector operator-(const Vector& v0, const Vector& v1) {
         return Difference(v0, v1);
     }
-    friend Vector operator*(const Vector& v, double s) {
+    friend Vector operator*(const Vector& v, T s) {
         return Scale(v, s);
     }
-    friend Vector operator*(double s, const Vector& v) {
+    friend Vector operator*(T s, const Vector& v) {
         return Scale(v, s);
     }
     friend Vector operator*(const Vector& v, const Vector& s) {
         return Product(v, s);
     }
-    friend Vector operator/(const Vector& v, double s) {
+    friend Vector operator/(const Vector& v, T s) {
         return Divide(v, s);
     }
 
@@ -96,9 +98,9 @@ public:
     // Self-modifying subtraction.
     void Subtract(const Vector& v);
     // Self-modifying multiplication by a scalar.
-    void Multiply(double s);
+    void Multiply(T s);
     // Self-modifying division by a scalar.
-    void Divide(double s);
+    void Divide(T s);
 
     // Unary negation.
     Vector Negation() const;
@@ -110,29 +112,29 @@ public:
     // Binary component-wise subtraction.
     static Vector Difference(const Vector& v0, const Vector& v1);
     // Binary multiplication by a scalar.
-    static Vector Scale(const Vector& v, double s);
+    static Vector Scale(const Vector& v, T s);
     // Binary division by a scalar.
-    static Vector Divide(const Vector& v, double s);
+    static Vector Divide(const Vector& v, T s);
 
 private:
-    std::array<double, Dimension> elem_;
+    std::array<T, Dimension> elem_;
 };
 //------------------------------------------------------------------------------
 
-template <int Dimension>
-Vector<Dimension>::Vector() {
+template <int Dimension, typename T>
+Vector<Dimension, T>::Vector() {
     for(int i = 0; i < Dimension; i++) {
         elem_[i] = 0;
     }
 }
 
-template <int Dimension>
-constexpr Vector<Dimension>::Vector(double e0, double e1, double e2)
+template <int Dimension, typename T>
+constexpr Vector<Dimension, T>::Vector(T e0, T e1, T e2)
     : elem_{e0, e1, e2} {
 }
 
-template <int Dimension>
-constexpr Vector<Dimension>::Vector(double e0, double e1, double e2, double e3)
+template <int Dimension, typename T>
+constexpr Vector<Dimension, T>::Vector(T e0, T e1, T e2, T e3)
     : elem_{e0, e1, e2, e3} {
 }
 /*
@@ -140,111 +142,111 @@ template <>
 constexpr Vector<4>::Vector(const Vector<3>& v, double s)
     : elem_{v[0], v[1], v[2], s} {}
 */
-template <int Dimension>
-void Vector<Dimension>::Set(double e0, double e1, double e2) {
+template <int Dimension, typename T>
+void Vector<Dimension, T>::Set(T e0, T e1, T e2) {
     elem_[0] = e0;
     elem_[1] = e1;
     elem_[2] = e2;
 }
 
-template <int Dimension>
-void Vector<Dimension>::Set(double e0, double e1, double e2, double e3) {
+template <int Dimension, typename T>
+void Vector<Dimension, T>::Set(T e0, T e1, T e2, T e3) {
     elem_[0] = e0;
     elem_[1] = e1;
     elem_[2] = e2;
     elem_[3] = e3;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Zero() {
-    Vector<Dimension> v;
+template <int Dimension, typename T>
+Vector<Dimension, T> Vector<Dimension, T>::Zero() {
+    Vector<Dimension, T> v;
     return v;
 }
 
-template <int Dimension>
-void Vector<Dimension>::Add(const Vector& v) {
+template <int Dimension, typename T>
+void Vector<Dimension, T>::Add(const Vector& v) {
     for(int i = 0; i < Dimension; i++) {
         elem_[i] += v[i];
     }
 }
 
-template <int Dimension>
-void Vector<Dimension>::Subtract(const Vector& v) {
+template <int Dimension, typename T>
+void Vector<Dimension, T>::Subtract(const Vector& v) {
     for(int i = 0; i < Dimension; i++) {
         elem_[i] -= v[i];
     }
 }
 
-template <int Dimension>
-void Vector<Dimension>::Multiply(double s) {
+template <int Dimension, typename T>
+void Vector<Dimension, T>::Multiply(T s) {
     for(int i = 0; i < Dimension; i++) {
         elem_[i] *= s;
     }
 }
 
-template <int Dimension>
-void Vector<Dimension>::Divide(double s) {
+template <int Dimension, typename T>
+void Vector<Dimension, T>::Divide(T s) {
     for(int i = 0; i < Dimension; i++) {
         elem_[i] /= s;
     }
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Negation() const {
-    Vector<Dimension> ret;
+template <int Dimension, typename T>
+Vector<Dimension, T> Vector<Dimension, T>::Negation() const {
+    Vector<Dimension, T> ret;
     for(int i = 0; i < Dimension; i++) {
         ret.elem_[i] = -elem_[i];
     }
     return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Product(const Vector& v0, const Vector& v1) {
-    Vector<Dimension> ret;
+template <int Dimension, typename T>
+Vector<Dimension, T> Vector<Dimension, T>::Product(const Vector& v0, const Vector& v1) {
+    Vector<Dimension, T> ret;
     for(int i = 0; i < Dimension; i++) {
         ret.elem_[i] = v0[i] * v1[i];
     }
     return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Sum(const Vector& v0, const Vector& v1) {
-    Vector<Dimension> ret;
+template <int Dimension, typename T>
+Vector<Dimension, T> Vector<Dimension, T>::Sum(const Vector& v0, const Vector& v1) {
+    Vector<Dimension, T> ret;
     for(int i = 0; i < Dimension; i++) {
         ret.elem_[i] = v0[i] + v1[i];
     }
     return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Difference(const Vector& v0, const Vector& v1) {
-    Vector<Dimension> ret;
+template <int Dimension, typename T>
+Vector<Dimension, T> Vector<Dimension, T>::Difference(const Vector& v0, const Vector& v1) {
+    Vector<Dimension, T> ret;
     for(int i = 0; i < Dimension; i++) {
         ret.elem_[i] = v0[i] - v1[i];
     }
     return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Scale(const Vector& v, double s) {
-    Vector<Dimension> ret;
+template <int Dimension, typename T>
+Vector<Dimension, T> Vector<Dimension, T>::Scale(const Vector& v, T s) {
+    Vector<Dimension, T> ret;
     for(int i = 0; i < Dimension; i++) {
         ret.elem_[i] = v[i] * s;
     }
     return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Divide(const Vector& v, double s) {
-    Vector<Dimension> ret;
+template <int Dimension, typename T>
+Vector<Dimension, T> Vector<Dimension, T>::Divide(const Vector& v, T s) {
+    Vector<Dimension, T> ret;
     for(int i = 0; i < Dimension; i++) {
         ret.elem_[i] = v[i] / s;
     }
     return ret;
 }
 
-typedef Vector<3> Vector3;
-typedef Vector<4> Vector4;
+typedef Vector<3, Scalar> Vector3;
+typedef Vector<4, Scalar> Vector4;
 
 } // namespace cardboard
 
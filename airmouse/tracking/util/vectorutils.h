@@ -27,31 +27,43 @@
 namespace cardboard {
 
 // Returns the dot (inner) product of two Vectors.
-double Dot(const Vector<3>& v0, const Vector<3>& v1);
+template <typename T>
+inline T Dot(const Vector<3, T>& v0, const Vector<3, T>& v1) {
+    return v0[0] * v1[0] + v0[1] * v1[1] + v0[2] * v1[2];
+}
 
 // Returns the dot (inner) product of two Vectors.
-double Dot(const Vector<4>& v0, const Vector<4>& v1);
+template <typename T>
+inline T Dot(const Vector<4, T>& v0, const Vector<4, T>& v1) {
+    return v0[0] * v1[0] + v0[1] * v1[1] + v0[2] * v1[2] + v0[3] * v1[3];
+}
 
 // Returns the 3-dimensional cross product of 2 Vectors. Note that this is
 // defined only for 3-dimensional Vectors.
-Vector<3> Cross(const Vector<3>& v0, const Vector<3>& v1);
+template <typename T>
+inline Vector<3, T> Cross(const Vector<3, T>& v0, const Vector<3, T>& v1) {
+    return Vector<3, T>(
+        v0[1] * v1[2] - v0[2] * v1[1],
+        v0[2] * v1[0] - v0[0] * v1[2],
+        v0[0] * v1[1] - v0[1] * v1[0]);
+}
 
 // Returns the square of the length of a Vector.
-template <int Dimension>
-double LengthSquared(const Vector<Dimension>& v) {
+template <int Dimension, typename T>
+T LengthSquared(const Vector<Dimension, T>& v) {
     return Dot(v, v);
 }
 
 // Returns the geometric length of a Vector.
-template <int Dimension>
-double Length(const Vector<Dimension>& v) {
-    return sqrt(LengthSquared(v));
+template <int Dimension, typename T>
+T Length(const Vector<Dimension, T>& v) {
+    return std::sqrt(LengthSquared(v));
 }
 
 // the Vector untouched and returns false.
-template <int Dimension>
-bool Normalize(Vector<Dimension>* v) {
-    const double len = Length(*v);
+template <int Dimension, typename T>
+bool Normalize(Vector<Dimension, T>* v) {
+    const T len = Length(*v);
     if(len == 0) {
         return false;
     } else {
@@ -62,13 +74,13 @@ bool Normalize(Vector<Dimension>* v) {
 
 // Returns a unit-length version of a Vector. If the given Vector has no
 // length, this returns a Zero() Vector.
-template <int Dimension>
-Vector<Dimension> Normalized(const Vector<Dimension>& v) {
-    Vector<Dimension> result = v;
+template <int Dimension, typename T>
+Vector<Dimension, T> Normalized(const Vector<Dimension, T>& v) {
+    Vector<Dimension, T> result = v;
     if(Normalize(&result))
         return result;
     else
-        return Vector<Dimension>::Zero();
+        return Vector<Dimension, T>::Zero();
 }
 
 } // namespace cardboard
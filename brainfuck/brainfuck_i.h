@@ -42,9 +42,9 @@ typedef unsigned char byte;
 
 #define BF_INST_BUFFER_SIZE 2048
 #define BF_OUTPUT_SIZE 512
-#define BF_STACK_INITIAL_SIZE 128
+#define BF_OUTPUT_FLUSH_MS 100
+#define BF_STACK_SIZE 4096
 #define BF_INPUT_BUFFER_SIZE 64
-#define BF_STACK_STEP_SIZE 32
 
 enum brainfuckCustomEvent {
     // Reserve first 100 events for button types and indexes, starting from 0
@@ -0,0 +1,73 @@
+// Runs a program through one of the interpreters: the output goes to stdout,
+// the op count and speed to stderr. BF_REF selects the original interpreter,
+// which counts source instructions, the app's worker counts compiled ops.
+//
+//   bf_app program.b [input]
+
+#include <stdio.h>
+#include <time.h>
+
+#include "brainfuck_i.h"
+#include "worker.h"
+
+#define BENCH_MIN_MS 200 // the program is rerun until this much time has passed
+
+const char message_blue_255, message_blue_0, message_do_not_reset;
+
+extern char* wOutput;
+#ifdef BF_REF
+extern int wOutputPtr;
+#define OUTPUT_SIZE wOutputPtr
+#else
+extern uint32_t wOutputHead;
+#define OUTPUT_SIZE wOutputHead
+#endif
+
+static double time_ms(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+}
+
+int main(int argc, char** argv) {
+    static BFApp app;
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s program.b [input]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* file = fopen(argv[1], "rb");
+    if(!file) {
+        perror(argv[1]);
+        return 2;
+    }
+    app.dataSize = fread(app.dataBuffer, 1, sizeof(app.dataBuffer) - 1, file);
+    bool too_big = fgetc(file) != EOF;
+    fclose(file);
+    if(too_big) {
+        fprintf(stderr, "%s: larger than %d bytes\n", argv[1], BF_INST_BUFFER_SIZE - 1);
+        return 2;
+    }
+    app.dataBuffer[app.dataSize] = 0;
+    strncpy(app.inputBuffer, argc > 2 ? argv[2] : "hello", sizeof(app.inputBuffer) - 1);
+
+    double ops = 0, elapsed = 0;
+    int runs = 0;
+    while(elapsed < BENCH_MIN_MS) {
+        double start = time_ms();
+        initWorker(&app);
+        beginWorker();
+        elapsed += time_ms() - start;
+        ops += getOpCount();
+        runs++;
+    }
+
+    fwrite(wOutput, 1, OUTPUT_SIZE, stdout);
+    fprintf(
+        stderr,
+        "%10.0f ops %8.3f ms %6.0f Mops/s\n",
+        ops / runs,
+        elapsed / runs,
+        ops / elapsed / 1000.0);
+    return 0;
+}
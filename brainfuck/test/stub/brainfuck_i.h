@@ -0,0 +1,100 @@
+#pragma once
+
+// Just enough of the app and the firmware for worker.c to build on the host
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BF_INST_BUFFER_SIZE 2048
+#define BF_OUTPUT_SIZE (1 << 20) // whole output is kept for the comparison
+#define BF_OUTPUT_FLUSH_MS 100
+#define BF_STACK_SIZE 4096
+#define BF_INPUT_BUFFER_SIZE 64
+
+// reference interpreter
+#define BF_STACK_INITIAL_SIZE 128
+#define BF_STACK_STEP_SIZE 32
+
+#define UNUSED(x) (void)(x)
+
+typedef struct {
+    int unused;
+} TextBox;
+
+typedef struct {
+    int unused;
+} NotificationApp;
+
+typedef struct {
+    void* port;
+    uint16_t pin;
+} GpioPin;
+
+#define GPIOC NULL
+#define LL_GPIO_PIN_13 (1 << 13)
+
+typedef const void* NotificationMessage;
+typedef const NotificationMessage NotificationSequence[];
+extern const char message_blue_255, message_blue_0, message_do_not_reset;
+
+typedef struct {
+    int unused;
+} FuriTimer;
+
+typedef void (*FuriTimerCallback)(void* context);
+
+typedef enum {
+    FuriTimerTypePeriodic,
+} FuriTimerType;
+
+typedef struct BFApp {
+    TextBox* text_box;
+    NotificationApp* notifications;
+    int dataSize;
+    char dataBuffer[BF_INST_BUFFER_SIZE];
+    char inputBuffer[BF_INPUT_BUFFER_SIZE];
+} BFApp;
+
+static inline void text_box_set_text(TextBox* text_box, const char* text) {
+    UNUSED(text_box);
+    UNUSED(text);
+}
+
+static inline void
+    notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    UNUSED(app);
+    UNUSED(sequence);
+}
+
+static inline bool furi_hal_gpio_read(const GpioPin* gpio) {
+    UNUSED(gpio);
+    return true; // back button released
+}
+
+static inline FuriTimer*
+    furi_timer_alloc(FuriTimerCallback callback, FuriTimerType type, void* context) {
+    UNUSED(callback);
+    UNUSED(type);
+    UNUSED(context);
+    static FuriTimer timer;
+    return &timer;
+}
+
+static inline void furi_timer_start(FuriTimer* timer, uint32_t ticks) {
+    UNUSED(timer);
+    UNUSED(ticks);
+}
+
+static inline void furi_timer_stop(FuriTimer* timer) {
+    UNUSED(timer);
+}
+
+static inline void furi_timer_free(FuriTimer* timer) {
+    UNUSED(timer);
+}
+
+static inline uint32_t furi_ms_to_ticks(uint32_t ms) {
+    return ms;
+}
@@ -1,291 +1,445 @@
-#include "worker.h"
-#include <furi_hal_resources.h>
-#include <furi.h>
-
-bool killswitch = false;
-
-int status = 0; //0: idle, 1: running, 2: failure
-
-char* inst = 0;
-int instCount = 0;
-int instPtr = 0;
-int runOpCount = 0;
-
-char* wOutput = 0;
-int wOutputPtr = 0;
-
-char* wInput = 0;
-int wInputPtr = 0;
-
-uint8_t* bfStack = 0;
-int stackPtr = 0;
-int stackSize = BF_STACK_INITIAL_SIZE;
-int stackSizeReal = 0;
-
-BFApp* wrkrApp = 0;
-
-void killThread() {
-    killswitch = true;
-}
-
-bool validateInstPtr() {
-    if(instPtr > instCount || instPtr < 0) {
-        return false;
-    }
-    return true;
-}
-
-bool validateStackPtr() {
-    if(stackPtr > stackSize || stackPtr < 0) {
-        return false;
-    }
-    return true;
-}
-
-char* workerGetOutput() {
-    return wOutput;
-}
-
-int getStackSize() {
-    return stackSizeReal;
-}
-
-int getOpCount() {
-    return runOpCount;
-}
-
-int getStatus() {
-    return status;
-}
-
-void initWorker(BFApp* app) {
-    wrkrApp = app;
-
-    //rebuild output
-    if(wOutput) {
-        free(wOutput);
-    }
-    wOutput = (char*)malloc(BF_OUTPUT_SIZE);
-    wOutputPtr = 0;
-
-    //rebuild stack
-    if(bfStack) {
-        free(bfStack);
-    }
-    bfStack = (uint8_t*)malloc(BF_STACK_INITIAL_SIZE);
-    memset(bfStack, 0x00, BF_STACK_INITIAL_SIZE);
-    stackSize = BF_STACK_INITIAL_SIZE;
-    stackSizeReal = 0;
-    stackPtr = 0;
-
-    //set instructions
-    inst = wrkrApp->dataBuffer;
-    instCount = wrkrApp->dataSize;
-    instPtr = 0;
-    runOpCount = 0;
-
-    //set input
-    wInput = wrkrApp->inputBuffer;
-    wInputPtr = 0;
-
-    //set status
-    status = 0;
-}
-
-void rShift() {
-    runOpCount++;
-    stackPtr++;
-    if(!validateStackPtr()) {
-        status = 2;
-        return;
-    }
-
-    while(stackPtr > stackSize) {
-        stackSize += BF_STACK_STEP_SIZE;
-        void* tmp = realloc(bfStack, stackSize);
-
-        if(!tmp) {
-            status = 2;
-            return;
-        }
-
-        memset((tmp + stackSize) - BF_STACK_STEP_SIZE, 0x00, BF_STACK_STEP_SIZE);
-        bfStack = (uint8_t*)tmp;
-    };
-    if(stackPtr > stackSizeReal) {
-        stackSizeReal = stackPtr;
-    }
-}
-
-void lShift() {
-    runOpCount++;
-    stackPtr--;
-    if(!validateStackPtr()) {
-        status = 2;
-        return;
-    }
-}
-
-void inc() {
-    runOpCount++;
-    if(!validateStackPtr()) {
-        status = 2;
-        return;
-    }
-    bfStack[stackPtr]++;
-}
-
-void dec() {
-    runOpCount++;
-    if(!validateStackPtr()) {
-        status = 2;
-        return;
-    }
-    bfStack[stackPtr]--;
-}
-
-void print() {
-    runOpCount++;
-    wOutput[wOutputPtr] = bfStack[stackPtr];
-    wOutputPtr++;
-    if(wOutputPtr > (BF_OUTPUT_SIZE - 1)) {
-        wOutputPtr = 0;
-    }
-}
-
-void input() {
-    runOpCount++;
-
-    bfStack[stackPtr] = (uint8_t)wInput[wInputPtr];
-    if(wInput[wInputPtr] == 0x00 || wInputPtr >= 64) {
-        wInputPtr = 0;
-    } else {
-        wInputPtr++;
-    }
-}
-
-void loop() {
-    runOpCount++;
-    if(bfStack[stackPtr] == 0) {
-        int loopCount = 1;
-        while(loopCount > 0) {
-            instPtr++;
-            if(!validateInstPtr()) {
-                status = 2;
-                return;
-            }
-            if(inst[instPtr] == '[') {
-                loopCount++;
-            } else if(inst[instPtr] == ']') {
-                loopCount--;
-            }
-        }
-    }
-}
-
-void endLoop() {
-    runOpCount++;
-    if(bfStack[stackPtr] != 0) {
-        int loopCount = 1;
-        while(loopCount > 0) {
-            instPtr--;
-            if(!validateInstPtr()) {
-                status = 2;
-                return;
-            }
-            if(inst[instPtr] == ']') {
-                loopCount++;
-            } else if(inst[instPtr] == '[') {
-                loopCount--;
-            }
-        }
-    }
-}
-
-static const NotificationSequence led_on = {
-    &message_blue_255,
-    &message_do_not_reset,
-    NULL,
-};
-
-static const NotificationSequence led_off = {
-    &message_blue_0,
-    NULL,
-};
-
-void input_kill(void* _ctx) {
-    UNUSED(_ctx);
-    killswitch = true;
-}
-
-void beginWorker() {
-    status = 1;
-
-    //redefined from furi_hal_resources.c
-    const GpioPin gpio_button_back = {.port = GPIOC, .pin = LL_GPIO_PIN_13};
-
-    while(inst[instPtr] != 0x00) {
-        if(runOpCount % 500 == 0) {
-            text_box_set_text(wrkrApp->text_box, workerGetOutput());
-            notification_message(wrkrApp->notifications, &led_on);
-        }
-
-        //status 2 indicates failure
-        if(status == 2) {
-            status = 0;
-            break;
-        }
-
-        //read back button directly to avoid weirdness in furi
-        if(killswitch || !furi_hal_gpio_read(&gpio_button_back)) {
-            status = 0;
-            killswitch = false;
-            break;
-        }
-
-        switch(inst[instPtr]) {
-        case '>':
-            rShift();
-            break;
-        case '<':
-            lShift();
-            break;
-
-        case '+':
-            inc();
-            break;
-
-        case '-':
-            dec();
-            break;
-
-        case '.':
-            print();
-            break;
-
-        case ',':
-            input();
-            break;
-
-        case '[':
-            loop();
-            break;
-
-        case ']':
-            endLoop();
-            break;
-
-        default:
-            break;
-        }
-        instPtr++;
-        if(!validateInstPtr()) {
-            status = 0;
-            break;
-        }
-    }
-
-    notification_message(wrkrApp->notifications, &led_off);
-    text_box_set_text(wrkrApp->text_box, workerGetOutput());
-    status = 0;
-}
\ No newline at end of file
+#include "worker.h"
+#include <furi_hal_resources.h>
+#include <furi.h>
+
+//bytecode the source is compiled into before running
+typedef enum {
+    opEnd,
+    opAdd, //cell += value, folded run of + and -
+    opMove, //ptr += arg, folded run of > and <
+    opOut,
+    opIn,
+    opJumpZero, //jump to arg if cell == 0
+    opJumpNonZero, //jump to arg if cell != 0
+    opClear, //cell = 0, [-] or [+]
+    opMulAdd, //cell[ptr + arg] += cell * value, body of loops like [->+>++<<]
+} bfOpCode;
+
+typedef struct {
+    uint8_t op;
+    uint8_t value;
+    int16_t arg;
+} bfOp;
+
+//max number of cells a move-add loop can touch to be folded
+#define BF_IDIOM_MAX_CELLS 8
+
+//back-edges taken between checks of the back button
+#define BF_KILL_CHECK_INTERVAL 256
+
+bool killswitch = false;
+
+int status = 0; //0: idle, 1: running, 2: failure
+
+char* inst = 0;
+int instCount = 0;
+int instPtr = 0;
+int runOpCount = 0;
+
+bfOp* program = 0;
+int programSize = 0;
+
+char* wOutput = 0; //ring buffer the program writes into
+uint32_t wOutputHead = 0;
+uint32_t wOutputFlushed = 0;
+char* wDisplay = 0; //last BF_OUTPUT_SIZE - 1 chars of output, shown in the text box
+
+char* wInput = 0;
+int wInputPtr = 0;
+
+uint8_t* bfStack = 0;
+int stackPtr = 0;
+int stackSize = BF_STACK_SIZE;
+int stackSizeReal = 0;
+
+BFApp* wrkrApp = 0;
+
+void killThread() {
+    killswitch = true;
+}
+
+bool validateStackPtr() {
+    if(stackPtr >= stackSize || stackPtr < 0) {
+        return false;
+    }
+    return true;
+}
+
+char* workerGetOutput() {
+    return wDisplay;
+}
+
+int getStackSize() {
+    return stackSizeReal;
+}
+
+int getOpCount() {
+    return runOpCount;
+}
+
+int getStatus() {
+    return status;
+}
+
+bool isCommand(char c) {
+    return c != 0x00 && strchr("<>+-.,[]", c) != NULL;
+}
+
+//folds the run of up/down chars starting at inst[*pos], returns the net count
+int foldRun(int* pos, char up, char down) {
+    int total = 0;
+    while(*pos < instCount) {
+        char c = inst[*pos];
+        if(c == up) {
+            total++;
+        } else if(c == down) {
+            total--;
+        } else if(isCommand(c) || c == 0x00) {
+            break;
+        }
+        (*pos)++;
+    }
+    return total;
+}
+
+//compiles the loop at inst[start] if it only adds to cells around the pointer and moves the
+//pointer back, e.g. [-] or [->+>++<<], returns the number of chars consumed or 0 if it doesn't
+int compileIdiomLoop(int start) {
+    int16_t offsets[BF_IDIOM_MAX_CELLS];
+    uint8_t deltas[BF_IDIOM_MAX_CELLS];
+    int cells = 0;
+    int offset = 0;
+
+    int i = start + 1;
+    for(; i < instCount && inst[i] != ']'; i++) {
+        char c = inst[i];
+        if(c == '>') {
+            offset++;
+        } else if(c == '<') {
+            offset--;
+        } else if(c == '+' || c == '-') {
+            int cell = 0;
+            while(cell < cells && offsets[cell] != offset) {
+                cell++;
+            }
+            if(cell == cells) {
+                if(cells == BF_IDIOM_MAX_CELLS) {
+                    return 0;
+                }
+                offsets[cell] = offset;
+                deltas[cell] = 0;
+                cells++;
+            }
+            deltas[cell] += (c == '+') ? 1 : -1;
+        } else if(c == '.' || c == ',' || c == '[' || c == 0x00) {
+            return 0;
+        }
+    }
+
+    if(i >= instCount || offset != 0) {
+        return 0;
+    }
+
+    //the loop counter is the cell at the pointer, it must step by one to be predictable
+    uint8_t counterDelta = 0;
+    for(int cell = 0; cell < cells; cell++) {
+        if(offsets[cell] == 0) {
+            counterDelta = deltas[cell];
+        }
+    }
+    if(counterDelta != 1 && counterDelta != 0xFF) {
+        return 0;
+    }
+
+    //counting down runs the body cell times, counting up (256 - cell) times
+    for(int cell = 0; cell < cells; cell++) {
+        if(offsets[cell] != 0 && deltas[cell] != 0) {
+            program[programSize].op = opMulAdd;
+            program[programSize].value = (counterDelta == 0xFF) ? deltas[cell] : -deltas[cell];
+            program[programSize].arg = offsets[cell];
+            programSize++;
+        }
+    }
+    program[programSize].op = opClear;
+    programSize++;
+
+    return i - start + 1;
+}
+
+//compiles the source into bytecode, returns false if the brackets don't match
+bool compileProgram() {
+    //open loops are linked through the arg of their opJumpZero until they are closed
+    int openLoop = -1;
+
+    programSize = 0;
+    instPtr = 0;
+    while(instPtr < instCount && inst[instPtr] != 0x00) {
+        bfOp* op = &program[programSize];
+        op->value = 0;
+        op->arg = 0;
+
+        switch(inst[instPtr]) {
+        case '+':
+        case '-': {
+            op->op = opAdd;
+            op->value = (uint8_t)foldRun(&instPtr, '+', '-');
+            if(op->value != 0) {
+                programSize++;
+            }
+            continue;
+        }
+
+        case '>':
+        case '<': {
+            int distance = foldRun(&instPtr, '>', '<');
+            if(distance != 0) {
+                op->op = opMove;
+                op->arg = distance;
+                programSize++;
+            }
+            continue;
+        }
+
+        case '.':
+            op->op = opOut;
+            programSize++;
+            break;
+
+        case ',':
+            op->op = opIn;
+            programSize++;
+            break;
+
+        case '[': {
+            int consumed = compileIdiomLoop(instPtr);
+            if(consumed > 0) {
+                instPtr += consumed;
+                continue;
+            }
+            op->op = opJumpZero;
+            op->arg = openLoop;
+            openLoop = programSize;
+            programSize++;
+            break;
+        }
+
+        case ']': {
+            if(openLoop < 0) {
+                return false;
+            }
+            int loopStart = openLoop;
+            openLoop = program[loopStart].arg;
+
+            op->op = opJumpNonZero;
+            op->arg = loopStart + 1;
+            program[loopStart].arg = programSize + 1;
+            programSize++;
+            break;
+        }
+
+        default:
+            break;
+        }
+        instPtr++;
+    }
+
+    program[programSize].op = opEnd;
+    programSize++;
+
+    return openLoop < 0;
+}
+
+void initWorker(BFApp* app) {
+    wrkrApp = app;
+
+    //rebuild output
+    if(wOutput) {
+        free(wOutput);
+    }
+    if(wDisplay) {
+        free(wDisplay);
+    }
+    wOutput = (char*)malloc(BF_OUTPUT_SIZE);
+    wDisplay = (char*)malloc(BF_OUTPUT_SIZE);
+    wDisplay[0] = 0x00;
+    wOutputHead = 0;
+    wOutputFlushed = 0;
+
+    //rebuild stack
+    if(bfStack) {
+        free(bfStack);
+    }
+    bfStack = (uint8_t*)malloc(BF_STACK_SIZE);
+    memset(bfStack, 0x00, BF_STACK_SIZE);
+    stackSize = BF_STACK_SIZE;
+    stackSizeReal = 0;
+    stackPtr = 0;
+
+    //set instructions, every op consumes at least one char of source
+    inst = wrkrApp->dataBuffer;
+    instCount = wrkrApp->dataSize;
+    runOpCount = 0;
+
+    if(program) {
+        free(program);
+    }
+    program = (bfOp*)malloc((instCount + 1) * sizeof(bfOp));
+    if(!compileProgram()) {
+        strcpy(wDisplay, "Error: unmatched bracket");
+        program[0].op = opEnd;
+    }
+    instPtr = 0;
+
+    //set input
+    wInput = wrkrApp->inputBuffer;
+    wInputPtr = 0;
+
+    //set status
+    status = 0;
+}
+
+void print() {
+    wOutput[wOutputHead % BF_OUTPUT_SIZE] = bfStack[stackPtr];
+    wOutputHead++;
+}
+
+void input() {
+    bfStack[stackPtr] = (uint8_t)wInput[wInputPtr];
+    if(wInput[wInputPtr] == 0x00 || wInputPtr >= 64) {
+        wInputPtr = 0;
+    } else {
+        wInputPtr++;
+    }
+}
+
+//copies the end of the output ring into the text box, called from the timer and on exit
+void flushOutput() {
+    uint32_t head = wOutputHead;
+    if(head == wOutputFlushed) {
+        return;
+    }
+    wOutputFlushed = head;
+
+    uint32_t count = (head < BF_OUTPUT_SIZE - 1) ? head : BF_OUTPUT_SIZE - 1;
+    for(uint32_t i = 0; i < count; i++) {
+        wDisplay[i] = wOutput[(head - count + i) % BF_OUTPUT_SIZE];
+    }
+    wDisplay[count] = 0x00;
+
+    text_box_set_text(wrkrApp->text_box, wDisplay);
+}
+
+void flushTimerCallback(void* _ctx) {
+    UNUSED(_ctx);
+    flushOutput();
+}
+
+static const NotificationSequence led_on = {
+    &message_blue_255,
+    &message_do_not_reset,
+    NULL,
+};
+
+static const NotificationSequence led_off = {
+    &message_blue_0,
+    NULL,
+};
+
+void input_kill(void* _ctx) {
+    UNUSED(_ctx);
+    killswitch = true;
+}
+
+void beginWorker() {
+    status = 1;
+
+    //redefined from furi_hal_resources.c
+    const GpioPin gpio_button_back = {.port = GPIOC, .pin = LL_GPIO_PIN_13};
+
+    notification_message(wrkrApp->notifications, &led_on);
+
+    FuriTimer* flushTimer = furi_timer_alloc(flushTimerCallback, FuriTimerTypePeriodic, NULL);
+    furi_timer_start(flushTimer, furi_ms_to_ticks(BF_OUTPUT_FLUSH_MS));
+
+    int killCheckCountdown = BF_KILL_CHECK_INTERVAL;
+    bool running = true;
+    while(running) {
+        const bfOp* op = &program[instPtr];
+        instPtr++;
+        runOpCount++;
+
+        switch(op->op) {
+        case opAdd:
+            bfStack[stackPtr] += op->value;
+            break;
+
+        case opMove:
+            stackPtr += op->arg;
+            if(!validateStackPtr()) {
+                running = false;
+            } else if(stackPtr > stackSizeReal) {
+                stackSizeReal = stackPtr;
+            }
+            break;
+
+        case opOut:
+            print();
+            break;
+
+        case opIn:
+            input();
+            break;
+
+        case opJumpZero:
+            if(bfStack[stackPtr] == 0) {
+                instPtr = op->arg;
+            }
+            break;
+
+        case opJumpNonZero:
+            if(bfStack[stackPtr] != 0) {
+                instPtr = op->arg;
+            }
+
+            //every long running program passes here, read back button directly to avoid
+            //weirdness in furi
+            if(--killCheckCountdown == 0) {
+                killCheckCountdown = BF_KILL_CHECK_INTERVAL;
+                if(killswitch || !furi_hal_gpio_read(&gpio_button_back)) {
+                    killswitch = false;
+                    running = false;
+                }
+            }
+            break;
+
+        case opClear:
+            bfStack[stackPtr] = 0;
+            break;
+
+        case opMulAdd:
+            if(bfStack[stackPtr] != 0) {
+                int target = stackPtr + op->arg;
+                if(target >= stackSize || target < 0) {
+                    running = false;
+                    break;
+                }
+                bfStack[target] += bfStack[stackPtr] * op->value;
+                if(target > stackSizeReal) {
+                    stackSizeReal = target;
+                }
+            }
+            break;
+
+        default:
+            running = false;
+            break;
+        }
+    }
+
+    furi_timer_stop(flushTimer);
+    furi_timer_free(flushTimer);
+
+    notification_message(wrkrApp->notifications, &led_off);
+    flushOutput();
+    status = 0;
+}
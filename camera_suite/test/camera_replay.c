@@ -0,0 +1,437 @@
+// Replays an ESP32-CAM serial stream through the camera view: the UART interrupt callback,
+// the 2 KB stream buffer, the worker and the row parser, with the line simulated at 230400
+// baud by stub/host_camera.c. A simulated camera streams a moving test scene as raw 'Y' rows
+// like the current firmware or, once the FAP asked for them, as 'R' delta rows. Checks that:
+// - firmware that ignores the RLE request still shows every frame
+// - 'R' rows are only applied after the camera acknowledged the request
+// - every redraw shows exactly the rows received so far
+// - after bytes were lost to a full stream buffer or flipped on the line, the picture is
+//   right again within a keyframe
+// - the packed frame draws the same screen as the per-pixel draw it replaced, in all four
+//   orientations
+// and reports frames per second, bytes per frame and the time to render a frame.
+// The build asks for RLE rows (RLE_ROWS_ENABLED), the app does not by default.
+//
+//   make -C camera_suite/test run
+//   ./camera_replay capture.bin    replays bytes captured from the camera's TX instead
+
+#include <time.h>
+
+#include "../views/camera_suite_view_camera.c"
+#include "host_camera.h"
+
+#define FRAMES 600
+#define CAPTURE_US 40000 // the camera takes 25 frames per second
+#define NOISE_PIXELS 24 // sensor noise through the dithering, per frame
+
+typedef enum {
+    FirmwareRaw, // the current firmware, ignores 'R' and 'K'
+    FirmwareRle,
+    FirmwareRleNoAck, // sends 'R' rows but never acknowledges
+} Firmware;
+
+typedef struct {
+    size_t end; // line index after the last byte of the packet
+    uint8_t row;
+    bool raw;
+    uint8_t pixels[ROW_BUFFER_LENGTH];
+} Packet;
+
+typedef struct {
+    const char* name;
+    Firmware firmware;
+    uint32_t stall_us;
+    uint32_t stall_every_us;
+    uint32_t flip_every; // a bit flips every that many bytes on average, 0 for never
+} Scenario;
+
+static const Scenario scenarios[] = {
+    {"raw rows", FirmwareRaw, 0, 0, 0},
+    {"RLE rows", FirmwareRle, 0, 0, 0},
+    {"RLE rows, no acknowledge", FirmwareRleNoAck, 0, 0, 0},
+    {"raw rows, worker stalls", FirmwareRaw, 150000, 2000000, 0},
+    {"RLE rows, worker stalls", FirmwareRle, 150000, 2000000, 0},
+    {"RLE rows, bit errors", FirmwareRle, 0, 0, 20000},
+};
+
+static struct {
+    const Scenario* scenario;
+    bool streaming;
+    bool rle;
+    bool keyframe_requested;
+    uint32_t frame;
+    uint64_t next_capture_us;
+    uint8_t previous[FRAME_BUFFER_LENGTH]; // the frame as sent
+    uint32_t keyframes;
+    uint32_t keyframe_requests;
+    const uint8_t* capture;
+    size_t capture_length;
+} camera;
+
+static Packet* packets;
+static size_t packets_length;
+static size_t packets_applied;
+static uint8_t shadow[FRAME_BUFFER_LENGTH]; // a receiver that gets every byte
+
+static struct {
+    uint32_t wrong; // redraws that differ from the shadow
+    uint32_t run;
+    uint32_t longest_run;
+    uint32_t wrong_screens;
+    uint64_t last_redraw_us;
+} result;
+
+static UartDumpModel* model;
+static uint32_t failures;
+
+static void fail(const char* what) {
+    printf("FAIL %s\n", what);
+    failures++;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Background pattern, a ball bouncing around and a few noise pixels
+static void scene(uint32_t frame, uint8_t* pixels) {
+    memset(pixels, 0, FRAME_BUFFER_LENGTH);
+    int bx = 12 + abs((int)(frame * 3 % 208) - 104);
+    int by = 12 + abs((int)(frame * 2 % 80) - 40);
+    for(int y = 0; y < FRAME_HEIGHT; y++) {
+        for(int x = 0; x < FRAME_WIDTH; x++) {
+            bool on = (x * 3 + y * 5) % 7 == 0 && y > 40;
+            if((x - bx) * (x - bx) + (y - by) * (y - by) < 100) on = !on;
+            if(on) pixels[y * ROW_BUFFER_LENGTH + x / 8] |= 0x80 >> (x % 8);
+        }
+    }
+    for(int i = 0; i < NOISE_PIXELS; i++) {
+        pixels[rand() % FRAME_BUFFER_LENGTH] ^= 1 << (rand() % 8);
+    }
+}
+
+static size_t packbits(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t o = 0;
+    size_t i = 0;
+    while(i < length) {
+        size_t run = 1;
+        while(i + run < length && in[i + run] == in[i] && run < 128) run++;
+        if(run >= 2) {
+            out[o++] = (uint8_t)(1 - (int)run);
+            out[o++] = in[i];
+            i += run;
+        } else {
+            size_t start = i;
+            while(i < length && i - start < 128 && !(i + 1 < length && in[i + 1] == in[i])) i++;
+            out[o++] = i - start - 1;
+            memcpy(&out[o], &in[start], i - start);
+            o += i - start;
+        }
+    }
+    return o;
+}
+
+static void log_packet(size_t end, uint8_t row, bool raw, const uint8_t* pixels) {
+    packets = realloc(packets, (packets_length + 1) * sizeof(Packet));
+    Packet* packet = &packets[packets_length++];
+    packet->end = end;
+    packet->row = row;
+    packet->raw = raw;
+    memcpy(packet->pixels, pixels, ROW_BUFFER_LENGTH);
+}
+
+static void send(uint8_t* data, size_t length, uint64_t at_us) {
+    uint32_t flip_every = camera.scenario->flip_every;
+    if(flip_every) {
+        for(size_t i = 0; i < length; i++) {
+            if((uint32_t)rand() % flip_every == 0) data[i] ^= 1 << (rand() % 8);
+        }
+    }
+    host_line_send(data, length, at_us);
+}
+
+// The camera sends the next frame once the line is free and the frame has been taken
+static bool camera_next(void) {
+    if(camera.capture_length) {
+        if(!camera.capture) return false;
+        host_line_send(camera.capture, camera.capture_length, 0);
+        camera.capture = NULL;
+        return true;
+    }
+    if(!camera.streaming || camera.frame == FRAMES) return false;
+
+    uint8_t pixels[FRAME_BUFFER_LENGTH];
+    scene(camera.frame, pixels);
+
+    bool raw = !camera.rle || camera.keyframe_requested ||
+               camera.frame % RLE_KEYFRAME_INTERVAL == 0;
+    if(raw && camera.rle) camera.keyframes++;
+    camera.keyframe_requested = false;
+
+    uint8_t stream[FRAME_HEIGHT * (HEADER_LENGTH + 2 + RLE_ROW_MAX_LENGTH)];
+    size_t length = 0;
+    size_t base = host_line_queued();
+    for(uint8_t row = 0; row < FRAME_HEIGHT; row++) {
+        const uint8_t* current = &pixels[row * ROW_BUFFER_LENGTH];
+        if(raw) {
+            stream[length++] = 'Y';
+            stream[length++] = ':';
+            stream[length++] = row;
+            memcpy(&stream[length], current, ROW_BUFFER_LENGTH);
+            length += ROW_BUFFER_LENGTH;
+        } else {
+            uint8_t delta[ROW_BUFFER_LENGTH];
+            uint8_t changed = 0;
+            for(size_t i = 0; i < ROW_BUFFER_LENGTH; i++) {
+                delta[i] = current[i] ^ camera.previous[row * ROW_BUFFER_LENGTH + i];
+                changed |= delta[i];
+            }
+            if(!changed && row != FRAME_HEIGHT - 1) continue;
+            stream[length++] = RLE_REQUEST;
+            stream[length++] = ':';
+            stream[length++] = row;
+            size_t packed = packbits(delta, ROW_BUFFER_LENGTH, &stream[length + 1]);
+            stream[length++] = packed;
+            length += packed;
+            stream[length++] = row_crc8(current);
+        }
+        log_packet(base + length, row, raw, current);
+    }
+
+    uint64_t at_us = MAX(host_now_us(), camera.next_capture_us);
+    camera.next_capture_us = at_us + CAPTURE_US;
+    memcpy(camera.previous, pixels, FRAME_BUFFER_LENGTH);
+    camera.frame++;
+    send(stream, length, at_us);
+    return true;
+}
+
+static void camera_rx(uint8_t byte) {
+    Firmware firmware = camera.scenario ? camera.scenario->firmware : FirmwareRaw;
+    if(byte == 'S') {
+        camera.streaming = true;
+    } else if(byte == RLE_REQUEST && firmware != FirmwareRaw) {
+        camera.rle = true;
+        if(firmware == FirmwareRle) {
+            uint8_t ack[] = {RLE_REQUEST, ':', RLE_ACK_ROW};
+            send(ack, sizeof(ack), host_now_us());
+        }
+    } else if(byte == RLE_KEYFRAME_REQUEST && firmware != FirmwareRaw) {
+        camera.keyframe_requests++;
+        camera.keyframe_requested = true;
+    }
+}
+
+// The screen the per-pixel draw before the packed frame showed
+static void reference_draw(const UartDumpModel* model, uint8_t screen[FRAME_HEIGHT][FRAME_WIDTH]) {
+    memset(screen, 0, FRAME_HEIGHT * FRAME_WIDTH);
+    for(int i = 0; i < FRAME_WIDTH; i++) {
+        screen[0][i] = screen[FRAME_HEIGHT - 1][i] = 1;
+    }
+    for(int j = 0; j < FRAME_HEIGHT; j++) {
+        screen[j][0] = screen[j][FRAME_WIDTH - 1] = 1;
+    }
+    for(int p = 0; p < FRAME_BUFFER_LENGTH; p++) {
+        for(int i = 0; i < 8; i++) {
+            if(!(model->pixels[p] & (1 << (7 - i)))) continue;
+            int x = p % ROW_BUFFER_LENGTH * 8 + i;
+            int y = p / ROW_BUFFER_LENGTH;
+            int sx = x, sy = y;
+            switch(model->orientation) {
+            case 1:
+                sx = y;
+                sy = FRAME_WIDTH - 1 - x;
+                break;
+            case 2:
+                sx = FRAME_WIDTH - 1 - x;
+                sy = FRAME_HEIGHT - 1 - y;
+                break;
+            case 3:
+                sx = FRAME_HEIGHT - 1 - y;
+                sy = x;
+                break;
+            }
+            if(sx < FRAME_WIDTH && sy < FRAME_HEIGHT) screen[sy][sx] = 1;
+        }
+    }
+}
+
+static bool screen_matches(const UartDumpModel* model) {
+    static uint8_t expected[FRAME_HEIGHT][FRAME_WIDTH];
+    memset(host_screen, 0, sizeof(host_screen));
+    camera_suite_view_camera_draw(NULL, (void*)model);
+    reference_draw(model, expected);
+    return memcmp(host_screen, expected, sizeof(expected)) == 0;
+}
+
+static void redraw(void* redrawn) {
+    UartDumpModel* model = redrawn;
+    size_t consumed = host_line_consumed();
+    bool raw_only = camera.scenario && camera.scenario->firmware == FirmwareRleNoAck;
+    for(; packets_applied < packets_length && packets[packets_applied].end <= consumed;
+        packets_applied++) {
+        const Packet* packet = &packets[packets_applied];
+        if(raw_only && !packet->raw) continue;
+        memcpy(&shadow[packet->row * ROW_BUFFER_LENGTH], packet->pixels, ROW_BUFFER_LENGTH);
+    }
+
+    if(memcmp(model->pixels, shadow, FRAME_BUFFER_LENGTH) != 0) {
+        result.wrong++;
+        result.longest_run = MAX(result.longest_run, ++result.run);
+    } else {
+        result.run = 0;
+    }
+    if(!screen_matches(model)) result.wrong_screens++;
+    result.last_redraw_us = host_now_us();
+}
+
+static void replay(CameraSuiteViewCamera* instance, CameraSuite* app, const Scenario* scenario) {
+    memset(&camera, 0, sizeof(camera));
+    camera.scenario = scenario;
+    memset(&result, 0, sizeof(result));
+    packets_length = 0;
+    packets_applied = 0;
+    memset(shadow, 0, sizeof(shadow));
+    srand(1);
+
+    // every orientation gets its turn
+    app->orientation = (scenario - scenarios) % 4;
+    host_line_reset(2000, scenario->stall_us, scenario->stall_every_us);
+    camera_suite_view_camera_enter(instance);
+    host_counters.redraws = 0; // the model reset on enter
+    furi_thread_join(instance->worker_thread);
+
+    double duration = result.last_redraw_us / 1e6;
+    printf(
+        "%-26s %6u %6u %6.1f %7.0f %7zu %4u %4u %5u %5u\n",
+        scenario->name,
+        camera.frame,
+        host_counters.redraws,
+        host_counters.redraws / duration,
+        (double)host_line_queued() / camera.frame,
+        host_counters.dropped,
+        camera.keyframe_requests,
+        camera.keyframes,
+        result.wrong,
+        result.longest_run);
+
+    if(result.wrong_screens) fail("screen differs from the per-pixel draw");
+    bool clean = !scenario->stall_us && !scenario->flip_every;
+    // without the acknowledge only the keyframes complete a frame
+    uint32_t frames = scenario->firmware == FirmwareRleNoAck ? camera.keyframes : FRAMES;
+    if(clean && (result.wrong || host_counters.redraws != frames)) fail("frames lost");
+    if(scenario->firmware == FirmwareRle && model->is_rle_active != true) fail("RLE not active");
+    if(scenario->firmware != FirmwareRle && model->is_rle_active) fail("RLE active");
+    if(scenario->firmware == FirmwareRle && clean && host_line_queued() >= FRAMES * 1216 / 2) {
+        fail("RLE rows not smaller");
+    }
+    if(!clean) {
+        // Back in order within a keyframe request or the periodic keyframe
+        if(result.longest_run > RLE_KEYFRAME_INTERVAL + 1) fail("picture stays wrong");
+        if(!scenario->flip_every && result.run) fail("last frame wrong");
+    }
+}
+
+static void benchmark(void) {
+    uint8_t pixels[FRAME_BUFFER_LENGTH];
+    scene(0, pixels);
+    memcpy(model->pixels, pixels, sizeof(pixels));
+
+    uint32_t dots = 0;
+    for(size_t p = 0; p < FRAME_BUFFER_LENGTH; p++) {
+        dots += __builtin_popcount(pixels[p]);
+    }
+
+    printf("render_frame_by_orientation on the host:");
+    for(uint32_t orientation = 0; orientation < 4; orientation++) {
+        model->orientation = orientation;
+        const uint32_t rounds = 20000;
+        double start = seconds();
+        for(uint32_t i = 0; i < rounds; i++) {
+            model->pixels[i % FRAME_BUFFER_LENGTH] ^= 1;
+            render_frame_by_orientation(model);
+        }
+        printf(" %u deg %.2f us%s", orientation * 90, (seconds() - start) / rounds * 1e6,
+               orientation == 3 ? "\n" : ",");
+    }
+    printf(
+        "canvas calls per frame: 2 (frame, xbm), the per-pixel draw made %u for the test scene\n",
+        dots + 1);
+}
+
+static int replay_capture(CameraSuiteViewCamera* instance, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if(!file) {
+        printf("cannot open %s\n", path);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = malloc(length);
+    length = fread(data, 1, length, file);
+    fclose(file);
+
+    host_line_reset(2000, 0, 0);
+    camera.capture = data;
+    camera.capture_length = length;
+    host_redraw = NULL;
+    camera_suite_view_camera_enter(instance);
+    furi_thread_join(instance->worker_thread);
+
+    double duration = host_now_us() / 1e6;
+    printf(
+        "%s: %ld bytes, %u frames, %.1f frames/s, %.0f bytes/frame, %zu bytes dropped\n",
+        path,
+        length,
+        host_counters.redraws,
+        host_counters.redraws / duration,
+        host_counters.redraws ? (double)length / host_counters.redraws : 0.0,
+        host_counters.dropped);
+    free(data);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    CameraSuite app = {0};
+    host_stop_flags = WorkerEventStop;
+    host_camera_next = camera_next;
+    host_camera_rx = camera_rx;
+    host_redraw = redraw;
+
+    CameraSuiteViewCamera* instance = camera_suite_view_camera_alloc();
+    camera_suite_view_camera_set_callback(instance, NULL, &app);
+    model = view_get_model(instance->view);
+
+    if(argc > 1) return replay_capture(instance, argv[1]);
+
+    printf(
+        "%-26s %6s %6s %6s %7s %7s %4s %4s %5s %5s\n",
+        "",
+        "frames",
+        "shown",
+        "fps",
+        "B/frame",
+        "dropped",
+        "K",
+        "key",
+        "wrong",
+        "run");
+    for(size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        replay(instance, &app, &scenarios[i]);
+    }
+    benchmark();
+
+    camera_suite_view_camera_free(instance);
+    free(packets);
+
+    if(failures) {
+        printf("FAILED: %u checks\n", failures);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <gui/gui.h>
+
+static const Icon I_WarningDolphinFlip_45x42 = {0};
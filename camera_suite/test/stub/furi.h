@@ -0,0 +1,102 @@
+#pragma once
+
+// Just enough of the Furi API for the camera view on the host, the line and the worker
+// scheduling are simulated in host_camera.c
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// furi malloc never fails and returns zeroed memory
+#define malloc(size) calloc(1, size)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define UNUSED(x) (void)(x)
+
+#define furi_assert(x) (void)(x)
+#define furi_check(x)     \
+    do {                  \
+        if(!(x)) abort(); \
+    } while(0)
+
+#define EXT_PATH(path) "/ext/" path
+
+// Pictures are not saved on the host
+
+typedef struct FuriString FuriString;
+
+static inline FuriString* furi_string_alloc(void) {
+    return NULL;
+}
+
+static inline void furi_string_free(FuriString* string) {
+    UNUSED(string);
+}
+
+static inline const char* furi_string_get_cstr(const FuriString* string) {
+    UNUSED(string);
+    return "";
+}
+
+static inline void furi_string_printf(FuriString* string, const char* format, ...) {
+    UNUSED(string);
+    UNUSED(format);
+}
+
+#define RECORD_STORAGE "storage"
+
+static inline void* furi_record_open(const char* name) {
+    UNUSED(name);
+    return NULL;
+}
+
+typedef enum {
+    FuriFlagWaitAny = 0,
+    FuriFlagWaitAll = 1,
+    FuriFlagNoClear = 2,
+} FuriFlag;
+
+#define FuriFlagError (0x80000000U)
+#define FuriWaitForever (0xFFFFFFFFU)
+
+void furi_delay_ms(uint32_t milliseconds);
+
+typedef int32_t (*FuriThreadCallback)(void* context);
+typedef struct FuriThread FuriThread;
+typedef FuriThread* FuriThreadId;
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+typedef struct FuriStreamBuffer FuriStreamBuffer;
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level);
+void furi_stream_buffer_free(FuriStreamBuffer* stream_buffer);
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* stream_buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout);
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* stream_buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <furi.h>
+
+typedef enum {
+    FuriHalUartIdUSART1,
+    FuriHalUartIdLPUART1,
+} FuriHalUartId;
+
+typedef enum {
+    UartIrqEventRXNE,
+} UartIrqEvent;
+
+void furi_hal_uart_init(FuriHalUartId channel, uint32_t baud);
+void furi_hal_uart_deinit(FuriHalUartId channel);
+void furi_hal_uart_set_br(FuriHalUartId channel, uint32_t baud);
+void furi_hal_uart_tx(FuriHalUartId channel, uint8_t* buffer, size_t buffer_size);
+void furi_hal_uart_set_irq_cb(
+    FuriHalUartId channel,
+    void (*callback)(UartIrqEvent event, uint8_t data, void* context),
+    void* context);
+void furi_hal_console_disable(void);
+void furi_hal_console_enable(void);
+
+typedef struct {
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+} FuriHalRtcDateTime;
+
+static inline void furi_hal_rtc_get_datetime(FuriHalRtcDateTime* datetime) {
+    UNUSED(datetime);
+}
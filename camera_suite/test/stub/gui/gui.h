@@ -0,0 +1,35 @@
+#pragma once
+
+// The canvas draws into host_screen (host_camera.c), one byte per pixel
+
+#include <stdint.h>
+
+typedef struct Gui Gui;
+typedef struct Canvas Canvas;
+
+typedef struct {
+    uint8_t width;
+} Icon;
+
+typedef enum {
+    ColorWhite,
+    ColorBlack,
+} Color;
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+} Font;
+
+void canvas_set_color(Canvas* canvas, Color color);
+void canvas_set_font(Canvas* canvas, Font font);
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, int32_t width, int32_t height);
+void canvas_draw_xbm(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    const uint8_t* bitmap);
+void canvas_draw_icon(Canvas* canvas, int32_t x, int32_t y, const Icon* icon);
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct SceneManager SceneManager;
+
+typedef struct {
+    uint32_t type;
+    uint32_t event;
+} SceneManagerEvent;
+
+typedef struct {
+    const void* on_enter_handlers;
+    const void* on_event_handlers;
+    const void* on_exit_handlers;
+    uint32_t scene_num;
+} SceneManagerHandlers;
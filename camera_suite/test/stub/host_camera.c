@@ -0,0 +1,407 @@
+#include "host_camera.h"
+
+#include <furi_hal.h>
+#include <gui/view.h>
+#include <xtreme/xtreme.h>
+
+#include "../../helpers/camera_suite_haptic.h"
+#include "../../helpers/camera_suite_led.h"
+#include "../../helpers/camera_suite_speaker.h"
+
+XtremeSettings xtreme_settings;
+HostCounters host_counters;
+uint8_t host_screen[64][128];
+
+bool (*host_camera_next)(void);
+void (*host_camera_rx)(uint8_t byte);
+void (*host_redraw)(void* model);
+uint32_t host_stop_flags;
+
+struct FuriThread {
+    FuriThreadCallback callback;
+    void* context;
+};
+
+struct FuriStreamBuffer {
+    uint8_t* data;
+    size_t* index; // line index of each byte
+    size_t size;
+    size_t head;
+    size_t tail;
+};
+
+struct View {
+    void* model;
+};
+
+static struct {
+    uint8_t* data;
+    uint64_t* time_us; // arrival of each byte
+    size_t length;
+    size_t capacity;
+    uint64_t end_us;
+
+    size_t next;
+    size_t consumed;
+    uint64_t now_us;
+    bool running;
+    bool camera_done;
+    uint32_t max_latency_us;
+    uint32_t stall_us;
+    uint32_t stall_every_us;
+    uint64_t next_stall_us;
+    bool in_irq;
+    uint32_t pending;
+
+    void (*irq_cb)(UartIrqEvent event, uint8_t data, void* context);
+    void* irq_context;
+} line;
+
+static uint32_t random_us(uint32_t max_us) {
+    return max_us ? (uint32_t)rand() % max_us : 0;
+}
+
+void host_line_reset(uint32_t max_latency_us, uint32_t stall_us, uint32_t stall_every_us) {
+    line.length = 0;
+    line.end_us = 0;
+    line.next = 0;
+    line.consumed = 0;
+    line.now_us = 0;
+    line.running = false;
+    line.camera_done = false;
+    line.max_latency_us = max_latency_us;
+    line.stall_us = stall_us;
+    line.stall_every_us = stall_every_us;
+    line.next_stall_us = random_us(2 * stall_every_us);
+    line.pending = 0;
+    host_counters = (HostCounters){0};
+}
+
+void host_line_send(const uint8_t* data, size_t length, uint64_t at_us) {
+    if(line.length + length > line.capacity) {
+        line.capacity = MAX(line.capacity * 2, line.length + length);
+        line.data = realloc(line.data, line.capacity);
+        line.time_us = realloc(line.time_us, line.capacity * sizeof(uint64_t));
+    }
+
+    double t = MAX(line.end_us, at_us);
+    for(size_t i = 0; i < length; i++) {
+        t += UART_BYTE_US;
+        line.data[line.length] = data[i];
+        line.time_us[line.length++] = (uint64_t)t;
+    }
+    line.end_us = (uint64_t)t;
+}
+
+size_t host_line_queued(void) {
+    return line.length;
+}
+
+size_t host_line_consumed(void) {
+    return line.consumed;
+}
+
+uint64_t host_now_us(void) {
+    return line.now_us;
+}
+
+// The camera queues its next frame once the line is idle
+static bool line_feed(void) {
+    while(line.next == line.length && !line.camera_done) {
+        if(!host_camera_next || !host_camera_next()) line.camera_done = true;
+    }
+    return line.next < line.length;
+}
+
+static void line_run_until(uint64_t t) {
+    while(line_feed() && line.time_us[line.next] <= t) {
+        line.now_us = line.time_us[line.next];
+        line.in_irq = true;
+        if(line.irq_cb) line.irq_cb(UartIrqEventRXNE, line.data[line.next], line.irq_context);
+        line.in_irq = false;
+        line.next++;
+    }
+    line.now_us = MAX(line.now_us, t);
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    // The view is entered before the worker starts, the camera only streams after that
+    if(line.running) line_run_until(line.now_us + milliseconds * 1000ULL);
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    UNUSED(options);
+    UNUSED(timeout);
+    line.running = true;
+    host_counters.wakeups++;
+
+    while(!(line.pending & flags)) {
+        if(!line_feed()) return host_stop_flags;
+        line_run_until(line.time_us[line.next]);
+    }
+
+    // The scheduler does not switch to the worker right away
+    line_run_until(line.now_us + random_us(line.max_latency_us));
+    if(line.stall_every_us && line.now_us >= line.next_stall_us) {
+        host_counters.stalls++;
+        line_run_until(line.now_us + line.stall_us);
+        line.next_stall_us = line.now_us + random_us(2 * line.stall_every_us);
+    }
+
+    uint32_t events = line.pending & flags;
+    line.pending &= ~events;
+    return events;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    UNUSED(thread_id);
+    line.pending |= flags;
+    return flags;
+}
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    UNUSED(name);
+    UNUSED(stack_size);
+    FuriThread* thread = calloc(1, sizeof(FuriThread));
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
+
+void furi_thread_start(FuriThread* thread) {
+    UNUSED(thread);
+}
+
+// The worker receives the whole stream here
+bool furi_thread_join(FuriThread* thread) {
+    thread->callback(thread->context);
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level) {
+    UNUSED(trigger_level);
+    FuriStreamBuffer* stream_buffer = calloc(1, sizeof(FuriStreamBuffer));
+    stream_buffer->data = calloc(1, size);
+    stream_buffer->index = calloc(size, sizeof(size_t));
+    stream_buffer->size = size;
+    return stream_buffer;
+}
+
+void furi_stream_buffer_free(FuriStreamBuffer* stream_buffer) {
+    free(stream_buffer->data);
+    free(stream_buffer->index);
+    free(stream_buffer);
+}
+
+// Like xStreamBufferSendFromISR(), whatever does not fit is lost. Only the interrupt sends.
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* stream_buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout) {
+    UNUSED(timeout);
+    size_t n = MIN(length, stream_buffer->size - (stream_buffer->head - stream_buffer->tail));
+    for(size_t i = 0; i < n; i++) {
+        size_t slot = stream_buffer->head++ % stream_buffer->size;
+        stream_buffer->data[slot] = ((const uint8_t*)data)[i];
+        stream_buffer->index[slot] = line.next;
+    }
+    host_counters.dropped += length - n;
+    return n;
+}
+
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* stream_buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout) {
+    UNUSED(timeout);
+    size_t n = MIN(length, stream_buffer->head - stream_buffer->tail);
+    for(size_t i = 0; i < n; i++) {
+        size_t slot = stream_buffer->tail++ % stream_buffer->size;
+        ((uint8_t*)data)[i] = stream_buffer->data[slot];
+        line.consumed = stream_buffer->index[slot] + 1;
+    }
+    return n;
+}
+
+void furi_hal_uart_init(FuriHalUartId channel, uint32_t baud) {
+    UNUSED(channel);
+    UNUSED(baud);
+}
+
+void furi_hal_uart_deinit(FuriHalUartId channel) {
+    UNUSED(channel);
+}
+
+void furi_hal_uart_set_br(FuriHalUartId channel, uint32_t baud) {
+    UNUSED(channel);
+    UNUSED(baud);
+}
+
+void furi_hal_uart_tx(FuriHalUartId channel, uint8_t* buffer, size_t buffer_size) {
+    UNUSED(channel);
+    for(size_t i = 0; i < buffer_size; i++) {
+        if(host_camera_rx) host_camera_rx(buffer[i]);
+    }
+}
+
+void furi_hal_uart_set_irq_cb(
+    FuriHalUartId channel,
+    void (*callback)(UartIrqEvent event, uint8_t data, void* context),
+    void* context) {
+    UNUSED(channel);
+    line.irq_cb = callback;
+    line.irq_context = context;
+}
+
+void furi_hal_console_disable(void) {
+}
+
+void furi_hal_console_enable(void) {
+}
+
+View* view_alloc(void) {
+    return calloc(1, sizeof(View));
+}
+
+void view_free(View* view) {
+    free(view->model);
+    free(view);
+}
+
+void view_allocate_model(View* view, ViewModelType type, size_t size) {
+    UNUSED(type);
+    view->model = calloc(1, size);
+}
+
+void* view_get_model(View* view) {
+    return view->model;
+}
+
+void view_commit_model(View* view, bool update) {
+    if(!update) return;
+    host_counters.redraws++;
+    if(host_redraw) host_redraw(view->model);
+}
+
+void view_set_context(View* view, void* context) {
+    UNUSED(view);
+    UNUSED(context);
+}
+
+void view_set_draw_callback(View* view, ViewDrawCallback callback) {
+    UNUSED(view);
+    UNUSED(callback);
+}
+
+void view_set_input_callback(View* view, ViewInputCallback callback) {
+    UNUSED(view);
+    UNUSED(callback);
+}
+
+void view_set_enter_callback(View* view, ViewCallback callback) {
+    UNUSED(view);
+    UNUSED(callback);
+}
+
+void view_set_exit_callback(View* view, ViewCallback callback) {
+    UNUSED(view);
+    UNUSED(callback);
+}
+
+// Only the camera picture is drawn, the text and icons of the guide are left out
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    UNUSED(canvas);
+    UNUSED(color);
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    UNUSED(font);
+}
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, int32_t width, int32_t height) {
+    UNUSED(canvas);
+    for(int32_t i = x; i < x + width; i++) {
+        host_screen[y][i] = 1;
+        host_screen[y + height - 1][i] = 1;
+    }
+    for(int32_t j = y; j < y + height; j++) {
+        host_screen[j][x] = 1;
+        host_screen[j][x + width - 1] = 1;
+    }
+}
+
+// Like u8g2, set bits are drawn in the current color and clear bits are left alone
+void canvas_draw_xbm(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    const uint8_t* bitmap) {
+    UNUSED(canvas);
+    int32_t stride = (width + 7) / 8;
+    for(int32_t j = 0; j < height; j++) {
+        for(int32_t i = 0; i < width; i++) {
+            if(bitmap[j * stride + i / 8] & (1 << (i % 8))) host_screen[y + j][x + i] = 1;
+        }
+    }
+}
+
+void canvas_draw_icon(Canvas* canvas, int32_t x, int32_t y, const Icon* icon) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(icon);
+}
+
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(str);
+}
+
+// Feedback of the input handlers
+
+void camera_suite_play_happy_bump(void* context) {
+    UNUSED(context);
+}
+
+void camera_suite_play_bad_bump(void* context) {
+    UNUSED(context);
+}
+
+void camera_suite_play_long_bump(void* context) {
+    UNUSED(context);
+}
+
+void camera_suite_led_set_rgb(void* context, int red, int green, int blue) {
+    UNUSED(context);
+    UNUSED(red);
+    UNUSED(green);
+    UNUSED(blue);
+}
+
+void camera_suite_play_input_sound(void* context) {
+    UNUSED(context);
+}
+
+void camera_suite_stop_all_sound(void* context) {
+    UNUSED(context);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Simulated ESP32-CAM UART line, worker thread scheduling and display for camera_replay.
+//
+// Time is simulated: each byte takes UART_BYTE_US on the line and is handed to the RX
+// interrupt callback when it arrives. When the line has sent everything, it asks the camera
+// (host_camera_next) for more. The worker thread runs inside furi_thread_join(), every
+// furi_thread_flags_wait() lets the line run until a flag is set, plus a random wake up
+// latency and now and then a stall, like the GUI holding the model lock or an SD card write.
+// Once the camera is done and the worker waits again, the wait returns host_stop_flags.
+// Bytes the app sends go to host_camera_rx, the canvas draws into host_screen.
+
+#include <furi.h>
+
+#define UART_BAUD 230400
+#define UART_BYTE_US (10 * 1000000.0 / UART_BAUD) // 8N1
+
+typedef struct {
+    uint32_t wakeups; // furi_thread_flags_wait() returns
+    uint32_t stalls;
+    uint32_t redraws; // view_commit_model() with an update
+    size_t dropped; // bytes the stream buffer had no room for
+} HostCounters;
+
+extern HostCounters host_counters;
+extern uint8_t host_screen[64][128];
+
+// Set by the test
+extern bool (*host_camera_next)(void); // false once the camera has nothing more to send
+extern void (*host_camera_rx)(uint8_t byte);
+extern void (*host_redraw)(void* model);
+extern uint32_t host_stop_flags;
+
+// Starts over. The worker wakes up within max_latency_us of a flag, and stalls for stall_us
+// every stall_every_us on average (never if 0).
+void host_line_reset(uint32_t max_latency_us, uint32_t stall_us, uint32_t stall_every_us);
+// Queues bytes that the line sends back to back, starting no earlier than at_us
+void host_line_send(const uint8_t* data, size_t length, uint64_t at_us);
+// Bytes queued on the line so far
+size_t host_line_queued(void);
+// Bytes on the line up to and including the last one the worker took from the stream buffer
+size_t host_line_consumed(void);
+uint64_t host_now_us(void);
@@ -0,0 +1,21 @@
+#pragma once
+
+typedef enum {
+    InputKeyUp,
+    InputKeyDown,
+    InputKeyRight,
+    InputKeyLeft,
+    InputKeyOk,
+    InputKeyBack,
+    InputKeyMAX,
+} InputKey;
+
+typedef enum {
+    InputTypePress,
+    InputTypeRelease,
+} InputType;
+
+typedef struct {
+    InputKey key;
+    InputType type;
+} InputEvent;
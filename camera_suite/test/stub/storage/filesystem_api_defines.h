@@ -0,0 +1,16 @@
+#pragma once
+
+typedef enum {
+    FSAM_READ = (1 << 0),
+    FSAM_WRITE = (1 << 1),
+} FS_AccessMode;
+
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+} FS_OpenMode;
+
+typedef enum {
+    FSE_OK,
+    FSE_NOT_EXIST,
+} FS_Error;
@@ -0,0 +1,52 @@
+#pragma once
+
+// Pictures are not saved on the host, the files never open
+
+#include <furi.h>
+#include <storage/filesystem_api_defines.h>
+
+typedef struct Storage Storage;
+typedef struct File File;
+typedef struct FileInfo FileInfo;
+
+static inline FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* info) {
+    UNUSED(storage);
+    UNUSED(path);
+    UNUSED(info);
+    return FSE_OK;
+}
+
+static inline FS_Error storage_simply_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    UNUSED(path);
+    return FSE_OK;
+}
+
+static inline File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return NULL;
+}
+
+static inline void storage_file_free(File* file) {
+    UNUSED(file);
+}
+
+static inline bool
+    storage_file_open(File* file, const char* path, FS_AccessMode access, FS_OpenMode mode) {
+    UNUSED(file);
+    UNUSED(path);
+    UNUSED(access);
+    UNUSED(mode);
+    return false;
+}
+
+static inline bool storage_file_close(File* file) {
+    UNUSED(file);
+    return true;
+}
+
+static inline size_t storage_file_write(File* file, const void* data, size_t size) {
+    UNUSED(file);
+    UNUSED(data);
+    return size;
+}
@@ -8,29 +8,96 @@
 #include "../helpers/camera_suite_speaker.h"
 #include "../helpers/camera_suite_led.h"
 
-static void draw_pixel_by_orientation(Canvas* canvas, uint8_t x, uint8_t y, uint8_t orientation) {
-    furi_assert(canvas);
-    furi_assert(x);
-    furi_assert(y);
-    furi_assert(orientation);
+#define R2(n) n, n + 2 * 64, n + 1 * 64, n + 3 * 64
+#define R4(n) R2(n), R2(n + 2 * 16), R2(n + 1 * 16), R2(n + 3 * 16)
+#define R6(n) R4(n), R4(n + 2 * 4), R4(n + 1 * 4), R4(n + 3 * 4)
+
+// Camera rows are MSB-first while XBM bitmaps are LSB-first.
+static const uint8_t bit_reverse[256] = {R6(0), R6(2), R6(1), R6(3)};
+
+// Transposes an 8x8 bit block, bit 7 of rows[r] is column 0 of row r.
+static void transpose_block(const uint8_t* rows, uint8_t* columns) {
+    uint32_t x = ((uint32_t)rows[0] << 24) | (rows[1] << 16) | (rows[2] << 8) | rows[3];
+    uint32_t y = ((uint32_t)rows[4] << 24) | (rows[5] << 16) | (rows[6] << 8) | rows[7];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    for(size_t i = 0; i < 4; ++i) {
+        columns[i] = x >> (24 - 8 * i);
+        columns[i + 4] = y >> (24 - 8 * i);
+    }
+}
+
+// Rebuilds the XBM frame from the camera pixels for the current orientation.
+static void render_frame_by_orientation(UartDumpModel* model) {
+    furi_assert(model);
 
-    switch(orientation) {
+    const uint8_t* pixels = model->pixels;
+    uint8_t* frame = model->frame;
+    uint8_t block[8];
+    uint8_t columns[8];
+
+    switch(model->orientation) {
     default:
     case 0: { // Camera rotated 0 degrees (right side up, default)
-        canvas_draw_dot(canvas, x, y);
+        model->frame_width = FRAME_WIDTH;
+        model->frame_height = FRAME_HEIGHT;
+        for(size_t p = 0; p < FRAME_BUFFER_LENGTH; ++p) {
+            frame[p] = bit_reverse[pixels[p]];
+        }
         break;
     }
-    case 1: { // Camera rotated 90 degrees
-
-        canvas_draw_dot(canvas, y, FRAME_WIDTH - 1 - x);
+    case 1: { // Camera rotated 90 degrees, only the camera's right half is on screen
+        model->frame_width = FRAME_HEIGHT;
+        model->frame_height = FRAME_HEIGHT;
+        for(size_t y = 0; y < FRAME_HEIGHT; y += 8) {
+            for(size_t b = ROW_BUFFER_LENGTH / 2; b < ROW_BUFFER_LENGTH; ++b) {
+                for(size_t r = 0; r < 8; ++r) {
+                    block[r] = pixels[(y + r) * ROW_BUFFER_LENGTH + b];
+                }
+                transpose_block(block, columns);
+                for(size_t i = 0; i < 8; ++i) {
+                    frame[(FRAME_WIDTH - 1 - b * 8 - i) * 8 + y / 8] = bit_reverse[columns[i]];
+                }
+            }
+        }
         break;
     }
     case 2: { // Camera rotated 180 degrees (upside down)
-        canvas_draw_dot(canvas, FRAME_WIDTH - 1 - x, FRAME_HEIGHT - 1 - y);
+        model->frame_width = FRAME_WIDTH;
+        model->frame_height = FRAME_HEIGHT;
+        for(size_t p = 0; p < FRAME_BUFFER_LENGTH; ++p) {
+            frame[FRAME_BUFFER_LENGTH - 1 - p] = pixels[p];
+        }
         break;
     }
-    case 3: { // Camera rotated 270 degrees
-        canvas_draw_dot(canvas, FRAME_HEIGHT - 1 - y, x);
+    case 3: { // Camera rotated 270 degrees, only the camera's left half is on screen
+        model->frame_width = FRAME_HEIGHT;
+        model->frame_height = FRAME_HEIGHT;
+        for(size_t y = 0; y < FRAME_HEIGHT; y += 8) {
+            for(size_t b = 0; b < ROW_BUFFER_LENGTH / 2; ++b) {
+                for(size_t r = 0; r < 8; ++r) {
+                    block[r] = pixels[(y + r) * ROW_BUFFER_LENGTH + b];
+                }
+                transpose_block(block, columns);
+                for(size_t i = 0; i < 8; ++i) {
+                    frame[(b * 8 + i) * 8 + 7 - y / 8] = columns[i];
+                }
+            }
+        }
         break;
     }
     }
@@ -48,16 +115,13 @@ static void camera_suite_view_camera_draw(Canvas* canvas, void* model) {
     // Draw the frame.
     canvas_draw_frame(canvas, 0, 0, FRAME_WIDTH, FRAME_HEIGHT);
 
-    for(size_t p = 0; p < FRAME_BUFFER_LENGTH; ++p) {
-        uint8_t x = p % ROW_BUFFER_LENGTH; // 0 .. 15
-        uint8_t y = p / ROW_BUFFER_LENGTH; // 0 .. 63
-
-        for(uint8_t i = 0; i < 8; ++i) {
-            if((uartDumpModel->pixels[p] & (1 << (7 - i))) != 0) {
-                draw_pixel_by_orientation(canvas, (x * 8) + i, y, uartDumpModel->orientation);
-            }
-        }
-    }
+    canvas_draw_xbm(
+        canvas,
+        0,
+        0,
+        uartDumpModel->frame_width,
+        uartDumpModel->frame_height,
+        uartDumpModel->frame);
 
     // Draw the guide if the camera is not initialized.
     if(!uartDumpModel->is_initialized) {
@@ -116,12 +180,6 @@ static void save_image_to_flipper_sd_card(void* model) {
     // Free the file name after use.
     furi_string_free(file_name);
 
-    if(!uartDumpModel->is_inverted) {
-        for(size_t i = 0; i < FRAME_BUFFER_LENGTH; ++i) {
-            uartDumpModel->pixels[i] = ~uartDumpModel->pixels[i];
-        }
-    }
-
     // If the file was opened successfully, write the bitmap header and the
     // image data.
     if(result) {
@@ -131,13 +189,16 @@ static void save_image_to_flipper_sd_card(void* model) {
         // @todo - Add a function for saving the image directly from the
         // ESP32-CAM to the Flipper Zero SD card.
 
-        // Write locally to the Flipper Zero SD card in the DCIM folder.
-        int8_t row_buffer[ROW_BUFFER_LENGTH];
+        // Write locally to the Flipper Zero SD card in the DCIM folder. The
+        // pixels are inverted here, not in place, as RLE rows are deltas to them.
+        uint8_t invert_mask = uartDumpModel->is_inverted ? 0x00 : 0xFF;
+        uint8_t row_buffer[ROW_BUFFER_LENGTH];
 
         // @todo - Save image based on orientation.
         for(size_t i = 64; i > 0; --i) {
             for(size_t j = 0; j < ROW_BUFFER_LENGTH; ++j) {
-                row_buffer[j] = uartDumpModel->pixels[((i - 1) * ROW_BUFFER_LENGTH) + j];
+                row_buffer[j] =
+                    uartDumpModel->pixels[((i - 1) * ROW_BUFFER_LENGTH) + j] ^ invert_mask;
             }
             storage_file_write(file, row_buffer, ROW_BUFFER_LENGTH);
         }
@@ -163,6 +224,11 @@ static void
     for(size_t i = 0; i < FRAME_BUFFER_LENGTH; i++) {
         model->pixels[i] = 0;
     }
+    model->ringbuffer_index = 0;
+    model->is_keyframe_needed = false;
+    model->is_rle_active = false;
+
+    render_frame_by_orientation(model);
 }
 
 static bool camera_suite_view_camera_input(InputEvent* event, void* context) {
@@ -372,11 +438,16 @@ static void camera_suite_view_camera_enter(void* context) {
         UartDumpModel * model,
         { camera_suite_view_camera_model_init(model, instance_context); },
         true);
+
+#if RLE_ROWS_ENABLED
+    // Ask for RLE delta rows after the model reset, so that the acknowledge is
+    // not lost. Camera firmware without RLE support keeps sending raw rows.
+    furi_hal_uart_tx(UART_CH, (uint8_t[]){RLE_REQUEST}, 1);
+    furi_delay_ms(50);
+#endif
 }
 
 static void camera_on_irq_cb(UartIrqEvent uartIrqEvent, uint8_t data, void* context) {
-    furi_assert(uartIrqEvent);
-    furi_assert(data);
     furi_assert(context);
 
     // Cast `context` to `CameraSuiteViewCamera*` and store it in `instance`.
@@ -390,52 +461,161 @@ static void camera_on_irq_cb(UartIrqEvent uartIrqEvent, uint8_t data, void* cont
     }
 }
 
-static void process_ringbuffer(UartDumpModel* model, uint8_t const byte) {
+// CRC-8, polynomial 0x07, of a row of pixels.
+static uint8_t row_crc8(const uint8_t* row) {
+    uint8_t crc = 0;
+    for(size_t i = 0; i < ROW_BUFFER_LENGTH; ++i) {
+        crc ^= row[i];
+        for(size_t bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// Unpacks a PackBits row and applies it as XOR delta to the previous frame, if
+// the result matches the CRC that follows the payload.
+static bool apply_rle_row(UartDumpModel* model) {
+    uint8_t row[ROW_BUFFER_LENGTH];
+    size_t length = model->packet_length - 1;
+    size_t in = 0;
+    size_t out = 0;
+
+    while(in < length) {
+        int8_t header = model->rle_buffer[in++];
+        if(header >= 0) {
+            // Literal run of header + 1 bytes.
+            size_t count = header + 1;
+            if(in + count > length || out + count > ROW_BUFFER_LENGTH) {
+                return false;
+            }
+            memcpy(&row[out], &model->rle_buffer[in], count);
+            in += count;
+            out += count;
+        } else if(header != -128) {
+            // Repeated run of 1 - header bytes.
+            size_t count = 1 - header;
+            if(in >= length || out + count > ROW_BUFFER_LENGTH) {
+                return false;
+            }
+            memset(&row[out], model->rle_buffer[in++], count);
+            out += count;
+        }
+    }
+
+    if(out != ROW_BUFFER_LENGTH) {
+        return false;
+    }
+
+    uint8_t* pixels = &model->pixels[model->row_identifier * ROW_BUFFER_LENGTH];
+    for(size_t i = 0; i < ROW_BUFFER_LENGTH; ++i) {
+        row[i] ^= pixels[i];
+    }
+    if(row_crc8(row) != model->rle_buffer[length]) {
+        return false;
+    }
+
+    memcpy(pixels, row, ROW_BUFFER_LENGTH);
+    return true;
+}
+
+// Drops the packet being parsed. While RLE rows are active the delta chain is
+// broken, so a keyframe is needed.
+static void drop_packet(UartDumpModel* model) {
+    model->ringbuffer_index = 0;
+    if(model->is_rle_active) {
+        model->is_keyframe_needed = true;
+    }
+}
+
+// Returns true once the last row of a frame has been stored.
+static bool process_ringbuffer(UartDumpModel* model, uint8_t const byte) {
     furi_assert(model);
-    furi_assert(byte);
 
     // The first HEADER_LENGTH bytes are reserved for header information.
     if(model->ringbuffer_index < HEADER_LENGTH) {
-        // Validate the start of row characters 'Y' and ':'.
-        if(model->ringbuffer_index == 0 && byte != 'Y') {
-            // Incorrect start of frame; reset.
-            return;
+        // Validate the start of row characters 'Y' or 'R' and ':'.
+        if(model->ringbuffer_index == 0) {
+            if(byte != 'Y' && byte != RLE_REQUEST) {
+                // Incorrect start of frame; reset.
+                drop_packet(model);
+                return false;
+            }
+            model->packet_type = byte;
+            model->packet_length = ROW_BUFFER_LENGTH;
         }
         if(model->ringbuffer_index == 1 && byte != ':') {
             // Incorrect start of frame; reset.
-            model->ringbuffer_index = 0;
-            return;
+            drop_packet(model);
+            return false;
         }
         if(model->ringbuffer_index == 2) {
+            if(model->packet_type == RLE_REQUEST && byte == RLE_ACK_ROW) {
+                // The camera acknowledged the RLE request.
+                model->is_rle_active = true;
+                model->ringbuffer_index = 0;
+                return false;
+            }
+            if(byte >= FRAME_HEIGHT ||
+               (model->packet_type == RLE_REQUEST && !model->is_rle_active)) {
+                // Row identifier out of range or RLE row without acknowledge; drop the row.
+                drop_packet(model);
+                return false;
+            }
             // Assign the third byte as the row identifier.
             model->row_identifier = byte;
+            if(model->packet_type == RLE_REQUEST) {
+                // Payload length follows as an extra header byte.
+                model->packet_length = 0;
+            }
         }
         model->ringbuffer_index++; // Increment index for the next byte.
-        return;
+        return false;
+    }
+
+    if(model->packet_length == 0) {
+        if(byte == 0 || byte > RLE_ROW_MAX_LENGTH) {
+            // Invalid payload length; drop the row.
+            drop_packet(model);
+            return false;
+        }
+        model->packet_length = byte + 1; // The CRC follows the payload.
+        return false;
     }
 
     // Store pixel value directly after the header.
-    model->row_ringbuffer[model->ringbuffer_index - HEADER_LENGTH] = byte;
+    size_t payload_index = model->ringbuffer_index - HEADER_LENGTH;
+    if(model->packet_type == RLE_REQUEST) {
+        model->rle_buffer[payload_index] = byte;
+    } else {
+        model->row_ringbuffer[payload_index] = byte;
+    }
     model->ringbuffer_index++; // Increment index for the next byte.
 
-    // Check whether the ring buffer is filled.
-    if(model->ringbuffer_index >= RING_BUFFER_LENGTH) {
-        model->ringbuffer_index = 0; // Reset the ring buffer index.
-        model->is_initialized = true; // Set the connection as successfully established.
+    // Check whether the row payload is complete.
+    if(payload_index + 1 < model->packet_length) {
+        return false;
+    }
 
-        // Compute the starting index for the row in the pixel buffer.
-        size_t row_start_index = model->row_identifier * ROW_BUFFER_LENGTH;
+    model->ringbuffer_index = 0; // Reset the ring buffer index.
 
-        // Ensure the row start index is within the valid range.
-        if(row_start_index > LAST_ROW_INDEX) {
-            row_start_index = 0; // Reset to a safe value in case of an overflow.
+    if(model->packet_type == RLE_REQUEST) {
+        if(!apply_rle_row(model)) {
+            // Malformed payload or CRC mismatch; keep the previous row.
+            model->is_keyframe_needed = true;
+            return false;
         }
-
+    } else {
         // Flush the contents of the ring buffer to the pixel buffer.
-        for(size_t i = 0; i < ROW_BUFFER_LENGTH; ++i) {
-            model->pixels[row_start_index + i] = model->row_ringbuffer[i];
-        }
+        memcpy(
+            &model->pixels[model->row_identifier * ROW_BUFFER_LENGTH],
+            model->row_ringbuffer,
+            ROW_BUFFER_LENGTH);
     }
+
+    model->is_initialized = true; // Set the connection as successfully established.
+
+    return model->row_identifier == FRAME_HEIGHT - 1;
 }
 
 static int32_t camera_worker(void* context) {
@@ -459,20 +639,32 @@ static int32_t camera_worker(void* context) {
                     furi_stream_buffer_receive(instance->rx_stream, data, intended_data_size, 0);
 
                 if(length > 0) {
+                    // Only redraw once a whole frame has arrived.
+                    bool is_frame_complete = false;
+                    bool is_keyframe_needed = false;
                     with_view_model(
                         instance->view,
                         UartDumpModel * model,
                         {
                             for(size_t i = 0; i < length; i++) {
-                                process_ringbuffer(model, data[i]);
+                                if(process_ringbuffer(model, data[i])) {
+                                    is_frame_complete = true;
+                                }
+                            }
+                            if(is_frame_complete) {
+                                render_frame_by_orientation(model);
+                                is_keyframe_needed = model->is_keyframe_needed;
+                                model->is_keyframe_needed = false;
                             }
                         },
-                        false);
+                        is_frame_complete);
+
+                    if(is_keyframe_needed) {
+                        // RLE rows were lost or corrupted, ask for raw rows.
+                        furi_hal_uart_tx(UART_CH, (uint8_t[]){RLE_KEYFRAME_REQUEST}, 1);
+                    }
                 }
             } while(length > 0);
-
-            with_view_model(
-                instance->view, UartDumpModel * model, { UNUSED(model); }, true);
         }
     }
 
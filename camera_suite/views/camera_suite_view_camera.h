@@ -31,6 +31,26 @@
 #define LAST_ROW_INDEX 1008
 #define RING_BUFFER_LENGTH 19
 #define ROW_BUFFER_LENGTH 16
+#define RLE_ROW_MAX_LENGTH 32 // PackBits of a 16 byte row never exceeds 17 bytes
+
+// Frame protocol, one packet per row, a frame ends with row FRAME_HEIGHT - 1:
+// - 'Y' ':' row + ROW_BUFFER_LENGTH raw pixel bytes (MSB is the leftmost pixel).
+// - 'R' ':' row + length + PackBits payload + CRC-8 of the row after the delta.
+//   The unpacked payload is XORed into the previous frame, unchanged rows are
+//   skipped (except the last one).
+// The FAP asks for 'R' packets with RLE_REQUEST and only accepts them once the
+// camera answered 'R' ':' RLE_ACK_ROW. Rows that fail the CRC are not applied,
+// and packets lost to a full stream buffer break the delta chain. Either way the
+// FAP sends RLE_KEYFRAME_REQUEST at the end of the frame, and the camera answers
+// with a frame of 'Y' rows. It also sends one every RLE_KEYFRAME_INTERVAL frames.
+// The current camera firmware only sends 'Y' rows, so the request is off by default.
+#ifndef RLE_ROWS_ENABLED
+#define RLE_ROWS_ENABLED 0
+#endif
+#define RLE_REQUEST 'R'
+#define RLE_ACK_ROW 0xFF
+#define RLE_KEYFRAME_REQUEST 'K'
+#define RLE_KEYFRAME_INTERVAL 30
 
 static const unsigned char bitmap_header[BITMAP_HEADER_LENGTH] = {
     0x42, 0x4D, 0x3E, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x28, 0x00,
@@ -62,12 +82,21 @@ typedef struct UartDumpModel {
     bool is_dithering_enabled;
     bool is_initialized;
     bool is_inverted;
+    bool is_keyframe_needed;
+    bool is_rle_active;
     int rotation_angle;
     uint32_t orientation;
     uint8_t pixels[FRAME_BUFFER_LENGTH];
+    // Pixels after orientation transform, XBM layout (LSB is the leftmost pixel).
+    uint8_t frame[FRAME_BUFFER_LENGTH];
+    uint8_t frame_width;
+    uint8_t frame_height;
+    uint8_t packet_type;
+    uint8_t packet_length;
     uint8_t ringbuffer_index;
     uint8_t row_identifier;
     uint8_t row_ringbuffer[RING_BUFFER_LENGTH];
+    uint8_t rle_buffer[RLE_ROW_MAX_LENGTH + 1]; // payload and CRC
 } UartDumpModel;
 
 // Function Prototypes
@@ -112,6 +112,25 @@ void SCL_randomBetterSeed(uint16_t seed);
 #define SCL_ALPHA_BETA 1
 #endif
 
+#ifndef SCL_MOVE_STACK_SIZE
+/**
+    Number of moves the AI can keep generated at once over all plies of the
+    search (3 bytes each), moves are generated into this stack so that they can
+    be ordered (captures and killer moves first) before being searched. If the
+    stack gets full, the remaining moves of a position are not searched, which
+    with the default value only happens in very extreme positions.
+  */
+#define SCL_MOVE_STACK_SIZE 1024
+#endif
+
+#ifndef SCL_KILLER_PLIES
+/**
+    Number of plies from the root of the search for which the AI remembers
+    killer moves (quiet moves that caused a cutoff), used for move ordering.
+  */
+#define SCL_KILLER_PLIES 16
+#endif
+
 /**
   A set of game squares as a bit array, each bit representing one game square.
   Useful for representing e.g. possible moves. To easily iterate over the set
@@ -659,6 +678,68 @@ int16_t SCL_getAIMove(
     uint8_t* resultTo,
     char* resultProm);
 
+/**
+  Returns time in arbitrary units (e.g. milliseconds) for the time-limited AI.
+*/
+typedef uint32_t (*SCL_TimeFunction)(void);
+
+/**
+  Like SCL_getAIMove, but uses iterative deepening: the position is searched to
+  depth 1, 2, ... up to maxDepth, each iteration ordering moves by the results
+  of the previous one. Iterations up to baseDepth are always finished, deeper
+  ones are only started and finished while less than timeLimit (in units of
+  timeFunc) has passed since the function was called, an unfinished iteration
+  is discarded. If timeFunc is 0, the search always goes to maxDepth. The depth
+  of the last finished iteration is stored in SCL_aiDepthReached.
+*/
+int16_t SCL_getAIMoveTimed(
+    SCL_Board board,
+    uint8_t baseDepth,
+    uint8_t maxDepth,
+    uint8_t extensionExtraDepth,
+    uint8_t endgameExtraDepth,
+    SCL_StaticEvaluationFunction evalFunc,
+    SCL_RandomFunction randFunc,
+    uint8_t randomness,
+    uint8_t repetitionMoveFrom,
+    uint8_t repetitionMoveTo,
+    SCL_TimeFunction timeFunc,
+    uint32_t timeLimit,
+    uint8_t* resultFrom,
+    uint8_t* resultTo,
+    char* resultProm);
+
+uint8_t SCL_aiDepthReached = 0; /**< Depth of the last finished iteration of
+                                     the last AI search. */
+
+/**
+  Entry of the AI transposition table.
+*/
+typedef struct {
+    uint16_t check; ///< upper bits of the position hash
+    int16_t value; ///< value from the moving player's point of view
+    uint8_t depth; ///< searched depth, 0 means empty entry
+    uint8_t flags; ///< bit 7: value is a lower bound, bits 0-6: generation
+    uint8_t moveFrom; ///< best move start square
+    uint8_t moveTo; ///< best move target square
+} SCL_TTEntry;
+
+/**
+  Gives the AI memory for a transposition table in which it stores results of
+  already searched positions (with deeper searches preferred when two positions
+  compete for the same entry). The number of entries used is the biggest power
+  of two that fits in size bytes. Pass 0 to stop using the table, the memory is
+  not freed by the library.
+*/
+void SCL_transpositionTableInit(void* memory, uint32_t size);
+
+/**
+  Counts leaf positions of the legal move tree of given depth (with all four
+  promotion pieces), which can be compared to known values to test the move
+  generation.
+*/
+uint32_t SCL_boardPerft(SCL_Board board, uint8_t depth);
+
 /**
   Function that prints out a single character. This is passed to printing
   functions.
@@ -1983,6 +2064,46 @@ void SCL_boardGetMoves(SCL_Board board, uint8_t pieceSquare, SCL_SquareSet resul
     SCL_SQUARE_SET_ITERATE_END
 }
 
+uint32_t SCL_boardPerft(SCL_Board board, uint8_t depth) {
+    if(depth == 0) return 1;
+
+    uint32_t result = 0;
+    uint8_t whitesTurn = SCL_boardWhitesTurn(board);
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i) {
+        char s = board[i];
+
+        if(s == '.' || SCL_pieceIsWhite(s) != whitesTurn) continue;
+
+        SCL_SquareSet moves;
+
+        SCL_boardGetMoves(board, i, moves);
+
+        SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+
+        uint8_t promotion = (s == 'P' || s == 'p') && (iteratedSquare < 8 || iteratedSquare >= 56);
+
+        if(depth == 1)
+            result += promotion ? 4 : 1;
+        else {
+            const char* pieces = promotion ? "qrbn" : "q";
+
+            while(*pieces != 0) {
+                SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, *pieces);
+
+                result += SCL_boardPerft(board, depth - 1);
+
+                SCL_boardUndoMove(board, undo);
+                pieces++;
+            }
+        }
+
+        SCL_SQUARE_SET_ITERATE_END
+    }
+
+    return result;
+}
+
 uint8_t SCL_boardDead(SCL_Board board) {
     /*
     This byte represents material by bits:
@@ -2534,6 +2655,164 @@ SCL_StaticEvaluationFunction _SCL_staticEvaluationFunction;
 int16_t _SCL_currentEval;
 int8_t _SCL_depthHardLimit;
 
+typedef struct {
+    uint8_t from;
+    uint8_t to;
+    uint8_t score; ///< ordering score, higher is searched first
+} _SCL_Move;
+
+_SCL_Move _SCL_moveStack[SCL_MOVE_STACK_SIZE];
+uint16_t _SCL_moveStackTop;
+uint16_t _SCL_killers[SCL_KILLER_PLIES][2]; // (from << 8) | to, 0 = none
+uint8_t _SCL_ply; // distance of the searched position from the root
+
+SCL_TTEntry* _SCL_tt = 0;
+uint32_t _SCL_ttMask;
+uint8_t _SCL_ttGeneration;
+
+SCL_TimeFunction _SCL_timeFunction; // 0 if the current search can't be aborted
+uint32_t _SCL_timeStart;
+uint32_t _SCL_timeLimit;
+uint8_t _SCL_nodeCount;
+uint8_t _SCL_searchAborted;
+
+void SCL_transpositionTableInit(void* memory, uint32_t size) {
+    uint32_t count = 0;
+
+    if(memory != 0 && size >= sizeof(SCL_TTEntry)) {
+        count = 1;
+
+        // the check bits must not overlap with the index bits
+        while(count < 65536 && count * 2 * sizeof(SCL_TTEntry) <= size) count *= 2;
+    }
+
+    _SCL_tt = count != 0 ? (SCL_TTEntry*)memory : 0;
+    _SCL_ttMask = count - 1;
+    _SCL_ttGeneration = 0;
+
+    for(uint32_t i = 0; i < count; ++i) _SCL_tt[i].depth = 0;
+}
+
+/**
+  Position hash for the transposition table. Unlike SCL_boardHash32 it ignores
+  the move counters (so that transpositions are recognized) and mixes each
+  square thoroughly, as a collision here means the AI misjudges a position.
+*/
+uint32_t _SCL_boardHashTT(SCL_Board board) {
+    uint32_t result = (board[SCL_BOARD_PLY_BYTE] & 0x01) ? 0x9e3779b9 : 0;
+
+    result ^= ((uint32_t)((uint8_t)board[SCL_BOARD_ENPASSANT_CASTLE_BYTE])) * 0x85ebca6b;
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i)
+        if(board[i] != '.') {
+            // Zobrist key of the piece on the square, computed instead of stored
+            uint32_t key = ((((uint32_t)i) << 8) | ((uint8_t)board[i])) + 1;
+
+            key ^= key >> 16;
+            key *= 0x85ebca6b;
+            key ^= key >> 13;
+            key *= 0xc2b2ae35;
+            key ^= key >> 16;
+
+            result ^= key;
+        }
+
+    return result;
+}
+
+uint8_t _SCL_pieceRank(char piece) {
+    switch(piece | 0x20) { // to lower case
+    case 'p':
+        return 1;
+    case 'n':
+        return 2;
+    case 'b':
+        return 3;
+    case 'r':
+        return 4;
+    case 'q':
+        return 5;
+    default:
+        return 6;
+    }
+}
+
+/**
+  Pushes legal moves of the player to move onto the move stack with their
+  ordering scores: the hint move (e.g. the best move from the transposition
+  table) first, then captures (most valuable victim, least valuable attacker),
+  promotions, killer moves and the remaining quiet moves. Returns the number of
+  moves pushed.
+*/
+uint8_t _SCL_generateMoves(SCL_Board board, uint8_t hintFrom, uint8_t hintTo) {
+    uint8_t whitesTurn = SCL_boardWhitesTurn(board);
+    uint16_t start = _SCL_moveStackTop;
+    uint16_t killer0 = 0, killer1 = 0;
+
+    if(_SCL_ply < SCL_KILLER_PLIES) {
+        killer0 = _SCL_killers[_SCL_ply][0];
+        killer1 = _SCL_killers[_SCL_ply][1];
+    }
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i) {
+        char s = board[i];
+
+        if(s == '.' || SCL_pieceIsWhite(s) != whitesTurn) continue;
+
+        SCL_SquareSet moves;
+
+        SCL_boardGetMoves(board, i, moves);
+
+        SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+
+        if(_SCL_moveStackTop >= SCL_MOVE_STACK_SIZE) {
+            iterationEnd = 1;
+        } else {
+            _SCL_Move* m = &_SCL_moveStack[_SCL_moveStackTop];
+            char target = board[iteratedSquare];
+            uint16_t move = (((uint16_t)i) << 8) | iteratedSquare;
+
+            m->from = i;
+            m->to = iteratedSquare;
+
+            if(i == hintFrom && iteratedSquare == hintTo)
+                m->score = 255;
+            else if(target != '.' && SCL_pieceIsWhite(target) != whitesTurn) // 960 castling
+                m->score = 128 + _SCL_pieceRank(target) * 8 - _SCL_pieceRank(s);
+            else if((s == 'P' || s == 'p') && (iteratedSquare < 8 || iteratedSquare >= 56))
+                m->score = 127;
+            else if(move == killer0)
+                m->score = 126;
+            else if(move == killer1)
+                m->score = 125;
+            else
+                m->score = 0;
+
+            _SCL_moveStackTop++;
+        }
+
+        SCL_SQUARE_SET_ITERATE_END
+    }
+
+    return _SCL_moveStackTop - start;
+}
+
+/**
+  Swaps the best scored move of the move stack range [index, end) to index.
+*/
+void _SCL_pickMove(uint16_t index, uint16_t end) {
+    uint16_t best = index;
+
+    for(uint16_t i = index + 1; i < end; ++i)
+        if(_SCL_moveStack[i].score > _SCL_moveStack[best].score) best = i;
+
+    if(best != index) {
+        _SCL_Move tmp = _SCL_moveStack[index];
+        _SCL_moveStack[index] = _SCL_moveStack[best];
+        _SCL_moveStack[best] = tmp;
+    }
+}
+
 /**
   Inner recursive function for SCL_boardEvaluateDynamic. It is passed a square
   (or -1) at which last capture happened, to implement capture extension.
@@ -2551,6 +2830,12 @@ int16_t _SCL_boardEvaluateDynamic(
     wdt_reset();
 #endif
 
+    if(_SCL_timeFunction != 0 && (++_SCL_nodeCount & 0x3f) == 0 &&
+       _SCL_timeFunction() - _SCL_timeStart >= _SCL_timeLimit)
+        _SCL_searchAborted = 1;
+
+    if(_SCL_searchAborted) return 0; // the result will be thrown away
+
     uint8_t whitesTurn = SCL_boardWhitesTurn(board);
     int8_t valueMultiply = whitesTurn ? 1 : -1;
     int16_t bestMoveValue = -1 * SCL_EVALUATION_MAX_SCORE;
@@ -2579,86 +2864,125 @@ int16_t _SCL_boardEvaluateDynamic(
 #endif
 
         alphaBeta *= valueMultiply;
-        uint8_t end = 0;
-        const char* b = board;
+        uint8_t cutoff = 0;
+        uint8_t hintFrom = 0, hintTo = 0;
+        SCL_TTEntry* ttEntry = 0;
+        uint16_t ttCheck = 0;
+
+        if(_SCL_tt != 0 && depth > 0) {
+            /* Only positions searched to positive depth are stored as below it
+          the result depends on the extensions along the path. For the same
+          reason the square of the last capture is a part of the key. */
+            uint32_t hash = _SCL_boardHashTT(board) ^
+                            (((uint32_t)(takenSquare + 1)) * 0x27d4eb2f);
+
+            ttEntry = &_SCL_tt[hash & _SCL_ttMask];
+            ttCheck = hash >> 16;
+
+            if(ttEntry->depth != 0 && ttEntry->check == ttCheck) {
+                hintFrom = ttEntry->moveFrom;
+                hintTo = ttEntry->moveTo;
+
+                /* values are only valid in the search that stored them (each
+              search has its own _SCL_currentEval), older entries still give
+              the move to try first */
+                if((ttEntry->flags & 0x7f) == _SCL_ttGeneration && ttEntry->depth >= depth &&
+                   (!(ttEntry->flags & 0x80) || ttEntry->value > alphaBeta)) {
+                    bestMoveValue = ttEntry->value;
+                    cutoff = 1;
+                    ttEntry = 0; // nothing new to store
+                }
+            }
+        }
 
         depth--;
 
-        for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i, ++b) {
-            char s = *b;
-
-            if(s != '.' && SCL_pieceIsWhite(s) == whitesTurn) {
-                SCL_SquareSet moves;
-
-                SCL_squareSetClear(moves);
-
-                SCL_boardGetMoves(board, i, moves);
+        uint16_t movesStart = _SCL_moveStackTop;
+        uint16_t movesEnd = movesStart;
+        uint8_t bestFrom = 0, bestTo = 0;
 
-                if(!SCL_squareSetEmpty(moves)) {
-                    SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+        if(!cutoff) movesEnd += _SCL_generateMoves(board, hintFrom, hintTo);
 
-                    int8_t captureExtension = -1;
+        for(uint16_t m = movesStart; m < movesEnd && !cutoff; ++m) {
+            _SCL_pickMove(m, movesEnd);
 
-                    if(board[iteratedSquare] != '.' && // takes a piece
-                       (takenSquare == -1 || // extend on first taken sq.
-                        (extended && takenSquare != -1) || // ignore check extension
-                        (iteratedSquare == takenSquare))) // extend on same sq. taken
-                        captureExtension = iteratedSquare;
+            uint8_t squareFrom = _SCL_moveStack[m].from;
+            uint8_t squareTo = _SCL_moveStack[m].to;
+            int8_t captureExtension = -1;
 
-                    SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
+            if(board[squareTo] != '.' && // takes a piece
+               (takenSquare == -1 || // extend on first taken sq.
+                (extended && takenSquare != -1) || // ignore check extension
+                (squareTo == takenSquare))) // extend on same sq. taken
+                captureExtension = squareTo;
 
-                    uint8_t s0Dummy, s1Dummy;
-                    char pDummy;
-
-                    SCL_UNUSED(s0Dummy);
-                    SCL_UNUSED(s1Dummy);
-                    SCL_UNUSED(pDummy);
+            SCL_MoveUndo undo = SCL_boardMakeMove(board, squareFrom, squareTo, 'q');
 
 #if SCL_DEBUG_AI
-                    if(debugFirst)
-                        debugFirst = 0;
-                    else
-                        putchar(',');
+            if(debugFirst)
+                debugFirst = 0;
+            else
+                putchar(',');
 
-                    if(extended) putchar('*');
+            if(extended) putchar('*');
 
-                    printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
+            printf("%s ", SCL_moveToString(board, squareFrom, squareTo, 'q', moveStr));
 #endif
 
-                    int16_t value = _SCL_boardEvaluateDynamic(
-                                        board,
-                                        depth, // this is depth - 1, we decremented it
+            _SCL_ply++;
+
+            int16_t value = _SCL_boardEvaluateDynamic(
+                                board,
+                                depth, // this is depth - 1, we decremented it
 #if SCL_ALPHA_BETA
-                                        valueMultiply * bestMoveValue,
+                                valueMultiply * bestMoveValue,
 #else
-                                        0,
+                                0,
 #endif
-                                        captureExtension) *
-                                    valueMultiply;
+                                captureExtension) *
+                            valueMultiply;
+
+            _SCL_ply--;
 
-                    SCL_boardUndoMove(board, undo);
+            SCL_boardUndoMove(board, undo);
 
-                    if(value > bestMoveValue) {
-                        bestMoveValue = value;
+            if(value > bestMoveValue) {
+                bestMoveValue = value;
+                bestFrom = squareFrom;
+                bestTo = squareTo;
 
 #if SCL_ALPHA_BETA
-                        // alpha-beta pruning:
+                // alpha-beta pruning:
 
-                        if(value > alphaBeta) // no, >= can't be here
-                        {
-                            end = 1;
-                            iterationEnd = 1;
-                        }
-#endif
-                    }
+                if(value > alphaBeta) // no, >= can't be here
+                {
+                    cutoff = 1;
 
-                    SCL_SQUARE_SET_ITERATE_END
-                } // !squre set empty?
-            } // valid piece?
+                    uint16_t move = (((uint16_t)squareFrom) << 8) | squareTo;
 
-            if(end) break;
+                    if(board[squareTo] == '.' && _SCL_ply < SCL_KILLER_PLIES &&
+                       _SCL_killers[_SCL_ply][0] != move) {
+                        _SCL_killers[_SCL_ply][1] = _SCL_killers[_SCL_ply][0];
+                        _SCL_killers[_SCL_ply][0] = move;
+                    }
+                }
+#endif
+            }
+        }
 
-        } // for each square
+        _SCL_moveStackTop = movesStart;
+
+        // depth-preferred replacement, entries of older searches are free
+        if(ttEntry != 0 && !_SCL_searchAborted &&
+           (ttEntry->depth == 0 || (ttEntry->flags & 0x7f) != _SCL_ttGeneration ||
+            depth + 1 >= ttEntry->depth)) {
+            ttEntry->check = ttCheck;
+            ttEntry->value = bestMoveValue;
+            ttEntry->depth = depth + 1;
+            ttEntry->flags = _SCL_ttGeneration | (cutoff ? 0x80 : 0);
+            ttEntry->moveFrom = bestFrom;
+            ttEntry->moveTo = bestTo;
+        }
 
 #if SCL_DEBUG_AI
         putchar(')');
@@ -2693,9 +3017,11 @@ int16_t _SCL_boardEvaluateDynamic(
     return bestMoveValue * valueMultiply;
 }
 
-int16_t SCL_boardEvaluateDynamic(
+/**
+  Prepares global state for a new search from given position.
+*/
+void _SCL_searchInit(
     SCL_Board board,
-    uint8_t baseDepth,
     uint8_t extensionExtraDepth,
     SCL_StaticEvaluationFunction evalFunction) {
     _SCL_staticEvaluationFunction = evalFunction;
@@ -2703,6 +3029,33 @@ int16_t SCL_boardEvaluateDynamic(
     _SCL_depthHardLimit = 0;
     _SCL_depthHardLimit -= extensionExtraDepth;
 
+    _SCL_moveStackTop = 0;
+    _SCL_ply = 0;
+    _SCL_timeFunction = 0;
+    _SCL_searchAborted = 0;
+
+    for(uint8_t i = 0; i < SCL_KILLER_PLIES; ++i) {
+        _SCL_killers[i][0] = 0;
+        _SCL_killers[i][1] = 0;
+    }
+
+    _SCL_ttGeneration = (_SCL_ttGeneration + 1) & 0x7f;
+
+    if(_SCL_ttGeneration == 0) // wrapped around, forget entries of old searches
+    {
+        for(uint32_t i = 0; _SCL_tt != 0 && i <= _SCL_ttMask; ++i) _SCL_tt[i].depth = 0;
+
+        _SCL_ttGeneration = 1;
+    }
+}
+
+int16_t SCL_boardEvaluateDynamic(
+    SCL_Board board,
+    uint8_t baseDepth,
+    uint8_t extensionExtraDepth,
+    SCL_StaticEvaluationFunction evalFunction) {
+    _SCL_searchInit(board, extensionExtraDepth, evalFunction);
+
     return _SCL_boardEvaluateDynamic(
         board,
         baseDepth,
@@ -2758,9 +3111,125 @@ void SCL_printBoardSimple(
     SCL_printBoard(board, putCharFunc, s, selectSquare, format, 1, 1, 0);
 }
 
-int16_t SCL_getAIMove(
+/**
+  Searches the root position to given depth, see SCL_getAIMove. The root moves
+  are expected at the bottom of the move stack, in the order in which they are
+  searched; the best found move is moved to the front for the next iteration.
+*/
+int16_t _SCL_searchRoot(
+    SCL_Board board,
+    uint8_t depth,
+    uint16_t moveCount,
+    SCL_RandomFunction randFunc,
+    uint8_t randomness,
+    uint8_t repetitionMoveFrom,
+    uint8_t repetitionMoveTo,
+    uint8_t* resultFrom,
+    uint8_t* resultTo) {
+#if SCL_DEBUG_AI
+    putchar('(');
+    unsigned char debugFirst = 1;
+    char moveStr[8];
+#endif
+
+    uint8_t whitesTurn = SCL_boardWhitesTurn(board);
+    uint16_t bestIndex = 0;
+
+    int16_t bestScore = whitesTurn ? -1 * SCL_EVALUATION_MAX_SCORE - 1 :
+                                     (SCL_EVALUATION_MAX_SCORE + 1);
+
+    /* Moves can be cut off by the best score so far unless a random bias is
+     added to the scores. The margin of 2 keeps cut off moves strictly worse
+     even after the +-1 depth adjustment, so equally good moves are still rated
+     exactly for the random pick between them. */
+    uint8_t useBound = SCL_ALPHA_BETA && (randFunc == 0 || randomness <= 1);
+
+    *resultFrom = 0;
+    *resultTo = 0;
+
+    for(uint16_t m = 0; m < moveCount; ++m) {
+        uint8_t squareFrom = _SCL_moveStack[m].from;
+        uint8_t squareTo = _SCL_moveStack[m].to;
+        int16_t score = 0;
+
+#if SCL_DEBUG_AI
+        if(debugFirst)
+            debugFirst = 0;
+        else
+            putchar(',');
+
+        printf("%s ", SCL_moveToString(board, squareFrom, squareTo, 'q', moveStr));
+#endif
+
+        if(squareFrom != repetitionMoveFrom || squareTo != repetitionMoveTo) {
+            int16_t bound = useBound ? bestScore - (whitesTurn ? 2 : -2) :
+                                       (whitesTurn ? -1 * SCL_EVALUATION_MAX_SCORE :
+                                                     SCL_EVALUATION_MAX_SCORE);
+
+            SCL_MoveUndo undo = SCL_boardMakeMove(board, squareFrom, squareTo, 'q');
+
+            _SCL_ply++;
+            score = _SCL_boardEvaluateDynamic(board, depth - 1, bound, -1);
+            _SCL_ply--;
+
+            SCL_boardUndoMove(board, undo);
+        }
+
+        if(_SCL_searchAborted) break;
+
+        if(randFunc != 0 && randomness > 1 && score < 16000 && score > -16000) {
+            /*^ We limit randomizing by about half the max score for two reasons:
+          to prevent over/under flows and secondly we don't want to alter
+          the highest values for checkmate -- these are modified by tiny
+          values depending on their depth so as to prevent endless loops in
+          which most moves are winning, biasing such values would completely
+          kill that algorithm */
+
+            int16_t bias = randFunc();
+            bias = (bias - 128) / 2;
+            bias *= randomness - 1;
+            score += bias;
+        }
+
+        uint8_t comparison = score == bestScore;
+
+        if((comparison != 1) &&
+           ((whitesTurn && score > bestScore) || (!whitesTurn && score < bestScore)))
+            comparison = 2;
+
+        uint8_t replace = 0;
+
+        if(randFunc == 0)
+            replace = comparison == 2;
+        else
+            replace = (comparison == 2) ||
+                      ((comparison == 1) && (randFunc() < 160)); // not uniform distr. but simple
+
+        if(replace) {
+            *resultFrom = squareFrom;
+            *resultTo = squareTo;
+            bestScore = score;
+            bestIndex = m;
+        }
+    }
+
+    _SCL_Move best = _SCL_moveStack[bestIndex];
+
+    for(uint16_t m = bestIndex; m > 0; --m) _SCL_moveStack[m] = _SCL_moveStack[m - 1];
+
+    _SCL_moveStack[0] = best;
+
+#if SCL_DEBUG_AI
+    printf(")%d %s\n", bestScore, SCL_moveToString(board, *resultFrom, *resultTo, 'q', moveStr));
+#endif
+
+    return bestScore;
+}
+
+int16_t SCL_getAIMoveTimed(
     SCL_Board board,
     uint8_t baseDepth,
+    uint8_t maxDepth,
     uint8_t extensionExtraDepth,
     uint8_t endgameExtraDepth,
     SCL_StaticEvaluationFunction evalFunc,
@@ -2768,14 +3237,17 @@ int16_t SCL_getAIMove(
     uint8_t randomness,
     uint8_t repetitionMoveFrom,
     uint8_t repetitionMoveTo,
+    SCL_TimeFunction timeFunc,
+    uint32_t timeLimit,
     uint8_t* resultFrom,
     uint8_t* resultTo,
     char* resultProm) {
+    uint32_t timeStart = timeFunc != 0 ? timeFunc() : 0;
+
+    SCL_aiDepthReached = 0;
+
 #if SCL_DEBUG_AI
     puts("===== AI debug =====");
-    putchar('(');
-    unsigned char debugFirst = 1;
-    char moveStr[8];
 #endif
 
     if(baseDepth == 0) {
@@ -2787,92 +3259,98 @@ int16_t SCL_getAIMove(
 #endif
     }
 
-    if(SCL_boardEstimatePhase(board) == SCL_PHASE_ENDGAME) baseDepth += endgameExtraDepth;
+    if(SCL_boardEstimatePhase(board) == SCL_PHASE_ENDGAME) {
+        baseDepth += endgameExtraDepth;
+        maxDepth += endgameExtraDepth;
+    }
+
+    if(maxDepth < baseDepth) maxDepth = baseDepth;
 
     *resultFrom = 0;
     *resultTo = 0;
     *resultProm = 'q';
 
-    int16_t bestScore = SCL_boardWhitesTurn(board) ? -1 * SCL_EVALUATION_MAX_SCORE - 1 :
-                                                     (SCL_EVALUATION_MAX_SCORE + 1);
+    _SCL_searchInit(board, extensionExtraDepth, evalFunc);
 
-    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i)
-        if(board[i] != '.' && SCL_boardWhitesTurn(board) == SCL_pieceIsWhite(board[i])) {
-            SCL_SquareSet moves;
+    uint16_t moveCount = _SCL_generateMoves(board, 0, 0);
 
-            SCL_squareSetClear(moves);
+    // root moves are searched in order, initially sort them by the scores
+    for(uint16_t i = 1; i < moveCount; ++i) {
+        _SCL_Move move = _SCL_moveStack[i];
+        uint16_t j = i;
 
-            SCL_boardGetMoves(board, i, moves);
-
-            SCL_SQUARE_SET_ITERATE_BEGIN(moves)
-
-            int16_t score = 0;
-
-#if SCL_DEBUG_AI
-            if(debugFirst)
-                debugFirst = 0;
-            else
-                putchar(',');
+        for(; j > 0 && _SCL_moveStack[j - 1].score < move.score; --j)
+            _SCL_moveStack[j] = _SCL_moveStack[j - 1];
 
-            printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
-
-#endif
-
-            if(i != repetitionMoveFrom || iteratedSquare != repetitionMoveTo) {
-                SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
+        _SCL_moveStack[j] = move;
+    }
 
-                score =
-                    SCL_boardEvaluateDynamic(board, baseDepth - 1, extensionExtraDepth, evalFunc);
+    int16_t bestScore = 0;
 
-                SCL_boardUndoMove(board, undo);
-            }
+    for(uint16_t depth = 1; depth <= maxDepth; ++depth) {
+        if(depth > baseDepth && (timeFunc == 0 || timeFunc() - timeStart >= timeLimit))
+            break;
 
-            if(randFunc != 0 && randomness > 1 && score < 16000 && score > -16000) {
-                /*^ We limit randomizing by about half the max score for two reasons:
-            to prevent over/under flows and secondly we don't want to alter
-            the highest values for checkmate -- these are modified by tiny
-            values depending on their depth so as to prevent endless loops in
-            which most moves are winning, biasing such values would completely
-            kill that algorithm */
-
-                int16_t bias = randFunc();
-                bias = (bias - 128) / 2;
-                bias *= randomness - 1;
-                score += bias;
-            }
+        uint8_t from, to;
 
-            uint8_t comparison = score == bestScore;
+        // only the iterations over the base depth may run out of time
+        _SCL_timeFunction = depth > baseDepth ? timeFunc : 0;
+        _SCL_timeStart = timeStart;
+        _SCL_timeLimit = timeLimit;
 
-            if((comparison != 1) && ((SCL_boardWhitesTurn(board) && score > bestScore) ||
-                                     (!SCL_boardWhitesTurn(board) && score < bestScore)))
-                comparison = 2;
+        int16_t score = _SCL_searchRoot(
+            board, depth, moveCount, randFunc, randomness, repetitionMoveFrom, repetitionMoveTo,
+            &from, &to);
 
-            uint8_t replace = 0;
+        if(_SCL_searchAborted) break;
 
-            if(randFunc == 0)
-                replace = comparison == 2;
-            else
-                replace =
-                    (comparison == 2) ||
-                    ((comparison == 1) && (randFunc() < 160)); // not uniform distr. but simple
-
-            if(replace) {
-                *resultFrom = i;
-                *resultTo = iteratedSquare;
-                bestScore = score;
-            }
+        *resultFrom = from;
+        *resultTo = to;
+        bestScore = score;
+        SCL_aiDepthReached = depth;
+    }
 
-            SCL_SQUARE_SET_ITERATE_END
-        }
+    _SCL_timeFunction = 0;
+    _SCL_moveStackTop = 0;
 
 #if SCL_DEBUG_AI
-    printf(")%d %s\n", bestScore, SCL_moveToString(board, *resultFrom, *resultTo, 'q', moveStr));
     puts("===== AI debug end ===== ");
 #endif
 
     return bestScore;
 }
 
+int16_t SCL_getAIMove(
+    SCL_Board board,
+    uint8_t baseDepth,
+    uint8_t extensionExtraDepth,
+    uint8_t endgameExtraDepth,
+    SCL_StaticEvaluationFunction evalFunc,
+    SCL_RandomFunction randFunc,
+    uint8_t randomness,
+    uint8_t repetitionMoveFrom,
+    uint8_t repetitionMoveTo,
+    uint8_t* resultFrom,
+    uint8_t* resultTo,
+    char* resultProm) {
+    return SCL_getAIMoveTimed(
+        board,
+        baseDepth,
+        baseDepth,
+        extensionExtraDepth,
+        endgameExtraDepth,
+        evalFunc,
+        randFunc,
+        randomness,
+        repetitionMoveFrom,
+        repetitionMoveTo,
+        0,
+        0,
+        resultFrom,
+        resultTo,
+        resultProm);
+}
+
 uint8_t SCL_boardToFEN(SCL_Board board, char* string) {
     uint8_t square = 56;
     uint8_t spaces = 0;
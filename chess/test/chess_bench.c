@@ -0,0 +1,144 @@
+// Host build of smallchesslib: checks the move generator against known perft
+// counts and benchmarks the AI the way the app configures it.
+//
+//   make -C chess/test run
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SCL_960_CASTLING 0
+#define SCL_COUNT_EVALUATED_POSITIONS 1
+#define SCL_EVALUATION_FUNCTION SCL_boardEvaluateStatic
+#define SCL_DEBUG_AI 0
+
+#include "../chess/smallchesslib.h"
+
+#define AI_TABLE_SIZE (16 * 1024) // same as the app
+#define AI_TIME_LIMIT 1000 // ms per position for the timed search
+#define AI_BASE_DEPTH 2
+#define AI_MAX_DEPTH 20
+
+// https://www.chessprogramming.org/Perft_Results
+static const struct {
+    const char* fen;
+    uint8_t depth;
+    uint32_t nodes;
+} perft_suite[] = {
+    {SCL_FEN_START, 4, 197281},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+};
+
+// openings, middlegames and endgames
+static const char* search_suite[] = {
+    SCL_FEN_START,
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1B1PPP/R2QKB1R w KQ - 0 8",
+    "r2q1rk1/ppp2ppp/2n1bn2/2bpp3/4P3/2PP1N2/PP1NBPPP/R1BQ1RK1 b - - 0 8",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "2r3k1/pp3ppp/8/3N4/8/8/PPP2PPP/4R1K1 w - - 0 1",
+};
+
+#define COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint32_t time_ms(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000 + t.tv_nsec / 1000000;
+}
+
+static double per_second(uint32_t count, uint32_t ms) {
+    return count * 1000.0 / (ms ? ms : 1);
+}
+
+static int run_perft(void) {
+    int failed = 0;
+    printf("perft\n");
+    for(size_t i = 0; i < COUNT_OF(perft_suite); i++) {
+        SCL_Board board;
+        SCL_boardFromFEN(board, perft_suite[i].fen);
+
+        uint32_t start = time_ms();
+        uint32_t nodes = SCL_boardPerft(board, perft_suite[i].depth);
+        uint32_t elapsed = time_ms() - start;
+
+        bool ok = nodes == perft_suite[i].nodes;
+        failed += !ok;
+        printf(
+            "  %zu: depth %u %8u nodes %s %8.0f nodes/s\n",
+            i + 1,
+            perft_suite[i].depth,
+            nodes,
+            ok ? "ok  " : "FAIL",
+            per_second(nodes, elapsed));
+        if(!ok) printf("     expected %u\n", perft_suite[i].nodes);
+    }
+    return failed;
+}
+
+static void run_search(void) {
+    static uint8_t table[AI_TABLE_SIZE];
+    SCL_transpositionTableInit(table, sizeof(table));
+
+    printf("search, %u ms per position\n", AI_TIME_LIMIT);
+    uint32_t total_nodes = 0, total_ms = 0, total_depth = 0;
+    for(size_t i = 0; i < COUNT_OF(search_suite); i++) {
+        SCL_Board board;
+        uint8_t from, to;
+        char prom, move[8];
+        SCL_boardFromFEN(board, search_suite[i]);
+        SCL_positionsEvaluated = 0;
+
+        uint32_t start = time_ms();
+        int16_t value = SCL_getAIMoveTimed(
+            board,
+            AI_BASE_DEPTH,
+            AI_MAX_DEPTH,
+            3,
+            1,
+            SCL_boardEvaluateStatic,
+            0,
+            0,
+            255,
+            255,
+            time_ms,
+            AI_TIME_LIMIT,
+            &from,
+            &to,
+            &prom);
+        uint32_t elapsed = time_ms() - start;
+
+        total_nodes += SCL_positionsEvaluated;
+        total_ms += elapsed;
+        total_depth += SCL_aiDepthReached;
+        printf(
+            "  %zu: %-5s %6d depth %2u %9u nodes %5u ms %8.0f nodes/s\n",
+            i + 1,
+            SCL_moveToString(board, from, to, prom, move),
+            value,
+            SCL_aiDepthReached,
+            SCL_positionsEvaluated,
+            elapsed,
+            per_second(SCL_positionsEvaluated, elapsed));
+    }
+    printf(
+        "  total %u nodes in %u ms, %.0f nodes/s, average depth %.1f\n",
+        total_nodes,
+        total_ms,
+        per_second(total_nodes, total_ms),
+        (double)total_depth / COUNT_OF(search_suite));
+
+    SCL_transpositionTableInit(NULL, 0);
+}
+
+int main(void) {
+    int failed = run_perft();
+    run_search();
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -21,11 +21,15 @@
 #define MAX_TEXT_LEN 15 // 15 = max length of text
 #define MAX_TEXT_BUF (MAX_TEXT_LEN + 1) // max length of text + null terminator
 #define THREAD_WAIT_TIME 20 // time to wait for draw thread to finish
+#define AI_EXTRA_DEPTH 2 // how much deeper than its level the AI searches if time allows
+#define AI_TIME_LIMIT 3000 // ms after which the AI stops searching deeper than its level
+#define AI_TABLE_SIZE (16 * 1024) // bytes of the AI transposition table
 
 struct FlipChessScene1 {
     View* view;
     FlipChessScene1Callback callback;
     void* context;
+    void* ai_table;
 };
 typedef struct {
     uint8_t paramPlayerW;
@@ -122,9 +126,10 @@ int16_t flipchess_makeAIMove(
         }
     }
 
-    return SCL_getAIMove(
+    return SCL_getAIMoveTimed(
         board,
         depth,
+        depth + AI_EXTRA_DEPTH,
         extraDepth,
         endgameDepth,
         SCL_boardEvaluateStatic,
@@ -132,6 +137,8 @@ int16_t flipchess_makeAIMove(
         randomness,
         rs0,
         rs1,
+        furi_get_tick,
+        AI_TIME_LIMIT,
         s0,
         s1,
         prom);
@@ -708,6 +715,9 @@ FlipChessScene1* flipchess_scene_1_alloc() {
     view_set_enter_callback(instance->view, flipchess_scene_1_enter);
     view_set_exit_callback(instance->view, flipchess_scene_1_exit);
 
+    instance->ai_table = malloc(AI_TABLE_SIZE);
+    SCL_transpositionTableInit(instance->ai_table, AI_TABLE_SIZE);
+
     return instance;
 }
 
@@ -718,6 +728,8 @@ void flipchess_scene_1_free(FlipChessScene1* instance) {
         instance->view, FlipChessScene1Model * model, { UNUSED(model); }, true);
 
     view_free(instance->view);
+    SCL_transpositionTableInit(NULL, 0);
+    free(instance->ai_table);
     free(instance);
 }
 
@@ -10,6 +10,7 @@
 #include "constants.h"
 #include "entities.h"
 #include "types.h"
+#include "fixed.h"
 #include "level.h"
 #include <notification/notification.h>
 #include <notification/notification_messages.h>
@@ -26,6 +27,11 @@
     } while(0)
 #define sign(a, b) (double)(a > b ? 1 : (b > a ? -1 : 0))
 #define pgm_read_byte(addr) (*(const unsigned char*)(addr))
+// Table angle per tick of the jogging animation, in 1 / FIXED_ONE steps
+#define JOGGING_ANGLE_STEP ((uint32_t)(JOGGING_SPEED * FIXED_ANGLES / (2 * PI) * FIXED_ONE))
+#define jogging_angle() ((uint16_t)((furi_get_tick() * JOGGING_ANGLE_STEP) >> FIXED_SHIFT))
+// Fireballs store their direction as FIREBALL_ANGLES per half turn
+#define fireball_angle(dir) ((dir) * (FIXED_ANGLES / 2) / FIREBALL_ANGLES)
 
 typedef enum {
     EventTypeTick,
@@ -420,10 +426,10 @@ void updateEntities(const uint8_t level[], Canvas* const canvas, PluginState* co
                 UID collided = updatePosition(
                     level,
                     &(plugin_state->entity[i].pos),
-                    cos((double)plugin_state->entity[i].health / FIREBALL_ANGLES * (double)PI) *
-                        (double)FIREBALL_SPEED,
-                    sin((double)plugin_state->entity[i].health / FIREBALL_ANGLES * (double)PI) *
-                        (double)FIREBALL_SPEED,
+                    (double)fixed_cos(fireball_angle(plugin_state->entity[i].health)) *
+                        (double)FIREBALL_SPEED / FIXED_ONE,
+                    (double)fixed_sin(fireball_angle(plugin_state->entity[i].health)) *
+                        (double)FIREBALL_SPEED / FIXED_ONE,
                     true,
                     plugin_state);
 
@@ -466,7 +472,17 @@ void updateEntities(const uint8_t level[], Canvas* const canvas, PluginState* co
     }
 }
 
+// Distance along a ray to the first grid line it crosses. The reciprocal clamps for rays
+// almost parallel to the axis, frac * delta would put that crossing far too close.
+static fixed_t first_side(fixed_t frac, fixed_t ray, fixed_t delta) {
+    if(delta < FIXED_RECIP_MAX) return fixed_mul(frac, delta);
+    if(ray == 0) return FIXED_RECIP_MAX;
+    int64_t side = ((int64_t)frac << FIXED_SHIFT) / (ray < 0 ? -ray : ray);
+    return side < FIXED_RECIP_MAX ? side : FIXED_RECIP_MAX;
+}
+
 // The map raycaster. Based on https://lodev.org/cgtutor/raycasting.html
+// Runs in 16.16 fixed point, the FPU only handles single precision and doubles are emulated.
 void renderMap(
     const uint8_t level[],
     double view_height,
@@ -474,35 +490,47 @@ void renderMap(
     PluginState* const plugin_state) {
     UID last_uid = 0; // NOT SURE ?
 
+    const fixed_t pos_x = fixed_from_double(plugin_state->player.pos.x);
+    const fixed_t pos_y = fixed_from_double(plugin_state->player.pos.y);
+    const fixed_t dir_x = fixed_from_double(plugin_state->player.dir.x);
+    const fixed_t dir_y = fixed_from_double(plugin_state->player.dir.y);
+    const fixed_t plane_x = fixed_from_double(plugin_state->player.plane.x);
+    const fixed_t plane_y = fixed_from_double(plugin_state->player.plane.y);
+    const fixed_t view_offset = fixed_from_double(view_height);
+    Coords map_coords = {plugin_state->player.pos.x, plugin_state->player.pos.y};
+    // Spawn check only depends on the player position, evaluate it once per frame
+    bool spawn_in_range = coords_distance_sq(&(plugin_state->player.pos), &map_coords) <
+                          MAX_ENTITY_DISTANCE * MAX_ENTITY_DISTANCE;
+
     for(uint8_t x = 0; x < SCREEN_WIDTH; x += RES_DIVIDER) {
-        double camera_x = 2 * (double)x / SCREEN_WIDTH - 1;
-        double ray_x = plugin_state->player.dir.x + plugin_state->player.plane.x * camera_x;
-        double ray_y = plugin_state->player.dir.y + plugin_state->player.plane.y * camera_x;
-        uint8_t map_x = (uint8_t)plugin_state->player.pos.x;
-        uint8_t map_y = (uint8_t)plugin_state->player.pos.y;
-        Coords map_coords = {plugin_state->player.pos.x, plugin_state->player.pos.y};
-        double delta_x = fabs(1 / ray_x);
-        double delta_y = fabs(1 / ray_y);
+        // 2 * x / SCREEN_WIDTH - 1
+        fixed_t camera_x = fixed_from_int(2 * x) / SCREEN_WIDTH - FIXED_ONE;
+        fixed_t ray_x = dir_x + fixed_mul(plane_x, camera_x);
+        fixed_t ray_y = dir_y + fixed_mul(plane_y, camera_x);
+        uint8_t map_x = fixed_to_int(pos_x);
+        uint8_t map_y = fixed_to_int(pos_y);
+        fixed_t delta_x = fixed_recip(ray_x < 0 ? -ray_x : ray_x);
+        fixed_t delta_y = fixed_recip(ray_y < 0 ? -ray_y : ray_y);
 
         int8_t step_x;
         int8_t step_y;
-        double side_x;
-        double side_y;
+        fixed_t side_x;
+        fixed_t side_y;
 
         if(ray_x < 0) {
             step_x = -1;
-            side_x = (plugin_state->player.pos.x - map_x) * delta_x;
+            side_x = first_side(fixed_frac(pos_x), ray_x, delta_x);
         } else {
             step_x = 1;
-            side_x = (map_x + (double)1.0 - plugin_state->player.pos.x) * delta_x;
+            side_x = first_side(FIXED_ONE - fixed_frac(pos_x), ray_x, delta_x);
         }
 
         if(ray_y < 0) {
             step_y = -1;
-            side_y = (plugin_state->player.pos.y - map_y) * delta_y;
+            side_y = first_side(fixed_frac(pos_y), ray_y, delta_y);
         } else {
             step_y = 1;
-            side_y = (map_y + (double)1.0 - plugin_state->player.pos.y) * delta_y;
+            side_y = first_side(FIXED_ONE - fixed_frac(pos_y), ray_y, delta_y);
         }
 
         // Wall detection
@@ -530,8 +558,7 @@ void renderMap(
                 // cost scan for them in another loop
                 if(block == E_ENEMY || (block & 0b00001000) /* all collectable items */) {
                     // Check that it's close to the player
-                    if(coords_distance(&(plugin_state->player.pos), &map_coords) <
-                       MAX_ENTITY_DISTANCE) {
+                    if(spawn_in_range) {
                         UID uid = create_uid(block, map_x, map_y);
                         if(last_uid != uid && !isSpawned(uid, plugin_state)) {
                             spawnEntity(block, map_x, map_y, plugin_state);
@@ -545,27 +572,25 @@ void renderMap(
         }
 
         if(hit) {
-            double distance;
-
-            if(side == 0) {
-                distance =
-                    fmax(1, (map_x - plugin_state->player.pos.x + (1 - step_x) / 2) / ray_x);
-            } else {
-                distance =
-                    fmax(1, (map_y - plugin_state->player.pos.y + (1 - step_y) / 2) / ray_y);
-            }
+            // Perpendicular distance is the side distance before the last step
+            fixed_t distance = side == 0 ? side_x - delta_x : side_y - delta_y;
+            if(distance < FIXED_ONE) distance = FIXED_ONE;
+            fixed_t inv_distance = fixed_recip(distance);
 
             // store zbuffer value for the column
-            zbuffer[x / Z_RES_DIVIDER] = fmin(distance * DISTANCE_MULTIPLIER, 255);
+            uint32_t z = fixed_to_int(distance * DISTANCE_MULTIPLIER);
+            zbuffer[x / Z_RES_DIVIDER] = z > 255 ? 255 : z;
 
             // rendered line height
-            uint8_t line_height = RENDER_HEIGHT / distance;
+            uint8_t line_height = fixed_to_int(RENDER_HEIGHT * inv_distance);
+            fixed_t offset = fixed_mul(view_offset, inv_distance);
 
             drawVLine(
                 x,
-                view_height / distance - line_height / 2 + RENDER_HEIGHT / 2,
-                view_height / distance + line_height / 2 + RENDER_HEIGHT / 2,
-                GRADIENT_COUNT - (int)distance / MAX_RENDER_DEPTH * GRADIENT_COUNT - side * 2,
+                fixed_to_int(offset + fixed_from_int(RENDER_HEIGHT / 2 - line_height / 2)),
+                fixed_to_int(offset + fixed_from_int(RENDER_HEIGHT / 2 + line_height / 2)),
+                GRADIENT_COUNT - fixed_to_int(distance) / MAX_RENDER_DEPTH * GRADIENT_COUNT -
+                    side * 2,
                 canvas);
         }
     }
@@ -717,9 +742,9 @@ void renderEntities(double view_height, Canvas* const canvas, PluginState* const
 
 void renderGun(uint8_t gun_pos, double amount_jogging, Canvas* const canvas) {
     // jogging
-    char x = 48 + sin((double)furi_get_tick() * (double)JOGGING_SPEED) * 10 * amount_jogging;
-    char y = RENDER_HEIGHT - gun_pos +
-             fabs(cos((double)furi_get_tick() * (double)JOGGING_SPEED)) * 8 * amount_jogging;
+    uint16_t angle = jogging_angle();
+    char x = 48 + fixed_sin(angle) * 10 * amount_jogging / FIXED_ONE;
+    char y = RENDER_HEIGHT - gun_pos + abs(fixed_cos(angle)) * 8 * amount_jogging / FIXED_ONE;
 
     if(gun_pos > GUN_SHOT_POS - 2) {
         // Gun fire
@@ -908,8 +933,7 @@ static void doom_game_tick(PluginState* const plugin_state) {
                 //plugin_state->left = false;
             }
             plugin_state->view_height =
-                fabs(sin((double)furi_get_tick() * (double)JOGGING_SPEED)) * 6 *
-                plugin_state->jogging;
+                abs(fixed_sin(jogging_angle())) * 6 * plugin_state->jogging / FIXED_ONE;
 
             if(plugin_state->gun_pos > GUN_TARGET_POS) {
                 // Right after fire
@@ -0,0 +1,148 @@
+#include "fixed.h"
+
+// sin() of the first quarter turn, FIXED_ANGLES / 4 + 1 entries
+static const fixed_t sin_table[FIXED_ANGLES / 4 + 1] = {
+    0, 402, 804, 1206, 1608, 2010, 2412, 2814,
+    3216, 3617, 4019, 4420, 4821, 5222, 5623, 6023,
+    6424, 6824, 7224, 7623, 8022, 8421, 8820, 9218,
+    9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391,
+    12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+    15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+    19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699,
+    22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708,
+    25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+    28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+    30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347,
+    33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+    36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716,
+    39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264,
+    41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+    44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056,
+    46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288,
+    48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+    50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398,
+    52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+    54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+    56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607,
+    57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071,
+    59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+    60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+    61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596,
+    62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+    63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197,
+    64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766,
+    64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+    65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436,
+    65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535,
+    65536,
+};
+
+// 2^39 / (256 + i), estimate of the reciprocal of a 9 bit normalized mantissa
+static const uint32_t recip_table[256] = {
+    2147483648, 2139127680, 2130836488, 2122609320, 2114445438, 2106344115,
+    2098304633, 2090326289, 2082408386, 2074550241, 2066751180, 2059010539,
+    2051327664, 2043701910, 2036132644, 2028619239, 2021161080, 2013757560,
+    2006408080, 1999112051, 1991868891, 1984678028, 1977538899, 1970450946,
+    1963413621, 1956426384, 1949488702, 1942600049, 1935759908, 1928967768,
+    1922223125, 1915525484, 1908874354, 1902269252, 1895709703, 1889195237,
+    1882725390, 1876299706, 1869917734, 1863579030, 1857283155, 1851029676,
+    1844818167, 1838648207, 1832519380, 1826431275, 1820383490, 1814375623,
+    1808407283, 1802478078, 1796587627, 1790735550, 1784921474, 1779145029,
+    1773405851, 1767703582, 1762037865, 1756408351, 1750814694, 1745256552,
+    1739733588, 1734245470, 1728791868, 1723372457, 1717986918, 1712634934,
+    1707316192, 1702030384, 1696777203, 1691556350, 1686367527, 1681210440,
+    1676084798, 1670990316, 1665926709, 1660893698, 1655891006, 1650918360,
+    1645975491, 1641062131, 1636178018, 1631322890, 1626496491, 1621698566,
+    1616928864, 1612187138, 1607473140, 1602786629, 1598127366, 1593495113,
+    1588889636, 1584310703, 1579758086, 1575231558, 1570730897, 1566255880,
+    1561806289, 1557381909, 1552982525, 1548607926, 1544257904, 1539932252,
+    1535630765, 1531353242, 1527099483, 1522869291, 1518662469, 1514478826,
+    1510318170, 1506180312, 1502065065, 1497972245, 1493901668, 1489853154,
+    1485826524, 1481821601, 1477838209, 1473876177, 1469935331, 1466015504,
+    1462116526, 1458238233, 1454380460, 1450543045, 1446725826, 1442928645,
+    1439151345, 1435393770, 1431655765, 1427937179, 1424237860, 1420557659,
+    1416896428, 1413254020, 1409630292, 1406025099, 1402438301, 1398869755,
+    1395319325, 1391786871, 1388272257, 1384775350, 1381296015, 1377834120,
+    1374389535, 1370962129, 1367551776, 1364158347, 1360781718, 1357421763,
+    1354078359, 1350751385, 1347440720, 1344146244, 1340867839, 1337605387,
+    1334358772, 1331127879, 1327912594, 1324712805, 1321528399, 1318359266,
+    1315205296, 1312066382, 1308942414, 1305833287, 1302738895, 1299659134,
+    1296593901, 1293543092, 1290506605, 1287484342, 1284476201, 1281482084,
+    1278501893, 1275535531, 1272582903, 1269643912, 1266718465, 1263806469,
+    1260907830, 1258022457, 1255150260, 1252291148, 1249445032, 1246611823,
+    1243791434, 1240983779, 1238188770, 1235406323, 1232636354, 1229878778,
+    1227133513, 1224400476, 1221679586, 1218970763, 1216273925, 1213588993,
+    1210915890, 1208254536, 1205604855, 1202966770, 1200340205, 1197725085,
+    1195121335, 1192528880, 1189947649, 1187377568, 1184818564, 1182270568,
+    1179733506, 1177207310, 1174691910, 1172187236, 1169693221, 1167209796,
+    1164736894, 1162274448, 1159822392, 1157380661, 1154949189, 1152527912,
+    1150116765, 1147715687, 1145324612, 1142943480, 1140572228, 1138210795,
+    1135859120, 1133517142, 1131184802, 1128862041, 1126548799, 1124245018,
+    1121950641, 1119665609, 1117389866, 1115123355, 1112866020, 1110617806,
+    1108378657, 1106148519, 1103927337, 1101715058, 1099511628, 1097316994,
+    1095131103, 1092953904, 1090785345, 1088625374, 1086473940, 1084330994,
+    1082196484, 1080070361, 1077952576, 1075843080,
+};
+
+fixed_t fixed_sin(uint16_t angle) {
+    angle &= FIXED_ANGLES - 1;
+    uint16_t quadrant = angle / (FIXED_ANGLES / 4);
+    uint16_t index = angle % (FIXED_ANGLES / 4);
+
+    switch(quadrant) {
+    case 0:
+        return sin_table[index];
+    case 1:
+        return sin_table[FIXED_ANGLES / 4 - index];
+    case 2:
+        return -sin_table[index];
+    default:
+        return -sin_table[FIXED_ANGLES / 4 - index];
+    }
+}
+
+fixed_t fixed_cos(uint16_t angle) {
+    return fixed_sin(angle + FIXED_ANGLES / 4);
+}
+
+// Table estimate refined with one Newton-Raphson step, r' = r + r * (1 - x * r)
+fixed_t fixed_recip(fixed_t value) {
+    bool negative = value < 0;
+    uint32_t x = negative ? -value : value;
+
+    if(x <= (FIXED_ONE >> 8)) {
+        // Below 1 / 256 of a unit the result is clamped, rays are never that steep
+        return negative ? -FIXED_RECIP_MAX : FIXED_RECIP_MAX;
+    }
+
+    uint32_t shift = 31 - __builtin_clz(x);
+    uint32_t mantissa = x >> (shift - 8);
+    uint32_t estimate = recip_table[mantissa - 256] >> (shift - 1);
+
+    int64_t error = ((int64_t)1 << 32) - (int64_t)x * estimate;
+    int64_t result = estimate + ((estimate * error) >> 32);
+
+    if(result > FIXED_RECIP_MAX) result = FIXED_RECIP_MAX;
+    return negative ? -result : result;
+}
+
+uint32_t isqrt(uint32_t value) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+
+    while(bit > value) {
+        bit >>= 2;
+    }
+
+    while(bit != 0) {
+        if(value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return result;
+}
@@ -0,0 +1,31 @@
+#ifndef _fixed_h
+#define _fixed_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 16.16 fixed point, used by the raycaster instead of the software emulated doubles
+typedef int32_t fixed_t;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define FIXED_RECIP_MAX (256 * FIXED_ONE)
+
+// Angles are expressed in 1 / FIXED_ANGLES of a full turn
+#define FIXED_ANGLES 1024
+
+#define fixed_from_int(a) ((fixed_t)(a) << FIXED_SHIFT)
+#define fixed_from_double(a) ((fixed_t)((a) * (double)FIXED_ONE))
+#define fixed_to_int(a) ((a) >> FIXED_SHIFT)
+#define fixed_frac(a) ((a) & (FIXED_ONE - 1))
+
+static inline fixed_t fixed_mul(fixed_t a, fixed_t b) {
+    return ((int64_t)a * b) >> FIXED_SHIFT;
+}
+
+fixed_t fixed_sin(uint16_t angle);
+fixed_t fixed_cos(uint16_t angle);
+fixed_t fixed_recip(fixed_t value);
+uint32_t isqrt(uint32_t value);
+
+#endif
@@ -0,0 +1,108 @@
+// Checks the fixed-point trig, reciprocal, square root and distance helpers
+// used by the raycaster against libm and compares their speed with doubles.
+//
+//   make -C doom/test run
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../fixed.h"
+#include "../types.h"
+
+#define BENCH_COUNT 10000000
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int check_trig(void) {
+    double max_error = 0;
+    for(uint32_t angle = 0; angle < 2 * FIXED_ANGLES; angle++) {
+        double turn = 2 * M_PI * angle / FIXED_ANGLES;
+        double error = fabs(fixed_sin(angle) - sin(turn) * FIXED_ONE);
+        error = fmax(error, fabs(fixed_cos(angle) - cos(turn) * FIXED_ONE));
+        max_error = fmax(max_error, error);
+    }
+    printf("sin/cos     max error %.2f / %d\n", max_error, FIXED_ONE);
+    return max_error > 1;
+}
+
+// within one unit plus 2^-16 of the result, large inputs lose bits to the 16.16 format
+static int check_recip(void) {
+    double max_error = 0;
+    fixed_t value = (FIXED_ONE >> 8) + 1;
+    for(; value < INT32_MAX - 97; value += value < (1 << 24) ? 1 : 97) {
+        double expected = (double)FIXED_ONE * FIXED_ONE / value;
+        if(expected > FIXED_RECIP_MAX) expected = FIXED_RECIP_MAX;
+        double bound = 1 + expected / FIXED_ONE;
+        double error = fabs(fixed_recip(value) - expected) / bound;
+        error = fmax(error, fabs(-fixed_recip(-value) - expected) / bound);
+        max_error = fmax(max_error, error);
+    }
+    if(fixed_recip(0) != FIXED_RECIP_MAX || fixed_recip(-1) != -FIXED_RECIP_MAX) {
+        printf("recip       not clamped near zero\n");
+        return 1;
+    }
+    printf("recip       max error %.2f of the bound\n", max_error);
+    return max_error > 1;
+}
+
+static int check_isqrt(void) {
+    for(uint64_t value = 0; value <= UINT32_MAX; value += value < 100000 ? 1 : value / 1000) {
+        uint32_t root = isqrt(value);
+        if((uint64_t)root * root > value || (uint64_t)(root + 1) * (root + 1) <= value) {
+            printf("isqrt       wrong for %llu\n", (unsigned long long)value);
+            return 1;
+        }
+    }
+    printf("isqrt       exact\n");
+    return 0;
+}
+
+static int check_distance(void) {
+    int max_error = 0;
+    srand(1);
+    for(int i = 0; i < 1000000; i++) {
+        Coords a = {rand() % 6400 / 100.0, rand() % 5700 / 100.0};
+        Coords b = {a.x + rand() % 1200 / 100.0 - 6, a.y + rand() % 1200 / 100.0 - 6};
+        double expected = sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y)) * 20;
+        if(expected >= 255) continue;
+        int error = abs((int)expected - coords_distance(&a, &b));
+        if(error > max_error) max_error = error;
+    }
+    printf("distance    max error %d\n", max_error);
+    return max_error > 1;
+}
+
+static void bench(void) {
+    volatile fixed_t fixed_sink = 0;
+    volatile double double_sink = 0;
+
+    double start = time_s();
+    for(int i = 0; i < BENCH_COUNT; i++) {
+        fixed_sink += fixed_mul(fixed_cos(i), fixed_recip(fixed_sin(i) | 1));
+    }
+    double fixed_s = time_s() - start;
+
+    start = time_s();
+    for(int i = 0; i < BENCH_COUNT; i++) {
+        double turn = 2 * M_PI * (i & (FIXED_ANGLES - 1)) / FIXED_ANGLES;
+        double_sink += cos(turn) / (sin(turn) + 1e-9);
+    }
+    double double_s = time_s() - start;
+
+    printf(
+        "cos/sin     fixed %.1f M/s, double %.1f M/s\n",
+        BENCH_COUNT / fixed_s / 1e6,
+        BENCH_COUNT / double_s / 1e6);
+}
+
+int main(void) {
+    int failed = check_trig() + check_recip() + check_isqrt() + check_distance();
+    bench();
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
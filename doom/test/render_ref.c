@@ -0,0 +1,107 @@
+// The double precision raycaster renderMap() replaced, kept to compare the fixed-point one with.
+// Included by render_test.c after doom.c.
+
+// The map raycaster. Based on https://lodev.org/cgtutor/raycasting.html
+void renderMapDouble(
+    const uint8_t level[],
+    double view_height,
+    Canvas* const canvas,
+    PluginState* const plugin_state) {
+    UID last_uid = 0; // NOT SURE ?
+
+    for(uint8_t x = 0; x < SCREEN_WIDTH; x += RES_DIVIDER) {
+        double camera_x = 2 * (double)x / SCREEN_WIDTH - 1;
+        double ray_x = plugin_state->player.dir.x + plugin_state->player.plane.x * camera_x;
+        double ray_y = plugin_state->player.dir.y + plugin_state->player.plane.y * camera_x;
+        uint8_t map_x = (uint8_t)plugin_state->player.pos.x;
+        uint8_t map_y = (uint8_t)plugin_state->player.pos.y;
+        Coords map_coords = {plugin_state->player.pos.x, plugin_state->player.pos.y};
+        double delta_x = fabs(1 / ray_x);
+        double delta_y = fabs(1 / ray_y);
+
+        int8_t step_x;
+        int8_t step_y;
+        double side_x;
+        double side_y;
+
+        if(ray_x < 0) {
+            step_x = -1;
+            side_x = (plugin_state->player.pos.x - map_x) * delta_x;
+        } else {
+            step_x = 1;
+            side_x = (map_x + (double)1.0 - plugin_state->player.pos.x) * delta_x;
+        }
+
+        if(ray_y < 0) {
+            step_y = -1;
+            side_y = (plugin_state->player.pos.y - map_y) * delta_y;
+        } else {
+            step_y = 1;
+            side_y = (map_y + (double)1.0 - plugin_state->player.pos.y) * delta_y;
+        }
+
+        // Wall detection
+        uint8_t depth = 0;
+        bool hit = 0;
+        bool side;
+        while(!hit && depth < MAX_RENDER_DEPTH) {
+            if(side_x < side_y) {
+                side_x += delta_x;
+                map_x += step_x;
+                side = 0;
+            } else {
+                side_y += delta_y;
+                map_y += step_y;
+                side = 1;
+            }
+
+            uint8_t block = getBlockAt(level, map_x, map_y);
+
+            if(block == E_WALL) {
+                hit = 1;
+            } else {
+                // Spawning entities here, as soon they are visible for the
+                // player. Not the best place, but would be a very performance
+                // cost scan for them in another loop
+                if(block == E_ENEMY || (block & 0b00001000) /* all collectable items */) {
+                    // Check that it's close to the player
+                    if(coords_distance(&(plugin_state->player.pos), &map_coords) <
+                       MAX_ENTITY_DISTANCE) {
+                        UID uid = create_uid(block, map_x, map_y);
+                        if(last_uid != uid && !isSpawned(uid, plugin_state)) {
+                            spawnEntity(block, map_x, map_y, plugin_state);
+                            last_uid = uid;
+                        }
+                    }
+                }
+            }
+
+            depth++;
+        }
+
+        if(hit) {
+            double distance;
+
+            if(side == 0) {
+                distance =
+                    fmax(1, (map_x - plugin_state->player.pos.x + (1 - step_x) / 2) / ray_x);
+            } else {
+                distance =
+                    fmax(1, (map_y - plugin_state->player.pos.y + (1 - step_y) / 2) / ray_y);
+            }
+
+            // store zbuffer value for the column
+            zbuffer[x / Z_RES_DIVIDER] = fmin(distance * DISTANCE_MULTIPLIER, 255);
+
+            // rendered line height
+            uint8_t line_height = RENDER_HEIGHT / distance;
+
+            drawVLine(
+                x,
+                view_height / distance - line_height / 2 + RENDER_HEIGHT / 2,
+                view_height / distance + line_height / 2 + RENDER_HEIGHT / 2,
+                GRADIENT_COUNT - (int)distance / MAX_RENDER_DEPTH * GRADIENT_COUNT - side * 2,
+                canvas);
+        }
+    }
+}
@@ -0,0 +1,276 @@
+// Walks the player along scripted camera paths through doom_game_tick() and renders every
+// frame with the fixed-point renderMap() and the double renderMapDouble() it replaced
+// (render_ref.c), from the same state onto cleared screens. Compares every column's wall line
+// and zbuffer value and the entities the raycaster spawns, and the time both take per frame.
+// Columns may only land on another wall where the ray is ill-conditioned: it passes a grid
+// corner or runs along a wall closer than 16.16 can tell apart.
+//
+//   make -C doom/test run
+
+#include <time.h>
+
+#include "../doom.c"
+#include "render_ref.c"
+#include "host_doom.h"
+
+#define FRAME_TICKS 67 // FRAME_TIME
+#define RANDOM_FRAMES 20000
+#define BENCH_FRAMES 20000
+
+// Lines end one pixel apart where the two land on either side of a rounding boundary
+#define MAX_COLUMN_END_DIFF 1
+#define MAX_ZBUFFER_DIFF 1
+// in cells along the ray, and of a ray component
+#define ILL_CONDITIONED 1e-3
+
+typedef struct {
+    const char* name;
+    uint32_t frames;
+    uint32_t frames_differing;
+    uint32_t pixels;
+    uint32_t columns_off_by_one;
+    uint32_t columns_ill_conditioned;
+    uint32_t columns_wrong;
+    uint32_t spawn_mismatches;
+} Path;
+
+static PluginState state;
+static uint8_t screen_double[HOST_SCREEN_HEIGHT][HOST_SCREEN_WIDTH];
+static uint8_t zbuffer_double[sizeof(zbuffer)];
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void start(void) {
+    memset(&state, 0, sizeof(state));
+    initializeLevel(sto_level_1, &state);
+    state.scene = GAME_PLAY;
+    host_tick = 0;
+}
+
+static void keys(bool up, bool down, bool left, bool right) {
+    state.up = up;
+    state.down = down;
+    state.left = left;
+    state.right = right;
+}
+
+// first and one past the last lit row of a column, 0 and 0 if it is empty
+static void column_ends(uint8_t screen[][HOST_SCREEN_WIDTH], uint8_t x, int* top, int* bottom) {
+    *top = 0;
+    *bottom = 0;
+    for(int y = 0; y < HOST_SCREEN_HEIGHT; y++) {
+        if(!screen[y][x]) continue;
+        if(*bottom == 0) *top = y;
+        *bottom = y + 1;
+    }
+}
+
+// How close the column's ray comes to a grid corner on its way to the wall, or to running
+// parallel to an axis, replaying the double renderer's steps
+static double ray_margin(const PluginState* state, uint8_t x) {
+    double camera_x = 2 * (double)x / SCREEN_WIDTH - 1;
+    double ray_x = state->player.dir.x + state->player.plane.x * camera_x;
+    double ray_y = state->player.dir.y + state->player.plane.y * camera_x;
+    uint8_t map_x = state->player.pos.x;
+    uint8_t map_y = state->player.pos.y;
+    double delta_x = fabs(1 / ray_x);
+    double delta_y = fabs(1 / ray_y);
+    double side_x = (ray_x < 0 ? state->player.pos.x - map_x : map_x + 1 - state->player.pos.x) *
+                    delta_x;
+    double side_y = (ray_y < 0 ? state->player.pos.y - map_y : map_y + 1 - state->player.pos.y) *
+                    delta_y;
+
+    double margin = fmin(fabs(ray_x), fabs(ray_y));
+    for(uint8_t depth = 0; depth < MAX_RENDER_DEPTH; depth++) {
+        margin = fmin(margin, fabs(side_x - side_y));
+        if(side_x < side_y) {
+            side_x += delta_x;
+            map_x += ray_x < 0 ? -1 : 1;
+        } else {
+            side_y += delta_y;
+            map_y += ray_y < 0 ? -1 : 1;
+        }
+        if(getBlockAt(sto_level_1, map_x, map_y) == E_WALL) break;
+    }
+    return margin;
+}
+
+static bool same_spawns(const PluginState* a, const PluginState* b) {
+    if(a->num_entities != b->num_entities) return false;
+    for(uint8_t i = 0; i < a->num_entities; i++) {
+        if(a->entity[i].uid != b->entity[i].uid) return false;
+    }
+    return true;
+}
+
+static void frame(Path* path) {
+    host_tick += FRAME_TICKS;
+    doom_game_tick(&state);
+
+    PluginState double_state = state;
+    memset(zbuffer, 0, sizeof(zbuffer));
+    renderMapDouble(sto_level_1, double_state.view_height, host_canvas(), &double_state);
+    memcpy(screen_double, host_screen, sizeof(screen_double));
+    memcpy(zbuffer_double, zbuffer, sizeof(zbuffer_double));
+
+    memset(zbuffer, 0, sizeof(zbuffer));
+    renderMap(sto_level_1, state.view_height, host_canvas(), &state);
+
+    uint32_t pixels = 0;
+    for(int y = 0; y < HOST_SCREEN_HEIGHT; y++) {
+        for(int x = 0; x < HOST_SCREEN_WIDTH; x++) {
+            pixels += host_screen[y][x] != screen_double[y][x];
+        }
+    }
+    for(uint8_t x = 0; x < SCREEN_WIDTH; x += RES_DIVIDER) {
+        int top, bottom, top_double, bottom_double;
+        column_ends(host_screen, x, &top, &bottom);
+        column_ends(screen_double, x, &top_double, &bottom_double);
+        int ends = abs(top - top_double);
+        if(abs(bottom - bottom_double) > ends) ends = abs(bottom - bottom_double);
+        int z = abs(zbuffer[x / Z_RES_DIVIDER] - zbuffer_double[x / Z_RES_DIVIDER]);
+
+        if(ends <= MAX_COLUMN_END_DIFF && z <= MAX_ZBUFFER_DIFF) {
+            if(ends || z) path->columns_off_by_one++;
+        } else if(ray_margin(&state, x) < ILL_CONDITIONED) {
+            path->columns_ill_conditioned++;
+        } else {
+            printf(
+                "%s frame %u column %u: fixed rows %d-%d z %u, double rows %d-%d z %u\n",
+                path->name,
+                path->frames,
+                x,
+                top,
+                bottom,
+                zbuffer[x / Z_RES_DIVIDER],
+                top_double,
+                bottom_double,
+                zbuffer_double[x / Z_RES_DIVIDER]);
+            path->columns_wrong++;
+        }
+    }
+    if(!same_spawns(&state, &double_state)) path->spawn_mismatches++;
+
+    path->frames++;
+    path->pixels += pixels;
+    if(pixels) path->frames_differing++;
+}
+
+static void frames(Path* path, uint32_t count) {
+    for(uint32_t i = 0; i < count; i++) {
+        frame(path);
+    }
+}
+
+// a full turn on the spot in both directions
+static void path_turn(Path* path) {
+    start();
+    keys(false, false, false, true);
+    frames(path, 60);
+    keys(false, false, true, false);
+    frames(path, 60);
+}
+
+// down the corridors of the level, turning at the walls it runs into
+static void path_corridors(Path* path) {
+    start();
+    for(int leg = 0; leg < 24; leg++) {
+        keys(true, false, false, false);
+        Coords last = state.player.pos;
+        for(int i = 0; i < 120; i++) {
+            frame(path);
+            if(state.player.pos.x == last.x && state.player.pos.y == last.y) break;
+            last = state.player.pos;
+        }
+        keys(false, false, leg % 3 == 2, leg % 3 != 2);
+        frames(path, 13); // about a quarter turn
+    }
+}
+
+// pressed against a wall at close range, looking along it and backing off
+static void path_wall(Path* path) {
+    start();
+    keys(true, false, false, false);
+    frames(path, 150);
+    keys(true, false, false, true);
+    frames(path, 30);
+    keys(false, true, true, false);
+    frames(path, 30);
+    keys(false, false, false, false);
+    frames(path, 20);
+}
+
+// held keys changing every few frames
+static void path_random(Path* path) {
+    start();
+    srand(1);
+    for(uint32_t i = 0; i < RANDOM_FRAMES; i += 8) {
+        int r = rand();
+        keys(r & 1, (r & 6) == 6, (r & 24) == 8, (r & 24) == 16);
+        frames(path, 8);
+    }
+}
+
+static int report(const Path* path) {
+    printf(
+        "%-10s %6u %7u %6.2f %8u %8u %6u %6u\n",
+        path->name,
+        path->frames,
+        path->frames_differing,
+        (double)path->pixels / path->frames,
+        path->columns_off_by_one,
+        path->columns_ill_conditioned,
+        path->columns_wrong,
+        path->spawn_mismatches);
+    return path->columns_wrong || path->spawn_mismatches;
+}
+
+// The host has a double FPU, the Flipper emulates doubles in software
+static void bench(void) {
+    start();
+    Canvas* canvas = host_canvas();
+
+    double begin = time_s();
+    for(int i = 0; i < BENCH_FRAMES; i++) {
+        renderMapDouble(sto_level_1, 1.5, canvas, &state);
+    }
+    double double_s = time_s() - begin;
+
+    begin = time_s();
+    for(int i = 0; i < BENCH_FRAMES; i++) {
+        renderMap(sto_level_1, 1.5, canvas, &state);
+    }
+    double fixed_s = time_s() - begin;
+
+    printf(
+        "renderMap  fixed %.1f us/frame, double %.1f us/frame on the host\n",
+        fixed_s / BENCH_FRAMES * 1e6,
+        double_s / BENCH_FRAMES * 1e6);
+}
+
+int main(void) {
+    Path paths[] = {{.name = "turn"}, {.name = "corridors"}, {.name = "wall"}, {.name = "random"}};
+    void (*scripts[])(Path*) = {path_turn, path_corridors, path_wall, path_random};
+
+    printf(
+        "%-10s %6s %7s %6s %8s %8s %6s %6s\n",
+        "path",
+        "frames",
+        "differ",
+        "px/fr",
+        "1 px off",
+        "ill-cond",
+        "wrong",
+        "spawns");
+    int failed = 0;
+    for(size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        scripts[i](&paths[i]);
+        failed += report(&paths[i]);
+    }
+    bench();
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+typedef enum {
+    DolphinDeedPluginGameStart,
+} DolphinDeed;
+
+static inline void dolphin_deed(DolphinDeed deed) {
+    (void)deed;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <gui/icon.h>
+
+static const Icon I_logo_inv = {128, 64};
+static const Icon I_gun_inv = {32, 32};
+static const Icon I_gun_mask_inv = {32, 32};
+static const Icon I_fire_inv = {24, 20};
+static const Icon I_gradient_inv = {8, 8};
@@ -0,0 +1,126 @@
+#pragma once
+
+// Just enough of the Furi API to build doom.c on the host, see host_doom.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+
+#define furi_assert(x) (void)(x)
+#define furi_check(x)     \
+    do {                  \
+        if(!(x)) abort(); \
+    } while(0)
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+// Simulated, the test advances it
+extern uint32_t host_tick;
+
+static inline uint32_t furi_get_tick(void) {
+    return host_tick;
+}
+
+static inline uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+#define RECORD_GUI "gui"
+#define RECORD_NOTIFICATION "notification"
+
+static inline void* furi_record_open(const char* name) {
+    UNUSED(name);
+    return NULL;
+}
+
+static inline void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// The game runs on the test's thread. The app keeps the music mutex in a FuriMutex**,
+// hence void pointers.
+
+typedef struct FuriMutex FuriMutex;
+
+typedef enum {
+    FuriMutexTypeNormal,
+} FuriMutexType;
+
+static inline void* furi_mutex_alloc(FuriMutexType type) {
+    UNUSED(type);
+    return NULL;
+}
+
+static inline void furi_mutex_free(void* mutex) {
+    UNUSED(mutex);
+}
+
+static inline FuriStatus furi_mutex_acquire(void* mutex, uint32_t timeout) {
+    UNUSED(mutex);
+    UNUSED(timeout);
+    return FuriStatusOk;
+}
+
+static inline FuriStatus furi_mutex_release(void* mutex) {
+    UNUSED(mutex);
+    return FuriStatusOk;
+}
+
+// doom_app() is built but never runs
+
+typedef struct FuriMessageQueue FuriMessageQueue;
+
+static inline FuriMessageQueue* furi_message_queue_alloc(uint32_t count, uint32_t size) {
+    UNUSED(count);
+    UNUSED(size);
+    return NULL;
+}
+
+static inline void furi_message_queue_free(FuriMessageQueue* queue) {
+    UNUSED(queue);
+}
+
+static inline FuriStatus
+    furi_message_queue_put(FuriMessageQueue* queue, const void* message, uint32_t timeout) {
+    UNUSED(queue);
+    UNUSED(message);
+    UNUSED(timeout);
+    return FuriStatusOk;
+}
+
+static inline FuriStatus
+    furi_message_queue_get(FuriMessageQueue* queue, void* message, uint32_t timeout) {
+    UNUSED(queue);
+    UNUSED(message);
+    UNUSED(timeout);
+    return FuriStatusErrorTimeout;
+}
+
+typedef struct FuriTimer FuriTimer;
+
+typedef enum {
+    FuriTimerTypePeriodic,
+} FuriTimerType;
+
+#define furi_timer_alloc(cb, type, ctx) ((void)(cb), (void)(type), (void)(ctx), (FuriTimer*)NULL)
+
+static inline void furi_timer_start(FuriTimer* timer, uint32_t ticks) {
+    UNUSED(timer);
+    UNUSED(ticks);
+}
+
+static inline void furi_timer_free(FuriTimer* timer) {
+    UNUSED(timer);
+}
+
+#define FURI_LOG_E(tag, format, ...) printf("[%s] " format "\n", tag, ##__VA_ARGS__)
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <furi.h>
+
+static inline bool furi_hal_speaker_start(float frequency, float volume) {
+    UNUSED(frequency);
+    UNUSED(volume);
+    return true;
+}
+
+static inline void furi_hal_speaker_stop(void) {
+}
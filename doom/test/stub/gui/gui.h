@@ -0,0 +1,59 @@
+#pragma once
+
+// The canvas draws into host_screen (host_doom.c), one byte per pixel
+
+#include <furi.h>
+#include <gui/icon.h>
+#include <input/input.h>
+
+typedef struct Gui Gui;
+typedef struct Canvas Canvas;
+typedef struct ViewPort ViewPort;
+
+typedef enum {
+    FontPrimary,
+} Font;
+
+typedef enum {
+    GuiLayerFullscreen,
+} GuiLayer;
+
+void canvas_draw_dot(Canvas* canvas, int32_t x, int32_t y);
+void canvas_invert_color(Canvas* canvas);
+void canvas_draw_icon(Canvas* canvas, int32_t x, int32_t y, const Icon* icon);
+
+static inline void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    UNUSED(font);
+}
+
+static inline ViewPort* view_port_alloc(void) {
+    return NULL;
+}
+
+static inline void view_port_free(ViewPort* view_port) {
+    UNUSED(view_port);
+}
+
+static inline void view_port_update(ViewPort* view_port) {
+    UNUSED(view_port);
+}
+
+static inline void view_port_enabled_set(ViewPort* view_port, bool enabled) {
+    UNUSED(view_port);
+    UNUSED(enabled);
+}
+
+#define view_port_draw_callback_set(vp, cb, ctx) ((void)(vp), (void)(cb), (void)(ctx))
+#define view_port_input_callback_set(vp, cb, ctx) ((void)(vp), (void)(cb), (void)(ctx))
+
+static inline void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer) {
+    UNUSED(gui);
+    UNUSED(view_port);
+    UNUSED(layer);
+}
+
+static inline void gui_remove_view_port(Gui* gui, ViewPort* view_port) {
+    UNUSED(gui);
+    UNUSED(view_port);
+}
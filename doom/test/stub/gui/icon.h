@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t width;
+    uint8_t height;
+} Icon;
@@ -0,0 +1,70 @@
+#include <furi.h>
+#include <gui/gui.h>
+
+#include "../../doom_music_player_worker.h"
+#include "host_doom.h"
+
+uint32_t host_tick;
+uint8_t host_screen[HOST_SCREEN_HEIGHT][HOST_SCREEN_WIDTH];
+uint32_t host_clipped_dots;
+
+struct Canvas {
+    bool inverted;
+};
+
+static Canvas canvas;
+
+Canvas* host_canvas(void) {
+    canvas.inverted = false;
+    memset(host_screen, 0, sizeof(host_screen));
+    host_clipped_dots = 0;
+    return &canvas;
+}
+
+void canvas_draw_dot(Canvas* canvas, int32_t x, int32_t y) {
+    if(x < 0 || y < 0 || x >= HOST_SCREEN_WIDTH || y >= HOST_SCREEN_HEIGHT) {
+        host_clipped_dots++;
+        return;
+    }
+    host_screen[y][x] = !canvas->inverted;
+}
+
+void canvas_invert_color(Canvas* canvas) {
+    canvas->inverted = !canvas->inverted;
+}
+
+void canvas_draw_icon(Canvas* canvas, int32_t x, int32_t y, const Icon* icon) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(icon);
+}
+
+// No sound on the host
+
+MusicPlayerWorker* music_player_worker_alloc() {
+    return NULL;
+}
+
+void music_player_worker_free(MusicPlayerWorker* instance) {
+    UNUSED(instance);
+}
+
+bool music_player_worker_load_rtttl_from_string(MusicPlayerWorker* instance, const char* string) {
+    UNUSED(instance);
+    UNUSED(string);
+    return true;
+}
+
+void music_player_worker_set_volume(MusicPlayerWorker* instance, float volume) {
+    UNUSED(instance);
+    UNUSED(volume);
+}
+
+void music_player_worker_start(MusicPlayerWorker* instance) {
+    UNUSED(instance);
+}
+
+void music_player_worker_stop(MusicPlayerWorker* instance) {
+    UNUSED(instance);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <gui/gui.h>
+
+#define HOST_SCREEN_WIDTH 128
+#define HOST_SCREEN_HEIGHT 64
+
+extern uint32_t host_tick;
+extern uint8_t host_screen[HOST_SCREEN_HEIGHT][HOST_SCREEN_WIDTH];
+extern uint32_t host_clipped_dots;
+
+// Clears the screen and returns a canvas drawing into it
+Canvas* host_canvas(void);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <furi.h>
+
+typedef struct NotificationApp NotificationApp;
+
+typedef struct {
+    uint8_t type;
+} NotificationMessage;
+
+typedef const NotificationMessage* NotificationSequence[];
+
+static inline void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    UNUSED(app);
+    UNUSED(sequence);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <notification/notification.h>
+
+static const NotificationMessage message_note_c3 = {0};
+static const NotificationMessage message_note_c5 = {0};
+static const NotificationMessage message_delay_50 = {0};
+static const NotificationMessage message_delay_100 = {0};
+static const NotificationMessage message_sound_off = {0};
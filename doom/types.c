@@ -1,14 +1,11 @@
 #include "types.h"
+#include "fixed.h"
 
 /*template <class T>
 inline T sq(T value) {
     return value * value;
 }*/
 
-double sq(double val) {
-    return val * val;
-}
-
 //extern "C"
 Coords create_coords(double x, double y) {
     Coords cord;
@@ -17,9 +14,18 @@ Coords create_coords(double x, double y) {
     return cord;
 }
 
+// Squared distance in DISTANCE_MULTIPLIER units, enough for ordering and range checks.
+// Deltas are taken with 4 extra bits so the result stays within one unit of sqrt().
+uint32_t coords_distance_sq(Coords* a, Coords* b) {
+    int32_t dx = (float)(a->x - b->x) * (20 * 16);
+    int32_t dy = (float)(a->y - b->y) * (20 * 16);
+    return ((uint32_t)(dx * dx) + (uint32_t)(dy * dy)) >> 8;
+}
+
 //extern "C"
 uint8_t coords_distance(Coords* a, Coords* b) {
-    return sqrt(sq(a->x - b->x) + sq(a->y - b->y)) * 20;
+    uint32_t distance = isqrt(coords_distance_sq(a, b));
+    return distance > 255 ? 255 : distance;
 }
 
 //extern "C"
@@ -1,10 +1,13 @@
 #include "esp_flasher_worker.h"
+#include <esp_deflate.h>
+#include "lib/esp-serial-flasher/private_include/md5_hash.h"
 
 FuriStreamBuffer* flash_rx_stream; // TODO make safe
 EspFlasherApp* global_app; // TODO make safe
 FuriTimer* timer; // TODO make
 
 static uint32_t _remaining_time = 0;
+static uint32_t _bytes_sent = 0;
 static void _timer_callback(void* context) {
     UNUSED(context);
     if(_remaining_time > 0) {
@@ -12,29 +15,18 @@ static void _timer_callback(void* context) {
     }
 }
 
-static esp_loader_error_t _flash_file(EspFlasherApp* app, char* filepath, uint32_t addr) {
-    // TODO cleanup
-    esp_loader_error_t err;
-    static uint8_t payload[1024];
-    File* bin_file = storage_file_alloc(app->storage);
+#define FLASH_BLOCK_SIZE (1024)
+#define FLASH_REGION_SIZE (64 * 1024)
+#define FLASH_PIPE_BUFFERS (2)
 
+static esp_loader_error_t _flash_file_raw(File* bin_file, uint64_t size, uint32_t addr) {
+    esp_loader_error_t err;
+    static uint8_t payload[FLASH_BLOCK_SIZE];
     char user_msg[256];
 
-    // open file
-    if(!storage_file_open(bin_file, filepath, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        storage_file_close(bin_file);
-        storage_file_free(bin_file);
-        dialog_message_show_storage_error(app->dialogs, "Cannot open file");
-        return ESP_LOADER_ERROR_FAIL;
-    }
-
-    uint64_t size = storage_file_size(bin_file);
-
     loader_port_debug_print("Erasing flash...this may take a while\n");
     err = esp_loader_flash_start(addr, size, sizeof(payload));
     if(err != ESP_LOADER_SUCCESS) {
-        storage_file_close(bin_file);
-        storage_file_free(bin_file);
         snprintf(user_msg, sizeof(user_msg), "Erasing flash failed with error %d\n", err);
         loader_port_debug_print(user_msg);
         return err;
@@ -55,8 +47,6 @@ static esp_loader_error_t _flash_file(EspFlasherApp* app, char* filepath, uint32
         err = esp_loader_flash_write(payload, num_bytes);
         if(err != ESP_LOADER_SUCCESS) {
             snprintf(user_msg, sizeof(user_msg), "Packet could not be written! Error: %u\n", err);
-            storage_file_close(bin_file);
-            storage_file_free(bin_file);
             loader_port_debug_print(user_msg);
             return err;
         }
@@ -64,14 +54,268 @@ static esp_loader_error_t _flash_file(EspFlasherApp* app, char* filepath, uint32
         size -= num_bytes;
     }
 
+    // no MD5 command in the ESP8266 ROM, so nothing to verify against
     loader_port_debug_print("Finished programming\n");
+    return ESP_LOADER_SUCCESS;
+}
 
-    // TODO verify
+typedef struct {
+    File* file;
+    esp_deflate_t deflate;
+    struct MD5Context md5;
+    uint8_t chunk[ESP_DEFLATE_WINDOW_SIZE];
+    uint8_t compressed[ESP_DEFLATE_BOUND(ESP_DEFLATE_WINDOW_SIZE)];
+} FlashCompressor;
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+} FlashPacket;
+
+// Reads and compresses a region on its own thread while the worker waits for the target
+typedef struct {
+    FlashCompressor* compressor;
+    uint32_t size;
+    volatile bool failed;
+    FuriThread* thread;
+    FuriMessageQueue* free_queue;
+    FuriMessageQueue* full_queue;
+    uint8_t buffers[FLASH_PIPE_BUFFERS][FLASH_BLOCK_SIZE];
+} FlashPipe;
+
+// single read pass gives both the MD5 of the region and the size of its zlib stream
+static bool _scan_region(
+    FlashCompressor* compressor,
+    uint32_t size,
+    uint8_t digest[16],
+    uint32_t* compressed_size) {
+    esp_deflate_init(&compressor->deflate);
+    MD5Init(&compressor->md5);
+    *compressed_size = 0;
+
+    for(uint32_t offset = 0; offset < size;) {
+        uint32_t chunk = MIN(size - offset, (uint32_t)ESP_DEFLATE_WINDOW_SIZE);
+        if(storage_file_read(compressor->file, compressor->chunk, chunk) != chunk) {
+            return false;
+        }
+        offset += chunk;
+        MD5Update(&compressor->md5, compressor->chunk, chunk);
+        *compressed_size += esp_deflate_compress(
+            &compressor->deflate,
+            compressor->chunk,
+            chunk,
+            offset == size,
+            compressor->compressed);
+    }
+
+    MD5Final(digest, &compressor->md5);
+    return true;
+}
+
+static int32_t _flash_pipe_thread(void* context) {
+    FlashPipe* pipe = context;
+    FlashCompressor* compressor = pipe->compressor;
+    FlashPacket packet = {.data = NULL, .size = 0};
+
+    esp_deflate_init(&compressor->deflate);
+    for(uint32_t offset = 0; offset < pipe->size && !pipe->failed;) {
+        uint32_t chunk = MIN(pipe->size - offset, (uint32_t)ESP_DEFLATE_WINDOW_SIZE);
+        if(storage_file_read(compressor->file, compressor->chunk, chunk) != chunk) {
+            pipe->failed = true;
+            break;
+        }
+        offset += chunk;
+        size_t produced = esp_deflate_compress(
+            &compressor->deflate,
+            compressor->chunk,
+            chunk,
+            offset == pipe->size,
+            compressor->compressed);
+
+        for(size_t pos = 0; pos < produced;) {
+            if(!packet.data) {
+                furi_check(
+                    furi_message_queue_get(pipe->free_queue, &packet, FuriWaitForever) ==
+                    FuriStatusOk);
+                packet.size = 0;
+            }
+            size_t to_copy = MIN(produced - pos, FLASH_BLOCK_SIZE - packet.size);
+            memcpy(&packet.data[packet.size], &compressor->compressed[pos], to_copy);
+            packet.size += to_copy;
+            pos += to_copy;
+            if(packet.size == FLASH_BLOCK_SIZE) {
+                furi_message_queue_put(pipe->full_queue, &packet, FuriWaitForever);
+                packet.data = NULL;
+            }
+        }
+    }
+
+    if(packet.data) {
+        furi_message_queue_put(pipe->full_queue, &packet, FuriWaitForever);
+    }
+    // end of stream
+    packet.data = NULL;
+    furi_message_queue_put(pipe->full_queue, &packet, FuriWaitForever);
+    return 0;
+}
+
+static esp_loader_error_t _flash_region_compressed(
+    FlashCompressor* compressor,
+    uint32_t addr,
+    uint32_t size,
+    uint32_t compressed_size) {
+    esp_loader_error_t err =
+        esp_loader_flash_deflate_start(addr, size, compressed_size, FLASH_BLOCK_SIZE);
+    if(err != ESP_LOADER_SUCCESS) {
+        return err;
+    }
+
+    FlashPipe* pipe = malloc(sizeof(FlashPipe));
+    pipe->compressor = compressor;
+    pipe->size = size;
+    pipe->failed = false;
+    // one extra slot for the end of stream packet
+    pipe->free_queue = furi_message_queue_alloc(FLASH_PIPE_BUFFERS + 1, sizeof(FlashPacket));
+    pipe->full_queue = furi_message_queue_alloc(FLASH_PIPE_BUFFERS + 1, sizeof(FlashPacket));
+    for(size_t i = 0; i < FLASH_PIPE_BUFFERS; i++) {
+        FlashPacket packet = {.data = pipe->buffers[i], .size = 0};
+        furi_message_queue_put(pipe->free_queue, &packet, FuriWaitForever);
+    }
+    pipe->thread = furi_thread_alloc();
+    furi_thread_set_name(pipe->thread, "EspFlasherDeflate");
+    furi_thread_set_stack_size(pipe->thread, 2048);
+    furi_thread_set_context(pipe->thread, pipe);
+    furi_thread_set_callback(pipe->thread, _flash_pipe_thread);
+    furi_thread_start(pipe->thread);
+
+    FlashPacket packet;
+    while(true) {
+        furi_check(
+            furi_message_queue_get(pipe->full_queue, &packet, FuriWaitForever) == FuriStatusOk);
+        if(!packet.data) break;
+        if(err == ESP_LOADER_SUCCESS) {
+            err = esp_loader_flash_deflate_write(packet.data, packet.size);
+            // stop the producer, remaining packets are only drained
+            if(err != ESP_LOADER_SUCCESS) pipe->failed = true;
+        }
+        furi_message_queue_put(pipe->free_queue, &packet, FuriWaitForever);
+    }
+
+    furi_thread_join(pipe->thread);
+    furi_thread_free(pipe->thread);
+    furi_message_queue_free(pipe->free_queue);
+    furi_message_queue_free(pipe->full_queue);
+    if(err == ESP_LOADER_SUCCESS && pipe->failed) {
+        loader_port_debug_print("Cannot read file\n");
+        err = ESP_LOADER_ERROR_FAIL;
+    }
+    free(pipe);
+
+    return err;
+}
+
+static esp_loader_error_t _flash_file_compressed(File* bin_file, uint32_t size, uint32_t addr) {
+    esp_loader_error_t err = ESP_LOADER_SUCCESS;
+    char user_msg[256];
+    uint32_t skipped = 0;
+
+    FlashCompressor* compressor = malloc(sizeof(FlashCompressor));
+    compressor->file = bin_file;
+
+    loader_port_debug_print("Start programming\n");
+    for(uint32_t offset = 0; offset < size; offset += FLASH_REGION_SIZE) {
+        uint32_t region_size = MIN(size - offset, (uint32_t)FLASH_REGION_SIZE);
+        uint32_t compressed_size;
+        uint8_t digest[16];
+
+        if(!storage_file_seek(bin_file, offset, true) ||
+           !_scan_region(compressor, region_size, digest, &compressed_size)) {
+            loader_port_debug_print("Cannot read file\n");
+            err = ESP_LOADER_ERROR_FAIL;
+            break;
+        }
+
+        // region already holds the image
+        err = esp_loader_flash_verify_known_md5(addr + offset, region_size, digest);
+        if(err == ESP_LOADER_SUCCESS) {
+            skipped += region_size;
+            continue;
+        } else if(err != ESP_LOADER_ERROR_INVALID_MD5) {
+            snprintf(user_msg, sizeof(user_msg), "Reading MD5 failed with error %d\n", err);
+            loader_port_debug_print(user_msg);
+            break;
+        }
+
+        snprintf(
+            user_msg,
+            sizeof(user_msg),
+            "Writing 0x%lx (%lu bytes, %lu compressed)\n",
+            addr + offset,
+            region_size,
+            compressed_size);
+        loader_port_debug_print(user_msg);
+
+        storage_file_seek(bin_file, offset, true);
+        err = _flash_region_compressed(compressor, addr + offset, region_size, compressed_size);
+        if(err != ESP_LOADER_SUCCESS) {
+            snprintf(user_msg, sizeof(user_msg), "Packet could not be written! Error: %u\n", err);
+            loader_port_debug_print(user_msg);
+            break;
+        }
+
+        err = esp_loader_flash_verify_known_md5(addr + offset, region_size, digest);
+        if(err != ESP_LOADER_SUCCESS) {
+            snprintf(
+                user_msg,
+                sizeof(user_msg),
+                "Verify failed at 0x%lx, error %d\n",
+                addr + offset,
+                err);
+            loader_port_debug_print(user_msg);
+            break;
+        }
+    }
+
+    free(compressor);
+
+    if(err == ESP_LOADER_SUCCESS) {
+        snprintf(
+            user_msg,
+            sizeof(user_msg),
+            "Finished programming, %lu of %lu bytes were unchanged\n",
+            skipped,
+            size);
+        loader_port_debug_print(user_msg);
+    }
+
+    return err;
+}
+
+static esp_loader_error_t _flash_file(EspFlasherApp* app, char* filepath, uint32_t addr) {
+    esp_loader_error_t err;
+    File* bin_file = storage_file_alloc(app->storage);
+
+    // open file
+    if(!storage_file_open(bin_file, filepath, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        storage_file_close(bin_file);
+        storage_file_free(bin_file);
+        dialog_message_show_storage_error(app->dialogs, "Cannot open file");
+        return ESP_LOADER_ERROR_FAIL;
+    }
+
+    uint64_t size = storage_file_size(bin_file);
+
+    // ESP8266 ROM has neither compressed writes nor MD5
+    if(esp_loader_get_target() == ESP8266_CHIP) {
+        err = _flash_file_raw(bin_file, size, addr);
+    } else {
+        err = _flash_file_compressed(bin_file, size, addr);
+    }
 
     storage_file_close(bin_file);
     storage_file_free(bin_file);
 
-    return ESP_LOADER_SUCCESS;
+    return err;
 }
 
 // This in-app FW switch "exploits" the otadata (boot_app0)
@@ -227,34 +471,43 @@ static int32_t esp_flasher_flash_bin(void* context) {
         loader_port_debug_print(err_msg);
     }
 
-    // higher BR
+    // higher BR, keep flashing at the default rate if the target refuses it
+    bool fast_baudrate = false;
     if(!err && app->turbospeed) {
         loader_port_debug_print("Increasing speed for faster flash\n");
-        err = esp_loader_change_transmission_rate(FAST_BAUDRATE);
-        if(err != ESP_LOADER_SUCCESS) {
+        esp_loader_error_t br_err = esp_loader_change_transmission_rate(FAST_BAUDRATE);
+        if(br_err == ESP_LOADER_SUCCESS) {
+            furi_hal_uart_set_br(UART_CH, FAST_BAUDRATE);
+            // drop anything received while both sides were switching
+            loader_port_delay_ms(50);
+            furi_stream_buffer_reset(flash_rx_stream);
+            fast_baudrate = true;
+        } else {
             char err_msg[256];
             snprintf(
-                err_msg, sizeof(err_msg), "Cannot change transmission rate. Error: %u\n", err);
+                err_msg, sizeof(err_msg), "Cannot change transmission rate. Error: %u\n", br_err);
             loader_port_debug_print(err_msg);
         }
-        furi_hal_uart_set_br(UART_CH, FAST_BAUDRATE);
     }
 
     if(!err) {
         loader_port_debug_print("Connected\n");
         uint32_t start_time = furi_get_tick();
+        _bytes_sent = 0;
 
         if(!_switch_fw(app)) {
             _flash_all_files(app);
         }
         app->switch_fw = SwitchNotSet;
 
-        FuriString* flash_time =
-            furi_string_alloc_printf("Flash took: %lds\n", (furi_get_tick() - start_time) / 1000);
+        FuriString* flash_time = furi_string_alloc_printf(
+            "Flash took: %lds, %lu bytes sent\n",
+            (furi_get_tick() - start_time) / 1000,
+            _bytes_sent);
         loader_port_debug_print(furi_string_get_cstr(flash_time));
         furi_string_free(flash_time);
 
-        if(app->turbospeed) {
+        if(fast_baudrate) {
             loader_port_debug_print("Restoring transmission rate\n");
             furi_hal_uart_set_br(UART_CH, BAUDRATE);
         }
@@ -366,6 +619,7 @@ esp_loader_error_t loader_port_read(uint8_t* data, uint16_t size, uint32_t timeo
 esp_loader_error_t loader_port_write(const uint8_t* data, uint16_t size, uint32_t timeout) {
     UNUSED(timeout);
     esp_flasher_uart_tx((uint8_t*)data, size);
+    _bytes_sent += size;
     return ESP_LOADER_SUCCESS;
 }
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Minimal streaming zlib compressor (LZ77 + fixed Huffman codes) producing the
+ * stream expected by the FLASH_DEFL_* commands of the ROM loader.
+ * Memory footprint is sizeof(esp_deflate_t), roughly 28 kB.
+ */
+
+#define ESP_DEFLATE_WINDOW_SIZE 4096
+#define ESP_DEFLATE_HASH_BITS   11
+
+/**
+ * Upper bound of the number of bytes produced by a single esp_deflate_compress()
+ * call consuming in_size bytes of input (including zlib header and trailer).
+ */
+#define ESP_DEFLATE_BOUND(in_size) ((in_size) + (in_size) / 8 + 16)
+
+typedef struct {
+    uint8_t window[2 * ESP_DEFLATE_WINDOW_SIZE];
+    uint16_t head[1 << ESP_DEFLATE_HASH_BITS];
+    uint16_t prev[2 * ESP_DEFLATE_WINDOW_SIZE];
+    uint32_t window_end;
+    uint32_t bits;
+    uint32_t bit_count;
+    uint32_t adler_a;
+    uint32_t adler_b;
+    bool started;
+} esp_deflate_t;
+
+/**
+  * @brief Resets compressor state, must be called before each new stream.
+  *
+  * @param deflate[out]     Compressor state.
+  */
+void esp_deflate_init(esp_deflate_t *deflate);
+
+/**
+  * @brief Compresses next chunk of the stream.
+  *
+  * @param deflate[in,out]  Compressor state.
+  * @param in[in]           Input data.
+  * @param in_size[in]      Size of input, at most ESP_DEFLATE_WINDOW_SIZE bytes.
+  * @param finish[in]       Terminates the stream after this chunk when true.
+  * @param out[out]         Output buffer of at least ESP_DEFLATE_BOUND(in_size) bytes.
+  *
+  * @return Number of bytes written to out.
+  */
+size_t esp_deflate_compress(esp_deflate_t *deflate, const uint8_t *in, size_t in_size,
+                            bool finish, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -173,6 +173,55 @@ esp_loader_error_t esp_loader_flash_write(void *payload, uint32_t size);
   *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
   */
 esp_loader_error_t esp_loader_flash_finish(bool reboot);
+
+/**
+  * @brief Initiates compressed flash operation (FLASH_DEFL_BEGIN).
+  *
+  * @param offset[in]           Address from which flash operation will be performed.
+  * @param image_size[in]       Uncompressed size of the image, determines erased region.
+  * @param compressed_size[in]  Size of the zlib stream produced for the image.
+  * @param block_size[in]       Maximum size of chunks passed to esp_loader_flash_deflate_write.
+  *
+  * @note  Target inflates the stream on the fly, see esp_deflate.h for a matching compressor.
+  *        Verification is done with esp_loader_flash_verify_known_md5() afterwards.
+  *
+  * @return
+  *     - ESP_LOADER_SUCCESS Success
+  *     - ESP_LOADER_ERROR_TIMEOUT Timeout
+  *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
+  *     - ESP_LOADER_ERROR_UNSUPPORTED_FUNC Unsupported on the target
+  */
+esp_loader_error_t esp_loader_flash_deflate_start(uint32_t offset, uint32_t image_size,
+                                                 uint32_t compressed_size, uint32_t block_size);
+
+/**
+  * @brief Sends next chunk of the compressed stream (FLASH_DEFL_DATA).
+  *
+  * @param payload[in]      Compressed data.
+  * @param size[in]         Size of payload in bytes.
+  *
+  * @note  size must not be greater than block_size supplied to previously called
+  *        esp_loader_flash_deflate_start function. Payload is not padded, only the
+  *        last chunk of the stream is expected to be shorter than block_size.
+  *
+  * @return
+  *     - ESP_LOADER_SUCCESS Success
+  *     - ESP_LOADER_ERROR_TIMEOUT Timeout
+  *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
+  */
+esp_loader_error_t esp_loader_flash_deflate_write(const void *payload, uint32_t size);
+
+/**
+  * @brief Ends compressed flash operation (FLASH_DEFL_END).
+  *
+  * @param reboot[in]       reboot the target if true.
+  *
+  * @return
+  *     - ESP_LOADER_SUCCESS Success
+  *     - ESP_LOADER_ERROR_TIMEOUT Timeout
+  *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
+  */
+esp_loader_error_t esp_loader_flash_deflate_finish(bool reboot);
 #endif /* SERIAL_FLASHER_INTERFACE_UART */
 
 
@@ -286,6 +335,27 @@ esp_loader_error_t esp_loader_change_transmission_rate(uint32_t transmission_rat
   */
 #if MD5_ENABLED
 esp_loader_error_t esp_loader_flash_verify(void);
+
+/**
+  * @brief Compares MD5 of target's flash region against a digest computed by the caller.
+  *        Can be used to skip regions which already contain the image, or to verify
+  *        regions written by esp_loader_flash_deflate_write().
+  *
+  * @param address[in]      Start of the region.
+  * @param size[in]         Size of the region in bytes.
+  * @param expected_md5[in] Raw (binary) MD5 digest of the expected content.
+  *
+  * @note  This function is only available if MD5_ENABLED is set.
+  *
+  * @return
+  *     - ESP_LOADER_SUCCESS Success
+  *     - ESP_LOADER_ERROR_INVALID_MD5 MD5 does not match
+  *     - ESP_LOADER_ERROR_TIMEOUT Timeout
+  *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
+  *     - ESP_LOADER_ERROR_UNSUPPORTED_FUNC Unsupported on the target
+  */
+esp_loader_error_t esp_loader_flash_verify_known_md5(uint32_t address, uint32_t size,
+                                                    const uint8_t expected_md5[16]);
 #endif
 /**
   * @brief Toggles reset pin.
@@ -0,0 +1,230 @@
+#include "esp_deflate.h"
+#include <string.h>
+#include <assert.h>
+
+#define WINDOW_SIZE     ESP_DEFLATE_WINDOW_SIZE
+#define HASH_SIZE       (1 << ESP_DEFLATE_HASH_BITS)
+#define MIN_MATCH       3
+#define MAX_MATCH       258
+#define MAX_CHAIN       32
+#define END_OF_BLOCK    256
+#define ADLER_MOD       65521
+#define ADLER_NMAX      5552
+
+static const uint16_t s_length_base[] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8_t s_length_extra[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const uint16_t s_dist_base[] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289
+};
+
+static const uint8_t s_dist_extra[] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12
+};
+
+static void put_bits(esp_deflate_t *d, uint8_t **out, uint32_t value, uint32_t count)
+{
+    d->bits |= value << d->bit_count;
+    d->bit_count += count;
+
+    while (d->bit_count >= 8) {
+        *(*out)++ = (uint8_t)d->bits;
+        d->bits >>= 8;
+        d->bit_count -= 8;
+    }
+}
+
+/* Huffman codes are stored MSB first, everything else in the stream LSB first */
+static void put_code(esp_deflate_t *d, uint8_t **out, uint32_t code, uint32_t length)
+{
+    uint32_t reversed = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+
+    put_bits(d, out, reversed, length);
+}
+
+/* Fixed literal/length code, RFC 1951 section 3.2.6 */
+static void put_symbol(esp_deflate_t *d, uint8_t **out, uint32_t symbol)
+{
+    if (symbol < 144) {
+        put_code(d, out, 0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        put_code(d, out, 0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        put_code(d, out, symbol - 256, 7);
+    } else {
+        put_code(d, out, 0xc0 + symbol - 280, 8);
+    }
+}
+
+static void put_match(esp_deflate_t *d, uint8_t **out, uint32_t length, uint32_t distance)
+{
+    uint32_t code = sizeof(s_length_base) / sizeof(s_length_base[0]) - 1;
+    while (s_length_base[code] > length) {
+        code--;
+    }
+    put_symbol(d, out, 257 + code);
+    put_bits(d, out, length - s_length_base[code], s_length_extra[code]);
+
+    code = sizeof(s_dist_base) / sizeof(s_dist_base[0]) - 1;
+    while (s_dist_base[code] > distance) {
+        code--;
+    }
+    put_code(d, out, code, 5);
+    put_bits(d, out, distance - s_dist_base[code], s_dist_extra[code]);
+}
+
+static inline uint32_t hash(const uint8_t *data)
+{
+    uint32_t key = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
+    return (key * 2654435761U) >> (32 - ESP_DEFLATE_HASH_BITS);
+}
+
+static void adler32_update(esp_deflate_t *d, const uint8_t *data, size_t size)
+{
+    while (size > 0) {
+        size_t chunk = size < ADLER_NMAX ? size : ADLER_NMAX;
+        size -= chunk;
+        while (chunk--) {
+            d->adler_a += *data++;
+            d->adler_b += d->adler_a;
+        }
+        d->adler_a %= ADLER_MOD;
+        d->adler_b %= ADLER_MOD;
+    }
+}
+
+/* Keeps the last WINDOW_SIZE bytes as history and rebases hash chains on them */
+static void slide_window(esp_deflate_t *d)
+{
+    const uint32_t shift = d->window_end - WINDOW_SIZE;
+
+    memmove(d->window, &d->window[shift], WINDOW_SIZE);
+
+    for (uint32_t i = 0; i < HASH_SIZE; i++) {
+        d->head[i] = d->head[i] > shift ? d->head[i] - shift : 0;
+    }
+    for (uint32_t i = 0; i < WINDOW_SIZE; i++) {
+        uint16_t link = d->prev[i + shift];
+        d->prev[i] = link > shift ? link - shift : 0;
+    }
+
+    d->window_end = WINDOW_SIZE;
+}
+
+static inline void insert_string(esp_deflate_t *d, uint32_t pos)
+{
+    uint32_t h = hash(&d->window[pos]);
+    d->prev[pos] = d->head[h];
+    d->head[h] = pos + 1;
+}
+
+void esp_deflate_init(esp_deflate_t *deflate)
+{
+    memset(deflate, 0, sizeof(*deflate));
+    deflate->adler_a = 1;
+}
+
+size_t esp_deflate_compress(esp_deflate_t *deflate, const uint8_t *in, size_t in_size,
+                            bool finish, uint8_t *out)
+{
+    esp_deflate_t *d = deflate;
+    uint8_t *o = out;
+
+    assert(in_size <= WINDOW_SIZE);
+
+    if (!d->started) {
+        // zlib header: deflate, 32K window, no dictionary, fastest compression level
+        *o++ = 0x78;
+        *o++ = 0x01;
+        // Non-final block with fixed Huffman codes, kept open until finish
+        put_bits(d, &o, 0x2, 3);
+        d->started = true;
+    }
+
+    adler32_update(d, in, in_size);
+
+    if (d->window_end + in_size > 2 * WINDOW_SIZE) {
+        slide_window(d);
+    }
+
+    memcpy(&d->window[d->window_end], in, in_size);
+
+    uint32_t pos = d->window_end;
+    const uint32_t end = d->window_end + in_size;
+    d->window_end = end;
+
+    while (pos < end) {
+        uint32_t best_length = 0;
+        uint32_t best_distance = 0;
+
+        if (end - pos >= MIN_MATCH) {
+            const uint8_t *current = &d->window[pos];
+            const uint32_t max_length = end - pos < MAX_MATCH ? end - pos : MAX_MATCH;
+            uint32_t chain = MAX_CHAIN;
+
+            for (uint32_t link = d->head[hash(current)]; link != 0 && chain-- > 0;
+                    link = d->prev[link - 1]) {
+                const uint8_t *match = &d->window[link - 1];
+                if (match[best_length] != current[best_length]) {
+                    continue;
+                }
+
+                uint32_t length = 0;
+                while (length < max_length && match[length] == current[length]) {
+                    length++;
+                }
+
+                if (length > best_length) {
+                    best_length = length;
+                    best_distance = pos - (link - 1);
+                    if (length == max_length) {
+                        break;
+                    }
+                }
+            }
+
+            insert_string(d, pos);
+        }
+
+        if (best_length >= MIN_MATCH) {
+            put_match(d, &o, best_length, best_distance);
+            for (uint32_t i = 1; i < best_length && pos + i + MIN_MATCH <= end; i++) {
+                insert_string(d, pos + i);
+            }
+            pos += best_length;
+        } else {
+            put_symbol(d, &o, d->window[pos]);
+            pos++;
+        }
+    }
+
+    if (finish) {
+        put_symbol(d, &o, END_OF_BLOCK);
+        // Empty final block
+        put_bits(d, &o, 0x3, 3);
+        put_symbol(d, &o, END_OF_BLOCK);
+        if (d->bit_count > 0) {
+            put_bits(d, &o, 0, 8 - d->bit_count);
+        }
+
+        *o++ = (uint8_t)(d->adler_b >> 8);
+        *o++ = (uint8_t)d->adler_b;
+        *o++ = (uint8_t)(d->adler_a >> 8);
+        *o++ = (uint8_t)d->adler_a;
+    }
+
+    return o - out;
+}
@@ -44,6 +44,10 @@ typedef enum {
 static const target_registers_t *s_reg = NULL;
 static target_chip_t s_target = ESP_UNKNOWN_CHIP;
 
+#ifdef SERIAL_FLASHER_INTERFACE_UART
+static size_t s_flash_size = 0;
+#endif
+
 #if MD5_ENABLED
 
 static const uint32_t MD5_TIMEOUT_PER_MB = 800;
@@ -97,6 +101,7 @@ esp_loader_error_t esp_loader_connect(esp_loader_connect_args_t *connect_args)
 #ifdef SERIAL_FLASHER_INTERFACE_UART
     esp_loader_error_t err;
     uint32_t spi_config;
+    s_flash_size = 0;
     if (s_target == ESP8266_CHIP) {
         err = loader_flash_begin_cmd(0, 0, 0, 0, s_target);
     } else {
@@ -116,6 +121,7 @@ target_chip_t esp_loader_get_target(void)
 
 #ifdef SERIAL_FLASHER_INTERFACE_UART
 static uint32_t s_flash_write_size = 0;
+static uint32_t s_deflate_ratio = 1;
 
 static esp_loader_error_t spi_set_data_lengths(size_t mosi_bits, size_t miso_bits)
 {
@@ -251,12 +257,15 @@ static uint32_t calc_erase_size(const target_chip_t target, const uint32_t offse
     }
 }
 
-esp_loader_error_t esp_loader_flash_start(uint32_t offset, uint32_t image_size, uint32_t block_size)
+static esp_loader_error_t set_flash_parameters(uint32_t image_size)
 {
-    s_flash_write_size = block_size;
+    // Detection takes a dozen register accesses, do it once per connection
+    if (s_flash_size == 0 && detect_flash_size(&s_flash_size) != ESP_LOADER_SUCCESS) {
+        s_flash_size = 0;
+    }
 
-    size_t flash_size = 0;
-    if (detect_flash_size(&flash_size) == ESP_LOADER_SUCCESS) {
+    size_t flash_size = s_flash_size;
+    if (flash_size != 0) {
         if (image_size > flash_size) {
             return ESP_LOADER_ERROR_IMAGE_SIZE;
         }
@@ -266,6 +275,15 @@ esp_loader_error_t esp_loader_flash_start(uint32_t offset, uint32_t image_size,
         loader_port_debug_print("Flash size detection failed, falling back to default");
     }
 
+    return ESP_LOADER_SUCCESS;
+}
+
+esp_loader_error_t esp_loader_flash_start(uint32_t offset, uint32_t image_size, uint32_t block_size)
+{
+    s_flash_write_size = block_size;
+
+    RETURN_ON_ERROR( set_flash_parameters(image_size) );
+
     init_md5(offset, image_size);
 
     bool encryption_in_cmd = encryption_in_begin_flash_cmd(s_target);
@@ -313,6 +331,52 @@ esp_loader_error_t esp_loader_flash_finish(bool reboot)
 
     return loader_flash_end_cmd(!reboot);
 }
+
+
+esp_loader_error_t esp_loader_flash_deflate_start(uint32_t offset, uint32_t image_size,
+                                                 uint32_t compressed_size, uint32_t block_size)
+{
+    if (s_target == ESP8266_CHIP) {
+        return ESP_LOADER_ERROR_UNSUPPORTED_FUNC;
+    }
+
+    s_flash_write_size = block_size;
+
+    RETURN_ON_ERROR( set_flash_parameters(image_size) );
+
+    bool encryption_in_cmd = encryption_in_begin_flash_cmd(s_target);
+    // ROM loader erases whole write blocks of the uncompressed image
+    const uint32_t erase_size = ROUNDUP(image_size, block_size) * block_size;
+    const uint32_t blocks_to_write = ROUNDUP(compressed_size, block_size);
+    s_deflate_ratio = (compressed_size > 0 && image_size > compressed_size) ?
+                      image_size / compressed_size : 1;
+
+    const uint32_t erase_region_timeout_per_mb = 10000;
+    loader_port_start_timer(timeout_per_mb(erase_size, erase_region_timeout_per_mb));
+    return loader_flash_defl_begin_cmd(offset, erase_size, block_size, blocks_to_write, encryption_in_cmd);
+}
+
+
+esp_loader_error_t esp_loader_flash_deflate_write(const void *payload, uint32_t size)
+{
+    if (size > s_flash_write_size) {
+        return ESP_LOADER_ERROR_INVALID_PARAM;
+    }
+
+    // Blocks are not retried, the inflater on the target may have already consumed them.
+    // Timeout covers writing the block's expected share of the uncompressed image.
+    const uint32_t write_timeout_per_mb = 40000;
+    loader_port_start_timer(timeout_per_mb(size * s_deflate_ratio, write_timeout_per_mb));
+    return loader_flash_defl_data_cmd((const uint8_t *)payload, size);
+}
+
+
+esp_loader_error_t esp_loader_flash_deflate_finish(bool reboot)
+{
+    loader_port_start_timer(DEFAULT_TIMEOUT);
+
+    return loader_flash_defl_end_cmd(!reboot);
+}
 #endif /* SERIAL_FLASHER_INTERFACE_UART */
 
 esp_loader_error_t esp_loader_mem_start(uint32_t offset, uint32_t size, uint32_t block_size)
@@ -424,6 +488,30 @@ esp_loader_error_t esp_loader_flash_verify(void)
     return ESP_LOADER_SUCCESS;
 }
 
+
+esp_loader_error_t esp_loader_flash_verify_known_md5(uint32_t address, uint32_t size,
+                                                    const uint8_t expected_md5[16])
+{
+    if (s_target == ESP8266_CHIP) {
+        return ESP_LOADER_ERROR_UNSUPPORTED_FUNC;
+    }
+
+    uint8_t hex_md5[MD5_SIZE] = {0};
+    uint8_t received_md5[MD5_SIZE + 2] = {0};
+
+    hexify(expected_md5, hex_md5);
+
+    loader_port_start_timer(timeout_per_mb(size, MD5_TIMEOUT_PER_MB));
+
+    RETURN_ON_ERROR( loader_md5_cmd(address, size, received_md5) );
+
+    if (memcmp(hex_md5, received_md5, MD5_SIZE) != 0) {
+        return ESP_LOADER_ERROR_INVALID_MD5;
+    }
+
+    return ESP_LOADER_SUCCESS;
+}
+
 #endif
 
 void esp_loader_reset_target(void)
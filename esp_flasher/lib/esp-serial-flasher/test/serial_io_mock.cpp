@@ -19,8 +19,11 @@
 #include <algorithm>
 #include <iostream>
 #include <stdio.h>
+#include <string.h>
 #include "esp_loader_io.h"
 #include "serial_io_mock.h"
+#include "protocol.h"
+#include "md5_hash.h"
 
 using namespace std;
 
@@ -29,6 +32,8 @@ static vector<int8_t> read_buffer;
 static uint32_t receive_delay = 0;
 static int32_t timer = 0;
 
+static void target_receive(const uint8_t *data, uint16_t size);
+
 
 esp_loader_error_t loader_port_mock_init(const loader_serial_config_t *config)
 {
@@ -43,6 +48,7 @@ void loader_port_mock_deinit()
 esp_loader_error_t loader_port_write(const uint8_t *data, uint16_t size, uint32_t timeout)
 {
     copy(&data[0], &data[size], back_inserter(write_buffer));
+    target_receive(data, size);
 
     return ESP_LOADER_SUCCESS;
 }
@@ -122,6 +128,7 @@ void clear_buffers()
 {
     write_buffer.clear();
     read_buffer.clear();
+    simulated_target_reset();
 }
 
 int8_t *write_buffer_data()
@@ -155,4 +162,389 @@ void write_buffer_print()
 void serial_set_time_delay(uint32_t miliseconds)
 {
     receive_delay = miliseconds;
-}
\ No newline at end of file
+}
+
+
+// ----------  Simulated target  ----------
+// Answers every command written while enabled, keeps a model of target's flash
+// and inflates FLASH_DEFL_DATA payloads into it the way the ROM loader does.
+
+static const uint32_t SIMULATED_FLASH_SIZE = 4 * 1024 * 1024;
+
+static bool target_enabled = false;
+static vector<uint8_t> target_flash(SIMULATED_FLASH_SIZE, 0xff);
+static vector<uint8_t> target_frame;
+static bool target_in_frame = false;
+static bool target_escape = false;
+static simulated_target_stats_t target_stats;
+
+static uint32_t session_offset;
+static uint32_t session_block_size;
+static uint32_t session_packets;
+static uint32_t session_sequence;
+static vector<uint8_t> session_stream;
+
+// Minimal inflater supporting stored and fixed Huffman blocks wrapped in zlib format
+class bit_reader {
+public:
+    bit_reader(const vector<uint8_t> &data) : data(data), pos(0), bit(0) { }
+
+    bool read(uint32_t count, uint32_t &value)
+    {
+        value = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            if (pos >= data.size()) {
+                return false;
+            }
+            value |= ((data[pos] >> bit) & 1) << i;
+            if (++bit == 8) {
+                bit = 0;
+                pos++;
+            }
+        }
+        return true;
+    }
+
+    bool read_code(uint32_t count, uint32_t &value)
+    {
+        uint32_t next;
+        for (uint32_t i = 0; i < count; i++) {
+            if (!read(1, next)) {
+                return false;
+            }
+            value = (value << 1) | next;
+        }
+        return true;
+    }
+
+    void align()
+    {
+        if (bit != 0) {
+            bit = 0;
+            pos++;
+        }
+    }
+
+    size_t position() const
+    {
+        return pos;
+    }
+
+    void skip(size_t bytes)
+    {
+        pos += bytes;
+    }
+
+private:
+    const vector<uint8_t> &data;
+    size_t pos;
+    uint32_t bit;
+};
+
+static bool inflate_fixed_symbol(bit_reader &reader, uint32_t &symbol)
+{
+    uint32_t code = 0;
+
+    if (!reader.read_code(7, code)) {
+        return false;
+    }
+    if (code <= 0x17) {
+        symbol = 256 + code;
+        return true;
+    }
+    if (!reader.read_code(1, code)) {
+        return false;
+    }
+    if (code >= 0x30 && code <= 0xbf) {
+        symbol = code - 0x30;
+        return true;
+    }
+    if (code >= 0xc0 && code <= 0xc7) {
+        symbol = 280 + code - 0xc0;
+        return true;
+    }
+    if (!reader.read_code(1, code)) {
+        return false;
+    }
+    symbol = 144 + code - 0x190;
+    return true;
+}
+
+static bool inflate_zlib(const vector<uint8_t> &in, vector<uint8_t> &out)
+{
+    static const uint16_t length_base[] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    static const uint8_t length_extra[] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+        2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    static const uint16_t dist_base[] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+    };
+    static const uint8_t dist_extra[] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    if (in.size() < 6 || (in[0] & 0x0f) != 8 || ((in[0] << 8) | in[1]) % 31 != 0) {
+        return false;
+    }
+
+    bit_reader reader(in);
+    reader.skip(2);
+
+    uint32_t final_block = 0;
+    while (!final_block) {
+        uint32_t type;
+        if (!reader.read(1, final_block) || !reader.read(2, type)) {
+            return false;
+        }
+
+        if (type == 0) {
+            reader.align();
+            size_t pos = reader.position();
+            if (pos + 4 > in.size()) {
+                return false;
+            }
+            uint32_t length = in[pos] | (in[pos + 1] << 8);
+            if (pos + 4 + length > in.size()) {
+                return false;
+            }
+            out.insert(out.end(), &in[pos + 4], &in[pos + 4 + length]);
+            reader.skip(4 + length);
+            continue;
+        }
+
+        if (type != 1) {
+            return false;
+        }
+
+        while (true) {
+            uint32_t symbol;
+            if (!inflate_fixed_symbol(reader, symbol)) {
+                return false;
+            }
+            if (symbol < 256) {
+                out.push_back(symbol);
+                continue;
+            }
+            if (symbol == 256) {
+                break;
+            }
+
+            symbol -= 257;
+            uint32_t extra, dist_code = 0, dist_extra_bits = 0;
+            if (symbol >= 29 || !reader.read(length_extra[symbol], extra)) {
+                return false;
+            }
+            uint32_t length = length_base[symbol] + extra;
+
+            if (!reader.read_code(5, dist_code) || dist_code >= 30 ||
+                !reader.read(dist_extra[dist_code], dist_extra_bits)) {
+                return false;
+            }
+            uint32_t distance = dist_base[dist_code] + dist_extra_bits;
+            if (distance > out.size()) {
+                return false;
+            }
+
+            size_t from = out.size() - distance;
+            for (uint32_t i = 0; i < length; i++) {
+                out.push_back(out[from + i]);
+            }
+        }
+    }
+
+    reader.align();
+    size_t pos = reader.position();
+    if (pos + 4 > in.size()) {
+        return false;
+    }
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : out) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    uint32_t adler = (in[pos] << 24) | (in[pos + 1] << 16) | (in[pos + 2] << 8) | in[pos + 3];
+
+    return adler == ((b << 16) | a);
+}
+
+static void target_respond(const void *response, size_t size)
+{
+    SLIP_encode((const int8_t *)response, size, read_buffer);
+}
+
+static void target_handle_command(const uint8_t *packet, size_t size)
+{
+    if (size < sizeof(command_common_t)) {
+        return;
+    }
+
+    command_common_t common;
+    memcpy(&common, packet, sizeof(common));
+
+    response_t response = {};
+    response.common.direction = READ_DIRECTION;
+    response.common.command = common.command;
+    response.common.size = sizeof(response_status_t);
+    response.status.failed = STATUS_SUCCESS;
+
+    target_stats.commands++;
+
+    switch (common.command) {
+    case FLASH_BEGIN:
+    case FLASH_DEFL_BEGIN: {
+        flash_begin_command_t begin = {};
+        memcpy(&begin, packet, min(size, sizeof(begin)));
+        session_offset = begin.offset;
+        session_block_size = begin.packet_size;
+        session_packets = begin.packet_count;
+        session_sequence = 0;
+        session_stream.clear();
+        if (begin.offset + begin.erase_size <= SIMULATED_FLASH_SIZE) {
+            fill_n(&target_flash[begin.offset], begin.erase_size, 0xff);
+            target_stats.erased_bytes += begin.erase_size;
+        }
+        if (common.command == FLASH_DEFL_BEGIN) {
+            target_stats.deflate_sessions++;
+        }
+        break;
+    }
+
+    case FLASH_DATA:
+    case FLASH_DEFL_DATA: {
+        data_command_t data = {};
+        if (size < sizeof(data)) {
+            return;
+        }
+        memcpy(&data, packet, sizeof(data));
+        const uint8_t *block = packet + sizeof(data);
+        const uint32_t block_size = size - sizeof(data);
+
+        if (data.sequence_number != session_sequence++ || block_size != data.data_size) {
+            response.status.failed = STATUS_FAILURE;
+            response.status.error = INVALID_COMMAND;
+            break;
+        }
+
+        if (common.command == FLASH_DATA) {
+            target_stats.data_packets++;
+            uint32_t address = session_offset + data.sequence_number * session_block_size;
+            if (address + block_size <= SIMULATED_FLASH_SIZE) {
+                copy_n(block, block_size, &target_flash[address]);
+            }
+            break;
+        }
+
+        target_stats.deflate_packets++;
+        session_stream.insert(session_stream.end(), block, block + block_size);
+        if (session_sequence == session_packets) {
+            vector<uint8_t> image;
+            if (!inflate_zlib(session_stream, image) ||
+                    session_offset + image.size() > SIMULATED_FLASH_SIZE) {
+                response.status.failed = STATUS_FAILURE;
+                response.status.error = DEFLATE_ERROR;
+                break;
+            }
+            copy(image.begin(), image.end(), &target_flash[session_offset]);
+            target_stats.inflated_bytes += image.size();
+        }
+        break;
+    }
+
+    case SPI_FLASH_MD5: {
+        spi_flash_md5_command_t md5_cmd = {};
+        memcpy(&md5_cmd, packet, min(size, sizeof(md5_cmd)));
+        target_stats.md5_requests++;
+
+        rom_md5_response_t md5_response = {};
+        md5_response.common = response.common;
+        md5_response.common.size = MD5_SIZE + sizeof(response_status_t);
+        md5_response.status = response.status;
+
+        uint8_t digest[16] = {0};
+        struct MD5Context context;
+        MD5Init(&context);
+        if (md5_cmd.address + md5_cmd.size <= SIMULATED_FLASH_SIZE) {
+            MD5Update(&context, &target_flash[md5_cmd.address], md5_cmd.size);
+        }
+        MD5Final(digest, &context);
+        for (int i = 0; i < 16; i++) {
+            snprintf((char *)&md5_response.md5[i * 2], 3, "%02x", digest[i]);
+        }
+        // snprintf terminates the string inside of the status field
+        md5_response.status = response.status;
+
+        target_respond(&md5_response, sizeof(md5_response));
+        return;
+    }
+
+    default:
+        break;
+    }
+
+    target_respond(&response, sizeof(response));
+}
+
+static void target_receive(const uint8_t *data, uint16_t size)
+{
+    if (!target_enabled) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < size; i++) {
+        uint8_t ch = data[i];
+
+        if (ch == 0xc0) {
+            if (target_in_frame && !target_frame.empty()) {
+                target_handle_command(target_frame.data(), target_frame.size());
+                target_frame.clear();
+                target_in_frame = false;
+            } else {
+                target_in_frame = true;
+            }
+        } else if (target_escape) {
+            target_frame.push_back(ch == 0xdc ? 0xc0 : 0xdb);
+            target_escape = false;
+        } else if (ch == 0xdb) {
+            target_escape = true;
+        } else {
+            target_frame.push_back(ch);
+        }
+    }
+}
+
+void simulated_target_enable(bool enable)
+{
+    target_enabled = enable;
+}
+
+void simulated_target_reset()
+{
+    fill(target_flash.begin(), target_flash.end(), 0xff);
+    target_frame.clear();
+    target_in_frame = false;
+    target_escape = false;
+    target_stats = {};
+}
+
+void simulated_flash_set(uint32_t address, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    copy(bytes, bytes + size, &target_flash[address]);
+}
+
+const uint8_t *simulated_flash_data()
+{
+    return target_flash.data();
+}
+
+simulated_target_stats_t simulated_target_stats()
+{
+    return target_stats;
+}
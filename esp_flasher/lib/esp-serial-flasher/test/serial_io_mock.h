@@ -29,6 +29,22 @@ void set_read_buffer(const void *data, size_t size);
 void print_array(int8_t *data, uint32_t size);
 void serial_set_time_delay(uint32_t miliseconds);
 
+typedef struct {
+    uint32_t commands;
+    uint32_t data_packets;
+    uint32_t deflate_sessions;
+    uint32_t deflate_packets;
+    uint32_t md5_requests;
+    uint32_t erased_bytes;
+    uint32_t inflated_bytes;
+} simulated_target_stats_t;
+
+void simulated_target_enable(bool enable);
+void simulated_target_reset();
+void simulated_flash_set(uint32_t address, const void *data, size_t size);
+const uint8_t *simulated_flash_data();
+simulated_target_stats_t simulated_target_stats();
+
 
 typedef struct {
     uint32_t dummy;
@@ -18,11 +18,16 @@
 #include "serial_io_mock.h"
 #include "esp_loader.h"
 #include "esp_loader_io.h"
+#include "esp_deflate.h"
+#include "md5_hash.h"
 #include <string.h>
 #include <stdio.h>
 #include <array>
 #include <map>
+#include <vector>
 #include <iostream>
+#include <fstream>
+#include <iterator>
 #include <algorithm>
 
 using namespace std;
@@ -403,3 +408,207 @@ TEST_CASE( "Serial read works correctly" )
         REQUIRE( memcmp(expected, encoded, sizeof(expected)) == 0 );
     }
 }
+
+
+// --------------------  Compressed flashing  -----------------------
+
+TEST_CASE( "Compressed flash begin command is constructed correctly" )
+{
+    uint8_t expected[] = {
+        0xc0,         // Begin
+        0x00,         // Write direction
+        0x10,         // FLASH_DEFL_BEGIN command
+        16, 0,        // Number of characters to send
+        0, 0, 0, 0,   // Checksum is ignored for this command
+        0x00, 0x14, 0, 0, // Erase size
+        2, 0, 0, 0,   // Packet count
+        0x00, 0x04, 0, 0, // Packet size
+        0x00, 0x00, 0x01, 0x00, // Offset
+        0xc0,         // End
+    };
+
+    clear_buffers();
+    expected_response defl_begin_response(FLASH_DEFL_BEGIN);
+    queue_response(defl_begin_response);
+
+    REQUIRE_SUCCESS( loader_flash_defl_begin_cmd(0x10000, 0x1400, 1024, 2, false) );
+
+    REQUIRE( write_buffer_size() == sizeof(expected) );
+    REQUIRE( memcmp(write_buffer_data(), expected, sizeof(expected)) == 0 );
+}
+
+TEST_CASE( "Deflate stream is encoded correctly" )
+{
+    static esp_deflate_t deflate;
+    const char input[] = "hello hello hello";
+    const uint8_t expected[] = {
+        0x78, 0x01, 0xca, 0x48, 0xcd, 0xc9, 0xc9, 0x57, 0x40, 0x22, 0x01, 0x03,
+        0x00, 0x3a, 0x2e, 0x06, 0x7d
+    };
+    uint8_t output[ESP_DEFLATE_BOUND(sizeof(input))];
+
+    SECTION( "Single chunk" ) {
+        esp_deflate_init(&deflate);
+        size_t size = esp_deflate_compress(&deflate, (const uint8_t *)input, strlen(input),
+                                           true, output);
+
+        REQUIRE( size == sizeof(expected) );
+        REQUIRE( memcmp(output, expected, sizeof(expected)) == 0 );
+    }
+
+    SECTION( "Empty stream" ) {
+        const uint8_t empty[] = { 0x78, 0x01, 0x02, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+        esp_deflate_init(&deflate);
+        size_t size = esp_deflate_compress(&deflate, NULL, 0, true, output);
+
+        REQUIRE( size == sizeof(empty) );
+        REQUIRE( memcmp(output, empty, sizeof(empty)) == 0 );
+    }
+}
+
+static const uint32_t FLASH_BLOCK_SIZE = 1024;
+static const uint32_t FLASH_REGION_SIZE = 64 * 1024;
+
+static void compute_md5(const uint8_t *data, uint32_t size, uint8_t digest[16])
+{
+    struct MD5Context context;
+    MD5Init(&context);
+    MD5Update(&context, data, size);
+    MD5Final(digest, &context);
+}
+
+// Compresses the region with the same chunking as the application, passing packets
+// of FLASH_BLOCK_SIZE bytes to the target when send is true. Returns compressed size.
+static uint32_t deflate_region(const uint8_t *data, uint32_t size, bool send)
+{
+    static esp_deflate_t deflate;
+    static uint8_t output[ESP_DEFLATE_BOUND(ESP_DEFLATE_WINDOW_SIZE)];
+    vector<uint8_t> pending;
+    uint32_t compressed = 0;
+
+    esp_deflate_init(&deflate);
+
+    uint32_t offset = 0;
+    do {
+        uint32_t chunk = min(size - offset, (uint32_t)ESP_DEFLATE_WINDOW_SIZE);
+        offset += chunk;
+        size_t produced = esp_deflate_compress(&deflate, data + offset - chunk, chunk,
+                                               offset == size, output);
+        compressed += produced;
+
+        if (send) {
+            pending.insert(pending.end(), output, output + produced);
+            while (pending.size() >= FLASH_BLOCK_SIZE || (offset == size && !pending.empty())) {
+                uint32_t block = min((uint32_t)pending.size(), FLASH_BLOCK_SIZE);
+                REQUIRE_SUCCESS( esp_loader_flash_deflate_write(pending.data(), block) );
+                pending.erase(pending.begin(), pending.begin() + block);
+            }
+        }
+    } while (offset < size);
+
+    return compressed;
+}
+
+// Mirrors the compressed pipeline of the application: regions whose MD5 already
+// matches are skipped, the rest is measured, streamed and verified.
+static void flash_image_compressed(const vector<uint8_t> &image, uint32_t address)
+{
+    for (uint32_t offset = 0; offset < image.size(); offset += FLASH_REGION_SIZE) {
+        uint32_t size = min((uint32_t)image.size() - offset, FLASH_REGION_SIZE);
+        uint8_t digest[16];
+        compute_md5(&image[offset], size, digest);
+
+        esp_loader_error_t err = esp_loader_flash_verify_known_md5(address + offset, size, digest);
+        if (err == ESP_LOADER_SUCCESS) {
+            continue;
+        }
+        REQUIRE( err == ESP_LOADER_ERROR_INVALID_MD5 );
+
+        uint32_t compressed = deflate_region(&image[offset], size, false);
+        REQUIRE_SUCCESS( esp_loader_flash_deflate_start(address + offset, size, compressed,
+                                                        FLASH_BLOCK_SIZE) );
+        deflate_region(&image[offset], size, true);
+
+        REQUIRE_SUCCESS( esp_loader_flash_verify_known_md5(address + offset, size, digest) );
+    }
+}
+
+static void flash_image_raw(vector<uint8_t> image, uint32_t address)
+{
+    image.resize(image.size() + FLASH_BLOCK_SIZE);
+    const uint32_t size = image.size() - FLASH_BLOCK_SIZE;
+
+    REQUIRE_SUCCESS( esp_loader_flash_start(address, size, FLASH_BLOCK_SIZE) );
+    for (uint32_t offset = 0; offset < size; offset += FLASH_BLOCK_SIZE) {
+        REQUIRE_SUCCESS( esp_loader_flash_write(&image[offset],
+                                                min(size - offset, FLASH_BLOCK_SIZE)) );
+    }
+    REQUIRE_SUCCESS( esp_loader_flash_verify() );
+}
+
+TEST_CASE( "Image can be flashed through compressed pipeline" )
+{
+    const uint32_t address = 0x10000;
+
+    ifstream file("../hello-world.bin", ios::binary);
+    REQUIRE( file.is_open() );
+    const vector<uint8_t> image((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    REQUIRE( image.size() > 2 * FLASH_REGION_SIZE );
+
+    esp_loader_connect_args_t connect_config = ESP_LOADER_CONNECT_DEFAULT();
+    queue_connect_response(ESP32_CHIP);
+    REQUIRE_SUCCESS( esp_loader_connect(&connect_config) );
+
+    clear_buffers();
+    simulated_target_enable(true);
+
+    SECTION( "Uncompressed reference" ) {
+        flash_image_raw(image, address);
+
+        REQUIRE( memcmp(simulated_flash_data() + address, image.data(), image.size()) == 0 );
+        printf("hello-world.bin (%zu bytes) uncompressed: %zu bytes on the wire\n",
+               image.size(), write_buffer_size());
+    }
+
+    SECTION( "Erased target receives compressed image" ) {
+        flash_image_compressed(image, address);
+
+        simulated_target_stats_t stats = simulated_target_stats();
+        REQUIRE( memcmp(simulated_flash_data() + address, image.data(), image.size()) == 0 );
+        REQUIRE( stats.deflate_sessions == (image.size() + FLASH_REGION_SIZE - 1) / FLASH_REGION_SIZE );
+        REQUIRE( stats.inflated_bytes == image.size() );
+        REQUIRE( write_buffer_size() < image.size() );
+        printf("hello-world.bin (%zu bytes) compressed: %zu bytes on the wire, %u packets\n",
+               image.size(), write_buffer_size(), stats.deflate_packets);
+    }
+
+    SECTION( "Unchanged image is skipped" ) {
+        simulated_flash_set(address, image.data(), image.size());
+
+        flash_image_compressed(image, address);
+
+        simulated_target_stats_t stats = simulated_target_stats();
+        REQUIRE( stats.deflate_sessions == 0 );
+        REQUIRE( stats.erased_bytes == 0 );
+        printf("hello-world.bin (%zu bytes) unchanged: %zu bytes on the wire\n",
+               image.size(), write_buffer_size());
+    }
+
+    SECTION( "Only changed region is written" ) {
+        vector<uint8_t> modified = image;
+        modified[FLASH_REGION_SIZE + 100] ^= 0xff;
+        simulated_flash_set(address, modified.data(), modified.size());
+
+        flash_image_compressed(image, address);
+
+        simulated_target_stats_t stats = simulated_target_stats();
+        REQUIRE( memcmp(simulated_flash_data() + address, image.data(), image.size()) == 0 );
+        REQUIRE( stats.deflate_sessions == 1 );
+        REQUIRE( stats.erased_bytes == FLASH_REGION_SIZE );
+        printf("hello-world.bin (%zu bytes) one region changed: %zu bytes on the wire\n",
+               image.size(), write_buffer_size());
+    }
+
+    simulated_target_enable(false);
+}
@@ -14,14 +14,11 @@ void sound_engine_init(
         free(sound_engine->audio_buffer);
     }
 
-    if(sound_engine->sine_lut) {
-        free(sound_engine->sine_lut);
-    }
-
     memset(sound_engine, 0, sizeof(SoundEngine));
 
     sound_engine->audio_buffer = malloc(audio_buffer_size * sizeof(sound_engine->audio_buffer[0]));
-    memset(sound_engine->audio_buffer, 0, sizeof(SoundEngine));
+    memset(
+        sound_engine->audio_buffer, 0, audio_buffer_size * sizeof(sound_engine->audio_buffer[0]));
     sound_engine->audio_buffer_size = audio_buffer_size;
     sound_engine->sample_rate = sample_rate;
     sound_engine->external_audio_output = external_audio_output;
@@ -96,7 +93,9 @@ void sound_engine_enable_gate(SoundEngine* sound_engine, SoundEngineChannel* cha
     }
 }
 
-void sound_engine_fill_buffer(
+// per sample renderer, used when ring modulation or hard sync make the channels depend on each
+// other sample by sample
+static void sound_engine_fill_buffer_per_sample(
     SoundEngine* sound_engine,
     uint16_t* audio_buffer,
     uint32_t audio_buffer_size) {
@@ -200,4 +199,63 @@ void sound_engine_fill_buffer(
         //audio_buffer[i] = output / (64 * 4);
         audio_buffer[i] = output >> 8;
     }
-}
\ No newline at end of file
+}
+
+static bool sound_engine_channels_interact(SoundEngine* sound_engine) {
+    for(uint32_t chan = 0; chan < NUM_CHANNELS; ++chan) {
+        SoundEngineChannel* channel = &sound_engine->channel[chan];
+
+        if(channel->frequency > 0 &&
+           (channel->flags & (SE_ENABLE_RING_MOD | SE_ENABLE_HARD_SYNC))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// block renderer: each channel is rendered SE_BLOCK_SIZE samples at a time, with the oscillator
+// waveform and the filter mode resolved once per block and the envelope advanced at block rate
+void sound_engine_fill_buffer(
+    SoundEngine* sound_engine,
+    uint16_t* audio_buffer,
+    uint32_t audio_buffer_size) {
+    if(sound_engine_channels_interact(sound_engine)) {
+        sound_engine_fill_buffer_per_sample(sound_engine, audio_buffer, audio_buffer_size);
+        return;
+    }
+
+    int32_t mix[SE_BLOCK_SIZE];
+    int32_t channel_output[SE_BLOCK_SIZE];
+
+    for(uint32_t start = 0; start < audio_buffer_size; start += SE_BLOCK_SIZE) {
+        uint32_t length = MIN((uint32_t)SE_BLOCK_SIZE, audio_buffer_size - start);
+
+        for(uint32_t i = 0; i < length; ++i) {
+            mix[i] = WAVE_AMP * 2;
+        }
+
+        for(uint32_t chan = 0; chan < NUM_CHANNELS; ++chan) {
+            SoundEngineChannel* channel = &sound_engine->channel[chan];
+
+            if(channel->frequency == 0) continue;
+
+            sound_engine_osc_block(sound_engine, channel, channel_output, length);
+            sound_engine_adsr_block(
+                channel_output, length, sound_engine, &channel->adsr, &channel->flags);
+
+            if((channel->flags & SE_ENABLE_FILTER) && channel->filter_mode != 0) {
+                sound_engine_filter_block(
+                    &channel->filter, channel->filter_mode, channel_output, length);
+            }
+
+            for(uint32_t i = 0; i < length; ++i) {
+                mix[i] += channel_output[i];
+            }
+        }
+
+        for(uint32_t i = 0; i < length; ++i) {
+            audio_buffer[start + i] = mix[i] >> 8;
+        }
+    }
+}
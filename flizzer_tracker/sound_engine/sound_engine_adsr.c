@@ -56,4 +56,101 @@ int32_t sound_engine_cycle_and_output_adsr(
 
     return (int32_t)((int32_t)input * (int32_t)(adsr->envelope >> 10) / (int32_t)(MAX_ADSR >> 10) *
                      (int32_t)adsr->volume / (int32_t)MAX_ADSR_VOLUME);
-}
\ No newline at end of file
+}
+
+// moves the envelope `steps` samples forward, exactly like `steps` calls of
+// sound_engine_cycle_and_output_adsr() would, but jumping over each linear segment at once
+void sound_engine_advance_adsr(
+    SoundEngine* eng,
+    SoundEngineADSR* adsr,
+    uint16_t* flags,
+    uint32_t steps) {
+    while(steps > 0) {
+        uint32_t speed = adsr->envelope_speed;
+        uint32_t linear_steps = 0; // steps before the state changes
+
+        switch(adsr->envelope_state) {
+        case ATTACK: {
+            if(adsr->envelope < MAX_ADSR) {
+                if(speed == 0) return;
+                linear_steps = (MAX_ADSR - adsr->envelope - 1) / speed;
+            }
+
+            if(steps <= linear_steps) {
+                adsr->envelope += steps * speed;
+                return;
+            }
+
+            adsr->envelope += linear_steps * speed;
+            break;
+        }
+
+        case DECAY: {
+            uint32_t sustain = (uint32_t)adsr->s << 17;
+
+            if(adsr->envelope > sustain + speed) {
+                if(speed == 0) return;
+                linear_steps = (adsr->envelope - sustain - speed - 1) / speed + 1;
+            }
+
+            if(steps <= linear_steps) {
+                adsr->envelope -= steps * speed;
+                return;
+            }
+
+            adsr->envelope -= linear_steps * speed;
+            break;
+        }
+
+        case RELEASE: {
+            if(adsr->envelope > speed) {
+                if(speed == 0) return;
+                linear_steps = (adsr->envelope - speed - 1) / speed + 1;
+            }
+
+            if(steps <= linear_steps) {
+                adsr->envelope -= steps * speed;
+                return;
+            }
+
+            adsr->envelope -= linear_steps * speed;
+            break;
+        }
+
+        default: // sustain and done: nothing moves
+        {
+            return;
+        }
+        }
+
+        // the next step changes the state
+        sound_engine_cycle_and_output_adsr(0, eng, adsr, flags);
+        steps -= linear_steps + 1;
+    }
+}
+
+// applies the envelope and volume to `length` samples. the envelope is advanced once per block and
+// linearly interpolated in between, which is exact except for the blocks where the state changes
+void sound_engine_adsr_block(
+    int32_t* buffer,
+    uint32_t length,
+    SoundEngine* eng,
+    SoundEngineADSR* adsr,
+    uint16_t* flags) {
+    if(length == 0) return;
+
+    int32_t start = adsr->envelope;
+    sound_engine_advance_adsr(eng, adsr, flags, length);
+    int32_t delta = (int32_t)adsr->envelope - start;
+    int32_t volume = adsr->volume;
+
+    // 16.16 fixed point step, so there is a single 64-bit division per block
+    int64_t step = ((int64_t)delta << 16) / (int32_t)length;
+
+    for(uint32_t i = 0; i < length; ++i) {
+        uint32_t envelope = start + (int32_t)((step * (int32_t)(i + 1)) >> 16);
+
+        buffer[i] = (int32_t)((int32_t)buffer[i] * (int32_t)(envelope >> 10) /
+                              (int32_t)(MAX_ADSR >> 10) * volume / (int32_t)MAX_ADSR_VOLUME);
+    }
+}
@@ -6,4 +6,15 @@ int32_t sound_engine_cycle_and_output_adsr(
     int32_t input,
     SoundEngine* eng,
     SoundEngineADSR* adsr,
+    uint16_t* flags);
+void sound_engine_advance_adsr(
+    SoundEngine* eng,
+    SoundEngineADSR* adsr,
+    uint16_t* flags,
+    uint32_t steps);
+void sound_engine_adsr_block(
+    int32_t* buffer,
+    uint32_t length,
+    SoundEngine* eng,
+    SoundEngineADSR* adsr,
     uint16_t* flags);
\ No newline at end of file
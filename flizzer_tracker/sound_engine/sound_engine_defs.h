@@ -17,6 +17,8 @@
 #define SINE_LUT_SIZE 256
 #define SINE_LUT_BITDEPTH 8
 
+#define SE_BLOCK_SIZE 32 // samples rendered at once by the block renderer
+
 #define MAX_ADSR (0xff << 17)
 #define MAX_ADSR_VOLUME 0x80
 #define BASE_FREQ 22050
@@ -25,4 +25,76 @@ int32_t sound_engine_output_highpass(SoundEngineFilter* flt) {
 
 int32_t sound_engine_output_bandpass(SoundEngineFilter* flt) {
     return flt->band * 8;
-}
\ No newline at end of file
+}
+
+// filters `length` samples in place. same as sound_engine_filter_cycle() and the output mode
+// switch for every sample, but the mode is resolved once into masks selecting the outputs to sum
+void sound_engine_filter_block(
+    SoundEngineFilter* flt,
+    uint8_t filter_mode,
+    int32_t* buffer,
+    uint32_t length) {
+    int32_t low_mask = 0, high_mask = 0, band_mask = 0;
+
+    switch(filter_mode) {
+    case FIL_OUTPUT_LOWPASS: {
+        low_mask = -1;
+        break;
+    }
+
+    case FIL_OUTPUT_HIGHPASS: {
+        high_mask = -1;
+        break;
+    }
+
+    case FIL_OUTPUT_BANDPASS: {
+        band_mask = -1;
+        break;
+    }
+
+    case FIL_OUTPUT_LOW_HIGH: {
+        low_mask = high_mask = -1;
+        break;
+    }
+
+    case FIL_OUTPUT_HIGH_BAND: {
+        high_mask = band_mask = -1;
+        break;
+    }
+
+    case FIL_OUTPUT_LOW_BAND: {
+        low_mask = band_mask = -1;
+        break;
+    }
+
+    case FIL_OUTPUT_LOW_HIGH_BAND: {
+        low_mask = high_mask = band_mask = -1;
+        break;
+    }
+
+    default: // unknown mode: the per sample path runs the filter but leaves the signal as is
+    {
+        for(uint32_t i = 0; i < length; ++i) {
+            sound_engine_filter_cycle(flt, buffer[i]);
+        }
+
+        return;
+    }
+    }
+
+    int32_t cutoff = flt->cutoff, resonance = flt->resonance;
+    int32_t low = flt->low, high = flt->high, band = flt->band;
+
+    for(uint32_t i = 0; i < length; ++i) {
+        int32_t input = buffer[i] / 8;
+        low = low + ((cutoff * band) >> 16);
+        high = input - low - (((256 - resonance) * band) >> 8);
+        band = ((cutoff * high) >> 16) + band;
+
+        buffer[i] = (low & low_mask) * 8 + (high & high_mask) * 8 + (band & band_mask) * 8;
+    }
+
+    flt->low = low;
+    flt->high = high;
+    flt->band = band;
+}
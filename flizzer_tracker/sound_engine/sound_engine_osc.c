@@ -275,4 +275,86 @@ uint16_t
     }
 
     return WAVE_AMP / 2;
-}
\ No newline at end of file
+}
+
+// renders `length` samples of the channel oscillator (already centered around zero) into `output`,
+// advancing the phase accumulator like `length` calls of sound_engine_osc() would. the waveform is
+// resolved once, so the common single waveforms get their own inner loop
+void sound_engine_osc_block(
+    SoundEngine* sound_engine,
+    SoundEngineChannel* channel,
+    int32_t* output,
+    uint32_t length) {
+    uint32_t acc = channel->accumulator;
+    const uint32_t frequency = channel->frequency;
+    uint8_t sync_bit = channel->sync_bit;
+
+    switch(channel->waveform) {
+    case SE_WAVEFORM_PULSE: {
+        const uint32_t pw = (channel->pw == 0xfff ? channel->pw + 1 : channel->pw) << 4;
+
+        for(uint32_t i = 0; i < length; ++i) {
+            acc += frequency;
+            sync_bit |= (acc & ACC_LENGTH);
+            acc &= ACC_LENGTH - 1;
+            output[i] = ((acc >> ((uint32_t)ACC_BITS - 17)) >= pw ? (WAVE_AMP - 1) : 0) -
+                        WAVE_AMP / 2;
+        }
+
+        break;
+    }
+
+    case SE_WAVEFORM_TRIANGLE: {
+        for(uint32_t i = 0; i < length; ++i) {
+            acc += frequency;
+            sync_bit |= (acc & ACC_LENGTH);
+            acc &= ACC_LENGTH - 1;
+            output[i] = sound_engine_triangle(acc) - WAVE_AMP / 2;
+        }
+
+        break;
+    }
+
+    case SE_WAVEFORM_SAW: {
+        for(uint32_t i = 0; i < length; ++i) {
+            acc += frequency;
+            sync_bit |= (acc & ACC_LENGTH);
+            acc &= ACC_LENGTH - 1;
+            output[i] = sound_engine_saw(acc) - WAVE_AMP / 2;
+        }
+
+        break;
+    }
+
+    case SE_WAVEFORM_SINE: {
+        for(uint32_t i = 0; i < length; ++i) {
+            acc += frequency;
+            sync_bit |= (acc & ACC_LENGTH);
+            acc &= ACC_LENGTH - 1;
+            output[i] = sound_engine_sine(acc, sound_engine) - WAVE_AMP / 2;
+        }
+
+        break;
+    }
+
+    default: // noise and waveform combinations: the noise LFSR lives in the channel
+    {
+        channel->sync_bit = sync_bit;
+
+        for(uint32_t i = 0; i < length; ++i) {
+            uint32_t prev_acc = channel->accumulator;
+
+            channel->accumulator += frequency;
+            channel->sync_bit |= (channel->accumulator & ACC_LENGTH);
+            channel->accumulator &= ACC_LENGTH - 1;
+
+            output[i] = sound_engine_osc(sound_engine, channel, prev_acc) - WAVE_AMP / 2;
+        }
+
+        return;
+    }
+    }
+
+    channel->accumulator = acc;
+    channel->sync_bit = sync_bit;
+}
@@ -0,0 +1,259 @@
+// Offline renderer: plays a .fzt song through the tracker and sound engines on the host and
+// writes it to a WAV file, timing the buffer fill in cycles per sample. The song is rendered a
+// second time with the per-sample path (the renderer before the block engine) and both outputs
+// are compared sample by sample.
+//
+//   make -C flizzer_tracker/test run
+//   ./fzt_render [song.fzt] [out.wav]
+//
+// Without a song a built-in four channel demo is used.
+
+#include "../sound_engine/sound_engine.c"
+#include "../tracker_engine/diskop.h"
+#include "../tracker_engine/tracker_engine.h"
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COUNTER_UNIT "cycles"
+static uint64_t counter(void) {
+    return __rdtsc();
+}
+#else
+#define COUNTER_UNIT "ns"
+static uint64_t counter(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#endif
+
+#define SAMPLE_RATE 44100
+#define HALF_BUFFER 512 // the app fills half of its 1024 sample DMA buffer at a time
+#define MAX_SECONDS 300 // looping songs never stop on their own
+#define TAIL_SECONDS 1 // let the release of the last notes ring out
+
+typedef struct {
+    SoundEngine sound_engine;
+    TrackerEngine tracker_engine;
+    uint16_t* out;
+    uint32_t length;
+    uint64_t fill_time;
+} Render;
+
+static void demo_step(TrackerSong* song, uint8_t pattern, uint8_t row, uint8_t note, uint8_t inst) {
+    TrackerSongPatternStep* step = &song->pattern[pattern].step[row];
+    set_note(step, note);
+    set_instrument(step, inst);
+}
+
+// four channels: a filtered pulse lead with vibrato, a saw bass, a triangle pad and noise drums
+static void demo_song(TrackerSong* song) {
+    memset(song, 0, sizeof(TrackerSong));
+    strcpy(song->song_name, "host demo");
+    song->speed = 6;
+    song->rate = 50;
+    song->pattern_length = 64;
+    song->num_patterns = 4;
+    song->num_instruments = 4;
+
+    static const uint8_t waveforms[4] = {
+        SE_WAVEFORM_PULSE, SE_WAVEFORM_SAW, SE_WAVEFORM_TRIANGLE, SE_WAVEFORM_NOISE};
+
+    for(uint8_t i = 0; i < song->num_instruments; i++) {
+        Instrument* inst = malloc(sizeof(Instrument));
+        set_default_instrument(inst);
+        inst->waveform = waveforms[i];
+        inst->adsr.a = 0x04 + i * 0x10;
+        inst->adsr.d = 0x30;
+        inst->adsr.s = i == 3 ? 0 : 0x60;
+        inst->adsr.r = 0x20 + i * 0x08;
+        song->instrument[i] = inst;
+    }
+
+    song->instrument[0]->sound_engine_flags |= SE_ENABLE_FILTER;
+    song->instrument[0]->filter_cutoff = 0x60;
+    song->instrument[0]->filter_resonance = 0x80;
+    song->instrument[1]->flags &= ~TE_ENABLE_VIBRATO;
+    song->instrument[3]->flags &= ~TE_ENABLE_VIBRATO;
+
+    for(uint8_t p = 0; p < song->num_patterns; p++) {
+        song->pattern[p].step = malloc(sizeof(TrackerSongPatternStep) * song->pattern_length);
+        set_empty_pattern(&song->pattern[p], song->pattern_length);
+    }
+
+    static const uint8_t lead[8] = {0, 3, 7, 12, 10, 7, 3, 5};
+
+    for(uint8_t row = 0; row < 64; row++) {
+        if(row % 4 == 0) demo_step(song, 0, row, MIDDLE_C + lead[(row / 4) % 8], 0);
+        if(row % 4 == 3) demo_step(song, 0, row, MUS_NOTE_RELEASE, MUS_NOTE_INSTRUMENT_NONE);
+        if(row % 8 == 0) demo_step(song, 1, row, MIDDLE_C - 24 + (row / 16) * 5, 1);
+        if(row % 8 == 6) demo_step(song, 1, row, MUS_NOTE_RELEASE, MUS_NOTE_INSTRUMENT_NONE);
+        if(row % 32 == 0) demo_step(song, 2, row, MIDDLE_C + (row ? 5 : 0), 2);
+        if(row % 32 == 28) demo_step(song, 2, row, MUS_NOTE_RELEASE, MUS_NOTE_INSTRUMENT_NONE);
+        if(row % 4 == 0) demo_step(song, 3, row, MIDDLE_C + 24 + (row % 16 ? 0 : 12), 3);
+    }
+
+    song->num_sequence_steps = 4;
+
+    for(uint8_t s = 0; s < song->num_sequence_steps; s++) {
+        for(uint8_t chan = 0; chan < SONG_MAX_CHANNELS; chan++) {
+            song->sequence.sequence_step[s].pattern_indices[chan] = chan;
+        }
+    }
+}
+
+static bool load_song_file(TrackerSong* song, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if(!f) return false;
+
+    memset(song, 0, sizeof(TrackerSong));
+    load_song(song, (Stream*)f);
+    fclose(f);
+
+    return song->num_sequence_steps > 0 && song->pattern_length > 0 && song->rate > 0;
+}
+
+// what init_tracker() and play_song() do, minus the hardware
+static void render(Render* r, TrackerSong* song, bool per_sample) {
+    memset(r, 0, sizeof(Render));
+    sound_engine_init(&r->sound_engine, SAMPLE_RATE, false, HALF_BUFFER * 2);
+    tracker_engine_init(&r->tracker_engine, song->rate, &r->sound_engine);
+    tracker_engine_set_song(&r->tracker_engine, song);
+    r->tracker_engine.master_volume = 0x80;
+    r->tracker_engine.playing = true;
+
+    uint32_t capacity = SAMPLE_RATE * (MAX_SECONDS + TAIL_SECONDS);
+    uint32_t tail = SAMPLE_RATE * TAIL_SECONDS;
+    uint32_t samples_per_tick = SAMPLE_RATE / song->rate;
+    r->out = malloc(capacity * sizeof(r->out[0]));
+
+    // the tick timer has the higher priority, so it lands between any two samples
+    while(r->length + samples_per_tick <= capacity && (r->tracker_engine.playing || tail > 0)) {
+        if(r->tracker_engine.playing) {
+            tracker_engine_advance_tick(&r->tracker_engine);
+        } else {
+            tail -= MIN(tail, samples_per_tick);
+        }
+
+        for(uint32_t done = 0; done < samples_per_tick;) {
+            uint32_t length = MIN((uint32_t)HALF_BUFFER, samples_per_tick - done);
+            uint16_t* out = &r->out[r->length + done];
+
+            uint64_t start = counter();
+
+            if(per_sample) {
+                sound_engine_fill_buffer_per_sample(&r->sound_engine, out, length);
+            } else {
+                sound_engine_fill_buffer(&r->sound_engine, out, length);
+            }
+
+            r->fill_time += counter() - start;
+            done += length;
+        }
+
+        r->length += samples_per_tick;
+    }
+
+    free(r->sound_engine.audio_buffer);
+}
+
+static void put16(FILE* f, uint16_t v) {
+    fputc(v & 0xff, f);
+    fputc(v >> 8, f);
+}
+
+static void put32(FILE* f, uint32_t v) {
+    put16(f, v & 0xffff);
+    put16(f, v >> 16);
+}
+
+// the engine output is an unsigned PWM value centered on WAVE_AMP * 2 >> 8
+static bool write_wav(const char* path, const Render* r) {
+    FILE* f = fopen(path, "wb");
+    if(!f) return false;
+
+    const int32_t center = WAVE_AMP * 2 >> 8;
+
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + r->length * 2);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1); // PCM
+    put16(f, 1); // mono
+    put32(f, SAMPLE_RATE);
+    put32(f, SAMPLE_RATE * 2);
+    put16(f, 2);
+    put16(f, 16);
+    fwrite("data", 1, 4, f);
+    put32(f, r->length * 2);
+
+    for(uint32_t i = 0; i < r->length; i++) {
+        int32_t v = ((int32_t)r->out[i] - center) * 32767 / center;
+        put16(f, (uint16_t)(int16_t)MAX(-32768, MIN(32767, v)));
+    }
+
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    static TrackerSong song;
+    static Render block, reference;
+
+    if(argc > 1) {
+        if(!load_song_file(&song, argv[1])) {
+            fprintf(stderr, "can't load %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        demo_song(&song);
+    }
+
+    const char* wav = argc > 2 ? argv[2] : "fzt_render.wav";
+
+    render(&block, &song, false);
+    render(&reference, &song, true);
+
+    uint32_t differ = 0, max_diff = 0;
+
+    for(uint32_t i = 0; i < block.length; i++) {
+        uint32_t d = abs((int32_t)block.out[i] - (int32_t)reference.out[i]);
+        if(d) differ++;
+        if(d > max_diff) max_diff = d;
+    }
+
+    printf(
+        "%s: %lu samples (%.1f s) at %d Hz, %d ticks/s\n",
+        song.song_name,
+        (unsigned long)block.length,
+        (double)block.length / SAMPLE_RATE,
+        SAMPLE_RATE,
+        song.rate);
+    printf(
+        "block renderer      %7.1f %s/sample\n",
+        (double)block.fill_time / block.length,
+        COUNTER_UNIT);
+    printf(
+        "per-sample renderer %7.1f %s/sample\n",
+        (double)reference.fill_time / reference.length,
+        COUNTER_UNIT);
+    printf(
+        "%lu samples differ (%.3f%%), max difference %lu of %d\n",
+        (unsigned long)differ,
+        100.0 * differ / block.length,
+        (unsigned long)max_diff,
+        WAVE_AMP * 4 >> 8);
+
+    if(!write_wav(wav, &block)) {
+        fprintf(stderr, "can't write %s\n", wav);
+        return 1;
+    }
+
+    printf("written %s\n", wav);
+
+    free(block.out);
+    free(reference.out);
+    tracker_engine_deinit_song(&song, false);
+    return 0;
+}
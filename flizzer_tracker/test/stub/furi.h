@@ -0,0 +1,16 @@
+#pragma once
+
+// Just enough of furi for the sound and tracker engines to build on the host.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#define furi_assert(x) (void)(x)
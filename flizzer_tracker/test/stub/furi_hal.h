@@ -0,0 +1,38 @@
+#pragma once
+
+// The engines only register interrupts and release the speaker, both are no-ops here.
+// The timers and the DMA are driven by the renderer instead, see fzt_render.c.
+
+#include <furi.h>
+
+typedef enum {
+    FuriHalInterruptIdDma1Ch1,
+    FuriHalInterruptIdTIM2,
+} FuriHalInterruptId;
+
+typedef void (*FuriHalInterruptISR)(void* context);
+
+static inline void
+    furi_hal_interrupt_set_isr(FuriHalInterruptId index, FuriHalInterruptISR isr, void* context) {
+    UNUSED(index);
+    UNUSED(isr);
+    UNUSED(context);
+}
+
+static inline void furi_hal_interrupt_set_isr_ex(
+    FuriHalInterruptId index,
+    uint16_t priority,
+    FuriHalInterruptISR isr,
+    void* context) {
+    UNUSED(index);
+    UNUSED(priority);
+    UNUSED(isr);
+    UNUSED(context);
+}
+
+static inline bool furi_hal_speaker_is_mine(void) {
+    return false;
+}
+
+static inline void furi_hal_speaker_release(void) {
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <furi.h>
+
+typedef struct {
+    uint32_t pin;
+} GpioPin;
+
+typedef enum { GpioModeAnalog } GpioMode;
+typedef enum { GpioPullNo } GpioPull;
+typedef enum { GpioSpeedLow } GpioSpeed;
+
+static inline void
+    furi_hal_gpio_init(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed) {
+    UNUSED(gpio);
+    UNUSED(mode);
+    UNUSED(pull);
+    UNUSED(speed);
+}
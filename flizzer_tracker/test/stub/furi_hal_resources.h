@@ -0,0 +1,5 @@
+#pragma once
+
+#include <furi_hal_gpio.h>
+
+static const GpioPin gpio_ext_pa6 = {6};
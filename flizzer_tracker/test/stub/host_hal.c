@@ -0,0 +1,41 @@
+// Host replacements for flizzer_tracker_hal.c and the file stream. The hardware is never touched:
+// fzt_render.c calls the tracker tick and the buffer fill itself.
+
+#include "../../flizzer_tracker_hal.h"
+#include <toolbox/stream/file_stream.h>
+
+size_t stream_read(Stream* stream, uint8_t* data, size_t size) {
+    return fread(data, 1, size, (FILE*)stream);
+}
+
+void sound_engine_init_hardware(
+    uint32_t sample_rate,
+    bool external_audio_output,
+    uint16_t* audio_buffer,
+    uint32_t audio_buffer_size) {
+    UNUSED(sample_rate);
+    UNUSED(external_audio_output);
+    UNUSED(audio_buffer);
+    UNUSED(audio_buffer_size);
+}
+
+void tracker_engine_init_hardware(uint8_t rate) {
+    UNUSED(rate);
+}
+
+void sound_engine_dma_isr(void* ctx) {
+    UNUSED(ctx);
+}
+
+void tracker_engine_timer_isr(void* ctx) {
+    UNUSED(ctx);
+}
+
+void sound_engine_stop() {
+}
+
+void sound_engine_deinit_timer() {
+}
+
+void tracker_engine_stop() {
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+// Only needed for flizzer_tracker_hal.h to parse, nothing is used.
@@ -0,0 +1,9 @@
+#pragma once
+
+// The renderer loads songs straight from a host file, see stream_read() in host_hal.c.
+
+#include <furi.h>
+
+typedef struct Stream Stream;
+
+size_t stream_read(Stream* stream, uint8_t* data, size_t size);
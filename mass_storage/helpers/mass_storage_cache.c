@@ -0,0 +1,271 @@
+#include "mass_storage_cache.h"
+
+#include <core/log.h>
+
+#define TAG "MassStorageCache"
+
+// Cache lines hold a cluster worth of blocks, the usual FAT cluster size is 4KB
+#define CACHE_LINE_BLOCKS (8UL)
+#define CACHE_LINE_SIZE (CACHE_LINE_BLOCKS * SCSI_BLOCK_SIZE)
+#define CACHE_LINES (4)
+
+#define CACHE_LBA_NONE (UINT32_MAX)
+#define CACHE_POS_NONE (UINT64_MAX)
+
+typedef struct {
+    uint32_t lba; // first block of the line, CACHE_LBA_NONE if the line is unused
+    uint32_t last_used;
+    bool dirty;
+    uint8_t* data;
+} CacheLine;
+
+struct MassStorageCache {
+    File* file;
+    uint32_t num_blocks;
+    uint64_t file_pos;
+
+    CacheLine lines[CACHE_LINES];
+    uint32_t use_counter;
+    uint32_t last_write;
+
+    // storage operations issued, for the flush log
+    uint32_t sd_reads;
+    uint32_t sd_writes;
+};
+
+MassStorageCache* mass_storage_cache_alloc(File* file) {
+    MassStorageCache* cache = malloc(sizeof(MassStorageCache));
+    cache->file = file;
+    cache->num_blocks = storage_file_size(file) / SCSI_BLOCK_SIZE;
+    cache->file_pos = CACHE_POS_NONE;
+    for(size_t i = 0; i < CACHE_LINES; i++) {
+        cache->lines[i].lba = CACHE_LBA_NONE;
+        cache->lines[i].dirty = false;
+        cache->lines[i].data = malloc(CACHE_LINE_SIZE);
+    }
+    return cache;
+}
+
+void mass_storage_cache_free(MassStorageCache* cache) {
+    furi_assert(cache);
+    mass_storage_cache_flush(cache);
+    for(size_t i = 0; i < CACHE_LINES; i++) {
+        free(cache->lines[i].data);
+    }
+    free(cache);
+}
+
+uint32_t mass_storage_cache_num_blocks(MassStorageCache* cache) {
+    return cache->num_blocks;
+}
+
+static bool cache_seek(MassStorageCache* cache, uint32_t lba) {
+    uint64_t pos = (uint64_t)lba * SCSI_BLOCK_SIZE;
+    // sequential accesses don't need a seek
+    if(pos == cache->file_pos) return true;
+    if(!storage_file_seek(cache->file, pos, true)) {
+        FURI_LOG_W(TAG, "seek failed");
+        cache->file_pos = CACHE_POS_NONE;
+        return false;
+    }
+    cache->file_pos = pos;
+    return true;
+}
+
+static bool cache_sd_read(MassStorageCache* cache, uint32_t lba, uint16_t count, uint8_t* out) {
+    if(!cache_seek(cache, lba)) return false;
+    uint16_t len = count * SCSI_BLOCK_SIZE;
+    uint16_t read = storage_file_read(cache->file, out, len);
+    cache->file_pos += read;
+    cache->sd_reads++;
+    return read == len;
+}
+
+static bool
+    cache_sd_write(MassStorageCache* cache, uint32_t lba, uint16_t count, const uint8_t* buf) {
+    if(!cache_seek(cache, lba)) return false;
+    uint16_t len = count * SCSI_BLOCK_SIZE;
+    uint16_t written = storage_file_write(cache->file, buf, len);
+    cache->file_pos += written;
+    cache->sd_writes++;
+    return written == len;
+}
+
+static uint16_t cache_line_blocks(MassStorageCache* cache, uint32_t line_lba) {
+    // the last line may be cut short by the end of the image
+    return MIN(CACHE_LINE_BLOCKS, cache->num_blocks - line_lba);
+}
+
+static CacheLine* cache_find(MassStorageCache* cache, uint32_t line_lba) {
+    for(size_t i = 0; i < CACHE_LINES; i++) {
+        if(cache->lines[i].lba == line_lba) {
+            cache->lines[i].last_used = ++cache->use_counter;
+            return &cache->lines[i];
+        }
+    }
+    return NULL;
+}
+
+static bool cache_write_back(MassStorageCache* cache, CacheLine* line) {
+    if(!line->dirty) return true;
+    if(!cache_sd_write(cache, line->lba, cache_line_blocks(cache, line->lba), line->data)) {
+        FURI_LOG_W(TAG, "write back failed lba=%08lX", line->lba);
+        return false;
+    }
+    line->dirty = false;
+    return true;
+}
+
+static CacheLine* cache_fill(MassStorageCache* cache, uint32_t line_lba) {
+    CacheLine* line = &cache->lines[0];
+    for(size_t i = 0; i < CACHE_LINES; i++) {
+        if(cache->lines[i].lba == CACHE_LBA_NONE) {
+            line = &cache->lines[i];
+            break;
+        }
+        if(cache->lines[i].last_used < line->last_used) {
+            line = &cache->lines[i];
+        }
+    }
+
+    if(!cache_write_back(cache, line)) return NULL;
+
+    line->lba = CACHE_LBA_NONE;
+    if(!cache_sd_read(cache, line_lba, cache_line_blocks(cache, line_lba), line->data)) {
+        return NULL;
+    }
+    line->lba = line_lba;
+    line->last_used = ++cache->use_counter;
+    return line;
+}
+
+// Copies the blocks of lba..lba+count held by a line from or to buf
+static void cache_line_copy(
+    CacheLine* line,
+    uint32_t lba,
+    uint16_t count,
+    uint8_t* buf,
+    bool to_line) {
+    uint32_t start = MAX(lba, line->lba);
+    uint32_t end = MIN(lba + count, line->lba + CACHE_LINE_BLOCKS);
+    if(start >= end) return;
+
+    uint8_t* line_data = line->data + (start - line->lba) * SCSI_BLOCK_SIZE;
+    uint8_t* data = buf + (start - lba) * SCSI_BLOCK_SIZE;
+    size_t len = (end - start) * SCSI_BLOCK_SIZE;
+    if(to_line) {
+        memcpy(line_data, data, len);
+    } else {
+        memcpy(data, line_data, len);
+    }
+}
+
+bool mass_storage_cache_read(MassStorageCache* cache, uint32_t lba, uint16_t count, uint8_t* out) {
+    furi_assert(cache);
+    if(lba + count > cache->num_blocks) return false;
+
+    if(count >= CACHE_LINE_BLOCKS) {
+        // bulk reads go straight to the caller in one read, patched with unwritten data
+        if(!cache_sd_read(cache, lba, count, out)) return false;
+        for(size_t i = 0; i < CACHE_LINES; i++) {
+            if(cache->lines[i].dirty) {
+                cache_line_copy(&cache->lines[i], lba, count, out, false);
+            }
+        }
+        return true;
+    }
+
+    while(count) {
+        uint32_t offset = lba % CACHE_LINE_BLOCKS;
+        uint32_t line_lba = lba - offset;
+        uint16_t n = MIN(count, CACHE_LINE_BLOCKS - offset);
+
+        // small reads load the whole line, the rest of it is kept as read-ahead
+        CacheLine* line = cache_find(cache, line_lba);
+        if(!line) line = cache_fill(cache, line_lba);
+        if(!line) return false;
+        memcpy(out, line->data + offset * SCSI_BLOCK_SIZE, n * SCSI_BLOCK_SIZE);
+
+        lba += n;
+        count -= n;
+        out += n * SCSI_BLOCK_SIZE;
+    }
+    return true;
+}
+
+bool mass_storage_cache_write(
+    MassStorageCache* cache,
+    uint32_t lba,
+    uint16_t count,
+    const uint8_t* buf) {
+    furi_assert(cache);
+    if(lba + count > cache->num_blocks) return false;
+
+    if(count >= CACHE_LINE_BLOCKS) {
+        // bulk writes go to the card in one write, cached copies are kept up to date
+        if(!cache_sd_write(cache, lba, count, buf)) return false;
+        for(size_t i = 0; i < CACHE_LINES; i++) {
+            if(cache->lines[i].lba != CACHE_LBA_NONE) {
+                cache_line_copy(&cache->lines[i], lba, count, (uint8_t*)buf, true);
+            }
+        }
+        return true;
+    }
+
+    while(count) {
+        uint32_t offset = lba % CACHE_LINE_BLOCKS;
+        uint32_t line_lba = lba - offset;
+        uint16_t n = MIN(count, CACHE_LINE_BLOCKS - offset);
+
+        // small writes, mostly FAT and directory updates, are coalesced in the cache
+        CacheLine* line = cache_find(cache, line_lba);
+        if(!line) line = cache_fill(cache, line_lba);
+        if(!line) return false;
+        memcpy(line->data + offset * SCSI_BLOCK_SIZE, buf, n * SCSI_BLOCK_SIZE);
+        line->dirty = true;
+
+        lba += n;
+        count -= n;
+        buf += n * SCSI_BLOCK_SIZE;
+    }
+    cache->last_write = furi_get_tick();
+    return true;
+}
+
+bool mass_storage_cache_flush(MassStorageCache* cache) {
+    furi_assert(cache);
+    bool result = true;
+    bool flushed = false;
+
+    // write back in lba order so adjacent lines don't need a seek
+    while(true) {
+        CacheLine* next = NULL;
+        for(size_t i = 0; i < CACHE_LINES; i++) {
+            CacheLine* line = &cache->lines[i];
+            if(line->dirty && (!next || line->lba < next->lba)) {
+                next = line;
+            }
+        }
+        if(!next) break;
+        if(!cache_write_back(cache, next)) {
+            // drop the line rather than retrying it forever
+            next->dirty = false;
+            next->lba = CACHE_LBA_NONE;
+            result = false;
+        }
+        flushed = true;
+    }
+
+    if(flushed) {
+        FURI_LOG_D(TAG, "flush, sd reads %lu writes %lu", cache->sd_reads, cache->sd_writes);
+    }
+    return result;
+}
+
+bool mass_storage_cache_flush_expired(MassStorageCache* cache) {
+    furi_assert(cache);
+    if(furi_get_tick() - cache->last_write < furi_ms_to_ticks(MASS_STORAGE_CACHE_FLUSH_MS)) {
+        return true;
+    }
+    return mass_storage_cache_flush(cache);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <storage/storage.h>
+#include "mass_storage_scsi.h"
+
+// Dirty data is written back once no writes came in for this long
+#define MASS_STORAGE_CACHE_FLUSH_MS (1000)
+
+typedef struct MassStorageCache MassStorageCache;
+
+MassStorageCache* mass_storage_cache_alloc(File* file);
+void mass_storage_cache_free(MassStorageCache* cache);
+
+bool mass_storage_cache_read(MassStorageCache* cache, uint32_t lba, uint16_t count, uint8_t* out);
+bool mass_storage_cache_write(
+    MassStorageCache* cache,
+    uint32_t lba,
+    uint16_t count,
+    const uint8_t* buf);
+
+uint32_t mass_storage_cache_num_blocks(MassStorageCache* cache);
+
+bool mass_storage_cache_flush(MassStorageCache* cache);
+// Flushes if the cache is dirty and MASS_STORAGE_CACHE_FLUSH_MS passed since the last write
+bool mass_storage_cache_flush_expired(MassStorageCache* cache);
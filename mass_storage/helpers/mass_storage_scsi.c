@@ -14,6 +14,7 @@
 #define SCSI_PREVENT_MEDIUM_REMOVAL (0x1E)
 #define SCSI_START_STOP_UNIT (0x1B)
 #define SCSI_WRITE_10 (0x2A)
+#define SCSI_SYNCHRONIZE_CACHE_10 (0x35)
 
 bool scsi_cmd_start(SCSISession* scsi, uint8_t* cmd, uint8_t len) {
     if(!len) {
@@ -246,6 +247,10 @@ bool scsi_cmd_end(SCSISession* scsi) {
         FURI_LOG_D(TAG, "SCSI_PREVENT_MEDIUM_REMOVAL prevent=%d", prevent);
         return !prevent;
     }; break;
+    case SCSI_SYNCHRONIZE_CACHE_10: {
+        FURI_LOG_D(TAG, "SCSI_SYNCHRONIZE_CACHE_10");
+        return scsi->fn.flush(scsi->fn.ctx);
+    }; break;
     case SCSI_START_STOP_UNIT: {
         if(len < 6) return false;
         bool eject = (cmd[4] & 2) != 0;
@@ -20,6 +20,7 @@ typedef struct {
         uint32_t* out_len,
         uint32_t out_cap);
     bool (*write)(void* ctx, uint32_t lba, uint16_t count, uint8_t* buf, uint32_t len);
+    bool (*flush)(void* ctx);
     uint32_t (*num_blocks)(void* ctx);
     void (*eject)(void* ctx);
 } SCSIDeviceFunc;
@@ -3,6 +3,7 @@
 #include "mass_storage_app.h"
 #include "scenes/mass_storage_scene.h"
 #include "helpers/mass_storage_usb.h"
+#include "helpers/mass_storage_cache.h"
 
 #include <furi_hal.h>
 #include <gui/gui.h>
@@ -37,6 +38,7 @@ struct MassStorageApp {
 
     FuriString* file_path;
     File* file;
+    MassStorageCache* cache;
     MassStorage* mass_storage_view;
 
     FuriMutex* usb_mutex;
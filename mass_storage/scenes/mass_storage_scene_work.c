@@ -14,15 +14,14 @@ static bool file_read(
     uint32_t out_cap) {
     MassStorageApp* app = ctx;
     FURI_LOG_T(TAG, "file_read lba=%08lX count=%04X out_cap=%08lX", lba, count, out_cap);
-    if(!storage_file_seek(app->file, lba * SCSI_BLOCK_SIZE, true)) {
-        FURI_LOG_W(TAG, "seek failed");
-        return false;
-    }
-    uint16_t clamp = MIN(out_cap, count * SCSI_BLOCK_SIZE);
-    *out_len = storage_file_read(app->file, out, clamp);
+    uint16_t blocks = MIN(out_cap / SCSI_BLOCK_SIZE, count);
+    furi_mutex_acquire(app->usb_mutex, FuriWaitForever);
+    bool result = mass_storage_cache_read(app->cache, lba, blocks, out);
+    furi_mutex_release(app->usb_mutex);
+    *out_len = result ? blocks * SCSI_BLOCK_SIZE : 0;
     FURI_LOG_T(TAG, "%lu/%lu", *out_len, count * SCSI_BLOCK_SIZE);
     app->bytes_read += *out_len;
-    return *out_len == clamp;
+    return result;
 }
 
 static bool file_write(void* ctx, uint32_t lba, uint16_t count, uint8_t* buf, uint32_t len) {
@@ -32,22 +31,30 @@ static bool file_write(void* ctx, uint32_t lba, uint16_t count, uint8_t* buf, ui
         FURI_LOG_W(TAG, "bad write params count=%u len=%lu", count, len);
         return false;
     }
-    if(!storage_file_seek(app->file, lba * SCSI_BLOCK_SIZE, true)) {
-        FURI_LOG_W(TAG, "seek failed");
-        return false;
-    }
     app->bytes_written += len;
-    return storage_file_write(app->file, buf, len) == len;
+    furi_mutex_acquire(app->usb_mutex, FuriWaitForever);
+    bool result = mass_storage_cache_write(app->cache, lba, count, buf);
+    furi_mutex_release(app->usb_mutex);
+    return result;
+}
+
+static bool file_flush(void* ctx) {
+    MassStorageApp* app = ctx;
+    furi_mutex_acquire(app->usb_mutex, FuriWaitForever);
+    bool result = mass_storage_cache_flush(app->cache);
+    furi_mutex_release(app->usb_mutex);
+    return result;
 }
 
 static uint32_t file_num_blocks(void* ctx) {
     MassStorageApp* app = ctx;
-    return storage_file_size(app->file) / SCSI_BLOCK_SIZE;
+    return mass_storage_cache_num_blocks(app->cache);
 }
 
 static void file_eject(void* ctx) {
     MassStorageApp* app = ctx;
     FURI_LOG_D(TAG, "EJECT");
+    file_flush(app);
     view_dispatcher_send_custom_event(app->view_dispatcher, MassStorageCustomEventEject);
 }
 
@@ -64,6 +71,12 @@ bool mass_storage_scene_work_on_event(void* context, SceneManagerEvent event) {
             }
         }
     } else if(event.type == SceneManagerEventTypeTick) {
+        // write back cached data once the host stopped writing
+        if(app->cache) {
+            furi_mutex_acquire(app->usb_mutex, FuriWaitForever);
+            mass_storage_cache_flush_expired(app->cache);
+            furi_mutex_release(app->usb_mutex);
+        }
         mass_storage_set_stats(app->mass_storage_view, app->bytes_read, app->bytes_written);
     } else if(event.type == SceneManagerEventTypeBack) {
         consumed = scene_manager_search_and_switch_to_previous_scene(
@@ -100,11 +113,13 @@ void mass_storage_scene_work_on_enter(void* context) {
         furi_string_get_cstr(app->file_path),
         FSAM_READ | FSAM_WRITE,
         FSOM_OPEN_EXISTING));
+    app->cache = mass_storage_cache_alloc(app->file);
 
     SCSIDeviceFunc fn = {
         .ctx = app,
         .read = file_read,
         .write = file_write,
+        .flush = file_flush,
         .num_blocks = file_num_blocks,
         .eject = file_eject,
     };
@@ -121,14 +136,18 @@ void mass_storage_scene_work_on_exit(void* context) {
     MassStorageApp* app = context;
     mass_storage_app_show_loading_popup(app, true);
 
-    if(app->usb_mutex) {
-        furi_mutex_free(app->usb_mutex);
-        app->usb_mutex = NULL;
-    }
     if(app->usb) {
         mass_storage_usb_stop(app->usb);
         app->usb = NULL;
     }
+    if(app->cache) {
+        mass_storage_cache_free(app->cache);
+        app->cache = NULL;
+    }
+    if(app->usb_mutex) {
+        furi_mutex_free(app->usb_mutex);
+        app->usb_mutex = NULL;
+    }
     if(app->file) {
         storage_file_free(app->file);
         app->file = NULL;
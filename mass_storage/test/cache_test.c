@@ -0,0 +1,384 @@
+// Drives the block cache with the requests a USB host sends, against a RAM-backed image, and
+// next to the path it replaced (a seek and a read or write on the image for every chunk).
+//
+// Every read is checked against a reference copy of what the host wrote, and after each
+// SYNCHRONIZE CACHE the image itself must match it. 200k random mixed requests run on a small
+// image whose size is not a whole number of cache lines. Then traces of a FAT format, an 8 MB
+// file copy and an fsck-style scan run on a 64 MB FAT16 image, counting the SD operations,
+// seeks included.
+//
+//   make -C mass_storage/test run
+
+#include "../helpers/mass_storage_cache.h"
+
+#define USB_MSC_BUF_MAX (0x10000UL - SCSI_BLOCK_SIZE) // as in mass_storage_usb.c
+#define CHUNK_BLOCKS (USB_MSC_BUF_MAX / SCSI_BLOCK_SIZE)
+#define SCENE_TICK_MS 500
+
+#define RANDOM_BLOCKS (8192 + 3) // 4 MB and a short last cache line
+#define RANDOM_REQUESTS 200000
+
+// 64 MB FAT16 with 4 KB clusters
+#define FAT_BLOCKS (131072)
+#define FAT_RESERVED 4
+#define FAT_SIZE 64 // blocks per FAT, 2 bytes for each of the 16k clusters
+#define FAT_ROOT_BLOCKS 32 // 512 entries
+#define FAT_FAT1 FAT_RESERVED
+#define FAT_FAT2 (FAT_FAT1 + FAT_SIZE)
+#define FAT_ROOT (FAT_FAT2 + FAT_SIZE)
+#define FAT_DATA (FAT_ROOT + FAT_ROOT_BLOCKS)
+#define FAT_CLUSTER_BLOCKS 8
+
+#define COPY_BYTES (8 * 1024 * 1024)
+#define COPY_COMMAND_BLOCKS 240 // the Linux usb-storage max_sectors
+#define COPY_DIR_UPDATE_COMMANDS 8
+
+typedef struct {
+    const char* name;
+    File* file;
+    MassStorageCache* cache; // NULL for the uncached path
+    uint8_t* reference;
+    uint32_t num_blocks;
+    uint8_t buf[USB_MSC_BUF_MAX];
+} Disk;
+
+static uint32_t failures;
+static uint32_t random_state;
+
+static void fail(const Disk* disk, const char* what, uint32_t lba) {
+    if(failures++ < 10) printf("FAIL %s: %s at lba %lu\n", disk->name, what, (unsigned long)lba);
+}
+
+static uint32_t random_next(void) {
+    random_state = random_state * 1103515245 + 12345;
+    return random_state >> 8;
+}
+
+static uint32_t random_below(uint32_t n) {
+    return random_next() % n;
+}
+
+static void disk_init(Disk* disk, const char* name, uint32_t num_blocks, bool cached) {
+    disk->name = name;
+    disk->num_blocks = num_blocks;
+    disk->file = host_file_alloc((uint64_t)num_blocks * SCSI_BLOCK_SIZE);
+    disk->reference = calloc(num_blocks, SCSI_BLOCK_SIZE);
+    disk->cache = cached ? mass_storage_cache_alloc(disk->file) : NULL;
+}
+
+static void disk_free(Disk* disk) {
+    if(disk->cache) mass_storage_cache_free(disk->cache);
+    host_file_free(disk->file);
+    free(disk->reference);
+}
+
+// file_read() and file_write() of the work scene, before and after the cache
+static bool disk_read_chunk(Disk* disk, uint32_t lba, uint16_t count, uint8_t* out) {
+    if(disk->cache) return mass_storage_cache_read(disk->cache, lba, count, out);
+
+    if(!storage_file_seek(disk->file, lba * SCSI_BLOCK_SIZE, true)) return false;
+    uint16_t len = count * SCSI_BLOCK_SIZE;
+    return storage_file_read(disk->file, out, len) == len;
+}
+
+static bool disk_write_chunk(Disk* disk, uint32_t lba, uint16_t count, const uint8_t* buf) {
+    if(disk->cache) return mass_storage_cache_write(disk->cache, lba, count, buf);
+
+    if(!storage_file_seek(disk->file, lba * SCSI_BLOCK_SIZE, true)) return false;
+    uint16_t len = count * SCSI_BLOCK_SIZE;
+    return storage_file_write(disk->file, buf, len) == len;
+}
+
+static bool in_range(const Disk* disk, uint32_t lba, uint32_t count) {
+    return lba + count <= disk->num_blocks;
+}
+
+// READ(10): the USB layer hands out the data in buffers of up to CHUNK_BLOCKS
+static void scsi_read(Disk* disk, uint32_t lba, uint32_t count) {
+    bool valid = in_range(disk, lba, count);
+
+    while(count) {
+        uint16_t n = MIN(count, CHUNK_BLOCKS);
+        bool result = disk_read_chunk(disk, lba, n, disk->buf);
+        if(result != valid) {
+            fail(disk, valid ? "read failed" : "read out of range succeeded", lba);
+            return;
+        }
+        if(!valid) return;
+        if(memcmp(disk->buf, disk->reference + (uint64_t)lba * SCSI_BLOCK_SIZE, n * SCSI_BLOCK_SIZE)) {
+            fail(disk, "read data", lba);
+        }
+        lba += n;
+        count -= n;
+    }
+}
+
+// WRITE(10), the data of each block is derived from its lba and the seed
+static void scsi_write(Disk* disk, uint32_t lba, uint32_t count, uint32_t seed) {
+    bool valid = in_range(disk, lba, count);
+
+    while(count) {
+        uint16_t n = MIN(count, CHUNK_BLOCKS);
+        for(uint32_t i = 0; i < n * SCSI_BLOCK_SIZE / 4; i++) {
+            uint32_t v = (lba * 0x9e3779b9u) ^ (seed * 0x85ebca6bu) ^ (i * 0xc2b2ae35u);
+            memcpy(disk->buf + i * 4, &v, 4);
+        }
+
+        bool result = disk_write_chunk(disk, lba, n, disk->buf);
+        if(result != valid) {
+            fail(disk, valid ? "write failed" : "write out of range succeeded", lba);
+            return;
+        }
+        if(!valid) return;
+        memcpy(disk->reference + (uint64_t)lba * SCSI_BLOCK_SIZE, disk->buf, n * SCSI_BLOCK_SIZE);
+        lba += n;
+        count -= n;
+    }
+}
+
+static void check_image(Disk* disk) {
+    uint64_t size = (uint64_t)disk->num_blocks * SCSI_BLOCK_SIZE;
+    if(memcmp(disk->file->data, disk->reference, size)) {
+        for(uint32_t lba = 0; lba < disk->num_blocks; lba++) {
+            uint64_t at = (uint64_t)lba * SCSI_BLOCK_SIZE;
+            if(memcmp(disk->file->data + at, disk->reference + at, SCSI_BLOCK_SIZE)) {
+                fail(disk, "image after sync", lba);
+                break;
+            }
+        }
+    }
+}
+
+// SYNCHRONIZE CACHE(10), after that the image must hold everything written
+static void scsi_sync(Disk* disk) {
+    if(disk->cache && !mass_storage_cache_flush(disk->cache)) fail(disk, "flush", 0);
+    check_image(disk);
+}
+
+// The host is quiet for ms, the scene tick writes back once the writes stopped for a second
+static void idle(Disk* disk, uint32_t ms) {
+    for(uint32_t t = 0; t < ms; t += SCENE_TICK_MS) {
+        host_tick += SCENE_TICK_MS;
+        if(disk->cache && !mass_storage_cache_flush_expired(disk->cache)) fail(disk, "flush", 0);
+    }
+}
+
+static uint32_t random_lba(const Disk* disk) {
+    switch(random_below(4)) {
+    case 0:
+        return random_below(64); // FAT and directory area
+    case 1:
+        return disk->num_blocks - 1 - random_below(16); // short last line
+    default:
+        return random_below(disk->num_blocks);
+    }
+}
+
+static uint32_t random_count(void) {
+    switch(random_below(10)) {
+    case 0:
+    case 1:
+        return 8 + random_below(CHUNK_BLOCKS * 3); // bulk, over several chunks
+    case 2:
+        return 8 * (1 + random_below(4)); // whole cache lines
+    default:
+        return 1 + random_below(7);
+    }
+}
+
+static void test_random(void) {
+    Disk disk;
+    disk_init(&disk, "random", RANDOM_BLOCKS, true);
+    random_state = 1;
+    uint32_t syncs = 0;
+
+    // start from a filled image, so reads of unwritten blocks are checked too
+    for(uint32_t lba = 0; lba < disk.num_blocks; lba += CHUNK_BLOCKS) {
+        scsi_write(&disk, lba, MIN(CHUNK_BLOCKS, disk.num_blocks - lba), 0);
+    }
+    scsi_sync(&disk);
+
+    for(uint32_t request = 1; request <= RANDOM_REQUESTS; request++) {
+        uint32_t kind = random_below(100);
+        uint32_t lba = random_lba(&disk);
+        uint32_t count = random_count();
+
+        if(kind < 2) {
+            // past the end, must fail without touching anything
+            scsi_read(&disk, disk.num_blocks - random_below(4), count + 4);
+        } else if(kind < 4) {
+            scsi_write(&disk, disk.num_blocks - random_below(4), count + 4, request);
+        } else if(kind < 6) {
+            scsi_sync(&disk);
+            syncs++;
+        } else if(kind < 8) {
+            idle(&disk, random_below(2000));
+        } else if(kind < 54) {
+            scsi_read(&disk, lba, MIN(count, disk.num_blocks - lba));
+        } else {
+            scsi_write(&disk, lba, MIN(count, disk.num_blocks - lba), request);
+        }
+    }
+
+    scsi_sync(&disk);
+    printf(
+        "random: %u requests and %lu syncs on %lu blocks, %lu SD reads, %lu writes\n",
+        RANDOM_REQUESTS,
+        (unsigned long)syncs,
+        (unsigned long)disk.num_blocks,
+        (unsigned long)disk.file->reads,
+        (unsigned long)disk.file->writes);
+    disk_free(&disk);
+}
+
+// A failed write back must be reported by SYNCHRONIZE CACHE, not dropped silently
+static void test_write_back_error(void) {
+    Disk disk;
+    disk_init(&disk, "write back error", RANDOM_BLOCKS, true);
+
+    scsi_write(&disk, 10, 1, 1);
+    disk.file->fail_writes_after = disk.file->writes + 1;
+    if(mass_storage_cache_flush(disk.cache)) fail(&disk, "flush reported success", 10);
+
+    disk.file->fail_writes_after = 0;
+    disk_free(&disk);
+}
+
+static void fat_update(Disk* disk, uint32_t cluster, uint32_t seed) {
+    // a FAT16 sector covers 256 clusters, both FATs are kept in step
+    uint32_t sector = cluster / 256;
+    scsi_write(disk, FAT_FAT1 + sector, 1, seed);
+    scsi_write(disk, FAT_FAT2 + sector, 1, seed);
+}
+
+// mkfs.fat: boot sector and reserved area, both FATs and the root directory, each in one go
+static void trace_format(Disk* disk) {
+    scsi_read(disk, 0, 1);
+    scsi_write(disk, 0, 1, 1);
+    for(uint32_t lba = 1; lba < FAT_RESERVED; lba++) {
+        scsi_write(disk, lba, 1, 1);
+    }
+    scsi_write(disk, FAT_FAT1, FAT_SIZE, 2);
+    scsi_write(disk, FAT_FAT2, FAT_SIZE, 2);
+    scsi_write(disk, FAT_ROOT, FAT_ROOT_BLOCKS, 3);
+    scsi_sync(disk);
+    // the host mounts it right away
+    scsi_read(disk, 0, 1);
+    scsi_read(disk, FAT_FAT1, 1);
+    scsi_read(disk, FAT_ROOT, 1);
+}
+
+// A file copied with a sync mount: data in max_sectors commands, the FAT entries of the
+// clusters just written after each command and the directory entry every few commands
+static void trace_copy(Disk* disk) {
+    for(uint32_t lba = FAT_ROOT; lba < FAT_ROOT + 4; lba++) {
+        scsi_read(disk, lba, 1);
+    }
+    scsi_write(disk, FAT_ROOT + 1, 1, 1); // new directory entry
+
+    uint32_t blocks = COPY_BYTES / SCSI_BLOCK_SIZE;
+    uint32_t first_cluster = 16;
+    uint32_t commands = 0;
+
+    for(uint32_t done = 0; done < blocks; done += COPY_COMMAND_BLOCKS) {
+        uint32_t n = MIN(COPY_COMMAND_BLOCKS, blocks - done);
+        uint32_t lba = FAT_DATA + first_cluster * FAT_CLUSTER_BLOCKS + done;
+        scsi_write(disk, lba, n, 10 + done);
+
+        uint32_t cluster = first_cluster + done / FAT_CLUSTER_BLOCKS;
+        uint32_t last = first_cluster + (done + n - 1) / FAT_CLUSTER_BLOCKS;
+        fat_update(disk, cluster, 10 + done);
+        if(last / 256 != cluster / 256) fat_update(disk, last, 10 + done);
+
+        if(++commands % COPY_DIR_UPDATE_COMMANDS == 0) {
+            scsi_write(disk, FAT_ROOT + 1, 1, 10 + done); // size and modification time
+        }
+    }
+
+    scsi_write(disk, FAT_ROOT + 1, 1, 2);
+    scsi_sync(disk);
+}
+
+// fsck.fat -n reading the FATs and the root directory a sector at a time
+static void trace_fsck(Disk* disk) {
+    scsi_read(disk, 0, 1);
+    for(uint32_t lba = FAT_FAT1; lba < FAT_ROOT + FAT_ROOT_BLOCKS; lba++) {
+        scsi_read(disk, lba, 1);
+    }
+    // and the clusters of a few subdirectories
+    for(uint32_t dir = 0; dir < 32; dir++) {
+        uint32_t lba = FAT_DATA + (dir * 97 % 2048) * FAT_CLUSTER_BLOCKS;
+        for(uint32_t i = 0; i < FAT_CLUSTER_BLOCKS; i++) {
+            scsi_read(disk, lba + i, 1);
+        }
+    }
+}
+
+typedef struct {
+    const char* name;
+    void (*run)(Disk* disk);
+} Trace;
+
+static const Trace traces[] = {
+    {"format", trace_format},
+    {"8 MB copy", trace_copy},
+    {"fsck", trace_fsck},
+};
+
+static void test_traces(void) {
+    Disk disks[2];
+    disk_init(&disks[0], "uncached", FAT_BLOCKS, false);
+    disk_init(&disks[1], "cached", FAT_BLOCKS, true);
+
+    printf(
+        "%-10s %-8s %7s %7s %7s %7s %9s %9s\n",
+        "trace",
+        "",
+        "seeks",
+        "reads",
+        "writes",
+        "SD ops",
+        "KB read",
+        "KB written");
+
+    // each trace runs on the image the previous one left, as the host would see it
+    for(size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+        for(int d = 0; d < 2; d++) {
+            Disk* disk = &disks[d];
+            host_file_reset_counters(disk->file);
+            traces[t].run(disk);
+            if(disk->cache && !mass_storage_cache_flush(disk->cache)) fail(disk, "flush", 0);
+
+            const File* file = disk->file;
+            printf(
+                "%-10s %-8s %7lu %7lu %7lu %7lu %9lu %9lu\n",
+                d == 0 ? traces[t].name : "",
+                d == 0 ? "old" : "cache",
+                (unsigned long)file->seeks,
+                (unsigned long)file->reads,
+                (unsigned long)file->writes,
+                (unsigned long)host_file_operations(file),
+                (unsigned long)(file->bytes_read / 1024),
+                (unsigned long)(file->bytes_written / 1024));
+        }
+    }
+
+    for(int d = 0; d < 2; d++) {
+        check_image(&disks[d]);
+        disk_free(&disks[d]);
+    }
+}
+
+int main(void) {
+    test_random();
+    test_write_back_error();
+    test_traces();
+
+    if(failures) {
+        printf("FAILED: %lu checks\n", (unsigned long)failures);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
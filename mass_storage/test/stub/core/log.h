@@ -0,0 +1,12 @@
+#pragma once
+
+static inline void furi_log_print(const char* tag, const char* format, ...) {
+    (void)tag;
+    (void)format;
+}
+
+#define FURI_LOG_E(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_T(tag, ...) furi_log_print(tag, __VA_ARGS__)
@@ -0,0 +1,36 @@
+#pragma once
+
+// Just enough of the Furi API for mass_storage_cache.c on the host
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <core/log.h>
+
+// furi malloc never fails and returns zeroed memory
+#define malloc(size) calloc(1, size)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define UNUSED(x) (void)(x)
+
+#define furi_assert(x) (void)(x)
+
+// The tick is advanced by the test
+extern uint32_t host_tick;
+
+static inline uint32_t furi_get_tick(void) {
+    return host_tick;
+}
+
+static inline uint32_t furi_ms_to_ticks(uint32_t ms) {
+    return ms;
+}
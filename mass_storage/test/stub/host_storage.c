@@ -0,0 +1,58 @@
+#include <storage/storage.h>
+
+uint32_t host_tick;
+
+File* host_file_alloc(uint64_t size) {
+    File* file = calloc(1, sizeof(File));
+    file->data = calloc(1, size);
+    file->size = size;
+    return file;
+}
+
+void host_file_free(File* file) {
+    free(file->data);
+    free(file);
+}
+
+void host_file_reset_counters(File* file) {
+    file->seeks = 0;
+    file->reads = 0;
+    file->writes = 0;
+    file->bytes_read = 0;
+    file->bytes_written = 0;
+}
+
+uint32_t host_file_operations(const File* file) {
+    return file->seeks + file->reads + file->writes;
+}
+
+uint64_t storage_file_size(File* file) {
+    return file->size;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    file->seeks++;
+    uint64_t pos = from_start ? offset : file->pos + offset;
+    if(pos > file->size) return false;
+    file->pos = pos;
+    return true;
+}
+
+uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read) {
+    file->reads++;
+    uint16_t n = MIN(bytes_to_read, file->size - file->pos);
+    memcpy(buff, file->data + file->pos, n);
+    file->pos += n;
+    file->bytes_read += n;
+    return n;
+}
+
+uint16_t storage_file_write(File* file, const void* buff, uint16_t bytes_to_write) {
+    file->writes++;
+    if(file->fail_writes_after && file->writes >= file->fail_writes_after) return 0;
+    uint16_t n = MIN(bytes_to_write, file->size - file->pos);
+    memcpy(file->data + file->pos, buff, n);
+    file->pos += n;
+    file->bytes_written += n;
+    return n;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// A file is a RAM-backed image on the host, every call is counted as one SD operation
+
+#include <furi.h>
+
+typedef struct {
+    uint8_t* data;
+    uint64_t size;
+    uint64_t pos;
+
+    uint32_t seeks;
+    uint32_t reads;
+    uint32_t writes;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+
+    uint32_t fail_writes_after; // 0 never fails
+} File;
+
+File* host_file_alloc(uint64_t size);
+void host_file_free(File* file);
+void host_file_reset_counters(File* file);
+uint32_t host_file_operations(const File* file);
+
+uint64_t storage_file_size(File* file);
+bool storage_file_seek(File* file, uint32_t offset, bool from_start);
+uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read);
+uint16_t storage_file_write(File* file, const void* buff, uint16_t bytes_to_write);
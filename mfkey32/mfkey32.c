@@ -27,6 +27,10 @@
 
 #define MF_CLASSIC_DICT_FLIPPER_PATH EXT_PATH("nfc/assets/mf_classic_dict.nfc")
 #define MF_CLASSIC_DICT_USER_PATH EXT_PATH("nfc/assets/mf_classic_dict_user.nfc")
+#define MF_CLASSIC_DICT_USER_INDEX_PATH EXT_PATH("nfc/assets/mf_classic_dict_user.idx")
+#define MF_CLASSIC_DICT_INDEX_MAGIC (0x3249464D) // "MFI2"
+#define MF_CLASSIC_DICT_INDEX_KEY_LEN (6)
+#define MF_CLASSIC_DICT_INDEX_CHUNK_KEYS (64)
 #define MF_CLASSIC_NONCE_PATH EXT_PATH("nfc/.mfkey32.log")
 #define TAG "Mfkey32"
 #define NFC_MF_CLASSIC_KEY_LEN (13)
@@ -60,6 +64,20 @@ struct Msb {
     int tail;
     uint32_t states[768];
 };
+// Bucket cursors for radix_sort_msb, shared by every old_recover() recursion level
+struct MsbBuckets {
+    int next[256];
+    int end[256];
+};
+// Tables allocated once per batch and reused for every nonce
+struct MfkeyWorkspace {
+    unsigned int* states_buffer;
+    struct Msb* odd_msbs;
+    struct Msb* even_msbs;
+    unsigned int* temp_states_odd;
+    unsigned int* temp_states_even;
+    struct MsbBuckets* buckets;
+};
 
 typedef enum {
     EventTypeTick,
@@ -131,8 +149,21 @@ typedef enum {
 typedef struct {
     Stream* stream;
     uint32_t total_keys;
+    MfClassicDictType type;
+    uint64_t* keys; // Sorted, unique
+    size_t keys_count;
+    size_t keys_capacity;
+    bool index_dirty;
 } MfClassicDict;
 
+// Sidecar index header, followed by keys_count big-endian 48-bit keys in ascending order
+typedef struct {
+    uint32_t magic;
+    uint32_t keys_count;
+    uint32_t dict_size; // Size of the text dictionary the index was built from
+    uint32_t dict_timestamp; // and its modification time
+} MfClassicDictIndexHeader;
+
 static const uint8_t table[256] = {
     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3,
     4, 4, 5, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4,
@@ -328,45 +359,47 @@ static inline int state_loop(unsigned int* states_buffer, int xks, int m1, int m
     return states_tail;
 }
 
-int binsearch(unsigned int data[], int start, int stop) {
-    int mid, val = data[stop] & 0xff000000;
-    while(start != stop) {
-        mid = (stop - start) >> 1;
-        if((data[start + mid] ^ 0x80000000) > (val ^ 0x80000000))
-            stop = start + mid;
-        else
-            start += mid + 1;
-    }
-    return start;
+// Map the top byte so that bucket order matches the signed comparisons used by old_recover()
+static inline int msb_bucket(unsigned int x) {
+    return (x >> 24) ^ 0x80;
 }
-void quicksort(unsigned int array[], int low, int high) {
-    //if (SIZEOF(array) == 0)
-    //    return;
-    if(low >= high) return;
-    int middle = low + (high - low) / 2;
-    unsigned int pivot = array[middle];
-    int i = low, j = high;
-    while(i <= j) {
-        while(array[i] < pivot) {
-            i++;
-        }
-        while(array[j] > pivot) {
-            j--;
-        }
-        if(i <= j) { // swap
-            int temp = array[i];
-            array[i] = array[j];
-            array[j] = temp;
-            i++;
-            j--;
-        }
+
+// In-place American flag sort on the top byte: O(n), no recursion, no extra table
+static void radix_sort_msb(unsigned int data[], int head, int tail, struct MsbBuckets* b) {
+    int i, k, pos;
+    unsigned int v, t;
+    if(head >= tail) return;
+    memset(b->end, 0, sizeof(b->end));
+    for(i = head; i <= tail; i++) {
+        b->end[msb_bucket(data[i])]++;
     }
-    if(low < j) {
-        quicksort(array, low, j);
+    for(pos = head, k = 0; k < 256; k++) {
+        b->next[k] = pos;
+        pos += b->end[k];
+        b->end[k] = pos;
+    }
+    for(k = 0; k < 256; k++) {
+        while(b->next[k] < b->end[k]) {
+            v = data[b->next[k]];
+            i = msb_bucket(v);
+            while(i != k) {
+                t = data[b->next[i]];
+                data[b->next[i]++] = v;
+                v = t;
+                i = msb_bucket(v);
+            }
+            data[b->next[k]++] = v;
+        }
     }
-    if(high > i) {
-        quicksort(array, i, high);
+}
+
+// Merge-join step: first index of the run sharing the top byte of data[stop]
+static inline int msb_run_start(unsigned int data[], int start, int stop) {
+    unsigned int val = data[stop] >> 24;
+    while(stop > start && (data[stop - 1] >> 24) == val) {
+        stop--;
     }
+    return stop;
 }
 int extend_table(unsigned int data[], int tbl, int end, int bit, int m1, int m2) {
     for(data[tbl] <<= 1; tbl <= end; data[++tbl] <<= 1) {
@@ -398,7 +431,8 @@ int old_recover(
     int rem,
     int s,
     struct Crypto1Params* p,
-    int first_run) {
+    int first_run,
+    struct MsbBuckets* buckets) {
     int o, e, i;
     if(rem == -1) {
         for(e = e_head; e <= e_tail; ++e) {
@@ -427,20 +461,21 @@ int old_recover(
         }
     }
     first_run = 0;
-    quicksort(odd, o_head, o_tail);
-    quicksort(even, e_head, e_tail);
+    radix_sort_msb(odd, o_head, o_tail, buckets);
+    radix_sort_msb(even, e_head, e_tail, buckets);
     while(o_tail >= o_head && e_tail >= e_head) {
         if(((odd[o_tail] ^ even[e_tail]) >> 24) == 0) {
-            o_tail = binsearch(odd, o_head, o = o_tail);
-            e_tail = binsearch(even, e_head, e = e_tail);
-            s = old_recover(odd, o_tail--, o, oks, even, e_tail--, e, eks, rem, s, p, first_run);
+            o_tail = msb_run_start(odd, o_head, o = o_tail);
+            e_tail = msb_run_start(even, e_head, e = e_tail);
+            s = old_recover(
+                odd, o_tail--, o, oks, even, e_tail--, e, eks, rem, s, p, first_run, buckets);
             if(s == -1) {
                 break;
             }
-        } else if((odd[o_tail] ^ 0x80000000) > (even[e_tail] ^ 0x80000000)) {
-            o_tail = binsearch(odd, o_head, o_tail) - 1;
+        } else if(msb_bucket(odd[o_tail]) > msb_bucket(even[e_tail])) {
+            o_tail = msb_run_start(odd, o_head, o_tail) - 1;
         } else {
-            e_tail = binsearch(even, e_head, e_tail) - 1;
+            e_tail = msb_run_start(even, e_head, e_tail) - 1;
         }
     }
     return s;
@@ -462,13 +497,14 @@ int calculate_msb_tables(
     int eks,
     int msb_round,
     struct Crypto1Params* p,
-    unsigned int* states_buffer,
-    struct Msb* odd_msbs,
-    struct Msb* even_msbs,
-    unsigned int* temp_states_odd,
-    unsigned int* temp_states_even,
+    struct MfkeyWorkspace* ws,
     ProgramState* program_state) {
     //FURI_LOG_I(TAG, "MSB GO %i", msb_iter); // DEBUG
+    unsigned int* states_buffer = ws->states_buffer;
+    struct Msb* odd_msbs = ws->odd_msbs;
+    struct Msb* even_msbs = ws->even_msbs;
+    unsigned int* temp_states_odd = ws->temp_states_odd;
+    unsigned int* temp_states_even = ws->temp_states_even;
     unsigned int msb_head = (MSB_LIMIT * msb_round); // msb_iter ranges from 0 to (256/MSB_LIMIT)-1
     unsigned int msb_tail = (MSB_LIMIT * (msb_round + 1));
     int states_tail = 0, tail = 0;
@@ -557,7 +593,8 @@ int calculate_msb_tables(
             3,
             0,
             p,
-            1);
+            1,
+            ws->buckets);
         if(res == -1) {
             return 1;
         }
@@ -568,13 +605,33 @@ int calculate_msb_tables(
     return 0;
 }
 
-bool recover(struct Crypto1Params* p, int ks2, ProgramState* program_state) {
+struct MfkeyWorkspace* mfkey_workspace_alloc() {
+    struct MfkeyWorkspace* ws = malloc(sizeof(struct MfkeyWorkspace));
+    ws->states_buffer = malloc(sizeof(unsigned int) * (2 << 9));
+    ws->odd_msbs = (struct Msb*)malloc(MSB_LIMIT * sizeof(struct Msb));
+    ws->even_msbs = (struct Msb*)malloc(MSB_LIMIT * sizeof(struct Msb));
+    ws->temp_states_odd = malloc(sizeof(unsigned int) * (1280));
+    ws->temp_states_even = malloc(sizeof(unsigned int) * (1280));
+    ws->buckets = malloc(sizeof(struct MsbBuckets));
+    return ws;
+}
+
+void mfkey_workspace_free(struct MfkeyWorkspace* ws) {
+    free(ws->states_buffer);
+    free(ws->odd_msbs);
+    free(ws->even_msbs);
+    free(ws->temp_states_odd);
+    free(ws->temp_states_even);
+    free(ws->buckets);
+    free(ws);
+}
+
+bool recover(
+    struct Crypto1Params* p,
+    int ks2,
+    struct MfkeyWorkspace* ws,
+    ProgramState* program_state) {
     bool found = false;
-    unsigned int* states_buffer = malloc(sizeof(unsigned int) * (2 << 9));
-    struct Msb* odd_msbs = (struct Msb*)malloc(MSB_LIMIT * sizeof(struct Msb));
-    struct Msb* even_msbs = (struct Msb*)malloc(MSB_LIMIT * sizeof(struct Msb));
-    unsigned int* temp_states_odd = malloc(sizeof(unsigned int) * (1280));
-    unsigned int* temp_states_even = malloc(sizeof(unsigned int) * (1280));
     int oks = 0, eks = 0;
     int i = 0, msb = 0;
     for(i = 31; i >= 0; i -= 2) {
@@ -590,17 +647,7 @@ bool recover(struct Crypto1Params* p, int ks2, ProgramState* program_state) {
         program_state->search = msb;
         program_state->eta_round = eta_round_time;
         program_state->eta_total = eta_total_time - (eta_round_time * msb);
-        if(calculate_msb_tables(
-               oks,
-               eks,
-               msb,
-               p,
-               states_buffer,
-               odd_msbs,
-               even_msbs,
-               temp_states_odd,
-               temp_states_even,
-               program_state)) {
+        if(calculate_msb_tables(oks, eks, msb, p, ws, program_state)) {
             int bench_stop = furi_hal_rtc_get_timestamp();
             FURI_LOG_I(TAG, "Cracked in %i seconds", bench_stop - bench_start);
             found = true;
@@ -610,11 +657,6 @@ bool recover(struct Crypto1Params* p, int ks2, ProgramState* program_state) {
             break;
         }
     }
-    free(states_buffer);
-    free(odd_msbs);
-    free(even_msbs);
-    free(temp_states_odd);
-    free(temp_states_even);
     return found;
 }
 
@@ -633,11 +675,158 @@ bool napi_mf_classic_dict_check_presence(MfClassicDictType dict_type) {
     return dict_present;
 }
 
+static void napi_mf_classic_dict_str_to_int(FuriString* key_str, uint64_t* key_int);
+
+static size_t napi_mf_classic_dict_keys_lower_bound(MfClassicDict* dict, uint64_t key) {
+    size_t lo = 0, hi = dict->keys_count;
+    while(lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if(dict->keys[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static bool napi_mf_classic_dict_keys_find(MfClassicDict* dict, uint64_t key) {
+    size_t pos = napi_mf_classic_dict_keys_lower_bound(dict, key);
+    return pos < dict->keys_count && dict->keys[pos] == key;
+}
+
+static void napi_mf_classic_dict_keys_reserve(MfClassicDict* dict, size_t count) {
+    if(count <= dict->keys_capacity) return;
+    size_t capacity = dict->keys_capacity ? dict->keys_capacity : 64;
+    while(capacity < count) capacity *= 2;
+    dict->keys = realloc(dict->keys, sizeof(uint64_t) * capacity); //-V701
+    dict->keys_capacity = capacity;
+}
+
+static bool napi_mf_classic_dict_keys_insert(MfClassicDict* dict, uint64_t key) {
+    size_t pos = napi_mf_classic_dict_keys_lower_bound(dict, key);
+    if(pos < dict->keys_count && dict->keys[pos] == key) return false;
+    napi_mf_classic_dict_keys_reserve(dict, dict->keys_count + 1);
+    memmove(
+        &dict->keys[pos + 1], &dict->keys[pos], sizeof(uint64_t) * (dict->keys_count - pos));
+    dict->keys[pos] = key;
+    dict->keys_count++;
+    return true;
+}
+
+static int napi_mf_classic_dict_key_cmp(const void* a, const void* b) {
+    uint64_t ka = *(const uint64_t*)a;
+    uint64_t kb = *(const uint64_t*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+static bool napi_mf_classic_dict_index_load(MfClassicDict* dict, uint32_t dict_size) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint8_t* buf = NULL;
+
+    bool index_loaded = false;
+    do {
+        uint32_t dict_timestamp;
+        if(storage_common_timestamp(storage, MF_CLASSIC_DICT_USER_PATH, &dict_timestamp) !=
+           FSE_OK)
+            break;
+        if(!storage_file_open(
+               file, MF_CLASSIC_DICT_USER_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+        MfClassicDictIndexHeader header;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != MF_CLASSIC_DICT_INDEX_MAGIC) break;
+        if(header.dict_size != dict_size || header.dict_timestamp != dict_timestamp) {
+            FURI_LOG_D(TAG, "Dictionary index is stale");
+            break;
+        }
+        if((uint64_t)header.keys_count * MF_CLASSIC_DICT_INDEX_KEY_LEN !=
+           storage_file_size(file) - sizeof(header)) {
+            FURI_LOG_W(TAG, "Dictionary index is corrupted");
+            break;
+        }
+        buf = malloc(MF_CLASSIC_DICT_INDEX_CHUNK_KEYS * MF_CLASSIC_DICT_INDEX_KEY_LEN);
+        napi_mf_classic_dict_keys_reserve(dict, header.keys_count);
+        size_t i = 0;
+        while(i < header.keys_count) {
+            size_t chunk = MIN(header.keys_count - i, (size_t)MF_CLASSIC_DICT_INDEX_CHUNK_KEYS);
+            size_t chunk_size = chunk * MF_CLASSIC_DICT_INDEX_KEY_LEN;
+            if(storage_file_read(file, buf, chunk_size) != chunk_size) break;
+            for(size_t k = 0; k < chunk; k++, i++) {
+                uint64_t key = 0;
+                for(size_t j = 0; j < MF_CLASSIC_DICT_INDEX_KEY_LEN; j++) {
+                    key = key << 8 | buf[k * MF_CLASSIC_DICT_INDEX_KEY_LEN + j];
+                }
+                dict->keys[i] = key;
+            }
+        }
+        if(i != header.keys_count) break;
+        dict->keys_count = header.keys_count;
+        index_loaded = true;
+    } while(false);
+
+    free(buf);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return index_loaded;
+}
+
+static bool napi_mf_classic_dict_index_save(MfClassicDict* dict, uint32_t dict_size) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint8_t* buf = malloc(MF_CLASSIC_DICT_INDEX_CHUNK_KEYS * MF_CLASSIC_DICT_INDEX_KEY_LEN);
+
+    bool index_saved = false;
+    do {
+        uint32_t dict_timestamp;
+        if(storage_common_timestamp(storage, MF_CLASSIC_DICT_USER_PATH, &dict_timestamp) !=
+           FSE_OK)
+            break;
+        if(!storage_file_open(
+               file, MF_CLASSIC_DICT_USER_INDEX_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        MfClassicDictIndexHeader header = {
+            .magic = MF_CLASSIC_DICT_INDEX_MAGIC,
+            .keys_count = dict->keys_count,
+            .dict_size = dict_size,
+            .dict_timestamp = dict_timestamp,
+        };
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        bool write_ok = true;
+        size_t i = 0;
+        while(write_ok && i < dict->keys_count) {
+            size_t chunk = MIN(dict->keys_count - i, (size_t)MF_CLASSIC_DICT_INDEX_CHUNK_KEYS);
+            size_t chunk_size = chunk * MF_CLASSIC_DICT_INDEX_KEY_LEN;
+            for(size_t k = 0; k < chunk; k++, i++) {
+                for(size_t j = 0; j < MF_CLASSIC_DICT_INDEX_KEY_LEN; j++) {
+                    buf[k * MF_CLASSIC_DICT_INDEX_KEY_LEN + j] =
+                        dict->keys[i] >> (8 * (MF_CLASSIC_DICT_INDEX_KEY_LEN - 1 - j));
+                }
+            }
+            write_ok = storage_file_write(file, buf, chunk_size) == chunk_size;
+        }
+        if(!write_ok) break;
+        dict->index_dirty = false;
+        index_saved = true;
+    } while(false);
+
+    free(buf);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return index_saved;
+}
+
 MfClassicDict* napi_mf_classic_dict_alloc(MfClassicDictType dict_type) {
     MfClassicDict* dict = malloc(sizeof(MfClassicDict));
     Storage* storage = furi_record_open(RECORD_STORAGE);
     dict->stream = buffered_file_stream_alloc(storage);
     furi_record_close(RECORD_STORAGE);
+    dict->type = dict_type;
 
     bool dict_loaded = false;
     do {
@@ -670,7 +859,15 @@ MfClassicDict* napi_mf_classic_dict_alloc(MfClassicDictType dict_type) {
             if(!stream_rewind(dict->stream)) break;
         }
 
-        // Read total amount of keys
+        // Use the sidecar index if it matches the dictionary, otherwise parse the text once
+        if(dict_type == MfClassicDictTypeUser &&
+           napi_mf_classic_dict_index_load(dict, stream_size(dict->stream))) {
+            dict->total_keys = dict->keys_count;
+            dict_loaded = true;
+            FURI_LOG_I(TAG, "Loaded dictionary index with %lu keys", dict->total_keys);
+            break;
+        }
+
         FuriString* next_line;
         next_line = furi_string_alloc();
         while(true) {
@@ -685,17 +882,33 @@ MfClassicDict* napi_mf_classic_dict_alloc(MfClassicDictType dict_type) {
                 furi_string_size(next_line));
             if(furi_string_get_char(next_line, 0) == '#') continue;
             if(furi_string_size(next_line) != NFC_MF_CLASSIC_KEY_LEN) continue;
-            dict->total_keys++;
+            napi_mf_classic_dict_keys_reserve(dict, dict->keys_count + 1);
+            napi_mf_classic_dict_str_to_int(next_line, &dict->keys[dict->keys_count++]);
         }
         furi_string_free(next_line);
         stream_rewind(dict->stream);
 
+        // Sort and drop duplicate lines
+        if(dict->keys_count > 1) {
+            qsort(dict->keys, dict->keys_count, sizeof(uint64_t), napi_mf_classic_dict_key_cmp);
+            size_t unique = 1;
+            for(size_t i = 1; i < dict->keys_count; i++) {
+                if(dict->keys[i] != dict->keys[unique - 1]) dict->keys[unique++] = dict->keys[i];
+            }
+            dict->keys_count = unique;
+        }
+        dict->total_keys = dict->keys_count;
+        if(dict_type == MfClassicDictTypeUser) {
+            napi_mf_classic_dict_index_save(dict, stream_size(dict->stream));
+        }
+
         dict_loaded = true;
         FURI_LOG_I(TAG, "Loaded dictionary with %lu keys", dict->total_keys);
     } while(false);
 
     if(!dict_loaded) {
         buffered_file_stream_close(dict->stream);
+        free(dict->keys);
         free(dict);
         dict = NULL;
     }
@@ -706,6 +919,13 @@ MfClassicDict* napi_mf_classic_dict_alloc(MfClassicDictType dict_type) {
 bool napi_mf_classic_dict_add_key_str(MfClassicDict* dict, FuriString* key) {
     furi_assert(dict);
     furi_assert(dict->stream);
+
+    uint64_t key_int;
+    napi_mf_classic_dict_str_to_int(key, &key_int);
+    if(napi_mf_classic_dict_keys_find(dict, key_int)) {
+        FURI_LOG_D(TAG, "Key already in dictionary: %s", furi_string_get_cstr(key));
+        return false;
+    }
     FURI_LOG_I(TAG, "Saving key: %s", furi_string_get_cstr(key));
 
     furi_string_cat_printf(key, "\n");
@@ -714,6 +934,8 @@ bool napi_mf_classic_dict_add_key_str(MfClassicDict* dict, FuriString* key) {
     do {
         if(!stream_seek(dict->stream, 0, StreamOffsetFromEnd)) break;
         if(!stream_insert_string(dict->stream, key)) break;
+        napi_mf_classic_dict_keys_insert(dict, key_int);
+        dict->index_dirty = true;
         dict->total_keys++;
         key_added = true;
     } while(false);
@@ -726,8 +948,15 @@ void napi_mf_classic_dict_free(MfClassicDict* dict) {
     furi_assert(dict);
     furi_assert(dict->stream);
 
+    // The dictionary is closed first so the index records its final size and modification time
+    buffered_file_stream_sync(dict->stream);
+    uint32_t dict_size = stream_size(dict->stream);
     buffered_file_stream_close(dict->stream);
+    if(dict->type == MfClassicDictTypeUser && dict->index_dirty) {
+        napi_mf_classic_dict_index_save(dict, dict_size);
+    }
     stream_free(dict->stream);
+    free(dict->keys);
     free(dict);
 }
 
@@ -795,34 +1024,20 @@ bool napi_mf_classic_dict_get_next_key(MfClassicDict* dict, uint64_t* key) {
 
 bool napi_mf_classic_dict_is_key_present_str(MfClassicDict* dict, FuriString* key) {
     furi_assert(dict);
-    furi_assert(dict->stream);
 
-    FuriString* next_line;
-    next_line = furi_string_alloc();
-
-    bool key_found = false;
-    stream_rewind(dict->stream);
-    while(!key_found) { //-V654
-        if(!stream_read_line(dict->stream, next_line)) break;
-        if(furi_string_get_char(next_line, 0) == '#') continue;
-        if(furi_string_size(next_line) != NFC_MF_CLASSIC_KEY_LEN) continue;
-        furi_string_left(next_line, 12);
-        if(!furi_string_equal(key, next_line)) continue;
-        key_found = true;
-    }
-
-    furi_string_free(next_line);
-    return key_found;
+    uint64_t key_int;
+    napi_mf_classic_dict_str_to_int(key, &key_int);
+    return napi_mf_classic_dict_keys_find(dict, key_int);
 }
 
 bool napi_mf_classic_dict_is_key_present(MfClassicDict* dict, uint8_t* key) {
-    FuriString* temp_key;
+    furi_assert(dict);
 
-    temp_key = furi_string_alloc();
-    napi_mf_classic_dict_int_to_str(key, temp_key);
-    bool key_found = napi_mf_classic_dict_is_key_present_str(dict, temp_key);
-    furi_string_free(temp_key);
-    return key_found;
+    uint64_t key_int = 0;
+    for(size_t i = 0; i < 6; i++) {
+        key_int = key_int << 8 | key[i];
+    }
+    return napi_mf_classic_dict_keys_find(dict, key_int);
 }
 
 bool napi_key_already_found_for_nonce(
@@ -832,14 +1047,12 @@ bool napi_key_already_found_for_nonce(
     uint32_t p64b,
     uint32_t ar1_enc) {
     bool found = false;
-    uint64_t k = 0;
-    napi_mf_classic_dict_rewind(dict);
-    while(napi_mf_classic_dict_get_next_key(dict, &k)) {
+    for(size_t k = 0; k < dict->keys_count; k++) {
         struct Crypto1State temp = {0, 0};
         int i;
         for(i = 0; i < 24; i++) {
-            (&temp)->odd |= (BIT(k, 2 * i + 1) << (i ^ 3));
-            (&temp)->even |= (BIT(k, 2 * i) << (i ^ 3));
+            (&temp)->odd |= (BIT(dict->keys[k], 2 * i + 1) << (i ^ 3));
+            (&temp)->even |= (BIT(dict->keys[k], 2 * i) << (i ^ 3));
         }
         crypt_word_noret(&temp, uid_xor_nt1, 0);
         crypt_word_noret(&temp, nr1_enc, 1);
@@ -990,6 +1203,7 @@ void napi_mf_classic_nonce_array_free(MfClassicNonceArray* nonce_array) {
 
     buffered_file_stream_close(nonce_array->stream);
     stream_free(nonce_array->stream);
+    free(nonce_array->remaining_nonce_array);
     free(nonce_array);
 }
 
@@ -1052,6 +1266,8 @@ void mfkey32(ProgramState* program_state) {
         eta_total_time *= 2;
         MSB_LIMIT /= 2;
     }
+    // MSB tables depend on each nonce's keystream, so the batch shares one workspace instead
+    struct MfkeyWorkspace* ws = mfkey_workspace_alloc();
     program_state->mfkey_state = MfkeyAttack;
     // TODO: Work backwards on this array and free memory
     for(i = 0; i < nonce_arr->total_nonces; i++) {
@@ -1079,7 +1295,7 @@ void mfkey32(ProgramState* program_state) {
             next_nonce.nr1_enc,
             p64b,
             next_nonce.ar1_enc};
-        if(!recover(&p, next_nonce.ar0_enc ^ p64, program_state)) {
+        if(!recover(&p, next_nonce.ar0_enc ^ p64, ws, program_state)) {
             if(program_state->close_thread_please) {
                 break;
             }
@@ -1105,6 +1321,7 @@ void mfkey32(ProgramState* program_state) {
             (program_state->unique_cracked)++;
         }
     }
+    mfkey_workspace_free(ws);
     // TODO: Update display to show all keys were found
     // TODO: Prepend found key(s) to user dictionary file
     //FURI_LOG_I(TAG, "Unique keys found:");
@@ -0,0 +1,286 @@
+// Runs mfkey32() on the host over generated .mfkey32.log sets and reports keys/s
+// and peak heap for MSB_LIMIT 16 and 8, then checks that the user dictionary's
+// sorted key table and index survive reloads and get rebuilt when stale.
+//
+//   make -C mfkey32/test run
+
+// napi_mf_classic_dict_int_to_str() is unused in the app as well
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "../mfkey32.c"
+#pragma GCC diagnostic pop
+
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+
+#define BENCH_KEYS 2
+#define BENCH_NONCES_PER_KEY 2 // the second nonce of a key is solved from the first one
+#define DICT_KEYS 500
+#define DICT_DUPLICATES 50
+
+static uint64_t rand_key(void) {
+    return ((uint64_t)rand() << 32 ^ (uint64_t)rand() << 8 ^ rand()) & 0xFFFFFFFFFFFF;
+}
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void remove_file(const char* path) {
+    unlink(path);
+}
+
+static size_t file_size(const char* path) {
+    struct stat st;
+    return stat(path, &st) ? 0 : (size_t)st.st_size;
+}
+
+static uint32_t file_mtime(const char* path) {
+    struct stat st;
+    return stat(path, &st) ? 0 : st.st_mtime;
+}
+
+static void set_file_mtime(const char* path, uint32_t mtime) {
+    struct utimbuf times = {.actime = mtime, .modtime = mtime};
+    utime(path, &times);
+}
+
+// What a reader with this key sends after the tag's nonce nt
+static void sniff_auth(uint64_t key, uint32_t uid, uint32_t nt, uint32_t nr, uint32_t* ar) {
+    struct Crypto1State state = {0, 0};
+    for(int i = 0; i < 24; i++) {
+        state.odd |= BIT(key, 2 * i + 1) << (i ^ 3);
+        state.even |= BIT(key, 2 * i) << (i ^ 3);
+    }
+    crypt_word_noret(&state, uid ^ nt, 0);
+    crypt_word_noret(&state, nr, 1);
+    *ar = crypt_word(&state) ^ prng_successor(nt, 64);
+}
+
+static void write_nonce_log(const uint64_t* keys, size_t keys_count) {
+    FILE* log = fopen(MF_CLASSIC_NONCE_PATH, "w");
+    for(size_t k = 0; k < keys_count; k++) {
+        uint32_t uid = rand();
+        for(size_t n = 0; n < BENCH_NONCES_PER_KEY; n++) {
+            uint32_t nt0 = rand(), nt1 = rand(), nr0 = rand(), nr1 = rand(), ar0, ar1;
+            sniff_auth(keys[k], uid, nt0, nr0, &ar0);
+            sniff_auth(keys[k], uid, nt1, nr1, &ar1);
+            fprintf(
+                log,
+                "Sec %zu key A cuid %08x nt0 %08x nr0 %08x ar0 %08x nt1 %08x nr1 %08x ar1 %08x\n",
+                k,
+                uid,
+                nt0,
+                nr0,
+                ar0,
+                nt1,
+                nr1,
+                ar1);
+        }
+    }
+    fclose(log);
+}
+
+static bool user_dict_has_keys(const uint64_t* keys, size_t keys_count) {
+    MfClassicDict* dict = napi_mf_classic_dict_alloc(MfClassicDictTypeUser);
+    bool found = dict->keys_count == keys_count;
+    for(size_t k = 0; k < keys_count; k++) {
+        uint8_t key[6];
+        for(size_t i = 0; i < 6; i++) key[i] = keys[k] >> (40 - 8 * i);
+        found = found && napi_mf_classic_dict_is_key_present(dict, key);
+    }
+    napi_mf_classic_dict_free(dict);
+    return found;
+}
+
+static int bench(int msb_limit) {
+    uint64_t keys[BENCH_KEYS];
+    for(size_t k = 0; k < BENCH_KEYS; k++) keys[k] = rand_key();
+    write_nonce_log(keys, BENCH_KEYS);
+    remove_file(MF_CLASSIC_DICT_USER_PATH);
+    remove_file(MF_CLASSIC_DICT_USER_INDEX_PATH);
+
+    ProgramState state = {0};
+    mfkey32_state_init(&state);
+    MSB_LIMIT = msb_limit;
+
+    size_t heap_start = host_heap_used();
+    host_heap_reset_peak();
+    double start = time_s();
+    mfkey32(&state);
+    double elapsed = time_s() - start;
+
+    bool ok = state.mfkey_state == Complete &&
+              state.cracked == BENCH_KEYS * BENCH_NONCES_PER_KEY &&
+              state.unique_cracked == BENCH_KEYS && host_heap_used() == heap_start &&
+              user_dict_has_keys(keys, BENCH_KEYS);
+    printf(
+        "MSB_LIMIT %2d: %d nonces, %d keys in %5.2f s, %.2f keys/s, peak heap %5.1f KB %s\n",
+        msb_limit,
+        state.total,
+        state.unique_cracked,
+        elapsed,
+        state.unique_cracked / elapsed,
+        (host_heap_peak() - heap_start) / 1024.0,
+        ok ? "ok" : "FAIL");
+    return !ok;
+}
+
+static int key_cmp(const void* a, const void* b) {
+    uint64_t ka = *(const uint64_t*)a, kb = *(const uint64_t*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+// The dictionary must hold exactly the sorted expected keys, and find nothing else
+static bool dict_matches(MfClassicDict* dict, const uint64_t* expected, size_t count) {
+    if(dict->keys_count != count || dict->total_keys != count) return false;
+    for(size_t i = 0; i < count; i++) {
+        if(dict->keys[i] != expected[i]) return false;
+    }
+    for(int i = 0; i < 1000; i++) {
+        uint64_t key = rand_key();
+        bool expected_present = bsearch(&key, expected, count, sizeof(uint64_t), key_cmp);
+        if(napi_mf_classic_dict_keys_find(dict, key) != expected_present) return false;
+    }
+    return true;
+}
+
+static bool reload_matches(const uint64_t* expected, size_t count) {
+    MfClassicDict* dict = napi_mf_classic_dict_alloc(MfClassicDictTypeUser);
+    bool ok = dict && dict_matches(dict, expected, count);
+    if(dict) napi_mf_classic_dict_free(dict);
+    return ok;
+}
+
+static bool index_header(MfClassicDictIndexHeader* header) {
+    FILE* file = fopen(MF_CLASSIC_DICT_USER_INDEX_PATH, "rb");
+    if(!file) return false;
+    bool ok = fread(header, sizeof(*header), 1, file) == 1;
+    fclose(file);
+    return ok;
+}
+
+// The index must describe the dictionary as it is now
+static bool index_current(size_t count) {
+    MfClassicDictIndexHeader header;
+    return index_header(&header) && header.keys_count == count &&
+           file_size(MF_CLASSIC_DICT_USER_INDEX_PATH) ==
+               sizeof(header) + count * MF_CLASSIC_DICT_INDEX_KEY_LEN &&
+           header.dict_size == file_size(MF_CLASSIC_DICT_USER_PATH) &&
+           header.dict_timestamp == file_mtime(MF_CLASSIC_DICT_USER_PATH);
+}
+
+// Overwrites the first key of the index in place, the header stays valid
+static void index_replace_first_key(uint64_t key) {
+    FILE* file = fopen(MF_CLASSIC_DICT_USER_INDEX_PATH, "r+b");
+    fseek(file, sizeof(MfClassicDictIndexHeader), SEEK_SET);
+    for(int i = 0; i < MF_CLASSIC_DICT_INDEX_KEY_LEN; i++) fputc(key >> (40 - 8 * i), file);
+    fclose(file);
+}
+
+#define CHECK(name, condition)                                  \
+    do {                                                        \
+        bool ok = (condition);                                  \
+        failed += !ok;                                          \
+        printf("dict index: %-40s %s\n", name, ok ? "ok" : "FAIL"); \
+    } while(0)
+
+static int test_dict_index(void) {
+    int failed = 0;
+    static uint64_t keys[DICT_KEYS + 1];
+    remove_file(MF_CLASSIC_DICT_USER_INDEX_PATH);
+
+    // comments, CRLF lines, duplicates and no final newline, like hand-edited files
+    FILE* text = fopen(MF_CLASSIC_DICT_USER_PATH, "w");
+    fprintf(text, "# user keys\n");
+    for(size_t i = 0; i < DICT_KEYS; i++) {
+        keys[i] = rand_key();
+        fprintf(text, i % 7 ? "%012" PRIX64 "\n" : "%012" PRIX64 "\r\n", keys[i]);
+        if(i < DICT_DUPLICATES) fprintf(text, "%012" PRIX64 "\n", keys[i]);
+    }
+    fprintf(text, "%012" PRIX64, keys[0]);
+    fclose(text);
+    qsort(keys, DICT_KEYS, sizeof(uint64_t), key_cmp);
+    size_t count = DICT_KEYS;
+
+    CHECK("text parsed sorted and unique", reload_matches(keys, count));
+    CHECK("index written", index_current(count));
+
+    // a valid index is trusted without reading the text
+    uint64_t original = keys[0], planted = keys[0] ^ 0xA5A5;
+    index_replace_first_key(planted);
+    keys[0] = planted;
+    qsort(keys, count, sizeof(uint64_t), key_cmp);
+    CHECK("valid index used", reload_matches(keys, count));
+
+    // a newer dictionary invalidates it
+    uint32_t mtime = file_mtime(MF_CLASSIC_DICT_USER_PATH) + 10;
+    set_file_mtime(MF_CLASSIC_DICT_USER_PATH, mtime);
+    for(size_t i = 0; i < count; i++) {
+        if(keys[i] == planted) keys[i] = original;
+    }
+    qsort(keys, count, sizeof(uint64_t), key_cmp);
+    CHECK("rebuilt on changed mtime", reload_matches(keys, count));
+    CHECK("index rewritten", index_current(count));
+
+    // so does a different size under the same mtime
+    text = fopen(MF_CLASSIC_DICT_USER_PATH, "a");
+    keys[count] = rand_key();
+    fprintf(text, "%012" PRIX64 "\n", keys[count++]);
+    fclose(text);
+    set_file_mtime(MF_CLASSIC_DICT_USER_PATH, mtime);
+    qsort(keys, count, sizeof(uint64_t), key_cmp);
+    CHECK("rebuilt on changed size", reload_matches(keys, count));
+
+    // and a key table that doesn't match its header
+    bool truncated =
+        truncate(MF_CLASSIC_DICT_USER_INDEX_PATH, sizeof(MfClassicDictIndexHeader) + 3) == 0;
+    CHECK("rebuilt on truncated index", truncated && reload_matches(keys, count));
+    CHECK("index rewritten", index_current(count));
+
+    // keys added by the app are saved to both files
+    MfClassicDict* dict = napi_mf_classic_dict_alloc(MfClassicDictTypeUser);
+    FuriString* key = furi_string_alloc();
+    uint64_t added = rand_key();
+    furi_string_cat_printf(key, "%012" PRIX64, added);
+    bool add_ok = napi_mf_classic_dict_add_key_str(dict, key);
+    bool add_again = napi_mf_classic_dict_add_key_str(dict, key);
+    furi_string_free(key);
+    napi_mf_classic_dict_free(dict);
+    static uint64_t with_added[DICT_KEYS + 2];
+    memcpy(with_added, keys, count * sizeof(uint64_t));
+    with_added[count++] = added;
+    qsort(with_added, count, sizeof(uint64_t), key_cmp);
+    CHECK("added key inserted once", add_ok && !add_again);
+    CHECK("index saved after close", index_current(count));
+    CHECK("added key reloaded", reload_matches(with_added, count));
+
+    return failed;
+}
+
+int main(void) {
+    char dir[] = "/tmp/mfkey32_test.XXXXXX";
+    if(!mkdtemp(dir) || chdir(dir) || mkdir("ext", 0755) || mkdir("ext/nfc", 0755) ||
+       mkdir("ext/nfc/assets", 0755)) {
+        perror(dir);
+        return EXIT_FAILURE;
+    }
+    srand(1);
+
+    int failed = test_dict_index();
+    failed += bench(16);
+    failed += bench(8);
+
+    remove_file(MF_CLASSIC_NONCE_PATH);
+    remove_file(MF_CLASSIC_DICT_USER_PATH);
+    remove_file(MF_CLASSIC_DICT_USER_INDEX_PATH);
+    rmdir("ext/nfc/assets");
+    rmdir("ext/nfc");
+    rmdir("ext");
+    rmdir(dir);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+typedef enum {
+    DolphinDeedNfcMfcAdd,
+} DolphinDeed;
+
+static inline void dolphin_deed(DolphinDeed deed) {
+    (void)deed;
+}
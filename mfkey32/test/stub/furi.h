@@ -0,0 +1,167 @@
+#pragma once
+
+// Just enough of furi for mfkey32.c to build on the host. Heap use is tracked so the
+// test can report the peak table memory.
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define furi_assert(x) (void)(x)
+
+// every path on the SD card lives under ext/ in the test's working directory
+#define EXT_PATH(path) "ext/" path
+
+void* host_malloc(size_t size);
+void* host_realloc(void* ptr, size_t size);
+void host_free(void* ptr);
+void host_heap_reset_peak(void);
+size_t host_heap_used(void);
+size_t host_heap_peak(void);
+
+#define malloc(size) host_malloc(size)
+#define realloc(ptr, size) host_realloc(ptr, size)
+#define free(ptr) host_free(ptr)
+
+static inline void furi_log_print(const char* tag, const char* format, ...) {
+    UNUSED(tag);
+    UNUSED(format);
+}
+
+#define FURI_LOG_E(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_T(tag, ...) furi_log_print(tag, __VA_ARGS__)
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+char furi_string_get_char(const FuriString* string, size_t index);
+void furi_string_push_back(FuriString* string, char c);
+void furi_string_left(FuriString* string, size_t index);
+bool furi_string_start_with_str(const FuriString* string, const char* start);
+int furi_string_cat_printf(FuriString* string, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+#define RECORD_STORAGE "storage"
+#define RECORD_GUI "gui"
+
+static inline void* furi_record_open(const char* name) {
+    UNUSED(name);
+    return NULL;
+}
+
+static inline void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// The app's UI thread is not used, the test calls mfkey32() directly
+
+typedef struct FuriMutex FuriMutex;
+typedef struct FuriThread FuriThread;
+typedef struct FuriMessageQueue FuriMessageQueue;
+typedef int32_t (*FuriThreadCallback)(void* context);
+
+typedef enum {
+    FuriMutexTypeNormal,
+} FuriMutexType;
+
+static inline FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    UNUSED(type);
+    return (FuriMutex*)1;
+}
+
+static inline void furi_mutex_free(FuriMutex* mutex) {
+    UNUSED(mutex);
+}
+
+static inline FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    UNUSED(mutex);
+    UNUSED(timeout);
+    return FuriStatusOk;
+}
+
+static inline FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    UNUSED(mutex);
+    return FuriStatusOk;
+}
+
+static inline FuriThread* furi_thread_alloc(void) {
+    return NULL;
+}
+
+static inline void furi_thread_free(FuriThread* thread) {
+    UNUSED(thread);
+}
+
+static inline void furi_thread_set_name(FuriThread* thread, const char* name) {
+    UNUSED(thread);
+    UNUSED(name);
+}
+
+static inline void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    UNUSED(thread);
+    UNUSED(stack_size);
+}
+
+static inline void furi_thread_set_context(FuriThread* thread, void* context) {
+    UNUSED(thread);
+    UNUSED(context);
+}
+
+static inline void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    UNUSED(thread);
+    UNUSED(callback);
+}
+
+static inline void furi_thread_start(FuriThread* thread) {
+    UNUSED(thread);
+}
+
+static inline bool furi_thread_join(FuriThread* thread) {
+    UNUSED(thread);
+    return true;
+}
+
+static inline FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    UNUSED(msg_count);
+    UNUSED(msg_size);
+    return NULL;
+}
+
+static inline void furi_message_queue_free(FuriMessageQueue* queue) {
+    UNUSED(queue);
+}
+
+static inline FuriStatus
+    furi_message_queue_put(FuriMessageQueue* queue, const void* msg, uint32_t timeout) {
+    UNUSED(queue);
+    UNUSED(msg);
+    UNUSED(timeout);
+    return FuriStatusOk;
+}
+
+static inline FuriStatus
+    furi_message_queue_get(FuriMessageQueue* queue, void* msg, uint32_t timeout) {
+    UNUSED(queue);
+    UNUSED(msg);
+    UNUSED(timeout);
+    return FuriStatusError;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <time.h>
+
+static inline uint32_t furi_hal_rtc_get_timestamp(void) {
+    return time(NULL);
+}
+
+// plenty, so mfkey32() keeps the MSB_LIMIT the test sets
+static inline size_t memmgr_get_free_heap(void) {
+    return 1024 * 1024;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <gui/gui.h>
+
+static inline void elements_progress_bar_with_text(
+    Canvas* canvas,
+    int x,
+    int y,
+    int width,
+    float progress,
+    const char* text) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(progress);
+    UNUSED(text);
+}
+
+static inline void elements_button_center(Canvas* canvas, const char* str) {
+    UNUSED(canvas);
+    UNUSED(str);
+}
+
+static inline void elements_button_right(Canvas* canvas, const char* str) {
+    UNUSED(canvas);
+    UNUSED(str);
+}
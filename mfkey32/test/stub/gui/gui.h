@@ -0,0 +1,99 @@
+#pragma once
+
+#include <furi.h>
+#include <input/input.h>
+
+typedef struct Canvas Canvas;
+typedef struct ViewPort ViewPort;
+typedef struct Gui Gui;
+
+typedef struct {
+    int unused;
+} Icon;
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+} Font;
+
+typedef enum {
+    AlignLeft,
+    AlignTop,
+} Align;
+
+typedef enum {
+    GuiLayerFullscreen,
+} GuiLayer;
+
+static inline void canvas_clear(Canvas* canvas) {
+    UNUSED(canvas);
+}
+
+static inline void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    UNUSED(font);
+}
+
+static inline void canvas_draw_frame(Canvas* canvas, int x, int y, int width, int height) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+}
+
+static inline void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int x,
+    int y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(horizontal);
+    UNUSED(vertical);
+    UNUSED(str);
+}
+
+static inline void canvas_draw_icon(Canvas* canvas, int x, int y, const Icon* icon) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(icon);
+}
+
+// callbacks are taken as they come, the firmware's types are not needed here
+#define view_port_draw_callback_set(view_port, callback, context) \
+    ((void)(view_port), (void)(callback), (void)(context))
+#define view_port_input_callback_set(view_port, callback, context) \
+    ((void)(view_port), (void)(callback), (void)(context))
+
+static inline ViewPort* view_port_alloc(void) {
+    return NULL;
+}
+
+static inline void view_port_free(ViewPort* view_port) {
+    UNUSED(view_port);
+}
+
+static inline void view_port_update(ViewPort* view_port) {
+    UNUSED(view_port);
+}
+
+static inline void view_port_enabled_set(ViewPort* view_port, bool enabled) {
+    UNUSED(view_port);
+    UNUSED(enabled);
+}
+
+static inline void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer) {
+    UNUSED(gui);
+    UNUSED(view_port);
+    UNUSED(layer);
+}
+
+static inline void gui_remove_view_port(Gui* gui, ViewPort* view_port) {
+    UNUSED(gui);
+    UNUSED(view_port);
+}
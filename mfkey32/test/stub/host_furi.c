@@ -0,0 +1,352 @@
+// Host implementations of the furi pieces mfkey32.c needs: a heap that
+// remembers its peak, FuriString, args and files/streams on top of stdio.
+
+#include <furi.h>
+#include <lib/toolbox/args.h>
+#include <storage/storage.h>
+#include <toolbox/stream/buffered_file_stream.h>
+
+#include <stddef.h>
+#include <sys/stat.h>
+
+#undef malloc
+#undef realloc
+#undef free
+
+// Each block carries its size in front of it. Memory comes zeroed like from the
+// firmware's malloc, which the app relies on.
+
+typedef union {
+    size_t size;
+    max_align_t align;
+} HeapHeader;
+
+static size_t heap_used;
+static size_t heap_peak;
+
+void* host_malloc(size_t size) {
+    HeapHeader* header = calloc(1, sizeof(HeapHeader) + size);
+    if(!header) abort();
+    header->size = size;
+    heap_used += size;
+    if(heap_used > heap_peak) heap_peak = heap_used;
+    return header + 1;
+}
+
+void host_free(void* ptr) {
+    if(!ptr) return;
+    HeapHeader* header = (HeapHeader*)ptr - 1;
+    heap_used -= header->size;
+    free(header);
+}
+
+void* host_realloc(void* ptr, size_t size) {
+    if(!ptr) return host_malloc(size);
+    HeapHeader* header = (HeapHeader*)ptr - 1;
+    size_t old_size = header->size;
+    header = realloc(header, sizeof(HeapHeader) + size);
+    if(!header) abort();
+    header->size = size;
+    heap_used = heap_used - old_size + size;
+    if(heap_used > heap_peak) heap_peak = heap_used;
+    return header + 1;
+}
+
+void host_heap_reset_peak(void) {
+    heap_peak = heap_used;
+}
+
+size_t host_heap_used(void) {
+    return heap_used;
+}
+
+size_t host_heap_peak(void) {
+    return heap_peak;
+}
+
+// FuriString
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+static void furi_string_reserve(FuriString* string, size_t size) {
+    if(size + 1 <= string->capacity) return;
+    while(string->capacity < size + 1) string->capacity *= 2;
+    string->data = host_realloc(string->data, string->capacity);
+}
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = host_malloc(sizeof(FuriString));
+    string->capacity = 16;
+    string->data = host_malloc(string->capacity);
+    furi_string_reset(string);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    host_free(string->data);
+    host_free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+char furi_string_get_char(const FuriString* string, size_t index) {
+    return index < string->size ? string->data[index] : '\0';
+}
+
+void furi_string_push_back(FuriString* string, char c) {
+    furi_string_reserve(string, string->size + 1);
+    string->data[string->size++] = c;
+    string->data[string->size] = '\0';
+}
+
+void furi_string_left(FuriString* string, size_t index) {
+    if(index < string->size) {
+        string->size = index;
+        string->data[index] = '\0';
+    }
+}
+
+bool furi_string_start_with_str(const FuriString* string, const char* start) {
+    return strncmp(string->data, start, strlen(start)) == 0;
+}
+
+int furi_string_cat_printf(FuriString* string, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int size = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    furi_string_reserve(string, string->size + size);
+    va_start(args, format);
+    vsnprintf(string->data + string->size, size + 1, format, args);
+    va_end(args);
+    string->size += size;
+    return size;
+}
+
+// Toolbox
+
+static bool args_char_to_hex_nibble(char c, uint8_t* nibble) {
+    if(c >= '0' && c <= '9') {
+        *nibble = c - '0';
+    } else if(c >= 'A' && c <= 'F') {
+        *nibble = c - 'A' + 10;
+    } else if(c >= 'a' && c <= 'f') {
+        *nibble = c - 'a' + 10;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool args_char_to_hex(char hi_nibble, char low_nibble, uint8_t* byte) {
+    uint8_t hi, lo;
+    if(!args_char_to_hex_nibble(hi_nibble, &hi) || !args_char_to_hex_nibble(low_nibble, &lo)) {
+        return false;
+    }
+    *byte = hi << 4 | lo;
+    return true;
+}
+
+// Storage
+
+struct File {
+    FILE* file;
+};
+
+FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo) {
+    UNUSED(storage);
+    struct stat st;
+    if(stat(path, &st)) return FSE_NOT_EXIST;
+    if(fileinfo) fileinfo->size = st.st_size;
+    return FSE_OK;
+}
+
+FS_Error storage_common_timestamp(Storage* storage, const char* path, uint32_t* timestamp) {
+    UNUSED(storage);
+    struct stat st;
+    if(stat(path, &st)) return FSE_NOT_EXIST;
+    *timestamp = st.st_mtime;
+    return FSE_OK;
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    File* file = host_malloc(sizeof(File));
+    file->file = NULL;
+    return file;
+}
+
+void storage_file_free(File* file) {
+    storage_file_close(file);
+    host_free(file);
+}
+
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    UNUSED(access_mode);
+    struct stat st;
+    bool exists = stat(path, &st) == 0;
+
+    if(open_mode == FSOM_OPEN_EXISTING && !exists) return false;
+    if(open_mode == FSOM_CREATE_NEW && exists) return false;
+    if(open_mode == FSOM_CREATE_ALWAYS || !exists) {
+        file->file = fopen(path, "w+b");
+    } else {
+        file->file = fopen(path, "r+b");
+    }
+    if(file->file && open_mode == FSOM_OPEN_APPEND) fseek(file->file, 0, SEEK_END);
+    return file->file != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->file) return false;
+    fclose(file->file);
+    file->file = NULL;
+    return true;
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    // switching from writing to reading needs a seek with stdio
+    fseek(file->file, 0, SEEK_CUR);
+    return fread(buff, 1, bytes_to_read, file->file);
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    fseek(file->file, 0, SEEK_CUR);
+    return fwrite(buff, 1, bytes_to_write, file->file);
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    return fseek(file->file, offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+uint64_t storage_file_tell(File* file) {
+    return ftell(file->file);
+}
+
+uint64_t storage_file_size(File* file) {
+    long position = ftell(file->file);
+    fseek(file->file, 0, SEEK_END);
+    long size = ftell(file->file);
+    fseek(file->file, position, SEEK_SET);
+    return size;
+}
+
+bool storage_file_sync(File* file) {
+    return fflush(file->file) == 0;
+}
+
+// Stream
+
+struct Stream {
+    File* file;
+};
+
+Stream* buffered_file_stream_alloc(Storage* storage) {
+    Stream* stream = host_malloc(sizeof(Stream));
+    stream->file = storage_file_alloc(storage);
+    return stream;
+}
+
+bool buffered_file_stream_open(
+    Stream* stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    return storage_file_open(stream->file, path, access_mode, open_mode);
+}
+
+bool buffered_file_stream_close(Stream* stream) {
+    return storage_file_close(stream->file);
+}
+
+bool buffered_file_stream_sync(Stream* stream) {
+    return stream->file->file && storage_file_sync(stream->file);
+}
+
+void stream_free(Stream* stream) {
+    storage_file_free(stream->file);
+    host_free(stream);
+}
+
+size_t stream_tell(Stream* stream) {
+    return storage_file_tell(stream->file);
+}
+
+size_t stream_size(Stream* stream) {
+    return storage_file_size(stream->file);
+}
+
+bool stream_eof(Stream* stream) {
+    return stream_tell(stream) >= stream_size(stream);
+}
+
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type) {
+    int64_t position = offset;
+    if(offset_type == StreamOffsetFromCurrent) position += stream_tell(stream);
+    if(offset_type == StreamOffsetFromEnd) position += stream_size(stream);
+    if(position < 0 || position > (int64_t)stream_size(stream)) return false;
+    return storage_file_seek(stream->file, position, true);
+}
+
+bool stream_rewind(Stream* stream) {
+    return stream_seek(stream, 0, StreamOffsetFromStart);
+}
+
+size_t stream_read(Stream* stream, uint8_t* data, size_t size) {
+    return storage_file_read(stream->file, data, size);
+}
+
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size) {
+    return storage_file_write(stream->file, data, size);
+}
+
+size_t stream_write_char(Stream* stream, char c) {
+    return stream_write(stream, (const uint8_t*)&c, 1);
+}
+
+// Same rules as the firmware: '\r' is dropped, '\n' is kept
+bool stream_read_line(Stream* stream, FuriString* str_result) {
+    furi_string_reset(str_result);
+    uint8_t c;
+    while(stream_read(stream, &c, 1) == 1) {
+        if(c == '\r') continue;
+        furi_string_push_back(str_result, c);
+        if(c == '\n') break;
+    }
+    return furi_string_size(str_result) != 0;
+}
+
+bool stream_insert_string(Stream* stream, FuriString* string) {
+    size_t position = stream_tell(stream);
+    size_t tail_size = stream_size(stream) - position;
+    uint8_t* tail = host_malloc(tail_size + 1);
+    bool inserted = stream_read(stream, tail, tail_size) == tail_size &&
+                    stream_seek(stream, position, StreamOffsetFromStart);
+    size_t size = furi_string_size(string);
+    inserted = inserted &&
+               stream_write(stream, (const uint8_t*)furi_string_get_cstr(string), size) == size;
+    inserted = inserted && stream_write(stream, tail, tail_size) == tail_size;
+    inserted = inserted && stream_seek(stream, position + size, StreamOffsetFromStart);
+    host_free(tail);
+    return inserted;
+}
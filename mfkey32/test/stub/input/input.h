@@ -0,0 +1,20 @@
+#pragma once
+
+typedef enum {
+    InputTypePress,
+    InputTypeRelease,
+} InputType;
+
+typedef enum {
+    InputKeyUp,
+    InputKeyDown,
+    InputKeyRight,
+    InputKeyLeft,
+    InputKeyOk,
+    InputKeyBack,
+} InputKey;
+
+typedef struct {
+    InputKey key;
+    InputType type;
+} InputEvent;
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+bool args_char_to_hex(char hi_nibble, char low_nibble, uint8_t* byte);
@@ -0,0 +1,16 @@
+#pragma once
+
+typedef struct NotificationApp NotificationApp;
+
+typedef struct {
+    int unused;
+} NotificationSequence;
+
+static const NotificationSequence sequence_audiovisual_alert;
+static const NotificationSequence sequence_display_backlight_on;
+
+static inline void
+    notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    (void)app;
+    (void)sequence;
+}
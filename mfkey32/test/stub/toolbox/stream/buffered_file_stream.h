@@ -0,0 +1,34 @@
+#pragma once
+
+// Unbuffered stand-in for the firmware's buffered file stream, see host_furi.c
+
+#include <storage/storage.h>
+
+typedef struct Stream Stream;
+
+typedef enum {
+    StreamOffsetFromCurrent,
+    StreamOffsetFromStart,
+    StreamOffsetFromEnd,
+} StreamOffset;
+
+Stream* buffered_file_stream_alloc(Storage* storage);
+bool buffered_file_stream_open(
+    Stream* stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode);
+bool buffered_file_stream_close(Stream* stream);
+bool buffered_file_stream_sync(Stream* stream);
+
+void stream_free(Stream* stream);
+bool stream_eof(Stream* stream);
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type);
+size_t stream_tell(Stream* stream);
+size_t stream_size(Stream* stream);
+bool stream_rewind(Stream* stream);
+size_t stream_read(Stream* stream, uint8_t* data, size_t size);
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size);
+size_t stream_write_char(Stream* stream, char c);
+bool stream_read_line(Stream* stream, FuriString* str_result);
+bool stream_insert_string(Stream* stream, FuriString* string);
@@ -1,6 +1,69 @@
 #include "crypto1.h"
 #include <string.h>
 
+// Filter function inputs fa/fb (bits 0-7) and fc/fd (bits 8-15), pre-shifted into place
+static const uint8_t crypto1_filter_lut_lo[256] = {
+     0,  0, 16, 16,  0, 16,  0,  0,  0, 16,  0,  0, 16, 16, 16, 16,
+     0,  0, 16, 16,  0, 16,  0,  0,  0, 16,  0,  0, 16, 16, 16, 16,
+     0,  0, 16, 16,  0, 16,  0,  0,  0, 16,  0,  0, 16, 16, 16, 16,
+     8,  8, 24, 24,  8, 24,  8,  8,  8, 24,  8,  8, 24, 24, 24, 24,
+     8,  8, 24, 24,  8, 24,  8,  8,  8, 24,  8,  8, 24, 24, 24, 24,
+     8,  8, 24, 24,  8, 24,  8,  8,  8, 24,  8,  8, 24, 24, 24, 24,
+     0,  0, 16, 16,  0, 16,  0,  0,  0, 16,  0,  0, 16, 16, 16, 16,
+     0,  0, 16, 16,  0, 16,  0,  0,  0, 16,  0,  0, 16, 16, 16, 16,
+     8,  8, 24, 24,  8, 24,  8,  8,  8, 24,  8,  8, 24, 24, 24, 24,
+     0,  0, 16, 16,  0, 16,  0,  0,  0, 16,  0,  0, 16, 16, 16, 16,
+     0,  0, 16, 16,  0, 16,  0,  0,  0, 16,  0,  0, 16, 16, 16, 16,
+     8,  8, 24, 24,  8, 24,  8,  8,  8, 24,  8,  8, 24, 24, 24, 24,
+     8,  8, 24, 24,  8, 24,  8,  8,  8, 24,  8,  8, 24, 24, 24, 24,
+     0,  0, 16, 16,  0, 16,  0,  0,  0, 16,  0,  0, 16, 16, 16, 16,
+     8,  8, 24, 24,  8, 24,  8,  8,  8, 24,  8,  8, 24, 24, 24, 24,
+     8,  8, 24, 24,  8, 24,  8,  8,  8, 24,  8,  8, 24, 24, 24, 24};
+
+static const uint8_t crypto1_filter_lut_hi[256] = {
+     0,  0,  4,  4,  0,  4,  0,  0,  0,  4,  0,  0,  4,  4,  4,  4,
+     0,  0,  4,  4,  0,  4,  0,  0,  0,  4,  0,  0,  4,  4,  4,  4,
+     2,  2,  6,  6,  2,  6,  2,  2,  2,  6,  2,  2,  6,  6,  6,  6,
+     2,  2,  6,  6,  2,  6,  2,  2,  2,  6,  2,  2,  6,  6,  6,  6,
+     0,  0,  4,  4,  0,  4,  0,  0,  0,  4,  0,  0,  4,  4,  4,  4,
+     2,  2,  6,  6,  2,  6,  2,  2,  2,  6,  2,  2,  6,  6,  6,  6,
+     0,  0,  4,  4,  0,  4,  0,  0,  0,  4,  0,  0,  4,  4,  4,  4,
+     0,  0,  4,  4,  0,  4,  0,  0,  0,  4,  0,  0,  4,  4,  4,  4,
+     0,  0,  4,  4,  0,  4,  0,  0,  0,  4,  0,  0,  4,  4,  4,  4,
+     2,  2,  6,  6,  2,  6,  2,  2,  2,  6,  2,  2,  6,  6,  6,  6,
+     0,  0,  4,  4,  0,  4,  0,  0,  0,  4,  0,  0,  4,  4,  4,  4,
+     0,  0,  4,  4,  0,  4,  0,  0,  0,  4,  0,  0,  4,  4,  4,  4,
+     2,  2,  6,  6,  2,  6,  2,  2,  2,  6,  2,  2,  6,  6,  6,  6,
+     2,  2,  6,  6,  2,  6,  2,  2,  2,  6,  2,  2,  6,  6,  6,  6,
+     2,  2,  6,  6,  2,  6,  2,  2,  2,  6,  2,  2,  6,  6,  6,  6,
+     2,  2,  6,  6,  2,  6,  2,  2,  2,  6,  2,  2,  6,  6,  6,  6};
+
+static inline uint32_t crypto1_filter_fast(uint32_t in) {
+    uint32_t out = crypto1_filter_lut_lo[in & 0xff] | crypto1_filter_lut_hi[(in >> 8) & 0xff];
+    out |= 0x0d938 >> (in >> 16 & 0xf) & 1;
+    return FURI_BIT(0xEC57E80A, out);
+}
+
+static inline uint32_t crypto1_parity_fast(uint32_t x) {
+#if !defined __GNUC__
+    return evenparity32(x);
+#else
+    return __builtin_parity(x);
+#endif
+}
+
+// One LFSR clock on registers held in locals, returns the keystream bit
+static inline uint32_t
+    crypto1_clock(uint32_t* odd, uint32_t* even, uint32_t in, uint32_t is_encrypted) {
+    uint32_t out = crypto1_filter_fast(*odd);
+    uint32_t feed = crypto1_parity_fast((LF_POLY_ODD & *odd) ^ (LF_POLY_EVEN & *even));
+    feed ^= (out & is_encrypted) ^ in;
+    uint32_t t = *odd;
+    *odd = *even << 1 | feed;
+    *even = t;
+    return out;
+}
+
 void crypto1_reset(Crypto1* crypto1) {
     furi_assert(crypto1);
     crypto1->even = 0;
@@ -18,6 +81,10 @@ void crypto1_init(Crypto1* crypto1, uint64_t key) {
 }
 
 uint32_t crypto1_filter(uint32_t in) {
+    return crypto1_filter_fast(in);
+}
+
+uint32_t crypto1_filter_reference(uint32_t in) {
     uint32_t out = 0;
     out = 0xf22c0 >> (in & 0xf) & 16;
     out |= 0x6c9c0 >> (in >> 4 & 0xf) & 8;
@@ -29,7 +96,7 @@ uint32_t crypto1_filter(uint32_t in) {
 
 uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
-    uint8_t out = crypto1_filter(crypto1->odd);
+    uint8_t out = crypto1_filter_reference(crypto1->odd);
     uint32_t feed = out & (!!is_encrypted);
     feed ^= !!in;
     feed ^= LF_POLY_ODD & crypto1->odd;
@@ -42,14 +109,40 @@ uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
 
 uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
+    uint32_t odd = crypto1->odd, even = crypto1->even;
+    uint32_t enc = !!is_encrypted;
     uint8_t out = 0;
     for(uint8_t i = 0; i < 8; i++) {
-        out |= crypto1_bit(crypto1, FURI_BIT(in, i), is_encrypted) << i;
+        out |= crypto1_clock(&odd, &even, FURI_BIT(in, i), enc) << i;
     }
+    crypto1->odd = odd;
+    crypto1->even = even;
     return out;
 }
 
 uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    uint32_t odd = crypto1->odd, even = crypto1->even;
+    uint32_t enc = !!is_encrypted;
+    uint32_t out = 0;
+    for(uint8_t i = 0; i < 32; i++) {
+        out |= crypto1_clock(&odd, &even, BEBIT(in, i), enc) << (24 ^ i);
+    }
+    crypto1->odd = odd;
+    crypto1->even = even;
+    return out;
+}
+
+uint8_t crypto1_byte_reference(Crypto1* crypto1, uint8_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    uint8_t out = 0;
+    for(uint8_t i = 0; i < 8; i++) {
+        out |= crypto1_bit(crypto1, FURI_BIT(in, i), is_encrypted) << i;
+    }
+    return out;
+}
+
+uint32_t crypto1_word_reference(Crypto1* crypto1, uint32_t in, int is_encrypted) {
     furi_assert(crypto1);
     uint32_t out = 0;
     for(uint8_t i = 0; i < 32; i++) {
@@ -75,11 +168,14 @@ void crypto1_decrypt(
     furi_assert(decrypted_data);
 
     if(encrypted_data_bits < 8) {
+        uint32_t odd = crypto->odd, even = crypto->even;
         uint8_t decrypted_byte = 0;
-        decrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(encrypted_data[0], 0)) << 0;
-        decrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(encrypted_data[0], 1)) << 1;
-        decrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(encrypted_data[0], 2)) << 2;
-        decrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(encrypted_data[0], 3)) << 3;
+        for(uint8_t i = 0; i < 4; i++) {
+            decrypted_byte |= (crypto1_clock(&odd, &even, 0, 0) ^ FURI_BIT(encrypted_data[0], i))
+                              << i;
+        }
+        crypto->odd = odd;
+        crypto->even = even;
         decrypted_data[0] = decrypted_byte;
     } else {
         for(size_t i = 0; i < encrypted_data_bits / 8; i++) {
@@ -22,6 +22,13 @@ uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted);
 
 uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted);
 
+// Bit-serial implementations kept for cross-checking the table-driven fast path
+uint32_t crypto1_filter_reference(uint32_t in);
+
+uint8_t crypto1_byte_reference(Crypto1* crypto1, uint8_t in, int is_encrypted);
+
+uint32_t crypto1_word_reference(Crypto1* crypto1, uint32_t in, int is_encrypted);
+
 uint32_t prng_successor(uint32_t x, uint32_t n);
 
 void crypto1_decrypt(
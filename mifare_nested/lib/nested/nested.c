@@ -1,6 +1,7 @@
 #include "nested.h"
 
 #include <furi_hal_nfc.h>
+#include <stdlib.h>
 #include "../../lib/parity/parity.h"
 #include "../../lib/crypto1/crypto1.h"
 #define TAG "Nested"
@@ -172,6 +173,133 @@ void nonce_distance(uint32_t* msb, uint32_t* lsb) {
     }
 }
 
+static inline uint16_t nested_prng_lfsr16_next(uint16_t x) {
+    return x >> 1 | (x ^ x >> 2 ^ x >> 3 ^ x >> 5) << 15;
+}
+
+static inline uint16_t nested_prng_swap16(uint16_t x) {
+    return (x & 0xff) << 8 | x >> 8;
+}
+
+static int nested_prng_lookup_cmp(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+NestedPrngIndex* nested_prng_index_alloc() {
+    NestedPrngIndex* index = malloc(sizeof(NestedPrngIndex));
+    uint16_t x = 1, ahead = 1;
+
+    for(uint8_t i = 0; i < 16; i++) {
+        ahead = nested_prng_lfsr16_next(ahead);
+    }
+
+    for(uint32_t pos = 0; pos < NESTED_PRNG_PERIOD; pos++) {
+        if(pos % NESTED_PRNG_STRIDE == 0) {
+            uint32_t j = pos / NESTED_PRNG_STRIDE;
+            index->landmark_nonce[j] = (uint32_t)nested_prng_swap16(x) << 16 |
+                                       nested_prng_swap16(ahead);
+            index->lookup[j] = (uint32_t)x << 16 | j;
+        }
+
+        x = nested_prng_lfsr16_next(x);
+        ahead = nested_prng_lfsr16_next(ahead);
+    }
+
+    qsort(index->lookup, NESTED_PRNG_LANDMARKS, sizeof(uint32_t), nested_prng_lookup_cmp);
+
+    return index;
+}
+
+void nested_prng_index_free(NestedPrngIndex* index) {
+    furi_assert(index);
+    free(index);
+}
+
+static uint32_t nested_prng_index_position16(NestedPrngIndex* index, uint16_t value) {
+    uint16_t x = nested_prng_swap16(value);
+
+    if(!x) return NESTED_PRNG_INVALID;
+
+    // Walk forward until a landmark is hit, then step back by the walked distance
+    for(uint32_t steps = 0; steps < NESTED_PRNG_STRIDE; steps++) {
+        uint32_t lo = 0, hi = NESTED_PRNG_LANDMARKS;
+
+        while(lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            if((index->lookup[mid] >> 16) < x) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        if(lo < NESTED_PRNG_LANDMARKS && (index->lookup[lo] >> 16) == x) {
+            return ((index->lookup[lo] & 0xFFFF) * NESTED_PRNG_STRIDE + NESTED_PRNG_PERIOD -
+                    steps) %
+                   NESTED_PRNG_PERIOD;
+        }
+
+        x = nested_prng_lfsr16_next(x);
+    }
+
+    return NESTED_PRNG_INVALID;
+}
+
+uint32_t nested_prng_index_position(NestedPrngIndex* index, uint32_t nt) {
+    furi_assert(index);
+
+    // Successors of nt only depend on its lower half, which is 16 steps ahead
+    uint32_t pos = nested_prng_index_position16(index, nt & 0xFFFF);
+
+    if(pos == NESTED_PRNG_INVALID) return pos;
+
+    return (pos + NESTED_PRNG_PERIOD - 16) % NESTED_PRNG_PERIOD;
+}
+
+uint32_t nested_prng_index_successor(NestedPrngIndex* index, uint32_t nt, uint32_t n) {
+    furi_assert(index);
+
+    if(n < NESTED_PRNG_STRIDE) return prng_successor(nt, n);
+
+    uint32_t pos = nested_prng_index_position(index, nt);
+
+    if(pos == NESTED_PRNG_INVALID) return prng_successor(nt, n);
+
+    pos = (pos + n % NESTED_PRNG_PERIOD) % NESTED_PRNG_PERIOD;
+
+    return prng_successor(
+        index->landmark_nonce[pos / NESTED_PRNG_STRIDE], pos % NESTED_PRNG_STRIDE);
+}
+
+uint32_t nested_prng_index_distance(
+    NestedPrngIndex* index,
+    uint32_t nt1,
+    uint32_t nt2,
+    uint32_t start,
+    uint32_t limit) {
+    furi_assert(index);
+
+    uint32_t from = nested_prng_index_position(index, nt1);
+    uint32_t to = nested_prng_index_position16(index, nt2 >> 16);
+
+    if(from == NESTED_PRNG_INVALID || to == NESTED_PRNG_INVALID) return limit;
+
+    // nt2 has to be a well-formed nonce: lower half 16 steps after the upper one
+    if(nested_prng_index_position16(index, nt2 & 0xFFFF) != (to + 16) % NESTED_PRNG_PERIOD) {
+        return limit;
+    }
+
+    uint32_t distance = (to + NESTED_PRNG_PERIOD - from) % NESTED_PRNG_PERIOD;
+
+    while(distance < start) {
+        distance += NESTED_PRNG_PERIOD;
+    }
+
+    return distance < limit ? distance : limit;
+}
+
 bool validate_prng_nonce(uint32_t nonce) {
     uint32_t msb = nonce >> 16;
     uint32_t lsb = nonce & 0xffff;
@@ -314,7 +442,8 @@ uint32_t nested_calibrate_distance(
     uint8_t keyType,
     uint64_t ui64Key,
     uint32_t delay,
-    bool full) {
+    bool full,
+    NestedPrngIndex* prng_index) {
     uint32_t cuid = 0;
     Crypto1* crypto = malloc(sizeof(Crypto1));
     uint32_t nt1, nt2, i = 0, davg = 0, dmin = 0, dmax = 0, rtr = 0, unsuccessful_tries = 0;
@@ -337,12 +466,7 @@ uint32_t nested_calibrate_distance(
         }
 
         // NXP Mifare is typical around 840, but for some unlicensed/compatible mifare tag this can be 160
-        uint32_t nttmp = prng_successor(nt1, 100);
-
-        for(i = 101; i < max_prng_value; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = nested_prng_index_distance(prng_index, nt1, nt2, 101, max_prng_value);
 
         if(i != max_prng_value) {
             if(rtr != 0) {
@@ -391,7 +515,8 @@ struct distance_info nested_calibrate_distance_info(
     FuriHalNfcTxRxContext* tx_rx,
     uint8_t blockNo,
     uint8_t keyType,
-    uint64_t ui64Key) {
+    uint64_t ui64Key,
+    NestedPrngIndex* prng_index) {
     uint32_t cuid = 0;
     Crypto1* crypto = malloc(sizeof(Crypto1));
     uint32_t nt1, nt2, i = 0, davg = 0, dmin = 0, dmax = 0, rtr = 0, unsuccessful_tries = 0;
@@ -409,12 +534,7 @@ struct distance_info nested_calibrate_distance_info(
         mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
         // NXP Mifare is typical around 840, but for some unlicensed/compatible mifare tag this can be 160
-        uint32_t nttmp = prng_successor(nt1, 1);
-
-        for(i = 2; i < 65565; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = nested_prng_index_distance(prng_index, nt1, nt2, 2, 65565);
 
         if(i != 65565) {
             if(rtr != 0) {
@@ -466,7 +586,8 @@ struct nonce_info nested_attack(
     uint8_t targetKeyType,
     uint64_t ui64Key,
     uint32_t distance,
-    uint32_t delay) {
+    uint32_t delay,
+    NestedPrngIndex* prng_index) {
     uint32_t cuid = 0;
     Crypto1* crypto = malloc(sizeof(Crypto1));
     uint8_t par_array[4] = {0x00};
@@ -507,7 +628,7 @@ struct nonce_info nested_attack(
             }
 
             uint32_t ncount = 0;
-            uint32_t nttest = prng_successor(nt1, dmin - 1);
+            uint32_t nttest = nested_prng_index_successor(prng_index, nt1, dmin - 1);
 
             for(j = dmin; j < dmax + 1; j++) {
                 nttest = prng_successor(nttest, 1);
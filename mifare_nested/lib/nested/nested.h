@@ -44,6 +44,37 @@ struct distance_info {
     uint32_t mid_prng;
 };
 
+// Weak PRNG is a 16-bit LFSR with this period
+#define NESTED_PRNG_PERIOD (65535)
+// Distance between indexed PRNG positions, bounds the walk per lookup
+#define NESTED_PRNG_STRIDE (128)
+#define NESTED_PRNG_LANDMARKS ((NESTED_PRNG_PERIOD + NESTED_PRNG_STRIDE - 1) / NESTED_PRNG_STRIDE)
+#define NESTED_PRNG_INVALID (0xFFFFFFFF)
+
+// Baby-step/giant-step index over the PRNG cycle (~4 KB)
+typedef struct {
+    uint32_t landmark_nonce[NESTED_PRNG_LANDMARKS]; // Nonce at position i * NESTED_PRNG_STRIDE
+    uint32_t lookup[NESTED_PRNG_LANDMARKS]; // LFSR state << 16 | landmark, sorted
+} NestedPrngIndex;
+
+NestedPrngIndex* nested_prng_index_alloc();
+
+void nested_prng_index_free(NestedPrngIndex* index);
+
+// Position of the PRNG state reached by nt, or NESTED_PRNG_INVALID
+uint32_t nested_prng_index_position(NestedPrngIndex* index, uint32_t nt);
+
+// Same as prng_successor(nt, n), in at most NESTED_PRNG_STRIDE steps
+uint32_t nested_prng_index_successor(NestedPrngIndex* index, uint32_t nt, uint32_t n);
+
+// Smallest i in [start, limit) with prng_successor(nt1, i) == nt2, limit if there is none
+uint32_t nested_prng_index_distance(
+    NestedPrngIndex* index,
+    uint32_t nt1,
+    uint32_t nt2,
+    uint32_t start,
+    uint32_t limit);
+
 struct nonce_info_static nested_static_nonce_attack(
     FuriHalNfcTxRxContext* tx_rx,
     uint8_t blockNo,
@@ -60,7 +91,8 @@ struct nonce_info nested_attack(
     uint8_t targetKeyType,
     uint64_t ui64Key,
     uint32_t distance,
-    uint32_t delay);
+    uint32_t delay,
+    NestedPrngIndex* prng_index);
 
 struct nonce_info_hard nested_hard_nonce_attack(
     FuriHalNfcTxRxContext* tx_rx,
@@ -79,13 +111,15 @@ uint32_t nested_calibrate_distance(
     uint8_t keyType,
     uint64_t ui64Key,
     uint32_t delay,
-    bool full);
+    bool full,
+    NestedPrngIndex* prng_index);
 
 struct distance_info nested_calibrate_distance_info(
     FuriHalNfcTxRxContext* tx_rx,
     uint8_t blockNo,
     uint8_t keyType,
-    uint64_t ui64Key);
+    uint64_t ui64Key,
+    NestedPrngIndex* prng_index);
 
 typedef enum {
     NestedCheckKeyNoTag,
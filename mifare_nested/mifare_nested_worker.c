@@ -34,6 +34,7 @@ MifareNestedWorker* mifare_nested_worker_alloc() {
 
     mifare_nested_worker->callback = NULL;
     mifare_nested_worker->context = NULL;
+    mifare_nested_worker->prng_index = nested_prng_index_alloc();
 
     mifare_nested_worker_change_state(mifare_nested_worker, MifareNestedWorkerStateReady);
 
@@ -44,6 +45,7 @@ void mifare_nested_worker_free(MifareNestedWorker* mifare_nested_worker) {
     furi_assert(mifare_nested_worker);
 
     furi_thread_free(mifare_nested_worker->thread);
+    nested_prng_index_free(mifare_nested_worker->prng_index);
     free(mifare_nested_worker);
 }
 
@@ -315,12 +317,7 @@ uint32_t mifare_nested_worker_predict_delay(
         mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
         // Searching for delay, where PRNG will be near 800
-        uint32_t nttmp = prng_successor(nt1, 100);
-
-        for(i = 101; i < 65565; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = nested_prng_index_distance(mifare_nested_worker->prng_index, nt1, nt2, 101, 65565);
 
         if(!rtr) {
             zero_prng_value = i;
@@ -380,12 +377,7 @@ uint32_t mifare_nested_worker_predict_delay(
             mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
             // Searching for delay, where PRNG will be near 800
-            uint32_t nttmp = prng_successor(nt1, 0);
-
-            for(i = 1; i < 65565; i++) {
-                nttmp = prng_successor(nttmp, 1);
-                if(nttmp == nt2) break;
-            }
+            i = nested_prng_index_distance(mifare_nested_worker->prng_index, nt1, nt2, 1, 65565);
 
             if(!(i > previous - 50 && i < previous + 50) && rtz) {
                 repeat++;
@@ -1174,16 +1166,35 @@ void mifare_nested_worker_collect_nonces(MifareNestedWorker* mifare_nested_worke
         mifare_nested_worker->callback(
             MifareNestedWorkerEventCalibrating, mifare_nested_worker->context);
 
-        distance = nested_calibrate_distance(&tx_rx, key_block, found_key_type, key, delay, false);
+        distance = nested_calibrate_distance(
+            &tx_rx,
+            key_block,
+            found_key_type,
+            key,
+            delay,
+            false,
+            mifare_nested_worker->prng_index);
 
         if(mifare_nested_worker->state == MifareNestedWorkerStateCollecting) {
-            first_distance =
-                nested_calibrate_distance(&tx_rx, key_block, found_key_type, key, delay, true);
+            first_distance = nested_calibrate_distance(
+                &tx_rx,
+                key_block,
+                found_key_type,
+                key,
+                delay,
+                true,
+                mifare_nested_worker->prng_index);
         }
 
         if(mifare_nested_worker->state == MifareNestedWorkerStateCollecting) {
-            second_distance =
-                nested_calibrate_distance(&tx_rx, key_block, found_key_type, key, 10000, true);
+            second_distance = nested_calibrate_distance(
+                &tx_rx,
+                key_block,
+                found_key_type,
+                key,
+                10000,
+                true,
+                mifare_nested_worker->prng_index);
         }
 
         if(first_distance == 0 && second_distance == 0) {
@@ -1206,8 +1217,8 @@ void mifare_nested_worker_collect_nonces(MifareNestedWorker* mifare_nested_worke
                 first_distance,
                 second_distance);
 
-            struct distance_info info =
-                nested_calibrate_distance_info(&tx_rx, key_block, found_key_type, key);
+            struct distance_info info = nested_calibrate_distance_info(
+                &tx_rx, key_block, found_key_type, key, mifare_nested_worker->prng_index);
 
             if(info.max_prng - info.min_prng > 150) {
                 FURI_LOG_W(
@@ -1223,8 +1234,14 @@ void mifare_nested_worker_collect_nonces(MifareNestedWorker* mifare_nested_worke
                     TAG,
                     "PRNG is stable, using method without delay! (May be false positive, still will collect x3 times)");
 
-                distance =
-                    nested_calibrate_distance(&tx_rx, key_block, found_key_type, key, delay, true);
+                distance = nested_calibrate_distance(
+                    &tx_rx,
+                    key_block,
+                    found_key_type,
+                    key,
+                    delay,
+                    true,
+                    mifare_nested_worker->prng_index);
 
                 delay = 2;
                 tries_count = 3;
@@ -1285,7 +1302,13 @@ void mifare_nested_worker_collect_nonces(MifareNestedWorker* mifare_nested_worke
 
             if(mifare_nested_worker->state == MifareNestedWorkerStateCollecting && !failed) {
                 distance = nested_calibrate_distance(
-                    &tx_rx, key_block, found_key_type, key, delay, false);
+                    &tx_rx,
+                    key_block,
+                    found_key_type,
+                    key,
+                    delay,
+                    false,
+                    mifare_nested_worker->prng_index);
             }
 
             if(distance == 0 && !failed) {
@@ -1370,7 +1393,8 @@ void mifare_nested_worker_collect_nonces(MifareNestedWorker* mifare_nested_worke
                             key_type,
                             key,
                             distance,
-                            delay);
+                            delay,
+                            mifare_nested_worker->prng_index);
 
                         if(result.full) {
                             FURI_LOG_I(
@@ -3,6 +3,7 @@
 #include <furi.h>
 #include "mifare_nested_i.h"
 #include "mifare_nested_worker.h"
+#include "lib/nested/nested.h"
 
 struct MifareNestedWorker {
     FuriThread* thread;
@@ -13,6 +14,8 @@ struct MifareNestedWorker {
     MifareNested* context;
 
     MifareNestedWorkerState state;
+
+    NestedPrngIndex* prng_index;
 };
 
 int32_t mifare_nested_worker_task(void* context);
@@ -0,0 +1,195 @@
+// Replays nonce pairs through the PRNG position index and checks distances
+// and successors against the linear walk the worker used before, then
+// compares the time per lookup.
+//
+//   make -C mifare_nested/test run
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../lib/nested/nested.h"
+#include "../lib/crypto1/crypto1.h"
+
+#define TEST_PAIRS 2000
+#define BENCH_PAIRS 200
+
+struct FuriString {
+    char* text;
+};
+
+FuriString* furi_string_alloc_printf(const char* format, ...) {
+    FuriString* string = malloc(sizeof(FuriString));
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    string->text = malloc(length + 1);
+    va_start(args, format);
+    vsnprintf(string->text, length + 1, format, args);
+    va_end(args);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->text);
+    free(string);
+}
+
+size_t stream_write_string(Stream* stream, FuriString* string) {
+    (void)stream;
+    return strlen(string->text);
+}
+
+typedef struct {
+    uint32_t nt1;
+    uint32_t nt2;
+    uint32_t start;
+    uint32_t limit;
+} NoncePair;
+
+// Search windows of nested_calibrate_distance, nested_calibrate_distance_info
+// and mifare_nested_worker_predict_delay
+static const uint32_t windows[][2] = {{101, 65565}, {2, 65565}, {1, 65565}, {101, 1000}};
+
+static uint32_t rand_u32(void) {
+    return (uint32_t)rand() << 16 ^ (uint32_t)rand();
+}
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static uint32_t linear_distance(uint32_t nt1, uint32_t nt2, uint32_t start, uint32_t limit) {
+    uint32_t nttmp = prng_successor(nt1, start - 1);
+    uint32_t i;
+
+    for(i = start; i < limit; i++) {
+        nttmp = prng_successor(nttmp, 1);
+        if(nttmp == nt2) break;
+    }
+
+    return i;
+}
+
+// Tag nonces are PRNG outputs, so start from a random point of the cycle
+static uint32_t random_nonce(void) {
+    return prng_successor(0x01200145, rand() % NESTED_PRNG_PERIOD);
+}
+
+static NoncePair random_pair(int i) {
+    NoncePair pair;
+    pair.start = windows[i % 4][0];
+    pair.limit = windows[i % 4][1];
+    pair.nt1 = random_nonce();
+
+    switch(i % 5) {
+    case 0: // garbled second nonce
+        pair.nt2 = rand_u32();
+        break;
+    case 1: // garbled first nonce
+        pair.nt1 = rand_u32();
+        pair.nt2 = prng_successor(pair.nt1, rand() % 65535);
+        break;
+    case 2: // close to the start of the window
+        pair.nt2 = prng_successor(pair.nt1, pair.start + rand() % 8);
+        pair.nt1 = prng_successor(pair.nt1, 4);
+        break;
+    default:
+        pair.nt2 = prng_successor(pair.nt1, rand() % 65600);
+        break;
+    }
+
+    return pair;
+}
+
+static int check(NestedPrngIndex* index) {
+    for(int i = 0; i < TEST_PAIRS; i++) {
+        NoncePair p = random_pair(i);
+        uint32_t expected = linear_distance(p.nt1, p.nt2, p.start, p.limit);
+        uint32_t actual = nested_prng_index_distance(index, p.nt1, p.nt2, p.start, p.limit);
+
+        if(actual != expected) {
+            printf(
+                "distance %08X -> %08X in [%u, %u): %u, expected %u\n",
+                p.nt1,
+                p.nt2,
+                p.start,
+                p.limit,
+                actual,
+                expected);
+            return 1;
+        }
+    }
+
+    for(int i = 0; i < TEST_PAIRS; i++) {
+        uint32_t nt = i % 5 ? random_nonce() : rand_u32();
+        uint32_t n = i % 3 ? (uint32_t)rand() % 140000 : (uint32_t)rand() % 256;
+
+        if(nested_prng_index_successor(index, nt, n) != prng_successor(nt, n)) {
+            printf("successor of %08X by %u differs\n", nt, n);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void bench(NestedPrngIndex* index) {
+    NoncePair pairs[BENCH_PAIRS];
+    volatile uint32_t sink = 0;
+
+    for(int i = 0; i < BENCH_PAIRS; i++) {
+        pairs[i] = random_pair(i);
+    }
+
+    double t0 = time_s();
+    for(int i = 0; i < BENCH_PAIRS; i++) {
+        NoncePair p = pairs[i];
+        sink += linear_distance(p.nt1, p.nt2, p.start, p.limit);
+    }
+    double linear = (time_s() - t0) / BENCH_PAIRS;
+
+    int rounds = 1000;
+    t0 = time_s();
+    for(int r = 0; r < rounds; r++) {
+        for(int i = 0; i < BENCH_PAIRS; i++) {
+            NoncePair p = pairs[i];
+            sink += nested_prng_index_distance(index, p.nt1, p.nt2, p.start, p.limit);
+        }
+    }
+    double indexed = (time_s() - t0) / BENCH_PAIRS / rounds;
+
+    t0 = time_s();
+    for(int r = 0; r < 20; r++) {
+        nested_prng_index_free(nested_prng_index_alloc());
+    }
+    double build = (time_s() - t0) / 20;
+
+    (void)sink;
+    printf(
+        "linear walk %9.2f us/pair\nindex       %9.2f us/pair (%.0fx)\n",
+        linear * 1e6,
+        indexed * 1e6,
+        linear / indexed);
+    printf(
+        "index build %9.2f us, %zu bytes\n", build * 1e6, sizeof(NestedPrngIndex));
+}
+
+int main(void) {
+    srand(1);
+    NestedPrngIndex* index = nested_prng_index_alloc();
+
+    if(check(index)) {
+        nested_prng_index_free(index);
+        return 1;
+    }
+    printf("%d nonce pairs match the linear walk\n", TEST_PAIRS);
+
+    bench(index);
+    nested_prng_index_free(index);
+    return 0;
+}
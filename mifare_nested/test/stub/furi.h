@@ -0,0 +1,28 @@
+#pragma once
+
+// Just enough of the firmware for lib/nested to build on the host
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FURI_BIT(x, n) (((x) >> (n)) & 1)
+#define furi_assert(x) (void)(x)
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+#define FURI_LOG_E(tag, ...) (void)(tag)
+#define FURI_LOG_I(tag, ...) (void)(tag)
+#define FURI_LOG_D(tag, ...) (void)(tag)
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc_printf(const char* format, ...);
+void furi_string_free(FuriString* string);
+
+static inline void furi_delay_us(uint32_t us) {
+    (void)us;
+}
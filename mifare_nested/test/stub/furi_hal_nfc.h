@@ -0,0 +1,107 @@
+#pragma once
+
+// NFC HAL with no reader attached: every poll and exchange fails
+
+#include <furi.h>
+
+#define FURI_HAL_NFC_LL_FDT_LISTEN_NFCA_POLLER (1172)
+#define FURI_HAL_NFC_LL_FDT_POLL_NFCA_POLLER (6780)
+#define FURI_HAL_NFC_LL_GT_NFCA (5000)
+
+typedef enum {
+    FuriHalNfcTxRxTypeDefault,
+    FuriHalNfcTxRxTypeRxNoCrc,
+    FuriHalNfcTxRxTypeRaw,
+} FuriHalNfcTxRxType;
+
+typedef enum {
+    FuriHalNfcReturnOk,
+    FuriHalNfcReturnTimeout,
+} FuriHalNfcReturn;
+
+typedef enum {
+    FuriHalNfcModePollNfca,
+} FuriHalNfcMode;
+
+typedef enum {
+    FuriHalNfcBitrate106,
+} FuriHalNfcBitrate;
+
+typedef enum {
+    FuriHalNfcErrorHandlingNfc,
+} FuriHalNfcErrorHandling;
+
+typedef struct {
+    uint8_t tx_data[512];
+    uint8_t tx_parity[64];
+    uint16_t tx_bits;
+    uint8_t rx_data[512];
+    uint8_t rx_parity[64];
+    uint16_t rx_bits;
+    FuriHalNfcTxRxType tx_rx_type;
+} FuriHalNfcTxRxContext;
+
+typedef struct {
+    uint8_t uid_len;
+    uint8_t uid[10];
+} FuriHalNfcDevData;
+
+static inline bool furi_hal_nfc_tx_rx(FuriHalNfcTxRxContext* tx_rx, uint16_t timeout_ms) {
+    (void)tx_rx;
+    (void)timeout_ms;
+    return false;
+}
+
+static inline bool furi_hal_nfc_activate_nfca(uint32_t timeout, uint32_t* cuid) {
+    (void)timeout;
+    (void)cuid;
+    return false;
+}
+
+static inline bool furi_hal_nfc_detect(FuriHalNfcDevData* dev_data, uint32_t timeout) {
+    (void)dev_data;
+    (void)timeout;
+    return false;
+}
+
+static inline void furi_hal_nfc_exit_sleep(void) {
+}
+
+static inline void furi_hal_nfc_start_sleep(void) {
+}
+
+static inline void furi_hal_nfc_sleep(void) {
+}
+
+static inline void furi_hal_nfc_ll_txrx_on(void) {
+}
+
+static inline void furi_hal_nfc_ll_txrx_off(void) {
+}
+
+static inline void furi_hal_nfc_ll_poll(void) {
+}
+
+static inline FuriHalNfcReturn
+    furi_hal_nfc_ll_set_mode(FuriHalNfcMode mode, FuriHalNfcBitrate tx, FuriHalNfcBitrate rx) {
+    (void)mode;
+    (void)tx;
+    (void)rx;
+    return FuriHalNfcReturnTimeout;
+}
+
+static inline void furi_hal_nfc_ll_set_fdt_listen(uint32_t cycles) {
+    (void)cycles;
+}
+
+static inline void furi_hal_nfc_ll_set_fdt_poll(uint32_t cycles) {
+    (void)cycles;
+}
+
+static inline void furi_hal_nfc_ll_set_guard_time(uint32_t cycles) {
+    (void)cycles;
+}
+
+static inline void furi_hal_nfc_ll_set_error_handling(FuriHalNfcErrorHandling error_handling) {
+    (void)error_handling;
+}
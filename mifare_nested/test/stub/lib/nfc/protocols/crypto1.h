@@ -0,0 +1,19 @@
+#pragma once
+
+// Just enough of the firmware for lib/crypto1 to build on the host
+
+#include <stdint.h>
+
+#define FURI_BIT(x, n) (((x) >> (n)) & 1)
+#define FURI_SWAP(a, b)         \
+    do {                        \
+        __typeof__(a) _tmp = a; \
+        a = b;                  \
+        b = _tmp;               \
+    } while(0)
+#define furi_assert(x) (void)(x)
+
+typedef struct {
+    uint32_t odd;
+    uint32_t even;
+} Crypto1;
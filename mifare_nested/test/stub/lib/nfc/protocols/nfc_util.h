@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+static inline uint64_t nfc_util_bytes2num(const uint8_t* src, uint8_t len) {
+    uint64_t res = 0;
+    while(len--) {
+        res = res << 8 | *src++;
+    }
+    return res;
+}
+
+static inline void nfc_util_num2bytes(uint64_t src, uint8_t len, uint8_t* dest) {
+    for(int i = len - 1; i >= 0; i--) {
+        dest[i] = (uint8_t)src;
+        src >>= 8;
+    }
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <furi.h>
+
+typedef struct Storage Storage;
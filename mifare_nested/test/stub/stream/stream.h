@@ -0,0 +1,7 @@
+#pragma once
+
+#include <furi.h>
+
+typedef struct Stream Stream;
+
+size_t stream_write_string(Stream* stream, FuriString* string);
@@ -152,10 +152,13 @@ ProtoViewApp* protoview_app_alloc() {
     // Signal found and visualization defaults
     app->signal_bestlen = 0;
     app->signal_last_scan_idx = 0;
+    app->signal_scan_tail = 0;
     app->signal_decoded = false;
     app->us_scale = PROTOVIEW_RAW_VIEW_DEFAULT_SCALE;
     app->signal_offset = 0;
     app->msg_info = NULL;
+    app->decode_bitmap = malloc(PROTOVIEW_DECODE_BITMAP_LEN);
+    app->scan_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 
     // Init Worker & Protocol
     app->txrx = malloc(sizeof(ProtoViewTxRx));
@@ -210,6 +213,8 @@ void protoview_app_free(ProtoViewApp* app) {
     free(app->txrx);
 
     // Raw samples buffers.
+    free(app->decode_bitmap);
+    furi_mutex_free(app->scan_mutex);
     raw_samples_free(RawSamples);
     raw_samples_free(DetectedSamples);
     furi_hal_power_suppress_charge_exit();
@@ -236,7 +241,8 @@ static void timer_callback(void* ctx) {
     }
     if(delta < RawSamples->total / 2) return;
     app->signal_last_scan_idx = RawSamples->idx;
-    scan_for_signal(app, RawSamples, ProtoViewModulations[app->modulation].duration_filter);
+    scan_for_signal(
+        app, RawSamples, ProtoViewModulations[app->modulation].duration_filter, delta);
 }
 
 /* This is the navigation callback we use in the view dispatcher used
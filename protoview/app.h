@@ -25,6 +25,7 @@
 #define PROTOVIEW_RAW_VIEW_DEFAULT_SCALE 100 // 100us is 1 pixel by default
 #define BITMAP_SEEK_NOT_FOUND UINT32_MAX // Returned by function as sentinel
 #define PROTOVIEW_VIEW_PRIVDATA_LEN 64 // View specific private data len
+#define PROTOVIEW_DECODE_BITMAP_LEN 4096 // Bytes of the decoding bitmap
 
 #define DEBUG_MSG 0
 
@@ -140,8 +141,17 @@ struct ProtoViewApp {
     uint32_t signal_bestlen; /* Longest coherent signal observed so far. */
     uint32_t signal_last_scan_idx; /* Index of the buffer last time we
                                       performed the scan. */
+    uint32_t signal_scan_tail; /* Samples at the end of the buffer in the
+                                  last scan that may belong to a signal
+                                  still in progress: they are scanned
+                                  again together with the new samples. */
     bool signal_decoded; /* Was the current signal decoded? */
     ProtoViewMsgInfo* msg_info; /* Decoded message info if not NULL. */
+    uint8_t* decode_bitmap; /* PROTOVIEW_DECODE_BITMAP_LEN bytes bitmap
+                               reused by every decode_signal() call. */
+    FuriMutex* scan_mutex; /* Serializes scan_for_signal(), that is called
+                              both by the timer and the build view, since
+                              they share decode_bitmap. */
     bool direct_sampling_enabled; /* This special view needs an explicit
                                      acknowledge to work. */
     void* view_privdata; /* This is a piece of memory of total size
@@ -220,6 +230,16 @@ typedef struct ProtoViewFieldSet {
     uint32_t numfields;
 } ProtoViewFieldSet;
 
+/* Per decoder counters, updated by decode_signal() each time the
+ * decoder is tried against a signal. */
+typedef struct ProtoViewDecoderStats {
+    uint32_t calls; /* Number of times the decoder was called. */
+    uint32_t decoded; /* Number of signals it was able to decode. */
+    uint32_t us; /* Total time spent inside decode(), in microseconds. */
+    uint32_t max_us; /* Slowest single decode() call, in microseconds. */
+    uint32_t skipped; /* Calls avoided because of the decoder metadata. */
+} ProtoViewDecoderStats;
+
 typedef struct ProtoViewDecoder {
     const char* name; /* Protocol name. */
     /* The decode function takes a buffer that is actually a bitmap, with
@@ -238,6 +258,20 @@ typedef struct ProtoViewDecoder {
     /* This method takes the fields supported by the decoder, and
      * renders a message in 'samples'. */
     void (*build_message)(RawSamplesBuffer* samples, ProtoViewFieldSet* fields);
+    /* Cheap admissibility checks performed by decode_signal() before
+     * calling decode(), in order to skip decoders that can't match the
+     * signal. A zero / NULL field means no constraint.
+     *
+     * Decoders don't check the absolute timing of the signal, so the
+     * short pulse ranges should be generous, just excluding durations
+     * that are several times off the protocol nominal timing. */
+    uint32_t short_pulse_min; /* Min detected short pulse, in us. */
+    uint32_t short_pulse_max; /* Max detected short pulse, in us. */
+    uint32_t min_bits; /* decode() always fails with less bitmap bits. */
+    const char* preamble; /* First (up to 8) bits of the sync pattern
+                             decode() searches in the bitmap. */
+    /* Runtime counters. Decoders don't need to initialize this field. */
+    ProtoViewDecoderStats stats;
 } ProtoViewDecoder;
 
 extern RawSamplesBuffer *RawSamples, *DetectedSamples;
@@ -256,7 +290,11 @@ void protoview_rx_callback(bool level, uint32_t duration, void* context);
 /* signal.c */
 uint32_t duration_delta(uint32_t a, uint32_t b);
 void reset_current_signal(ProtoViewApp* app);
-void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration);
+void scan_for_signal(
+    ProtoViewApp* app,
+    RawSamplesBuffer* source,
+    uint32_t min_duration,
+    uint32_t new_samples);
 bool bitmap_get(uint8_t* b, uint32_t blen, uint32_t bitpos);
 void bitmap_set(uint8_t* b, uint32_t blen, uint32_t bitpos, bool val);
 void bitmap_copy(
@@ -27,7 +27,7 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     uint32_t off;
     int j;
-    for(j = 0; j < 3; j++) {
+    for(j = 0; j < 6; j++) {
         off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_patterns[j]);
         if(off != BITMAP_SEEK_NOT_FOUND) break;
     }
@@ -90,4 +90,8 @@ ProtoViewDecoder B4B1Decoder = {
     .name = "PT/SC remote",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .short_pulse_min = 100,
+    .short_pulse_max = 1500,
+    .min_bits = 30,
+    .preamble = "10000000"};
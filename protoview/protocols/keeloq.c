@@ -117,5 +117,12 @@ static void build_message(RawSamplesBuffer* samples, ProtoViewFieldSet* fieldset
     }
 }
 
-ProtoViewDecoder KeeloqDecoder =
-    {.name = "Keeloq", .decode = decode, .get_fields = get_fields, .build_message = build_message};
+ProtoViewDecoder KeeloqDecoder = {
+    .name = "Keeloq",
+    .decode = decode,
+    .get_fields = get_fields,
+    .build_message = build_message,
+    .short_pulse_min = 100,
+    .short_pulse_max = 1500,
+    .min_bits = 3 * 66,
+    .preamble = "10101010"};
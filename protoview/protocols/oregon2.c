@@ -80,5 +80,12 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder Oregon2Decoder =
-    {.name = "Oregon2", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder Oregon2Decoder = {
+    .name = "Oregon2",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .short_pulse_min = 100,
+    .short_pulse_max = 1500,
+    .min_bits = 32,
+    .preamble = "01100110"};
@@ -202,4 +202,8 @@ ProtoViewDecoder ProtoViewChatDecoder = {
     .name = "ProtoView chat",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .short_pulse_min = 75,
+    .short_pulse_max = 1200,
+    .min_bits = 32 + 8 * 4,
+    .preamble = "10101010"};
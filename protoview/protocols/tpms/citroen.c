@@ -54,5 +54,12 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder CitroenTPMSDecoder =
-    {.name = "Citroen TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder CitroenTPMSDecoder = {
+    .name = "Citroen TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .short_pulse_min = 20,
+    .short_pulse_max = 400,
+    .min_bits = 17 + 8 * 10,
+    .preamble = "10101010"};
@@ -57,5 +57,12 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder FordTPMSDecoder =
-    {.name = "Ford TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder FordTPMSDecoder = {
+    .name = "Ford TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .short_pulse_min = 20,
+    .short_pulse_max = 400,
+    .min_bits = 16 + 8 * 8,
+    .preamble = "01010101"};
@@ -116,4 +116,8 @@ ProtoViewDecoder RenaultTPMSDecoder = {
     .name = "Renault TPMS",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .short_pulse_min = 20,
+    .short_pulse_max = 400,
+    .min_bits = USE_TEST_VECTOR ? 0 : 12 + 9 * 8,
+    .preamble = USE_TEST_VECTOR ? NULL : "01010101"};
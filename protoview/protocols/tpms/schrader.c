@@ -66,5 +66,12 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder SchraderTPMSDecoder =
-    {.name = "Schrader TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder SchraderTPMSDecoder = {
+    .name = "Schrader TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .short_pulse_min = 20,
+    .short_pulse_max = 400,
+    .min_bits = USE_TEST_VECTOR ? 0 : 64,
+    .preamble = USE_TEST_VECTOR ? NULL : "11110101"};
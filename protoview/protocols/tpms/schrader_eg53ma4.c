@@ -58,5 +58,12 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder SchraderEG53MA4TPMSDecoder =
-    {.name = "Schrader EG53MA4 TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder SchraderEG53MA4TPMSDecoder = {
+    .name = "Schrader EG53MA4 TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .short_pulse_min = 20,
+    .short_pulse_max = 400,
+    .min_bits = 20 - 8 + 8 * 10,
+    .preamble = "01010101"};
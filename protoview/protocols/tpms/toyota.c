@@ -77,5 +77,12 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder ToyotaTPMSDecoder =
-    {.name = "Toyota TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder ToyotaTPMSDecoder = {
+    .name = "Toyota TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .short_pulse_min = 20,
+    .short_pulse_max = 400,
+    .min_bits = 6 + 64 * 2,
+    .preamble = "001111"};
@@ -3,7 +3,7 @@
 
 #include "app.h"
 
-bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info);
+bool decode_signal(ProtoViewApp* app, RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info);
 
 /* =============================================================================
  * Protocols table.
@@ -56,6 +56,7 @@ uint32_t duration_delta(uint32_t a, uint32_t b) {
 void reset_current_signal(ProtoViewApp* app) {
     app->signal_bestlen = 0;
     app->signal_offset = 0;
+    app->signal_scan_tail = 0;
     app->signal_decoded = false;
     raw_samples_reset(DetectedSamples);
     raw_samples_reset(RawSamples);
@@ -65,7 +66,7 @@ void reset_current_signal(ProtoViewApp* app) {
 
 /* This function starts scanning samples at offset idx looking for the
  * longest run of pulses, either high or low, that are not much different
- * from each other, for a maximum of three duration classes.
+ * from each other, for a maximum of SEARCH_MAX_CLASSES duration classes.
  * So for instance 50 successive pulses that are roughly long 340us or 670us
  * will be sensed as a coherent signal (example: 312, 361, 700, 334, 667, ...)
  *
@@ -74,15 +75,46 @@ void reset_current_signal(ProtoViewApp* app) {
  * the level of the pulse.
  *
  * For instance Oregon2 sensors, in the case of protocol 2.1 will send
- * pulses of ~400us (RF on) VS ~580us (RF off). */
-#define SEARCH_CLASSES 3
+ * pulses of ~400us (RF on) VS ~580us (RF off).
+ *
+ * Each class tracks the average duration of its pulses and their average
+ * deviation from it, and accepts new pulses within a tolerance derived
+ * from such deviation: classes of very regular pulses get a tight
+ * tolerance, so that protocols using many close timings can be told
+ * apart, while jittery ones are allowed a larger one. A pulse is assigned
+ * to the closest class accepting it.
+ *
+ * Noise would easily fill many classes, so only the first
+ * SEARCH_BASE_CLASSES classes can be created freely: the additional ones
+ * are created only if all the existing classes of the same level have
+ * already been observed at least twice. */
+#define SEARCH_MAX_CLASSES 8
+#define SEARCH_BASE_CLASSES 3
+#define SEARCH_SETTLED_COUNT 4 /* Samples before a class tolerance adapts. */
+
+/* Until we have a few samples use a 20% tolerance, then four times the
+ * average deviation (that is in 1/16 us), but never less than 12.5% or
+ * more than 30% of the class duration. */
+static uint32_t search_class_tolerance(uint32_t classavg, uint32_t dev, uint32_t count) {
+    if(count < SEARCH_SETTLED_COUNT) return classavg / 5;
+    uint32_t tolerance = dev / 4;
+    if(tolerance < classavg / 8) tolerance = classavg / 8;
+    if(tolerance > classavg * 3 / 10) tolerance = classavg * 3 / 10;
+    return tolerance;
+}
+
 uint32_t search_coherent_signal(RawSamplesBuffer* s, uint32_t idx, uint32_t min_duration) {
     struct {
         uint32_t dur[2]; /* dur[0] = low, dur[1] = high */
         uint32_t count[2]; /* Associated observed frequency. */
-    } classes[SEARCH_CLASSES];
-
-    memset(classes, 0, sizeof(classes));
+        uint32_t dev[2]; /* Average absolute deviation from 'dur', in
+                            1/16 us: with short pulses the average of a
+                            few us would otherwise truncate to zero. */
+        uint32_t tolerance[2]; /* Accepted distance from 'dur', updated
+                                  together with it. */
+    } classes[SEARCH_MAX_CLASSES];
+    uint32_t numclasses[2] = {0, 0}; /* Classes in use for each level. Only
+                                        these are initialized. */
 
     // Set a min/max duration limit for samples to be considered part of a
     // coherent signal. The maximum length is fixed while the minimum
@@ -99,37 +131,46 @@ uint32_t search_coherent_signal(RawSamplesBuffer* s, uint32_t idx, uint32_t min_
 
         if(dur < min_duration || dur > max_duration) break; /* return. */
 
-        /* Let's see if it matches a class we already have or if we
-         * can populate a new (yet empty) class. */
-        uint32_t k;
-        for(k = 0; k < SEARCH_CLASSES; k++) {
-            if(classes[k].count[level] == 0) {
-                classes[k].dur[level] = dur;
-                classes[k].count[level] = 1;
-                break; /* Sample accepted. */
-            } else {
-                uint32_t classavg = classes[k].dur[level];
-                uint32_t count = classes[k].count[level];
-                uint32_t delta = duration_delta(dur, classavg);
-                /* Is the difference in duration between this signal and
-                 * the class we are inspecting less than a given percentage?
-                 * If so, accept this signal. */
-                if(delta < classavg / 5) { /* 100%/5 = 20%. */
-                    /* It is useful to compute the average of the class
-                     * we are observing. We know how many samples we got so
-                     * far, so we can recompute the average easily.
-                     * By always having a better estimate of the pulse len
-                     * we can avoid missing next samples in case the first
-                     * observed samples are too off. */
-                    classavg = ((classavg * count) + dur) / (count + 1);
-                    classes[k].dur[level] = classavg;
-                    classes[k].count[level]++;
-                    break; /* Sample accepted. */
-                }
+        /* Find the closest class accepting this sample. */
+        uint32_t best = SEARCH_MAX_CLASSES, best_delta = UINT32_MAX;
+        bool seen_twice = true; /* All the classes of this level have
+                                   at least two samples? */
+        for(uint32_t k = 0; k < numclasses[level]; k++) {
+            uint32_t delta = duration_delta(dur, classes[k].dur[level]);
+
+            if(classes[k].count[level] < 2) seen_twice = false;
+            if(delta < classes[k].tolerance[level] && delta < best_delta) {
+                best = k;
+                best_delta = delta;
             }
         }
 
-        if(k == SEARCH_CLASSES) break; /* No match, return. */
+        if(best != SEARCH_MAX_CLASSES) {
+            /* It is useful to compute the average of the class
+             * we are observing. We know how many samples we got so
+             * far, so we can recompute the average easily.
+             * By always having a better estimate of the pulse len
+             * we can avoid missing next samples in case the first
+             * observed samples are too off. */
+            uint32_t count = classes[best].count[level];
+            classes[best].dev[level] = ((classes[best].dev[level] * count) + best_delta * 16) /
+                                       (count + 1);
+            classes[best].dur[level] = ((classes[best].dur[level] * count) + dur) / (count + 1);
+            classes[best].count[level]++;
+            classes[best].tolerance[level] = search_class_tolerance(
+                classes[best].dur[level], classes[best].dev[level], count + 1);
+        } else if(
+            numclasses[level] < SEARCH_BASE_CLASSES ||
+            (numclasses[level] < SEARCH_MAX_CLASSES && seen_twice)) {
+            /* Populate a new class with this sample. */
+            uint32_t k = numclasses[level]++;
+            classes[k].dur[level] = dur;
+            classes[k].count[level] = 1;
+            classes[k].dev[level] = 0;
+            classes[k].tolerance[level] = search_class_tolerance(dur, 0, 1);
+        } else {
+            break; /* No match, return. */
+        }
 
         /* If we are here, we accepted this sample. Try with the next
          * one. */
@@ -137,12 +178,11 @@ uint32_t search_coherent_signal(RawSamplesBuffer* s, uint32_t idx, uint32_t min_
     }
 
     /* Update the buffer setting the shortest pulse we found
-     * among the three classes. This will be used when scaling
+     * among the classes. This will be used when scaling
      * for visualization. */
     uint32_t short_dur[2] = {0, 0};
-    for(int j = 0; j < SEARCH_CLASSES; j++) {
-        for(int level = 0; level < 2; level++) {
-            if(classes[j].dur[level] == 0) continue;
+    for(int level = 0; level < 2; level++) {
+        for(uint32_t j = 0; j < numclasses[level]; j++) {
             if(classes[j].count[level] < 3) continue;
             if(short_dur[level] == 0 || short_dur[level] > classes[j].dur[level]) {
                 short_dur[level] = classes[j].dur[level];
@@ -183,8 +223,24 @@ void notify_signal_detected(ProtoViewApp* app, bool decoded) {
 /* Search the source buffer with the stored signal (last N samples received)
  * in order to find a coherent signal. If a signal that does not appear to
  * be just noise is found, it is set in DetectedSamples global signal
- * buffer, that is what is rendered on the screen. */
-void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration) {
+ * buffer, that is what is rendered on the screen.
+ *
+ * 'new_samples' is the number of samples added to the buffer since the
+ * previous call: the older samples were already scanned, so we start from
+ * the first sample of the last run found by the previous scan (that could
+ * be continuing in the new samples) instead of from the start of the
+ * buffer. Pass the buffer total to scan it all.
+ *
+ * This incremental bookkeeping (app->signal_scan_tail) only applies to the
+ * live RawSamples buffer: other buffers, like the ones built by the build
+ * view, are always scanned whole and don't touch it. */
+void scan_for_signal(
+    ProtoViewApp* app,
+    RawSamplesBuffer* source,
+    uint32_t min_duration,
+    uint32_t new_samples) {
+    furi_mutex_acquire(app->scan_mutex, FuriWaitForever);
+
     /* We need to work on a copy: the source buffer may be populated
      * by the background thread receiving data. */
     RawSamplesBuffer* copy = raw_samples_alloc();
@@ -196,9 +252,14 @@ void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_d
                                        than a few samples it's very easy to
                                        mistake noise for signal. */
 
+    bool live = source == RawSamples;
     uint32_t i = 0;
+    uint32_t rescan = new_samples + app->signal_scan_tail;
+    if(live && new_samples < copy->total && rescan < copy->total) i = copy->total - rescan;
+    uint32_t last_start = i;
 
     while(i < copy->total - 1) {
+        last_start = i;
         uint32_t thislen = search_coherent_signal(copy, i, min_duration);
 
         /* For messages that are long enough, attempt decoding. */
@@ -214,7 +275,7 @@ void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_d
             /* decode_signal() expects the detected signal to start
              * from index zero .*/
             raw_samples_center(copy, i);
-            bool decoded = decode_signal(copy, thislen, info);
+            bool decoded = decode_signal(app, copy, thislen, info);
             copy->idx = saved_idx; /* Restore the index as we are scanning
                                       the signal in the loop. */
 
@@ -248,7 +309,9 @@ void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_d
         }
         i += thislen ? thislen : 1;
     }
+    if(live) app->signal_scan_tail = copy->total - last_start;
     raw_samples_free(copy);
+    furi_mutex_release(app->scan_mutex);
 }
 
 /* =============================================================================
@@ -286,6 +349,86 @@ bool bitmap_get(uint8_t* b, uint32_t blen, uint32_t bitpos) {
     return (b[byte] & (1 << bit)) != 0;
 }
 
+/* Get 'count' bits (1 to 32) of the bitmap 'b' of 'blen' bytes, starting
+ * at 'bitpos'. The bits are returned right-aligned in an integer, with the
+ * first bit of the bitmap as the most significant bit, so that reading
+ * "1101" returns 13. Like in bitmap_get(), out of range bits are zero.
+ *
+ * This is the building block of all the word at a time functions below:
+ * we load the 5 bytes covering the requested bits and shift them in place,
+ * instead of extracting the bits one after the other. */
+static inline uint32_t
+    bitmap_get_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, uint32_t count) {
+    uint32_t byte = bitpos / 8;
+    uint32_t skew = bitpos & 7;
+    uint64_t w;
+    if(byte < blen && blen - byte >= 5) {
+        w = (uint64_t)b[byte] << 32 | (uint32_t)b[byte + 1] << 24 |
+            (uint32_t)b[byte + 2] << 16 | (uint32_t)b[byte + 3] << 8 | b[byte + 4];
+    } else {
+        w = 0;
+        for(uint32_t j = 0; j < 5; j++) {
+            w <<= 8;
+            if(byte + j < blen) w |= b[byte + j];
+        }
+    }
+    return (w >> (40 - skew - count)) & (((uint64_t)1 << count) - 1);
+}
+
+/* Set 'count' bits of the bitmap 'b' of 'blen' bytes to 'val', starting
+ * at 'bitpos'. Whole bytes are filled at once. Out of range bits will
+ * silently be discarded. */
+static void
+    bitmap_set_run(uint8_t* b, uint32_t blen, uint32_t bitpos, uint32_t count, bool val) {
+    while(count && (bitpos & 7)) {
+        bitmap_set(b, blen, bitpos++, val);
+        count--;
+    }
+    uint32_t byte = bitpos / 8;
+    uint32_t bytes = count / 8;
+    if(byte < blen) {
+        uint32_t fill = MIN(bytes, blen - byte);
+        memset(b + byte, val ? 0xff : 0, fill);
+    }
+    bitpos += bytes * 8;
+    count &= 7;
+    while(count--) bitmap_set(b, blen, bitpos++, val);
+}
+
+/* A pattern in the "0110..." string form used by the protocols, compiled
+ * into an integer so that it can be matched with a few word compares
+ * instead of bit by bit. Patterns longer than 64 bits are not compiled
+ * and are matched with the bit by bit code. */
+typedef struct {
+    uint64_t bits; /* Pattern bits, right-aligned, first bit as MSB. */
+    uint32_t len; /* Pattern len in bits. */
+} BitmapPattern;
+
+/* Compile the string pattern 'str' into 'p'. Like bitmap_match_bits() any
+ * character that is not '1' is considered a zero. Returns false if the
+ * pattern is too long to be compiled. */
+static bool bitmap_pattern_compile(BitmapPattern* p, const char* str) {
+    p->bits = 0;
+    p->len = 0;
+    for(; str[p->len]; p->len++) {
+        if(p->len == 64) return false;
+        p->bits = (p->bits << 1) | (str[p->len] == '1');
+    }
+    return true;
+}
+
+/* Return true if the compiled pattern 'p' is found in the bitmap 'b' of
+ * 'blen' bytes at 'bitpos' position. */
+static inline bool
+    bitmap_match_pattern(uint8_t* b, uint32_t blen, uint32_t bitpos, const BitmapPattern* p) {
+    if(p->len == 0) return true;
+    if(p->len <= 32) return bitmap_get_bits(b, blen, bitpos, p->len) == p->bits;
+    uint32_t rest = p->len - 32;
+    return bitmap_get_bits(b, blen, bitpos, 32) == (uint32_t)(p->bits >> rest) &&
+           bitmap_get_bits(b, blen, bitpos + 32, rest) ==
+               (uint32_t)(p->bits & (((uint64_t)1 << rest) - 1));
+}
+
 /* Copy 'count' bits from the bitmap 's' of 'slen' total bytes, to the
  * bitmap 'd' of 'dlen' total bytes. The bits are copied starting from
  * offset 'soff' of the source bitmap to the offset 'doff' of the
@@ -403,6 +546,9 @@ void bitmap_reverse_bytes_bits(uint8_t* p, uint32_t len) {
  * form "11010110..." is found in the 'b' bitmap of 'blen' bits at 'bitpos'
  * position. */
 bool bitmap_match_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, const char* bits) {
+    BitmapPattern p;
+    if(bitmap_pattern_compile(&p, bits)) return bitmap_match_pattern(b, blen, bitpos, &p);
+
     for(size_t j = 0; bits[j]; j++) {
         bool expected = (bits[j] == '1') ? true : false;
         if(bitmap_get(b, blen, bitpos + j) != expected) return false;
@@ -415,9 +561,10 @@ bool bitmap_match_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, const char* b
  * Returns the offset (in bits) of the match, or BITMAP_SEEK_NOT_FOUND if not
  * found.
  *
- * Note: there are better algorithms, such as Boyer-Moore. Here we hope that
- * for the kind of patterns we search we'll have a lot of early stops so
- * we use a vanilla approach. */
+ * The search keeps a window with the next (up to) 32 bits of the bitmap
+ * and compares it with the head of the pattern: advancing one position
+ * just means shifting a new bit inside the window. Only when the head
+ * matches the rest of the pattern, if any, is checked. */
 uint32_t bitmap_seek_bits(
     uint8_t* b,
     uint32_t blen,
@@ -427,8 +574,26 @@ uint32_t bitmap_seek_bits(
     uint32_t endpos = startpos + blen * 8;
     uint32_t end2 = startpos + maxbits;
     if(end2 < endpos) endpos = end2;
-    for(uint32_t j = startpos; j < endpos; j++)
-        if(bitmap_match_bits(b, blen, j, bits)) return j;
+
+    BitmapPattern p;
+    if(!bitmap_pattern_compile(&p, bits)) {
+        for(uint32_t j = startpos; j < endpos; j++)
+            if(bitmap_match_bits(b, blen, j, bits)) return j;
+        return BITMAP_SEEK_NOT_FOUND;
+    }
+    if(p.len == 0) return startpos < endpos ? startpos : BITMAP_SEEK_NOT_FOUND;
+
+    uint32_t headlen = MIN(p.len, 32u);
+    uint32_t head = p.bits >> (p.len - headlen);
+    uint32_t mask = headlen == 32 ? UINT32_MAX : (1u << headlen) - 1;
+    uint32_t window = 0;
+    for(uint32_t j = startpos; j < endpos; j++) {
+        if(j == startpos)
+            window = bitmap_get_bits(b, blen, j, headlen);
+        else
+            window = ((window << 1) | bitmap_get(b, blen, j + headlen - 1)) & mask;
+        if(window == head && bitmap_match_pattern(b, blen, j, &p)) return j;
+    }
     return BITMAP_SEEK_NOT_FOUND;
 }
 
@@ -443,10 +608,13 @@ bool bitmap_match_bitmap(
     uint32_t b2len,
     uint32_t b2off,
     uint32_t cmplen) {
-    for(uint32_t j = 0; j < cmplen; j++) {
-        bool bit1 = bitmap_get(b1, b1len, b1off + j);
-        bool bit2 = bitmap_get(b2, b2len, b2off + j);
-        if(bit1 != bit2) return false;
+    while(cmplen) {
+        uint32_t count = MIN(cmplen, 32u);
+        if(bitmap_get_bits(b1, b1len, b1off, count) != bitmap_get_bits(b2, b2len, b2off, count))
+            return false;
+        b1off += count;
+        b2off += count;
+        cmplen -= count;
     }
     return true;
 }
@@ -530,7 +698,8 @@ uint32_t convert_signal_to_bits(
          * and ignore it completely. */
         if(numbits == 0) continue;
 
-        while(numbits--) bitmap_set(b, blen, bitpos++, level);
+        bitmap_set_run(b, blen, bitpos, numbits, level);
+        bitpos += numbits;
     }
     return bitpos;
 }
@@ -556,15 +725,25 @@ uint32_t convert_from_line_code(
     const char* zero_pattern,
     const char* one_pattern) {
     uint32_t decoded = 0; /* Number of bits extracted. */
+    uint32_t numbytes = len;
     len *= 8; /* Convert bytes to bits. */
+
+    /* Compile the patterns once, so that each symbol costs just a couple
+     * of word compares. Very long patterns use the string matching. */
+    BitmapPattern zero = {0}, one = {0};
+    bool compiled = bitmap_pattern_compile(&zero, zero_pattern) &&
+                    bitmap_pattern_compile(&one, one_pattern);
     while(off < len) {
         bool bitval;
-        if(bitmap_match_bits(bits, len, off, zero_pattern)) {
+        if(compiled ? bitmap_match_pattern(bits, numbytes, off, &zero) :
+                      bitmap_match_bits(bits, numbytes, off, zero_pattern)) {
             bitval = false;
-            off += strlen(zero_pattern);
-        } else if(bitmap_match_bits(bits, len, off, one_pattern)) {
+            off += compiled ? zero.len : strlen(zero_pattern);
+        } else if(
+            compiled ? bitmap_match_pattern(bits, numbytes, off, &one) :
+                       bitmap_match_bits(bits, numbytes, off, one_pattern)) {
             bitval = true;
-            off += strlen(one_pattern);
+            off += compiled ? one.len : strlen(one_pattern);
         } else {
             break;
         }
@@ -574,6 +753,37 @@ uint32_t convert_from_line_code(
     return decoded;
 }
 
+/* Differential Manchester decoding table: given 8 line code bits (four
+ * symbols) and the value of the previous line bit, DiffManchesterTable
+ * tells how many of the four symbols are valid, the data bits they
+ * represent and the last line bit. The entry for byte 'x' and previous
+ * bit 'p' is at index p*256+x and is encoded as:
+ *
+ *   bits 7-5: number of valid symbols (0 to 4).
+ *   bits 4-1: decoded data bits, first symbol as MSB, right-aligned
+ *             to the number of valid symbols.
+ *   bit 0:    the last line bit of the valid symbols (or 'p' if none).
+ *
+ * The table is filled the first time it is needed. */
+static uint8_t DiffManchesterTable[512];
+static bool DiffManchesterTableReady = false;
+
+static void diff_manchester_table_init(void) {
+    for(uint32_t idx = 0; idx < 512; idx++) {
+        bool previous = idx >> 8;
+        uint32_t valid = 0, data = 0;
+        for(; valid < 4; valid++) {
+            bool b0 = (idx >> (7 - valid * 2)) & 1;
+            bool b1 = (idx >> (6 - valid * 2)) & 1;
+            if(b0 == previous) break;
+            data = (data << 1) | (b0 == b1);
+            previous = b1;
+        }
+        DiffManchesterTable[idx] = valid << 5 | data << 1 | previous;
+    }
+    DiffManchesterTableReady = true;
+}
+
 /* Convert the differential Manchester code to bits. This is similar to
  * convert_from_line_code() but specific for diff-Manchester. The user must
  * supply the value of the previous symbol before this stream, since
@@ -588,10 +798,30 @@ uint32_t convert_from_diff_manchester(
     uint32_t off,
     bool previous) {
     uint32_t decoded = 0;
+    uint32_t numbytes = len;
     len *= 8; /* Conver to bits. */
-    for(uint32_t j = off; j < len; j += 2) {
-        bool b0 = bitmap_get(bits, len, j);
-        bool b1 = bitmap_get(bits, len, j + 1);
+    if(!DiffManchesterTableReady) diff_manchester_table_init();
+
+    /* Decode four symbols at a time while there are at least four symbols
+     * left, and space for four bits in the target buffer. */
+    uint32_t j = off;
+    while(j < len && len - j >= 8 && buflen * 8 - decoded >= 4) {
+        uint32_t line = bitmap_get_bits(bits, numbytes, j, 8);
+        uint8_t e = DiffManchesterTable[(uint32_t)previous << 8 | line];
+        uint32_t valid = e >> 5;
+        uint32_t data = (e >> 1) & 0xf;
+        for(uint32_t k = 0; k < valid; k++)
+            bitmap_set(buf, buflen, decoded++, (data >> (valid - 1 - k)) & 1);
+        previous = e & 1;
+        j += valid * 2;
+        if(valid != 4) return decoded; /* Invalid symbol found. */
+        if(decoded / 8 == buflen) return decoded; /* No space left. */
+    }
+
+    /* Handle the remaining symbols one by one. */
+    for(; j < len; j += 2) {
+        bool b0 = bitmap_get(bits, numbytes, j);
+        bool b1 = bitmap_get(bits, numbytes, j + 1);
         if(b0 == previous) break; /* Each new bit must switch value. */
         bitmap_set(buf, buflen, decoded++, b0 == b1);
         previous = b1;
@@ -617,20 +847,63 @@ void init_msg_info(ProtoViewMsgInfo* i, ProtoViewApp* app) {
     i->fieldset = fieldset_new();
 }
 
+/* Return true if the decoder metadata allows to call it for a signal
+ * with the specified short pulse duration. */
+static bool decoder_accepts_pulse(ProtoViewDecoder* d, uint32_t short_pulse_dur) {
+    if(d->short_pulse_min && short_pulse_dur < d->short_pulse_min) return false;
+    if(d->short_pulse_max && short_pulse_dur > d->short_pulse_max) return false;
+    return true;
+}
+
+/* Populate 'seen', a set of 256 bits, with all the 8 bits values found
+ * in the bitmap at any offset from 0 to numbits-1. This is computed once
+ * per signal and allows to check the decoders preambles in constant time,
+ * instead of letting each decoder scan the bitmap. */
+static void bitmap_collect_bytes(uint8_t* b, uint32_t blen, uint32_t numbits, uint8_t* seen) {
+    memset(seen, 0, 32);
+    uint32_t window = 0;
+    for(uint32_t j = 0; j < numbits; j++) {
+        if(j == 0)
+            window = bitmap_get_bits(b, blen, 0, 8);
+        else
+            window = ((window << 1) | bitmap_get(b, blen, j + 7)) & 0xff;
+        seen[window / 8] |= 1 << (window & 7);
+    }
+}
+
+/* Return true if some 8 bits value in the 'seen' set starts with the
+ * decoder preamble. */
+static bool decoder_preamble_seen(ProtoViewDecoder* d, uint8_t* seen) {
+    BitmapPattern p;
+    if(d->preamble == NULL || !bitmap_pattern_compile(&p, d->preamble) || p.len > 8)
+        return true;
+    uint32_t free_bits = 8 - p.len;
+    for(uint32_t ext = 0; ext < (1u << free_bits); ext++) {
+        uint32_t val = (uint32_t)p.bits << free_bits | ext;
+        if(seen[val / 8] & (1 << (val & 7))) return true;
+    }
+    return false;
+}
+
 /* This function is called when a new signal is detected. It converts it
  * to a bitstream, and the calls the protocol specific functions for
  * decoding. If the signal was decoded correctly by some protocol, true
- * is returned. Otherwise false is returned. */
-bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
-    uint32_t bitmap_bits_size = 4096 * 8;
-    uint32_t bitmap_size = bitmap_bits_size / 8;
+ * is returned. Otherwise false is returned.
+ *
+ * Decoders whose metadata (see ProtoViewDecoder) excludes the signal are
+ * not called at all. */
+bool decode_signal(ProtoViewApp* app, RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
+    uint32_t bitmap_size = PROTOVIEW_DECODE_BITMAP_LEN;
 
     /* We call the decoders with an offset a few samples before the actual
      * signal detected and for a len of a few bits after its end. */
     uint32_t before_samples = 32;
     uint32_t after_samples = 100;
 
-    uint8_t* bitmap = malloc(bitmap_size);
+    /* The bitmap is reused across calls. Decoders may look at bits after
+     * the end of the signal, so it must be clean like a new one. */
+    uint8_t* bitmap = app->decode_bitmap;
+    memset(bitmap, 0, bitmap_size);
     uint32_t bits = convert_signal_to_bits(
         bitmap,
         bitmap_size,
@@ -654,16 +927,58 @@ bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
     int j = 0;
 
     bool decoded = false;
-    while(Decoders[j]) {
-        uint32_t start_time = furi_get_tick();
+    uint8_t seen[32]; /* 8 bits values found in the bitmap. */
+    bool seen_ready = false;
+    for(; Decoders[j]; j++) {
+        ProtoViewDecoderStats* stats = &Decoders[j]->stats;
+        bool admissible = decoder_accepts_pulse(Decoders[j], s->short_pulse_dur) &&
+                          bits >= Decoders[j]->min_bits;
+        if(admissible && Decoders[j]->preamble) {
+            if(!seen_ready) {
+                bitmap_collect_bytes(bitmap, bitmap_size, bits, seen);
+                seen_ready = true;
+            }
+            admissible = decoder_preamble_seen(Decoders[j], seen);
+        }
+        if(!admissible) {
+            stats->skipped++;
+            if(DEBUG_MSG) {
+                /* Estimate the time saved using the average call time. */
+                uint32_t avg = stats->calls ? stats->us / stats->calls : 0;
+                FURI_LOG_E(
+                    TAG,
+                    "Decoder %s skipped (skipped:%lu, ~%lu us saved)",
+                    Decoders[j]->name,
+                    (unsigned long)stats->skipped,
+                    (unsigned long)(stats->skipped * avg));
+            }
+            continue;
+        }
+
+        /* The tick is a millisecond, too coarse for most decoders:
+         * use the cycle counter instead. */
+        uint32_t start_cycles = DWT->CYCCNT;
         decoded = Decoders[j]->decode(bitmap, bitmap_size, bits, info);
-        uint32_t delta = furi_get_tick() - start_time;
-        FURI_LOG_E(TAG, "Decoder %s took %lu ms", Decoders[j]->name, (unsigned long)delta);
+        uint32_t delta = (DWT->CYCCNT - start_cycles) /
+                         furi_hal_cortex_instructions_per_microsecond();
+        stats->calls++;
+        stats->us += delta;
+        if(delta > stats->max_us) stats->max_us = delta;
+        if(decoded) stats->decoded++;
+        if(DEBUG_MSG)
+            FURI_LOG_E(
+                TAG,
+                "Decoder %s: %lu us (calls:%lu decoded:%lu total:%lu max:%lu)",
+                Decoders[j]->name,
+                (unsigned long)delta,
+                (unsigned long)stats->calls,
+                (unsigned long)stats->decoded,
+                (unsigned long)stats->us,
+                (unsigned long)stats->max_us);
         if(decoded) {
             info->decoder = Decoders[j];
             break;
         }
-        j++;
     }
 
     if(!decoded) {
@@ -687,6 +1002,5 @@ bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
                 info->pulses_count);
         }
     }
-    free(bitmap);
     return decoded;
 }
@@ -0,0 +1,164 @@
+// Runs the coherent signal search over 2048-sample windows with the
+// adaptive duration classes and with the old three fixed classes, and
+// compares how often the planted signal is found and the CPU time per
+// window.
+//
+//   make -C protoview/test run
+
+#include <time.h>
+
+#include "corpus.h"
+
+#define CAPTURES_PER_DECODER 100
+#define SYNTHETIC_WINDOWS 200
+#define MIN_RUN 18 // Same as scan_for_signal()
+#define MIN_COVERAGE 0.9 // Part of the signal a run must cover to count
+#define MAX_CATEGORIES 16
+
+uint32_t search_coherent_signal(RawSamplesBuffer* s, uint32_t idx, uint32_t min_duration);
+uint32_t search_coherent_signal_ref(RawSamplesBuffer* s, uint32_t idx, uint32_t min_duration);
+
+typedef uint32_t (*SearchFn)(RawSamplesBuffer* s, uint32_t idx, uint32_t min_duration);
+
+typedef struct {
+    const char* name;
+    uint32_t windows;
+    uint32_t detected[2];
+    double coverage[2];
+    uint32_t noise_runs[2];
+    double seconds[2];
+} Category;
+
+static Category categories[MAX_CATEGORIES];
+static uint32_t num_categories;
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static Category* category(const char* name) {
+    for(uint32_t j = 0; j < num_categories; j++) {
+        if(strcmp(categories[j].name, name) == 0) return &categories[j];
+    }
+    categories[num_categories].name = name;
+    return &categories[num_categories++];
+}
+
+static uint32_t jitter(uint32_t dur, uint32_t pct) {
+    uint32_t range = dur * pct / 100;
+    return dur - range + (uint32_t)rand() % (range * 2 + 1);
+}
+
+// Whole-window signals: the cases the adaptive classes were written for
+static void add_synthetic(Corpus* corpus, const char* name, int kind) {
+    static const uint32_t timings[] = {1, 2, 3, 4, 6};
+    for(int w = 0; w < SYNTHETIC_WINDOWS; w++) {
+        corpus->captures = realloc(corpus->captures, sizeof(Capture) * (corpus->count + 1));
+        Capture* c = &corpus->captures[corpus->count++];
+        snprintf(c->label, sizeof(c->label), "%s", name);
+        c->samples = raw_samples_alloc();
+        c->min_duration = 30;
+        c->signal_start = 0;
+        c->signal_len = RAW_SAMPLES_NUM;
+        uint32_t te = 300;
+        for(uint32_t j = 0; j < RAW_SAMPLES_NUM; j++) {
+            uint32_t dur;
+            switch(kind) {
+            case 0:
+                dur = jitter(rand() & 1 ? te : te * 3, 10);
+                break;
+            case 1:
+                dur = jitter(rand() & 1 ? te : te * 2, 15);
+                break;
+            default:
+                dur = jitter(te * timings[rand() % 5], 5);
+                break;
+            }
+            raw_samples_add(c->samples, j & 1, dur);
+        }
+    }
+}
+
+static void scan_window(Capture* c, SearchFn search, int v, Category* cat) {
+    RawSamplesBuffer* s = c->samples;
+    uint32_t best = 0, noise_runs = 0;
+
+    double start = time_s();
+    for(uint32_t i = 0; i < s->total - 1;) {
+        uint32_t len = search(s, i, c->min_duration);
+        if(len > MIN_RUN) {
+            uint32_t a = MAX(i, c->signal_start);
+            uint32_t b = MIN(i + len, c->signal_start + c->signal_len);
+            if(b > a && b - a > best) best = b - a;
+            if(c->signal_len == 0) noise_runs++;
+        }
+        i += len ? len : 1;
+    }
+    cat->seconds[v] += time_s() - start;
+
+    cat->noise_runs[v] += noise_runs;
+    if(c->signal_len) {
+        double coverage = (double)best / c->signal_len;
+        cat->coverage[v] += coverage;
+        if(coverage >= MIN_COVERAGE) cat->detected[v]++;
+    }
+}
+
+int main(void) {
+    Corpus corpus = {0};
+    corpus_generate(&corpus, CAPTURES_PER_DECODER, 3);
+    add_synthetic(&corpus, "PWM 2 timings 10%", 0);
+    add_synthetic(&corpus, "Manchester 15%", 1);
+    add_synthetic(&corpus, "5 timings 5%", 2);
+
+    SearchFn search[2] = {search_coherent_signal_ref, search_coherent_signal};
+    for(uint32_t j = 0; j < corpus.count; j++) {
+        Capture* c = &corpus.captures[j];
+        const char* name = c->label[0] ? c->label : c->signal_len ? "pulse train" : "noise";
+        Category* cat = category(name);
+        cat->windows++;
+        for(int v = 0; v < 2; v++) scan_window(c, search[v], v, cat);
+    }
+
+    printf(
+        "%-20s %7s | %9s %8s %8s | %9s %8s %8s\n",
+        "",
+        "",
+        "old found",
+        "coverage",
+        "us/win",
+        "new found",
+        "coverage",
+        "us/win");
+    uint32_t found[2] = {0, 0};
+    double seconds[2] = {0, 0};
+    for(uint32_t j = 0; j < num_categories; j++) {
+        Category* cat = &categories[j];
+        printf("%-20s %7u", cat->name, cat->windows);
+        for(int v = 0; v < 2; v++) {
+            if(strcmp(cat->name, "noise") == 0)
+                printf(" | %4u runs %8s", cat->noise_runs[v], "");
+            else
+                printf(
+                    " | %8.1f%% %7.1f%%",
+                    100.0 * cat->detected[v] / cat->windows,
+                    100.0 * cat->coverage[v] / cat->windows);
+            printf(" %8.1f", cat->seconds[v] * 1e6 / cat->windows);
+            found[v] += cat->detected[v];
+            seconds[v] += cat->seconds[v];
+        }
+        printf("\n");
+    }
+    printf(
+        "\n%u windows: old %u found in %.1f ms, new %u found in %.1f ms\n",
+        corpus.count,
+        found[0],
+        seconds[0] * 1e3,
+        found[1],
+        seconds[1] * 1e3);
+
+    corpus_free(&corpus);
+    return found[1] < found[0];
+}
@@ -0,0 +1,178 @@
+#include "corpus.h"
+
+#define NOISE_MIN_US 30
+#define NOISE_MAX_US 3000
+#define JITTER_PCT 8
+
+static uint32_t rand_range(uint32_t min, uint32_t max) {
+    return min + (uint32_t)rand() % (max - min + 1);
+}
+
+static Capture* corpus_add(Corpus* corpus, const char* label, uint32_t min_duration) {
+    corpus->captures = realloc(corpus->captures, sizeof(Capture) * (corpus->count + 1));
+    Capture* c = &corpus->captures[corpus->count++];
+    snprintf(c->label, sizeof(c->label), "%s", label);
+    c->samples = raw_samples_alloc();
+    c->min_duration = min_duration;
+    c->signal_start = 0;
+    c->signal_len = 0;
+    return c;
+}
+
+static void add_noise(RawSamplesBuffer* s, uint32_t count) {
+    while(count--) {
+        raw_samples_add_or_update(s, rand() & 1, rand_range(NOISE_MIN_US, NOISE_MAX_US));
+    }
+}
+
+static void add_jittered(RawSamplesBuffer* s, bool level, uint32_t dur) {
+    int32_t jitter = (int32_t)dur * JITTER_PCT / 100;
+    int32_t d = (int32_t)dur + (int32_t)rand_range(0, jitter * 2) - jitter;
+    raw_samples_add_or_update(s, level, d > 1 ? d : 1);
+}
+
+// Noise, then the message with a gap around it, then noise up to a full buffer
+static void add_message(Capture* c, RawSamplesBuffer* msg, uint32_t repeat) {
+    RawSamplesBuffer* s = c->samples;
+    add_noise(s, rand_range(50, 600));
+    for(uint32_t r = 0; r < repeat; r++) {
+        raw_samples_add_or_update(s, false, 12000);
+        uint32_t start = s->idx;
+        for(uint32_t j = 0; j < msg->idx; j++) {
+            bool level;
+            uint32_t dur;
+            raw_samples_get(msg, j - msg->idx, &level, &dur);
+            add_jittered(s, level, dur);
+        }
+        if(r == 0) {
+            c->signal_start = start;
+            c->signal_len = s->idx - start;
+        }
+        raw_samples_add_or_update(s, false, 12000);
+    }
+    while(s->idx != 0 && s->idx < RAW_SAMPLES_NUM - 1) add_noise(s, 1);
+
+    /* Capture offsets are relative to the oldest sample, like the scan. */
+    c->signal_start = (c->signal_start + RAW_SAMPLES_NUM - s->idx) % RAW_SAMPLES_NUM;
+}
+
+static void randomize_fields(ProtoViewFieldSet* fs) {
+    for(uint32_t j = 0; j < fs->numfields; j++) {
+        ProtoViewField* f = fs->fields[j];
+        if(f->type == FieldTypeBytes) {
+            for(uint32_t k = 0; k < (f->len + 1) / 2; k++) f->bytes[k] = rand();
+        } else if(f->type != FieldTypeStr && f->type != FieldTypeFloat) {
+            field_incr_value(f, rand() % 256);
+        }
+    }
+}
+
+// Generic PWM / Manchester-like trains no decoder knows about
+static void add_pulse_train(Capture* c) {
+    uint32_t te = rand_range(150, 900);
+    uint32_t bits = rand_range(24, 200);
+    RawSamplesBuffer* msg = raw_samples_alloc();
+    bool pwm = rand() & 1;
+    for(uint32_t j = 0; j < bits; j++) {
+        bool one = rand() & 1;
+        if(pwm) {
+            raw_samples_add(msg, true, one ? te * 3 : te);
+            raw_samples_add(msg, false, one ? te : te * 3);
+        } else {
+            raw_samples_add_or_update(msg, one, te);
+            raw_samples_add_or_update(msg, !one, te);
+        }
+    }
+    add_message(c, msg, 1);
+    raw_samples_free(msg);
+}
+
+void corpus_generate(Corpus* corpus, uint32_t per_decoder, unsigned seed) {
+    srand(seed);
+    for(int j = 0; Decoders[j]; j++) {
+        ProtoViewDecoder* d = Decoders[j];
+        if(d->get_fields == NULL || d->build_message == NULL) continue;
+        for(uint32_t k = 0; k < per_decoder; k++) {
+            ProtoViewFieldSet* fs = fieldset_new();
+            d->get_fields(fs);
+            randomize_fields(fs);
+            RawSamplesBuffer* msg = raw_samples_alloc();
+            d->build_message(msg, fs);
+            Capture* c = corpus_add(corpus, d->name, 30);
+            add_message(c, msg, rand_range(1, 3));
+            raw_samples_free(msg);
+            fieldset_free(fs);
+        }
+    }
+
+    for(uint32_t k = 0; k < per_decoder; k++) {
+        Capture* c = corpus_add(corpus, "", 30);
+        add_noise(c->samples, RAW_SAMPLES_NUM);
+        c = corpus_add(corpus, "", 30);
+        add_pulse_train(c);
+    }
+}
+
+bool corpus_load_sub(Corpus* corpus, const char* path) {
+    FILE* fp = fopen(path, "r");
+    if(fp == NULL) return false;
+
+    const char* name = strrchr(path, '/');
+    Capture* c = corpus_add(corpus, name ? name + 1 : path, 30);
+    char line[4096];
+    while(fgets(line, sizeof(line), fp)) {
+        if(strncmp(line, "RAW_Data:", 9) != 0) continue;
+        char* p = line + 9;
+        char* end;
+        for(long v = strtol(p, &end, 10); end != p; v = strtol(p, &end, 10)) {
+            uint32_t dur = v < 0 ? -v : v;
+            raw_samples_add_or_update(c->samples, v > 0, dur > 32767 ? 32767 : dur);
+            p = end;
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+void corpus_free(Corpus* corpus) {
+    for(uint32_t j = 0; j < corpus->count; j++) raw_samples_free(corpus->captures[j].samples);
+    free(corpus->captures);
+    corpus->captures = NULL;
+    corpus->count = 0;
+}
+
+ProtoViewApp* replay_app_alloc(void) {
+    ProtoViewApp* app = calloc(1, sizeof(ProtoViewApp));
+    app->decode_bitmap = malloc(PROTOVIEW_DECODE_BITMAP_LEN);
+    app->scan_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    RawSamples = raw_samples_alloc();
+    DetectedSamples = raw_samples_alloc();
+    return app;
+}
+
+void replay_app_free(ProtoViewApp* app) {
+    free_msg_info(app->msg_info);
+    raw_samples_free(RawSamples);
+    raw_samples_free(DetectedSamples);
+    furi_mutex_free(app->scan_mutex);
+    free(app->decode_bitmap);
+    free(app);
+}
+
+bool replay_capture(ProtoViewApp* app, Capture* capture, char* result, size_t len) {
+    reset_current_signal(app);
+    raw_samples_copy(RawSamples, capture->samples);
+    scan_for_signal(app, RawSamples, capture->min_duration, RawSamples->total);
+
+    result[0] = 0;
+    if(app->msg_info == NULL || !app->signal_decoded) return false;
+
+    size_t used = snprintf(result, len, "%s", app->msg_info->decoder->name);
+    ProtoViewFieldSet* fs = app->msg_info->fieldset;
+    for(uint32_t j = 0; j < fs->numfields && used < len; j++) {
+        char value[64];
+        field_to_string(value, sizeof(value), fs->fields[j]);
+        used += snprintf(result + used, len - used, " %s=%s", fs->fields[j]->name, value);
+    }
+    return app->msg_info->decoder != &UnknownDecoder;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Labelled 2048-sample captures shared by the ProtoView host tests
+
+#include "../app.h"
+
+#define CAPTURE_LABEL_LEN 32
+
+typedef struct {
+    char label[CAPTURE_LABEL_LEN]; // Decoder that must decode it, empty for noise
+    RawSamplesBuffer* samples;
+    uint32_t min_duration; // Duration filter of the modulation
+    uint32_t signal_start; // First sample of the first message, if any
+    uint32_t signal_len; // Its samples, 0 for noise
+} Capture;
+
+typedef struct {
+    Capture* captures;
+    uint32_t count;
+} Corpus;
+
+// Messages built by every decoder implementing build_message(), with
+// jitter and surrounding noise, plus unlabelled noise and generic pulse
+// trains
+void corpus_generate(Corpus* corpus, uint32_t per_decoder, unsigned seed);
+
+// Flipper .sub file with RAW_Data lines, labelled with its file name
+bool corpus_load_sub(Corpus* corpus, const char* path);
+
+void corpus_free(Corpus* corpus);
+
+ProtoViewApp* replay_app_alloc(void);
+void replay_app_free(ProtoViewApp* app);
+
+// Scans the whole capture like the timer does and writes the decoder
+// name and fields of the resulting signal in 'result'. Returns true if
+// some decoder other than the Unknown one decoded it.
+bool replay_capture(ProtoViewApp* app, Capture* capture, char* result, size_t len);
+
+extern ProtoViewDecoder* Decoders[];
+extern ProtoViewDecoder UnknownDecoder;
@@ -0,0 +1,81 @@
+// Replays the capture corpus through scan_for_signal() and reports the
+// per-decoder counters kept in ProtoViewDecoder.stats.
+//
+//   make -C protoview/test run
+//   ./decoder_bench [capture.sub ...]   # recorded captures instead
+
+#include <time.h>
+
+#include "corpus.h"
+
+#define CAPTURES_PER_DECODER 50
+#define ROUNDS 20
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    Corpus corpus = {0};
+    if(argc > 1) {
+        for(int j = 1; j < argc; j++) {
+            if(!corpus_load_sub(&corpus, argv[j])) {
+                fprintf(stderr, "can't read %s\n", argv[j]);
+                return 1;
+            }
+        }
+    } else {
+        corpus_generate(&corpus, CAPTURES_PER_DECODER, 1);
+    }
+
+    ProtoViewApp* app = replay_app_alloc();
+    uint32_t labelled = 0, correct = 0;
+    char result[256];
+
+    double start = time_s();
+    for(int round = 0; round < ROUNDS; round++) {
+        for(uint32_t j = 0; j < corpus.count; j++) {
+            Capture* c = &corpus.captures[j];
+            bool decoded = replay_capture(app, c, result, sizeof(result));
+            if(round != 0 || argc > 1 || c->label[0] == 0) continue;
+            labelled++;
+            if(decoded && strncmp(result, c->label, strlen(c->label)) == 0) correct++;
+        }
+    }
+    double elapsed = time_s() - start;
+
+    printf(
+        "%u captures x %d rounds, %.1f us per capture\n",
+        corpus.count,
+        ROUNDS,
+        elapsed * 1e6 / corpus.count / ROUNDS);
+    if(labelled) printf("%u/%u labelled captures decoded as expected\n", correct, labelled);
+
+    printf(
+        "\n%-20s %8s %8s %8s %10s %8s %8s\n",
+        "decoder",
+        "calls",
+        "decoded",
+        "skipped",
+        "total us",
+        "us/call",
+        "max us");
+    for(int j = 0; Decoders[j]; j++) {
+        ProtoViewDecoderStats* s = &Decoders[j]->stats;
+        printf(
+            "%-20s %8u %8u %8u %10u %8.2f %8u\n",
+            Decoders[j]->name,
+            s->calls,
+            s->decoded,
+            s->skipped,
+            s->us,
+            s->calls ? (double)s->us / s->calls : 0,
+            s->max_us);
+    }
+
+    replay_app_free(app);
+    corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Replays the labelled capture corpus with and without the decoders
+// admissibility metadata, checks that every capture decodes to the same
+// message both ways and counts the decoder calls the metadata avoided.
+//
+//   make -C protoview/test run
+//   ./decoder_replay [capture.sub ...]   # recorded captures instead
+
+#include <time.h>
+
+#include "corpus.h"
+
+#define CAPTURES_PER_DECODER 200
+#define RESULT_LEN 256
+
+typedef struct {
+    uint32_t short_pulse_min;
+    uint32_t short_pulse_max;
+    uint32_t min_bits;
+    const char* preamble;
+} DecoderMetadata;
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void reset_stats(void) {
+    for(int j = 0; Decoders[j]; j++) memset(&Decoders[j]->stats, 0, sizeof(ProtoViewDecoderStats));
+}
+
+static double replay_all(ProtoViewApp* app, Corpus* corpus, char* results) {
+    reset_stats();
+    double start = time_s();
+    for(uint32_t j = 0; j < corpus->count; j++) {
+        replay_capture(app, &corpus->captures[j], results + j * RESULT_LEN, RESULT_LEN);
+    }
+    return time_s() - start;
+}
+
+int main(int argc, char** argv) {
+    Corpus corpus = {0};
+    if(argc > 1) {
+        for(int j = 1; j < argc; j++) {
+            if(!corpus_load_sub(&corpus, argv[j])) {
+                fprintf(stderr, "can't read %s\n", argv[j]);
+                return 1;
+            }
+        }
+    } else {
+        corpus_generate(&corpus, CAPTURES_PER_DECODER, 2);
+    }
+
+    ProtoViewApp* app = replay_app_alloc();
+    char* filtered = malloc(corpus.count * RESULT_LEN);
+    char* unfiltered = malloc(corpus.count * RESULT_LEN);
+    ProtoViewDecoderStats stats[32];
+    DecoderMetadata saved[32];
+
+    double t_filtered = replay_all(app, &corpus, filtered);
+    for(int j = 0; Decoders[j]; j++) {
+        ProtoViewDecoder* d = Decoders[j];
+        stats[j] = d->stats;
+        saved[j] = (DecoderMetadata){d->short_pulse_min, d->short_pulse_max, d->min_bits, d->preamble};
+        d->short_pulse_min = d->short_pulse_max = d->min_bits = 0;
+        d->preamble = NULL;
+    }
+    double t_unfiltered = replay_all(app, &corpus, unfiltered);
+
+    uint32_t differ = 0, labelled = 0, correct = 0;
+    for(uint32_t j = 0; j < corpus.count; j++) {
+        Capture* c = &corpus.captures[j];
+        char* a = filtered + j * RESULT_LEN;
+        char* b = unfiltered + j * RESULT_LEN;
+        if(strcmp(a, b) != 0) {
+            if(differ++ < 10) printf("capture %u (%s): \"%s\" vs \"%s\"\n", j, c->label, a, b);
+        }
+        if(argc == 1 && c->label[0]) {
+            labelled++;
+            if(strncmp(a, c->label, strlen(c->label)) == 0) correct++;
+        }
+    }
+
+    printf("%u captures, %u decoded differently with the metadata\n", corpus.count, differ);
+    if(labelled) printf("%u/%u labelled captures decoded as expected\n", correct, labelled);
+    printf(
+        "replay time %.1f ms with the metadata, %.1f ms without\n\n",
+        t_filtered * 1e3,
+        t_unfiltered * 1e3);
+
+    printf("%-20s %8s %8s %8s\n", "decoder", "calls", "skipped", "without");
+    uint32_t calls = 0, skipped = 0, calls_without = 0;
+    for(int j = 0; Decoders[j]; j++) {
+        printf(
+            "%-20s %8u %8u %8u\n",
+            Decoders[j]->name,
+            stats[j].calls,
+            stats[j].skipped,
+            Decoders[j]->stats.calls);
+        calls += stats[j].calls;
+        skipped += stats[j].skipped;
+        calls_without += Decoders[j]->stats.calls;
+    }
+    printf("%-20s %8u %8u %8u\n", "total", calls, skipped, calls_without);
+
+    for(int j = 0; Decoders[j]; j++) {
+        Decoders[j]->short_pulse_min = saved[j].short_pulse_min;
+        Decoders[j]->short_pulse_max = saved[j].short_pulse_max;
+        Decoders[j]->min_bits = saved[j].min_bits;
+        Decoders[j]->preamble = saved[j].preamble;
+    }
+    free(filtered);
+    free(unfiltered);
+    replay_app_free(app);
+    corpus_free(&corpus);
+    return differ != 0;
+}
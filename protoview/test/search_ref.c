@@ -0,0 +1,101 @@
+/* The coherent signal search as it was before the adaptive duration
+ * classes, kept as the reference for classifier_replay. */
+
+#include "../app.h"
+
+/* This function starts scanning samples at offset idx looking for the
+ * longest run of pulses, either high or low, that are not much different
+ * from each other, for a maximum of three duration classes.
+ * So for instance 50 successive pulses that are roughly long 340us or 670us
+ * will be sensed as a coherent signal (example: 312, 361, 700, 334, 667, ...)
+ *
+ * The classes are counted separtely for high and low signals (RF on / off)
+ * because many devices tend to have different pulse lenghts depending on
+ * the level of the pulse.
+ *
+ * For instance Oregon2 sensors, in the case of protocol 2.1 will send
+ * pulses of ~400us (RF on) VS ~580us (RF off). */
+#define SEARCH_CLASSES 3
+uint32_t search_coherent_signal_ref(RawSamplesBuffer* s, uint32_t idx, uint32_t min_duration) {
+    struct {
+        uint32_t dur[2]; /* dur[0] = low, dur[1] = high */
+        uint32_t count[2]; /* Associated observed frequency. */
+    } classes[SEARCH_CLASSES];
+
+    memset(classes, 0, sizeof(classes));
+
+    // Set a min/max duration limit for samples to be considered part of a
+    // coherent signal. The maximum length is fixed while the minimum
+    // is passed as argument, as depends on the data rate and in general
+    // on the signal to analyze.
+    uint32_t max_duration = 4000;
+
+    uint32_t len = 0; /* Observed len of coherent samples. */
+    s->short_pulse_dur = 0;
+    for(uint32_t j = idx; j < idx + s->total; j++) {
+        bool level;
+        uint32_t dur;
+        raw_samples_get(s, j, &level, &dur);
+
+        if(dur < min_duration || dur > max_duration) break; /* return. */
+
+        /* Let's see if it matches a class we already have or if we
+         * can populate a new (yet empty) class. */
+        uint32_t k;
+        for(k = 0; k < SEARCH_CLASSES; k++) {
+            if(classes[k].count[level] == 0) {
+                classes[k].dur[level] = dur;
+                classes[k].count[level] = 1;
+                break; /* Sample accepted. */
+            } else {
+                uint32_t classavg = classes[k].dur[level];
+                uint32_t count = classes[k].count[level];
+                uint32_t delta = duration_delta(dur, classavg);
+                /* Is the difference in duration between this signal and
+                 * the class we are inspecting less than a given percentage?
+                 * If so, accept this signal. */
+                if(delta < classavg / 5) { /* 100%/5 = 20%. */
+                    /* It is useful to compute the average of the class
+                     * we are observing. We know how many samples we got so
+                     * far, so we can recompute the average easily.
+                     * By always having a better estimate of the pulse len
+                     * we can avoid missing next samples in case the first
+                     * observed samples are too off. */
+                    classavg = ((classavg * count) + dur) / (count + 1);
+                    classes[k].dur[level] = classavg;
+                    classes[k].count[level]++;
+                    break; /* Sample accepted. */
+                }
+            }
+        }
+
+        if(k == SEARCH_CLASSES) break; /* No match, return. */
+
+        /* If we are here, we accepted this sample. Try with the next
+         * one. */
+        len++;
+    }
+
+    /* Update the buffer setting the shortest pulse we found
+     * among the three classes. This will be used when scaling
+     * for visualization. */
+    uint32_t short_dur[2] = {0, 0};
+    for(int j = 0; j < SEARCH_CLASSES; j++) {
+        for(int level = 0; level < 2; level++) {
+            if(classes[j].dur[level] == 0) continue;
+            if(classes[j].count[level] < 3) continue;
+            if(short_dur[level] == 0 || short_dur[level] > classes[j].dur[level]) {
+                short_dur[level] = classes[j].dur[level];
+            }
+        }
+    }
+
+    /* Use the average between high and low short pulses duration.
+     * Often they are a bit different, and using the average is more robust
+     * when we do decoding sampling at short_pulse_dur intervals. */
+    if(short_dur[0] == 0) short_dur[0] = short_dur[1];
+    if(short_dur[1] == 0) short_dur[1] = short_dur[0];
+    s->short_pulse_dur = (short_dur[0] + short_dur[1]) / 2;
+
+    return len;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+// Just enough of furi for the ProtoView signal code and decoders to build
+// on the host. Mutexes are no-ops: the test is single threaded.
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#define furi_assert(x) (void)(x)
+
+static inline void furi_log_print(const char* tag, const char* format, ...) {
+    UNUSED(tag);
+    UNUSED(format);
+}
+
+#define FURI_LOG_E(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) furi_log_print(tag, __VA_ARGS__)
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+typedef struct FuriMutex FuriMutex;
+typedef struct FuriMessageQueue FuriMessageQueue;
+typedef struct FuriString FuriString;
+
+static inline FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    UNUSED(type);
+    return (FuriMutex*)1;
+}
+
+static inline void furi_mutex_free(FuriMutex* mutex) {
+    UNUSED(mutex);
+}
+
+static inline FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    UNUSED(mutex);
+    UNUSED(timeout);
+    return FuriStatusOk;
+}
+
+static inline FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    UNUSED(mutex);
+    return FuriStatusOk;
+}
+
+uint32_t furi_get_tick(void);
+
+static inline uint32_t furi_ms_to_ticks(uint32_t ms) {
+    return ms;
+}
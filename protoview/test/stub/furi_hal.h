@@ -0,0 +1,34 @@
+#pragma once
+
+#include <furi.h>
+
+// The cycle counter runs at one cycle per nanosecond on the host
+typedef struct {
+    uint32_t CYCCNT;
+} HostDwt;
+
+HostDwt* host_dwt(void);
+
+#define DWT (host_dwt())
+
+static inline uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return 1000;
+}
+
+typedef enum {
+    FuriHalSubGhzPresetIDLE,
+    FuriHalSubGhzPresetOok270Async,
+    FuriHalSubGhzPresetOok650Async,
+    FuriHalSubGhzPreset2FSKDev238Async,
+    FuriHalSubGhzPreset2FSKDev476Async,
+    FuriHalSubGhzPresetMSK99_97KbAsync,
+    FuriHalSubGhzPresetGFSK9_99KbAsync,
+    FuriHalSubGhzPresetCustom,
+} FuriHalSubGhzPreset;
+
+typedef struct {
+    uint32_t duration;
+    bool level;
+} LevelDuration;
+
+typedef LevelDuration (*FuriHalSubGhzAsyncTxCallback)(void* context);
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <gui/gui.h>
+
+typedef struct VariableItemList VariableItemList;
@@ -0,0 +1,28 @@
+// Host side of the firmware and of the parts of the app the tests don't build
+
+#include <time.h>
+
+#include "../../app.h"
+
+RawSamplesBuffer *RawSamples, *DetectedSamples;
+
+static uint64_t host_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+uint32_t furi_get_tick(void) {
+    return host_ns() / 1000000;
+}
+
+HostDwt* host_dwt(void) {
+    static HostDwt dwt;
+    dwt.CYCCNT = host_ns();
+    return &dwt;
+}
+
+void adjust_raw_view_scale(ProtoViewApp* app, uint32_t short_pulse_dur) {
+    UNUSED(app);
+    UNUSED(short_pulse_dur);
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <furi_hal.h>
+
+typedef struct SubGhzDevice SubGhzDevice;
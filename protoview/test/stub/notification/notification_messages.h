@@ -0,0 +1,27 @@
+#pragma once
+
+#include <furi.h>
+
+// Notifications are dropped: only the decoding path is exercised
+
+typedef struct NotificationApp NotificationApp;
+
+typedef struct {
+    int type;
+} NotificationMessage;
+
+typedef const NotificationMessage* NotificationSequence[];
+
+static const NotificationMessage message_vibro_on;
+static const NotificationMessage message_vibro_off;
+static const NotificationMessage message_red_255;
+static const NotificationMessage message_red_0;
+static const NotificationMessage message_green_255;
+static const NotificationMessage message_green_0;
+static const NotificationMessage message_delay_50;
+
+static inline void
+    notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    UNUSED(app);
+    UNUSED(sequence);
+}
@@ -1,46 +1,111 @@
 #include <furi.h>
 #include <furi_hal.h>
+#include <storage/storage.h>
 #include "stm32_sam.h"
 // WOULD BE COOL IF SOMEONE MADE A TEXT ENTRY SCREEN TO HAVE IT READ WHAT IS ENTERED TO TEXT
 STM32SAM voice;
 
-extern "C" int32_t sam_app(void* p) {
-    UNUSED(p);
-    if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
+typedef struct {
+    uint8_t riff[4];
+    uint32_t riff_size;
+    uint8_t wave[4];
+    uint8_t fmt[4];
+    uint32_t fmt_size;
+    uint16_t tag;
+    uint16_t channels;
+    uint32_t sample_rate;
+    uint32_t byte_per_sec;
+    uint16_t block_align;
+    uint16_t bits_per_sample;
+    uint8_t data[4];
+    uint32_t data_size;
+} SamWavHeader;
+
+typedef struct {
+    File* file;
+    uint32_t data_size;
+} SamWavFile;
+
+static void sam_wav_write(const uint8_t* samples, size_t count, void* context) {
+    SamWavFile* wav = (SamWavFile*)context;
+    wav->data_size += storage_file_write(wav->file, samples, count);
+}
+
+// Renders the text into an 8-bit mono WAV file instead of the speaker
+static bool sam_say_to_wav(const char* text, const char* path) {
+    Storage* storage = (Storage*)furi_record_open(RECORD_STORAGE);
+    SamWavFile wav;
+    wav.file = storage_file_alloc(storage);
+    wav.data_size = 0;
+
+    SamWavHeader header;
+    memcpy(header.riff, "RIFF", 4);
+    memcpy(header.wave, "WAVE", 4);
+    memcpy(header.fmt, "fmt ", 4);
+    header.fmt_size = 16;
+    header.tag = 1;
+    header.channels = 1;
+    header.sample_rate = SAM_SAMPLE_RATE;
+    header.byte_per_sec = SAM_SAMPLE_RATE;
+    header.block_align = 1;
+    header.bits_per_sample = 8;
+    memcpy(header.data, "data", 4);
+    header.riff_size = 0;
+    header.data_size = 0;
+
+    bool result = false;
+    if(storage_file_open(wav.file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_write(wav.file, &header, sizeof(header));
+
+        voice.setRenderCallback(sam_wav_write, &wav);
+        voice.say(text);
+        voice.setRenderCallback(NULL, NULL);
+
+        // sizes are known once the speech is rendered
+        header.data_size = wav.data_size;
+        header.riff_size = sizeof(header) - 8 + wav.data_size;
+        result = storage_file_seek(wav.file, 0, true) &&
+                 storage_file_write(wav.file, &header, sizeof(header)) == sizeof(header);
+    } else {
+        FURI_LOG_E("SAM", "Cannot open file \"%s\"", path);
+    }
+
+    storage_file_close(wav.file);
+    storage_file_free(wav.file);
+    furi_record_close(RECORD_STORAGE);
+    return result;
+}
+
+// Plays the text, or renders it to the WAV file passed as launch argument
+static void sam_say(const char* text, void* p) {
+    const char* path = (const char*)p;
+    if(path && path[0]) {
+        sam_say_to_wav(text, path);
+    } else if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
         voice.begin();
-        voice.say(
-            "All your base are belong to us. You have no chance to survive make your time. ha. ha. ha. GOOD BYE. ");
+        voice.say(text);
         furi_hal_speaker_release();
     }
+}
+
+extern "C" int32_t sam_app(void* p) {
+    sam_say(
+        "All your base are belong to us. You have no chance to survive make your time. ha. ha. ha. GOOD BYE. ",
+        p);
     return 0;
 }
 
 extern "C" int32_t sam_app_yes(void* p) {
-    UNUSED(p);
-    if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        voice.begin();
-        voice.say("Yes");
-        furi_hal_speaker_release();
-    }
+    sam_say("Yes", p);
     return 0;
 }
 
 extern "C" int32_t sam_app_no(void* p) {
-    UNUSED(p);
-    if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        voice.begin();
-        voice.say("No");
-        furi_hal_speaker_release();
-    }
+    sam_say("No", p);
     return 0;
 }
 
 extern "C" int32_t sam_app_wtf(void* p) {
-    UNUSED(p);
-    if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        voice.begin();
-        voice.say("What The Fuck");
-        furi_hal_speaker_release();
-    }
+    sam_say("What The Fuck", p);
     return 0;
 }
@@ -2425,22 +2425,36 @@ void STM32SAM::Output8BitAry(int index, unsigned char ary[5]) {
 
     int sample_uS = bufferpos - bufferposOld;
 
-    uint32_t f = 0;
-
-    // write a little bit in advance
+    // the previous value stays on for the time the old busy-wait output waited before
+    // writing the next one
+    uint32_t hold_us = sample_uS / (_STM32SAM_SPEED + 1);
     for(k = 0; k < 5; k++) {
-        //   buffer[bufferpos / 50 + k] = ary[k];
-
-        // f = micros() + sample_uS / (_STM32SAM_SPEED + 1);
-        // while(micros() < f) {
-        // };
-        f = sample_uS / (_STM32SAM_SPEED + 1);
-        furi_delay_us(f);
-        SetAUDIO(ary[k]);
-        //  delayMicroseconds(sample_uS / 5 );
+        OutputHold(level, hold_us);
+        level = audio_table[ary[k]];
+    }
+}
+
+// Box filters the held levels into samples of SAM_SAMPLE_PERIOD_US
+void STM32SAM::OutputHold(unsigned char value, uint32_t hold_us) {
+    accum_value += value * hold_us;
+    accum_time += hold_us;
+
+    while(accum_time >= SAM_SAMPLE_PERIOD_US) {
+        // whatever spills over into the next sample is at the current value
+        uint32_t over = accum_time - SAM_SAMPLE_PERIOD_US;
+        uint32_t sample =
+            (accum_value - value * over + SAM_SAMPLE_PERIOD_US / 2) / SAM_SAMPLE_PERIOD_US;
+        PushSample(sample);
+        accum_value = value * over;
+        accum_time = over;
     }
+}
 
-    //  SetAUDIO(ary[0]);
+void STM32SAM::PushSample(unsigned char sample) {
+    ring[ring_pos++] = sample;
+    if(ring_pos % SAM_RING_HALF == 0) {
+        SubmitHalf();
+    }
 }
 
 void STM32SAM::Output8Bit(int index, unsigned char A) {
@@ -4510,7 +4524,7 @@ void STM32SAM::AdjustLengths() {
                 mem56 = flags[index];
 
             // not a consonant
-            if((flags[index] & 64) == 0) {
+            if((mem56 & 64) == 0) {
                 // RX or LX?
                 if((index == 18) || (index == 19)) // 'RX' & 'LX'
                 {
@@ -5259,6 +5273,12 @@ STM32SAM::STM32SAM(uint32_t STM32SAM_SPEED /* = 5 */) {
     mem59 = 0;
 
     oldtimetableindex = 0;
+
+    render_callback = NULL;
+    render_context = NULL;
+    InitAudioTable();
+    level = 127; // begin() starts the PWM there
+    half_done = NULL;
 }
 
 STM32SAM::STM32SAM() {
@@ -5280,6 +5300,12 @@ STM32SAM::STM32SAM() {
     mem59 = 0;
 
     oldtimetableindex = 0;
+
+    render_callback = NULL;
+    render_context = NULL;
+    InitAudioTable();
+    level = 127; // begin() starts the PWM there
+    half_done = NULL;
 }
 
 /*
@@ -5362,9 +5388,9 @@ void STM32SAM::sam(
 
     SetInput(input);
 
-    if(!SAMMain()) {
-        return;
-    }
+    BeginOutput();
+    SAMMain();
+    EndOutput();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -5413,9 +5439,9 @@ void STM32SAM::sam(
 
     SetInput(input);
 
-    if(!SAMMain()) {
-        return;
-    }
+    BeginOutput();
+    SAMMain();
+    EndOutput();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -5616,6 +5642,17 @@ void STM32SAM::setMouth(unsigned char _mouth /* = 128 */) {
 void STM32SAM::setThroat(unsigned char _throat /* = 128 */) {
     throat = _throat;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//
+//           STM32SAM setRenderCallback (callback, context)
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void STM32SAM::setRenderCallback(SamRenderCallback callback, void* context) {
+    render_callback = callback;
+    render_context = context;
+}
 ////////////////////////////////////////////////////////////////////////////////////////////
 //
 //           Hardware
@@ -5627,7 +5664,9 @@ void STM32SAM::setThroat(unsigned char _throat /* = 128 */) {
 // Set PA8 pin as PWM, at 256 timer ticks overflow (8bit resolution)
 
 #include <math.h>
+#include <furi_hal.h>
 #include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_dma.h>
 
 #define FURI_HAL_SPEAKER_TIMER TIM16
 #define FURI_HAL_SPEAKER_CHANNEL LL_TIM_CHANNEL_CH1
@@ -5670,35 +5709,153 @@ void STM32SAM::begin(void) {
     LL_TIM_EnableCounter(FURI_HAL_SPEAKER_TIMER);
 } // begin
 
-inline void STM32SAM::SetAUDIO(unsigned char main_volume) {
-#ifdef USE_ROGER_CORE
-    Timer1.setCompare(TIMER_CH1, main_volume);
-#endif
+void STM32SAM::InitAudioTable() {
+    for(int i = 0; i < 256; i++) {
+        float data = i;
+        data /= 255.0f;
+        data -= 0.5f;
+        data *= 4.0f;
+        data = tanhf(data);
+
+        data += 0.5f;
+        data *= 255.0f;
+
+        if(data < 0) {
+            data = 0;
+        } else if(data > 255) {
+            data = 255;
+        }
 
-#ifdef USE_STM32duino_CORE
-    PWM->setCaptureCompare(1, main_volume, TICK_COMPARE_FORMAT);
-#endif
+        audio_table[i] = data;
+    }
+}
+
+void STM32SAM::BeginOutput() {
+    accum_value = 0;
+    accum_time = 0;
+    ring_pos = 0;
+    halves_written = 0;
+    halves_played = 0;
+    playing = false;
+    if(!render_callback) {
+        half_done = furi_semaphore_alloc(2, 0);
+    }
+}
+
+void STM32SAM::EndOutput() {
+    if(accum_time > 0) {
+        OutputHold(level, SAM_SAMPLE_PERIOD_US - accum_time);
+    }
+
+    if(render_callback) {
+        if(ring_pos % SAM_RING_HALF != 0) {
+            size_t start = ring_pos < SAM_RING_HALF ? 0 : SAM_RING_HALF;
+            render_callback(&ring[start], ring_pos - start, render_context);
+        }
+        return;
+    }
+
+    // pad the current half and add a quiet one for the DMA to be in when it is stopped,
+    // returning from the last SubmitHalf means everything before it has been played
+    while(ring_pos % SAM_RING_HALF != 0) {
+        PushSample(level);
+    }
+    for(size_t i = 0; i < SAM_RING_HALF; i++) {
+        PushSample(level);
+    }
+
+    if(playing) {
+        StopPlayback();
+    }
+    furi_semaphore_free(half_done);
+    half_done = NULL;
+}
+
+void STM32SAM::SubmitHalf() {
+    if(render_callback) {
+        render_callback(&ring[ring_pos - SAM_RING_HALF], SAM_RING_HALF, render_context);
+    } else {
+        halves_written++;
+        if(!playing && halves_written == 2) {
+            StartPlayback();
+        }
+
+        // the next half is free once the DMA has moved past it
+        while(halves_written - halves_played >= 2) {
+            if(furi_semaphore_acquire(half_done, furi_ms_to_ticks(SAM_RING_TIMEOUT_MS)) !=
+               FuriStatusOk) {
+                FURI_LOG_W("SAM", "DMA stalled");
+            }
+            halves_played++;
+        }
+    }
 
-    // if(main_volume > 64) {
-    //     LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, 127);
-    // } else {
-    //     LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, main_volume);
-    // }
-
-    float data = main_volume;
-    data /= 255.0f;
-    data -= 0.5f;
-    data *= 4.0f;
-    data = tanhf(data);
-
-    data += 0.5f;
-    data *= 255.0f;
-
-    if(data < 0) {
-        data = 0;
-    } else if(data > 255) {
-        data = 255;
+    if(ring_pos == SAM_RING_SIZE) {
+        ring_pos = 0;
     }
+}
+
+#define SAMPLE_RATE_TIMER TIM2
+#define DMA_INSTANCE DMA1, LL_DMA_CHANNEL_1
+
+void STM32SAM::DmaIsr(void* context) {
+    STM32SAM* sam = (STM32SAM*)context;
+
+    if(LL_DMA_IsActiveFlag_HT1(DMA1)) {
+        LL_DMA_ClearFlag_HT1(DMA1);
+        furi_semaphore_release(sam->half_done);
+    }
+
+    if(LL_DMA_IsActiveFlag_TC1(DMA1)) {
+        LL_DMA_ClearFlag_TC1(DMA1);
+        furi_semaphore_release(sam->half_done);
+    }
+}
 
-    LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, data);
-}
\ No newline at end of file
+// TIM2 requests a DMA transfer of the next ring byte into the PWM compare register every sample
+void STM32SAM::StartPlayback() {
+    playing = true;
+
+    furi_hal_bus_enable(FuriHalBusTIM2);
+
+    LL_TIM_InitTypeDef TIM_InitStruct;
+    memset(&TIM_InitStruct, 0, sizeof(LL_TIM_InitTypeDef));
+    TIM_InitStruct.Prescaler = 0;
+    TIM_InitStruct.Autoreload = 64000000 / SAM_SAMPLE_RATE - 1;
+    LL_TIM_Init(SAMPLE_RATE_TIMER, &TIM_InitStruct);
+
+    // 32-bit addresses on the STM32, through uintptr_t so the host build takes them too
+    uint32_t dma_dst = (uint32_t)(uintptr_t)&FURI_HAL_SPEAKER_TIMER->CCR1;
+    LL_DMA_ConfigAddresses(
+        DMA_INSTANCE, (uint32_t)(uintptr_t)ring, dma_dst, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetDataLength(DMA_INSTANCE, SAM_RING_SIZE);
+    LL_DMA_SetPeriphRequest(DMA_INSTANCE, LL_DMAMUX_REQ_TIM2_UP);
+    LL_DMA_SetDataTransferDirection(DMA_INSTANCE, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetChannelPriorityLevel(DMA_INSTANCE, LL_DMA_PRIORITY_VERYHIGH);
+    LL_DMA_SetMode(DMA_INSTANCE, LL_DMA_MODE_CIRCULAR);
+    LL_DMA_SetPeriphIncMode(DMA_INSTANCE, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(DMA_INSTANCE, LL_DMA_MEMORY_INCREMENT);
+    // bytes are zero extended into the 16-bit register
+    LL_DMA_SetPeriphSize(DMA_INSTANCE, LL_DMA_PDATAALIGN_HALFWORD);
+    LL_DMA_SetMemorySize(DMA_INSTANCE, LL_DMA_MDATAALIGN_BYTE);
+    LL_DMA_EnableIT_TC(DMA_INSTANCE);
+    LL_DMA_EnableIT_HT(DMA_INSTANCE);
+
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch1, DmaIsr, this);
+
+    LL_DMA_EnableChannel(DMA_INSTANCE);
+    LL_TIM_EnableDMAReq_UPDATE(SAMPLE_RATE_TIMER);
+    LL_TIM_EnableCounter(SAMPLE_RATE_TIMER);
+}
+
+void STM32SAM::StopPlayback() {
+    LL_TIM_DisableCounter(SAMPLE_RATE_TIMER);
+    LL_TIM_DisableDMAReq_UPDATE(SAMPLE_RATE_TIMER);
+    LL_DMA_DisableChannel(DMA_INSTANCE);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch1, NULL, NULL);
+    furi_hal_bus_disable(FuriHalBusTIM2);
+
+    // hold the last level like the direct output did
+    LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, level);
+    playing = false;
+}
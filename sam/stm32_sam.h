@@ -5,6 +5,17 @@
 
 // SAM Text-To-Speech (TTS), ported from https://github.com/s-macke/SAM
 
+// Rendered output, 8-bit unsigned mono
+#define SAM_SAMPLE_RATE 50000
+#define SAM_SAMPLE_PERIOD_US (1000000 / SAM_SAMPLE_RATE)
+
+// Speaker ring buffer, synthesis runs up to one half ahead of the DMA reading the other one
+#define SAM_RING_SIZE 4096
+#define SAM_RING_HALF (SAM_RING_SIZE / 2)
+#define SAM_RING_TIMEOUT_MS 100
+
+typedef void (*SamRenderCallback)(const uint8_t* samples, size_t count, void* context);
+
 class STM32SAM {
 public:
     STM32SAM(uint32_t STM32SAM_SPEED);
@@ -47,8 +58,20 @@ public:
     void setMouth(unsigned char _mouth = 128);
     void setThroat(unsigned char _throat = 128);
 
+    // Hands the samples of the following calls to callback instead of playing them, NULL plays
+    // them on the speaker again
+    void setRenderCallback(SamRenderCallback callback, void* context);
+
 private:
-    void SetAUDIO(unsigned char main_volume);
+    void InitAudioTable();
+    void BeginOutput();
+    void EndOutput();
+    void OutputHold(unsigned char value, uint32_t hold_us);
+    void PushSample(unsigned char sample);
+    void SubmitHalf();
+    void StartPlayback();
+    void StopPlayback();
+    static void DmaIsr(void* context);
 
     void Output8BitAry(int index, unsigned char ary[5]);
     void Output8Bit(int index, unsigned char A);
@@ -91,6 +114,22 @@ private:
     unsigned char phonetic;
     unsigned char singmode;
 
+    SamRenderCallback render_callback;
+    void* render_context;
+
+    // speaker level for each synthesized value, the tanh limiter of the old direct output
+    unsigned char audio_table[256];
+    unsigned char level;
+    uint32_t accum_value;
+    uint32_t accum_time;
+
+    unsigned char ring[SAM_RING_SIZE];
+    size_t ring_pos;
+    uint32_t halves_written;
+    uint32_t halves_played;
+    bool playing;
+    FuriSemaphore* half_done;
+
 }; // STM32SAM class
 
 #endif
\ No newline at end of file
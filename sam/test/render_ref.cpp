@@ -0,0 +1,101 @@
+// The speaker output SAM had before the ring buffer: Output8BitAry() busy-waited in
+// furi_delay_us() and wrote every value through the tanh limiter of SetAUDIO() into the PWM
+// compare register, which holds it until the next write. The synthesis before that stage is
+// ../stm32_sam.cpp built a second time in its own namespace, with its calls to Output8BitAry()
+// going to the old one below, which logs the writes on a simulated clock instead.
+
+namespace sam_ref {
+
+class STM32SAM;
+static void RefOutput8BitAry(STM32SAM* sam, int index, unsigned char ary[5]);
+
+// The declaration and definition become Output8BitAryNew(int index, ...), the calls
+// Output8BitAry(index, ary) and Output8BitAry(0, ary) RefOutput8BitAry(this, ...)
+#define Output8BitAry(index, ary) REF_CALL_##index, ary)
+#define REF_CALL_int Output8BitAryNew(int
+#define REF_CALL_index RefOutput8BitAry(this, index
+#define REF_CALL_0 RefOutput8BitAry(this, 0
+
+#undef __STM32SAM__
+#include "../stm32_sam.cpp"
+
+#undef Output8BitAry
+#undef REF_CALL_int
+#undef REF_CALL_index
+#undef REF_CALL_0
+
+struct RefWrite {
+    uint64_t time_us;
+    uint8_t value;
+};
+
+static std::vector<RefWrite> writes;
+static uint64_t now_us;
+
+static void furi_delay_us(uint32_t us) {
+    now_us += us;
+}
+
+// in place of LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, value)
+static void log_write(uint32_t value) {
+    writes.push_back({now_us, (uint8_t)value});
+}
+
+static void SetAUDIO(unsigned char main_volume) {
+    float data = main_volume;
+    data /= 255.0f;
+    data -= 0.5f;
+    data *= 4.0f;
+    data = tanhf(data);
+
+    data += 0.5f;
+    data *= 255.0f;
+
+    if(data < 0) {
+        data = 0;
+    } else if(data > 255) {
+        data = 255;
+    }
+
+    log_write(data);
+}
+
+static void RefOutput8BitAry(STM32SAM* sam, int index, unsigned char ary[5]) {
+    int k;
+
+    uint32_t bufferposOld = bufferpos;
+
+    bufferpos += timetable[oldtimetableindex][index];
+    oldtimetableindex = index;
+
+    int sample_uS = bufferpos - bufferposOld;
+
+    uint32_t f = 0;
+
+    // write a little bit in advance
+    for(k = 0; k < 5; k++) {
+        f = sample_uS / (sam->_STM32SAM_SPEED + 1);
+        furi_delay_us(f);
+        SetAUDIO(ary[k]);
+    }
+}
+
+static void discard(const uint8_t* samples, size_t count, void* context) {
+    UNUSED(samples);
+    UNUSED(count);
+    UNUSED(context);
+}
+
+// The compare register writes of a fresh voice saying the text, and when the last one was
+static const std::vector<RefWrite>& say(const char* text, uint64_t* end_us) {
+    STM32SAM voice;
+    // the ring buffer stage sees no samples, the old one above all the writes
+    voice.setRenderCallback(discard, NULL);
+    writes.clear();
+    now_us = 0;
+    voice.say(text);
+    *end_us = now_us;
+    return writes;
+}
+
+} // namespace sam_ref
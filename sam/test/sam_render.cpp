@@ -0,0 +1,177 @@
+// Renders a phrase set to WAV files through sam_say_to_wav(), the way the app does when it is
+// launched with a path, and compares every sample with the speaker output of the busy-wait
+// loop the ring buffer replaced (render_ref.cpp), box-averaged over the same sample period.
+// Then says each phrase on the simulated speaker and checks the DMA plays those samples too,
+// and reports how long the synthesis takes against the length of the speech.
+//
+//   make -C sam/test run
+
+#include <math.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <vector>
+
+#include "host_sam.h"
+
+// for the voice's level and ring buffer, and the old output stage
+#define private public
+#include "../sam_app.cpp"
+#include "render_ref.cpp"
+#undef private
+
+#define WAV_DIR "wav"
+
+static const char* phrases[] = {
+    "All your base are belong to us. You have no chance to survive make your time. ha. ha. ha. GOOD BYE. ",
+    "Yes",
+    "No",
+    "What The Fuck",
+    "Hello, my name is SAM. I am a software automatic mouth.",
+    "Is this a question?",
+    "One two three four five six seven eight nine ten.",
+    "The quick brown fox jumps over the lazy dog, while zebras shiver in the breeze.",
+};
+
+static uint32_t failures;
+
+static void fail(const char* what) {
+    printf("FAIL %s\n", what);
+    failures++;
+}
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// The compare register level over a 1 us grid, averaged into samples like OutputHold() does.
+// The last sample is filled up with the level that stays on after the last write.
+static std::vector<uint8_t> reference_samples(const char* text) {
+    uint64_t end_us;
+    const std::vector<sam_ref::RefWrite>& writes = sam_ref::say(text, &end_us);
+
+    std::vector<uint8_t> samples;
+    uint8_t level = 127; // begin() starts the PWM there
+    size_t next = 0;
+    uint32_t sum = 0;
+    uint64_t count = (end_us + SAM_SAMPLE_PERIOD_US - 1) / SAM_SAMPLE_PERIOD_US;
+    for(uint64_t t = 0; t < count * SAM_SAMPLE_PERIOD_US; t++) {
+        while(next < writes.size() && writes[next].time_us <= t) {
+            level = writes[next++].value;
+        }
+        sum += level;
+        if((t + 1) % SAM_SAMPLE_PERIOD_US == 0) {
+            samples.push_back((sum + SAM_SAMPLE_PERIOD_US / 2) / SAM_SAMPLE_PERIOD_US);
+            sum = 0;
+        }
+    }
+    return samples;
+}
+
+// The samples of a WAV file the way sam_say_to_wav() writes them, empty if it is not one
+static std::vector<uint8_t> read_wav(const char* path) {
+    std::vector<uint8_t> samples;
+    FILE* file = fopen(path, "rb");
+    if(!file) return samples;
+
+    SamWavHeader header;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if(fread(&header, sizeof(header), 1, file) == 1 && !memcmp(header.riff, "RIFF", 4) &&
+       !memcmp(header.wave, "WAVE", 4) && !memcmp(header.fmt, "fmt ", 4) &&
+       !memcmp(header.data, "data", 4) && header.fmt_size == 16 && header.tag == 1 &&
+       header.channels == 1 && header.sample_rate == SAM_SAMPLE_RATE &&
+       header.byte_per_sec == SAM_SAMPLE_RATE && header.block_align == 1 &&
+       header.bits_per_sample == 8 && header.riff_size == size - 8 &&
+       header.data_size == size - sizeof(header)) {
+        samples.resize(header.data_size);
+        if(fread(samples.data(), 1, samples.size(), file) != samples.size()) samples.clear();
+    }
+    fclose(file);
+    return samples;
+}
+
+// The DMA has to play the samples and hold the last level until it is stopped
+static bool speaker_plays(const std::vector<uint8_t>& samples) {
+    if(host_dma_stalls || host_dma_bad_config) return false;
+    if(host_dma_played.size() < samples.size()) return false;
+    if(memcmp(host_dma_played.data(), samples.data(), samples.size())) return false;
+    for(size_t i = samples.size(); i < host_dma_played.size(); i++) {
+        if(host_dma_played[i] != voice.level) return false;
+    }
+    return host_tim16.CCR1 == voice.level;
+}
+
+int main(void) {
+    mkdir(WAV_DIR, 0755);
+
+    printf(
+        "%-6s %8s %8s %8s %8s %9s\n", "phrase", "samples", "seconds", "differ", "speaker", "RTF");
+    double total_render_s = 0;
+    double total_audio_s = 0;
+    for(size_t i = 0; i < sizeof(phrases) / sizeof(phrases[0]); i++) {
+        char path[64];
+        snprintf(path, sizeof(path), WAV_DIR "/phrase_%zu.wav", i);
+        // say() copies 256 bytes of the text whatever its length
+        char text[256] = {0};
+        strncpy(text, phrases[i], sizeof(text) - 1);
+
+        // every phrase from a fresh voice, like a launch of the app
+        voice = STM32SAM();
+        double begin = time_s();
+        if(!sam_say_to_wav(text, path)) fail("sam_say_to_wav");
+        double render_s = time_s() - begin;
+
+        std::vector<uint8_t> samples = read_wav(path);
+        if(samples.empty()) fail("WAV header");
+        std::vector<uint8_t> reference = reference_samples(text);
+        size_t differ = 0;
+        for(size_t j = 0; j < samples.size() && j < reference.size(); j++) {
+            differ += samples[j] != reference[j];
+        }
+        if(samples.size() != reference.size()) {
+            printf(
+                "phrase %zu: %zu samples, the old output %zu\n",
+                i,
+                samples.size(),
+                reference.size());
+            fail("sample count");
+        }
+        if(differ) fail("samples");
+
+        voice = STM32SAM();
+        host_sam_reset();
+        host_dma_memory = voice.ring;
+        sam_say(text, NULL);
+        bool speaker = speaker_plays(samples);
+        if(!speaker) fail("speaker");
+
+        double audio_s = (double)samples.size() / SAM_SAMPLE_RATE;
+        printf(
+            "%-6zu %8zu %8.2f %8zu %8s %9.5f\n",
+            i,
+            samples.size(),
+            audio_s,
+            differ,
+            speaker ? "ok" : "wrong",
+            render_s / audio_s);
+        total_render_s += render_s;
+        total_audio_s += audio_s;
+    }
+
+    // The old output ran at exactly 1, the busy waits took up whatever synthesis left over
+    printf(
+        "%.2f s of speech rendered in %.1f ms on the host, real-time factor %.5f\n",
+        total_audio_s,
+        total_render_s * 1e3,
+        total_render_s / total_audio_s);
+
+    if(failures) {
+        printf("FAILED: %u checks\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
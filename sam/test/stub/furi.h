@@ -0,0 +1,34 @@
+#pragma once
+
+// Just enough of the Furi API to build SAM and sam_app.cpp on the host, see host_sam.cpp
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+
+#define FURI_LOG_W(tag, format, ...) fprintf(stderr, "[%s] " format "\n", tag, ##__VA_ARGS__)
+#define FURI_LOG_E FURI_LOG_W
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+typedef struct FuriSemaphore FuriSemaphore;
+
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count);
+void furi_semaphore_free(FuriSemaphore* instance);
+FuriStatus furi_semaphore_acquire(FuriSemaphore* instance, uint32_t timeout);
+FuriStatus furi_semaphore_release(FuriSemaphore* instance);
+
+static inline uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <furi.h>
+
+typedef enum {
+    FuriHalBusTIM2,
+} FuriHalBus;
+
+typedef enum {
+    FuriHalInterruptIdDma1Ch1,
+} FuriHalInterruptId;
+
+typedef void (*FuriHalInterruptISR)(void* context);
+
+void furi_hal_bus_enable(FuriHalBus bus);
+void furi_hal_bus_disable(FuriHalBus bus);
+void furi_hal_interrupt_set_isr(FuriHalInterruptId index, FuriHalInterruptISR isr, void* context);
+
+bool furi_hal_speaker_acquire(uint32_t timeout);
+void furi_hal_speaker_release(void);
+bool furi_hal_speaker_is_mine(void);
@@ -0,0 +1,271 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <storage/storage.h>
+
+#include "host_sam.h"
+
+TIM_TypeDef host_tim16, host_tim2;
+
+const uint8_t* host_dma_memory;
+std::vector<uint8_t> host_dma_played;
+uint32_t host_dma_stalls;
+uint32_t host_dma_bad_config;
+
+static bool speaker_owned;
+static bool tim2_counting;
+static bool tim2_dma_request;
+
+static struct {
+    uint32_t source;
+    uint32_t destination;
+    uint32_t length;
+    bool circular;
+    bool enabled;
+    uint32_t position;
+    bool half_transfer;
+    bool transfer_complete;
+    FuriHalInterruptISR isr;
+    void* isr_context;
+} dma;
+
+void host_sam_reset(void) {
+    host_dma_played.clear();
+    host_dma_stalls = 0;
+    host_dma_bad_config = 0;
+    host_tim16.CCR1 = 0;
+}
+
+// One half of the buffer goes out, then the interrupt for it
+static bool dma_play_half(void) {
+    if(!dma.enabled || !tim2_counting || !tim2_dma_request) return false;
+
+    uint32_t half = dma.length / 2;
+    for(uint32_t i = 0; i < half; i++) {
+        host_tim16.CCR1 = host_dma_memory[dma.position++];
+        host_dma_played.push_back(host_tim16.CCR1);
+    }
+    if(dma.position == dma.length) {
+        dma.position = 0;
+        dma.transfer_complete = true;
+    } else {
+        dma.half_transfer = true;
+    }
+    if(dma.isr) dma.isr(dma.isr_context);
+    return true;
+}
+
+// Semaphores
+
+struct FuriSemaphore {
+    uint32_t max_count;
+    uint32_t count;
+};
+
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count) {
+    FuriSemaphore* instance = (FuriSemaphore*)malloc(sizeof(FuriSemaphore));
+    instance->max_count = max_count;
+    instance->count = initial_count;
+    return instance;
+}
+
+void furi_semaphore_free(FuriSemaphore* instance) {
+    free(instance);
+}
+
+FuriStatus furi_semaphore_acquire(FuriSemaphore* instance, uint32_t timeout) {
+    UNUSED(timeout);
+    if(instance->count == 0) dma_play_half();
+    if(instance->count == 0) {
+        host_dma_stalls++;
+        return FuriStatusErrorTimeout;
+    }
+    instance->count--;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_semaphore_release(FuriSemaphore* instance) {
+    if(instance->count < instance->max_count) instance->count++;
+    return FuriStatusOk;
+}
+
+// Records
+
+void* furi_record_open(const char* name) {
+    return (void*)name;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// Speaker, bus and interrupts
+
+bool furi_hal_speaker_acquire(uint32_t timeout) {
+    UNUSED(timeout);
+    if(speaker_owned) return false;
+    speaker_owned = true;
+    return true;
+}
+
+void furi_hal_speaker_release(void) {
+    speaker_owned = false;
+}
+
+bool furi_hal_speaker_is_mine(void) {
+    return speaker_owned;
+}
+
+void furi_hal_bus_enable(FuriHalBus bus) {
+    UNUSED(bus);
+}
+
+void furi_hal_bus_disable(FuriHalBus bus) {
+    UNUSED(bus);
+}
+
+void furi_hal_interrupt_set_isr(FuriHalInterruptId index, FuriHalInterruptISR isr, void* context) {
+    UNUSED(index);
+    dma.isr = isr;
+    dma.isr_context = context;
+}
+
+// Timers
+
+void LL_TIM_Init(TIM_TypeDef* timer, LL_TIM_InitTypeDef* init) {
+    UNUSED(timer);
+    UNUSED(init);
+}
+
+void LL_TIM_OC_Init(TIM_TypeDef* timer, uint32_t channel, LL_TIM_OC_InitTypeDef* init) {
+    UNUSED(channel);
+    timer->CCR1 = init->CompareValue;
+}
+
+void LL_TIM_OC_SetCompareCH1(TIM_TypeDef* timer, uint32_t value) {
+    timer->CCR1 = value;
+}
+
+void LL_TIM_EnableCounter(TIM_TypeDef* timer) {
+    if(timer == TIM2) tim2_counting = true;
+}
+
+void LL_TIM_DisableCounter(TIM_TypeDef* timer) {
+    if(timer == TIM2) tim2_counting = false;
+}
+
+void LL_TIM_EnableDMAReq_UPDATE(TIM_TypeDef* timer) {
+    if(timer == TIM2) tim2_dma_request = true;
+}
+
+void LL_TIM_DisableDMAReq_UPDATE(TIM_TypeDef* timer) {
+    if(timer == TIM2) tim2_dma_request = false;
+}
+
+// DMA
+
+void LL_DMA_ConfigAddresses(
+    int dma_instance,
+    int channel,
+    uint32_t source,
+    uint32_t destination,
+    uint32_t direction) {
+    UNUSED(dma_instance);
+    UNUSED(channel);
+    UNUSED(direction);
+    dma.source = source;
+    dma.destination = destination;
+}
+
+void LL_DMA_SetDataLength(int dma_instance, int channel, uint32_t length) {
+    UNUSED(dma_instance);
+    UNUSED(channel);
+    dma.length = length;
+}
+
+void LL_DMA_SetMode(int dma_instance, int channel, uint32_t mode) {
+    UNUSED(dma_instance);
+    UNUSED(channel);
+    dma.circular = mode == LL_DMA_MODE_CIRCULAR;
+}
+
+void LL_DMA_EnableChannel(int dma_instance, int channel) {
+    UNUSED(dma_instance);
+    UNUSED(channel);
+    if(dma.source != (uint32_t)(uintptr_t)host_dma_memory ||
+       dma.destination != (uint32_t)(uintptr_t)&host_tim16.CCR1 || dma.length == 0 ||
+       dma.length % 2 || !dma.circular) {
+        host_dma_bad_config++;
+        return;
+    }
+    dma.enabled = true;
+    dma.position = 0;
+}
+
+void LL_DMA_DisableChannel(int dma_instance, int channel) {
+    UNUSED(dma_instance);
+    UNUSED(channel);
+    dma.enabled = false;
+}
+
+uint32_t LL_DMA_IsActiveFlag_HT1(int dma_instance) {
+    UNUSED(dma_instance);
+    return dma.half_transfer;
+}
+
+uint32_t LL_DMA_IsActiveFlag_TC1(int dma_instance) {
+    UNUSED(dma_instance);
+    return dma.transfer_complete;
+}
+
+void LL_DMA_ClearFlag_HT1(int dma_instance) {
+    UNUSED(dma_instance);
+    dma.half_transfer = false;
+}
+
+void LL_DMA_ClearFlag_TC1(int dma_instance) {
+    UNUSED(dma_instance);
+    dma.transfer_complete = false;
+}
+
+// Storage
+
+struct File {
+    FILE* file;
+};
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    File* file = (File*)malloc(sizeof(File));
+    file->file = NULL;
+    return file;
+}
+
+void storage_file_free(File* file) {
+    storage_file_close(file);
+    free(file);
+}
+
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    UNUSED(access_mode);
+    file->file = fopen(path, open_mode == FSOM_CREATE_ALWAYS ? "w+b" : "r+b");
+    return file->file != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->file) return false;
+    fclose(file->file);
+    file->file = NULL;
+    return true;
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    return fwrite(buff, 1, bytes_to_write, file->file);
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    return fseek(file->file, offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// A simulated speaker: the PWM compare register of TIM16, and DMA1 channel 1 moving the ring
+// buffer into it on TIM2 updates. Nothing runs by itself, waiting on a semaphore nobody has
+// released yet lets the DMA play the next half of the ring and raise its interrupt.
+
+#include <vector>
+
+#include <furi_hal.h>
+#include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_dma.h>
+
+// What the DMA source address points at, it only holds the low 32 bits of it on the host
+extern const uint8_t* host_dma_memory;
+
+// Every sample the DMA moved into the compare register
+extern std::vector<uint8_t> host_dma_played;
+// Waits on a semaphore no interrupt would have released, with the DMA stopped
+extern uint32_t host_dma_stalls;
+// Transfers started with another source, destination, length or mode than the ring
+extern uint32_t host_dma_bad_config;
+
+void host_sam_reset(void);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+
+// DMA1 channel 1 only, the channel SAM plays the ring buffer with, see host_sam.h
+#define DMA1 0
+#define LL_DMA_CHANNEL_1 1
+
+#define LL_DMA_DIRECTION_MEMORY_TO_PERIPH 1
+#define LL_DMAMUX_REQ_TIM2_UP 1
+#define LL_DMA_PRIORITY_VERYHIGH 1
+#define LL_DMA_MODE_CIRCULAR 1
+#define LL_DMA_PERIPH_NOINCREMENT 1
+#define LL_DMA_MEMORY_INCREMENT 1
+#define LL_DMA_PDATAALIGN_HALFWORD 1
+#define LL_DMA_MDATAALIGN_BYTE 1
+
+void LL_DMA_ConfigAddresses(
+    int dma,
+    int channel,
+    uint32_t source,
+    uint32_t destination,
+    uint32_t direction);
+void LL_DMA_SetDataLength(int dma, int channel, uint32_t length);
+void LL_DMA_SetMode(int dma, int channel, uint32_t mode);
+void LL_DMA_EnableChannel(int dma, int channel);
+void LL_DMA_DisableChannel(int dma, int channel);
+
+static inline void LL_DMA_SetPeriphRequest(int dma, int channel, uint32_t request) {
+    (void)dma;
+    (void)channel;
+    (void)request;
+}
+
+static inline void LL_DMA_SetDataTransferDirection(int dma, int channel, uint32_t direction) {
+    (void)dma;
+    (void)channel;
+    (void)direction;
+}
+
+static inline void LL_DMA_SetChannelPriorityLevel(int dma, int channel, uint32_t priority) {
+    (void)dma;
+    (void)channel;
+    (void)priority;
+}
+
+static inline void LL_DMA_SetPeriphIncMode(int dma, int channel, uint32_t mode) {
+    (void)dma;
+    (void)channel;
+    (void)mode;
+}
+
+static inline void LL_DMA_SetMemoryIncMode(int dma, int channel, uint32_t mode) {
+    (void)dma;
+    (void)channel;
+    (void)mode;
+}
+
+static inline void LL_DMA_SetPeriphSize(int dma, int channel, uint32_t size) {
+    (void)dma;
+    (void)channel;
+    (void)size;
+}
+
+static inline void LL_DMA_SetMemorySize(int dma, int channel, uint32_t size) {
+    (void)dma;
+    (void)channel;
+    (void)size;
+}
+
+static inline void LL_DMA_EnableIT_TC(int dma, int channel) {
+    (void)dma;
+    (void)channel;
+}
+
+static inline void LL_DMA_EnableIT_HT(int dma, int channel) {
+    (void)dma;
+    (void)channel;
+}
+
+uint32_t LL_DMA_IsActiveFlag_HT1(int dma);
+uint32_t LL_DMA_IsActiveFlag_TC1(int dma);
+void LL_DMA_ClearFlag_HT1(int dma);
+void LL_DMA_ClearFlag_TC1(int dma);
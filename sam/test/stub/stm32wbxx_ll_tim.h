@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+// The speaker compare register is the simulated speaker, see host_sam.h
+typedef struct {
+    volatile uint32_t CCR1;
+} TIM_TypeDef;
+
+extern TIM_TypeDef host_tim16, host_tim2;
+#define TIM16 (&host_tim16)
+#define TIM2 (&host_tim2)
+
+#define LL_TIM_CHANNEL_CH1 1
+#define LL_TIM_OCMODE_PWM1 1
+#define LL_TIM_OCSTATE_ENABLE 1
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t Autoreload;
+} LL_TIM_InitTypeDef;
+
+typedef struct {
+    uint32_t OCMode;
+    uint32_t OCState;
+    uint32_t CompareValue;
+} LL_TIM_OC_InitTypeDef;
+
+void LL_TIM_Init(TIM_TypeDef* timer, LL_TIM_InitTypeDef* init);
+void LL_TIM_OC_Init(TIM_TypeDef* timer, uint32_t channel, LL_TIM_OC_InitTypeDef* init);
+void LL_TIM_OC_SetCompareCH1(TIM_TypeDef* timer, uint32_t value);
+
+static inline void LL_TIM_EnableAllOutputs(TIM_TypeDef* timer) {
+    (void)timer;
+}
+
+void LL_TIM_EnableCounter(TIM_TypeDef* timer);
+void LL_TIM_DisableCounter(TIM_TypeDef* timer);
+void LL_TIM_EnableDMAReq_UPDATE(TIM_TypeDef* timer);
+void LL_TIM_DisableDMAReq_UPDATE(TIM_TypeDef* timer);
@@ -22,6 +22,10 @@ typedef struct {
     bool mode_change;
     bool modulation_change;
 
+    bool waterfall;
+    uint8_t waterfall_head; // Row the next sweep is written to
+    uint8_t waterfall_history[WATERFALL_ROWS][WATERFALL_COLUMNS];
+
     float max_rssi;
     uint8_t max_rssi_dec;
     uint8_t max_rssi_channel;
@@ -106,6 +110,32 @@ void spectrum_analyzer_draw_scale(Canvas* canvas, const SpectrumAnalyzerModel* m
     }
 }
 
+void spectrum_analyzer_draw_waterfall(Canvas* canvas, const SpectrumAnalyzerModel* model) {
+    // 4x4 ordered dithering, to show the signal level with single pixels
+    static const uint8_t dither[4][4] = {
+        {0, 8, 2, 10},
+        {12, 4, 14, 6},
+        {3, 11, 1, 9},
+        {15, 7, 13, 5},
+    };
+
+    // Newest sweep on top
+    uint8_t row = model->waterfall_head;
+    for(uint8_t y = 0; y < WATERFALL_ROWS; y++) {
+        row = (row == 0) ? WATERFALL_ROWS - 1 : row - 1;
+        const uint8_t* ss = model->waterfall_history[row];
+
+        for(uint8_t column = 0; column < WATERFALL_COLUMNS; column++) {
+            // The bars are (ss - vscroll) >> 2 pixels high, this is the same scale in 16 steps.
+            // Negative below vscroll, so nothing is drawn there
+            int16_t level = (ss[column] - model->vscroll) >> 4;
+            if(level > dither[y & 3][column & 3]) {
+                canvas_draw_dot(canvas, column, y);
+            }
+        }
+    }
+}
+
 static void spectrum_analyzer_render_callback(Canvas* const canvas, void* ctx) {
     SpectrumAnalyzer* spectrum_analyzer = ctx;
     //furi_check(furi_mutex_acquire(spectrum_analyzer->model_mutex, FuriWaitForever) == FuriStatusOk);
@@ -114,14 +144,18 @@ static void spectrum_analyzer_render_callback(Canvas* const canvas, void* ctx) {
 
     spectrum_analyzer_draw_scale(canvas, model);
 
-    for(uint8_t column = 0; column < 128; column++) {
-        uint8_t ss = model->channel_ss[column + 2];
-        // Compress height to max of 64 values (255>>2)
-        uint8_t s = MAX((ss - model->vscroll) >> 2, 0);
-        uint8_t y = FREQ_BOTTOM_Y - s; // bar height
-
-        // Draw each bar
-        canvas_draw_line(canvas, column, FREQ_BOTTOM_Y, column, y);
+    if(model->waterfall) {
+        spectrum_analyzer_draw_waterfall(canvas, model);
+    } else {
+        for(uint8_t column = 0; column < 128; column++) {
+            uint8_t ss = model->channel_ss[column + 2];
+            // Compress height to max of 64 values (255>>2)
+            uint8_t s = MAX((ss - model->vscroll) >> 2, 0);
+            uint8_t y = FREQ_BOTTOM_Y - s; // bar height
+
+            // Draw each bar
+            canvas_draw_line(canvas, column, FREQ_BOTTOM_Y, column, y);
+        }
     }
 
     if(model->mode_change) {
@@ -236,6 +270,13 @@ static void spectrum_analyzer_worker_callback(
     model->max_rssi_dec = max_rssi_dec;
     model->max_rssi_channel = max_rssi_channel;
 
+    // Roll the waterfall history
+    memcpy(
+        model->waterfall_history[model->waterfall_head],
+        &((uint8_t*)channel_ss)[2],
+        WATERFALL_COLUMNS);
+    model->waterfall_head = (model->waterfall_head + 1) % WATERFALL_ROWS;
+
     furi_mutex_release(spectrum_analyzer->model_mutex);
     view_port_update(spectrum_analyzer->view_port);
 }
@@ -371,6 +412,10 @@ void spectrum_analyzer_calculate_frequencies(SpectrumAnalyzerModel* model) {
     model->max_rssi = -200.0;
     model->max_rssi_dec = 0;
 
+    // History of another frequency range is meaningless
+    memset(model->waterfall_history, 0, sizeof(model->waterfall_history));
+    model->waterfall_head = 0;
+
     FURI_LOG_D("Spectrum", "setup_frequencies - max_hz: %lu - min_hz: %lu", max_hz, min_hz);
     FURI_LOG_D("Spectrum", "center_freq: %lu", model->center_freq);
     FURI_LOG_D(
@@ -588,6 +633,10 @@ int32_t spectrum_analyzer_app(void* p) {
                 spectrum_analyzer_worker_set_modulation(
                     spectrum_analyzer->worker, spectrum_analyzer->model->modulation);
                 break;
+            case InputKeyUp:
+                model->waterfall = !model->waterfall;
+                FURI_LOG_D("Spectrum", "Waterfall: %u", model->waterfall);
+                break;
             default:
                 break;
             }
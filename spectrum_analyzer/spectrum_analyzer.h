@@ -10,6 +10,10 @@
 // dBm threshold to show peak value
 #define PEAK_THRESHOLD -85
 
+// Waterfall history, one row per sweep above the scale
+#define WATERFALL_ROWS FREQ_BOTTOM_Y
+#define WATERFALL_COLUMNS 128
+
 /*
  * ultrawide mode: 80 MHz on screen, 784 kHz per channel
  * wide mode (default): 20 MHz on screen, 196 kHz per channel
@@ -8,6 +8,17 @@
 
 #include <lib/drivers/cc1101_regs.h>
 
+/* No modulation preset loaded in the radio yet */
+#define MODULATION_NONE 0xFF
+
+/* RSSI settle time after entering RX: PLL lock plus a few RSSI filter
+ * periods, which get longer as the RX filter gets narrower */
+#define SETTLE_TIME_DEFAULT_US 900 // 270 kHz RX filter
+#define SETTLE_TIME_NARROW_US 2200 // 58 kHz RX filter
+
+/* Pause between two sweeps, so the GUI thread gets some time */
+#define SWEEP_IDLE_MS 10
+
 struct SpectrumAnalyzerWorker {
     FuriThread* thread;
     bool should_work;
@@ -25,6 +36,15 @@ struct SpectrumAnalyzerWorker {
     uint8_t max_rssi_dec;
     uint8_t max_rssi_channel;
 
+    /* Set by spectrum_analyzer_worker_set_frequencies(), the worker thread
+     * then rebuilds channel_frequency[] before its next sweep */
+    volatile bool frequencies_changed;
+
+    /* Frequency of each channel, 0 if the radio can not tune to it */
+    uint32_t channel_frequency[NUM_CHANNELS];
+    uint8_t loaded_modulation;
+    uint32_t settle_time_us;
+
     uint8_t channel_ss[NUM_CHANNELS];
 };
 
@@ -54,6 +74,31 @@ void spectrum_analyzer_worker_set_filter(SpectrumAnalyzerWorker* instance) {
     // furi_hal_subghz_load_registers((uint8_t*)filter_config);
 }
 
+/* Compute the channel frequencies once per band/spacing change instead of
+ * on every hop of every sweep */
+static void spectrum_analyzer_worker_build_channels(SpectrumAnalyzerWorker* instance) {
+    uint8_t valid = 0;
+
+    instance->frequencies_changed = false;
+
+    for(uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+        uint32_t frequency = instance->channel0_frequency + (ch * instance->spacing);
+
+        if(subghz_devices_is_frequency_valid(instance->radio_device, frequency)) {
+            instance->channel_frequency[ch] = frequency;
+            valid++;
+        } else {
+            instance->channel_frequency[ch] = 0;
+        }
+    }
+
+    FURI_LOG_D(
+        "SpectrumWorker",
+        "spectrum_analyzer_worker_build_channels: %u/%u channels valid",
+        valid,
+        NUM_CHANNELS);
+}
+
 static int32_t spectrum_analyzer_worker_thread(void* context) {
     furi_assert(context);
     SpectrumAnalyzerWorker* instance = context;
@@ -189,15 +234,26 @@ static int32_t spectrum_analyzer_worker_thread(void* context) {
 
     const uint8_t* modulations[] = {default_modulation, narrow_modulation};
 
+    uint32_t sweep_count = 0;
+    uint32_t sweep_start = furi_get_tick();
+
     while(instance->should_work) {
-        furi_delay_ms(50);
+        furi_delay_ms(SWEEP_IDLE_MS);
 
         // FURI_LOG_T("SpectrumWorker", "spectrum_analyzer_worker_thread: Worker Loop");
         subghz_devices_idle(instance->radio_device);
-        subghz_devices_load_preset(
-            instance->radio_device,
-            FuriHalSubGhzPresetCustom,
-            (uint8_t*)modulations[instance->modulation]);
+
+        // Loading a custom preset resets the radio, only do it when the modulation changes
+        if(instance->loaded_modulation != instance->modulation) {
+            subghz_devices_load_preset(
+                instance->radio_device,
+                FuriHalSubGhzPresetCustom,
+                (uint8_t*)modulations[instance->modulation]);
+            instance->loaded_modulation = instance->modulation;
+            instance->settle_time_us = instance->modulation == NARROW_MODULATION ?
+                                           SETTLE_TIME_NARROW_US :
+                                           SETTLE_TIME_DEFAULT_US;
+        }
         //subghz_devices_load_preset(
         //    instance->radio_device, FuriHalSubGhzPresetCustom, (uint8_t*)default_modulation);
         //furi_hal_subghz_load_custom_preset(modulations[instance->modulation]);
@@ -205,6 +261,10 @@ static int32_t spectrum_analyzer_worker_thread(void* context) {
         // TODO: Check filter!
         // spectrum_analyzer_worker_set_filter(instance);
 
+        if(instance->frequencies_changed) {
+            spectrum_analyzer_worker_build_channels(instance);
+        }
+
         instance->max_rssi_dec = 0;
 
         // Visit each channel non-consecutively
@@ -212,15 +272,16 @@ static int32_t spectrum_analyzer_worker_thread(void* context) {
             ++chunk >= NUM_CHUNKS && ++ch_offset && (chunk = 0)) {
             uint8_t ch = chunk * CHUNK_SIZE + ch_offset;
 
-            if(subghz_devices_is_frequency_valid(
-                   instance->radio_device,
-                   instance->channel0_frequency + (ch * instance->spacing)))
-                subghz_devices_set_frequency(
-                    instance->radio_device,
-                    instance->channel0_frequency + (ch * instance->spacing));
+            // Out of the radio range: nothing to measure
+            if(instance->channel_frequency[ch] == 0) {
+                instance->channel_ss[ch] = 0;
+                continue;
+            }
+
+            subghz_devices_set_frequency(instance->radio_device, instance->channel_frequency[ch]);
 
             subghz_devices_set_rx(instance->radio_device);
-            furi_delay_ms(3);
+            furi_delay_us(instance->settle_time_us);
 
             //         dec      dBm
             //max_ss = 127 ->  -10.5
@@ -240,6 +301,15 @@ static int32_t spectrum_analyzer_worker_thread(void* context) {
 
         // FURI_LOG_T("SpectrumWorker", "channel_ss[0]: %u", instance->channel_ss[0]);
 
+        if(++sweep_count == 16) {
+            FURI_LOG_T(
+                "SpectrumWorker",
+                "%lu ms per sweep",
+                (furi_get_tick() - sweep_start) / sweep_count);
+            sweep_count = 0;
+            sweep_start = furi_get_tick();
+        }
+
         // Report results back to main thread
         if(instance->callback) {
             instance->callback(
@@ -258,6 +328,7 @@ SpectrumAnalyzerWorker* spectrum_analyzer_worker_alloc() {
     FURI_LOG_D("Spectrum", "spectrum_analyzer_worker_alloc: Start");
 
     SpectrumAnalyzerWorker* instance = malloc(sizeof(SpectrumAnalyzerWorker));
+    instance->loaded_modulation = MODULATION_NONE;
 
     instance->thread = furi_thread_alloc();
     furi_thread_set_name(instance->thread, "SpectrumWorker");
@@ -314,6 +385,7 @@ void spectrum_analyzer_worker_set_frequencies(
     instance->channel0_frequency = channel0_frequency;
     instance->spacing = spacing;
     instance->width = width;
+    instance->frequencies_changed = true;
 }
 
 void spectrum_analyzer_worker_set_modulation(SpectrumAnalyzerWorker* instance, uint8_t modulation) {
@@ -0,0 +1,218 @@
+#include "mock_subghz.h"
+#include "../helpers/radio_device_loader.h"
+
+#include <pthread.h>
+
+// Manual calibration after each frequency change, the firmware waits for the
+// chip to get back to IDLE (CC1101 datasheet, FS calibration at 26 MHz)
+#define CALIBRATION_US 721
+// One register access on the 8 MHz SPI bus, with chip select and status byte
+#define SPI_ACCESS_US 3
+// Register writes of the Ook650Async firmware preset
+#define FIRMWARE_PRESET_WRITES 20
+#define PATABLE_SIZE 8
+
+MockSubGhzCounters mock_subghz;
+
+static uint64_t now_us;
+static uint32_t frequency;
+static bool rx;
+static const SubGhzDevice mock_device = {"cc1101_mock"};
+
+// A strong carrier and a weak one above a noise floor that depends on the frequency, so every
+// channel reads a value that only depends on where the radio is tuned
+static const struct {
+    uint32_t frequency;
+    float rssi;
+} carriers[] = {{433920000, -35.0f}, {434420000, -62.0f}, {315000000, -50.0f}};
+
+static void spi_access(uint32_t count) {
+    now_us += count * SPI_ACCESS_US;
+    mock_subghz.busy_us += count * SPI_ACCESS_US;
+}
+
+static void strobe(void) {
+    mock_subghz.strobes++;
+    spi_access(1);
+}
+
+uint64_t mock_subghz_now_us(void) {
+    return now_us;
+}
+
+uint32_t mock_subghz_frequency(void) {
+    return frequency;
+}
+
+void subghz_devices_init(void) {
+}
+
+void subghz_devices_deinit(void) {
+}
+
+void subghz_devices_reset(const SubGhzDevice* device) {
+    UNUSED(device);
+    strobe();
+}
+
+void subghz_devices_sleep(const SubGhzDevice* device) {
+    UNUSED(device);
+    strobe();
+}
+
+void subghz_devices_idle(const SubGhzDevice* device) {
+    UNUSED(device);
+    rx = false;
+    strobe();
+}
+
+// Like furi_hal_subghz_load_custom_preset(): the chip is reset, then the register pairs up
+// to the 0, 0 terminator and the PATABLE that follows it are written
+void subghz_devices_load_preset(
+    const SubGhzDevice* device,
+    FuriHalSubGhzPreset preset,
+    uint8_t* preset_data) {
+    UNUSED(device);
+    uint32_t writes = FIRMWARE_PRESET_WRITES;
+
+    if(preset == FuriHalSubGhzPresetCustom) {
+        writes = 0;
+        while(preset_data[writes * 2] != 0) {
+            writes++;
+        }
+    }
+
+    mock_subghz.preset_loads++;
+    strobe();
+    mock_subghz.register_writes += writes + PATABLE_SIZE;
+    spi_access(writes + PATABLE_SIZE);
+}
+
+bool subghz_devices_is_frequency_valid(const SubGhzDevice* device, uint32_t value) {
+    UNUSED(device);
+    return (value >= 281000000 && value <= 361000000) ||
+           (value >= 378000000 && value <= 481000000) ||
+           (value >= 749000000 && value <= 962000000);
+}
+
+// FREQ2, FREQ1 and FREQ0, then SCAL and the wait for the calibration to end
+uint32_t subghz_devices_set_frequency(const SubGhzDevice* device, uint32_t value) {
+    UNUSED(device);
+    frequency = value;
+    mock_subghz.register_writes += 3;
+    spi_access(3);
+    strobe();
+    mock_subghz.calibrations++;
+    now_us += CALIBRATION_US;
+    mock_subghz.busy_us += CALIBRATION_US;
+    return value;
+}
+
+void subghz_devices_set_rx(const SubGhzDevice* device) {
+    UNUSED(device);
+    rx = true;
+    strobe();
+}
+
+void subghz_devices_flush_rx(const SubGhzDevice* device) {
+    UNUSED(device);
+    strobe();
+}
+
+float subghz_devices_get_rssi(const SubGhzDevice* device) {
+    UNUSED(device);
+    mock_subghz.rssi_reads++;
+    spi_access(1);
+
+    float rssi = -100.0f + (float)((frequency / 10000) % 8);
+
+    for(size_t i = 0; i < sizeof(carriers) / sizeof(carriers[0]); i++) {
+        uint32_t distance = frequency > carriers[i].frequency ? frequency - carriers[i].frequency :
+                                                                carriers[i].frequency - frequency;
+        if(distance < 100000 && carriers[i].rssi > rssi) rssi = carriers[i].rssi;
+    }
+
+    return rssi;
+}
+
+const SubGhzDevice* radio_device_loader_set(
+    const SubGhzDevice* current_radio_device,
+    SubGhzRadioDeviceType radio_device_type) {
+    UNUSED(current_radio_device);
+    UNUSED(radio_device_type);
+    return &mock_device;
+}
+
+void radio_device_loader_end(const SubGhzDevice* radio_device) {
+    UNUSED(radio_device);
+}
+
+// furi
+
+struct FuriThread {
+    pthread_t thread;
+    FuriThreadCallback callback;
+    void* context;
+};
+
+FuriThread* furi_thread_alloc(void) {
+    return calloc(1, sizeof(FuriThread));
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
+
+void furi_thread_set_name(FuriThread* thread, const char* name) {
+    UNUSED(thread);
+    UNUSED(name);
+}
+
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    UNUSED(thread);
+    UNUSED(stack_size);
+}
+
+void furi_thread_set_context(FuriThread* thread, void* context) {
+    thread->context = context;
+}
+
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    thread->callback = callback;
+}
+
+static void* furi_thread_body(void* arg) {
+    FuriThread* thread = arg;
+    thread->callback(thread->context);
+    return NULL;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    pthread_create(&thread->thread, NULL, furi_thread_body, thread);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    return pthread_join(thread->thread, NULL) == 0;
+}
+
+// A delay in RX waits for the RSSI to settle, any other one is a pause between sweeps
+static void delay(uint64_t microseconds) {
+    now_us += microseconds;
+    if(rx) {
+        mock_subghz.settle_us += microseconds;
+    } else {
+        mock_subghz.idle_us += microseconds;
+    }
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    delay((uint64_t)milliseconds * 1000);
+}
+
+void furi_delay_us(uint32_t microseconds) {
+    delay(microseconds);
+}
+
+uint32_t furi_get_tick(void) {
+    return now_us / 1000;
+}
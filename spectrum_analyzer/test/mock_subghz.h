@@ -0,0 +1,26 @@
+#pragma once
+
+// Mock CC1101 behind the subghz_devices API. Every call is counted the way the
+// firmware driver talks to the chip, and the time it would take is added to a
+// simulated clock together with the worker's own delays.
+
+#include <lib/subghz/devices/devices.h>
+
+typedef struct {
+    uint32_t preset_loads;
+    uint32_t register_writes; // configuration and FREQ registers, PATABLE bytes
+    uint32_t strobes;
+    uint32_t calibrations;
+    uint32_t rssi_reads;
+    uint64_t settle_us; // delays in RX, waiting for the RSSI to settle
+    uint64_t idle_us; // other delays, the pause between sweeps
+    uint64_t busy_us; // SPI accesses and the frequency synthesizer calibration
+} MockSubGhzCounters;
+
+extern MockSubGhzCounters mock_subghz;
+
+// Simulated time in microseconds since start
+uint64_t mock_subghz_now_us(void);
+
+// Frequency the radio is tuned to, 0 before the first set_frequency
+uint32_t mock_subghz_frequency(void);
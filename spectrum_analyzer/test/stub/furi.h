@@ -0,0 +1,40 @@
+#pragma once
+
+// Just enough of furi for the spectrum analyzer worker to build on the host.
+// Threads are pthreads, delays only advance the simulated clock of mock_subghz.c.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+#define furi_assert(x) (void)(x)
+
+static inline void furi_log_print(const char* tag, const char* format, ...) {
+    (void)tag;
+    (void)format;
+}
+
+#define FURI_LOG_E(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_T(tag, ...) furi_log_print(tag, __VA_ARGS__)
+
+typedef int32_t (*FuriThreadCallback)(void* context);
+typedef struct FuriThread FuriThread;
+
+FuriThread* furi_thread_alloc(void);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_name(FuriThread* thread, const char* name);
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size);
+void furi_thread_set_context(FuriThread* thread, void* context);
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+
+void furi_delay_ms(uint32_t milliseconds);
+void furi_delay_us(uint32_t microseconds);
+uint32_t furi_get_tick(void);
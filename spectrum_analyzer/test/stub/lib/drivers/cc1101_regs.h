@@ -0,0 +1,16 @@
+#pragma once
+
+// The CC1101 configuration registers written by the worker presets
+
+#define CC1101_FSCTRL1 0x0B
+#define CC1101_FSCTRL0 0x0C
+#define CC1101_FREQ2 0x0D
+#define CC1101_FREQ1 0x0E
+#define CC1101_FREQ0 0x0F
+#define CC1101_MDMCFG4 0x10
+#define CC1101_AGCCTRL2 0x1B
+#define CC1101_AGCCTRL1 0x1C
+#define CC1101_AGCCTRL0 0x1D
+#define CC1101_TEST2 0x2C
+#define CC1101_TEST1 0x2D
+#define CC1101_TEST0 0x2E
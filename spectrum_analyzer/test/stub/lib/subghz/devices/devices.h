@@ -0,0 +1,35 @@
+#pragma once
+
+// The subset of the subghz_devices API used by the worker, implemented by mock_subghz.c
+
+#include <furi.h>
+
+typedef enum {
+    FuriHalSubGhzPresetIDLE,
+    FuriHalSubGhzPresetOok270Async,
+    FuriHalSubGhzPresetOok650Async,
+    FuriHalSubGhzPreset2FSKDev238Async,
+    FuriHalSubGhzPreset2FSKDev476Async,
+    FuriHalSubGhzPresetMSK99_97KbAsync,
+    FuriHalSubGhzPresetGFSK9_99KbAsync,
+    FuriHalSubGhzPresetCustom,
+} FuriHalSubGhzPreset;
+
+typedef struct {
+    const char* name;
+} SubGhzDevice;
+
+void subghz_devices_init(void);
+void subghz_devices_deinit(void);
+void subghz_devices_reset(const SubGhzDevice* device);
+void subghz_devices_sleep(const SubGhzDevice* device);
+void subghz_devices_idle(const SubGhzDevice* device);
+void subghz_devices_load_preset(
+    const SubGhzDevice* device,
+    FuriHalSubGhzPreset preset,
+    uint8_t* preset_data);
+bool subghz_devices_is_frequency_valid(const SubGhzDevice* device, uint32_t frequency);
+uint32_t subghz_devices_set_frequency(const SubGhzDevice* device, uint32_t frequency);
+void subghz_devices_set_rx(const SubGhzDevice* device);
+void subghz_devices_flush_rx(const SubGhzDevice* device);
+float subghz_devices_get_rssi(const SubGhzDevice* device);
@@ -0,0 +1,220 @@
+// Runs the sweep worker, and the worker as it was before the channel table and the settle
+// time per RX filter, against a mock CC1101 for each spacing mode. Reports the register
+// writes, strobes, calibrations and the time of one steady state sweep, and checks that both
+// workers read the same RSSI on every channel the radio can tune to.
+//
+//   make -C spectrum_analyzer/test run
+
+#include <pthread.h>
+
+#include "../spectrum_analyzer.h"
+#include "../spectrum_analyzer_worker.h"
+#include "mock_subghz.h"
+
+#define WARMUP_SWEEPS 2 // the first sweep also starts the radio and loads the preset
+#define SWEEPS 16
+
+SpectrumAnalyzerWorker* spectrum_analyzer_worker_ref_alloc();
+void spectrum_analyzer_worker_ref_free(SpectrumAnalyzerWorker* instance);
+void spectrum_analyzer_worker_ref_set_callback(
+    SpectrumAnalyzerWorker* instance,
+    SpectrumAnalyzerWorkerCallback callback,
+    void* context);
+void spectrum_analyzer_worker_ref_set_frequencies(
+    SpectrumAnalyzerWorker* instance,
+    uint32_t channel0_frequency,
+    uint32_t spacing,
+    uint8_t width);
+void spectrum_analyzer_worker_ref_set_modulation(
+    SpectrumAnalyzerWorker* instance,
+    uint8_t modulation);
+void spectrum_analyzer_worker_ref_start(SpectrumAnalyzerWorker* instance);
+void spectrum_analyzer_worker_ref_stop(SpectrumAnalyzerWorker* instance);
+
+typedef struct {
+    const char* name;
+    SpectrumAnalyzerWorker* (*alloc)();
+    void (*free)(SpectrumAnalyzerWorker*);
+    void (*set_callback)(SpectrumAnalyzerWorker*, SpectrumAnalyzerWorkerCallback, void*);
+    void (*set_frequencies)(SpectrumAnalyzerWorker*, uint32_t, uint32_t, uint8_t);
+    void (*set_modulation)(SpectrumAnalyzerWorker*, uint8_t);
+    void (*start)(SpectrumAnalyzerWorker*);
+    void (*stop)(SpectrumAnalyzerWorker*);
+} WorkerApi;
+
+static const WorkerApi workers[2] = {
+    {"old",
+     spectrum_analyzer_worker_ref_alloc,
+     spectrum_analyzer_worker_ref_free,
+     spectrum_analyzer_worker_ref_set_callback,
+     spectrum_analyzer_worker_ref_set_frequencies,
+     spectrum_analyzer_worker_ref_set_modulation,
+     spectrum_analyzer_worker_ref_start,
+     spectrum_analyzer_worker_ref_stop},
+    {"new",
+     spectrum_analyzer_worker_alloc,
+     spectrum_analyzer_worker_free,
+     spectrum_analyzer_worker_set_callback,
+     spectrum_analyzer_worker_set_frequencies,
+     spectrum_analyzer_worker_set_modulation,
+     spectrum_analyzer_worker_start,
+     spectrum_analyzer_worker_stop},
+};
+
+typedef struct {
+    const char* name;
+    uint8_t width;
+    uint32_t spacing;
+    uint32_t center_khz; // already rounded like spectrum_analyzer_calculate_frequencies()
+    uint8_t modulation;
+} Mode;
+
+static const Mode modes[] = {
+    {"wide", WIDE, WIDE_SPACING, 435000, DEFAULT_MODULATION},
+    {"narrow", NARROW, NARROW_SPACING, 433920, DEFAULT_MODULATION},
+    {"narrow 58k", NARROW, NARROW_SPACING, 433920, NARROW_MODULATION},
+    {"ultranarrow 58k", ULTRANARROW, ULTRANARROW_SPACING, 433920, NARROW_MODULATION},
+    {"precise 58k", PRECISE, PRECISE_SPACING, 433920, NARROW_MODULATION},
+    {"ultrawide", ULTRAWIDE, ULTRAWIDE_SPACING, 440000, DEFAULT_MODULATION},
+    {"ultrawide gap", ULTRAWIDE, ULTRAWIDE_SPACING, 360000, DEFAULT_MODULATION},
+};
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    uint32_t sweeps;
+    MockSubGhzCounters start, end;
+    uint64_t start_us, end_us;
+    uint8_t channel_ss[NUM_CHANNELS];
+} Run;
+
+static void sweep_callback(
+    void* chan_table,
+    float max_rssi,
+    uint8_t max_rssi_dec,
+    uint8_t max_rssi_channel,
+    void* context) {
+    UNUSED(max_rssi);
+    UNUSED(max_rssi_dec);
+    UNUSED(max_rssi_channel);
+    Run* run = context;
+
+    pthread_mutex_lock(&run->lock);
+    run->sweeps++;
+
+    if(run->sweeps == WARMUP_SWEEPS) {
+        run->start = mock_subghz;
+        run->start_us = mock_subghz_now_us();
+    } else if(run->sweeps == WARMUP_SWEEPS + SWEEPS) {
+        run->end = mock_subghz;
+        run->end_us = mock_subghz_now_us();
+        memcpy(run->channel_ss, chan_table, NUM_CHANNELS);
+        pthread_cond_signal(&run->done);
+    }
+
+    pthread_mutex_unlock(&run->lock);
+}
+
+static void run_worker(const WorkerApi* api, const Mode* mode, Run* run) {
+    memset(run, 0, sizeof(Run));
+    pthread_mutex_init(&run->lock, NULL);
+    pthread_cond_init(&run->done, NULL);
+
+    SpectrumAnalyzerWorker* worker = api->alloc();
+    api->set_callback(worker, sweep_callback, run);
+    api->set_frequencies(
+        worker,
+        mode->center_khz * 1000 - (mode->spacing * ((NUM_CHANNELS / 2) + 1)),
+        mode->spacing,
+        mode->width);
+    api->set_modulation(worker, mode->modulation);
+    api->start(worker);
+
+    pthread_mutex_lock(&run->lock);
+    while(run->sweeps < WARMUP_SWEEPS + SWEEPS) {
+        pthread_cond_wait(&run->done, &run->lock);
+    }
+    pthread_mutex_unlock(&run->lock);
+
+    api->stop(worker);
+    api->free(worker);
+
+    pthread_cond_destroy(&run->done);
+    pthread_mutex_destroy(&run->lock);
+}
+
+static double per_sweep(uint64_t start, uint64_t end) {
+    return (double)(end - start) / SWEEPS;
+}
+
+int main(void) {
+    uint32_t failures = 0;
+
+    printf(
+        "%-16s %-4s %7s %7s %7s %7s %9s %9s %9s %9s\n",
+        "mode",
+        "",
+        "presets",
+        "writes",
+        "strobes",
+        "cal",
+        "settle ms",
+        "busy ms",
+        "idle ms",
+        "sweep ms");
+
+    for(size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        const Mode* mode = &modes[m];
+        Run runs[2];
+
+        for(int w = 0; w < 2; w++) {
+            Run* run = &runs[w];
+            run_worker(&workers[w], mode, run);
+
+            printf(
+                "%-16s %-4s %7.1f %7.1f %7.1f %7.1f %9.1f %9.1f %9.1f %9.1f\n",
+                w == 0 ? mode->name : "",
+                workers[w].name,
+                per_sweep(run->start.preset_loads, run->end.preset_loads),
+                per_sweep(run->start.register_writes, run->end.register_writes),
+                per_sweep(run->start.strobes, run->end.strobes),
+                per_sweep(run->start.calibrations, run->end.calibrations),
+                per_sweep(run->start.settle_us, run->end.settle_us) / 1000,
+                per_sweep(run->start.busy_us, run->end.busy_us) / 1000,
+                per_sweep(run->start.idle_us, run->end.idle_us) / 1000,
+                per_sweep(run->start_us, run->end_us) / 1000);
+        }
+
+        // The old worker measured out-of-range channels at whatever frequency was set
+        // before, the new one skips them and reports 0
+        uint32_t channel0 = mode->center_khz * 1000 - (mode->spacing * ((NUM_CHANNELS / 2) + 1));
+        uint32_t valid = 0, differ = 0, skipped_not_zero = 0;
+
+        for(uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+            if(subghz_devices_is_frequency_valid(NULL, channel0 + ch * mode->spacing)) {
+                valid++;
+                if(runs[0].channel_ss[ch] != runs[1].channel_ss[ch]) differ++;
+            } else if(runs[1].channel_ss[ch] != 0) {
+                skipped_not_zero++;
+            }
+        }
+
+        printf(
+            "%-16s %u/%u channels in range, %u read differently, %u out of range not 0\n",
+            "",
+            valid,
+            NUM_CHANNELS,
+            differ,
+            skipped_not_zero);
+
+        failures += differ + skipped_not_zero;
+    }
+
+    if(failures) {
+        printf("FAILED: %u channels\n", failures);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -74,8 +74,8 @@ bool spi_mem_tools_read_chip_info(SPIMemChip* chip) {
 
 bool spi_mem_tools_check_chip_info(SPIMemChip* chip) {
     SPIMemChip new_chip_info;
-    spi_mem_tools_read_chip_info(&new_chip_info);
     do {
+        if(!spi_mem_tools_read_chip_info(&new_chip_info)) break;
         if(chip->vendor_id != new_chip_info.vendor_id) break;
         if(chip->type_id != new_chip_info.type_id) break;
         if(chip->capacity_id != new_chip_info.capacity_id) break;
@@ -140,6 +140,24 @@ bool spi_mem_tools_erase_chip(SPIMemChip* chip) {
     return true;
 }
 
+bool spi_mem_tools_erase_sector(SPIMemChip* chip, size_t offset) {
+    uint8_t cmd[4];
+    do {
+        if(!spi_mem_tools_check_chip_info(chip)) break;
+        if((offset + SPI_MEM_SECTOR_SIZE) > chip->size) break;
+        if(!spi_mem_tools_set_write_enabled(chip, true)) break;
+        if(!spi_mem_tools_trx(
+               SPIMemChipCMDSectorErase,
+               cmd,
+               spi_mem_tools_addr_to_byte_arr(offset, cmd),
+               NULL,
+               0))
+            break;
+        return true;
+    } while(0);
+    return false;
+}
+
 bool spi_mem_tools_write_bytes(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size) {
     do {
         if(!spi_mem_tools_check_chip_info(chip)) break;
@@ -7,9 +7,10 @@ typedef enum {
     SPIMemEventVerify = (1 << 3),
     SPIMemEventErase = (1 << 4),
     SPIMemEventWrite = (1 << 5),
+    SPIMemEventUpdate = (1 << 6),
     SPIMemEventAll =
         (SPIMemEventStopThread | SPIMemEventChipDetect | SPIMemEventRead | SPIMemEventVerify |
-         SPIMemEventErase | SPIMemEventWrite)
+         SPIMemEventErase | SPIMemEventWrite | SPIMemEventUpdate)
 } SPIMemEventEventType;
 
 static int32_t spi_mem_worker_thread(void* thread_context);
@@ -48,6 +49,7 @@ static int32_t spi_mem_worker_thread(void* thread_context) {
             if(flags & SPIMemEventVerify) worker->mode_index = SPIMemWorkerModeVerify;
             if(flags & SPIMemEventErase) worker->mode_index = SPIMemWorkerModeErase;
             if(flags & SPIMemEventWrite) worker->mode_index = SPIMemWorkerModeWrite;
+            if(flags & SPIMemEventUpdate) worker->mode_index = SPIMemWorkerModeUpdate;
             if(spi_mem_worker_modes[worker->mode_index].process) {
                 spi_mem_worker_modes[worker->mode_index].process(worker);
             }
@@ -127,3 +129,15 @@ void spi_mem_worker_write_start(
     worker->chip_info = chip_info;
     furi_thread_flags_set(furi_thread_get_id(worker->thread), SPIMemEventWrite);
 }
+
+void spi_mem_worker_update_start(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context) {
+    furi_check(worker->mode_index == SPIMemWorkerModeIdle);
+    worker->callback = callback;
+    worker->cb_ctx = context;
+    worker->chip_info = chip_info;
+    furi_thread_flags_set(furi_thread_get_id(worker->thread), SPIMemEventUpdate);
+}
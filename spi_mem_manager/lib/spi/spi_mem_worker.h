@@ -17,6 +17,7 @@ typedef enum {
     SPIMemCustomEventWorkerFileFail,
     SPIMemCustomEventWorkerDone,
     SPIMemCustomEventWorkerVerifyFail,
+    SPIMemCustomEventWorkerEraseFail,
 } SPIMemCustomEventWorker;
 
 typedef void (*SPIMemWorkerCallback)(void* context, SPIMemCustomEventWorker event);
@@ -52,3 +53,8 @@ void spi_mem_worker_write_start(
     SPIMemWorker* worker,
     SPIMemWorkerCallback callback,
     void* context);
+void spi_mem_worker_update_start(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context);
@@ -8,6 +8,7 @@ static void spi_mem_worker_read_process(SPIMemWorker* worker);
 static void spi_mem_worker_verify_process(SPIMemWorker* worker);
 static void spi_mem_worker_erase_process(SPIMemWorker* worker);
 static void spi_mem_worker_write_process(SPIMemWorker* worker);
+static void spi_mem_worker_update_process(SPIMemWorker* worker);
 
 const SPIMemWorkerModeType spi_mem_worker_modes[] = {
     [SPIMemWorkerModeIdle] = {.process = NULL},
@@ -15,7 +16,8 @@ const SPIMemWorkerModeType spi_mem_worker_modes[] = {
     [SPIMemWorkerModeRead] = {.process = spi_mem_worker_read_process},
     [SPIMemWorkerModeVerify] = {.process = spi_mem_worker_verify_process},
     [SPIMemWorkerModeErase] = {.process = spi_mem_worker_erase_process},
-    [SPIMemWorkerModeWrite] = {.process = spi_mem_worker_write_process}};
+    [SPIMemWorkerModeWrite] = {.process = spi_mem_worker_write_process},
+    [SPIMemWorkerModeUpdate] = {.process = spi_mem_worker_update_process}};
 
 static void spi_mem_worker_run_callback(SPIMemWorker* worker, SPIMemCustomEventWorker event) {
     if(worker->callback) {
@@ -25,12 +27,12 @@ static void spi_mem_worker_run_callback(SPIMemWorker* worker, SPIMemCustomEventW
 
 static bool spi_mem_worker_await_chip_busy(SPIMemWorker* worker) {
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
         if(spi_mem_worker_check_for_stop(worker)) return true;
         SPIMemChipStatus chip_status = spi_mem_tools_get_chip_status(worker->chip_info);
         if(chip_status == SPIMemChipStatusError) return false;
-        if(chip_status == SPIMemChipStatusBusy) continue;
-        return true;
+        if(chip_status == SPIMemChipStatusIdle) return true;
+        // page program takes about a millisecond, poll at tick rate
+        furi_delay_tick(1);
     }
 }
 
@@ -59,28 +61,32 @@ static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker) {
 
 // Read
 static bool spi_mem_worker_read(SPIMemWorker* worker, SPIMemCustomEventWorker* event) {
-    uint8_t data_buffer[SPI_MEM_FILE_BUFFER_SIZE];
     size_t chip_size = spi_mem_chip_get_size(worker->chip_info);
     size_t offset = 0;
     bool success = true;
+    // the previous block is stored while the next one is read from the chip
+    SPIMemFilePipe* pipe = spi_mem_file_pipe_alloc(worker->cb_ctx, true, chip_size);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
+        furi_thread_yield(); // to give some time to OS
         size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= chip_size) break;
         if((offset + block_size) > chip_size) block_size = chip_size - offset;
+        uint8_t* data_buffer = spi_mem_file_pipe_acquire(pipe);
         if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer, block_size)) {
+            spi_mem_file_pipe_release(pipe, data_buffer, 0);
             *event = SPIMemCustomEventWorkerChipFail;
             success = false;
             break;
         }
-        if(!spi_mem_file_write_block(worker->cb_ctx, data_buffer, block_size)) {
+        if(!spi_mem_file_pipe_release(pipe, data_buffer, block_size)) {
             success = false;
             break;
         }
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    if(!spi_mem_file_pipe_free(pipe)) success = false;
     if(success) *event = SPIMemCustomEventWorkerDone;
     return success;
 }
@@ -100,11 +106,12 @@ static void spi_mem_worker_read_process(SPIMemWorker* worker) {
 static bool
     spi_mem_worker_verify(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
     uint8_t data_buffer_chip[SPI_MEM_FILE_BUFFER_SIZE];
-    uint8_t data_buffer_file[SPI_MEM_FILE_BUFFER_SIZE];
     size_t offset = 0;
     bool success = true;
+    // the next file block is read while the chip is compared
+    SPIMemFilePipe* pipe = spi_mem_file_pipe_alloc(worker->cb_ctx, false, total_size);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
+        furi_thread_yield(); // to give some time to OS
         size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= total_size) break;
@@ -114,11 +121,14 @@ static bool
             success = false;
             break;
         }
-        if(!spi_mem_file_read_block(worker->cb_ctx, data_buffer_file, block_size)) {
+        uint8_t* data_buffer_file = spi_mem_file_pipe_acquire(pipe);
+        if(!data_buffer_file) {
             success = false;
             break;
         }
-        if(memcmp(data_buffer_chip, data_buffer_file, block_size) != 0) {
+        bool equal = memcmp(data_buffer_chip, data_buffer_file, block_size) == 0;
+        spi_mem_file_pipe_release(pipe, data_buffer_file, 0);
+        if(!equal) {
             *event = SPIMemCustomEventWorkerVerifyFail;
             success = false;
             break;
@@ -126,6 +136,7 @@ static bool
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_file_pipe_free(pipe);
     if(success) *event = SPIMemCustomEventWorkerDone;
     return success;
 }
@@ -173,28 +184,33 @@ static bool spi_mem_worker_write_block_by_page(
 static bool
     spi_mem_worker_write(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
     bool success = true;
-    uint8_t data_buffer[SPI_MEM_FILE_BUFFER_SIZE];
     size_t page_size = spi_mem_chip_get_page_size(worker->chip_info);
     size_t offset = 0;
+    // the next file block is read while the chip is programmed
+    SPIMemFilePipe* pipe = spi_mem_file_pipe_alloc(worker->cb_ctx, false, total_size);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
+        furi_thread_yield(); // to give some time to OS
         size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= total_size) break;
         if((offset + block_size) > total_size) block_size = total_size - offset;
-        if(!spi_mem_file_read_block(worker->cb_ctx, data_buffer, block_size)) {
+        uint8_t* data_buffer = spi_mem_file_pipe_acquire(pipe);
+        if(!data_buffer) {
             *event = SPIMemCustomEventWorkerFileFail;
             success = false;
             break;
         }
-        if(!spi_mem_worker_write_block_by_page(
-               worker, offset, data_buffer, block_size, page_size)) {
+        bool written = spi_mem_worker_write_block_by_page(
+            worker, offset, data_buffer, block_size, page_size);
+        spi_mem_file_pipe_release(pipe, data_buffer, 0);
+        if(!written) {
             success = false;
             break;
         }
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_file_pipe_free(pipe);
     return success;
 }
 
@@ -212,3 +228,132 @@ static void spi_mem_worker_write_process(SPIMemWorker* worker) {
     spi_mem_file_close(worker->cb_ctx);
     spi_mem_worker_run_callback(worker, event);
 }
+
+// Update, erases and programs only the sectors that differ from the file
+static bool spi_mem_worker_is_blank(const uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        if(data[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+// Only the 4KB sector erase (0x20) is used. A part that ignores or rejects it keeps the old
+// contents, and programming on top of them would AND the new data into the sector.
+static bool spi_mem_worker_check_erased(
+    SPIMemWorker* worker,
+    size_t offset,
+    size_t sector_size,
+    SPIMemCustomEventWorker* event) {
+    uint8_t data_buffer[SPI_MEM_MAX_BLOCK_SIZE];
+    for(size_t i = 0; i < sector_size; i += SPI_MEM_MAX_BLOCK_SIZE) {
+        if(!spi_mem_tools_read_block(
+               worker->chip_info, offset + i, data_buffer, SPI_MEM_MAX_BLOCK_SIZE))
+            return false;
+        if(!spi_mem_worker_is_blank(data_buffer, SPI_MEM_MAX_BLOCK_SIZE)) {
+            *event = SPIMemCustomEventWorkerEraseFail;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool spi_mem_worker_update_sector(
+    SPIMemWorker* worker,
+    size_t offset,
+    uint8_t* data,
+    size_t data_size,
+    uint8_t* sector_buffer,
+    SPIMemCustomEventWorker* event) {
+    size_t chip_size = spi_mem_chip_get_size(worker->chip_info);
+    size_t page_size = spi_mem_chip_get_page_size(worker->chip_info);
+    size_t sector_size = MIN((size_t)SPI_MEM_SECTOR_SIZE, chip_size - offset);
+
+    *event = SPIMemCustomEventWorkerChipFail;
+    if(!spi_mem_tools_read_block(worker->chip_info, offset, sector_buffer, sector_size))
+        return false;
+    if(memcmp(sector_buffer, data, data_size) == 0) return true;
+
+    // programming can only clear bits, setting any bit needs an erase
+    bool need_erase = false;
+    for(size_t i = 0; i < data_size; i++) {
+        if(~sector_buffer[i] & data[i]) {
+            need_erase = true;
+            break;
+        }
+    }
+
+    if(need_erase) {
+        if(!spi_mem_worker_await_chip_busy(worker)) return false;
+        if(!spi_mem_tools_erase_sector(worker->chip_info, offset)) return false;
+        if(!spi_mem_worker_await_chip_busy(worker)) return false;
+        if(!spi_mem_worker_check_erased(worker, offset, sector_size, event)) return false;
+        // the part of the sector past the end of the file keeps its contents
+        memcpy(sector_buffer, data, data_size);
+        for(size_t i = 0; i < sector_size; i += page_size) {
+            if(spi_mem_worker_is_blank(sector_buffer + i, page_size)) continue;
+            if(!spi_mem_worker_await_chip_busy(worker)) return false;
+            if(!spi_mem_tools_write_bytes(
+                   worker->chip_info, offset + i, sector_buffer + i, page_size))
+                return false;
+        }
+    } else {
+        for(size_t i = 0; i < data_size; i += page_size) {
+            size_t size = MIN(page_size, data_size - i);
+            if(memcmp(sector_buffer + i, data + i, size) == 0) continue;
+            if(!spi_mem_worker_await_chip_busy(worker)) return false;
+            if(!spi_mem_tools_write_bytes(worker->chip_info, offset + i, data + i, size))
+                return false;
+        }
+    }
+    if(!spi_mem_worker_await_chip_busy(worker)) return false;
+
+    // catches pages that did not program
+    if(!spi_mem_tools_read_block(worker->chip_info, offset, sector_buffer, data_size)) return false;
+    return memcmp(sector_buffer, data, data_size) == 0;
+}
+
+static bool
+    spi_mem_worker_update(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
+    uint8_t sector_buffer[SPI_MEM_SECTOR_SIZE];
+    size_t offset = 0;
+    bool success = true;
+    SPIMemFilePipe* pipe = spi_mem_file_pipe_alloc(worker->cb_ctx, false, total_size);
+    while(true) {
+        furi_thread_yield(); // to give some time to OS
+        size_t block_size = SPI_MEM_SECTOR_SIZE;
+        if(spi_mem_worker_check_for_stop(worker)) break;
+        if(offset >= total_size) break;
+        if((offset + block_size) > total_size) block_size = total_size - offset;
+        uint8_t* data_buffer = spi_mem_file_pipe_acquire(pipe);
+        if(!data_buffer) {
+            *event = SPIMemCustomEventWorkerFileFail;
+            success = false;
+            break;
+        }
+        bool updated = spi_mem_worker_update_sector(
+            worker, offset, data_buffer, block_size, sector_buffer, event);
+        spi_mem_file_pipe_release(pipe, data_buffer, 0);
+        if(!updated) {
+            success = false;
+            break;
+        }
+        offset += block_size;
+        spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
+    }
+    spi_mem_file_pipe_free(pipe);
+    return success;
+}
+
+static void spi_mem_worker_update_process(SPIMemWorker* worker) {
+    SPIMemCustomEventWorker event = SPIMemCustomEventWorkerChipFail;
+    size_t total_size =
+        spi_mem_worker_modes_get_total_size(worker); // need to be executed before opening file
+    do {
+        if(!spi_mem_file_open(worker->cb_ctx)) break;
+        if(!spi_mem_worker_await_chip_busy(worker)) break;
+        if(!spi_mem_worker_update(worker, total_size, &event)) break;
+        event = SPIMemCustomEventWorkerDone;
+    } while(0);
+    spi_mem_file_close(worker->cb_ctx);
+    spi_mem_worker_run_callback(worker, event);
+}
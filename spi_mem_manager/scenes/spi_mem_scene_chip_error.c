@@ -10,18 +10,18 @@ static void
 
 void spi_mem_scene_chip_error_on_enter(void* context) {
     SPIMemApp* app = context;
+    const char* text = "Error while\ncommunicating\nwith chip";
+    // Update Changes only supports chips with the 4KB sector erase (0x20)
+    if(scene_manager_get_scene_state(app->scene_manager, SPIMemSceneChipError) ==
+       SPIMemCustomEventWorkerEraseFail) {
+        text = "No 4KB sector\nerase, use\nWrite instead";
+    }
     widget_add_button_element(
         app->widget, GuiButtonTypeLeft, "Back", spi_mem_scene_chip_error_widget_callback, app);
     widget_add_string_element(
         app->widget, 85, 15, AlignCenter, AlignBottom, FontPrimary, "SPI chip error");
     widget_add_string_multiline_element(
-        app->widget,
-        85,
-        52,
-        AlignCenter,
-        AlignBottom,
-        FontSecondary,
-        "Error while\ncommunicating\nwith chip");
+        app->widget, 85, 52, AlignCenter, AlignBottom, FontSecondary, text);
     widget_add_icon_element(app->widget, 5, 6, &I_Dip8_32x36);
     view_dispatcher_switch_to_view(app->view_dispatcher, SPIMemViewWidget);
 }
@@ -48,5 +48,6 @@ bool spi_mem_scene_chip_error_on_event(void* context, SceneManagerEvent event) {
 }
 void spi_mem_scene_chip_error_on_exit(void* context) {
     SPIMemApp* app = context;
+    scene_manager_set_scene_state(app->scene_manager, SPIMemSceneChipError, 0);
     widget_reset(app->widget);
 }
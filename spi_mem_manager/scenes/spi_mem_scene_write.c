@@ -24,7 +24,13 @@ void spi_mem_scene_write_on_enter(void* context) {
         app->view_progress, spi_mem_tools_get_file_max_block_size(app->chip_info));
     view_dispatcher_switch_to_view(app->view_dispatcher, SPIMemViewProgress);
     spi_mem_worker_start_thread(app->worker);
-    spi_mem_worker_write_start(app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    if(app->mode == SPIMemModeUpdate) {
+        spi_mem_worker_update_start(
+            app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    } else {
+        spi_mem_worker_write_start(
+            app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    }
 }
 
 bool spi_mem_scene_write_on_event(void* context, SceneManagerEvent event) {
@@ -44,6 +50,10 @@ bool spi_mem_scene_write_on_event(void* context, SceneManagerEvent event) {
             scene_manager_next_scene(app->scene_manager, SPIMemSceneVerify);
         } else if(event.event == SPIMemCustomEventWorkerChipFail) {
             scene_manager_next_scene(app->scene_manager, SPIMemSceneChipError);
+        } else if(event.event == SPIMemCustomEventWorkerEraseFail) {
+            scene_manager_set_scene_state(
+                app->scene_manager, SPIMemSceneChipError, SPIMemCustomEventWorkerEraseFail);
+            scene_manager_next_scene(app->scene_manager, SPIMemSceneChipError);
         } else if(event.event == SPIMemCustomEventWorkerFileFail) {
             scene_manager_next_scene(app->scene_manager, SPIMemSceneStorageError);
         }
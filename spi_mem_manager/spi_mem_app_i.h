@@ -33,6 +33,7 @@
 typedef enum {
     SPIMemModeRead,
     SPIMemModeWrite,
+    SPIMemModeUpdate,
     SPIMemModeCompare,
     SPIMemModeErase,
     SPIMemModeDelete,
@@ -1,4 +1,5 @@
 #include "spi_mem_app_i.h"
+#include "lib/spi/spi_mem_tools.h"
 
 bool spi_mem_file_delete(SPIMemApp* app) {
     return (storage_simply_remove(app->storage, furi_string_get_cstr(app->file_path)));
@@ -66,3 +67,107 @@ size_t spi_mem_file_get_size(SPIMemApp* app) {
         return 0;
     return file_info.size;
 }
+
+#define SPI_MEM_FILE_PIPE_BUFFERS 2
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+} SPIMemFilePipeBlock;
+
+struct SPIMemFilePipe {
+    SPIMemApp* app;
+    bool write;
+    size_t size;
+    volatile bool error;
+    FuriThread* thread;
+    // buffers owned by the caller side and by the storage thread
+    FuriMessageQueue* free_queue;
+    FuriMessageQueue* full_queue;
+    uint8_t buffers[SPI_MEM_FILE_PIPE_BUFFERS][SPI_MEM_FILE_BUFFER_SIZE];
+};
+
+static int32_t spi_mem_file_pipe_thread(void* context) {
+    SPIMemFilePipe* pipe = context;
+    SPIMemFilePipeBlock block;
+    size_t offset = 0;
+    while(true) {
+        if(pipe->write) {
+            furi_check(
+                furi_message_queue_get(pipe->full_queue, &block, FuriWaitForever) ==
+                FuriStatusOk);
+            if(!block.data) break;
+            if(!pipe->error && !spi_mem_file_write_block(pipe->app, block.data, block.size)) {
+                pipe->error = true;
+            }
+            furi_message_queue_put(pipe->free_queue, &block, FuriWaitForever);
+        } else {
+            if(offset >= pipe->size) break;
+            furi_check(
+                furi_message_queue_get(pipe->free_queue, &block, FuriWaitForever) ==
+                FuriStatusOk);
+            if(!block.data) break;
+            block.size = MIN(pipe->size - offset, (size_t)SPI_MEM_FILE_BUFFER_SIZE);
+            if(!spi_mem_file_read_block(pipe->app, block.data, block.size)) {
+                pipe->error = true;
+                block.data = NULL;
+            }
+            furi_message_queue_put(pipe->full_queue, &block, FuriWaitForever);
+            if(!block.data) break;
+            offset += block.size;
+        }
+    }
+    return 0;
+}
+
+SPIMemFilePipe* spi_mem_file_pipe_alloc(SPIMemApp* app, bool write, size_t size) {
+    SPIMemFilePipe* pipe = malloc(sizeof(SPIMemFilePipe));
+    pipe->app = app;
+    pipe->write = write;
+    pipe->size = size;
+    pipe->error = false;
+    // one extra slot for the stop block
+    pipe->free_queue =
+        furi_message_queue_alloc(SPI_MEM_FILE_PIPE_BUFFERS + 1, sizeof(SPIMemFilePipeBlock));
+    pipe->full_queue =
+        furi_message_queue_alloc(SPI_MEM_FILE_PIPE_BUFFERS + 1, sizeof(SPIMemFilePipeBlock));
+    for(size_t i = 0; i < SPI_MEM_FILE_PIPE_BUFFERS; i++) {
+        SPIMemFilePipeBlock block = {.data = pipe->buffers[i], .size = 0};
+        furi_message_queue_put(pipe->free_queue, &block, FuriWaitForever);
+    }
+    pipe->thread = furi_thread_alloc();
+    furi_thread_set_name(pipe->thread, "SPIMemFilePipe");
+    furi_thread_set_stack_size(pipe->thread, 1024);
+    furi_thread_set_context(pipe->thread, pipe);
+    furi_thread_set_callback(pipe->thread, spi_mem_file_pipe_thread);
+    furi_thread_start(pipe->thread);
+    return pipe;
+}
+
+uint8_t* spi_mem_file_pipe_acquire(SPIMemFilePipe* pipe) {
+    SPIMemFilePipeBlock block;
+    FuriMessageQueue* queue = pipe->write ? pipe->free_queue : pipe->full_queue;
+    furi_check(furi_message_queue_get(queue, &block, FuriWaitForever) == FuriStatusOk);
+    return block.data;
+}
+
+bool spi_mem_file_pipe_release(SPIMemFilePipe* pipe, uint8_t* data, size_t size) {
+    SPIMemFilePipeBlock block = {.data = data, .size = size};
+    FuriMessageQueue* queue = pipe->write ? pipe->full_queue : pipe->free_queue;
+    furi_message_queue_put(queue, &block, FuriWaitForever);
+    return !pipe->error;
+}
+
+bool spi_mem_file_pipe_free(SPIMemFilePipe* pipe) {
+    // stop block, unblocks the thread if it waits for a buffer
+    SPIMemFilePipeBlock block = {.data = NULL, .size = 0};
+    furi_message_queue_put(
+        pipe->write ? pipe->full_queue : pipe->free_queue, &block, FuriWaitForever);
+    furi_thread_join(pipe->thread);
+    furi_thread_free(pipe->thread);
+    furi_message_queue_free(pipe->free_queue);
+    furi_message_queue_free(pipe->full_queue);
+    bool success = !pipe->error;
+    free(pipe);
+    return success;
+}
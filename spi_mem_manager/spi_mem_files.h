@@ -11,3 +11,15 @@ bool spi_mem_file_read_block(SPIMemApp* app, uint8_t* data, size_t size);
 void spi_mem_file_close(SPIMemApp* app);
 void spi_mem_file_show_storage_error(SPIMemApp* app, const char* error_text);
 size_t spi_mem_file_get_size(SPIMemApp* app);
+
+// Moves file blocks on a separate thread, so storage access overlaps with SPI transfers.
+// A write pipe stores the blocks it is given, a read pipe prefetches size bytes of the file.
+typedef struct SPIMemFilePipe SPIMemFilePipe;
+
+SPIMemFilePipe* spi_mem_file_pipe_alloc(SPIMemApp* app, bool write, size_t size);
+// Write pipe: free buffer to fill. Read pipe: next block of the file, NULL on read error
+uint8_t* spi_mem_file_pipe_acquire(SPIMemFilePipe* pipe);
+// Write pipe: queues size bytes of the buffer for writing. Read pipe: returns the buffer
+bool spi_mem_file_pipe_release(SPIMemFilePipe* pipe, uint8_t* data, size_t size);
+// Waits for pending writes, returns false if any storage access failed
+bool spi_mem_file_pipe_free(SPIMemFilePipe* pipe);
@@ -0,0 +1,376 @@
+// Runs the worker modes, and the modes as they were before the file pipe and the update mode,
+// against a simulated SPI NOR flash. Reports the simulated time and the bus traffic of a dump,
+// a verify and a full write (chip erase and write) of a W25Q32, then checks Update Changes:
+// only the sectors that differ are touched, a file shorter than the chip keeps the rest of the
+// chip, and a part without the 4KB sector erase gets an error with nothing programmed.
+//
+// The file is in memory and the pipe hands blocks over synchronously, so the times are the
+// SPI side only: the SD card accesses the pipe overlaps with it are not included.
+//
+//   make -C spi_mem_manager/test run
+
+#include "../lib/spi/spi_mem_worker_i.h"
+#include "../lib/spi/spi_mem_chip_i.h"
+#include "../lib/spi/spi_mem_tools.h"
+#include "../spi_mem_files.h"
+#include "host_flash.h"
+
+#define CHANGED_SECTORS 16 // sectors the update test changes, half of them need an erase
+
+extern const SPIMemWorkerModeType spi_mem_worker_modes_ref[];
+
+static const HostFlashPart w25q32 = {
+    .name = "W25Q32",
+    .jedec_id = {0xEF, 0x40, 0x16},
+    .size = 4194304,
+    .page_size = 256,
+    .sector_erase = true,
+    .page_program_us = 700,
+    .sector_erase_us = 45000,
+    .chip_erase_us = 10000000,
+};
+
+static const HostFlashPart m25p32 = {
+    .name = "M25P32",
+    .jedec_id = {0x20, 0x20, 0x16},
+    .size = 4194304,
+    .page_size = 256,
+    .sector_erase = false,
+    .page_program_us = 1400,
+    .sector_erase_us = 600000, // 64KB, 0xD8
+    .chip_erase_us = 23000000,
+};
+
+struct SPIMemApp {
+    uint8_t* file;
+    size_t file_size;
+    size_t capacity;
+    size_t position;
+    SPIMemCustomEventWorker event;
+    uint32_t blocks;
+};
+
+struct SPIMemFilePipe {
+    SPIMemApp* app;
+    bool write;
+    uint8_t buffer[SPI_MEM_FILE_BUFFER_SIZE];
+};
+
+static uint32_t failures;
+
+static void fail(const char* what) {
+    printf("FAIL %s\n", what);
+    failures++;
+}
+
+bool spi_mem_worker_check_for_stop(SPIMemWorker* worker) {
+    UNUSED(worker);
+    return false;
+}
+
+bool spi_mem_file_create_open(SPIMemApp* app) {
+    app->file_size = 0;
+    app->position = 0;
+    return true;
+}
+
+bool spi_mem_file_open(SPIMemApp* app) {
+    app->position = 0;
+    return true;
+}
+
+void spi_mem_file_close(SPIMemApp* app) {
+    UNUSED(app);
+}
+
+size_t spi_mem_file_get_size(SPIMemApp* app) {
+    return app->file_size;
+}
+
+bool spi_mem_file_write_block(SPIMemApp* app, uint8_t* data, size_t size) {
+    if(app->position + size > app->capacity) return false;
+    memcpy(app->file + app->position, data, size);
+    app->position += size;
+    app->file_size = MAX(app->file_size, app->position);
+    return true;
+}
+
+bool spi_mem_file_read_block(SPIMemApp* app, uint8_t* data, size_t size) {
+    if(app->position + size > app->file_size) return false;
+    memcpy(data, app->file + app->position, size);
+    app->position += size;
+    return true;
+}
+
+SPIMemFilePipe* spi_mem_file_pipe_alloc(SPIMemApp* app, bool write, size_t size) {
+    UNUSED(size);
+    SPIMemFilePipe* pipe = malloc(sizeof(SPIMemFilePipe));
+    pipe->app = app;
+    pipe->write = write;
+    return pipe;
+}
+
+uint8_t* spi_mem_file_pipe_acquire(SPIMemFilePipe* pipe) {
+    if(pipe->write) return pipe->buffer;
+    SPIMemApp* app = pipe->app;
+    size_t size = MIN((size_t)SPI_MEM_FILE_BUFFER_SIZE, app->file_size - app->position);
+    if(!spi_mem_file_read_block(app, pipe->buffer, size)) return NULL;
+    return pipe->buffer;
+}
+
+bool spi_mem_file_pipe_release(SPIMemFilePipe* pipe, uint8_t* data, size_t size) {
+    if(!pipe->write || size == 0) return true;
+    return spi_mem_file_write_block(pipe->app, data, size);
+}
+
+bool spi_mem_file_pipe_free(SPIMemFilePipe* pipe) {
+    free(pipe);
+    return true;
+}
+
+static void worker_callback(void* context, SPIMemCustomEventWorker event) {
+    SPIMemApp* app = context;
+    if(event == SPIMemCustomEventWorkerBlockReaded) {
+        app->blocks++;
+    } else {
+        app->event = event;
+    }
+}
+
+typedef struct {
+    double seconds;
+    HostFlashCounters counters;
+} Run;
+
+static SPIMemCustomEventWorker run_mode(
+    const SPIMemWorkerModeType* modes,
+    SPIMemWorkerMode mode,
+    SPIMemChip* chip,
+    SPIMemApp* app,
+    Run* run) {
+    SPIMemWorker worker = {
+        .chip_info = chip,
+        .mode_index = mode,
+        .callback = worker_callback,
+        .cb_ctx = app,
+    };
+    app->event = SPIMemCustomEventWorkerFileFail;
+    app->blocks = 0;
+
+    double start = host_flash_now_us();
+    HostFlashCounters before = host_flash_counters;
+    modes[mode].process(&worker);
+
+    if(run) {
+        run->seconds += (host_flash_now_us() - start) / 1e6;
+        run->counters.transactions += host_flash_counters.transactions - before.transactions;
+        run->counters.bus_bytes += host_flash_counters.bus_bytes - before.bus_bytes;
+        run->counters.status_reads += host_flash_counters.status_reads - before.status_reads;
+        run->counters.page_programs += host_flash_counters.page_programs - before.page_programs;
+        run->counters.sector_erases += host_flash_counters.sector_erases - before.sector_erases;
+        run->counters.chip_erases += host_flash_counters.chip_erases - before.chip_erases;
+        run->counters.ignored += host_flash_counters.ignored - before.ignored;
+    }
+    return app->event;
+}
+
+static void chip_of(SPIMemChip* chip, const HostFlashPart* part) {
+    *chip = (SPIMemChip){
+        .vendor_id = part->jedec_id[0],
+        .type_id = part->jedec_id[1],
+        .capacity_id = part->jedec_id[2],
+        .model_name = part->name,
+        .size = part->size,
+        .page_size = part->page_size,
+        .write_mode = SPIMemChipWriteModePage,
+    };
+}
+
+static void fill_random(uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)rand();
+    }
+}
+
+static void print_header(void) {
+    printf(
+        "%-8s %-4s %9s %9s %9s %8s %8s %7s %7s\n",
+        "",
+        "",
+        "time s",
+        "trans",
+        "KB",
+        "polls",
+        "programs",
+        "erases",
+        "ignored");
+}
+
+static void print_run(const char* name, const char* which, const Run* run) {
+    printf(
+        "%-8s %-4s %9.2f %9u %9.0f %8u %8u %7u %7u\n",
+        name,
+        which,
+        run->seconds,
+        run->counters.transactions,
+        run->counters.bus_bytes / 1024.0,
+        run->counters.status_reads,
+        run->counters.page_programs,
+        run->counters.sector_erases + run->counters.chip_erases,
+        run->counters.ignored);
+}
+
+static void check_run(const char* what, const Run* run, SPIMemCustomEventWorker event) {
+    if(event != SPIMemCustomEventWorkerDone) fail(what);
+    if(run->counters.ignored) fail("command sent while the chip was busy");
+}
+
+// Dump, verify, and erase then write the whole chip with the old and the new modes
+static void bench_w25q32(SPIMemApp* app, uint8_t* image) {
+    const SPIMemWorkerModeType* modes[2] = {spi_mem_worker_modes_ref, spi_mem_worker_modes};
+    const char* names[2] = {"old", "new"};
+    SPIMemChip chip;
+    chip_of(&chip, &w25q32);
+    host_flash_init(&w25q32);
+    size_t size = w25q32.size;
+
+    printf("%s, %zu KB, SPI at %.0f MHz\n", w25q32.name, size / 1024, 8 / SPI_BYTE_US);
+    print_header();
+
+    for(int m = 0; m < 2; m++) {
+        Run run = {0};
+        memcpy(host_flash_memory(), image, size);
+        check_run("dump", &run, run_mode(modes[m], SPIMemWorkerModeRead, &chip, app, &run));
+        if(app->file_size != size || memcmp(app->file, image, size) != 0) fail("dump contents");
+        print_run("dump", names[m], &run);
+    }
+
+    for(int m = 0; m < 2; m++) {
+        Run run = {0};
+        check_run("verify", &run, run_mode(modes[m], SPIMemWorkerModeVerify, &chip, app, &run));
+        print_run("verify", names[m], &run);
+    }
+
+    for(int m = 0; m < 2; m++) {
+        Run run = {0};
+        memset(host_flash_memory(), 0, size);
+        check_run("erase", &run, run_mode(modes[m], SPIMemWorkerModeErase, &chip, app, &run));
+        check_run("write", &run, run_mode(modes[m], SPIMemWorkerModeWrite, &chip, app, &run));
+        if(memcmp(host_flash_memory(), image, size) != 0) fail("written contents");
+        print_run("write", names[m], &run);
+    }
+}
+
+// Changes CHANGED_SECTORS sectors of the file: the even ones only clear bits and are
+// programmed in place, the odd ones set bits and need an erase
+static void change_sectors(uint8_t* file, size_t size, uint32_t* pages) {
+    *pages = 0;
+    for(uint32_t i = 0; i < CHANGED_SECTORS; i++) {
+        size_t sector = (size / SPI_MEM_SECTOR_SIZE) * (i * 2 + 1) / (CHANGED_SECTORS * 2);
+        size_t offset = sector * SPI_MEM_SECTOR_SIZE + (rand() % SPI_MEM_SECTOR_SIZE);
+        if(i % 2) {
+            while(file[offset] == 0xFF) offset++;
+            file[offset] |= ~file[offset] & -~file[offset]; // sets the lowest clear bit
+            *pages += SPI_MEM_SECTOR_SIZE / w25q32.page_size;
+        } else {
+            while(file[offset] == 0x00) offset++;
+            file[offset] &= file[offset] - 1; // clears the lowest set bit
+            (*pages)++;
+        }
+    }
+}
+
+static void test_update(SPIMemApp* app, uint8_t* image) {
+    SPIMemChip chip;
+    chip_of(&chip, &w25q32);
+    size_t size = w25q32.size;
+    uint32_t pages;
+    Run run = {0};
+
+    printf("Update Changes on the %s\n", w25q32.name);
+    print_header();
+
+    // unchanged file
+    host_flash_init(&w25q32);
+    memcpy(host_flash_memory(), image, size);
+    memcpy(app->file, image, size);
+    app->file_size = size;
+    check_run("update", &run, run_mode(spi_mem_worker_modes, SPIMemWorkerModeUpdate, &chip, app, &run));
+    if(run.counters.page_programs || run.counters.sector_erases) fail("unchanged file written");
+    print_run("same", "new", &run);
+
+    // some sectors changed
+    run = (Run){0};
+    change_sectors(app->file, size, &pages);
+    check_run("update", &run, run_mode(spi_mem_worker_modes, SPIMemWorkerModeUpdate, &chip, app, &run));
+    if(memcmp(host_flash_memory(), app->file, size) != 0) fail("updated contents");
+    if(run.counters.sector_erases != CHANGED_SECTORS / 2) fail("sector erases");
+    // a 0xFF page of an erased sector is skipped, so this is an upper bound
+    if(run.counters.page_programs > pages) fail("page programs");
+    print_run("changed", "new", &run);
+
+    // a file shorter than the chip that ends inside a sector which needs an erase
+    run = (Run){0};
+    size_t file_size = size / 4 + 1000;
+    memcpy(host_flash_memory(), image, size);
+    memcpy(app->file, image, file_size);
+    app->file_size = file_size;
+    size_t last = file_size - 1;
+    app->file[last] = app->file[last] == 0xFF ? 0x00 : 0xFF;
+    if(app->file[last] == 0x00) app->file[last - 1] = (uint8_t)~app->file[last - 1];
+    check_run("update", &run, run_mode(spi_mem_worker_modes, SPIMemWorkerModeUpdate, &chip, app, &run));
+    if(memcmp(host_flash_memory(), app->file, file_size) != 0) fail("short file contents");
+    if(memcmp(host_flash_memory() + file_size, image + file_size, size - file_size) != 0) {
+        fail("chip past the end of the file changed");
+    }
+    if(run.counters.sector_erases != 1) fail("short file sector erases");
+    print_run("short", "new", &run);
+}
+
+// The M25P32 has no 4KB sector erase, the update must stop before programming anything
+static void test_no_sector_erase(SPIMemApp* app, uint8_t* image) {
+    SPIMemChip chip;
+    chip_of(&chip, &m25p32);
+    size_t size = m25p32.size;
+    Run run = {0};
+
+    host_flash_init(&m25p32);
+    memcpy(host_flash_memory(), image, size);
+    memcpy(app->file, image, size);
+    app->file_size = size;
+    app->file[size / 2] = (uint8_t)~app->file[size / 2];
+
+    SPIMemCustomEventWorker event =
+        run_mode(spi_mem_worker_modes, SPIMemWorkerModeUpdate, &chip, app, &run);
+    if(event != SPIMemCustomEventWorkerEraseFail) fail("no sector erase not reported");
+    if(run.counters.page_programs) fail("programmed after a failed erase");
+    if(memcmp(host_flash_memory(), image, size) != 0) fail("chip changed after a failed erase");
+    printf(
+        "%s without 4KB sector erase: %s, %u pages programmed\n",
+        m25p32.name,
+        event == SPIMemCustomEventWorkerEraseFail ? "erase error" : "no error",
+        run.counters.page_programs);
+}
+
+int main(void) {
+    size_t size = w25q32.size;
+    uint8_t* image = malloc(size);
+    SPIMemApp app = {.file = malloc(size), .capacity = size};
+    srand(1);
+    fill_random(image, size);
+
+    bench_w25q32(&app, image);
+    test_update(&app, image);
+    test_no_sector_erase(&app, image);
+
+    free(app.file);
+    free(image);
+
+    if(failures) {
+        printf("FAILED: %u checks\n", failures);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
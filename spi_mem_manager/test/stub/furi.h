@@ -0,0 +1,35 @@
+#pragma once
+
+// Just enough of the Furi API for the SPI worker modes on the host, time is simulated by
+// host_flash.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// furi malloc never fails and returns zeroed memory
+#define malloc(size) calloc(1, size)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define UNUSED(x) (void)(x)
+
+#define furi_assert(x) (void)(x)
+#define furi_check(x)     \
+    do {                  \
+        if(!(x)) abort(); \
+    } while(0)
+
+typedef struct FuriString FuriString;
+typedef struct FuriThread FuriThread;
+
+// furi_delay_tick advances the simulated clock
+void furi_delay_tick(uint32_t ticks);
+void furi_thread_yield(void);
@@ -0,0 +1,225 @@
+#include "host_flash.h"
+
+#include <furi_hal.h>
+
+#define CMD_READ_JEDEC_ID 0x9F
+#define CMD_READ_DATA 0x03
+#define CMD_CHIP_ERASE 0xC7
+#define CMD_SECTOR_ERASE 0x20
+#define CMD_WRITE_ENABLE 0x06
+#define CMD_WRITE_DISABLE 0x04
+#define CMD_READ_STATUS 0x05
+#define CMD_PAGE_PROGRAM 0x02
+
+#define STATUS_BUSY (1 << 0)
+#define STATUS_WEL (1 << 1)
+
+#define SECTOR_SIZE 4096
+#define ADDRESS_BYTES 3
+
+struct FuriHalSpiBusHandle {
+    int unused;
+};
+
+FuriHalSpiBusHandle furi_hal_spi_bus_handle_external;
+HostFlashCounters host_flash_counters;
+
+static struct {
+    const HostFlashPart* part;
+    uint8_t* memory;
+    double now_us;
+    double busy_until_us;
+    bool wel;
+
+    // current transaction
+    bool selected;
+    size_t length; // bytes clocked in since chip select
+    uint8_t opcode;
+    uint32_t address;
+    size_t data_length;
+    uint8_t* page_latch;
+    bool* page_latched;
+} flash;
+
+void host_flash_init(const HostFlashPart* part) {
+    free(flash.memory);
+    free(flash.page_latch);
+    free(flash.page_latched);
+    memset(&flash, 0, sizeof(flash));
+    flash.part = part;
+    flash.memory = calloc(1, part->size);
+    memset(flash.memory, 0xFF, part->size);
+    flash.page_latch = calloc(1, part->page_size);
+    flash.page_latched = calloc(part->page_size, sizeof(bool));
+    host_flash_reset_stats();
+}
+
+uint8_t* host_flash_memory(void) {
+    return flash.memory;
+}
+
+double host_flash_now_us(void) {
+    return flash.now_us;
+}
+
+void host_flash_reset_stats(void) {
+    host_flash_counters = (HostFlashCounters){0};
+    flash.now_us = 0;
+    flash.busy_until_us = 0;
+}
+
+static bool flash_busy(void) {
+    return flash.now_us < flash.busy_until_us;
+}
+
+void furi_delay_tick(uint32_t ticks) {
+    flash.now_us += (double)ticks * TICK_US;
+}
+
+// no other thread is ready to run
+void furi_thread_yield(void) {
+}
+
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle) {
+    UNUSED(handle);
+    flash.now_us += SPI_TRANSACTION_US;
+    flash.selected = true;
+    flash.length = 0;
+    flash.address = 0;
+    flash.data_length = 0;
+    memset(flash.page_latched, 0, flash.part->page_size * sizeof(bool));
+    host_flash_counters.transactions++;
+}
+
+static bool flash_has_address(uint8_t opcode) {
+    return opcode == CMD_READ_DATA || opcode == CMD_PAGE_PROGRAM || opcode == CMD_SECTOR_ERASE;
+}
+
+static void flash_clock_in(uint8_t data) {
+    size_t index = flash.length++;
+    if(index == 0) {
+        flash.opcode = data;
+    } else if(flash_has_address(flash.opcode) && index <= ADDRESS_BYTES) {
+        flash.address = (flash.address << 8) | data;
+    } else if(flash.opcode == CMD_PAGE_PROGRAM) {
+        // the address wraps around inside the page
+        size_t page_size = flash.part->page_size;
+        size_t offset = (flash.address + flash.data_length++) % page_size;
+        flash.page_latch[offset] = data;
+        flash.page_latched[offset] = true;
+    }
+}
+
+static uint8_t flash_clock_out(void) {
+    size_t index = flash.length++;
+    if(flash_busy() && flash.opcode != CMD_READ_STATUS) return 0xFF;
+
+    switch(flash.opcode) {
+    case CMD_READ_JEDEC_ID:
+        return flash.part->jedec_id[(index - 1) % 3];
+    case CMD_READ_STATUS:
+        return (flash_busy() ? STATUS_BUSY : 0) | (flash.wel ? STATUS_WEL : 0);
+    case CMD_READ_DATA:
+        return flash.memory[(flash.address + flash.data_length++) % flash.part->size];
+    default:
+        return 0xFF;
+    }
+}
+
+// Commands take effect when chip select goes high
+static void flash_execute(void) {
+    if(flash.length == 0) return;
+
+    if(flash.opcode == CMD_READ_STATUS) {
+        host_flash_counters.status_reads++;
+        return;
+    }
+    if(flash_busy()) {
+        host_flash_counters.ignored++;
+        return;
+    }
+
+    switch(flash.opcode) {
+    case CMD_WRITE_ENABLE:
+        flash.wel = true;
+        break;
+    case CMD_WRITE_DISABLE:
+        flash.wel = false;
+        break;
+    case CMD_PAGE_PROGRAM: {
+        if(!flash.wel) {
+            host_flash_counters.ignored++;
+            break;
+        }
+        // programming can only clear bits
+        size_t page_size = flash.part->page_size;
+        size_t page = (flash.address % flash.part->size) / page_size * page_size;
+        for(size_t i = 0; i < page_size; i++) {
+            if(flash.page_latched[i]) flash.memory[page + i] &= flash.page_latch[i];
+        }
+        flash.wel = false;
+        flash.busy_until_us = flash.now_us + flash.part->page_program_us;
+        host_flash_counters.page_programs++;
+        break;
+    }
+    case CMD_SECTOR_ERASE:
+        // a part without it ignores the opcode, WEL stays set
+        if(!flash.wel || !flash.part->sector_erase) {
+            host_flash_counters.ignored++;
+            break;
+        }
+        memset(flash.memory + (flash.address % flash.part->size) / SECTOR_SIZE * SECTOR_SIZE,
+               0xFF,
+               SECTOR_SIZE);
+        flash.wel = false;
+        flash.busy_until_us = flash.now_us + flash.part->sector_erase_us;
+        host_flash_counters.sector_erases++;
+        break;
+    case CMD_CHIP_ERASE:
+        if(!flash.wel) {
+            host_flash_counters.ignored++;
+            break;
+        }
+        memset(flash.memory, 0xFF, flash.part->size);
+        flash.wel = false;
+        flash.busy_until_us = flash.now_us + flash.part->chip_erase_us;
+        host_flash_counters.chip_erases++;
+        break;
+    default:
+        break;
+    }
+}
+
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle) {
+    UNUSED(handle);
+    flash_execute();
+    flash.selected = false;
+}
+
+bool furi_hal_spi_bus_tx(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* buffer,
+    size_t size,
+    uint32_t timeout) {
+    UNUSED(handle);
+    UNUSED(timeout);
+    furi_check(flash.selected);
+    for(size_t i = 0; i < size; i++) {
+        flash_clock_in(buffer[i]);
+    }
+    flash.now_us += size * SPI_BYTE_US;
+    host_flash_counters.bus_bytes += size;
+    return true;
+}
+
+bool furi_hal_spi_bus_rx(FuriHalSpiBusHandle* handle, uint8_t* buffer, size_t size, uint32_t timeout) {
+    UNUSED(handle);
+    UNUSED(timeout);
+    furi_check(flash.selected);
+    for(size_t i = 0; i < size; i++) {
+        buffer[i] = flash_clock_out();
+    }
+    flash.now_us += size * SPI_BYTE_US;
+    host_flash_counters.bus_bytes += size;
+    return true;
+}
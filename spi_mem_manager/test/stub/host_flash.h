@@ -0,0 +1,40 @@
+#pragma once
+
+// A 25-series SPI NOR flash on the external SPI bus: JEDEC ID, status register with BUSY and
+// WEL, read, page program, 4KB sector erase and chip erase. Time is simulated: every byte on
+// the bus takes SPI_BYTE_US, programming and erasing keep the chip busy as long as the
+// datasheet says, and furi_delay_tick() moves the clock on by a millisecond per tick.
+
+#include <furi.h>
+
+#define SPI_BYTE_US 4.0 // 8 clocks at 2 MHz
+#define SPI_TRANSACTION_US 5.0 // chip select and HAL call overhead
+#define TICK_US 1000
+
+typedef struct {
+    const char* name;
+    uint8_t jedec_id[3];
+    size_t size;
+    size_t page_size;
+    bool sector_erase; // 0x20 erases 4KB, M25P parts only have 64KB sector erase (0xD8)
+    uint32_t page_program_us;
+    uint32_t sector_erase_us;
+    uint32_t chip_erase_us;
+} HostFlashPart;
+
+typedef struct {
+    uint32_t transactions;
+    uint64_t bus_bytes;
+    uint32_t status_reads;
+    uint32_t page_programs;
+    uint32_t sector_erases;
+    uint32_t chip_erases;
+    uint32_t ignored; // anything but a status read while busy, or a write without WEL
+} HostFlashCounters;
+
+extern HostFlashCounters host_flash_counters;
+
+void host_flash_init(const HostFlashPart* part);
+uint8_t* host_flash_memory(void);
+double host_flash_now_us(void);
+void host_flash_reset_stats(void);
@@ -0,0 +1,26 @@
+#pragma once
+
+// The part of M*LIB arrays spi_mem_chip.c uses
+
+#define ARRAY_DEF(name, type, oplist)                                         \
+    typedef struct {                                                          \
+        type* data;                                                           \
+        size_t size;                                                          \
+        size_t alloc;                                                         \
+    } name##_s;                                                               \
+    typedef name##_s name##_t[1];                                             \
+    static inline void name##_reset(name##_t array) {                         \
+        array->size = 0;                                                      \
+    }                                                                         \
+    static inline void name##_push_back(name##_t array, type value) {         \
+        if(array->size == array->alloc) {                                     \
+            array->alloc = array->alloc ? array->alloc * 2 : 8;               \
+            array->data = realloc(array->data, array->alloc * sizeof(type));  \
+        }                                                                     \
+        array->data[array->size++] = value;                                   \
+    }                                                                         \
+    static inline size_t name##_size(const name##_t array) {                  \
+        return array->size;                                                   \
+    }
+
+#define M_POD_OPLIST
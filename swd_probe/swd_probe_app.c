@@ -318,6 +318,7 @@ static void swd_line_reset(AppFSM* const ctx) {
     }
     swd_write_byte(ctx, 0, 8);
     ctx->dp_regs.select_ok = false;
+    ctx->memap_csw_ok = false;
     //notification_message(ctx->notification, &sequence_reset_red);
 }
 
@@ -438,6 +439,9 @@ static uint8_t swd_read_ap_single(AppFSM* const ctx, uint8_t ap, uint8_t ap_off,
 }
 
 static uint8_t swd_write_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t data) {
+    if(ap_off == MEMAP_CSW) {
+        ctx->memap_csw_ok = false;
+    }
     uint8_t ret = swd_select(ctx, ap, (ap_off >> 4) & 0x0F, 0);
     if(ret != 1) {
         DBGS("swd_select failed");
@@ -451,11 +455,36 @@ static uint8_t swd_write_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint3
     return ret;
 }
 
+/* AP reads are posted, fetch the last result without starting another access */
+static uint8_t swd_read_rdbuff(AppFSM* const ctx, uint32_t* data) {
+    *data = 0;
+    uint8_t ret = swd_transfer(ctx, false, false, REG_RDBUFF, data);
+    if(ret != 1) {
+        DBG("failed: %d", ret);
+    }
+    return ret;
+}
+
+/* CSW is only written when it differs from the one last written to this AP */
+static uint8_t swd_write_csw(AppFSM* const ctx, uint8_t ap, uint32_t csw) {
+    if(ctx->memap_csw_ok && ctx->memap_csw_ap == ap && ctx->memap_csw == csw) {
+        return 1;
+    }
+
+    uint8_t ret = swd_write_ap(ctx, ap, MEMAP_CSW, csw);
+    if(ret == 1) {
+        ctx->memap_csw = csw;
+        ctx->memap_csw_ap = ap;
+        ctx->memap_csw_ok = true;
+    }
+    return ret;
+}
+
 static uint8_t swd_write_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_t data) {
     uint8_t ret = 0;
     uint32_t csw = 0x23000002;
 
-    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
+    ret |= swd_write_csw(ctx, ap, csw);
     ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
     ret |= swd_write_ap(ctx, ap, MEMAP_DRW, data);
     DBG("write 0x%08lX to 0x%08lX", data, address);
@@ -470,9 +499,10 @@ uint8_t swd_read_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_
     uint8_t ret = 0;
     uint32_t csw = 0x23000002;
 
-    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
+    ret |= swd_write_csw(ctx, ap, csw);
     ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
-    ret |= swd_read_ap(ctx, ap, MEMAP_DRW, data);
+    ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, data);
+    ret |= swd_read_rdbuff(ctx, data);
 
     if(ret != 1) {
         DBG("read from 0x%08lX failed", address);
@@ -483,6 +513,11 @@ uint8_t swd_read_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_
     return ret;
 }
 
+/* bytes left until TAR auto-increment would wrap */
+static uint32_t swd_tar_remaining(uint32_t address) {
+    return MEMAP_TAR_WRAP - (address & (MEMAP_TAR_WRAP - 1));
+}
+
 static uint8_t swd_read_memory_block(
     AppFSM* const ctx,
     uint8_t ap,
@@ -493,22 +528,62 @@ static uint8_t swd_read_memory_block(
     uint32_t data = 0;
     uint32_t csw = 0x23000012;
 
-    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
-    ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
-    ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, &data);
+    ret |= swd_write_csw(ctx, ap, csw);
 
-    for(size_t pos = 0; pos < len; pos += 4) {
-        data = 0xDEADBEEF;
-        ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, &data);
-        DBG("read %lX", data);
+    for(uint32_t pos = 0; pos < len && ret == 1;) {
+        uint32_t end = pos + MIN(len - pos, swd_tar_remaining(address + pos));
+
+        ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address + pos);
 
+        /* every DRW read returns the data of the previous one */
+        ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, &data);
+        for(; pos + 4 < end && ret == 1; pos += 4) {
+            ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, &data);
+            memcpy(&buf[pos], &data, 4);
+        }
+        ret |= swd_read_rdbuff(ctx, &data);
         memcpy(&buf[pos], &data, 4);
+        pos += 4;
+    }
 
-        if(ret != 1) {
-            swd_abort(ctx);
-            return ret;
+    if(ret != 1) {
+        DBG("read from 0x%08lX failed", address);
+        swd_abort(ctx);
+    }
+    return ret;
+}
+
+static uint8_t swd_write_memory_block(
+    AppFSM* const ctx,
+    uint8_t ap,
+    uint32_t address,
+    const uint8_t* buf,
+    uint32_t len) {
+    uint8_t ret = 0;
+    uint32_t data = 0;
+    uint32_t csw = 0x23000012;
+
+    ret |= swd_write_csw(ctx, ap, csw);
+
+    for(uint32_t pos = 0; pos < len && ret == 1;) {
+        uint32_t end = pos + MIN(len - pos, swd_tar_remaining(address + pos));
+
+        ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address + pos);
+        for(; pos < end && ret == 1; pos += 4) {
+            memcpy(&data, &buf[pos], 4);
+            ret |= swd_write_ap(ctx, ap, MEMAP_DRW, data);
         }
     }
+
+    /* writes are posted too, the next DP access reports whether the last one completed */
+    if(ret == 1) {
+        ret |= swd_read_rdbuff(ctx, &data);
+    }
+
+    if(ret != 1) {
+        DBG("write to 0x%08lX failed", address);
+        swd_abort(ctx);
+    }
     return ret;
 }
 
@@ -723,22 +798,23 @@ static void swd_script_log(ScriptContext* ctx, FuriLogLevel level, const char* f
     furi_string_free(buffer);
 }
 
+/* the text being parsed, either the loaded script or a command line */
+static const char* swd_script_text(ScriptContext* ctx) {
+    return ctx->script_data ? ctx->script_data : ctx->line_data;
+}
+
 /* read characters until newline was read */
 static bool swd_script_seek_newline(ScriptContext* ctx) {
+    const char* text = swd_script_text(ctx);
+
     while(true) {
-        uint8_t ch = 0;
+        char ch = text[ctx->line_pos];
 
-        if(ctx->script_file) {
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                return false;
-            }
-        } else {
-            ch = ctx->line_data[ctx->line_pos];
-            if(ch == 0) {
-                return false;
-            }
-            ctx->line_pos++;
+        if(ch == 0) {
+            return false;
         }
+        ctx->line_pos++;
+
         if(ch == '\n') {
             return true;
         }
@@ -748,83 +824,50 @@ static bool swd_script_seek_newline(ScriptContext* ctx) {
 /* read whitespaces until the next character is read. 
    returns false if EOF or newline was read */
 static bool swd_script_skip_whitespace(ScriptContext* ctx) {
-    while(true) {
-        uint8_t ch = 0;
-        uint64_t start_pos = 0;
+    const char* text = swd_script_text(ctx);
 
-        if(ctx->script_file) {
-            start_pos = storage_file_tell(ctx->script_file);
-
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                return false;
-            }
-        } else {
-            start_pos = ctx->line_pos;
-            ch = ctx->line_data[ctx->line_pos];
+    while(true) {
+        char ch = text[ctx->line_pos];
 
-            if(ch == 0) {
-                return false;
-            }
-            ctx->line_pos++;
+        if(ch == 0) {
+            return false;
         }
         if(ch == '\n') {
+            ctx->line_pos++;
             return false;
         }
         if(ch != ' ') {
-            if(ctx->script_file) {
-                storage_file_seek(ctx->script_file, start_pos, true);
-            } else {
-                ctx->line_pos = start_pos;
-            }
             return true;
         }
+        ctx->line_pos++;
     }
 }
 
 static bool swd_script_get_string(ScriptContext* ctx, char* str, size_t max_length) {
+    const char* text = swd_script_text(ctx);
     bool quot = false;
     size_t pos = 0;
 
     str[pos] = '\000';
 
     while(true) {
-        char ch = 0;
-        uint64_t start_pos = 0;
-
-        if(ctx->script_file) {
-            start_pos = storage_file_tell(ctx->script_file);
+        char ch = text[ctx->line_pos];
 
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                DBGS("end reached");
-                return false;
-            }
-        } else {
-            start_pos = ctx->line_pos;
-            ch = ctx->line_data[ctx->line_pos];
-
-            if(ch == 0) {
-                DBGS("end reached");
-                return false;
-            }
-            ctx->line_pos++;
+        if(ch == 0) {
+            DBGS("end reached");
+            return false;
         }
+        if(!quot && (ch == '\r' || ch == '\n')) {
+            break;
+        }
+        ctx->line_pos++;
 
         if(ch == '"') {
             quot = !quot;
             continue;
         }
-        if(!quot) {
-            if(ch == ' ') {
-                break;
-            }
-            if(ch == '\r' || ch == '\n') {
-                if(ctx->script_file) {
-                    storage_file_seek(ctx->script_file, start_pos, true);
-                } else {
-                    ctx->line_pos = start_pos;
-                }
-                break;
-            }
+        if(!quot && ch == ' ') {
+            break;
         }
         if(pos + 2 > max_length) {
             DBGS("too long");
@@ -906,21 +949,10 @@ static bool swd_scriptfunc_comment(ScriptContext* ctx) {
     return true;
 }
 
+/* labels are resolved when the script gets compiled */
 static bool swd_scriptfunc_label(ScriptContext* ctx) {
-    char label[256];
     DBGS("label");
 
-    swd_script_skip_whitespace(ctx);
-    if(!swd_script_get_string(ctx, label, sizeof(label))) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse label");
-        return false;
-    }
-
-    if(!strcmp(label, ctx->goto_label)) {
-        ctx->goto_active = false;
-        DBG("matches '%s'", ctx->goto_label);
-    }
-
     swd_script_seek_newline(ctx);
 
     return true;
@@ -929,18 +961,13 @@ static bool swd_scriptfunc_label(ScriptContext* ctx) {
 static bool swd_scriptfunc_goto(ScriptContext* ctx) {
     DBGS("goto");
 
-    swd_script_skip_whitespace(ctx);
-
-    if(!swd_script_get_string(ctx, ctx->goto_label, sizeof(ctx->goto_label))) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse target label");
+    if(!ctx->program) {
+        swd_script_log(ctx, FuriLogLevelError, "goto is only supported in scripts");
         return false;
     }
 
-    /* start from beginning and rerun starting from label */
-    ctx->goto_active = true;
-    ctx->restart = true;
-
-    swd_script_seek_newline(ctx);
+    /* pc already points past this goto */
+    ctx->pc = ctx->program[ctx->pc - 1].target;
 
     return true;
 }
@@ -1065,7 +1092,7 @@ static bool swd_scriptfunc_message(ScriptContext* ctx) {
     }
 
     if(wait_time <= 60 * 1000) {
-        strncpy(ctx->app->state_string, message, sizeof(ctx->app->state_string));
+        snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "%s", message);
         swd_script_gui_refresh(ctx);
         furi_delay_ms(wait_time);
         if(show_dialog) {
@@ -1170,7 +1197,8 @@ static bool swd_scriptfunc_blocksize(ScriptContext* ctx) {
     }
 
     if(block_size >= 4 && block_size <= 0x1000) {
-        ctx->block_size = block_size;
+        /* memory is accessed in words */
+        ctx->block_size = block_size & ~3;
     } else {
         swd_script_log(ctx, FuriLogLevelError, "value must be between 4 and 4096");
     }
@@ -1303,15 +1331,8 @@ static bool swd_scriptfunc_mem_dump(ScriptContext* ctx) {
                 DBGS("aborting read");
                 break;
             }
-            uint32_t ret = 0;
-
-            if(ctx->block_size > 4) {
-                ret = swd_read_memory_block(
-                    ctx->app, ctx->selected_ap, address + pos, buffer, ctx->block_size);
-            } else {
-                ret =
-                    swd_read_memory(ctx->app, ctx->selected_ap, address + pos, (uint32_t*)buffer);
-            }
+            uint32_t ret = swd_read_memory_block(
+                ctx->app, ctx->selected_ap, address + pos, buffer, ctx->block_size);
             read_ok = (ret == 1);
 
             if(!read_ok) {
@@ -1354,6 +1375,152 @@ static bool swd_scriptfunc_mem_dump(ScriptContext* ctx) {
     furi_mutex_release(ctx->app->swd_mutex);
 
     storage_file_close(dump);
+    storage_file_free(dump);
+    swd_script_seek_newline(ctx);
+    free(buffer);
+
+    return success;
+}
+
+static bool swd_scriptfunc_mem_load(ScriptContext* ctx) {
+    char filename[MAX_FILE_LENGTH];
+    uint32_t address = 0;
+    bool success = true;
+
+    /* get file */
+    if(!swd_script_skip_whitespace(ctx)) {
+        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
+        return false;
+    }
+
+    if(!swd_script_get_string(ctx, filename, sizeof(filename))) {
+        swd_script_log(ctx, FuriLogLevelError, "failed to parse filename");
+        return false;
+    }
+    /* get address */
+    if(!swd_script_get_number(ctx, &address)) {
+        swd_script_log(ctx, FuriLogLevelError, "failed to parse address");
+        return false;
+    }
+    if(address & 3) {
+        swd_script_log(ctx, FuriLogLevelError, "address must be word aligned");
+        return false;
+    }
+
+    File* image = storage_file_alloc(ctx->app->storage);
+
+    if(!storage_file_open(image, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        storage_file_free(image);
+        snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "Failed to open file");
+        swd_script_gui_refresh(ctx);
+        notification_message_block(ctx->app->notification, &seq_error);
+        return false;
+    }
+
+    if(ctx->block_size == 0) {
+        ctx->block_size = 0x100;
+    }
+    if(ctx->block_size > 0x1000) {
+        ctx->block_size = 0x1000;
+    }
+
+    uint32_t length = storage_file_size(image);
+    uint8_t* buffer = malloc(ctx->block_size);
+
+    LOG("load %s, len %08lX to %08lX", filename, length, address);
+
+    furi_mutex_acquire(ctx->app->swd_mutex, FuriWaitForever);
+
+    for(uint32_t pos = 0; pos < length; pos += ctx->block_size) {
+        int pct = pos * 100 / length;
+        snprintf(
+            ctx->app->state_string,
+            sizeof(ctx->app->state_string),
+            "Load %08lX (%d%%)",
+            pos,
+            pct);
+        swd_script_gui_refresh(ctx);
+
+        uint32_t count = storage_file_read(image, buffer, ctx->block_size);
+        if(count == 0) {
+            snprintf(
+                ctx->app->state_string, sizeof(ctx->app->state_string), "Failed to read file");
+            success = false;
+            break;
+        }
+
+        /* keep the target's bytes behind a partial last word */
+        uint32_t tail = count & 3;
+        if(tail) {
+            uint32_t data = 0;
+            bool read_ok = false;
+
+            for(uint32_t tries = 0; tries < ctx->max_tries && !ctx->abort; tries++) {
+                read_ok = swd_read_memory(
+                              ctx->app, ctx->selected_ap, address + pos + count - tail, &data) ==
+                          1;
+                if(read_ok) {
+                    break;
+                }
+                furi_delay_ms(100);
+            }
+            if(ctx->abort) {
+                DBGS("aborting");
+                break;
+            }
+            if(!read_ok) {
+                snprintf(
+                    ctx->app->state_string,
+                    sizeof(ctx->app->state_string),
+                    "Failed at 0x%08lX",
+                    address + pos + count - tail);
+                notification_message_block(ctx->app->notification, &seq_error);
+                success = false;
+                break;
+            }
+            memcpy(&buffer[count], ((uint8_t*)&data) + tail, 4 - tail);
+            count += 4 - tail;
+        }
+
+        bool write_ok = false;
+
+        for(uint32_t tries = 0; tries < ctx->max_tries; tries++) {
+            if(ctx->abort) {
+                DBGS("aborting write");
+                break;
+            }
+            uint32_t ret =
+                swd_write_memory_block(ctx->app, ctx->selected_ap, address + pos, buffer, count);
+            write_ok = (ret == 1);
+
+            if(!write_ok) {
+                snprintf(
+                    ctx->app->state_string,
+                    sizeof(ctx->app->state_string),
+                    "Failed at 0x%08lX",
+                    address + pos);
+                swd_script_gui_refresh(ctx);
+                furi_delay_ms(100);
+            } else {
+                break;
+            }
+        }
+        if(ctx->abort) {
+            DBGS("aborting");
+            break;
+        }
+
+        if(!write_ok) {
+            notification_message_block(ctx->app->notification, &seq_error);
+            success = false;
+            break;
+        }
+    }
+
+    furi_mutex_release(ctx->app->swd_mutex);
+
+    storage_file_close(image);
+    storage_file_free(image);
     swd_script_seek_newline(ctx);
     free(buffer);
 
@@ -1987,6 +2154,7 @@ static const ScriptFunctionInfo script_funcs[] = {
     {"block_size", &swd_scriptfunc_blocksize},
     {"abort", &swd_scriptfunc_abort},
     {"mem_dump", &swd_scriptfunc_mem_dump},
+    {"mem_load", &swd_scriptfunc_mem_load},
     {"mem_ldmst", &swd_scriptfunc_mem_ldmst},
     {"mem_write", &swd_scriptfunc_mem_write},
     {"mem_read", &swd_scriptfunc_mem_read},
@@ -2006,106 +2174,228 @@ static const ScriptFunctionInfo script_funcs[] = {
 
 /************************** script main code **************************/
 
-static bool swd_execute_script_line(ScriptContext* const ctx) {
-    char buffer[64];
-    uint64_t start_pos = 0;
-
-    if(ctx->script_file) {
-        start_pos = storage_file_tell(ctx->script_file);
-        uint16_t ret = storage_file_read(ctx->script_file, buffer, 2);
-        storage_file_seek(ctx->script_file, start_pos, true);
+/* index of the script function the text starts with, -1 if there is none */
+static int32_t swd_script_find_func(const char* text) {
+    for(size_t entry = 0; entry < COUNT(script_funcs); entry++) {
+        const char* prefix = script_funcs[entry].prefix;
 
-        if(ret < 2) {
-            return true;
+        if(!strncmp(text, prefix, strlen(prefix))) {
+            return entry;
         }
-    } else {
-        start_pos = ctx->line_pos;
-        strncpy(buffer, ctx->line_data, 2);
+    }
+    return -1;
+}
 
-        if(buffer[0] == 0 || buffer[1] == 0) {
-            return true;
-        }
+static bool swd_script_run_func(ScriptContext* const ctx, size_t entry) {
+    DBG("command: '%s'", script_funcs[entry].prefix);
+
+    if(!ctx->status_ignore) {
+        snprintf(
+            ctx->app->state_string,
+            sizeof(ctx->app->state_string),
+            "CMD: %s",
+            script_funcs[entry].prefix);
     }
+    swd_script_gui_refresh(ctx);
+
+    /* function, execute */
+    bool success = script_funcs[entry].func(ctx);
+
+    if(!success && !ctx->errors_ignore) {
+        swd_script_log(ctx, FuriLogLevelError, "Command failed: %s", script_funcs[entry].prefix);
+        snprintf(
+            ctx->app->state_string,
+            sizeof(ctx->app->state_string),
+            "Command failed: %s",
+            script_funcs[entry].prefix);
+        return false;
+    }
+
+    return true;
+}
 
-    if(buffer[0] == '\n' || (buffer[0] == '\r' && buffer[1] == '\n')) {
+static bool swd_execute_script_line(ScriptContext* const ctx) {
+    const char* line = &ctx->line_data[ctx->line_pos];
+
+    if(line[0] == 0 || line[0] == '\n' || (line[0] == '\r' && line[1] == '\n')) {
         swd_script_seek_newline(ctx);
         return true;
     }
 
-    for(size_t entry = 0; entry < COUNT(script_funcs); entry++) {
-        if(ctx->abort) {
-            DBGS("aborting");
+    int32_t entry = swd_script_find_func(line);
+    if(entry < 0) {
+        swd_script_log(ctx, FuriLogLevelError, "unknown command '%s'", line);
+        return false;
+    }
+    ctx->line_pos += strlen(script_funcs[entry].prefix);
+
+    return swd_script_run_func(ctx, entry);
+}
+
+/* translate the script text into a list of instructions, so commands are looked up
+   only once and goto jumps straight to its label instead of rescanning the file */
+static bool swd_script_compile(ScriptContext* const ctx, uint32_t* error_line) {
+    const char* text = ctx->script_data;
+    uint32_t lines = 0;
+    uint32_t labels = 0;
+    bool success = true;
+
+    /* size the program and the label table */
+    for(const char* start = text; *start && lines < SCRIPT_MAX_LINES; lines++) {
+        int32_t entry = swd_script_find_func(start);
+        if(entry >= 0 && script_funcs[entry].func == &swd_scriptfunc_label) {
+            labels++;
+        }
+        const char* next = strchr(start, '\n');
+        start = next ? next + 1 : start + strlen(start);
+    }
+
+    ctx->program = malloc(sizeof(ScriptInstruction) * MAX(lines, 1u));
+    ScriptLabel* label_table = malloc(sizeof(ScriptLabel) * MAX(labels, 1u));
+    labels = 0;
+
+    size_t pos = 0;
+    for(uint32_t line = 1; text[pos] && success; line++) {
+        const char* start = &text[pos];
+        const char* next = strchr(start, '\n');
+        pos = next ? (size_t)(next - text) + 1 : pos + strlen(start);
+
+        if(line > SCRIPT_MAX_LINES) {
+            swd_script_log(ctx, FuriLogLevelWarn, "ignoring lines after %d", SCRIPT_MAX_LINES);
             break;
         }
-        size_t expected = strlen(script_funcs[entry].prefix);
+        if(start[0] == '\n' || (start[0] == '\r' && start[1] == '\n')) {
+            continue;
+        }
 
-        if(ctx->script_file) {
-            storage_file_seek(ctx->script_file, start_pos, true);
+        *error_line = line;
+        int32_t entry = swd_script_find_func(start);
+        if(entry < 0) {
+            swd_script_log(ctx, FuriLogLevelError, "unknown command in line %lu", line);
+            snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "Unknown command");
+            success = false;
+            break;
+        }
+        uint32_t args = (start - text) + strlen(script_funcs[entry].prefix);
 
-            if(storage_file_read(ctx->script_file, buffer, expected) != expected) {
-                continue;
-            }
-        } else {
-            ctx->line_pos = start_pos;
+        if(script_funcs[entry].func == &swd_scriptfunc_comment) {
+            continue;
+        }
+        if(script_funcs[entry].func == &swd_scriptfunc_label) {
+            ScriptLabel* label = &label_table[labels++];
 
-            if(strlen(ctx->line_data) < expected) {
-                continue;
+            ctx->line_pos = args;
+            swd_script_skip_whitespace(ctx);
+            if(!swd_script_get_string(ctx, label->name, sizeof(label->name))) {
+                swd_script_log(ctx, FuriLogLevelError, "failed to parse label");
+                snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "Invalid label");
+                success = false;
             }
-            strncpy(buffer, ctx->line_data, expected);
-            ctx->line_pos += expected;
+            label->target = ctx->program_length;
+            continue;
         }
 
-        buffer[expected] = '\000';
-        if(strncmp(buffer, script_funcs[entry].prefix, expected)) {
+        ScriptInstruction* instruction = &ctx->program[ctx->program_length++];
+        instruction->func = entry;
+        instruction->line = line;
+        instruction->args = args;
+    }
+
+    /* resolve goto targets, now that all labels are known */
+    for(uint32_t pc = 0; pc < ctx->program_length && success; pc++) {
+        ScriptInstruction* instruction = &ctx->program[pc];
+        char name[sizeof(label_table[0].name)];
+
+        if(script_funcs[instruction->func].func != &swd_scriptfunc_goto) {
             continue;
         }
-        bool success = true;
 
-        if(ctx->goto_active) {
-            DBG("ignore: '%s'", script_funcs[entry].prefix);
+        *error_line = instruction->line;
+        ctx->line_pos = instruction->args;
+        swd_script_skip_whitespace(ctx);
+        if(!swd_script_get_string(ctx, name, sizeof(name))) {
+            swd_script_log(ctx, FuriLogLevelError, "failed to parse target label");
+            snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "Invalid label");
+            success = false;
+            break;
+        }
 
-            /* only execute label handlers */
-            if(buffer[0] == '.') {
-                success = script_funcs[entry].func(ctx);
-            } else {
-                swd_script_seek_newline(ctx);
+        success = false;
+        for(uint32_t label = 0; label < labels; label++) {
+            if(!strcmp(label_table[label].name, name)) {
+                instruction->target = label_table[label].target;
+                success = true;
+                break;
             }
-        } else {
-            DBG("command: '%s'", script_funcs[entry].prefix);
+        }
+        if(!success) {
+            swd_script_log(ctx, FuriLogLevelError, "unknown label '%s'", name);
+            snprintf(
+                ctx->app->state_string,
+                sizeof(ctx->app->state_string),
+                "Unknown label '%s'",
+                name);
+        }
+    }
 
-            if(!ctx->status_ignore) {
-                snprintf(
-                    ctx->app->state_string,
-                    sizeof(ctx->app->state_string),
-                    "CMD: %s",
-                    script_funcs[entry].prefix);
-            }
-            swd_script_gui_refresh(ctx);
+    free(label_table);
+    DBG("%lu instructions, %lu labels", ctx->program_length, labels);
 
-            /* function, execute */
-            success = script_funcs[entry].func(ctx);
+    return success;
+}
 
-            if(!success && !ctx->errors_ignore) {
-                swd_script_log(
-                    ctx, FuriLogLevelError, "Command failed: %s", script_funcs[entry].prefix);
-                snprintf(
-                    ctx->app->state_string,
-                    sizeof(ctx->app->state_string),
-                    "Command failed: %s",
-                    script_funcs[entry].prefix);
-                return false;
-            }
+/* read the whole script into memory */
+static bool swd_script_load(ScriptContext* const ctx, const char* filename) {
+    File* file = storage_file_alloc(ctx->app->storage);
+    bool success = false;
+
+    do {
+        if(!storage_file_open(file, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            FURI_LOG_E(TAG, "open, %s", storage_file_get_error_desc(file));
+            DBG("Failed to open '%s'", filename);
+            break;
         }
 
-        return true;
-    }
-    swd_script_log(ctx, FuriLogLevelError, "unknown command '%s'", buffer);
+        uint64_t size = storage_file_size(file);
+        if(size > SCRIPT_MAX_SIZE) {
+            DBG("Script '%s' too large", filename);
+            break;
+        }
+
+        ctx->script_data = malloc(size + 1);
+        if(storage_file_read(file, ctx->script_data, size) != size) {
+            DBG("Failed to read '%s'", filename);
+            break;
+        }
+        ctx->script_data[size] = '\000';
 
-    return false;
+        success = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    return success;
+}
+
+static void swd_script_failed(AppFSM* const ctx, uint32_t line, bool allow_retry) {
+    char text_buf[128];
+
+    snprintf(text_buf, sizeof(text_buf), "Line %lu failed:\n%s", line, ctx->state_string);
+    DialogMessage* message = dialog_message_alloc();
+    dialog_message_set_header(message, "SWD Probe", 16, 2, AlignLeft, AlignTop);
+    dialog_message_set_icon(message, &I_app, 3, 2);
+    dialog_message_set_text(message, text_buf, 3, 16, AlignLeft, AlignTop);
+    dialog_message_set_buttons(message, "Back", allow_retry ? "Retry" : NULL, NULL);
+    if(dialog_message_show(ctx->dialogs, message) == DialogMessageButtonCenter) {
+        ctx->script->restart = true;
+    }
+    dialog_message_free(message);
 }
 
 static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
     bool success = true;
+    uint32_t line = 0;
 
     /* fetch current script and set as parent */
     ScriptContext* parent = ctx->script;
@@ -2118,91 +2408,48 @@ static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
 
     if(!storage_file_exists(ctx->storage, filename)) {
         DBG("Does not exist '%s'", filename);
-        parent = ctx->script->parent;
-        free(ctx->script);
-        ctx->script = parent;
-        return false;
-    }
-
-    /* first allocate a file object */
-    ctx->script->script_file = storage_file_alloc(ctx->storage);
-
-    /* then get our script opened */
-    if(!storage_file_open(ctx->script->script_file, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        FURI_LOG_E(TAG, "open, %s", storage_file_get_error_desc(ctx->script->script_file));
-        DBG("Failed to open '%s'", filename);
-        storage_file_free(ctx->script->script_file);
-        parent = ctx->script->parent;
-        free(ctx->script);
-        ctx->script = parent;
-        return false;
+        success = false;
+    } else if(!swd_script_load(ctx->script, filename)) {
+        success = false;
+    } else if(!swd_script_compile(ctx->script, &line)) {
+        swd_script_failed(ctx, line, false);
+        success = false;
     }
 
-    do {
-        success = true;
+    while(success) {
         ctx->script->restart = false;
+        ctx->script->pc = 0;
 
-        storage_file_seek(ctx->script->script_file, 0, true);
-
-        uint32_t line = 1;
-        while(line < SCRIPT_MAX_LINES) {
+        while(ctx->script->pc < ctx->script->program_length) {
             if(ctx->script->abort) {
                 DBGS("Abort requested");
                 break;
             }
-            if(storage_file_eof(ctx->script->script_file)) {
-                break;
-            }
+            const ScriptInstruction* instruction = &ctx->script->program[ctx->script->pc++];
+
+            line = instruction->line;
             DBG("line %lu", line);
-            if(!swd_execute_script_line(ctx->script)) {
+
+            ctx->script->line_pos = instruction->args;
+            if(!swd_script_run_func(ctx->script, instruction->func)) {
                 success = false;
                 break;
             }
-            if(ctx->script->restart) {
-                break;
-            }
-            line++;
-        }
-
-        if(ctx->script->restart) {
-            DBGS("Restarting");
-        } else {
-            DBGS("Finished");
-        }
-
-        if(line >= SCRIPT_MAX_LINES) {
-            success = true;
-            char text_buf[128];
-
-            snprintf(text_buf, sizeof(text_buf), "aborting after %d lines", SCRIPT_MAX_LINES);
-            DialogMessage* message = dialog_message_alloc();
-            dialog_message_set_header(message, "SWD Probe", 16, 2, AlignLeft, AlignTop);
-            dialog_message_set_icon(message, &I_app, 3, 2);
-            dialog_message_set_text(message, text_buf, 3, 16, AlignLeft, AlignTop);
-            dialog_message_set_buttons(message, "Back", NULL, NULL);
-            dialog_message_free(message);
-
-            ctx->script->restart = false;
         }
+        DBGS("Finished");
 
         if(!success) {
-            char text_buf[128];
-
-            snprintf(text_buf, sizeof(text_buf), "Line %lu failed:\n%s", line, ctx->state_string);
-            DialogMessage* message = dialog_message_alloc();
-            dialog_message_set_header(message, "SWD Probe", 16, 2, AlignLeft, AlignTop);
-            dialog_message_set_icon(message, &I_app, 3, 2);
-            dialog_message_set_text(message, text_buf, 3, 16, AlignLeft, AlignTop);
-            dialog_message_set_buttons(message, "Back", "Retry", NULL);
-            if(dialog_message_show(ctx->dialogs, message) == DialogMessageButtonCenter) {
-                ctx->script->restart = true;
-            }
-            dialog_message_free(message);
+            swd_script_failed(ctx, line, true);
+        }
+        if(!ctx->script->restart) {
+            break;
         }
-    } while(ctx->script->restart);
+        DBGS("Restarting");
+        success = true;
+    }
 
-    storage_file_close(ctx->script->script_file);
-    storage_file_free(ctx->script->script_file);
+    free(ctx->script->program);
+    free(ctx->script->script_data);
 
     parent = ctx->script->parent;
     free(ctx->script);
@@ -43,6 +43,7 @@
 
 #define MAX_FILE_LENGTH 128
 #define SCRIPT_MAX_LINES 1000
+#define SCRIPT_MAX_SIZE 0x8000
 
 typedef enum {
     ModePageScan = 0,
@@ -77,6 +78,7 @@ typedef enum {
 #define REG_EVENTSTAT_BANK 0x04
 
 #define REG_SELECT 0x02
+#define REG_RDBUFF 0x03
 
 #define MEMAP_CSW 0x00
 #define MEMAP_TAR 0x04
@@ -84,6 +86,9 @@ typedef enum {
 #define AP_IDR 0xFC
 #define AP_BASE 0xF8
 
+/* TAR auto-increment is only guaranteed within a 1 KiB window */
+#define MEMAP_TAR_WRAP 0x400
+
 #define SCS_CPUID 0xE000ED00u
 #define SCS_CPACR 0xE000ED88u
 #define SCS_DHCSR 0xE000EDF0u
@@ -171,6 +176,9 @@ typedef struct {
     swd_targetid_info_t targetid_info;
     swd_dpidr_info_t dpidr_info;
     swd_dpreg_t dp_regs;
+    uint32_t memap_csw;
+    uint8_t memap_csw_ap;
+    bool memap_csw_ok;
     swd_apidr_info_t apidr_info[256];
 
     ScriptContext* script;
@@ -209,6 +217,18 @@ typedef struct {
     bool script_detected_executed;
 } AppFSM;
 
+typedef struct {
+    uint8_t func; /* index into the script function table */
+    uint16_t line; /* source line, for error reporting */
+    uint32_t args; /* offset of the arguments in the script text */
+    uint32_t target; /* goto: resolved instruction index */
+} ScriptInstruction;
+
+typedef struct {
+    char name[64];
+    uint32_t target;
+} ScriptLabel;
+
 struct sScriptContext {
     AppFSM* app;
     ScriptContext* parent;
@@ -216,12 +236,15 @@ struct sScriptContext {
 
     /* when used with string input */
     char line_data[128];
+    /* parse position within line_data or script_data */
     uint64_t line_pos;
 
-    /* when used with file input */
-    File* script_file;
+    /* when used with file input, compiled once when loaded */
+    char* script_data;
+    ScriptInstruction* program;
+    uint32_t program_length;
+    uint32_t pc;
 
-    uint64_t position;
     uint32_t selected_ap;
     uint32_t max_tries;
     uint32_t block_size;
@@ -230,8 +253,6 @@ struct sScriptContext {
     bool restart;
     bool errors_ignore;
     bool status_ignore;
-    bool goto_active;
-    char goto_label[64];
 };
 
 typedef struct {
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <gui/gui.h>
+
+static const Icon I_ButtonUp_7x4;
+static const Icon I_ButtonDown_7x4;
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <gui/gui.h>
+
+// Every dialog is answered with Back and counted in host_dialogs
+
+typedef struct DialogsApp DialogsApp;
+typedef struct DialogMessage DialogMessage;
+
+typedef enum {
+    DialogMessageButtonBack,
+    DialogMessageButtonLeft,
+    DialogMessageButtonCenter,
+    DialogMessageButtonRight,
+} DialogMessageButton;
+
+typedef struct {
+    const char* extension;
+    const Icon* icon;
+} DialogsFileBrowserOptions;
+
+extern uint32_t host_dialogs;
+
+DialogMessageButton dialog_message_show(DialogsApp* context, const DialogMessage* message);
+
+static inline DialogMessage* dialog_message_alloc(void) {
+    return NULL;
+}
+
+static inline void dialog_message_free(DialogMessage* message) {
+    UNUSED(message);
+}
+
+static inline void dialog_message_set_header(
+    DialogMessage* message,
+    const char* text,
+    int x,
+    int y,
+    Align horizontal,
+    Align vertical) {
+    UNUSED(message);
+    UNUSED(text);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(horizontal);
+    UNUSED(vertical);
+}
+
+static inline void dialog_message_set_text(
+    DialogMessage* message,
+    const char* text,
+    int x,
+    int y,
+    Align horizontal,
+    Align vertical) {
+    UNUSED(message);
+    UNUSED(text);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(horizontal);
+    UNUSED(vertical);
+}
+
+static inline void dialog_message_set_icon(DialogMessage* message, const Icon* icon, int x, int y) {
+    UNUSED(message);
+    UNUSED(icon);
+    UNUSED(x);
+    UNUSED(y);
+}
+
+static inline void dialog_message_set_buttons(
+    DialogMessage* message,
+    const char* left,
+    const char* center,
+    const char* right) {
+    UNUSED(message);
+    UNUSED(left);
+    UNUSED(center);
+    UNUSED(right);
+}
+
+static inline void dialog_file_browser_set_basic_options(
+    DialogsFileBrowserOptions* options,
+    const char* extension,
+    const Icon* icon) {
+    options->extension = extension;
+    options->icon = icon;
+}
+
+static inline bool dialog_file_browser_show(
+    DialogsApp* context,
+    FuriString* result_path,
+    FuriString* path,
+    const DialogsFileBrowserOptions* options) {
+    UNUSED(context);
+    UNUSED(result_path);
+    UNUSED(path);
+    UNUSED(options);
+    return false;
+}
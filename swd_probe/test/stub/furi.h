@@ -0,0 +1,145 @@
+#pragma once
+
+// Just enough of furi for swd_probe_app.c to build on the host, see host_furi.c
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// furi malloc never fails and returns zeroed memory, the script contexts rely on it
+#define malloc(size) calloc(1, size)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define UNUSED(x) (void)(x)
+
+#define furi_assert(x) (void)(x)
+
+// every path on the SD card lives under ext/ in the test's working directory
+#define EXT_PATH(path) "ext/" path
+
+typedef enum {
+    FuriLogLevelDefault,
+    FuriLogLevelNone,
+    FuriLogLevelError,
+    FuriLogLevelWarn,
+    FuriLogLevelInfo,
+    FuriLogLevelDebug,
+    FuriLogLevelTrace,
+} FuriLogLevel;
+
+// Errors and warnings are counted, everything is printed with SWD_SIM_LOG set
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...);
+extern uint32_t host_log_errors;
+
+#define FURI_LOG_E(tag, ...) furi_log_print_format(FuriLogLevelError, tag, __VA_ARGS__)
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_printf(const char* format, ...)
+    __attribute__((format(printf, 1, 2)));
+void furi_string_free(FuriString* string);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+void furi_string_cat_str(FuriString* string, const char* str);
+void furi_string_cat_printf(FuriString* string, const char* format, ...);
+
+#define RECORD_STORAGE "storage"
+#define RECORD_GUI "gui"
+#define RECORD_DIALOGS "dialogs"
+#define RECORD_NOTIFICATION "notification"
+
+static inline void* furi_record_open(const char* name) {
+    UNUSED(name);
+    return NULL;
+}
+
+static inline void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// The scripts run on the test's thread, there is nothing to lock against
+
+typedef struct FuriMutex FuriMutex;
+
+typedef enum {
+    FuriMutexTypeNormal,
+} FuriMutexType;
+
+static inline FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    UNUSED(type);
+    return NULL;
+}
+
+static inline void furi_mutex_free(FuriMutex* mutex) {
+    UNUSED(mutex);
+}
+
+static inline FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    UNUSED(mutex);
+    UNUSED(timeout);
+    return FuriStatusOk;
+}
+
+static inline FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    UNUSED(mutex);
+    return FuriStatusOk;
+}
+
+typedef struct FuriTimer FuriTimer;
+
+// No input events ever arrive. The scripts ask for the queue length before every command,
+// host_furi.c counts that and calls host_command_hook.
+
+typedef struct FuriMessageQueue FuriMessageQueue;
+
+extern uint32_t host_commands;
+extern void (*host_command_hook)(void);
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue);
+
+static inline FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    UNUSED(msg_count);
+    UNUSED(msg_size);
+    return NULL;
+}
+
+static inline void furi_message_queue_free(FuriMessageQueue* queue) {
+    UNUSED(queue);
+}
+
+static inline FuriStatus
+    furi_message_queue_put(FuriMessageQueue* queue, const void* msg, uint32_t timeout) {
+    UNUSED(queue);
+    UNUSED(msg);
+    UNUSED(timeout);
+    return FuriStatusOk;
+}
+
+static inline FuriStatus
+    furi_message_queue_get(FuriMessageQueue* queue, void* msg, uint32_t timeout) {
+    UNUSED(queue);
+    UNUSED(msg);
+    UNUSED(timeout);
+    return FuriStatusErrorTimeout;
+}
+
+// SWD clock delays and retry waits, counted in host_swd.c
+void furi_delay_us(uint32_t us);
+void furi_delay_ms(uint32_t ms);
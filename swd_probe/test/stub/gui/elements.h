@@ -0,0 +1,33 @@
+#pragma once
+
+#include <gui/gui.h>
+
+static inline void elements_button_left(Canvas* canvas, const char* str) {
+    UNUSED(canvas);
+    UNUSED(str);
+}
+
+static inline void elements_button_center(Canvas* canvas, const char* str) {
+    UNUSED(canvas);
+    UNUSED(str);
+}
+
+static inline void elements_button_right(Canvas* canvas, const char* str) {
+    UNUSED(canvas);
+    UNUSED(str);
+}
+
+static inline void elements_scrollbar_pos(
+    Canvas* canvas,
+    int x,
+    int y,
+    int height,
+    uint16_t pos,
+    uint16_t total) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(height);
+    UNUSED(pos);
+    UNUSED(total);
+}
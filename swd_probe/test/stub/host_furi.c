@@ -0,0 +1,181 @@
+#include <furi.h>
+#include <dialogs/dialogs.h>
+#include <storage/storage.h>
+#include <toolbox/path.h>
+
+#include "../../usb_uart.h"
+
+uint32_t host_log_errors;
+uint32_t host_commands;
+void (*host_command_hook)(void);
+uint32_t host_dialogs;
+uint32_t host_file_reads;
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    if(level == FuriLogLevelError || level == FuriLogLevelWarn) host_log_errors++;
+    if(!getenv("SWD_SIM_LOG")) return;
+
+    va_list args;
+    va_start(args, format);
+    printf("[%s] ", tag);
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue) {
+    UNUSED(queue);
+    host_commands++;
+    if(host_command_hook) host_command_hook();
+    return 0;
+}
+
+DialogMessageButton dialog_message_show(DialogsApp* context, const DialogMessage* message) {
+    UNUSED(context);
+    UNUSED(message);
+    host_dialogs++;
+    return DialogMessageButtonBack;
+}
+
+struct FuriString {
+    char* data;
+    size_t size;
+};
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = malloc(sizeof(FuriString));
+    string->data = malloc(1);
+    return string;
+}
+
+static void furi_string_vcat(FuriString* string, const char* format, va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if(length <= 0) return;
+
+    string->data = realloc(string->data, string->size + length + 1);
+    vsnprintf(string->data + string->size, length + 1, format, args);
+    string->size += length;
+}
+
+FuriString* furi_string_alloc_printf(const char* format, ...) {
+    FuriString* string = furi_string_alloc();
+    va_list args;
+    va_start(args, format);
+    furi_string_vcat(string, format, args);
+    va_end(args);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+void furi_string_cat_str(FuriString* string, const char* str) {
+    furi_string_cat_printf(string, "%s", str);
+}
+
+void furi_string_cat_printf(FuriString* string, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    furi_string_vcat(string, format, args);
+    va_end(args);
+}
+
+void path_extract_dirname(const char* path, FuriString* dirname) {
+    const char* end = strrchr(path, '/');
+    size_t length = end ? (size_t)(end - path) : strlen(path);
+
+    free(dirname->data);
+    dirname->data = malloc(length + 1);
+    memcpy(dirname->data, path, length);
+    dirname->size = length;
+}
+
+struct File {
+    FILE* file;
+};
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return malloc(sizeof(File));
+}
+
+void storage_file_free(File* file) {
+    storage_file_close(file);
+    free(file);
+}
+
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    UNUSED(open_mode);
+    if(access_mode == FSAM_READ) host_file_reads++;
+    file->file = fopen(path, access_mode == FSAM_READ ? "rb" : "wb");
+    return file->file != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(file->file) fclose(file->file);
+    file->file = NULL;
+    return true;
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    return fread(buff, 1, bytes_to_read, file->file);
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    return fwrite(buff, 1, bytes_to_write, file->file);
+}
+
+uint64_t storage_file_size(File* file) {
+    long position = ftell(file->file);
+    fseek(file->file, 0, SEEK_END);
+    long size = ftell(file->file);
+    fseek(file->file, position, SEEK_SET);
+    return size;
+}
+
+const char* storage_file_get_error_desc(File* file) {
+    UNUSED(file);
+    return "host file error";
+}
+
+bool storage_file_exists(Storage* storage, const char* path) {
+    UNUSED(storage);
+    FILE* file = fopen(path, "rb");
+    if(file) fclose(file);
+    return file != NULL;
+}
+
+// The command line over USB is not used
+
+UsbUart* usb_uart_enable(UsbUartConfig* cfg) {
+    UNUSED(cfg);
+    return NULL;
+}
+
+void usb_uart_disable(UsbUart* usb_uart) {
+    UNUSED(usb_uart);
+}
+
+bool usb_uart_tx_data(UsbUart* usb_uart, uint8_t* data, size_t length) {
+    UNUSED(usb_uart);
+    UNUSED(data);
+    UNUSED(length);
+    return true;
+}
@@ -0,0 +1,352 @@
+#include "host_swd.h"
+
+#define LINE_RESET_ONES 50
+
+#define ACK_OK 0x1
+
+#define DP_ABORT 0
+#define DP_CTRLSTAT 1
+#define DP_SELECT 2
+#define DP_RDBUFF 3
+
+#define CTRLSTAT_STICKYERR (1u << 5)
+#define CTRLSTAT_WDATAERR (1u << 7)
+#define CTRLSTAT_CDBGPWRUPREQ (1u << 28)
+#define CTRLSTAT_CSYSPWRUPREQ (1u << 30)
+
+#define AP_CSW 0x00
+#define AP_TAR 0x04
+#define AP_DRW 0x0C
+#define AP_BASE 0xF8
+#define AP_IDR 0xFC
+
+#define CSW_ADDRINC_SINGLE (1u << 4)
+#define CSW_ADDRINC_MASK (3u << 4)
+#define TAR_WRAP 0x400
+
+const GpioPin gpio_ext_pc0 = {0};
+const GpioPin gpio_ext_pc1 = {1};
+const GpioPin gpio_ext_pc3 = {2};
+const GpioPin gpio_ext_pb2 = {3};
+const GpioPin gpio_ext_pb3 = {4};
+const GpioPin gpio_ext_pa4 = {5};
+const GpioPin gpio_ext_pa6 = {6};
+const GpioPin gpio_ext_pa7 = {7};
+
+HostSwdCounters host_swd;
+void (*host_swd_transfer_hook)(void);
+
+typedef enum {
+    PhaseIdle,
+    PhaseRequest,
+    PhaseDrive, // ACK and, for reads, data and parity
+    PhaseWriteTurnaround,
+    PhaseWriteData,
+    PhaseLockout, // after a protocol error, until the next line reset
+} Phase;
+
+static struct {
+    const GpioPin* swclk;
+    const GpioPin* swdio;
+
+    // the wire
+    bool clock;
+    bool probe_drives;
+    bool probe_level;
+    bool target_drives;
+    bool target_level;
+
+    Phase phase;
+    uint32_t ones;
+    uint8_t request;
+    uint8_t count;
+    uint8_t items;
+    uint64_t shift;
+
+    // DP and AP 0
+    uint32_t ctrlstat;
+    uint32_t select;
+    uint32_t rdbuff;
+    uint32_t csw;
+    uint32_t tar;
+    uint8_t ram[HOST_SWD_RAM_SIZE];
+} target;
+
+void host_swd_init(const GpioPin* swclk, const GpioPin* swdio) {
+    memset(&target, 0, sizeof(target));
+    target.swclk = swclk;
+    target.swdio = swdio;
+    host_swd = (HostSwdCounters){0};
+}
+
+uint8_t* host_swd_ram(void) {
+    return target.ram;
+}
+
+void furi_delay_us(uint32_t us) {
+    host_swd.delay_us += us;
+}
+
+void furi_delay_ms(uint32_t ms) {
+    host_swd.delay_us += (uint64_t)ms * 1000;
+}
+
+static uint8_t* target_word(uint32_t address) {
+    if(address - HOST_SWD_RAM_BASE > HOST_SWD_RAM_SIZE - 4) {
+        host_swd.stray++;
+        return NULL;
+    }
+    return &target.ram[(address - HOST_SWD_RAM_BASE) & ~3u];
+}
+
+static void target_tar_increment(void) {
+    if((target.csw & CSW_ADDRINC_MASK) == CSW_ADDRINC_SINGLE) {
+        target.tar = (target.tar & ~(TAR_WRAP - 1)) | ((target.tar + 4) & (TAR_WRAP - 1));
+    }
+}
+
+static uint32_t target_dp_read(uint8_t a23) {
+    host_swd.dp_reads++;
+    switch(a23) {
+    case DP_ABORT: // DPIDR
+        return HOST_SWD_DPIDR;
+    case DP_CTRLSTAT:
+        if(target.select & 0xF) return 0;
+        // the power-up acknowledges follow the requests right away
+        return target.ctrlstat | ((target.ctrlstat & CTRLSTAT_CDBGPWRUPREQ) << 1) |
+               ((target.ctrlstat & CTRLSTAT_CSYSPWRUPREQ) << 1);
+    case DP_RDBUFF:
+        return target.rdbuff;
+    default: // RESEND
+        return target.rdbuff;
+    }
+}
+
+static void target_dp_write(uint8_t a23, uint32_t data) {
+    host_swd.dp_writes++;
+    switch(a23) {
+    case DP_ABORT:
+        if(data & (1 << 2)) target.ctrlstat &= ~CTRLSTAT_STICKYERR;
+        if(data & (1 << 3)) target.ctrlstat &= ~CTRLSTAT_WDATAERR;
+        break;
+    case DP_CTRLSTAT:
+        if(!(target.select & 0xF)) target.ctrlstat = data & ~(CTRLSTAT_STICKYERR | CTRLSTAT_WDATAERR);
+        break;
+    case DP_SELECT:
+        target.select = data;
+        break;
+    default:
+        break;
+    }
+}
+
+static uint8_t target_ap_register(uint8_t a23) {
+    return (((target.select >> 4) & 0xF) << 4) | (a23 << 2);
+}
+
+// posted: returns the result of the previous AP read and starts this one
+static uint32_t target_ap_read(uint8_t a23) {
+    uint32_t previous = target.rdbuff;
+    uint32_t value = 0;
+    host_swd.ap_reads++;
+
+    if((target.select >> 24) == 0) {
+        switch(target_ap_register(a23)) {
+        case AP_CSW:
+            value = target.csw;
+            break;
+        case AP_TAR:
+            value = target.tar;
+            break;
+        case AP_DRW: {
+            uint8_t* word = target_word(target.tar);
+            if(word) {
+                memcpy(&value, word, 4);
+                host_swd.mem_reads++;
+            }
+            target_tar_increment();
+            break;
+        }
+        case AP_BASE:
+            value = 0xE00FF003;
+            break;
+        case AP_IDR:
+            value = HOST_SWD_AP_IDR;
+            break;
+        default:
+            break;
+        }
+    }
+
+    target.rdbuff = value;
+    return previous;
+}
+
+static void target_ap_write(uint8_t a23, uint32_t data) {
+    host_swd.ap_writes++;
+    if((target.select >> 24) != 0) return;
+
+    switch(target_ap_register(a23)) {
+    case AP_CSW:
+        target.csw = data;
+        break;
+    case AP_TAR:
+        target.tar = data;
+        break;
+    case AP_DRW: {
+        uint8_t* word = target_word(target.tar);
+        if(word) {
+            memcpy(word, &data, 4);
+            host_swd.mem_writes++;
+        }
+        target_tar_increment();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static bool target_request_valid(uint8_t request) {
+    // start, APnDP, RnW, A[2:3], parity, stop, park
+    bool parity = __builtin_parity(request & 0x1E);
+    return (request & 0x01) && ((request >> 5) & 1) == parity && !(request & 0x40) &&
+           (request & 0x80);
+}
+
+static void target_request(void) {
+    bool ap = target.request & 0x02;
+    bool read = target.request & 0x04;
+    uint8_t a23 = (target.request >> 3) & 3;
+
+    if(!target_request_valid(target.request)) {
+        host_swd.protocol_errors++;
+        target.phase = PhaseLockout;
+        return;
+    }
+
+    host_swd.transfers++;
+    target.shift = ACK_OK;
+    target.items = 3;
+    target.count = 0;
+    target.phase = PhaseDrive;
+
+    if(read) {
+        uint32_t data = ap ? target_ap_read(a23) : target_dp_read(a23);
+        target.shift |= (uint64_t)data << 3 | (uint64_t)__builtin_parity(data) << 35;
+        target.items = 36;
+    }
+
+    if(host_swd_transfer_hook) host_swd_transfer_hook();
+}
+
+static void target_write(void) {
+    bool ap = target.request & 0x02;
+    uint8_t a23 = (target.request >> 3) & 3;
+    uint32_t data = (uint32_t)target.shift;
+
+    if(((target.shift >> 32) & 1) != (uint64_t)__builtin_parity(data)) {
+        host_swd.parity_errors++;
+        target.ctrlstat |= CTRLSTAT_WDATAERR;
+        return;
+    }
+    if(ap) {
+        target_ap_write(a23, data);
+    } else {
+        target_dp_write(a23, data);
+    }
+}
+
+// A bit the probe clocks out, or the pull-up if nobody drives the line
+static bool target_sample(void) {
+    bool bit = target.probe_drives ? target.probe_level : true;
+
+    if(target.phase == PhaseIdle || target.phase == PhaseRequest ||
+       target.phase == PhaseLockout) {
+        if(bit) {
+            if(++target.ones >= LINE_RESET_ONES) target.phase = PhaseIdle;
+            if(target.ones >= LINE_RESET_ONES) return false;
+        } else {
+            target.ones = 0;
+        }
+    }
+    return bit;
+}
+
+static void target_rising_edge(void) {
+    host_swd.cycles++;
+
+    switch(target.phase) {
+    case PhaseIdle:
+        if(target_sample()) {
+            target.request = 1;
+            target.count = 1;
+            target.phase = PhaseRequest;
+        }
+        break;
+
+    case PhaseRequest: {
+        bool bit = target_sample();
+        if(target.phase != PhaseRequest) break; // line reset
+        target.request |= bit << target.count;
+        if(++target.count == 8) target_request();
+        break;
+    }
+
+    case PhaseDrive:
+        if(target.count < target.items) {
+            target.target_drives = true;
+            target.target_level = (target.shift >> target.count) & 1;
+            target.count++;
+        } else {
+            // turnaround
+            target.target_drives = false;
+            target.count = 0;
+            target.phase = target.items == 3 ? PhaseWriteTurnaround : PhaseIdle;
+        }
+        break;
+
+    case PhaseWriteTurnaround:
+        target.shift = 0;
+        target.count = 0;
+        target.phase = PhaseWriteData;
+        break;
+
+    case PhaseWriteData:
+        target.shift |= (uint64_t)target_sample() << target.count;
+        if(++target.count == 33) {
+            target_write();
+            target.phase = PhaseIdle;
+        }
+        break;
+
+    case PhaseLockout:
+        target_sample();
+        break;
+    }
+
+    if(target.probe_drives && target.target_drives) host_swd.contention++;
+}
+
+void furi_hal_gpio_init(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed) {
+    UNUSED(pull);
+    UNUSED(speed);
+    if(gpio == target.swdio) {
+        target.probe_drives = mode == GpioModeOutputPushPull || mode == GpioModeOutputOpenDrain;
+    }
+}
+
+void furi_hal_gpio_write(const GpioPin* gpio, bool state) {
+    if(gpio == target.swclk) {
+        if(state && !target.clock) target_rising_edge();
+        target.clock = state;
+    } else if(gpio == target.swdio) {
+        target.probe_level = state;
+    }
+}
+
+bool furi_hal_gpio_read(const GpioPin* gpio) {
+    if(gpio != target.swdio) return true;
+    if(target.target_drives) return target.target_level;
+    return target.probe_drives ? target.probe_level : true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// An SWD target on the GPIO pins: a DP and an AHB MEM-AP (AP 0) with 64 KiB of RAM. The
+// target decodes the bits swd_transfer() clocks out, checks the request and data parity and
+// answers every valid request with OK.
+//
+// Clocking follows swd_transfer(): the target samples SWDIO on rising SWCLK edges while
+// the probe drives it, and puts the next ACK or data bit on the line at each rising edge
+// while it drives. A read is ACK, 32 data bits, parity and one turnaround edge; a write has
+// two edges between the ACK and the data. 50 or more ones reset the line.
+//
+// DRW reads are posted like on a real MEM-AP: each AP read returns the result of the
+// previous one and RDBUFF returns the last. TAR only auto-increments within 1 KiB, the
+// window the architecture guarantees, so a burst crossing a boundary without reloading
+// TAR wraps around.
+
+#include <furi.h>
+#include <furi_hal.h>
+
+#define HOST_SWD_DPIDR 0x2BA01477 // Cortex-M4 SW-DP
+#define HOST_SWD_AP_IDR 0x24770011 // AHB-AP
+#define HOST_SWD_RAM_BASE 0x20000000
+#define HOST_SWD_RAM_SIZE 0x10000
+
+typedef struct {
+    uint64_t cycles;
+    uint32_t transfers;
+    uint32_t dp_reads;
+    uint32_t dp_writes;
+    uint32_t ap_reads;
+    uint32_t ap_writes;
+    uint32_t mem_reads; // DRW accesses that reached the RAM
+    uint32_t mem_writes;
+    uint32_t stray; // memory accesses outside the RAM
+    uint32_t protocol_errors; // bad request parity, stop or park bit
+    uint32_t parity_errors; // bad write data parity
+    uint32_t contention; // probe and target driving SWDIO at the same time
+    uint64_t delay_us; // furi_delay_us/ms
+} HostSwdCounters;
+
+extern HostSwdCounters host_swd;
+
+void host_swd_init(const GpioPin* swclk, const GpioPin* swdio);
+uint8_t* host_swd_ram(void);
+// Called after every decoded request
+extern void (*host_swd_transfer_hook)(void);
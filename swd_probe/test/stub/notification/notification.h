@@ -0,0 +1,21 @@
+#pragma once
+
+typedef struct NotificationApp NotificationApp;
+
+typedef struct {
+    int unused;
+} NotificationMessage;
+
+typedef const NotificationMessage* NotificationSequence[];
+
+static inline void
+    notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    (void)app;
+    (void)sequence;
+}
+
+static inline void
+    notification_message_block(NotificationApp* app, const NotificationSequence* sequence) {
+    (void)app;
+    (void)sequence;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include <notification/notification.h>
+
+static const NotificationMessage message_note_c4;
+static const NotificationMessage message_note_ds4;
+static const NotificationMessage message_note_g4;
+static const NotificationMessage message_sound_off;
+static const NotificationMessage message_vibro_on;
+static const NotificationMessage message_vibro_off;
+static const NotificationMessage message_delay_10;
+static const NotificationMessage message_delay_50;
+static const NotificationMessage message_delay_100;
+static const NotificationMessage message_delay_500;
+
+static const NotificationSequence sequence_display_backlight_enforce_on = {NULL};
+static const NotificationSequence sequence_display_backlight_enforce_auto = {NULL};
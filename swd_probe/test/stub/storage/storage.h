@@ -0,0 +1,39 @@
+#pragma once
+
+// Storage API over the host file system, see host_furi.c
+
+#include <furi.h>
+
+typedef struct Storage Storage;
+typedef struct File File;
+
+typedef enum {
+    FSAM_READ = 1 << 0,
+    FSAM_WRITE = 1 << 1,
+} FS_AccessMode;
+
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+
+File* storage_file_alloc(Storage* storage);
+void storage_file_free(File* file);
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode);
+bool storage_file_close(File* file);
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read);
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write);
+uint64_t storage_file_size(File* file);
+const char* storage_file_get_error_desc(File* file);
+bool storage_file_exists(Storage* storage, const char* path);
+
+static inline void
+    storage_common_migrate(Storage* storage, const char* source, const char* dest) {
+    UNUSED(storage);
+    UNUSED(source);
+    UNUSED(dest);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <gui/gui.h>
+
+static const Icon I_app;
+static const Icon I_swd;
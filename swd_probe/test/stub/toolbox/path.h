@@ -0,0 +1,5 @@
+#pragma once
+
+#include <furi.h>
+
+void path_extract_dirname(const char* path, FuriString* dirname);
@@ -0,0 +1,285 @@
+// Runs scripts through the script engine against a simulated SWD target (stub/host_swd.c),
+// with the real swd_transfer() bit-banging the pins. Checks that:
+// - mem_dump returns the target's memory for every block size, across 1 KiB TAR windows,
+//   and reads each word exactly once: the posted DRW reads end with RDBUFF, not with an
+//   extra DRW read past the end
+// - mem_load writes the file with burst writes and keeps the target's bytes behind a
+//   partial last word
+// - a goto loop runs without reading the script again, unknown commands and labels fail
+//   before anything is sent to the target
+// and reports SWD transfers and clock cycles of the dumps and the loops, and how fast the
+// script engine runs on the host.
+//
+//   make -C swd_probe/test run
+//   SWD_SIM_LOG=1 ./swd_sim     also prints the app's log
+
+#include <sys/stat.h>
+#include <time.h>
+
+#include "../swd_probe_app.c"
+#include "host_swd.h"
+
+#define FILES "swd_sim_files/"
+#define DUMP_ADDRESS 0x20000200 // not on a 1 KiB boundary
+#define DUMP_LENGTH 0x3000
+#define LOAD_ADDRESS 0x20004104
+#define LOAD_LENGTH 5003 // ends inside a word
+#define LOOP_COMMANDS 200000
+
+extern uint32_t host_file_reads;
+
+typedef struct {
+    bool ok;
+    double seconds;
+    uint32_t commands;
+    uint32_t dialogs;
+    uint32_t file_reads;
+    HostSwdCounters swd;
+} Run;
+
+static AppFSM* app;
+static uint32_t failures;
+static uint32_t abort_after;
+static HostSwdCounters totals;
+
+static void fail(const char* what) {
+    printf("FAIL %s\n", what);
+    failures++;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void write_file(const char* path, const void* data, size_t size) {
+    FILE* file = fopen(path, "wb");
+    fwrite(data, 1, size, file);
+    fclose(file);
+}
+
+static bool read_file(const char* path, void* data, size_t size) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return false;
+    bool ok = fread(data, 1, size, file) == size && fgetc(file) == EOF;
+    fclose(file);
+    return ok;
+}
+
+// the app checks for an abort request before every instruction
+static void abort_loop(void) {
+    if(abort_after && host_commands >= abort_after && app->script) app->script->abort = true;
+}
+
+static void accumulate(const HostSwdCounters* run) {
+    totals.protocol_errors += run->protocol_errors;
+    totals.parity_errors += run->parity_errors;
+    totals.contention += run->contention;
+    totals.stray += run->stray;
+}
+
+static Run run_script(const char* name, const char* text) {
+    char path[64];
+    snprintf(path, sizeof(path), FILES "%s.swd", name);
+    write_file(path, text, strlen(text));
+
+    host_swd = (HostSwdCounters){0};
+    host_commands = 0;
+    host_dialogs = 0;
+    host_file_reads = 0;
+
+    Run run;
+    double start = seconds();
+    run.ok = swd_execute_script(app, path);
+    run.seconds = seconds() - start;
+    run.commands = host_commands;
+    run.dialogs = host_dialogs;
+    run.file_reads = host_file_reads;
+    run.swd = host_swd;
+    accumulate(&run.swd);
+    return run;
+}
+
+static const uint8_t* ram_at(uint32_t address) {
+    return host_swd_ram() + (address - HOST_SWD_RAM_BASE);
+}
+
+static void test_dump(uint32_t block_size) {
+    static uint8_t dump[DUMP_LENGTH];
+    char script[256];
+    snprintf(
+        script,
+        sizeof(script),
+        "ap_select 0\nblock_size %u\nmem_dump " FILES "dump.bin 0x%X 0x%X\n",
+        block_size,
+        DUMP_ADDRESS,
+        DUMP_LENGTH);
+
+    Run run = run_script("dump", script);
+    if(!run.ok) fail("mem_dump");
+    if(!read_file(FILES "dump.bin", dump, sizeof(dump)) ||
+       memcmp(dump, ram_at(DUMP_ADDRESS), sizeof(dump)) != 0) {
+        fail("dumped data");
+    }
+    if(run.swd.mem_reads != DUMP_LENGTH / 4) fail("words read from the target");
+
+    printf(
+        "mem_dump %5u %9u %8.2f %10llu %9.0f %9.2f\n",
+        block_size,
+        run.swd.transfers,
+        (double)run.swd.transfers / (DUMP_LENGTH / 4),
+        (unsigned long long)run.swd.cycles,
+        (double)run.swd.cycles / (DUMP_LENGTH / 1024),
+        run.seconds * 1000);
+}
+
+static void test_load(void) {
+    static uint8_t image[LOAD_LENGTH];
+    static uint8_t before[HOST_SWD_RAM_SIZE];
+    for(size_t i = 0; i < sizeof(image); i++) {
+        image[i] = rand();
+    }
+    write_file(FILES "image.bin", image, sizeof(image));
+    memcpy(before, host_swd_ram(), sizeof(before));
+
+    Run run = run_script(
+        "load", "ap_select 0\nblock_size 1024\nmem_load " FILES "image.bin 0x20004104\n");
+    if(!run.ok) fail("mem_load");
+
+    uint32_t offset = LOAD_ADDRESS - HOST_SWD_RAM_BASE;
+    if(memcmp(ram_at(LOAD_ADDRESS), image, sizeof(image)) != 0) fail("loaded data");
+    if(memcmp(host_swd_ram(), before, offset) != 0) fail("memory before the image changed");
+    if(memcmp(
+           host_swd_ram() + offset + LOAD_LENGTH,
+           before + offset + LOAD_LENGTH,
+           HOST_SWD_RAM_SIZE - offset - LOAD_LENGTH) != 0) {
+        fail("memory behind the image changed");
+    }
+    if(run.swd.mem_writes != (LOAD_LENGTH + 3) / 4) fail("words written to the target");
+
+    printf(
+        "mem_load %5u %9u %8.2f %10llu %9.0f %9.2f\n",
+        1024,
+        run.swd.transfers,
+        (double)run.swd.transfers / ((LOAD_LENGTH + 3) / 4),
+        (unsigned long long)run.swd.cycles,
+        (double)run.swd.cycles / (LOAD_LENGTH / 1024.0),
+        run.seconds * 1000);
+}
+
+static void test_loops(void) {
+    // two instructions per iteration, nothing sent to the target
+    abort_after = LOOP_COMMANDS;
+    Run run = run_script("spin", "# spin\n.label top\nerrors ignore\ngoto top\n");
+    abort_after = 0;
+    if(!run.ok) fail("spin loop");
+    if(run.file_reads != 1) fail("spin loop read the script again");
+    printf(
+        "goto loop: %u commands, %.2f M commands/s, script read %u time(s)\n",
+        run.commands,
+        run.commands / run.seconds / 1e6,
+        run.file_reads);
+
+    // a write and a read of the same word per iteration, forward and backward jumps
+    abort_after = LOOP_COMMANDS / 10;
+    run = run_script(
+        "loop",
+        "# hammer\nerrors ignore\nstatus 0\ngoto start\n.label body\n"
+        "mem_write 0x20000000 0xA05F0001\nmem_read 0x20000000\n.label start\n"
+        "ap_select 0\ngoto body\n");
+    abort_after = 0;
+    if(!run.ok) fail("memory loop");
+    if(run.file_reads != 1) fail("memory loop read the script again");
+    uint32_t word;
+    memcpy(&word, ram_at(0x20000000), 4);
+    if(word != 0xA05F0001) fail("memory loop write");
+    uint32_t iterations = run.swd.mem_writes;
+    printf(
+        "memory loop: %u iterations, %.1f transfers and %.0f cycles each, %.0f k iterations/s\n",
+        iterations,
+        (double)run.swd.transfers / iterations,
+        (double)run.swd.cycles / iterations,
+        iterations / run.seconds / 1e3);
+}
+
+static void test_scripts(void) {
+    Run run = run_script("badlabel", "ap_select 0\ngoto nowhere\n");
+    if(run.ok || run.swd.transfers || run.dialogs != 1) fail("unknown label");
+
+    run = run_script("badcmd", "ap_select 0\nfoo 1\n");
+    if(run.ok || run.swd.transfers || run.dialogs != 1) fail("unknown command");
+
+    run = run_script("empty", "");
+    if(!run.ok || run.swd.transfers) fail("empty script");
+
+    run = run_script(
+        "crlf",
+        "ap_select 0\r\nmem_write 0x20000010 0x12345678\r\n\r\n# c\r\nmem_read 0x20000010\r\n");
+    uint32_t word;
+    memcpy(&word, ram_at(0x20000010), 4);
+    if(!run.ok || word != 0x12345678) fail("CRLF script");
+
+    write_file(FILES "sub.swd", "mem_write 0x20000020 0xCAFEBABE\n", 32);
+    run = run_script("call", "ap_select 0\ncall sub\nmem_read 0x20000020\n");
+    memcpy(&word, ram_at(0x20000020), 4);
+    if(!run.ok || word != 0xCAFEBABE) fail("call");
+
+    printf("unknown label and command, empty, CRLF and call scripts checked\n");
+}
+
+int main(void) {
+    mkdir(FILES, 0755);
+    srand(1);
+
+    app = malloc(sizeof(AppFSM));
+    app_init(app);
+    // as after a scan found the SWD pins: SWCLK on PC0, SWDIO on PC1
+    app->mode_page = ModePageScript;
+    app->io_num_swc = 0;
+    app->io_num_swd = 1;
+    host_swd_init(gpios[app->io_num_swc], gpios[app->io_num_swd]);
+    host_command_hook = abort_loop;
+
+    uint8_t* ram = host_swd_ram();
+    for(size_t i = 0; i < HOST_SWD_RAM_SIZE; i++) {
+        ram[i] = rand();
+    }
+
+    printf(
+        "%-8s %5s %9s %8s %10s %9s %9s\n",
+        "",
+        "block",
+        "transfers",
+        "per word",
+        "cycles",
+        "per KiB",
+        "host ms");
+    test_dump(4);
+    test_dump(256);
+    test_dump(1024);
+    test_dump(4096);
+    test_load();
+    test_loops();
+    test_scripts();
+
+    if(totals.protocol_errors || totals.parity_errors || totals.contention || totals.stray) {
+        printf(
+            "protocol errors %u, parity errors %u, contention %u, stray accesses %u\n",
+            totals.protocol_errors,
+            totals.parity_errors,
+            totals.contention,
+            totals.stray);
+        fail("SWD protocol");
+    }
+
+    free(app);
+
+    if(failures) {
+        printf("FAILED: %u checks\n", failures);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -13,6 +13,11 @@
 #define STATE_FILE_VERSION 2
 #define TAMA_SAVE_PATH APP_DATA_PATH("save.bin")
 
+#define TAMA_TICK_FREQUENCY 32768 // CPU ticks per second
+// Longest catch-up after loading a state, keeps the tick count within 32 bits (~36 hours)
+#define TAMA_FAST_FORWARD_MAX_S (UINT32_MAX / TAMA_TICK_FREQUENCY)
+#define TAMA_FAST_FORWARD_BATCH 1024 // steps run between two stop checks while catching up
+
 typedef struct {
     FuriThread* thread;
     hal_t hal;
@@ -1,5 +1,6 @@
 #include <furi.h>
 #include <furi_hal_bus.h>
+#include <furi_hal_rtc.h>
 #include <gui/gui.h>
 #include <input/input.h>
 #include <storage/storage.h>
@@ -472,10 +473,11 @@ static void tama_p1_update_timer_callback(FuriMessageQueue* event_queue) {
     furi_message_queue_put(event_queue, &event, 0);
 }
 
-static void tama_p1_load_state() {
+static bool tama_p1_load_state() {
     state_t* state;
     uint8_t buf[4];
     bool error = false;
+    bool loaded = false;
     state = tamalib_get_state();
 
     Storage* storage = furi_record_open(RECORD_STORAGE);
@@ -570,12 +572,27 @@ static void tama_p1_load_state() {
             }
             FURI_LOG_D(TAG, "Refreshing Hardware");
             tamalib_refresh_hw();
+            loaded = true;
         }
     }
 
     storage_file_close(file);
     storage_file_free(file);
     furi_record_close(RECORD_STORAGE);
+    return loaded;
+}
+
+// CPU ticks elapsed since the state was saved, the save file is written on exit so its
+// modification time is when the emulation stopped
+static uint32_t tama_p1_missed_ticks() {
+    uint32_t saved_at = 0;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool found = storage_common_timestamp(storage, TAMA_SAVE_PATH, &saved_at) == FSE_OK;
+    furi_record_close(RECORD_STORAGE);
+
+    uint32_t now = furi_hal_rtc_get_timestamp();
+    if(!found || now <= saved_at) return 0;
+    return MIN(now - saved_at, TAMA_FAST_FORWARD_MAX_S) * TAMA_TICK_FREQUENCY;
 }
 
 static void tama_p1_save_state() {
@@ -697,11 +714,20 @@ static int32_t tama_p1_worker(void* context) {
     cpu_sync_ref_timestamp();
     LL_TIM_EnableCounter(TIM2);
 
-    tama_p1_load_state();
+    if(tama_p1_load_state()) {
+        tamalib_fast_forward(tama_p1_missed_ticks());
+    }
 
     while(running) {
         if(furi_thread_flags_get()) {
             running = false;
+        } else if(!g_ctx->fast_forward_done) {
+            // Catching up, only poll the flags once per batch
+            for(uint32_t i = 0; i < TAMA_FAST_FORWARD_BATCH && tamalib_get_fast_forward() > 0;
+                i++) {
+                tamalib_step();
+            }
+            g_ctx->fast_forward_done = tamalib_get_fast_forward() == 0;
         } else {
             // FURI_LOG_D(TAG, "Stepping"); // enabling this cause blank screen somehow
             // for (int i = 0; i < 100; ++i)
@@ -770,9 +796,6 @@ static void tama_p1_init(TamaApp* const ctx) {
         tamalib_init((u12_t*)ctx->rom, NULL, 64000);
         tamalib_set_speed(speed);
 
-        // TODO: implement fast forwarding
-        // ctx->fast_forward_done = true;
-
         // Start stepping thread
         ctx->thread = furi_thread_alloc();
         furi_thread_set_name(ctx->thread, "TamaLIB");
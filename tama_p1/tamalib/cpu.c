@@ -116,6 +116,9 @@
 
 #define INPUT_PORT_NUM 2
 
+#define OP_LUT_SIZE 0x1000 // One entry for each 12-bit op-code
+#define OP_UNKNOWN 0xFF
+
 typedef struct {
     char* log;
     u12_t code;
@@ -170,6 +173,12 @@ static u32_t ts_freq;
 static u8_t speed_ratio = 1;
 static timestamp_t ref_ts;
 
+/* Ticks left to run without waiting (see cpu_fast_forward()) */
+static u32_t fast_forward_ticks = 0;
+
+/* Op-code -> index in ops[] (or OP_UNKNOWN), built by cpu_init() */
+static u8_t op_lut[OP_LUT_SIZE];
+
 static state_t cpu_state = {
     .pc = &pc,
     .x = &x,
@@ -231,6 +240,14 @@ void cpu_set_speed(u8_t speed) {
     speed_ratio = speed;
 }
 
+void cpu_fast_forward(u32_t ticks) {
+    fast_forward_ticks = ticks;
+}
+
+u32_t cpu_get_fast_forward(void) {
+    return fast_forward_ticks;
+}
+
 state_t* cpu_get_state(void) {
     return &cpu_state;
 }
@@ -1822,6 +1839,18 @@ static timestamp_t wait_for_cycles(timestamp_t since, u8_t cycles) {
 
     tick_counter += cycles;
 
+    if(fast_forward_ticks > 0) {
+        /* Catching up: do not wait, the timers only depend on tick_counter */
+        fast_forward_ticks = (cycles < fast_forward_ticks) ? fast_forward_ticks - cycles : 0;
+
+        if(fast_forward_ticks == 0) {
+            /* Back to real time from now on */
+            return g_hal->get_timestamp();
+        }
+
+        return since;
+    }
+
     if(speed_ratio == 0) {
         /* Emulation will be as fast as possible */
         return g_hal->get_timestamp();
@@ -1928,7 +1957,26 @@ void cpu_reset(void) {
     cpu_sync_ref_timestamp();
 }
 
+static void build_op_lut(void) {
+    u12_t op;
+    u8_t i;
+
+    /* The first matching entry of ops[] wins, like a linear lookup would do */
+    for(op = 0; op < OP_LUT_SIZE; op++) {
+        op_lut[op] = OP_UNKNOWN;
+
+        for(i = 0; ops[i].log != NULL; i++) {
+            if((op & ops[i].mask) == ops[i].code) {
+                op_lut[op] = i;
+                break;
+            }
+        }
+    }
+}
+
 bool_t cpu_init(const u12_t* program, breakpoint_t* breakpoints, u32_t freq) {
+    build_op_lut();
+
     g_program = program;
     g_breakpoints = breakpoints;
     ts_freq = freq;
@@ -1950,13 +1998,9 @@ int cpu_step(void) {
     op = g_program[pc];
 
     /* Lookup the OP code */
-    for(i = 0; ops[i].log != NULL; i++) {
-        if((op & ops[i].mask) == ops[i].code) {
-            break;
-        }
-    }
+    i = op_lut[op & (OP_LUT_SIZE - 1)];
 
-    if(ops[i].log == NULL) {
+    if(i == OP_UNKNOWN) {
         g_hal->log(LOG_ERROR, "Unknown op-code 0x%X (pc = 0x%04X)\n", op, pc);
         return 1;
     }
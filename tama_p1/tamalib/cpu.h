@@ -195,6 +195,9 @@ void cpu_free_bp(breakpoint_t** list);
 
 void cpu_set_speed(u8_t speed);
 
+void cpu_fast_forward(u32_t ticks);
+u32_t cpu_get_fast_forward(void);
+
 state_t* cpu_get_state(void);
 
 u32_t cpu_get_depth(void);
@@ -24,6 +24,8 @@
 
 #define DEFAULT_FRAMERATE 30 // fps
 
+#define FAST_FORWARD_BATCH 1024 // instructions run between two handler calls
+
 static exec_mode_t exec_mode = EXEC_MODE_RUN;
 
 static u32_t step_depth = 0;
@@ -114,9 +116,15 @@ void tamalib_step(void) {
 
 void tamalib_mainloop(void) {
     timestamp_t ts;
+    u32_t n;
 
     while(!g_hal->handler()) {
-        tamalib_step();
+        /* While fast-forwarding, run a whole batch before polling the HAL */
+        n = 0;
+        do {
+            tamalib_step();
+        } while(cpu_get_fast_forward() > 0 && exec_mode != EXEC_MODE_PAUSE &&
+                ++n < FAST_FORWARD_BATCH);
 
         /* Update the screen @ g_framerate fps */
         ts = g_hal->get_timestamp();
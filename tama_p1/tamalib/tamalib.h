@@ -28,6 +28,12 @@
 
 #define tamalib_set_speed(speed) cpu_set_speed(speed)
 
+/* Run the given amount of CPU ticks without waiting (e.g. to catch up after
+ * restoring a state or a long pause), timers stay cycle-accurate.
+ */
+#define tamalib_fast_forward(ticks) cpu_fast_forward(ticks)
+#define tamalib_get_fast_forward() cpu_get_fast_forward()
+
 #define tamalib_get_state() cpu_get_state()
 #define tamalib_refresh_hw() cpu_refresh_hw()
 
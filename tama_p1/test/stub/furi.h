@@ -0,0 +1,8 @@
+#pragma once
+
+// Just enough of furi.h for hal_types.h and tamalib on the host
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UNUSED(x) (void)(x)
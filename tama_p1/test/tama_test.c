@@ -0,0 +1,208 @@
+// Runs the ROM for a few emulated minutes with plain stepping and with
+// tamalib_fast_forward(), checks that both end in the state the original
+// TamaLIB decoder reached and measures the emulation speed.
+//
+//   make -C tama_p1/test run
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../tamalib/tamalib.h"
+
+#define ROM_PATH "../files/rom.bin"
+#define ROM_SIZE_MAX 16384
+#define TICK_FREQUENCY 32768
+#define RUN_SECONDS 600
+#define BUTTON_PERIOD 50000 // steps between middle button presses and releases
+
+// State hash after RUN_SECONDS, recorded with the original op-code search
+#define EXPECTED_HASH 0xB7F88BE7
+
+typedef struct {
+    uint64_t steps;
+    uint32_t hash;
+    uint32_t fast_forward_left;
+    double seconds;
+} RunResult;
+
+static timestamp_t now;
+static uint32_t lcd_hash;
+
+static void* hal_malloc(u32_t size) {
+    return malloc(size);
+}
+
+static void hal_free(void* ptr) {
+    free(ptr);
+}
+
+static void hal_halt(void) {
+}
+
+static bool_t hal_is_log_enabled(log_level_t level) {
+    (void)level;
+    return 0;
+}
+
+static void hal_log(log_level_t level, char* buff, ...) {
+    (void)level;
+    (void)buff;
+}
+
+// the clock never moves, only fast-forward or speed 0 get anywhere
+static void hal_sleep_until(timestamp_t ts) {
+    now = ts;
+}
+
+static timestamp_t hal_get_timestamp(void) {
+    return now;
+}
+
+static void hal_update_screen(void) {
+}
+
+static void hal_set_lcd_matrix(u8_t x, u8_t y, bool_t val) {
+    lcd_hash = lcd_hash * 31 + (x * 33 + y) * 2 + val;
+}
+
+static void hal_set_lcd_icon(u8_t icon, bool_t val) {
+    lcd_hash = lcd_hash * 31 + icon * 2 + val;
+}
+
+static void hal_set_frequency(u32_t freq) {
+    (void)freq;
+}
+
+static void hal_play_frequency(bool_t en) {
+    (void)en;
+}
+
+static int hal_handler(void) {
+    return 0;
+}
+
+static hal_t hal = {
+    .malloc = hal_malloc,
+    .free = hal_free,
+    .halt = hal_halt,
+    .is_log_enabled = hal_is_log_enabled,
+    .log = hal_log,
+    .sleep_until = hal_sleep_until,
+    .get_timestamp = hal_get_timestamp,
+    .update_screen = hal_update_screen,
+    .set_lcd_matrix = hal_set_lcd_matrix,
+    .set_lcd_icon = hal_set_lcd_icon,
+    .set_frequency = hal_set_frequency,
+    .play_frequency = hal_play_frequency,
+    .handler = hal_handler,
+};
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static uint32_t state_hash(void) {
+    state_t* state = tamalib_get_state();
+    uint32_t hash = 2166136261u;
+    const uint8_t* memory = (const uint8_t*)state->memory;
+    for(size_t i = 0; i < MEM_BUFFER_SIZE * sizeof(MEM_BUFFER_TYPE); i++) {
+        hash = (hash ^ memory[i]) * 16777619u;
+    }
+    hash ^= *state->pc * 7 ^ *state->x * 11 ^ *state->y * 13 ^ *state->a * 17 ^ *state->b * 19 ^
+            *state->sp * 23 ^ *state->flags * 29;
+    return hash ^ *state->tick_counter ^ lcd_hash;
+}
+
+static RunResult run(const u12_t* rom, bool fast_forward) {
+    const u32_t ticks = (u32_t)RUN_SECONDS * TICK_FREQUENCY;
+    RunResult result = {0};
+
+    tamalib_register_hal(&hal);
+    tamalib_init(rom, NULL, TICK_FREQUENCY);
+    if(fast_forward) {
+        tamalib_set_speed(1);
+        tamalib_fast_forward(ticks);
+    } else {
+        tamalib_set_speed(0);
+    }
+
+    state_t* state = tamalib_get_state();
+    double start = time_s();
+    while(*state->tick_counter < ticks) {
+        tamalib_step();
+        result.steps++;
+        if(result.steps % BUTTON_PERIOD == 0) {
+            bool pressed = (result.steps / BUTTON_PERIOD) & 1;
+            tamalib_set_button(BTN_MIDDLE, pressed ? BTN_STATE_PRESSED : BTN_STATE_RELEASED);
+        }
+    }
+    result.seconds = time_s() - start;
+    result.hash = state_hash();
+    result.fast_forward_left = tamalib_get_fast_forward();
+    return result;
+}
+
+// TamaLIB keeps its state in globals, every run gets a fresh process
+static bool run_isolated(const u12_t* rom, bool fast_forward, RunResult* result) {
+    int fds[2];
+    if(pipe(fds)) return false;
+
+    pid_t pid = fork();
+    if(pid == 0) {
+        RunResult child = run(rom, fast_forward);
+        _exit(write(fds[1], &child, sizeof(child)) == sizeof(child) ? 0 : 1);
+    }
+    close(fds[1]);
+    bool ok = pid > 0 && read(fds[0], result, sizeof(*result)) == sizeof(*result);
+    close(fds[0]);
+    int status;
+    if(pid > 0) waitpid(pid, &status, 0);
+    return ok;
+}
+
+int main(void) {
+    static uint8_t rom[ROM_SIZE_MAX];
+    FILE* file = fopen(ROM_PATH, "rb");
+    if(!file) {
+        perror(ROM_PATH);
+        return EXIT_FAILURE;
+    }
+    size_t size = fread(rom, 1, sizeof(rom), file);
+    fclose(file);
+
+    // same conversion as tama_p1.c
+    for(size_t i = 0; i + 1 < size; i += 2) {
+        uint8_t b = rom[i];
+        rom[i] = rom[i + 1];
+        rom[i + 1] = b & 0xF;
+    }
+
+    int failed = 0;
+    for(int fast_forward = 0; fast_forward < 2; fast_forward++) {
+        RunResult result;
+        if(!run_isolated((const u12_t*)rom, fast_forward, &result)) {
+            printf("run failed\n");
+            return EXIT_FAILURE;
+        }
+
+        bool ok = result.hash == EXPECTED_HASH && result.fast_forward_left == 0;
+        failed += !ok;
+        printf(
+            "%-12s %u s: %8lu steps, hash %08X %s %6.1f Msteps/s, %5.0fx realtime\n",
+            fast_forward ? "fast-forward" : "step",
+            RUN_SECONDS,
+            (unsigned long)result.steps,
+            result.hash,
+            ok ? "ok  " : "FAIL",
+            result.steps / result.seconds / 1e6,
+            RUN_SECONDS / result.seconds);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -14,7 +14,6 @@
 #include "../crypto/constants.h"
 #include "migrations/common_migration.h"
 
-#define CONFIG_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf"
 #define CONFIG_FILE_BACKUP_DIR CONFIG_FILE_DIRECTORY_PATH "/backups"
 #define CONFIG_FILE_BACKUP_BASE_PATH CONFIG_FILE_BACKUP_DIR "/totp.conf"
 
@@ -599,8 +598,8 @@ bool totp_config_file_update_crypto_signatures(const PluginState* plugin_state)
 
 void totp_config_file_close(PluginState* const plugin_state) {
     if(plugin_state->config_file_context == NULL) return;
-    totp_token_info_iterator_free(plugin_state->config_file_context->token_info_iterator_context);
     totp_close_config_file(plugin_state->config_file_context->config_file);
+    totp_token_info_iterator_free(plugin_state->config_file_context->token_info_iterator_context);
     free(plugin_state->config_file_context);
     plugin_state->config_file_context = NULL;
     totp_close_storage();
@@ -7,19 +7,51 @@
 #include "../../types/crypto_settings.h"
 
 #define CONFIG_FILE_PART_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.part"
+#define CONFIG_FILE_INDEX_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.idx"
 #define STREAM_COPY_BUFFER_SIZE (128)
+#define TOKEN_INDEX_FILE_MAGIC (0x58444954) // "TIDX"
+#define TOKEN_INDEX_FILE_VERSION (1)
+#define TOKEN_INDEX_MIN_CAPACITY (16)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t config_size;
+    uint32_t config_timestamp;
+    uint32_t generation;
+    uint32_t count;
+} TokenIndexFileHeader;
 
 struct TokenInfoIteratorContext {
     size_t total_count;
     size_t current_index;
     size_t last_seek_offset;
-    size_t last_seek_index;
+    uint32_t* token_offsets;
+    size_t token_offsets_capacity;
+    size_t indexed_stream_size;
+    uint32_t generation;
+    bool index_dirty;
     TokenInfo* current_token;
     FlipperFormat* config_file;
     CryptoSettings* crypto_settings;
     Storage* storage;
 };
 
+static bool stream_is_at_token_start(Stream* stream) {
+    char buffer[sizeof(TOTP_CONFIG_KEY_TOKEN_NAME) + 1];
+    size_t buffer_read_size;
+    if((buffer_read_size = stream_read(stream, (uint8_t*)&buffer[0], sizeof(buffer))) == 0) {
+        return false;
+    }
+
+    if(!stream_seek(stream, -(int32_t)buffer_read_size, StreamOffsetFromCurrent)) {
+        return false;
+    }
+
+    return buffer_read_size == sizeof(buffer) &&
+           strncmp(buffer, "\n" TOTP_CONFIG_KEY_TOKEN_NAME ":", sizeof(buffer)) == 0;
+}
+
 static bool
     flipper_format_seek_to_siblinig_token_start(Stream* stream, StreamDirection direction) {
     char buffer[sizeof(TOTP_CONFIG_KEY_TOKEN_NAME) + 1];
@@ -46,6 +78,172 @@ static bool
     return found;
 }
 
+static bool token_index_reserve(TokenInfoIteratorContext* context, size_t count) {
+    if(count <= context->token_offsets_capacity) {
+        return true;
+    }
+
+    size_t capacity = MAX(
+        MAX(count, context->token_offsets_capacity * 2), (size_t)TOKEN_INDEX_MIN_CAPACITY);
+    uint32_t* token_offsets = realloc(context->token_offsets, capacity * sizeof(uint32_t));
+    if(token_offsets == NULL) {
+        return false;
+    }
+
+    context->token_offsets = token_offsets;
+    context->token_offsets_capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Scans the whole config file and records the offset of every token
+ * @param context token info iterator context
+ * @return \c true if index has been built; \c false otherwise
+ */
+static bool token_index_rebuild(TokenInfoIteratorContext* context) {
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    context->indexed_stream_size = 0;
+    if(!stream_rewind(stream)) {
+        return false;
+    }
+
+    size_t count = 0;
+    while(flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward)) {
+        if(!token_index_reserve(context, count + 1)) {
+            return false;
+        }
+
+        context->token_offsets[count] = stream_tell(stream);
+        count++;
+    }
+
+    context->total_count = count;
+    context->indexed_stream_size = stream_size(stream);
+    return true;
+}
+
+/**
+ * @brief Loads token index from the sidecar file if it matches current config file
+ * @param context token info iterator context
+ * @param config_timestamp config file modification timestamp
+ * @return \c true if index has been loaded; \c false otherwise
+ */
+static bool token_index_load(TokenInfoIteratorContext* context, uint32_t config_timestamp) {
+    size_t config_size = stream_size(flipper_format_get_raw_stream(context->config_file));
+    Stream* index_stream = file_stream_alloc(context->storage);
+    bool result = false;
+    do {
+        if(!file_stream_open(
+               index_stream, CONFIG_FILE_INDEX_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+
+        TokenIndexFileHeader header;
+        if(stream_read(index_stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+            break;
+        }
+
+        if(header.magic != TOKEN_INDEX_FILE_MAGIC || header.version != TOKEN_INDEX_FILE_VERSION) {
+            break;
+        }
+
+        // Even a stale index tells which generation the config file is coming from
+        context->generation = header.generation;
+        if(header.config_size != config_size || header.config_timestamp != config_timestamp) {
+            break;
+        }
+
+        if(!token_index_reserve(context, header.count)) {
+            break;
+        }
+
+        size_t offsets_size = header.count * sizeof(uint32_t);
+        if(stream_read(index_stream, (uint8_t*)context->token_offsets, offsets_size) !=
+           offsets_size) {
+            break;
+        }
+
+        bool offsets_valid = true;
+        for(size_t i = 0; i < header.count && offsets_valid; i++) {
+            offsets_valid = context->token_offsets[i] < config_size &&
+                            (i == 0 || context->token_offsets[i] > context->token_offsets[i - 1]);
+        }
+
+        if(!offsets_valid) {
+            break;
+        }
+
+        context->total_count = header.count;
+        context->indexed_stream_size = config_size;
+        result = true;
+    } while(false);
+
+    stream_free(index_stream);
+    return result;
+}
+
+/**
+ * @brief Saves token index to the sidecar file
+ * @param context token info iterator context
+ * @param config_timestamp config file modification timestamp
+ */
+static void token_index_save(const TokenInfoIteratorContext* context, uint32_t config_timestamp) {
+    Stream* index_stream = file_stream_alloc(context->storage);
+    bool result = false;
+    do {
+        if(!file_stream_open(
+               index_stream, CONFIG_FILE_INDEX_FILE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            break;
+        }
+
+        TokenIndexFileHeader header = {
+            .magic = TOKEN_INDEX_FILE_MAGIC,
+            .version = TOKEN_INDEX_FILE_VERSION,
+            .config_size = context->indexed_stream_size,
+            .config_timestamp = config_timestamp,
+            .generation = context->generation,
+            .count = context->total_count};
+        if(stream_write(index_stream, (const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+            break;
+        }
+
+        size_t offsets_size = context->total_count * sizeof(uint32_t);
+        if(offsets_size > 0 &&
+           stream_write(index_stream, (const uint8_t*)context->token_offsets, offsets_size) !=
+               offsets_size) {
+            break;
+        }
+
+        result = true;
+    } while(false);
+
+    stream_free(index_stream);
+    if(!result) {
+        storage_common_remove(context->storage, CONFIG_FILE_INDEX_FILE_PATH);
+    }
+}
+
+/**
+ * @brief Rebuilds and saves token index after config file has been changed by the iterator
+ * @param context token info iterator context
+ */
+static void token_index_update(TokenInfoIteratorContext* context) {
+    context->generation++;
+    if(!token_index_rebuild(context)) {
+        FURI_LOG_W(LOGGING_TAG, "Unable to rebuild token index");
+        return;
+    }
+
+    uint32_t config_timestamp;
+    if(storage_common_timestamp(context->storage, CONFIG_FILE_PATH, &config_timestamp) ==
+       FSE_OK) {
+        token_index_save(context, config_timestamp);
+    }
+
+    // Modification time may only settle once the config file is closed, it is saved once more then
+    context->index_dirty = true;
+}
+
 static bool seek_to_token(size_t token_index, TokenInfoIteratorContext* context) {
     furi_check(context != NULL && context->config_file != NULL);
     if(token_index >= context->total_count) {
@@ -53,47 +251,25 @@ static bool seek_to_token(size_t token_index, TokenInfoIteratorContext* context)
     }
 
     Stream* stream = flipper_format_get_raw_stream(context->config_file);
-    long token_index_diff = (long)token_index - (long)context->last_seek_index;
-    size_t token_index_diff_weight = (size_t)labs(token_index_diff);
-    StreamDirection direction = token_index_diff >= 0 ? StreamDirectionForward :
-                                                        StreamDirectionBackward;
-    if(token_index_diff_weight > token_index || context->last_seek_offset == 0) {
-        context->last_seek_offset = 0;
-        context->last_seek_index = 0;
-        token_index_diff = token_index + 1;
-        direction = StreamDirectionForward;
-    } else if(token_index_diff_weight > (context->total_count - token_index - 1)) {
-        context->last_seek_offset = stream_size(stream);
-        context->last_seek_index = context->total_count - 1;
-        token_index_diff = -(long)(context->total_count - token_index);
-        direction = StreamDirectionBackward;
-    }
-
-    if(!stream_seek(stream, context->last_seek_offset, StreamOffsetFromStart)) {
+
+    // Config file has been changed (e.g. its header got updated), index is outdated
+    if(context->indexed_stream_size != stream_size(stream) &&
+       (!token_index_rebuild(context) || token_index >= context->total_count)) {
         return false;
     }
 
-    if(token_index_diff != 0) {
-        long i = 0;
-        long i_inc = token_index_diff >= 0 ? 1 : -1;
-        do {
-            if(!flipper_format_seek_to_siblinig_token_start(stream, direction)) {
-                break;
-            }
-
-            i += i_inc;
-        } while((i_inc > 0 && i < token_index_diff) || (i_inc < 0 && i > token_index_diff));
-
-        if((i_inc > 0 && i < token_index_diff) || (i_inc < 0 && i > token_index_diff)) {
-            context->last_seek_offset = 0;
-            FURI_LOG_D(LOGGING_TAG, "Was not able to move");
+    if(!stream_seek(stream, context->token_offsets[token_index], StreamOffsetFromStart) ||
+       !stream_is_at_token_start(stream)) {
+        // Config file has been changed without changing its size, try once again with fresh index
+        FURI_LOG_D(LOGGING_TAG, "Token index is outdated");
+        if(!token_index_rebuild(context) || token_index >= context->total_count ||
+           !stream_seek(stream, context->token_offsets[token_index], StreamOffsetFromStart) ||
+           !stream_is_at_token_start(stream)) {
             return false;
         }
-
-        context->last_seek_offset = stream_tell(stream);
-        context->last_seek_index = token_index;
     }
 
+    context->last_seek_offset = context->token_offsets[token_index];
     return true;
 }
 
@@ -244,9 +420,10 @@ static bool
     flipper_format_free(temp_ff);
     storage_common_remove(context->storage, CONFIG_FILE_PART_FILE_PATH);
 
+    token_index_update(context);
+
     stream_seek(stream, offset_start, StreamOffsetFromStart);
     context->last_seek_offset = offset_start;
-    context->last_seek_index = context->current_index;
 
     return result;
 }
@@ -255,31 +432,58 @@ TokenInfoIteratorContext* totp_token_info_iterator_alloc(
     Storage* storage,
     FlipperFormat* config_file,
     CryptoSettings* crypto_settings) {
-    Stream* stream = flipper_format_get_raw_stream(config_file);
-    stream_rewind(stream);
-    size_t tokens_count = 0;
-    while(true) {
-        if(!flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward)) {
-            break;
-        }
-
-        tokens_count++;
-    }
-
     TokenInfoIteratorContext* context = malloc(sizeof(TokenInfoIteratorContext));
     furi_check(context != NULL);
 
-    context->total_count = tokens_count;
+    context->token_offsets = NULL;
+    context->token_offsets_capacity = 0;
+    context->generation = 0;
+    context->index_dirty = false;
     context->current_token = token_info_alloc();
     context->config_file = config_file;
     context->crypto_settings = crypto_settings;
     context->storage = storage;
+
+    uint32_t config_timestamp;
+    bool has_timestamp =
+        storage_common_timestamp(storage, CONFIG_FILE_PATH, &config_timestamp) == FSE_OK;
+    if(!has_timestamp || !token_index_load(context, config_timestamp)) {
+        // Config file is new or has been changed outside of the iterator
+        context->generation++;
+        if(!token_index_rebuild(context)) {
+            context->total_count = 0;
+        } else if(has_timestamp) {
+            token_index_save(context, config_timestamp);
+        }
+    }
+
+    FURI_LOG_D(
+        LOGGING_TAG,
+        "Token index: %" PRIu32 " tokens, generation %" PRIu32,
+        (uint32_t)context->total_count,
+        context->generation);
+
     return context;
 }
 
 void totp_token_info_iterator_free(TokenInfoIteratorContext* context) {
     if(context == NULL) return;
+
+    // Config file is closed by now, so its final size and modification time are known
+    FileInfo config_info;
+    uint32_t config_timestamp;
+    if(context->index_dirty &&
+       storage_common_stat(context->storage, CONFIG_FILE_PATH, &config_info) == FSE_OK &&
+       config_info.size == context->indexed_stream_size &&
+       storage_common_timestamp(context->storage, CONFIG_FILE_PATH, &config_timestamp) ==
+           FSE_OK) {
+        token_index_save(context, config_timestamp);
+    }
+
     token_info_free(context->current_token);
+    if(context->token_offsets != NULL) {
+        free(context->token_offsets);
+    }
     free(context);
 }
 
@@ -309,6 +513,7 @@ bool totp_token_info_iterator_remove_current_token_info(TokenInfoIteratorContext
     }
 
     context->total_count--;
+    token_index_update(context);
     if(context->current_index >= context->total_count) {
         context->current_index = context->total_count - 1;
     }
@@ -372,8 +577,6 @@ bool totp_token_info_iterator_move_current_token_info(
             break;
         }
 
-        context->last_seek_offset = 0;
-        context->last_seek_index = 0;
         if(new_index >= context->total_count - 1) {
             if(!stream_seek(stream, stream_size(stream) - 1, StreamOffsetFromStart)) {
                 break;
@@ -388,8 +591,8 @@ bool totp_token_info_iterator_move_current_token_info(
     stream_free(temp_stream);
     storage_common_remove(context->storage, CONFIG_FILE_PART_FILE_PATH);
 
+    token_index_update(context);
     context->last_seek_offset = 0;
-    context->last_seek_index = 0;
 
     return result;
 }
@@ -98,7 +98,8 @@ TotpIteratorUpdateTokenResult totp_token_info_iterator_add_new_token(
 bool totp_token_info_iterator_remove_current_token_info(TokenInfoIteratorContext* context);
 
 /**
- * @brief Disposes token info iterator and releases all the resources
+ * @brief Disposes token info iterator and releases all the resources. Must be called after the
+ *        config file is closed, so the saved token index records its final modification time
  * @param context token info iterator context
  */
 void totp_token_info_iterator_free(TokenInfoIteratorContext* context);
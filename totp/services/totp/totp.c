@@ -2,9 +2,11 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include "../../config/wolfssl/config.h"
 #include <wolfssl/wolfcrypt/hmac.h>
+#include <wolfssl/wolfcrypt/hash.h>
 #ifdef NO_INLINE
 #include <wolfssl/wolfcrypt/misc.h>
 #else
@@ -13,6 +15,14 @@
 #endif
 
 #define HMAC_MAX_RESULT_SIZE WC_SHA512_DIGEST_SIZE
+#define HMAC_IPAD (0x36)
+#define HMAC_OPAD (0x5C)
+
+struct OtpHmacKey {
+    enum wc_HashType type;
+    wc_HashAlg inner;
+    wc_HashAlg outer;
+};
 
 static int32_t timezone_offset_from_hours(float hours) {
     return hours * 3600.0f;
@@ -42,6 +52,21 @@ uint64_t totp_timecode(uint8_t interval, uint64_t for_time) {
     return for_time / interval;
 }
 
+/**
+ * @brief Extracts OTP code from HMAC result (dynamic truncation)
+ * @param hmac HMAC result
+ * @param hmac_len HMAC result length
+ * @return OTP code
+ */
+static uint64_t otp_truncate(const uint8_t* hmac, int hmac_len) {
+    uint64_t offset = (hmac[hmac_len - 1] & 0xF);
+    uint64_t i_code =
+        ((hmac[offset] & 0x7F) << 24 | (hmac[offset + 1] & 0xFF) << 16 |
+         (hmac[offset + 2] & 0xFF) << 8 | (hmac[offset + 3] & 0xFF));
+
+    return i_code;
+}
+
 /**
  * @brief Generates an OTP (One Time Password)
  * @param algo hashing algorithm to be used
@@ -65,12 +90,44 @@ uint64_t otp_generate(
         return OTP_ERROR;
     }
 
-    uint64_t offset = (hmac[hmac_len - 1] & 0xF);
-    uint64_t i_code =
-        ((hmac[offset] & 0x7F) << 24 | (hmac[offset + 1] & 0xFF) << 16 |
-         (hmac[offset + 2] & 0xFF) << 8 | (hmac[offset + 3] & 0xFF));
+    return otp_truncate(&hmac[0], hmac_len);
+}
 
-    return i_code;
+/**
+ * @brief Generates an OTP (One Time Password) using precomputed HMAC key schedule.
+ *        Only the message and the inner digest get hashed, one compression each.
+ * @param key HMAC key schedule
+ * @param input input data for OTP code generation
+ * @return OTP code if code was successfully generated; 0 otherwise
+ */
+static uint64_t otp_generate_with_key(const OtpHmacKey* key, uint64_t input) {
+    uint8_t hmac[HMAC_MAX_RESULT_SIZE] = {0};
+    int hmac_len = wc_HashGetDigestSize(key->type);
+
+    uint64_t input_swapped = ByteReverseWord64(input);
+
+    wc_HashAlg state;
+    memcpy(&state, &key->inner, sizeof(state));
+    int ret = wc_HashUpdate(&state, key->type, (uint8_t*)&input_swapped, 8);
+    if(ret == 0) {
+        ret = wc_HashFinal(&state, key->type, &hmac[0]);
+    }
+
+    if(ret == 0) {
+        memcpy(&state, &key->outer, sizeof(state));
+        ret = wc_HashUpdate(&state, key->type, &hmac[0], hmac_len);
+    }
+
+    if(ret == 0) {
+        ret = wc_HashFinal(&state, key->type, &hmac[0]);
+    }
+
+    ForceZero(&state, sizeof(state));
+    if(ret != 0) {
+        return OTP_ERROR;
+    }
+
+    return otp_truncate(&hmac[0], hmac_len);
 }
 
 uint64_t totp_at(
@@ -94,6 +151,20 @@ uint64_t hotp_at(
     return otp_generate(algo, plain_secret, plain_secret_length, counter);
 }
 
+uint64_t totp_at_with_key(
+    const OtpHmacKey* key,
+    uint64_t for_time,
+    float timezone,
+    uint8_t interval) {
+    uint64_t for_time_adjusted =
+        timezone_offset_apply(for_time, timezone_offset_from_hours(timezone));
+    return otp_generate_with_key(key, totp_timecode(interval, for_time_adjusted));
+}
+
+uint64_t hotp_at_with_key(const OtpHmacKey* key, uint64_t counter) {
+    return otp_generate_with_key(key, counter);
+}
+
 static int totp_algo_common(
     int type,
     const uint8_t* key,
@@ -145,3 +216,83 @@ static int totp_algo_sha512(
 const TOTP_ALGO TOTP_ALGO_SHA1 = (TOTP_ALGO)(&totp_algo_sha1);
 const TOTP_ALGO TOTP_ALGO_SHA256 = (TOTP_ALGO)(&totp_algo_sha256);
 const TOTP_ALGO TOTP_ALGO_SHA512 = (TOTP_ALGO)(&totp_algo_sha512);
+
+static enum wc_HashType totp_algo_hash_type(TOTP_ALGO algo) {
+    if(algo == TOTP_ALGO_SHA1) {
+        return WC_HASH_TYPE_SHA;
+    }
+
+    if(algo == TOTP_ALGO_SHA256) {
+        return WC_HASH_TYPE_SHA256;
+    }
+
+    if(algo == TOTP_ALGO_SHA512) {
+        return WC_HASH_TYPE_SHA512;
+    }
+
+    return WC_HASH_TYPE_NONE;
+}
+
+OtpHmacKey*
+    otp_hmac_key_alloc(TOTP_ALGO algo, const uint8_t* plain_secret, size_t plain_secret_length) {
+    enum wc_HashType type = totp_algo_hash_type(algo);
+    int block_size = wc_HashGetBlockSize(type);
+    int digest_size = wc_HashGetDigestSize(type);
+    if(block_size <= 0 || block_size > WC_MAX_BLOCK_SIZE || digest_size <= 0) {
+        return NULL;
+    }
+
+    OtpHmacKey* key = malloc(sizeof(OtpHmacKey));
+    if(key == NULL) {
+        return NULL;
+    }
+
+    key->type = type;
+
+    uint8_t pad[WC_MAX_BLOCK_SIZE] = {0};
+    int ret = 0;
+    if(plain_secret_length > (size_t)block_size) {
+        ret = wc_Hash(type, plain_secret, plain_secret_length, &pad[0], digest_size);
+    } else if(plain_secret_length > 0) {
+        memcpy(&pad[0], plain_secret, plain_secret_length);
+    }
+
+    if(ret == 0) {
+        for(int i = 0; i < block_size; i++) {
+            pad[i] ^= HMAC_IPAD;
+        }
+
+        ret = wc_HashInit(&key->inner, type);
+    }
+
+    if(ret == 0) {
+        ret = wc_HashUpdate(&key->inner, type, &pad[0], block_size);
+    }
+
+    if(ret == 0) {
+        for(int i = 0; i < block_size; i++) {
+            pad[i] ^= HMAC_IPAD ^ HMAC_OPAD;
+        }
+
+        ret = wc_HashInit(&key->outer, type);
+    }
+
+    if(ret == 0) {
+        ret = wc_HashUpdate(&key->outer, type, &pad[0], block_size);
+    }
+
+    ForceZero(&pad[0], sizeof(pad));
+
+    if(ret != 0) {
+        otp_hmac_key_free(key);
+        return NULL;
+    }
+
+    return key;
+}
+
+void otp_hmac_key_free(OtpHmacKey* key) {
+    if(key == NULL) return;
+    ForceZero(key, sizeof(OtpHmacKey));
+    free(key);
+}
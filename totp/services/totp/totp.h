@@ -5,6 +5,11 @@
 
 #define OTP_ERROR (0)
 
+/**
+ * @brief HMAC key schedule: hash states with the inner and outer key pads already absorbed
+ */
+typedef struct OtpHmacKey OtpHmacKey;
+
 /**
  * @brief Must compute HMAC using passed arguments, output as char array through output.
  *        \p key is secret key buffer.
@@ -67,3 +72,41 @@ uint64_t hotp_at(
     const uint8_t* plain_secret,
     size_t plain_secret_length,
     uint64_t counter);
+
+/**
+ * @brief Precomputes HMAC key schedule, so that further codes do not need the secret anymore
+ * @param algo hashing algorithm to be used
+ * @param plain_secret plain token secret
+ * @param plain_secret_length plain token secret length
+ * @return HMAC key schedule if succeeded; \c NULL otherwise
+ */
+OtpHmacKey*
+    otp_hmac_key_alloc(TOTP_ALGO algo, const uint8_t* plain_secret, size_t plain_secret_length);
+
+/**
+ * @brief Wipes and releases HMAC key schedule
+ * @param key HMAC key schedule
+ */
+void otp_hmac_key_free(OtpHmacKey* key);
+
+/**
+ * @brief Generates a TOTP key using the totp algorithm and precomputed HMAC key schedule.
+ * @param key HMAC key schedule
+ * @param for_time the time the generated key will be created for
+ * @param timezone UTC timezone adjustment for the generated key
+ * @param interval token lifetime in seconds
+ * @return TOTP code if code was successfully generated; 0 otherwise
+ */
+uint64_t totp_at_with_key(
+    const OtpHmacKey* key,
+    uint64_t for_time,
+    float timezone,
+    uint8_t interval);
+
+/**
+ * @brief Generates a HOTP key using the hotp algorithm and precomputed HMAC key schedule.
+ * @param key HMAC key schedule
+ * @param counter the HOTP counter
+ * @return HOTP code if code was successfully generated; 0 otherwise
+ */
+uint64_t hotp_at_with_key(const OtpHmacKey* key, uint64_t counter);
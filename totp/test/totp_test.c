@@ -0,0 +1,172 @@
+// Checks the code generation against the RFC 6238 TOTP vectors (SHA1, SHA256 and SHA512) and
+// the RFC 4226 HOTP vectors, both with the secret (totp_at/hotp_at) and with the cached HMAC key
+// schedule (totp_at_with_key/hotp_at_with_key), then measures both paths.
+//
+//   make -C totp/test run
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../services/totp/totp.h"
+
+#define TOTP_DIGITS_MOD 100000000 // RFC 6238 vectors have 8 digits
+#define HOTP_DIGITS_MOD 1000000 // RFC 4226 vectors have 6 digits
+#define TOTP_INTERVAL 30
+#define LONG_KEY_LENGTH 199 // longer than the SHA512 block, so the key gets hashed first
+#define BENCH_CODES 200000
+
+typedef struct {
+    const char* name;
+    const TOTP_ALGO* algo;
+    const char* secret;
+    uint32_t expected[6];
+} Rfc6238Vector;
+
+// RFC 6238 appendix B, each algorithm has its own seed length
+static const uint64_t rfc6238_times[6] =
+    {59, 1111111109, 1111111111, 1234567890, 2000000000, 20000000000ULL};
+
+static const Rfc6238Vector rfc6238[] = {
+    {"SHA1",
+     &TOTP_ALGO_SHA1,
+     "12345678901234567890",
+     {94287082, 7081804, 14050471, 89005924, 69279037, 65353130}},
+    {"SHA256",
+     &TOTP_ALGO_SHA256,
+     "12345678901234567890123456789012",
+     {46119246, 68084774, 67062674, 91819424, 90698825, 77737706}},
+    {"SHA512",
+     &TOTP_ALGO_SHA512,
+     "1234567890123456789012345678901234567890123456789012345678901234",
+     {90693936, 25091201, 99943326, 93441116, 38618901, 47863826}},
+};
+
+// RFC 4226 appendix D
+static const char* rfc4226_secret = "12345678901234567890";
+static const uint32_t rfc4226[10] =
+    {755224, 287082, 359152, 969429, 338314, 254676, 287922, 162583, 399871, 520489};
+
+static uint32_t failures;
+
+static void check(const char* what, uint64_t counter, uint64_t got, uint64_t expected) {
+    if(got == expected) return;
+
+    printf(
+        "FAIL %s at %llu: %llu, expected %llu\n",
+        what,
+        (unsigned long long)counter,
+        (unsigned long long)got,
+        (unsigned long long)expected);
+    failures++;
+}
+
+static void test_rfc6238(const Rfc6238Vector* v) {
+    const uint8_t* secret = (const uint8_t*)v->secret;
+    size_t length = strlen(v->secret);
+    OtpHmacKey* key = otp_hmac_key_alloc(*v->algo, secret, length);
+
+    for(int i = 0; i < 6; i++) {
+        uint64_t t = rfc6238_times[i];
+        check(
+            v->name,
+            t,
+            totp_at(*v->algo, secret, length, t, 0, TOTP_INTERVAL) % TOTP_DIGITS_MOD,
+            v->expected[i]);
+        check(
+            v->name,
+            t,
+            totp_at_with_key(key, t, 0, TOTP_INTERVAL) % TOTP_DIGITS_MOD,
+            v->expected[i]);
+    }
+
+    otp_hmac_key_free(key);
+}
+
+static void test_rfc4226(void) {
+    const uint8_t* secret = (const uint8_t*)rfc4226_secret;
+    size_t length = strlen(rfc4226_secret);
+    OtpHmacKey* key = otp_hmac_key_alloc(TOTP_ALGO_SHA1, secret, length);
+
+    for(uint64_t counter = 0; counter < 10; counter++) {
+        check(
+            "HOTP",
+            counter,
+            hotp_at(TOTP_ALGO_SHA1, secret, length, counter) % HOTP_DIGITS_MOD,
+            rfc4226[counter]);
+        check("HOTP", counter, hotp_at_with_key(key, counter) % HOTP_DIGITS_MOD, rfc4226[counter]);
+    }
+
+    otp_hmac_key_free(key);
+}
+
+// HMAC hashes keys longer than the block size before padding them
+static void test_long_key(const Rfc6238Vector* v) {
+    uint8_t secret[LONG_KEY_LENGTH];
+    for(size_t i = 0; i < sizeof(secret); i++) {
+        secret[i] = (uint8_t)(i * 7 + 1);
+    }
+
+    OtpHmacKey* key = otp_hmac_key_alloc(*v->algo, secret, sizeof(secret));
+
+    for(uint64_t counter = 0; counter < 100; counter++) {
+        check(
+            v->name,
+            counter,
+            hotp_at_with_key(key, counter),
+            hotp_at(*v->algo, secret, sizeof(secret), counter));
+    }
+
+    otp_hmac_key_free(key);
+}
+
+static void bench(const Rfc6238Vector* v) {
+    const uint8_t* secret = (const uint8_t*)v->secret;
+    size_t length = strlen(v->secret);
+    OtpHmacKey* key = otp_hmac_key_alloc(*v->algo, secret, length);
+    volatile uint64_t sink = 0;
+
+    clock_t start = clock();
+    for(uint64_t i = 0; i < BENCH_CODES; i++) {
+        sink += totp_at(*v->algo, secret, length, i * TOTP_INTERVAL, 0, TOTP_INTERVAL);
+    }
+    double with_secret = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for(uint64_t i = 0; i < BENCH_CODES; i++) {
+        sink += totp_at_with_key(key, i * TOTP_INTERVAL, 0, TOTP_INTERVAL);
+    }
+    double with_key = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf(
+        "%-6s %10.0f codes/s with the secret, %10.0f codes/s with the key schedule\n",
+        v->name,
+        BENCH_CODES / with_secret,
+        BENCH_CODES / with_key);
+
+    otp_hmac_key_free(key);
+}
+
+int main(void) {
+    size_t count = sizeof(rfc6238) / sizeof(rfc6238[0]);
+
+    for(size_t i = 0; i < count; i++) {
+        test_rfc6238(&rfc6238[i]);
+        test_long_key(&rfc6238[i]);
+    }
+
+    test_rfc4226();
+
+    if(failures) {
+        printf("FAILED: %u checks\n", failures);
+        return 1;
+    }
+
+    printf("RFC 6238 and RFC 4226 vectors OK\n");
+
+    for(size_t i = 0; i < count; i++) {
+        bench(&rfc6238[i]);
+    }
+
+    return 0;
+}
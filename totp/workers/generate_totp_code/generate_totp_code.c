@@ -16,6 +16,7 @@ struct TotpGenerateCodeWorkerContext {
     const TokenInfo* token_info;
     float timezone_offset;
     const CryptoSettings* crypto_settings;
+    OtpHmacKey* hmac_key;
     TOTP_NEW_CODE_GENERATED_HANDLER on_new_code_generated_handler;
     void* on_new_code_generated_handler_context;
     TOTP_CODE_LIFETIME_CHANGED_HANDLER on_code_lifetime_changed_handler;
@@ -63,34 +64,44 @@ static TOTP_ALGO get_totp_algo_impl(TokenHashAlgo algo) {
     return NULL;
 }
 
+static void reset_hmac_key(TotpGenerateCodeWorkerContext* context) {
+    otp_hmac_key_free(context->hmac_key);
+    context->hmac_key = NULL;
+}
+
 static void generate_totp_code(
     TotpGenerateCodeWorkerContext* context,
     const TokenInfo* token_info,
     uint32_t current_ts) {
     if(token_info->token != NULL && token_info->token_length > 0) {
-        size_t key_length;
-        uint8_t* key = totp_crypto_decrypt(
-            token_info->token, token_info->token_length, context->crypto_settings, &key_length);
+        // Secret is decrypted only once per token, then just its HMAC key schedule is kept
+        if(context->hmac_key == NULL) {
+            size_t key_length;
+            uint8_t* key = totp_crypto_decrypt(
+                token_info->token,
+                token_info->token_length,
+                context->crypto_settings,
+                &key_length);
+
+            context->hmac_key =
+                otp_hmac_key_alloc(get_totp_algo_impl(token_info->algo), key, key_length);
+            memset_s(key, key_length, 0, key_length);
+            free(key);
+        }
 
         uint64_t otp_code;
-        if(token_info->type == TokenTypeTOTP) {
-            otp_code = totp_at(
-                get_totp_algo_impl(token_info->algo),
-                key,
-                key_length,
-                current_ts,
-                context->timezone_offset,
-                token_info->duration);
+        if(context->hmac_key == NULL) {
+            otp_code = OTP_ERROR;
+        } else if(token_info->type == TokenTypeTOTP) {
+            otp_code = totp_at_with_key(
+                context->hmac_key, current_ts, context->timezone_offset, token_info->duration);
         } else if(token_info->type == TokenTypeHOTP) {
-            otp_code = hotp_at(
-                get_totp_algo_impl(token_info->algo), key, key_length, token_info->counter);
+            otp_code = hotp_at_with_key(context->hmac_key, token_info->counter);
         } else {
             furi_crash("Unknown token type");
         }
 
         int_token_to_str(otp_code, context->code_buffer, token_info->digits, token_info->algo);
-        memset_s(key, key_length, 0, key_length);
-        free(key);
     } else {
         int_token_to_str(0, context->code_buffer, token_info->digits, token_info->algo);
     }
@@ -117,6 +128,11 @@ static int32_t totp_generate_worker_callback(void* context) {
 
         if(flags & TotpGenerateCodeWorkerEventStop) break;
 
+        // Forced update means token has been switched or changed, cached key is not valid anymore
+        if(flags & TotpGenerateCodeWorkerEventForceUpdate) {
+            reset_hmac_key(t_context);
+        }
+
         const TokenInfo* token_info = t_context->token_info;
         if(token_info == NULL) {
             continue;
@@ -167,6 +183,7 @@ TotpGenerateCodeWorkerContext* totp_generate_code_worker_start(
     context->code_buffer_sync = code_buffer_sync;
     context->timezone_offset = timezone_offset;
     context->crypto_settings = crypto_settings;
+    context->hmac_key = NULL;
     context->thread = furi_thread_alloc();
     furi_thread_set_name(context->thread, "TOTPGenerateWorker");
     furi_thread_set_stack_size(context->thread, 2048);
@@ -181,6 +198,7 @@ void totp_generate_code_worker_stop(TotpGenerateCodeWorkerContext* context) {
     furi_thread_flags_set(furi_thread_get_id(context->thread), TotpGenerateCodeWorkerEventStop);
     furi_thread_join(context->thread);
     furi_thread_free(context->thread);
+    reset_hmac_key(context);
     free(context);
 }
 
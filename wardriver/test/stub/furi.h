@@ -0,0 +1,95 @@
+#pragma once
+
+// Just enough of furi for the wardriver UART parser and access point table to build on the
+// host. Threads, flags and stream buffers are driven by the replay, see host_wardriver.c.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+#define furi_assert(x) (void)(x)
+#define furi_check(x) \
+    do {              \
+        if(!(x)) abort(); \
+    } while(0)
+
+static inline void furi_log_print(const char* tag, const char* format, ...) {
+    (void)tag;
+    (void)format;
+}
+
+#define FURI_LOG_E(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) furi_log_print(tag, __VA_ARGS__)
+#define FURI_LOG_T(tag, ...) furi_log_print(tag, __VA_ARGS__)
+
+// The app heap is counted, like the firmware reports it
+void* host_malloc(size_t size);
+void host_free(void* ptr);
+#define malloc(size) host_malloc(size)
+#define free(ptr) host_free(ptr)
+
+static inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t length = strlen(src);
+    if(size > 0) {
+        size_t n = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
+
+#define FuriWaitForever 0xFFFFFFFFU
+#define FuriFlagWaitAny 0
+#define FuriFlagError 0x80000000U
+#define FuriFlagErrorTimeout 0xFFFFFFFEU
+
+typedef struct FuriString FuriString;
+typedef struct FuriThread FuriThread;
+typedef struct FuriStreamBuffer FuriStreamBuffer;
+typedef struct FuriMessageQueue FuriMessageQueue;
+typedef struct FuriMutex FuriMutex;
+typedef void* FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void* context);
+
+const char* furi_string_get_cstr(const FuriString* string);
+
+uint32_t furi_get_tick(void);
+static inline uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+FuriThread* furi_thread_alloc(void);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_name(FuriThread* thread, const char* name);
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size);
+void furi_thread_set_context(FuriThread* thread, void* context);
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level);
+void furi_stream_buffer_free(FuriStreamBuffer* stream_buffer);
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* stream_buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout);
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* stream_buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout);
+
+#define RECORD_STORAGE "storage"
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
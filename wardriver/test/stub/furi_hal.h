@@ -0,0 +1,71 @@
+#pragma once
+
+#include <furi.h>
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t day;
+    uint8_t month;
+    uint16_t year;
+    uint8_t weekday;
+} FuriHalRtcDateTime;
+
+void furi_hal_rtc_get_datetime(FuriHalRtcDateTime* datetime);
+
+typedef enum {
+    LightRed = (1 << 0),
+    LightGreen = (1 << 1),
+    LightBlue = (1 << 2),
+} Light;
+
+static inline void furi_hal_light_set(Light light, uint8_t value) {
+    UNUSED(light);
+    UNUSED(value);
+}
+
+static inline void furi_hal_light_blink_start(Light light, uint8_t brightness, uint16_t on, uint16_t period) {
+    UNUSED(light);
+    UNUSED(brightness);
+    UNUSED(on);
+    UNUSED(period);
+}
+
+typedef enum {
+    FuriHalUartIdUSART1,
+    FuriHalUartIdLPUART1,
+} FuriHalUartId;
+
+typedef enum {
+    UartIrqEventRXNE,
+} UartIrqEvent;
+
+typedef void (*FuriHalUartIrqCallback)(UartIrqEvent event, uint8_t data, void* context);
+
+static inline void furi_hal_uart_init(FuriHalUartId channel, uint32_t baud) {
+    UNUSED(channel);
+    UNUSED(baud);
+}
+
+static inline void furi_hal_uart_deinit(FuriHalUartId channel) {
+    UNUSED(channel);
+}
+
+static inline void furi_hal_uart_set_br(FuriHalUartId channel, uint32_t baud) {
+    UNUSED(channel);
+    UNUSED(baud);
+}
+
+static inline void
+    furi_hal_uart_set_irq_cb(FuriHalUartId channel, FuriHalUartIrqCallback callback, void* context) {
+    UNUSED(channel);
+    UNUSED(callback);
+    UNUSED(context);
+}
+
+static inline void furi_hal_console_enable(void) {
+}
+
+static inline void furi_hal_console_disable(void) {
+}
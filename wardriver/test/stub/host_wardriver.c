@@ -0,0 +1,272 @@
+#include "host_wardriver.h"
+#include "../../wardriver_uart.h"
+
+#include <stddef.h>
+#include <time.h>
+
+#undef malloc
+#undef free
+
+HostHeap host_heap;
+HostStorage host_storage;
+XtremeSettings xtreme_settings;
+
+static struct {
+    const char* data;
+    size_t length;
+    size_t position;
+    size_t chunk_end;
+    size_t max_chunk;
+    uint32_t seed;
+    uint64_t time_us;
+} replay;
+
+void replay_start(const char* data, size_t length, size_t max_chunk, uint32_t seed) {
+    memset(&replay, 0, sizeof(replay));
+    replay.data = data;
+    replay.length = length;
+    replay.max_chunk = max_chunk;
+    replay.seed = seed;
+}
+
+static uint32_t replay_random(void) {
+    replay.seed = replay.seed * 1103515245 + 12345;
+    return replay.seed >> 8;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// heap
+
+typedef union {
+    size_t size;
+    max_align_t align;
+} HeapHeader;
+
+void* host_malloc(size_t size) {
+    // furi's malloc never returns NULL and zeroes memory
+    HeapHeader* header = calloc(1, sizeof(HeapHeader) + size);
+    if(!header) abort();
+
+    header->size = size;
+    host_heap.current += size;
+    host_heap.allocations++;
+    if(host_heap.current > host_heap.peak) host_heap.peak = host_heap.current;
+
+    return header + 1;
+}
+
+void host_free(void* ptr) {
+    if(!ptr) return;
+
+    HeapHeader* header = (HeapHeader*)ptr - 1;
+    host_heap.current -= header->size;
+    free(header);
+}
+
+// furi
+
+struct FuriString {
+    const char* cstr;
+};
+
+FuriString* host_string_alloc(const char* cstr) {
+    FuriString* string = calloc(1, sizeof(FuriString));
+    string->cstr = cstr;
+    return string;
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->cstr;
+}
+
+uint32_t furi_get_tick(void) {
+    return replay.time_us / 1000;
+}
+
+void furi_hal_rtc_get_datetime(FuriHalRtcDateTime* datetime) {
+    uint32_t s = replay.time_us / 1000000;
+
+    memset(datetime, 0, sizeof(FuriHalRtcDateTime));
+    datetime->year = 2024;
+    datetime->month = 1;
+    datetime->day = 1 + s / 86400;
+    datetime->hour = s / 3600 % 24;
+    datetime->minute = s / 60 % 60;
+    datetime->second = s % 60;
+}
+
+// The ESP worker runs on the calling thread: every wait hands it the next chunk of the log
+// until the log is over, then asks it to stop
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    UNUSED(flags);
+    UNUSED(options);
+    UNUSED(timeout);
+
+    if(replay.position >= replay.length) return WorkerEvtStop;
+
+    size_t chunk = 1 + replay_random() % replay.max_chunk;
+    replay.chunk_end = replay.position + chunk;
+    if(replay.chunk_end > replay.length) replay.chunk_end = replay.length;
+    replay.time_us += (replay.chunk_end - replay.position) * UART_BYTE_US;
+
+    return WorkerEvtRxDone;
+}
+
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* stream_buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout) {
+    UNUSED(stream_buffer);
+    UNUSED(timeout);
+
+    size_t n = replay.chunk_end - replay.position;
+    if(n > length) n = length;
+
+    memcpy(data, replay.data + replay.position, n);
+    replay.position += n;
+    return n;
+}
+
+// Only referenced by wardriver_uart_init() and the UART interrupt callbacks, never called
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level) {
+    UNUSED(size);
+    UNUSED(trigger_level);
+    return NULL;
+}
+
+void furi_stream_buffer_free(FuriStreamBuffer* stream_buffer) {
+    UNUSED(stream_buffer);
+}
+
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* stream_buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout) {
+    UNUSED(stream_buffer);
+    UNUSED(data);
+    UNUSED(timeout);
+    return length;
+}
+
+FuriThread* furi_thread_alloc(void) {
+    return NULL;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    UNUSED(thread);
+}
+
+void furi_thread_set_name(FuriThread* thread, const char* name) {
+    UNUSED(thread);
+    UNUSED(name);
+}
+
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    UNUSED(thread);
+    UNUSED(stack_size);
+}
+
+void furi_thread_set_context(FuriThread* thread, void* context) {
+    UNUSED(thread);
+    UNUSED(context);
+}
+
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    UNUSED(thread);
+    UNUSED(callback);
+}
+
+void furi_thread_start(FuriThread* thread) {
+    UNUSED(thread);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    UNUSED(thread);
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    UNUSED(thread_id);
+    return flags;
+}
+
+void* furi_record_open(const char* name) {
+    UNUSED(name);
+    return NULL;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// storage
+
+struct File {
+    FILE* file;
+    bool append;
+    double opened;
+};
+
+bool storage_common_exists(Storage* storage, const char* path) {
+    UNUSED(storage);
+    UNUSED(path);
+    return true;
+}
+
+int storage_common_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    UNUSED(path);
+    return 0;
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return calloc(1, sizeof(File));
+}
+
+void storage_file_free(File* file) {
+    free(file);
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    UNUSED(access_mode);
+
+    file->append = open_mode == FSOM_OPEN_APPEND;
+    file->opened = seconds();
+    file->file = fopen(path, file->append ? "ab" : "wb");
+    return file->file != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->file) return false;
+
+    fclose(file->file);
+    file->file = NULL;
+
+    if(file->append) {
+        double elapsed = seconds() - file->opened;
+        host_storage.saves++;
+        host_storage.seconds += elapsed;
+        if(elapsed > host_storage.max_seconds) host_storage.max_seconds = elapsed;
+    }
+
+    return true;
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    size_t written = fwrite(buff, 1, bytes_to_write, file->file);
+    host_storage.bytes += written;
+    return written;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// Replay of a scanner UART log through the ESP worker, with the heap and the storage
+// writes counted.
+
+#include <furi.h>
+
+#define UART_BAUD 115200
+#define UART_BYTE_US (10 * 1000000 / UART_BAUD) // start, 8 data and stop bits
+
+typedef struct {
+    size_t current;
+    size_t peak;
+    uint32_t allocations;
+} HostHeap;
+
+typedef struct {
+    uint32_t saves; // appends, from open to close
+    uint64_t bytes;
+    double seconds;
+    double max_seconds;
+} HostStorage;
+
+extern HostHeap host_heap;
+extern HostStorage host_storage;
+
+// Feeds data to the ESP worker in chunks of 1 to max_chunk bytes, like the UART interrupt
+// fills the stream buffer, and stops the worker at the end. furi_get_tick() follows the time
+// the bytes take on the UART.
+void replay_start(const char* data, size_t length, size_t max_chunk, uint32_t seed);
+
+// A constant FuriString, for the CSV path
+FuriString* host_string_alloc(const char* cstr);
@@ -0,0 +1,3 @@
+#pragma once
+
+// Only needed by the firmware build of minmea, nothing to add on the host.
@@ -0,0 +1,3 @@
+#pragma once
+
+// Generated from icons/ by the firmware build, nothing is used by the parser.
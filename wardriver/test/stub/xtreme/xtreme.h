@@ -0,0 +1,15 @@
+#pragma once
+
+#include <furi.h>
+
+typedef enum {
+    UARTDefault,
+    UARTExtra,
+} XtremeUartChannel;
+
+typedef struct {
+    XtremeUartChannel uart_esp_channel;
+    XtremeUartChannel uart_nmea_channel;
+} XtremeSettings;
+
+extern XtremeSettings xtreme_settings;
@@ -0,0 +1,349 @@
+// Replays a scanner UART log through the ESP worker: the bytes go through the same line
+// reassembly, parser, access point table and periodic CSV appends as on the Flipper. Reports
+// the parse throughput, the heap used and the time of the CSV saves.
+//
+// Without a log, a generated one is used: more than MAX_ACCESS_POINTS different BSSIDs seen
+// again and again, packets and invalid lines. The table and the CSV file are then checked
+// against what the log contains.
+//
+//   make -C wardriver/test run
+//   ./wardriver_replay [scanner.log]
+
+#include <time.h>
+
+#include "../wardriver_uart.c"
+#include "host_wardriver.h"
+
+#define CSV_PATH "wardriver_replay.csv"
+#define MAX_CHUNK 64 // bytes the UART interrupt may queue before the worker runs
+#define LOG_LINES 200000
+#define LOG_BSSIDS (MAX_ACCESS_POINTS + 64) // the last ones do not fit in the table
+
+typedef struct {
+    bool seen;
+    bool in_table;
+    char ssid[MAX_SSID_LENGTH + 1];
+    int8_t rssi;
+    uint8_t channel;
+    uint16_t rx;
+    uint16_t tx;
+} ExpectedAp;
+
+static ExpectedAp expected[LOG_BSSIDS];
+static uint16_t table_count;
+static uint32_t failures;
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fail(const char* what, uint32_t index) {
+    if(failures++ < 10) printf("FAIL %s (%u)\n", what, index);
+}
+
+static void bssid_of(uint32_t index, char* str) {
+    snprintf(
+        str,
+        MAX_BSSID_LENGTH,
+        "a4:%02x:3c:%02x:5a:%02x",
+        (uint8_t)index,
+        (uint8_t)(index >> 8),
+        (uint8_t)(index % 7));
+}
+
+static size_t append(char* log, size_t length, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    length += vsprintf(log + length, format, args);
+    va_end(args);
+    return length;
+}
+
+// What the ESP sends: "AR,ssid,bssid,rssi,channel" for access points, "PK,received,sent" for
+// packets, with the ground truth the worker should end up with
+static char* generate_log(size_t* length) {
+    char* log = host_malloc(LOG_LINES * 64);
+    char bssid[MAX_BSSID_LENGTH], other[MAX_BSSID_LENGTH];
+    size_t n = 0;
+    srand(1);
+
+    for(uint32_t line = 0; line < LOG_LINES; line++) {
+        uint32_t index = rand() % LOG_BSSIDS;
+        ExpectedAp* ap = &expected[index];
+        const char* eol = rand() % 2 ? "\r\n" : "\n";
+        int rssi = -20 - rand() % 76;
+        int channel = 1 + rand() % 14;
+        bssid_of(index, bssid);
+
+        switch(rand() % 20) {
+        case 0: // invalid: the worker must not touch the access point
+            switch(rand() % 6) {
+            case 0:
+                n = append(log, n, "AR,net,%s,%d,%d%s", bssid, -rssi, channel, eol);
+                break;
+            case 1:
+                n = append(log, n, "AR,net,%s,%d,15%s", bssid, rssi, eol);
+                break;
+            case 2:
+                n = append(log, n, "AR,  ,%s,%d,%d%s", bssid, rssi, channel, eol);
+                break;
+            case 3:
+                n = append(log, n, "AR,net,%.14s,%d,%d%s", bssid, rssi, channel, eol);
+                break;
+            case 4:
+                n = append(log, n, "AR,net,%s%s", bssid, eol);
+                break;
+            default:
+                n = append(log, n, "boot: rst:0x1 (POWERON),%s", eol);
+                break;
+            }
+            break;
+
+        case 1:
+        case 2: { // packet, the other end may be a client that is not an access point
+            uint32_t other_index = rand() % (LOG_BSSIDS * 2);
+            bssid_of(other_index, other);
+            n = append(log, n, "PK,%s,%s%s", bssid, other, eol);
+
+            if(ap->in_table) ap->rx++;
+            if(other_index < LOG_BSSIDS && expected[other_index].in_table) {
+                expected[other_index].tx++;
+            }
+            break;
+        }
+
+        default:
+            if(!ap->seen) {
+                ap->seen = true;
+                snprintf(ap->ssid, sizeof(ap->ssid), "net %04x", index);
+                if(table_count < MAX_ACCESS_POINTS) {
+                    ap->in_table = true;
+                    table_count++;
+                }
+            }
+
+            // some SSIDs come with a space in front
+            n = append(
+                log,
+                n,
+                "AR,%s%s,%s,%d,%d%s",
+                index % 5 ? "" : " ",
+                ap->ssid,
+                bssid,
+                rssi,
+                channel,
+                eol);
+            if(ap->in_table) {
+                ap->rssi = rssi;
+                ap->channel = channel;
+            }
+            break;
+        }
+    }
+
+    *length = n;
+    return log;
+}
+
+static char* load_log(const char* path, size_t* length) {
+    FILE* f = fopen(path, "rb");
+    if(!f) return NULL;
+
+    fseek(f, 0, SEEK_END);
+    *length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char* log = host_malloc(*length);
+    *length = fread(log, 1, *length, f);
+    fclose(f);
+    return log;
+}
+
+static void check_table(const AccessPointTable* table) {
+    if(table->count != table_count) fail("table size", table->count);
+
+    for(uint32_t index = 0; index < LOG_BSSIDS; index++) {
+        char bssid_str[MAX_BSSID_LENGTH];
+        uint8_t bssid[BSSID_SIZE];
+        bssid_of(index, bssid_str);
+        access_points_parse_bssid(bssid_str, bssid);
+
+        const ExpectedAp* e = &expected[index];
+        uint16_t slot = access_points_find(table, bssid);
+
+        if(!e->in_table) {
+            if(slot != AP_SLOT_NONE) fail("access point in the table", index);
+            continue;
+        }
+
+        if(slot == AP_SLOT_NONE) {
+            fail("access point missing", index);
+            continue;
+        }
+
+        const AccessPoint* ap = access_points_get(table, slot);
+        if(strcmp(ap->ssid, e->ssid) != 0) fail("ssid", index);
+        if(ap->rssi != e->rssi) fail("rssi", index);
+        if(ap->channel != e->channel) fail("channel", index);
+        if(ap->packetRxCount != e->rx) fail("received packets", index);
+        if(ap->packetTxCount != e->tx) fail("sent packets", index);
+    }
+
+    for(uint16_t rank = 1; rank < table->count; rank++) {
+        int8_t previous = access_points_get(table, access_points_at_rank(table, rank - 1))->rssi;
+        if(access_points_get(table, access_points_at_rank(table, rank))->rssi > previous) {
+            fail("order by RSSI", rank);
+        }
+    }
+}
+
+// The file gets a row each time an access point was added or changed since the last save,
+// the last row of each one must match the table
+static void check_csv(const AccessPointTable* table) {
+    FILE* f = fopen(CSV_PATH, "r");
+    if(!f) {
+        fail("CSV file", 0);
+        return;
+    }
+
+    static int last_rssi[MAX_ACCESS_POINTS];
+    static int last_channel[MAX_ACCESS_POINTS];
+    static bool found[MAX_ACCESS_POINTS];
+    char line[256];
+    uint32_t rows = 0;
+
+    // header
+    if(!fgets(line, sizeof(line), f) || strncmp(line, "WigleWifi-1.4", 13) != 0) {
+        fail("CSV header", 0);
+    }
+    if(!fgets(line, sizeof(line), f) || strncmp(line, "MAC,SSID,FirstSeen,Channel,RSSI", 31) != 0) {
+        fail("CSV columns", 0);
+    }
+
+    while(fgets(line, sizeof(line), f)) {
+        char bssid_str[MAX_BSSID_LENGTH], ssid[MAX_SSID_LENGTH + 1], date[32];
+        int channel, rssi;
+        uint8_t bssid[BSSID_SIZE];
+        rows++;
+
+        if(sscanf(line, "%17[^,],%32[^,],%31[^,],%d,%d,", bssid_str, ssid, date, &channel, &rssi) !=
+               5 ||
+           !access_points_parse_bssid(bssid_str, bssid)) {
+            fail("CSV row", rows);
+            continue;
+        }
+
+        uint16_t slot = access_points_find(table, bssid);
+        if(slot == AP_SLOT_NONE) {
+            fail("CSV row of an unknown access point", rows);
+            continue;
+        }
+
+        found[slot] = true;
+        last_rssi[slot] = rssi;
+        last_channel[slot] = channel;
+    }
+    fclose(f);
+
+    for(uint16_t slot = 0; slot < table->count; slot++) {
+        const AccessPoint* ap = access_points_get(table, slot);
+        if(!found[slot]) {
+            fail("access point not saved", slot);
+        } else if(last_rssi[slot] != ap->rssi || last_channel[slot] != ap->channel) {
+            fail("saved row out of date", slot);
+        }
+    }
+
+    printf("%u CSV rows for %u access points\n", rows, table->count);
+}
+
+int main(int argc, char** argv) {
+    size_t length;
+    char* log = argc > 1 ? load_log(argv[1], &length) : generate_log(&length);
+    if(!log) {
+        fprintf(stderr, "can't read %s\n", argv[1]);
+        return 1;
+    }
+
+    size_t log_heap = host_heap.current;
+
+    // what wardriver_app() sets up before starting the workers
+    Context* ctx = malloc(sizeof(Context));
+    access_points_init(&ctx->access_points);
+    ctx->view_state = NO_APS;
+    ctx->gps_data.latitude = NAN;
+    ctx->gps_data.longitude = NAN;
+    ctx->csv_path = host_string_alloc(CSV_PATH);
+    access_points_csv_create(CSV_PATH);
+
+    size_t lines = 0;
+    for(size_t i = 0; i < length; i++) {
+        if(log[i] == '\n') lines++;
+    }
+
+    replay_start(log, length, MAX_CHUNK, 1);
+    host_storage = (HostStorage){0};
+
+    double start = seconds();
+    uart_worker_esp(ctx);
+    double elapsed = seconds() - start - host_storage.seconds;
+    HostStorage periodic = host_storage;
+
+    // on exit and, to time the worst case, once more with every access point changed
+    access_points_csv_append(&ctx->access_points, CSV_PATH);
+    host_storage = (HostStorage){0};
+    for(uint16_t slot = 0; slot < ctx->access_points.count; slot++) {
+        access_points_set_dirty(&ctx->access_points, slot);
+    }
+    access_points_csv_append(&ctx->access_points, CSV_PATH);
+    HostStorage full = host_storage;
+
+    size_t heap = host_heap.peak - log_heap;
+
+    printf(
+        "%zu lines, %zu bytes (%.0f s at %d baud), %u access points\n",
+        lines,
+        length,
+        (double)length * UART_BYTE_US / 1e6,
+        UART_BAUD,
+        ctx->access_points.count);
+    printf(
+        "parse: %.2f M lines/s, %.1f MB/s, %.2f us/line\n",
+        lines / elapsed / 1e6,
+        length / elapsed / 1e6,
+        elapsed * 1e6 / lines);
+    printf(
+        "heap: %zu bytes peak (Context %zu, access point blocks and CSV buffer %zu)\n",
+        heap,
+        sizeof(Context),
+        heap - sizeof(Context));
+    printf(
+        "periodic saves: %u, %.1f KB each, %.3f ms average, %.3f ms max\n",
+        periodic.saves,
+        periodic.saves ? periodic.bytes / 1024.0 / periodic.saves : 0,
+        periodic.saves ? periodic.seconds * 1000 / periodic.saves : 0,
+        periodic.max_seconds * 1000);
+    printf(
+        "save of all %u access points: %.1f KB, %.3f ms\n",
+        ctx->access_points.count,
+        full.bytes / 1024.0,
+        full.seconds * 1000);
+
+    if(argc == 1) {
+        check_table(&ctx->access_points);
+        check_csv(&ctx->access_points);
+
+        if(failures) {
+            printf("FAILED: %u checks\n", failures);
+            return 1;
+        }
+        printf("OK\n");
+    }
+
+    access_points_free(&ctx->access_points);
+    free(ctx);
+    host_free(log);
+    return 0;
+}
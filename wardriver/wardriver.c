@@ -1,14 +1,13 @@
 #include "wardriver.h"
 #include "wardriver_uart.h"
+#include "wardriver_access_points.h"
 
-void save_file(Context* ctx) {
-    Storage* storage = furi_record_open(RECORD_STORAGE);
+static void create_file(Context* ctx) {
     FuriHalRtcDateTime datetime;
     furi_hal_rtc_get_datetime(&datetime);
 
-    FuriString* filename = furi_string_alloc();
     furi_string_printf(
-        filename,
+        ctx->csv_path,
         "%s/%s_%d_%d_%d_%d_%d_%d.txt",
         FILE_PATH,
         "wigle",
@@ -19,89 +18,16 @@ void save_file(Context* ctx) {
         datetime.minute,
         datetime.second);
 
-    File* file = storage_file_alloc(storage);
-
-    if(!storage_common_exists(storage, FILE_PATH)) {
-        storage_common_mkdir(storage, FILE_PATH);
-    }
-
-    if(!storage_file_open(file, furi_string_get_cstr(filename), FSAM_WRITE, FSOM_OPEN_ALWAYS)) {
-        FURI_LOG_I(appname, "Failed to open file");
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_string_free(filename);
-        furi_record_close(RECORD_STORAGE);
-
+    if(!access_points_csv_create(furi_string_get_cstr(ctx->csv_path))) {
         furi_hal_light_blink_start(LightRed, 100, 100, 5000);
-
-        return;
     }
+    ctx->last_save = furi_get_tick();
+}
 
-    furi_string_reset(ctx->buffer);
-
-    // WIGLE HEADERS DONT CHANGE THIS ITS IMPORTANT!
-    furi_string_printf(
-        ctx->buffer,
-        "%s,%s,%s,%s,%s,%s,%s,%s\r\n",
-        "WigleWifi-1.4",
-        "appRelease=v2.0",
-        "model=S33",
-        "release=XtremeFW",
-        "Flipper Zero",
-        "",
-        "Wardriver",
-        "S33");
-
-    furi_string_cat_printf(
-        ctx->buffer,
-        "%s,%s,%s,%s,%s,%s,%s\r\n",
-        "MAC",
-        "SSID",
-        "FirstSeen",
-        "Channel",
-        "RSSI",
-        "CurrentLatitude",
-        "CurrentLongitude");
-    if(!storage_file_write(
-           file, furi_string_get_cstr(ctx->buffer), strlen(furi_string_get_cstr(ctx->buffer)))) {
-        FURI_LOG_I(appname, "Failed to write header to file");
-    }
-
-    for(int i = 0; i < ctx->access_points_count; i++) {
-        AccessPoint ap = ctx->access_points[i];
-        furi_string_printf(
-            ctx->buffer,
-            "%s,%s,%04d-%02d-%02d %02d:%02d:%02d,%d,%d,%f,%f\r\n",
-            ap.bssid,
-            ap.ssid,
-            ap.datetime.year,
-            ap.datetime.month,
-            ap.datetime.day,
-            ap.datetime.hour,
-            ap.datetime.minute,
-            ap.datetime.second,
-            ap.rssi,
-            ap.channel,
-            (double)ap.latitude,
-            (double)ap.longitude);
-
-        if(!storage_file_write(
-               file,
-               furi_string_get_cstr(ctx->buffer),
-               strlen(furi_string_get_cstr(ctx->buffer)))) {
-            FURI_LOG_I(appname, "Failed to write AP to file");
-        }
-
-        free(ap.ssid);
-        free(ap.bssid);
+static void save_file(Context* ctx) {
+    if(!access_points_csv_append(&ctx->access_points, furi_string_get_cstr(ctx->csv_path))) {
+        furi_hal_light_blink_start(LightRed, 100, 100, 5000);
     }
-
-    storage_file_close(file);
-    storage_file_free(file);
-    furi_string_free(filename);
-    furi_record_close(RECORD_STORAGE);
-
-    return;
 }
 
 static void tick_callback(void* ctx_q) {
@@ -120,13 +46,15 @@ static void input_callback(InputEvent* input_event, FuriMessageQueue* queue) {
 static void draw_access_point(Canvas* canvas, Context* context) {
     Context* ctx = context;
 
-    AccessPoint ap = ctx->active_access_point;
+    AccessPoint ap = *access_points_get(&ctx->access_points, ctx->active_slot);
+    char bssid[MAX_BSSID_LENGTH];
+    access_points_format_bssid(ap.bssid, bssid);
 
     canvas_draw_str_aligned(canvas, 62, 25, AlignCenter, AlignBottom, ap.ssid);
 
     canvas_set_font(canvas, FontSecondary);
 
-    canvas_draw_str_aligned(canvas, 38, 12, AlignLeft, AlignBottom, ap.bssid);
+    canvas_draw_str_aligned(canvas, 38, 12, AlignLeft, AlignBottom, bssid);
 
     furi_string_printf(ctx->buffer, "Signal strength: %ddBm", ap.rssi);
     canvas_draw_str_aligned(
@@ -162,7 +90,7 @@ static void render_callback(Canvas* canvas, void* context) {
 
     canvas_set_font(canvas, FontPrimary);
 
-    if(ctx->access_points_count >= MAX_ACCESS_POINTS) {
+    if(ctx->access_points.count >= MAX_ACCESS_POINTS) {
         canvas_draw_str(canvas, 118, 10, "!");
     }
 
@@ -214,8 +142,12 @@ static void render_callback(Canvas* canvas, void* context) {
     default:
         canvas_draw_frame(canvas, 0, 0, 128, 64);
 
+        if(ctx->access_points.count == 0) {
+            break;
+        }
+
         furi_string_printf(
-            ctx->buffer, "%d/%d", ctx->access_points_index + 1, ctx->access_points_count);
+            ctx->buffer, "%d/%d", ctx->access_points_index + 1, ctx->access_points.count);
 
         canvas_draw_str(canvas, 3, 12, furi_string_get_cstr(ctx->buffer));
 
@@ -244,11 +176,15 @@ int32_t wardriver_app() {
     ctx->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     ctx->buffer = furi_string_alloc();
 
-    ctx->access_points_count = 0;
+    access_points_init(&ctx->access_points);
     ctx->access_points_index = 0;
+    ctx->active_slot = 0;
     ctx->pressedButton = false;
     ctx->view_state = NO_APS;
 
+    ctx->csv_path = furi_string_alloc();
+    create_file(ctx);
+
     wardriver_uart_init(ctx);
 
     ViewPort* view_port = view_port_alloc();
@@ -282,19 +218,25 @@ int32_t wardriver_app() {
                         processing = false;
                     }
                 } else if(event.input.type == InputTypeLong && event.input.key == InputKeyOk) {
-                } else if(event.input.type == InputTypePress && event.input.key == InputKeyDown) {
+                } else if(
+                    event.input.type == InputTypePress && event.input.key == InputKeyDown &&
+                    ctx->access_points.count > 0) {
                     ctx->access_points_index--;
                     if(ctx->access_points_index < 0) {
-                        ctx->access_points_index = ctx->access_points_count - 1;
+                        ctx->access_points_index = ctx->access_points.count - 1;
                     }
-                    ctx->active_access_point = ctx->access_points[ctx->access_points_index];
+                    ctx->active_slot =
+                        access_points_at_rank(&ctx->access_points, ctx->access_points_index);
                     ctx->pressedButton = true;
-                } else if(event.input.type == InputTypePress && event.input.key == InputKeyUp) {
+                } else if(
+                    event.input.type == InputTypePress && event.input.key == InputKeyUp &&
+                    ctx->access_points.count > 0) {
                     ctx->access_points_index++;
-                    if(ctx->access_points_index >= ctx->access_points_count) {
+                    if(ctx->access_points_index >= ctx->access_points.count) {
                         ctx->access_points_index = 0;
                     }
-                    ctx->active_access_point = ctx->access_points[ctx->access_points_index];
+                    ctx->active_slot =
+                        access_points_at_rank(&ctx->access_points, ctx->access_points_index);
                     ctx->pressedButton = true;
                 } else if(event.input.type == InputTypePress && event.input.key == InputKeyLeft) {
                     if(ctx->view_state == NORMAL) {
@@ -307,9 +249,9 @@ int32_t wardriver_app() {
                 break;
             case EventTypeTick:
                 // fix for the empty active access point when there was no interaction
-                if(!ctx->pressedButton) {
+                if(!ctx->pressedButton && ctx->access_points.count > 0) {
                     ctx->access_points_index = 0;
-                    ctx->active_access_point = ctx->access_points[ctx->access_points_index];
+                    ctx->active_slot = access_points_at_rank(&ctx->access_points, 0);
                 }
 
                 break;
@@ -329,14 +271,16 @@ int32_t wardriver_app() {
     view_port_free(view_port);
     furi_record_close(RECORD_GUI);
 
-    furi_message_queue_free(ctx->queue);
-    furi_mutex_free(ctx->mutex);
-    furi_string_free(ctx->buffer);
-
     wardriver_uart_deinit(ctx);
 
     save_file(ctx);
 
+    furi_message_queue_free(ctx->queue);
+    furi_mutex_free(ctx->mutex);
+    furi_string_free(ctx->buffer);
+    furi_string_free(ctx->csv_path);
+    access_points_free(&ctx->access_points);
+
     free(ctx);
 
     furi_hal_light_set(LightBlue, 0);
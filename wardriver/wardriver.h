@@ -18,6 +18,18 @@
 
 #define MAX_SSID_LENGTH 32
 #define MAX_BSSID_LENGTH 18
+#define BSSID_SIZE 6
+
+// Access points are stored in blocks allocated on demand
+#define AP_BLOCK_SIZE 64
+#define AP_BLOCK_COUNT (MAX_ACCESS_POINTS / AP_BLOCK_SIZE)
+// Open addressing hash table, kept at most half full
+#define AP_HASH_SIZE (MAX_ACCESS_POINTS * 2)
+#define AP_SLOT_NONE 0xFFFF
+
+// New and changed access points are appended to the CSV file this often
+#define SAVE_INTERVAL_MS 30000
+#define CSV_BUFFER_SIZE 1024
 
 #define FILE_PATH EXT_PATH("apps_data/ll-wardriver")
 
@@ -34,13 +46,8 @@ typedef struct {
 typedef enum { SHOW_NMEA, NORMAL, NO_APS } ViewState;
 
 typedef struct {
-    char* recievedMac;
-    char* sentMac;
-} Packet;
-
-typedef struct {
-    char* ssid;
-    char* bssid;
+    char ssid[MAX_SSID_LENGTH + 1];
+    uint8_t bssid[BSSID_SIZE];
     int8_t rssi;
     uint8_t channel;
     FuriHalRtcDateTime datetime;
@@ -50,6 +57,17 @@ typedef struct {
     float longitude;
 } AccessPoint;
 
+typedef struct {
+    uint16_t count;
+    AccessPoint* blocks[AP_BLOCK_COUNT];
+    // BSSID hash -> slot
+    uint16_t hash[AP_HASH_SIZE];
+    // slots ordered by RSSI, strongest first
+    uint16_t order[MAX_ACCESS_POINTS];
+    // slots not saved to the CSV file since they have been added or changed
+    uint32_t dirty[MAX_ACCESS_POINTS / 32];
+} AccessPointTable;
+
 typedef struct {
     float latitude;
     float longitude;
@@ -72,13 +90,15 @@ typedef struct {
     FuriStreamBuffer* rx_stream_gps;
     uint8_t rx_buf_gps[2048];
 
-    uint16_t access_points_count;
-    AccessPoint access_points[MAX_ACCESS_POINTS];
+    AccessPointTable access_points;
     int16_t access_points_index;
-    AccessPoint active_access_point;
+    uint16_t active_slot;
     bool extra_info;
     bool pressedButton;
 
     ViewState view_state;
     GpsData gps_data;
+
+    FuriString* csv_path;
+    uint32_t last_save;
 } Context;
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "wardriver_access_points.h"
+
+static uint16_t bssid_hash(const uint8_t* bssid) {
+    uint32_t hash = 2166136261UL;
+    for(size_t i = 0; i < BSSID_SIZE; i++) {
+        hash = (hash ^ bssid[i]) * 16777619UL;
+    }
+    return hash & (AP_HASH_SIZE - 1);
+}
+
+static int hex_value(char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void access_points_init(AccessPointTable* table) {
+    table->count = 0;
+    memset(table->blocks, 0, sizeof(table->blocks));
+    memset(table->hash, 0xFF, sizeof(table->hash));
+    memset(table->dirty, 0, sizeof(table->dirty));
+}
+
+void access_points_free(AccessPointTable* table) {
+    for(size_t i = 0; i < AP_BLOCK_COUNT; i++) {
+        if(table->blocks[i]) {
+            free(table->blocks[i]);
+            table->blocks[i] = NULL;
+        }
+    }
+    table->count = 0;
+}
+
+AccessPoint* access_points_get(const AccessPointTable* table, uint16_t slot) {
+    return &table->blocks[slot / AP_BLOCK_SIZE][slot % AP_BLOCK_SIZE];
+}
+
+uint16_t access_points_find(const AccessPointTable* table, const uint8_t* bssid) {
+    uint16_t i = bssid_hash(bssid);
+    while(table->hash[i] != AP_SLOT_NONE) {
+        uint16_t slot = table->hash[i];
+        if(memcmp(access_points_get(table, slot)->bssid, bssid, BSSID_SIZE) == 0) {
+            return slot;
+        }
+        i = (i + 1) & (AP_HASH_SIZE - 1);
+    }
+    return AP_SLOT_NONE;
+}
+
+// first position in the first n entries of the order that does not come before slot/rssi
+static uint16_t order_lower_bound(
+    const AccessPointTable* table,
+    uint16_t n,
+    uint16_t slot,
+    int8_t rssi) {
+    uint16_t low = 0;
+    uint16_t high = n;
+    while(low < high) {
+        uint16_t mid = (low + high) / 2;
+        uint16_t other = table->order[mid];
+        int8_t other_rssi = access_points_get(table, other)->rssi;
+        if(other_rssi > rssi || (other_rssi == rssi && other < slot)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void order_insert(AccessPointTable* table, uint16_t n, uint16_t slot) {
+    uint16_t pos = order_lower_bound(table, n, slot, access_points_get(table, slot)->rssi);
+    memmove(&table->order[pos + 1], &table->order[pos], (n - pos) * sizeof(uint16_t));
+    table->order[pos] = slot;
+}
+
+uint16_t access_points_add(AccessPointTable* table, const AccessPoint* ap) {
+    if(table->count >= MAX_ACCESS_POINTS) {
+        return AP_SLOT_NONE;
+    }
+
+    uint16_t slot = table->count;
+    AccessPoint** block = &table->blocks[slot / AP_BLOCK_SIZE];
+    if(*block == NULL) {
+        *block = malloc(sizeof(AccessPoint) * AP_BLOCK_SIZE);
+    }
+    memcpy(access_points_get(table, slot), ap, sizeof(AccessPoint));
+
+    uint16_t i = bssid_hash(ap->bssid);
+    while(table->hash[i] != AP_SLOT_NONE) {
+        i = (i + 1) & (AP_HASH_SIZE - 1);
+    }
+    table->hash[i] = slot;
+
+    order_insert(table, table->count, slot);
+    table->count++;
+
+    access_points_set_dirty(table, slot);
+    return slot;
+}
+
+void access_points_set_rssi(AccessPointTable* table, uint16_t slot, int8_t rssi) {
+    AccessPoint* ap = access_points_get(table, slot);
+    if(ap->rssi == rssi) {
+        return;
+    }
+
+    // move the slot to its new place in the order
+    uint16_t pos = access_points_rank(table, slot);
+    memmove(
+        &table->order[pos],
+        &table->order[pos + 1],
+        (table->count - pos - 1) * sizeof(uint16_t));
+    ap->rssi = rssi;
+    order_insert(table, table->count - 1, slot);
+}
+
+void access_points_set_dirty(AccessPointTable* table, uint16_t slot) {
+    table->dirty[slot / 32] |= 1UL << (slot % 32);
+}
+
+uint16_t access_points_rank(const AccessPointTable* table, uint16_t slot) {
+    return order_lower_bound(table, table->count, slot, access_points_get(table, slot)->rssi);
+}
+
+uint16_t access_points_at_rank(const AccessPointTable* table, uint16_t rank) {
+    return table->order[rank];
+}
+
+bool access_points_parse_bssid(const char* str, uint8_t* bssid) {
+    for(size_t i = 0; i < BSSID_SIZE; i++) {
+        const char* byte = &str[i * 3];
+        int high = hex_value(byte[0]);
+        if(high < 0) return false;
+        int low = hex_value(byte[1]);
+        if(low < 0) return false;
+
+        if(i < BSSID_SIZE - 1 ? byte[2] != ':' : (byte[2] != '\0' && byte[2] != '\r')) {
+            return false;
+        }
+
+        bssid[i] = (high << 4) | low;
+    }
+    return true;
+}
+
+void access_points_format_bssid(const uint8_t* bssid, char* str) {
+    snprintf(
+        str,
+        MAX_BSSID_LENGTH,
+        "%02x:%02x:%02x:%02x:%02x:%02x",
+        bssid[0],
+        bssid[1],
+        bssid[2],
+        bssid[3],
+        bssid[4],
+        bssid[5]);
+}
+
+bool access_points_csv_create(const char* path) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    if(!storage_common_exists(storage, FILE_PATH)) {
+        storage_common_mkdir(storage, FILE_PATH);
+    }
+
+    File* file = storage_file_alloc(storage);
+    bool success = false;
+
+    if(storage_file_open(file, path, FSAM_WRITE, FSOM_OPEN_ALWAYS)) {
+        // WIGLE HEADERS DONT CHANGE THIS ITS IMPORTANT!
+        const char* header = "WigleWifi-1.4,appRelease=v2.0,model=S33,release=XtremeFW,"
+                             "Flipper Zero,,Wardriver,S33\r\n"
+                             "MAC,SSID,FirstSeen,Channel,RSSI,CurrentLatitude,CurrentLongitude\r\n";
+        success = storage_file_write(file, header, strlen(header)) == strlen(header);
+    }
+
+    if(!success) {
+        FURI_LOG_I(appname, "Failed to write header to file");
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return success;
+}
+
+// rows of the slots in [from, to) reached the file
+static void access_points_clear_dirty(AccessPointTable* table, uint16_t from, uint16_t to) {
+    for(uint16_t slot = from; slot < to; slot++) {
+        table->dirty[slot / 32] &= ~(1UL << (slot % 32));
+    }
+}
+
+bool access_points_csv_append(AccessPointTable* table, const char* path) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+
+    if(!storage_file_open(file, path, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        FURI_LOG_I(appname, "Failed to open file");
+        storage_file_close(file);
+        storage_file_free(file);
+        furi_record_close(RECORD_STORAGE);
+        return false;
+    }
+
+    char* buffer = malloc(CSV_BUFFER_SIZE);
+    size_t length = 0;
+    bool success = true;
+    char bssid[MAX_BSSID_LENGTH];
+    // dirty bits are only cleared once the buffer holding the rows is written, so failed rows
+    // are retried on the next append
+    uint16_t buffer_start = 0;
+    uint16_t count = table->count;
+
+    for(uint16_t slot = 0; slot < count; slot++) {
+        if(!(table->dirty[slot / 32] & (1UL << (slot % 32)))) {
+            continue;
+        }
+
+        const AccessPoint* ap = access_points_get(table, slot);
+        access_points_format_bssid(ap->bssid, bssid);
+
+        // a line is well below the buffer size, flush before it may not fit
+        if(length > CSV_BUFFER_SIZE - (MAX_SSID_LENGTH + 128)) {
+            success = storage_file_write(file, buffer, length) == length;
+            if(!success) break;
+            access_points_clear_dirty(table, buffer_start, slot);
+            buffer_start = slot;
+            length = 0;
+        }
+
+        length += snprintf(
+            &buffer[length],
+            CSV_BUFFER_SIZE - length,
+            "%s,%s,%04d-%02d-%02d %02d:%02d:%02d,%d,%d,%f,%f\r\n",
+            bssid,
+            ap->ssid,
+            ap->datetime.year,
+            ap->datetime.month,
+            ap->datetime.day,
+            ap->datetime.hour,
+            ap->datetime.minute,
+            ap->datetime.second,
+            ap->channel,
+            ap->rssi,
+            (double)ap->latitude,
+            (double)ap->longitude);
+    }
+
+    if(success && length > 0) {
+        success = storage_file_write(file, buffer, length) == length;
+        if(success) access_points_clear_dirty(table, buffer_start, count);
+    }
+
+    if(!success) {
+        FURI_LOG_I(appname, "Failed to write APs to file");
+    }
+
+    free(buffer);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return success;
+}
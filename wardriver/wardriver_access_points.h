@@ -0,0 +1,21 @@
+#pragma once
+
+#include "wardriver.h"
+
+void access_points_init(AccessPointTable* table);
+void access_points_free(AccessPointTable* table);
+
+AccessPoint* access_points_get(const AccessPointTable* table, uint16_t slot);
+uint16_t access_points_find(const AccessPointTable* table, const uint8_t* bssid);
+uint16_t access_points_add(AccessPointTable* table, const AccessPoint* ap);
+void access_points_set_rssi(AccessPointTable* table, uint16_t slot, int8_t rssi);
+void access_points_set_dirty(AccessPointTable* table, uint16_t slot);
+
+uint16_t access_points_rank(const AccessPointTable* table, uint16_t slot);
+uint16_t access_points_at_rank(const AccessPointTable* table, uint16_t rank);
+
+bool access_points_parse_bssid(const char* str, uint8_t* bssid);
+void access_points_format_bssid(const uint8_t* bssid, char* str);
+
+bool access_points_csv_create(const char* path);
+bool access_points_csv_append(AccessPointTable* table, const char* path);
@@ -1,4 +1,5 @@
 #include "wardriver_uart.h"
+#include "wardriver_access_points.h"
 
 static void removeSpaces(char* str) {
     int i = 0;
@@ -18,183 +19,126 @@ static void removeSpaces(char* str) {
     }
 }
 
-static void sort_access_points(Context* ctx) {
-    for(int i = 0; i < ctx->access_points_count; i++) {
-        for(int j = i + 1; j < ctx->access_points_count; j++) {
-            if(strcmp(ctx->access_points[i].ssid, ctx->access_points[j].ssid) > 0) {
-                AccessPoint temp = ctx->access_points[i];
-                ctx->access_points[i] = ctx->access_points[j];
-                ctx->access_points[j] = temp;
-            }
-        }
+// split the next comma separated field off the line, returns NULL when there are no fields left
+static char* next_field(char** line) {
+    char* field = *line;
+    if(field == NULL) {
+        return NULL;
     }
-}
 
-static void set_index_from_access_points(Context* ctx) {
-    for(int i = 0; i < ctx->access_points_count; i++) {
-        if(ctx->access_points[i].bssid == ctx->active_access_point.bssid) {
-            ctx->access_points_index = i;
-            break;
-        }
+    char* comma = strchr(field, ',');
+    if(comma) {
+        *comma = '\0';
+        *line = comma + 1;
+    } else {
+        *line = NULL;
     }
+    return field;
 }
 
-static void uart_parse_esp(void* context, char* line) {
-    Context* ctx = context;
-
-    AccessPoint ap = {.ssid = malloc(MAX_SSID_LENGTH + 1), .bssid = malloc(MAX_BSSID_LENGTH + 1)};
+static void uart_parse_ap(Context* ctx, char* line) {
+    AccessPointTable* table = &ctx->access_points;
+    AccessPoint ap = {0};
 
-    Packet pkt = {.recievedMac = malloc(18 + 1), .sentMac = malloc(18 + 1)};
+    char* ssid = next_field(&line);
+    char* bssid = next_field(&line);
+    char* rssi = next_field(&line);
+    char* channel = next_field(&line);
 
-    char* token = strtok(line, ",");
-    int i = 0;
-    bool isAp = false;
-    bool isValid = false;
-    while(token != NULL) {
-        switch(i) {
-        case 0:
-            if(strcmp(token, "AR") == 0) {
-                isAp = true;
-                isValid = true;
-            } else if(strcmp(token, "PK") == 0) {
-                isValid = true;
-            }
-            break;
-        case 1:
-            if(isAp && isValid) {
-                removeSpaces(token);
-                strcpy(ap.ssid, token);
-            } else if(!isAp && isValid) {
-                strncpy(pkt.recievedMac, token, 18);
-                pkt.recievedMac[18] = '\0';
-            }
-            break;
-        case 2:
-            if(isAp && isValid) {
-                strcpy(ap.bssid, token);
-            } else if(!isAp && isValid) {
-                strncpy(pkt.sentMac, token, 18);
-                pkt.sentMac[18] = '\0';
-            }
-            break;
-        case 3:
-            if(isAp && isValid) {
-                ap.rssi = atoi(token);
-            }
-            break;
-        case 4:
-            if(isAp && isValid) {
-                ap.channel = atoi(token);
-            }
-            break;
-        }
-
-        token = strtok(NULL, ",");
-        i++;
+    if(ctx->view_state == NO_APS) {
+        ctx->view_state = NORMAL;
     }
 
-    if(isAp && isValid) {
-        // free the packet
-        free(pkt.recievedMac);
-        free(pkt.sentMac);
+    if(!ssid || !bssid || !rssi || !channel) {
+        return;
+    }
 
-        if(ctx->view_state == NO_APS) {
-            ctx->view_state = NORMAL;
-        }
+    removeSpaces(ssid);
+    strlcpy(ap.ssid, ssid, sizeof(ap.ssid));
+    int rssi_value = atoi(rssi);
+    int channel_value = atoi(channel);
+
+    // check if values are valid
+    // bssid needs to be 6 hex bytes separated by ":"
+    // rssi needs to be negative
+    // channel needs to be between 1 and 14
+    // ssid needs to be at least 1 character long
+    if(!access_points_parse_bssid(bssid, ap.bssid) || rssi_value > 0 || rssi_value < INT8_MIN ||
+       channel_value < 1 || channel_value > 14 || strlen(ap.ssid) < 1) {
+        return;
+    }
+    ap.rssi = rssi_value;
+    ap.channel = channel_value;
 
-        // check if values are valid
-        // bssid needs an ":"
-        // rssi needs to be negative
-        // channel needs to be between 1 and 14
-        // ssid needs to be at least 1 character long
-        if(ap.bssid[2] != ':' || ap.bssid[5] != ':' || ap.bssid[8] != ':' || ap.bssid[11] != ':' ||
-           ap.bssid[14] != ':' || ap.rssi > 0 || ap.channel < 1 || ap.channel > 14 ||
-           strlen(ap.ssid) < 1) {
-            free(ap.ssid);
-            free(ap.bssid);
-            return;
-        }
+    furi_hal_light_set(LightBlue, 0);
+    furi_hal_light_set(LightGreen, 255);
 
-        furi_hal_light_set(LightBlue, 0);
-        furi_hal_light_set(LightGreen, 255);
+    furi_hal_rtc_get_datetime(&ap.datetime);
 
-        furi_hal_rtc_get_datetime(&ap.datetime);
+    if(isnan(ctx->gps_data.latitude) || isnan(ctx->gps_data.longitude)) {
+        ap.latitude = 0;
+        ap.longitude = 0;
+    } else {
+        ap.latitude = ctx->gps_data.latitude;
+        ap.longitude = ctx->gps_data.longitude;
+    }
 
-        if(isnan(ctx->gps_data.latitude) || isnan(ctx->gps_data.longitude)) {
-            ap.latitude = 0;
-            ap.longitude = 0;
-        } else {
-            ap.latitude = ctx->gps_data.latitude;
-            ap.longitude = ctx->gps_data.longitude;
-        }
+    // check if ap is already in the list otherwise add it but update the rssi
+    uint16_t slot = access_points_find(table, ap.bssid);
+    if(slot != AP_SLOT_NONE) {
+        AccessPoint* found = access_points_get(table, slot);
+        access_points_set_rssi(table, slot, ap.rssi);
+        found->channel = ap.channel;
+        found->datetime = ap.datetime;
+        found->latitude = ap.latitude;
+        found->longitude = ap.longitude;
+        access_points_set_dirty(table, slot);
+    } else if(access_points_add(table, &ap) == AP_SLOT_NONE) {
+        return;
+    }
 
-        // check if ap is already in the list otherwise add it but update the rssi
-        bool found = false;
-        for(size_t i = 0; i < ctx->access_points_count; i++) {
-            if(strcmp(ctx->access_points[i].bssid, ap.bssid) == 0) {
-                found = true;
-                //update rssi channel datetime
-                ctx->access_points[i].rssi = ap.rssi;
-                ctx->access_points[i].channel = ap.channel;
-                ctx->access_points[i].datetime = ap.datetime;
-                ctx->access_points[i].latitude = ap.latitude;
-                ctx->access_points[i].longitude = ap.longitude;
-
-                if(strcmp(ctx->active_access_point.bssid, ap.bssid) == 0) {
-                    ctx->active_access_point.rssi = ap.rssi;
-                    ctx->active_access_point.channel = ap.channel;
-                    ctx->active_access_point.datetime = ap.datetime;
-                    ctx->active_access_point.latitude = ap.latitude;
-                    ctx->active_access_point.longitude = ap.longitude;
-                }
+    if(table->count > 0) {
+        ctx->access_points_index = access_points_rank(table, ctx->active_slot);
+    }
+}
 
-                free(ap.ssid);
-                free(ap.bssid);
+static void uart_parse_packet(Context* ctx, char* line) {
+    AccessPointTable* table = &ctx->access_points;
+    uint8_t received[BSSID_SIZE];
+    uint8_t sent[BSSID_SIZE];
 
-                break;
-            }
-        }
+    char* received_mac = next_field(&line);
+    char* sent_mac = next_field(&line);
 
-        if(!found) {
-            memcpy(&ctx->access_points[ctx->access_points_count], &ap, sizeof(AccessPoint));
-            ctx->access_points_count++;
-        }
+    // check if values are valid
+    // macs need to be 6 hex bytes separated by ":"
+    if(!received_mac || !sent_mac || !access_points_parse_bssid(received_mac, received) ||
+       !access_points_parse_bssid(sent_mac, sent) || table->count == 0) {
+        return;
+    }
 
-        sort_access_points(ctx);
-        set_index_from_access_points(ctx);
-    } else {
-        // it is a packet so screw the ap
-        free(ap.ssid);
-        free(ap.bssid);
-
-        // check if values are valid
-        // mac needs to be 6 characters long
-        if(strlen(pkt.recievedMac) != 17 || strlen(pkt.sentMac) != 17 ||
-           ctx->access_points_count == 0) {
-            free(pkt.recievedMac);
-            free(pkt.sentMac);
-            return;
-        }
+    furi_hal_light_set(LightGreen, 0);
+    furi_hal_light_set(LightBlue, 255);
 
-        furi_hal_light_set(LightGreen, 0);
-        furi_hal_light_set(LightBlue, 255);
+    uint16_t slot = access_points_find(table, received);
+    if(slot != AP_SLOT_NONE) {
+        access_points_get(table, slot)->packetRxCount++;
+    }
 
-        for(size_t i = 0; i < ctx->access_points_count; i++) {
-            if(strcmp(ctx->access_points[i].bssid, pkt.recievedMac) == 0) {
-                ctx->access_points[i].packetRxCount++;
-                break;
-            }
-        }
+    slot = access_points_find(table, sent);
+    if(slot != AP_SLOT_NONE) {
+        access_points_get(table, slot)->packetTxCount++;
+    }
+}
 
-        for(size_t i = 0; i < ctx->access_points_count; i++) {
-            if(strcmp(ctx->access_points[i].bssid, pkt.sentMac) == 0) {
-                ctx->access_points[i].packetTxCount++;
-                break;
-            }
-        }
+static void uart_parse_esp(void* context, char* line) {
+    Context* ctx = context;
 
-        free(pkt.recievedMac);
-        free(pkt.sentMac);
+    char* type = next_field(&line);
+    if(strcmp(type, "AR") == 0) {
+        uart_parse_ap(ctx, line);
+    } else if(strcmp(type, "PK") == 0) {
+        uart_parse_packet(ctx, line);
     }
 }
 
@@ -213,14 +157,23 @@ static int32_t uart_worker_esp(void* context) {
     size_t rx_offset = 0;
 
     while(1) {
-        uint32_t events =
-            furi_thread_flags_wait(WORKER_ALL_RX_EVENTS, FuriFlagWaitAny, FuriWaitForever);
+        uint32_t events = furi_thread_flags_wait(
+            WORKER_ALL_RX_EVENTS, FuriFlagWaitAny, furi_ms_to_ticks(SAVE_INTERVAL_MS));
+        if(events == (uint32_t)FuriFlagErrorTimeout) {
+            // no data for a while, still save what has been collected
+            events = 0;
+        }
         furi_check((events & FuriFlagError) == 0);
 
         if(events & WorkerEvtStop) {
             break;
         }
 
+        if(furi_get_tick() - ctx->last_save >= furi_ms_to_ticks(SAVE_INTERVAL_MS)) {
+            access_points_csv_append(&ctx->access_points, furi_string_get_cstr(ctx->csv_path));
+            ctx->last_save = furi_get_tick();
+        }
+
         if(events & WorkerEvtRxDone) {
             size_t len = 0;
             do {
@@ -409,7 +362,7 @@ void wardriver_uart_init(Context* ctx) {
 
     ctx->thread_esp = furi_thread_alloc();
     furi_thread_set_name(ctx->thread_esp, "LLwardriverUartWorkerESP");
-    furi_thread_set_stack_size(ctx->thread_esp, 2048);
+    furi_thread_set_stack_size(ctx->thread_esp, 3072);
     furi_thread_set_context(ctx->thread_esp, ctx);
     furi_thread_set_callback(ctx->thread_esp, uart_worker_esp);
 
@@ -0,0 +1,200 @@
+// Encodes a synthetic signal to IMA ADPCM, checks that wav_adpcm_decode_block
+// reconstructs exactly what the encoder predicted, full and short blocks, mono
+// and stereo, and measures decoding speed.
+//
+//   make -C wav_player/test run
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../wav_adpcm.h"
+
+#define SAMPLE_RATE 22050
+#define BLOCK_ALIGN_MONO 256
+#define BLOCK_ALIGN_STEREO 512
+#define BLOCK_MAX_SAMPLES 1024
+#define BENCH_MIN_S 0.5
+
+static const int8_t index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+static const int16_t step_table[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+typedef struct {
+    int32_t predictor;
+    int32_t index;
+} Encoder;
+
+// Standard IMA encoder, returns the nibble and leaves the decoded value in the predictor
+static uint8_t encode_sample(Encoder* encoder, int16_t sample) {
+    int32_t step = step_table[encoder->index];
+    int32_t diff = sample - encoder->predictor;
+    uint8_t nibble = 0;
+    if(diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+
+    int32_t delta = step >> 3;
+    if(diff >= step) {
+        nibble |= 4;
+        diff -= step;
+        delta += step;
+    }
+    if(diff >= step >> 1) {
+        nibble |= 2;
+        diff -= step >> 1;
+        delta += step >> 1;
+    }
+    if(diff >= step >> 2) {
+        nibble |= 1;
+        delta += step >> 2;
+    }
+
+    encoder->predictor += nibble & 8 ? -delta : delta;
+    if(encoder->predictor > INT16_MAX) encoder->predictor = INT16_MAX;
+    if(encoder->predictor < INT16_MIN) encoder->predictor = INT16_MIN;
+    encoder->index += index_table[nibble];
+    if(encoder->index < 0) encoder->index = 0;
+    if(encoder->index > 88) encoder->index = 88;
+    return nibble;
+}
+
+// Tone with noise and clipped bursts to push the step index to both ends
+static int16_t signal(size_t channel, size_t i) {
+    double t = (double)i / SAMPLE_RATE;
+    double v = 0.6 * sin(2 * M_PI * 440 * t * (1 + channel * 0.5));
+    v += 0.3 * sin(2 * M_PI * 3000 * t);
+    v += (rand() / (double)RAND_MAX - 0.5) * 0.2;
+    if(i % 5000 < 50) v = i & 1 ? 1.2 : -1.2;
+    if(v > 1) v = 1;
+    if(v < -1) v = -1;
+    return v * INT16_MAX;
+}
+
+// Encodes samples_count samples per channel starting at position into one block, the
+// expected decoder output goes to expected. Returns the block size in bytes.
+static size_t encode_block(
+    Encoder* encoders,
+    uint16_t channels,
+    size_t position,
+    size_t samples_count,
+    uint8_t* block,
+    int16_t* expected) {
+    uint8_t* out = block;
+    int16_t first[2];
+    for(size_t c = 0; c < channels; c++) {
+        first[c] = signal(c, position);
+        encoders[c].predictor = first[c];
+        *out++ = first[c] & 0xFF;
+        *out++ = (uint16_t)first[c] >> 8;
+        *out++ = encoders[c].index;
+        *out++ = 0;
+    }
+    *expected++ = channels == 1 ? first[0] : first[0] / 2 + first[1] / 2;
+
+    int16_t decoded[2][8];
+    for(size_t i = 1; i < samples_count; i += 8) {
+        for(size_t c = 0; c < channels; c++) {
+            for(size_t j = 0; j < 8; j += 2) {
+                uint8_t lo = encode_sample(&encoders[c], signal(c, position + i + j));
+                decoded[c][j] = encoders[c].predictor;
+                uint8_t hi = encode_sample(&encoders[c], signal(c, position + i + j + 1));
+                decoded[c][j + 1] = encoders[c].predictor;
+                *out++ = lo | hi << 4;
+            }
+        }
+        for(size_t j = 0; j < 8; j++) {
+            *expected++ = channels == 1 ? decoded[0][j] : decoded[0][j] / 2 + decoded[1][j] / 2;
+        }
+    }
+    return out - block;
+}
+
+static bool check(uint16_t channels, uint16_t block_align) {
+    Encoder encoders[2] = {0};
+    uint8_t block[BLOCK_ALIGN_STEREO];
+    int16_t expected[BLOCK_MAX_SAMPLES], decoded[BLOCK_MAX_SAMPLES];
+    size_t samples_per_block = wav_adpcm_samples_per_block(block_align, channels);
+    size_t position = 0;
+
+    // full blocks, then a short one like at the end of a file
+    for(size_t n = 0; n < 64; n++) {
+        size_t samples_count = n < 63 ? samples_per_block : 1 + 8 * (n % 7 + 1);
+        size_t size = encode_block(encoders, channels, position, samples_count, block, expected);
+        if(n < 63 && size != block_align) {
+            printf("%u ch: encoded block is %zu bytes\n", channels, size);
+            return false;
+        }
+
+        size_t count = wav_adpcm_decode_block(block, size, channels, decoded);
+        if(count != samples_count || memcmp(decoded, expected, count * sizeof(int16_t))) {
+            printf("%u ch: block %zu of %zu samples differs\n", channels, n, samples_count);
+            return false;
+        }
+        position += samples_count;
+    }
+
+    // a block cut inside its header decodes to nothing
+    if(wav_adpcm_decode_block(block, 4 * channels - 1, channels, decoded) != 0) {
+        printf("%u ch: truncated header decoded\n", channels);
+        return false;
+    }
+
+    printf("%u ch: %zu samples match the encoder\n", channels, position);
+    return true;
+}
+
+static double time_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void bench(uint16_t channels, uint16_t block_align) {
+    Encoder encoders[2] = {0};
+    uint8_t block[BLOCK_ALIGN_STEREO];
+    int16_t decoded[BLOCK_MAX_SAMPLES];
+    size_t samples_per_block = wav_adpcm_samples_per_block(block_align, channels);
+    encode_block(encoders, channels, 0, samples_per_block, block, decoded);
+
+    double start = time_s(), elapsed;
+    size_t samples = 0;
+    uint32_t sink = 0;
+    do {
+        for(size_t i = 0; i < 1000; i++) {
+            samples += wav_adpcm_decode_block(block, block_align, channels, decoded);
+            sink += decoded[i % samples_per_block];
+        }
+        elapsed = time_s() - start;
+    } while(elapsed < BENCH_MIN_S);
+
+    printf(
+        "%u ch: %.1f Msamples/s, %.0fx realtime at %u Hz (%u)\n",
+        channels,
+        samples / elapsed / 1e6,
+        samples / elapsed / SAMPLE_RATE,
+        SAMPLE_RATE,
+        sink);
+}
+
+int main(void) {
+    srand(1);
+    if(!check(1, BLOCK_ALIGN_MONO) || !check(2, BLOCK_ALIGN_STEREO)) return EXIT_FAILURE;
+    bench(1, BLOCK_ALIGN_MONO);
+    bench(2, BLOCK_ALIGN_STEREO);
+    return EXIT_SUCCESS;
+}
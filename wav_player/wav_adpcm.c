@@ -0,0 +1,90 @@
+#include "wav_adpcm.h"
+
+static const int8_t index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+static const int16_t step_table[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+typedef struct {
+    int32_t predictor;
+    int32_t index;
+} AdpcmChannel;
+
+static inline int16_t adpcm_step(AdpcmChannel* channel, uint8_t nibble) {
+    int32_t step = step_table[channel->index];
+    int32_t diff = step >> 3;
+    if(nibble & 1) diff += step >> 2;
+    if(nibble & 2) diff += step >> 1;
+    if(nibble & 4) diff += step;
+    if(nibble & 8) diff = -diff;
+
+    int32_t predictor = channel->predictor + diff;
+    if(predictor > INT16_MAX) predictor = INT16_MAX;
+    if(predictor < INT16_MIN) predictor = INT16_MIN;
+    channel->predictor = predictor;
+
+    int32_t index = channel->index + index_table[nibble];
+    if(index < 0) index = 0;
+    if(index > 88) index = 88;
+    channel->index = index;
+
+    return predictor;
+}
+
+static const uint8_t* adpcm_header(const uint8_t* data, AdpcmChannel* channel) {
+    channel->predictor = (int16_t)(data[0] | (data[1] << 8));
+    channel->index = data[2] > 88 ? 88 : data[2];
+    return data + 4;
+}
+
+size_t wav_adpcm_samples_per_block(uint16_t block_align, uint16_t channels) {
+    if(block_align <= 4 * channels) return 0;
+    return (block_align - 4 * channels) * 2 / channels + 1;
+}
+
+size_t wav_adpcm_decode_block(const uint8_t* block, size_t size, uint16_t channels, int16_t* out) {
+    AdpcmChannel left, right;
+    const uint8_t* end = block + size;
+    int16_t* start = out;
+
+    if(channels == 1) {
+        if(size < 4) return 0;
+        block = adpcm_header(block, &left);
+        *out++ = left.predictor;
+
+        while(block < end) {
+            *out++ = adpcm_step(&left, *block & 0x0F);
+            *out++ = adpcm_step(&left, *block >> 4);
+            block++;
+        }
+    } else {
+        if(size < 8) return 0;
+        block = adpcm_header(block, &left);
+        block = adpcm_header(block, &right);
+        *out++ = left.predictor / 2 + right.predictor / 2;
+
+        // 4 bytes (8 samples) of the left channel followed by 4 bytes of the right one
+        while(block + 8 <= end) {
+            for(size_t i = 0; i < 4; i++) {
+                int16_t l = adpcm_step(&left, block[i] & 0x0F);
+                int16_t r = adpcm_step(&right, block[i + 4] & 0x0F);
+                *out++ = l / 2 + r / 2;
+                l = adpcm_step(&left, block[i] >> 4);
+                r = adpcm_step(&right, block[i + 4] >> 4);
+                *out++ = l / 2 + r / 2;
+            }
+            block += 8;
+        }
+    }
+
+    return out - start;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Samples per channel in an IMA ADPCM block of block_align bytes
+size_t wav_adpcm_samples_per_block(uint16_t block_align, uint16_t channels);
+
+// Decodes one IMA ADPCM block (the last one in a file may be short) into 16-bit samples, stereo
+// is mixed down to mono. Returns the number of samples written.
+size_t wav_adpcm_decode_block(const uint8_t* block, size_t size, uint16_t channels, int16_t* out);
+
+#ifdef __cplusplus
+}
+#endif
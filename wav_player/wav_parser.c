@@ -1,4 +1,5 @@
 #include "wav_parser.h"
+#include "wav_adpcm.h"
 
 #define TAG "WavParser"
 
@@ -8,6 +9,8 @@ const char* format_text(FormatTag tag) {
         return "PCM";
     case FormatTagIEEE_FLOAT:
         return "IEEE FLOAT";
+    case FormatTagIMA_ADPCM:
+        return "IMA ADPCM";
     default:
         return "Unknown";
     }
@@ -32,7 +35,6 @@ void wav_parser_free(WavParser* parser) {
 bool wav_parser_parse(WavParser* parser, Stream* stream, WavPlayerApp* app) {
     stream_read(stream, (uint8_t*)&parser->header, sizeof(WavHeaderChunk));
     stream_read(stream, (uint8_t*)&parser->format, sizeof(WavFormatChunk));
-    stream_read(stream, (uint8_t*)&parser->data, sizeof(WavDataChunk));
     char segment_name[5];
 
     if(memcmp(parser->header.riff, "RIFF", 4) != 0) {
@@ -53,24 +55,61 @@ bool wav_parser_parse(WavParser* parser, Stream* stream, WavPlayerApp* app) {
         return false;
     }
 
-    if(parser->format.tag != FormatTagPCM) {
+    if(parser->format.size < sizeof(WavFormatChunk) - 8) {
+        FURI_LOG_E(TAG, "WAV: short fmt segment: %lu", parser->format.size);
+        return false;
+    }
+
+    bool supported = parser->format.channels == 1 || parser->format.channels == 2;
+    if(parser->format.tag == FormatTagPCM) {
+        supported = supported &&
+                    (parser->format.bits_per_sample == 8 ||
+                     parser->format.bits_per_sample == 16) &&
+                    parser->format.block_align ==
+                        parser->format.channels * parser->format.bits_per_sample / 8;
+    } else if(parser->format.tag == FormatTagIMA_ADPCM && supported) {
+        // a decoded block has to fit into the half of the sample buffer
+        size_t samples =
+            wav_adpcm_samples_per_block(parser->format.block_align, parser->format.channels);
+        supported = parser->format.bits_per_sample == 4 && samples > 0 &&
+                    samples <= app->samples_count_half;
+    } else {
+        supported = false;
+    }
+
+    if(!supported) {
         FURI_LOG_E(
             TAG,
-            "WAV: non-PCM format: %u (%s)",
+            "WAV: unsupported format: %u (%s), ch: %u, bits: %u, block: %u",
             parser->format.tag,
-            format_text(parser->format.tag));
+            format_text(parser->format.tag),
+            parser->format.channels,
+            parser->format.bits_per_sample,
+            parser->format.block_align);
         return false;
     }
 
-    if(memcmp(parser->data.data, "LIST", 4) == 0) {
-        FURI_LOG_D(TAG, "WAV: skipping LIST segment");
-        stream_seek(stream, parser->data.size, StreamOffsetFromCurrent);
-        stream_read(stream, (uint8_t*)&parser->data, sizeof(WavDataChunk));
-    }
+    // skip the fmt extension (cbSize and format specific fields) and word padding
+    size_t format_extra = parser->format.size - (sizeof(WavFormatChunk) - 8);
+    stream_seek(stream, format_extra + (format_extra & 1), StreamOffsetFromCurrent);
+
+    // skip LIST, fact and any other chunks preceding the data
+    while(true) {
+        if(stream_read(stream, (uint8_t*)&parser->data, sizeof(WavDataChunk)) !=
+           sizeof(WavDataChunk)) {
+            FURI_LOG_E(TAG, "WAV: no data segment");
+            return false;
+        }
+        if(memcmp(parser->data.data, "data", 4) == 0) break;
 
-    if(memcmp(parser->data.data, "data", 4) != 0) {
         strlcpy(segment_name, (char*)&parser->data.data, sizeof(segment_name));
-        FURI_LOG_E(TAG, "WAV: wrong data segment: '%s'", segment_name);
+        FURI_LOG_D(TAG, "WAV: skipping %s segment", segment_name);
+        stream_seek(
+            stream, parser->data.size + (parser->data.size & 1), StreamOffsetFromCurrent);
+    }
+
+    if(parser->data.size < parser->format.block_align) {
+        FURI_LOG_E(TAG, "WAV: empty data segment");
         return false;
     }
 
@@ -84,8 +123,10 @@ bool wav_parser_parse(WavParser* parser, Stream* stream, WavPlayerApp* app) {
         parser->format.bits_per_sample);
 
     app->sample_rate = parser->format.sample_rate;
+    app->format_tag = parser->format.tag;
     app->num_channels = parser->format.channels;
     app->bits_per_sample = parser->format.bits_per_sample;
+    app->block_align = parser->format.block_align;
 
     parser->wav_data_start = stream_tell(stream);
     parser->wav_data_end = parser->wav_data_start + parser->data.size;
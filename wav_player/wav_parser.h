@@ -12,6 +12,7 @@
 #include <toolbox/stream/file_stream.h>
 
 #include "wav_player_view.h"
+#include "wav_reader.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,6 +21,7 @@ extern "C" {
 typedef enum {
     FormatTagPCM = 0x0001,
     FormatTagIEEE_FLOAT = 0x0003,
+    FormatTagIMA_ADPCM = 0x0011,
 } FormatTag;
 
 typedef struct {
@@ -44,19 +46,34 @@ typedef struct {
     uint32_t size;
 } WavDataChunk;
 
+#define WAV_PLAYER_CLIP_TABLE_SIZE 1024
+
 typedef struct WavParser WavParser;
 
-typedef struct {
+typedef struct WavPlayerApp WavPlayerApp;
+
+// Converts count frames of source data into 8-bit output samples
+typedef void (*WavPlayerConvert)(WavPlayerApp* app, const uint8_t* data, uint16_t* out, size_t count);
+
+struct WavPlayerApp {
     Storage* storage;
     Stream* stream;
     WavParser* parser;
+    WavReader* reader;
     uint16_t* sample_buffer;
-    uint8_t* tmp_buffer;
+
+    // IMA ADPCM blocks are decoded here, samples are taken from it until it runs out
+    int16_t* decode_buffer;
+    size_t decode_count;
+    size_t decode_pos;
 
     uint32_t sample_rate;
 
+    uint16_t format_tag;
     uint16_t num_channels;
     uint16_t bits_per_sample;
+    uint16_t block_align;
+    WavPlayerConvert convert;
 
     size_t samples_count_half;
     size_t samples_count;
@@ -64,13 +81,15 @@ typedef struct {
     FuriMessageQueue* queue;
 
     float volume;
+    int32_t gain; // volume scaled so that (sample * gain) >> 16 indexes clip_table
+    uint8_t clip_table[WAV_PLAYER_CLIP_TABLE_SIZE];
     bool play;
 
     WavPlayerView* view;
     ViewDispatcher* view_dispatcher;
     Gui* gui;
     NotificationApp* notification;
-} WavPlayerApp;
+};
 
 WavParser* wav_parser_alloc();
 
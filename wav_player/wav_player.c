@@ -10,6 +10,8 @@
 #include "wav_player_hal.h"
 #include "wav_parser.h"
 #include "wav_player_view.h"
+#include "wav_reader.h"
+#include "wav_adpcm.h"
 #include <math.h>
 
 #include <wav_player_icons.h>
@@ -81,6 +83,10 @@ static void wav_player_dma_isr(void* ctx) {
     }
 }
 
+static void update_gain(WavPlayerApp* app) {
+    app->gain = app->volume > 0 ? (int32_t)(app->volume * 65536 / 127) : 0;
+}
+
 static WavPlayerApp* app_alloc() {
     WavPlayerApp* app = malloc(sizeof(WavPlayerApp));
     app->samples_count_half = 1024 * 4;
@@ -89,10 +95,17 @@ static WavPlayerApp* app_alloc() {
     app->stream = file_stream_alloc(app->storage);
     app->parser = wav_parser_alloc();
     app->sample_buffer = malloc(sizeof(uint16_t) * app->samples_count);
-    app->tmp_buffer = malloc(sizeof(uint8_t) * app->samples_count);
+    app->reader = NULL;
+    app->decode_buffer = NULL;
     app->queue = furi_message_queue_alloc(10, sizeof(WavPlayerEvent));
 
+    // hyperbolic tangent limiter, indexed by the amplified sample in 1/256 of full scale
+    for(size_t i = 0; i < WAV_PLAYER_CLIP_TABLE_SIZE; i++) {
+        app->clip_table[i] = tanhf(i / 256.0f) * 127.0f + 0.5f;
+    }
+
     app->volume = 10.0f;
+    update_gain(app);
     app->play = true;
 
     app->gui = furi_record_open(RECORD_GUI);
@@ -116,7 +129,12 @@ static void app_free(WavPlayerApp* app) {
     furi_record_close(RECORD_GUI);
 
     furi_message_queue_free(app->queue);
-    free(app->tmp_buffer);
+    if(app->reader) {
+        wav_reader_free(app->reader);
+    }
+    if(app->decode_buffer) {
+        free(app->decode_buffer);
+    }
     free(app->sample_buffer);
     wav_parser_free(app->parser);
     stream_free(app->stream);
@@ -127,186 +145,124 @@ static void app_free(WavPlayerApp* app) {
     free(app);
 }
 
-// TODO: that works only with 8-bit 2ch audio
-static bool fill_data(WavPlayerApp* app, size_t index) {
-    if(app->num_channels == 1 && app->bits_per_sample == 8) {
-        uint16_t* sample_buffer_start = &app->sample_buffer[index];
-        size_t count = stream_read(app->stream, app->tmp_buffer, app->samples_count_half);
-
-        for(size_t i = count; i < app->samples_count_half; i++) {
-            app->tmp_buffer[i] = 0;
-        }
-
-        //for(size_t i = 0; i < app->samples_count; i += 2)
-        for(size_t i = 0; i < app->samples_count_half; i++) //now works with mono!
-        {
-            float data = app->tmp_buffer[i];
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
-
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
-
-            if(data < 0) {
-                data = 0;
-            }
-
-            if(data > 255) {
-                data = 255;
-            }
-
-            //uint8_t data = app->tmp_buffer[i];
-
-            sample_buffer_start[i] = data;
-        }
-
-        wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
+// Maps a sample scaled to signed 16 bits through volume and the limiter to the unsigned 8-bit
+// PWM range
+static inline uint16_t soft_clip(const uint8_t* clip_table, int32_t gain, int32_t sample) {
+    int32_t index = ((sample < 0 ? -sample : sample) * gain) >> 16;
+    int32_t clipped = index < WAV_PLAYER_CLIP_TABLE_SIZE ? clip_table[index] : 127;
+    return sample < 0 ? 127 - clipped : 127 + clipped;
+}
 
-        return count != app->samples_count_half;
+static void convert_u8_mono(WavPlayerApp* app, const uint8_t* data, uint16_t* out, size_t count) {
+    const uint8_t* clip_table = app->clip_table;
+    const int32_t gain = app->gain;
+    for(size_t i = 0; i < count; i++) {
+        out[i] = soft_clip(clip_table, gain, (data[i] - 127) * 256);
     }
+}
 
-    if(app->num_channels == 1 && app->bits_per_sample == 16) {
-        uint16_t* sample_buffer_start = &app->sample_buffer[index];
-        size_t count = stream_read(app->stream, app->tmp_buffer, app->samples_count);
-
-        for(size_t i = count; i < app->samples_count; i++) {
-            //app->tmp_buffer[i] = 0;
-        }
-
-        for(size_t i = 0; i < app->samples_count; i += 2) {
-            int16_t int_16 =
-                (((int16_t)app->tmp_buffer[i + 1] << 8) + (int16_t)app->tmp_buffer[i]);
-
-            float data = ((float)int_16 / 256.0 + 127.0);
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
-
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
-
-            if(data < 0) {
-                data = 0;
-            }
-
-            if(data > 255) {
-                data = 255;
-            }
-
-            sample_buffer_start[i / 2] = data;
-        }
-
-        wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
-
-        return count != app->samples_count;
+static void
+    convert_u8_stereo(WavPlayerApp* app, const uint8_t* data, uint16_t* out, size_t count) {
+    const uint8_t* clip_table = app->clip_table;
+    const int32_t gain = app->gain;
+    for(size_t i = 0; i < count; i++) {
+        int32_t mono = (data[2 * i] + data[2 * i + 1]) >> 1; // (L + R) / 2
+        out[i] = soft_clip(clip_table, gain, (mono - 127) * 256);
     }
+}
 
-    if(app->num_channels == 2 && app->bits_per_sample == 16) {
-        uint16_t* sample_buffer_start = &app->sample_buffer[index];
-        size_t count = stream_read(app->stream, app->tmp_buffer, app->samples_count);
-
-        for(size_t i = 0; i < app->samples_count; i += 4) {
-            int16_t L = (((int16_t)app->tmp_buffer[i + 1] << 8) + (int16_t)app->tmp_buffer[i]);
-            int16_t R = (((int16_t)app->tmp_buffer[i + 3] << 8) + (int16_t)app->tmp_buffer[i + 2]);
-            int32_t int_16 = L / 2 + R / 2; // (L + R) / 2
-
-            float data = ((float)int_16 / 256.0 + 127.0);
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
-
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
-
-            if(data < 0) {
-                data = 0;
-            }
-
-            if(data > 255) {
-                data = 255;
-            }
-
-            sample_buffer_start[i / 4] = data;
-        }
-
-        count = stream_read(app->stream, app->tmp_buffer, app->samples_count);
-
-        for(size_t i = 0; i < app->samples_count; i += 4) {
-            int16_t L = (((int16_t)app->tmp_buffer[i + 1] << 8) + (int16_t)app->tmp_buffer[i]);
-            int16_t R = (((int16_t)app->tmp_buffer[i + 3] << 8) + (int16_t)app->tmp_buffer[i + 2]);
-            int32_t int_16 = L / 2 + R / 2; // (L + R) / 2
-
-            float data = ((float)int_16 / 256.0 + 127.0);
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
+// 16-bit frames are always 2-byte aligned in the reader batches and the ADPCM decode buffer
+static void
+    convert_s16_mono(WavPlayerApp* app, const uint8_t* data, uint16_t* out, size_t count) {
+    const uint8_t* clip_table = app->clip_table;
+    const int32_t gain = app->gain;
+    const int16_t* samples = (const int16_t*)data;
+    for(size_t i = 0; i < count; i++) {
+        out[i] = soft_clip(clip_table, gain, samples[i]);
+    }
+}
 
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
+static void
+    convert_s16_stereo(WavPlayerApp* app, const uint8_t* data, uint16_t* out, size_t count) {
+    const uint8_t* clip_table = app->clip_table;
+    const int32_t gain = app->gain;
+    const int16_t* samples = (const int16_t*)data;
+    for(size_t i = 0; i < count; i++) {
+        out[i] = soft_clip(clip_table, gain, samples[2 * i] / 2 + samples[2 * i + 1] / 2);
+    }
+}
 
-            if(data < 0) {
-                data = 0;
-            }
+static WavPlayerConvert select_convert(WavPlayerApp* app) {
+    if(app->format_tag == FormatTagIMA_ADPCM) {
+        // blocks are decoded and mixed down to 16-bit mono first
+        return convert_s16_mono;
+    }
+    if(app->bits_per_sample == 8) {
+        return app->num_channels == 1 ? convert_u8_mono : convert_u8_stereo;
+    }
+    return app->num_channels == 1 ? convert_s16_mono : convert_s16_stereo;
+}
 
-            if(data > 255) {
-                data = 255;
+static void fill_data(WavPlayerApp* app, size_t index) {
+    uint16_t* sample_buffer_start = &app->sample_buffer[index];
+    size_t filled = 0;
+
+    while(filled < app->samples_count_half) {
+        size_t count = app->samples_count_half - filled;
+        const uint8_t* data;
+
+        if(app->format_tag == FormatTagIMA_ADPCM) {
+            if(app->decode_pos == app->decode_count) {
+                size_t size;
+                const uint8_t* block = wav_reader_read(app->reader, app->block_align, &size);
+                if(size == 0) break;
+                // a block too short to hold a header decodes to nothing and is skipped
+                app->decode_count =
+                    wav_adpcm_decode_block(block, size, app->num_channels, app->decode_buffer);
+                app->decode_pos = 0;
             }
-
-            sample_buffer_start[i / 4 + app->samples_count / 4] = data;
+            count = MIN(count, app->decode_count - app->decode_pos);
+            data = (const uint8_t*)&app->decode_buffer[app->decode_pos];
+            app->decode_pos += count;
+        } else {
+            size_t size;
+            data = wav_reader_read(app->reader, count * app->block_align, &size);
+            if(size == 0) break;
+            // a partial frame at the end of the data is dropped
+            count = size / app->block_align;
+            if(count == 0) continue;
         }
 
-        wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
-
-        return count != app->samples_count;
+        app->convert(app, data, &sample_buffer_start[filled], count);
+        filled += count;
     }
 
-    if(app->num_channels == 2 && app->bits_per_sample == 8) {
-        uint16_t* sample_buffer_start = &app->sample_buffer[index];
-        size_t count = stream_read(app->stream, app->tmp_buffer, app->samples_count);
-
-        for(size_t i = count; i < app->samples_count; i++) {
-            app->tmp_buffer[i] = 0;
-        }
-
-        for(size_t i = 0; i < app->samples_count; i += 2) {
-            float data = (app->tmp_buffer[i] + app->tmp_buffer[i + 1]) / 2; // (L + R) / 2
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
-
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
-
-            if(data < 0) {
-                data = 0;
-            }
-
-            if(data > 255) {
-                data = 255;
-            }
+    // the reader had nothing to give, play silence
+    for(; filled < app->samples_count_half; filled++) {
+        sample_buffer_start[filled] = 127;
+    }
 
-            //uint8_t data = app->tmp_buffer[i];
+    wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
+}
 
-            sample_buffer_start[i / 2] = data;
-        }
+static void seek_data(WavPlayerApp* app, int32_t direction) {
+    size_t start = wav_parser_get_data_start(app->parser);
+    size_t position = wav_reader_get_position(app->reader);
 
-        wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
+    // 1% of the file, in whole frames or ADPCM blocks
+    size_t step = wav_parser_get_data_len(app->parser) / 100;
+    step -= step % app->block_align;
 
-        return count != app->samples_count;
+    if(direction < 0) {
+        position -= MIN(step, position - start);
+    } else {
+        position += step;
     }
 
-    return true;
+    wav_reader_seek(app->reader, position);
+    app->decode_pos = 0;
+    app->decode_count = 0;
+    wav_player_view_set_current(app->view, wav_reader_get_position(app->reader));
 }
 
 static void ctrl_callback(WavPlayerCtrl ctrl, void* ctx) {
@@ -347,17 +303,31 @@ static void app_run(WavPlayerApp* app) {
     if(!open_wav_stream(app->stream)) return;
     if(!wav_parser_parse(app->parser, app->stream, app)) return;
 
+    app->convert = select_convert(app);
+    if(app->format_tag == FormatTagIMA_ADPCM) {
+        app->decode_buffer = malloc(sizeof(int16_t) * app->samples_count_half);
+    }
+    app->decode_count = 0;
+    app->decode_pos = 0;
+
+    // the stream belongs to the reader thread from here on
+    app->reader = wav_reader_alloc(
+        app->stream,
+        wav_parser_get_data_start(app->parser),
+        wav_parser_get_data_end(app->parser),
+        app->block_align);
+
     wav_player_view_set_volume(app->view, app->volume);
     wav_player_view_set_start(app->view, wav_parser_get_data_start(app->parser));
-    wav_player_view_set_current(app->view, stream_tell(app->stream));
+    wav_player_view_set_current(app->view, wav_parser_get_data_start(app->parser));
     wav_player_view_set_end(app->view, wav_parser_get_data_end(app->parser));
     wav_player_view_set_play(app->view, app->play);
 
     wav_player_view_set_context(app->view, app->queue);
     wav_player_view_set_ctrl_callback(app->view, ctrl_callback);
 
-    bool eof = fill_data(app, 0);
-    eof = fill_data(app, app->samples_count_half);
+    fill_data(app, 0);
+    fill_data(app, app->samples_count_half);
 
     if(furi_hal_speaker_acquire(1000)) {
         wav_player_speaker_init(app->sample_rate);
@@ -376,52 +346,27 @@ static void app_run(WavPlayerApp* app) {
                     wav_player_view_set_chans(app->view, app->num_channels);
                     wav_player_view_set_bits(app->view, app->bits_per_sample);
 
-                    eof = fill_data(app, 0);
-                    wav_player_view_set_current(app->view, stream_tell(app->stream));
-                    if(eof) {
-                        stream_seek(
-                            app->stream,
-                            wav_parser_get_data_start(app->parser),
-                            StreamOffsetFromStart);
-                    }
+                    fill_data(app, 0);
+                    wav_player_view_set_current(app->view, wav_reader_get_position(app->reader));
 
                 } else if(event.type == WavPlayerEventFullTransfer) {
                     wav_player_view_set_chans(app->view, app->num_channels);
                     wav_player_view_set_bits(app->view, app->bits_per_sample);
 
-                    eof = fill_data(app, app->samples_count_half);
-                    wav_player_view_set_current(app->view, stream_tell(app->stream));
-                    if(eof) {
-                        stream_seek(
-                            app->stream,
-                            wav_parser_get_data_start(app->parser),
-                            StreamOffsetFromStart);
-                    }
+                    fill_data(app, app->samples_count_half);
+                    wav_player_view_set_current(app->view, wav_reader_get_position(app->reader));
                 } else if(event.type == WavPlayerEventCtrlVolUp) {
                     if(app->volume < 9.9) app->volume += 0.4;
+                    update_gain(app);
                     wav_player_view_set_volume(app->view, app->volume);
                 } else if(event.type == WavPlayerEventCtrlVolDn) {
                     if(app->volume > 0.01) app->volume -= 0.4;
+                    update_gain(app);
                     wav_player_view_set_volume(app->view, app->volume);
                 } else if(event.type == WavPlayerEventCtrlMoveL) {
-                    int32_t seek =
-                        stream_tell(app->stream) - wav_parser_get_data_start(app->parser);
-                    seek = MIN(
-                        seek,
-                        (int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100) % 2 ?
-                            ((int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100) - 1) :
-                            (int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100));
-                    stream_seek(app->stream, -seek, StreamOffsetFromCurrent);
-                    wav_player_view_set_current(app->view, stream_tell(app->stream));
+                    seek_data(app, -1);
                 } else if(event.type == WavPlayerEventCtrlMoveR) {
-                    int32_t seek = wav_parser_get_data_end(app->parser) - stream_tell(app->stream);
-                    seek = MIN(
-                        seek,
-                        (int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100) % 2 ?
-                            ((int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100) - 1) :
-                            (int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100));
-                    stream_seek(app->stream, seek, StreamOffsetFromCurrent);
-                    wav_player_view_set_current(app->view, stream_tell(app->stream));
+                    seek_data(app, 1);
                 } else if(event.type == WavPlayerEventCtrlOk) {
                     app->play = !app->play;
                     wav_player_view_set_play(app->view, app->play);
@@ -0,0 +1,164 @@
+#include "wav_reader.h"
+
+#include <furi.h>
+
+#define TAG "WavReader"
+
+#define WAV_READER_BATCH_COUNT 2
+#define WAV_READER_STOP 0xFFFFFFFF
+#define WAV_READER_NONE 0xFFFFFFFF
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t position;
+} WavReaderBatch;
+
+struct WavReader {
+    Stream* stream;
+    size_t start;
+    size_t end;
+    size_t align;
+    size_t batch_size;
+
+    FuriThread* thread;
+    FuriMessageQueue* free_queue;
+    FuriMessageQueue* filled_queue;
+    WavReaderBatch batch[WAV_READER_BATCH_COUNT];
+
+    // owned by the reader thread while it runs
+    size_t next_position;
+
+    // owned by the consumer
+    uint32_t current;
+    size_t current_offset;
+    size_t position;
+};
+
+static int32_t wav_reader_thread(void* context) {
+    WavReader* reader = context;
+    stream_seek(reader->stream, reader->next_position, StreamOffsetFromStart);
+
+    while(true) {
+        uint32_t index;
+        if(furi_message_queue_get(reader->free_queue, &index, FuriWaitForever) != FuriStatusOk) {
+            continue;
+        }
+        if(index == WAV_READER_STOP) break;
+
+        if(reader->next_position >= reader->end) {
+            reader->next_position = reader->start;
+            stream_seek(reader->stream, reader->start, StreamOffsetFromStart);
+        }
+
+        WavReaderBatch* batch = &reader->batch[index];
+        size_t size = MIN(reader->batch_size, reader->end - reader->next_position);
+        batch->position = reader->next_position;
+        batch->size = stream_read(reader->stream, batch->data, size);
+        reader->next_position += batch->size;
+        if(batch->size != size) {
+            // truncated file or read error, start over from the beginning
+            FURI_LOG_W(TAG, "short read at %u", batch->position);
+            reader->next_position = reader->end;
+        }
+
+        furi_message_queue_put(reader->filled_queue, &index, FuriWaitForever);
+    }
+
+    return 0;
+}
+
+static void wav_reader_start(WavReader* reader, size_t position) {
+    furi_message_queue_reset(reader->free_queue);
+    furi_message_queue_reset(reader->filled_queue);
+    for(uint32_t i = 0; i < WAV_READER_BATCH_COUNT; i++) {
+        furi_message_queue_put(reader->free_queue, &i, 0);
+    }
+
+    reader->next_position = position;
+    reader->current = WAV_READER_NONE;
+    reader->position = position;
+    furi_thread_start(reader->thread);
+}
+
+static void wav_reader_stop(WavReader* reader) {
+    uint32_t stop = WAV_READER_STOP;
+    furi_message_queue_reset(reader->free_queue);
+    furi_message_queue_put(reader->free_queue, &stop, FuriWaitForever);
+    furi_thread_join(reader->thread);
+}
+
+WavReader* wav_reader_alloc(Stream* stream, size_t start, size_t end, size_t align) {
+    WavReader* reader = malloc(sizeof(WavReader));
+    reader->stream = stream;
+    reader->start = start;
+    reader->end = end;
+    reader->align = align;
+    reader->batch_size = MAX(WAV_READER_BATCH_SIZE / align, 1U) * align;
+
+    for(size_t i = 0; i < WAV_READER_BATCH_COUNT; i++) {
+        reader->batch[i].data = malloc(reader->batch_size);
+        reader->batch[i].size = 0;
+        reader->batch[i].position = start;
+    }
+    reader->free_queue = furi_message_queue_alloc(WAV_READER_BATCH_COUNT + 1, sizeof(uint32_t));
+    reader->filled_queue = furi_message_queue_alloc(WAV_READER_BATCH_COUNT, sizeof(uint32_t));
+
+    reader->thread = furi_thread_alloc();
+    furi_thread_set_name(reader->thread, "WavReader");
+    furi_thread_set_callback(reader->thread, wav_reader_thread);
+    furi_thread_set_context(reader->thread, reader);
+    furi_thread_set_stack_size(reader->thread, 1024);
+
+    wav_reader_start(reader, start);
+    return reader;
+}
+
+void wav_reader_free(WavReader* reader) {
+    wav_reader_stop(reader);
+    furi_thread_free(reader->thread);
+    furi_message_queue_free(reader->filled_queue);
+    furi_message_queue_free(reader->free_queue);
+    for(size_t i = 0; i < WAV_READER_BATCH_COUNT; i++) {
+        free(reader->batch[i].data);
+    }
+    free(reader);
+}
+
+void wav_reader_seek(WavReader* reader, size_t position) {
+    if(position >= reader->end) position = reader->end - 1;
+    if(position < reader->start) position = reader->start;
+    position -= (position - reader->start) % reader->align;
+
+    wav_reader_stop(reader);
+    wav_reader_start(reader, position);
+}
+
+const uint8_t* wav_reader_read(WavReader* reader, size_t max_size, size_t* size) {
+    *size = 0;
+    for(size_t tries = 0; tries < 2; tries++) {
+        if(reader->current != WAV_READER_NONE) {
+            WavReaderBatch* batch = &reader->batch[reader->current];
+            size_t left = batch->size - reader->current_offset;
+            // the data may end with a short unit (the last ADPCM block), pass it on as is
+            if(batch->position + batch->size != reader->end) left -= left % reader->align;
+            if(left > 0) {
+                const uint8_t* data = &batch->data[reader->current_offset];
+                *size = MIN(left, max_size - max_size % reader->align);
+                reader->current_offset += *size;
+                reader->position = batch->position + reader->current_offset;
+                return data;
+            }
+            furi_message_queue_put(reader->free_queue, &reader->current, FuriWaitForever);
+        }
+
+        // an empty batch after a fresh one means there is nothing to read, don't spin on it
+        furi_message_queue_get(reader->filled_queue, &reader->current, FuriWaitForever);
+        reader->current_offset = 0;
+    }
+    return NULL;
+}
+
+size_t wav_reader_get_position(WavReader* reader) {
+    return reader->position;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <toolbox/stream/stream.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WAV_READER_BATCH_SIZE (16 * 1024)
+
+typedef struct WavReader WavReader;
+
+// Reads [start, end) of the stream on its own thread into two batch buffers, looping at the end.
+// Batches hold whole units of align bytes (PCM frames or ADPCM blocks), only the unit at the end
+// of the data may be short.
+WavReader* wav_reader_alloc(Stream* stream, size_t start, size_t end, size_t align);
+
+void wav_reader_free(WavReader* reader);
+
+void wav_reader_seek(WavReader* reader, size_t position);
+
+// Returns up to max_size bytes of whole units from the current batch, waiting for the next batch
+// if it is used up. The short unit at the end of the data is returned on its own. Size is 0 if the
+// stream has no data to give.
+const uint8_t* wav_reader_read(WavReader* reader, size_t max_size, size_t* size);
+
+// Stream position of the next byte wav_reader_read will return
+size_t wav_reader_get_position(WavReader* reader);
+
+#ifdef __cplusplus
+}
+#endif
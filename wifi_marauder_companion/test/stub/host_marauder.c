@@ -0,0 +1,256 @@
+#include "host_marauder.h"
+
+#include <furi_hal.h>
+#include <xtreme/xtreme.h>
+
+XtremeSettings xtreme_settings;
+HostCounters host_counters;
+
+struct FuriThread {
+    FuriThreadCallback callback;
+    void* context;
+};
+
+struct FuriStreamBuffer {
+    uint8_t* data;
+    size_t size;
+    size_t head;
+    size_t tail;
+};
+
+static struct {
+    uint8_t* data;
+    uint64_t* time_us; // arrival of each byte
+    size_t length;
+    size_t capacity;
+    uint64_t end_us;
+
+    size_t next;
+    uint64_t now_us;
+    uint64_t stop_us;
+    uint32_t max_latency_us;
+    bool in_irq;
+    uint32_t pending;
+    uint32_t deferred;
+
+    void (*irq_cb)(UartIrqEvent event, uint8_t data, void* context);
+    void* irq_context;
+} line;
+
+void host_line_append(const uint8_t* data, size_t length, uint32_t gap_us) {
+    if(line.length + length > line.capacity) {
+        line.capacity = MAX(line.capacity * 2, line.length + length);
+        line.data = realloc(line.data, line.capacity);
+        line.time_us = realloc(line.time_us, line.capacity * sizeof(uint64_t));
+    }
+
+    double t = line.end_us + gap_us;
+    for(size_t i = 0; i < length; i++) {
+        t += UART_BYTE_US;
+        line.data[line.length] = data[i];
+        line.time_us[line.length++] = (uint64_t)t;
+    }
+    line.end_us = (uint64_t)t;
+}
+
+void host_line_rewind(uint32_t max_latency_us, uint32_t seed) {
+    line.next = 0;
+    line.now_us = 0;
+    line.stop_us = line.end_us + STOP_DELAY_US;
+    line.max_latency_us = max_latency_us;
+    line.pending = 0;
+    line.deferred = 0;
+    host_counters = (HostCounters){0};
+    srand(seed);
+}
+
+size_t host_line_length(void) {
+    return line.length;
+}
+
+double host_line_seconds(void) {
+    return line.end_us / 1e6;
+}
+
+uint64_t host_now_us(void) {
+    return line.now_us;
+}
+
+static void line_run_until(uint64_t t) {
+    while(line.next < line.length && line.time_us[line.next] <= t) {
+        line.now_us = line.time_us[line.next];
+        line.in_irq = true;
+        if(line.irq_cb) line.irq_cb(UartIrqEventRXNE, line.data[line.next], line.irq_context);
+        line.in_irq = false;
+        line.next++;
+    }
+    if(line.deferred && t >= line.stop_us) {
+        line.pending |= line.deferred;
+        line.deferred = 0;
+    }
+    line.now_us = MAX(line.now_us, t);
+}
+
+void host_busy(uint32_t us) {
+    line_run_until(line.now_us + us);
+}
+
+// Next thing that can set a flag: a byte or the app stopping the worker
+static uint64_t line_next_event(void) {
+    if(line.next < line.length) return line.time_us[line.next];
+    if(line.deferred) return MAX(line.stop_us, line.now_us);
+    return UINT64_MAX;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    UNUSED(options);
+    uint64_t deadline = timeout == FuriWaitForever ? UINT64_MAX : line.now_us + timeout * 1000ULL;
+    host_counters.wakeups++;
+
+    while(!(line.pending & flags)) {
+        uint64_t next = line_next_event();
+        if(next == UINT64_MAX && deadline == UINT64_MAX) {
+            fprintf(stderr, "worker waits forever\n");
+            abort();
+        }
+        if(next > deadline) {
+            line.now_us = deadline;
+            host_counters.timeouts++;
+            return FuriFlagErrorTimeout;
+        }
+        line_run_until(next);
+    }
+
+    // The scheduler does not switch to the worker right away
+    if(line.max_latency_us) line_run_until(line.now_us + rand() % line.max_latency_us);
+
+    uint32_t events = line.pending & flags;
+    line.pending &= ~events;
+    return events;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    UNUSED(thread_id);
+    if(line.in_irq) {
+        line.pending |= flags;
+    } else {
+        line.deferred |= flags;
+    }
+    return flags;
+}
+
+FuriThread* furi_thread_alloc(void) {
+    return calloc(1, sizeof(FuriThread));
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
+
+void furi_thread_set_name(FuriThread* thread, const char* name) {
+    UNUSED(thread);
+    UNUSED(name);
+}
+
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    UNUSED(thread);
+    UNUSED(stack_size);
+}
+
+void furi_thread_set_context(FuriThread* thread, void* context) {
+    thread->context = context;
+}
+
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    thread->callback = callback;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    UNUSED(thread);
+}
+
+// The worker replays the whole dump here
+bool furi_thread_join(FuriThread* thread) {
+    thread->callback(thread->context);
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level) {
+    UNUSED(trigger_level);
+    FuriStreamBuffer* stream_buffer = calloc(1, sizeof(FuriStreamBuffer));
+    stream_buffer->data = calloc(1, size);
+    stream_buffer->size = size;
+    return stream_buffer;
+}
+
+void furi_stream_buffer_free(FuriStreamBuffer* stream_buffer) {
+    free(stream_buffer->data);
+    free(stream_buffer);
+}
+
+// Like xStreamBufferSendFromISR(), whatever does not fit is lost
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* stream_buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout) {
+    UNUSED(timeout);
+    size_t n = MIN(length, stream_buffer->size - (stream_buffer->head - stream_buffer->tail));
+    for(size_t i = 0; i < n; i++) {
+        stream_buffer->data[stream_buffer->head++ % stream_buffer->size] = ((const uint8_t*)data)[i];
+    }
+    host_counters.dropped += length - n;
+    return n;
+}
+
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* stream_buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout) {
+    UNUSED(timeout);
+    size_t n = MIN(length, stream_buffer->head - stream_buffer->tail);
+    for(size_t i = 0; i < n; i++) {
+        ((uint8_t*)data)[i] = stream_buffer->data[stream_buffer->tail++ % stream_buffer->size];
+    }
+    return n;
+}
+
+void furi_hal_uart_init(FuriHalUartId channel, uint32_t baud) {
+    UNUSED(channel);
+    UNUSED(baud);
+}
+
+void furi_hal_uart_deinit(FuriHalUartId channel) {
+    UNUSED(channel);
+}
+
+void furi_hal_uart_set_br(FuriHalUartId channel, uint32_t baud) {
+    UNUSED(channel);
+    UNUSED(baud);
+}
+
+void furi_hal_uart_tx(FuriHalUartId channel, uint8_t* buffer, size_t buffer_size) {
+    UNUSED(channel);
+    UNUSED(buffer);
+    UNUSED(buffer_size);
+}
+
+void furi_hal_uart_set_irq_cb(
+    FuriHalUartId channel,
+    void (*callback)(UartIrqEvent event, uint8_t data, void* context),
+    void* context) {
+    UNUSED(channel);
+    line.irq_cb = callback;
+    line.irq_context = context;
+}
+
+void furi_hal_console_disable(void) {
+}
+
+void furi_hal_console_enable(void) {
+}
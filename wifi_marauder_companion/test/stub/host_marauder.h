@@ -0,0 +1,34 @@
+#pragma once
+
+// Simulated ESP32 UART line and worker thread scheduling for uart_replay.
+//
+// Time is simulated: each byte takes UART_BYTE_US on the line and is handed to the RX
+// interrupt callback when it arrives. The worker thread runs inside furi_thread_join(), every
+// furi_thread_flags_wait() lets the line run until a flag is set (plus a random wake up
+// latency) or the timeout expires. Flags set outside of the interrupt, like the stop flag of
+// wifi_marauder_uart_free(), only arrive once the whole dump has been received.
+
+#include <furi.h>
+
+#define UART_BAUD 115200
+#define UART_BYTE_US (10 * 1000000.0 / UART_BAUD) // 8N1
+#define STOP_DELAY_US 100000 // from the last byte to the app closing the console
+
+typedef struct {
+    uint32_t wakeups; // furi_thread_flags_wait() returns, including timeouts
+    uint32_t timeouts;
+    size_t dropped; // bytes a stream buffer had no room for
+} HostCounters;
+
+extern HostCounters host_counters;
+
+// The line idles for gap_us, then sends the bytes back to back
+void host_line_append(const uint8_t* data, size_t length, uint32_t gap_us);
+// Starts the dump over, with the wake up latency of the worker up to max_latency_us
+void host_line_rewind(uint32_t max_latency_us, uint32_t seed);
+size_t host_line_length(void);
+double host_line_seconds(void);
+
+// The worker is busy for us, the interrupt keeps receiving meanwhile
+void host_busy(uint32_t us);
+uint64_t host_now_us(void);
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <furi.h>
+
+#define EXT_PATH(path) "/ext/" path
+
+typedef struct Storage Storage;
+typedef struct File File;
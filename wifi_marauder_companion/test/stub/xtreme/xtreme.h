@@ -0,0 +1,12 @@
+#pragma once
+
+typedef enum {
+    UARTDefault,
+    UARTExtra,
+} XtremeUartChannel;
+
+typedef struct {
+    XtremeUartChannel uart_esp_channel;
+} XtremeSettings;
+
+extern XtremeSettings xtreme_settings;
@@ -0,0 +1,291 @@
+// Replays an ESP32 Marauder UART dump through the receive path, with the worker as it is and
+// as it was before the chunked receive (uart_ref.c). The bytes arrive at 115200 baud on a
+// simulated line, the callbacks take as long as the console output scene would, and the text
+// and PCAP streams that come out are compared byte for byte.
+//
+// Without a dump, a generated sniff session is used: text lines, PCAP records between
+// [BUF/BEGIN] and [BUF/CLOSE], things that look like the start of a marker in both, and idle
+// gaps. Both workers must then give back exactly the text and PCAP data that was sent. With a
+// dump, it is sent back to back and the new worker must match the old one.
+//
+//   make -C wifi_marauder_companion/test run
+//   ./uart_replay [dump.bin [out.pcap]]
+
+#include "../wifi_marauder_app_i.h"
+#include "host_marauder.h"
+
+#define DUMP_BYTES (900 * 1024)
+#define PCAP_RECORD_HEADER 16
+#define SD_CALL_US 1500 // storage_file_write() of a few bytes, FatFs and SPI overhead
+#define SD_BYTE_NS 1000 // about 1 MB/s once the transfer runs
+#define TEXT_CB_US 200 // furi_string_cat_printf() and the view dispatcher event
+
+WifiMarauderUart*
+    wifi_marauder_uart_init(WifiMarauderApp* app, FuriHalUartId channel, const char* thread_name);
+WifiMarauderUart* wifi_marauder_uart_ref_init(
+    WifiMarauderApp* app,
+    FuriHalUartId channel,
+    const char* thread_name);
+void wifi_marauder_uart_ref_set_handle_rx_data_cb(
+    WifiMarauderUart* uart,
+    void (*handle_rx_data_cb)(uint8_t* buf, size_t len, void* context));
+void wifi_marauder_uart_ref_set_handle_rx_pcap_cb(
+    WifiMarauderUart* uart,
+    void (*handle_rx_pcap_cb)(uint8_t* buf, size_t len, void* context));
+void wifi_marauder_uart_ref_free(WifiMarauderUart* uart);
+
+typedef struct {
+    uint8_t* data;
+    size_t length;
+    size_t capacity;
+} Bytes;
+
+typedef struct {
+    const char* name;
+    WifiMarauderUart* (*init)(WifiMarauderApp*, FuriHalUartId, const char*);
+    void (*set_handle_rx_data_cb)(WifiMarauderUart*, void (*)(uint8_t*, size_t, void*));
+    void (*set_handle_rx_pcap_cb)(WifiMarauderUart*, void (*)(uint8_t*, size_t, void*));
+    void (*free)(WifiMarauderUart*);
+} UartApi;
+
+static const UartApi uarts[2] = {
+    {"old",
+     wifi_marauder_uart_ref_init,
+     wifi_marauder_uart_ref_set_handle_rx_data_cb,
+     wifi_marauder_uart_ref_set_handle_rx_pcap_cb,
+     wifi_marauder_uart_ref_free},
+    {"new",
+     wifi_marauder_uart_init,
+     wifi_marauder_uart_set_handle_rx_data_cb,
+     wifi_marauder_uart_set_handle_rx_pcap_cb,
+     wifi_marauder_uart_free},
+};
+
+// worker wake up latencies to replay with
+static const uint32_t latencies_us[] = {0, 1000, 5000};
+
+typedef struct {
+    Bytes text;
+    Bytes pcap;
+    uint32_t text_calls;
+    uint32_t pcap_calls;
+    uint64_t sd_us;
+    HostCounters counters;
+} Output;
+
+static Output* output;
+static Bytes sent_text, sent_pcap;
+
+static void bytes_append(Bytes* bytes, const void* data, size_t length) {
+    if(bytes->length + length > bytes->capacity) {
+        bytes->capacity = MAX(bytes->capacity * 2, bytes->length + length);
+        bytes->data = realloc(bytes->data, bytes->capacity);
+    }
+    memcpy(bytes->data + bytes->length, data, length);
+    bytes->length += length;
+}
+
+static bool bytes_equal(const Bytes* a, const Bytes* b) {
+    return a->length == b->length && !memcmp(a->data, b->data, a->length);
+}
+
+// what wifi_marauder_console_output_handle_rx_data_cb() does with the buffer
+static void handle_rx_data_cb(uint8_t* buf, size_t len, void* context) {
+    UNUSED(context);
+    buf[len] = '\0';
+    bytes_append(&output->text, buf, len);
+    output->text_calls++;
+    host_busy(TEXT_CB_US);
+}
+
+// the PCAP callback writes each call to the capture file
+static void handle_rx_pcap_cb(uint8_t* buf, size_t len, void* context) {
+    UNUSED(context);
+    uint32_t us = SD_CALL_US + len * SD_BYTE_NS / 1000;
+    bytes_append(&output->pcap, buf, len);
+    output->pcap_calls++;
+    output->sd_us += us;
+    host_busy(us);
+}
+
+static void send(const void* data, size_t length, uint32_t gap_us) {
+    host_line_append(data, length, gap_us);
+}
+
+static void send_text(const char* text, uint32_t gap_us) {
+    send(text, strlen(text), gap_us);
+    bytes_append(&sent_text, text, strlen(text));
+}
+
+// PCAP payload with the start of a marker in it now and then, never a whole one
+static void send_pcap(size_t length, uint32_t gap_us) {
+    static const char* near_misses[] = {"[", "[B", "[BUF/BEG", "[BUF/CLOSE", "[BUF/"};
+    uint8_t record[1600];
+
+    for(size_t i = 0; i < length; i++) {
+        record[i] = rand();
+    }
+
+    if(length > 16 && rand() % 4 == 0) {
+        const char* miss = near_misses[rand() % 5];
+        size_t at = rand() % (length - strlen(miss) - 1);
+        memcpy(record + at, miss, strlen(miss));
+        record[at + strlen(miss)] = 'x';
+    }
+
+    send("[BUF/BEGIN]", 11, gap_us);
+    send(record, length, 0);
+    send("[BUF/CLOSE]", 11, 0);
+    bytes_append(&sent_pcap, record, length);
+}
+
+// A sniffraw session: the PCAP file header, then one record per frame with the odd status
+// line in between
+static void generate_dump(void) {
+    static const char* lines[] = {
+        "[+] Ch: 6\n",
+        "[!] Stopping scan\r\n",
+        "#beacon: -67 Ch: 11 BSSID: a4:2b:b0:12:34:56 ESSID: home\n",
+        "deauth -> [BUF/x] 00:11:22:33:44:55\n",
+        "[BUF/BEGI\n",
+        "[[[ ]]]\n",
+    };
+    char line[128];
+    srand(1);
+
+    send_text("> sniffraw\nStarting Raw sniff. Stop with stopscan\n", 0);
+    send_pcap(24, 2000);
+
+    while(host_line_length() < DUMP_BYTES) {
+        uint32_t gap_us = rand() % 3 ? 0 : rand() % 50000;
+
+        if(rand() % 8 == 0) {
+            if(rand() % 2) {
+                snprintf(line, sizeof(line), "Packets/sec: %d\n", rand() % 400);
+                send_text(line, gap_us);
+            } else {
+                send_text(lines[rand() % 6], gap_us);
+            }
+        } else {
+            // a record header and a frame of up to a full 802.11 MPDU
+            send_pcap(PCAP_RECORD_HEADER + 24 + rand() % 1500, gap_us);
+        }
+    }
+
+    send_text("> stopscan\n", 20000);
+}
+
+static bool load_dump(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if(!f) return false;
+
+    uint8_t buf[4096];
+    size_t n;
+    while((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        send(buf, n, 0);
+    }
+    fclose(f);
+    return true;
+}
+
+static void replay(const UartApi* api, uint32_t latency_us, Output* out) {
+    memset(out, 0, sizeof(Output));
+    output = out;
+    host_line_rewind(latency_us, 1);
+
+    WifiMarauderUart* uart = api->init(NULL, FuriHalUartIdLPUART1, "WifiMarauderUartRxThread");
+    api->set_handle_rx_data_cb(uart, handle_rx_data_cb);
+    api->set_handle_rx_pcap_cb(uart, handle_rx_pcap_cb);
+    // the worker runs until the end of the dump in there
+    api->free(uart);
+
+    out->counters = host_counters;
+}
+
+int main(int argc, char** argv) {
+    bool generated = argc < 2;
+
+    if(generated) {
+        generate_dump();
+    } else if(!load_dump(argv[1])) {
+        fprintf(stderr, "can't read %s\n", argv[1]);
+        return 1;
+    }
+
+    printf(
+        "%zu bytes, %.1f s at %d baud%s\n",
+        host_line_length(),
+        host_line_seconds(),
+        UART_BAUD,
+        generated ? " with idle gaps" : "");
+    if(generated) {
+        printf("sent %zu bytes of text and %zu bytes of PCAP\n", sent_text.length, sent_pcap.length);
+    }
+    printf(
+        "%-10s %-4s %9s %9s %10s %9s %9s %8s %5s %5s\n",
+        "latency",
+        "",
+        "wakeups",
+        "text cb",
+        "PCAP wr",
+        "avg B",
+        "SD ms",
+        "dropped",
+        "text",
+        "PCAP");
+
+    uint32_t failures = 0;
+    Output out[2];
+
+    for(size_t l = 0; l < sizeof(latencies_us) / sizeof(latencies_us[0]); l++) {
+        for(int u = 0; u < 2; u++) {
+            replay(&uarts[u], latencies_us[l], &out[u]);
+        }
+
+        for(int u = 0; u < 2; u++) {
+            const Output* o = &out[u];
+            // a dump is checked against what the old worker made of it
+            const Bytes* text = generated ? &sent_text : &out[0].text;
+            const Bytes* pcap = generated ? &sent_pcap : &out[0].pcap;
+            bool text_ok = bytes_equal(&o->text, text);
+            bool pcap_ok = bytes_equal(&o->pcap, pcap);
+            if(generated || u == 1) failures += !text_ok + !pcap_ok;
+
+            char latency[16];
+            snprintf(latency, sizeof(latency), "%u us", latencies_us[l]);
+            printf(
+                "%-10s %-4s %9u %9u %10u %9.1f %9.0f %8zu %5s %5s\n",
+                u == 0 ? latency : "",
+                uarts[u].name,
+                o->counters.wakeups,
+                o->text_calls,
+                o->pcap_calls,
+                o->pcap_calls ? (double)o->pcap.length / o->pcap_calls : 0,
+                o->sd_us / 1000.0,
+                o->counters.dropped,
+                generated || u == 1 ? (text_ok ? "same" : "DIFF") : "-",
+                generated || u == 1 ? (pcap_ok ? "same" : "DIFF") : "-");
+        }
+
+        if(l == 0 && argc > 2) {
+            FILE* f = fopen(argv[2], "wb");
+            if(f) {
+                fwrite(out[1].pcap.data, 1, out[1].pcap.length, f);
+                fclose(f);
+            }
+        }
+
+        for(int u = 0; u < 2; u++) {
+            free(out[u].text.data);
+            free(out[u].pcap.data);
+        }
+    }
+
+    if(failures) {
+        printf("FAILED: %u outputs differ\n", failures);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -7,16 +7,35 @@
     (xtreme_settings.uart_esp_channel == UARTDefault ? FuriHalUartIdUSART1 : FuriHalUartIdLPUART1)
 #define BAUDRATE (115200)
 
+// Received bytes are queued by the ISR in a ring buffer and handed over in chunks
+#define RX_RING_SIZE (4096)
+#define RX_RING_MASK (RX_RING_SIZE - 1)
+// Wake the worker early once this much data is waiting
+#define RX_CHUNK_SIZE (512)
+// The line is treated as idle when nothing arrived for this long
+#define RX_IDLE_MS (5)
+// Pcap data is written to the SD card in blocks of this size
+#define PCAP_BLOCK_SIZE (512)
+
+#define MARK_LEN (11)
+static const char* mark_begin = "[BUF/BEGIN]";
+static const char* mark_close = "[BUF/CLOSE]";
+
 struct WifiMarauderUart {
     WifiMarauderApp* app;
     FuriHalUartId channel;
     FuriThread* rx_thread;
-    FuriStreamBuffer* rx_stream;
-    FuriStreamBuffer* pcap_stream;
+    uint8_t rx_ring[RX_RING_SIZE];
+    volatile size_t rx_head;
+    volatile size_t rx_tail;
+    volatile bool rx_pending;
     bool pcap;
-    uint8_t mark_test_buf[11];
+    uint8_t mark_test_buf[MARK_LEN];
     uint8_t mark_test_idx;
     uint8_t rx_buf[RX_BUF_SIZE + 1];
+    size_t rx_buf_len;
+    uint8_t pcap_buf[PCAP_BLOCK_SIZE];
+    size_t pcap_buf_len;
     void (*handle_rx_data_cb)(uint8_t* buf, size_t len, void* context);
     void (*handle_rx_pcap_cb)(uint8_t* buf, size_t len, void* context);
 };
@@ -24,7 +43,6 @@ struct WifiMarauderUart {
 typedef enum {
     WorkerEvtStop = (1 << 0),
     WorkerEvtRxDone = (1 << 1),
-    WorkerEvtPcapDone = (1 << 2),
 } WorkerEvtFlags;
 
 void wifi_marauder_uart_set_handle_rx_data_cb(
@@ -41,93 +59,186 @@ void wifi_marauder_uart_set_handle_rx_pcap_cb(
     uart->handle_rx_pcap_cb = handle_rx_pcap_cb;
 }
 
-#define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone | WorkerEvtPcapDone)
+#define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone)
 
 void wifi_marauder_uart_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
     WifiMarauderUart* uart = (WifiMarauderUart*)context;
 
     if(ev == UartIrqEventRXNE) {
-        const char* mark_begin = "[BUF/BEGIN]";
-        const char* mark_close = "[BUF/CLOSE]";
+        size_t head = uart->rx_head;
+        size_t used = head - uart->rx_tail;
+        if(used >= RX_RING_SIZE) {
+            // Worker is behind, drop the byte
+            return;
+        }
+        uart->rx_ring[head & RX_RING_MASK] = data;
+        uart->rx_head = head + 1;
+
+        // Only wake the worker at the start of a burst or once a chunk is ready,
+        // the rest is picked up when the line goes idle
+        if(!uart->rx_pending || used + 1 == RX_CHUNK_SIZE) {
+            uart->rx_pending = true;
+            furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
+        }
+    }
+}
+
+static void uart_flush_data(WifiMarauderUart* uart) {
+    if(uart->rx_buf_len > 0) {
+        if(uart->handle_rx_data_cb) {
+            uart->handle_rx_data_cb(uart->rx_buf, uart->rx_buf_len, uart->app);
+        }
+        uart->rx_buf_len = 0;
+    }
+}
+
+static void uart_flush_pcap(WifiMarauderUart* uart) {
+    if(uart->pcap_buf_len > 0) {
+        if(uart->handle_rx_pcap_cb) {
+            uart->handle_rx_pcap_cb(uart->pcap_buf, uart->pcap_buf_len, uart->app);
+        }
+        uart->pcap_buf_len = 0;
+    }
+}
+
+static void uart_push_data(WifiMarauderUart* uart, uint8_t* data, size_t len) {
+    while(len > 0) {
+        // Data callback needs room to null-terminate, keep a copy
+        size_t n = MIN(len, RX_BUF_SIZE - uart->rx_buf_len);
+        memcpy(uart->rx_buf + uart->rx_buf_len, data, n);
+        uart->rx_buf_len += n;
+        if(uart->rx_buf_len == RX_BUF_SIZE) {
+            uart_flush_data(uart);
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+static void uart_push_pcap(WifiMarauderUart* uart, uint8_t* data, size_t len) {
+    while(len > 0) {
+        size_t n;
+        if(uart->pcap_buf_len == 0 && len >= PCAP_BLOCK_SIZE) {
+            // Whole blocks go straight from the ring buffer
+            n = len - (len % PCAP_BLOCK_SIZE);
+            if(uart->handle_rx_pcap_cb) uart->handle_rx_pcap_cb(data, n, uart->app);
+        } else {
+            n = MIN(len, PCAP_BLOCK_SIZE - uart->pcap_buf_len);
+            memcpy(uart->pcap_buf + uart->pcap_buf_len, data, n);
+            uart->pcap_buf_len += n;
+            if(uart->pcap_buf_len == PCAP_BLOCK_SIZE) {
+                uart_flush_pcap(uart);
+            }
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+static void uart_push(WifiMarauderUart* uart, uint8_t* data, size_t len) {
+    if(len == 0) return;
+    if(uart->pcap) {
+        uart_push_pcap(uart, data, len);
+    } else {
+        uart_push_data(uart, data, len);
+    }
+}
+
+static bool uart_mark_continues(WifiMarauderUart* uart, uint8_t data) {
+    uint8_t idx = uart->mark_test_idx;
+    return (data == mark_begin[idx] && !memcmp(uart->mark_test_buf, mark_begin, idx)) ||
+           (data == mark_close[idx] && !memcmp(uart->mark_test_buf, mark_close, idx));
+}
+
+// Splits a chunk into text and pcap payloads, stripping the [BUF/BEGIN] and [BUF/CLOSE]
+// markers. A marker split across chunks is held back in mark_test_buf.
+static void uart_scan(WifiMarauderUart* uart, uint8_t* data, size_t len) {
+    size_t start = 0;
+    for(size_t i = 0; i < len; i++) {
+        uint8_t c = data[i];
         if(uart->mark_test_idx != 0) {
-            // We are trying to match a marker
-            if(data == mark_begin[uart->mark_test_idx] ||
-               data == mark_close[uart->mark_test_idx]) {
+            if(uart_mark_continues(uart, c)) {
                 // Received char matches next char in a marker, append to test buffer
-                uart->mark_test_buf[uart->mark_test_idx++] = data;
-                if(uart->mark_test_idx == sizeof(uart->mark_test_buf)) {
-                    // Test buffer reached max length, parse what marker this is and discard buffer
-                    if(!memcmp(
-                           uart->mark_test_buf, (void*)mark_begin, sizeof(uart->mark_test_buf))) {
-                        uart->pcap = true;
-                    } else if(!memcmp(
-                                  uart->mark_test_buf,
-                                  (void*)mark_close,
-                                  sizeof(uart->mark_test_buf))) {
-                        uart->pcap = false;
+                uart->mark_test_buf[uart->mark_test_idx++] = c;
+                if(uart->mark_test_idx == MARK_LEN) {
+                    // Complete marker, switch the payload type
+                    bool pcap = uart->mark_test_buf[5] == mark_begin[5];
+                    if(uart->pcap && !pcap) {
+                        uart_flush_pcap(uart);
                     }
+                    uart->pcap = pcap;
                     uart->mark_test_idx = 0;
                 }
-                // Don't pass to stream
-                return;
-            } else {
-                // Received char doesn't match any expected next char, send current test buffer
-                if(uart->pcap) {
-                    furi_stream_buffer_send(
-                        uart->pcap_stream, uart->mark_test_buf, uart->mark_test_idx, 0);
-                    furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtPcapDone);
-                } else {
-                    furi_stream_buffer_send(
-                        uart->rx_stream, uart->mark_test_buf, uart->mark_test_idx, 0);
-                    furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
-                }
-                // Reset test buffer and try parsing this char from scratch
-                uart->mark_test_idx = 0;
+                start = i + 1;
+                continue;
             }
+            // Not a marker after all, pass on the held back chars and parse this one from scratch
+            uart_push(uart, uart->mark_test_buf, uart->mark_test_idx);
+            uart->mark_test_idx = 0;
+            start = i;
         }
-        // If we reach here the buffer is empty
-        if(data == mark_begin[0]) {
-            // Received marker start, append to test buffer
-            uart->mark_test_buf[uart->mark_test_idx++] = data;
-        } else {
-            // Not a marker start and we aren't matching a marker, this is just data
-            if(uart->pcap) {
-                furi_stream_buffer_send(uart->pcap_stream, &data, 1, 0);
-                furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtPcapDone);
-            } else {
-                furi_stream_buffer_send(uart->rx_stream, &data, 1, 0);
-                furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
-            }
+        if(c == mark_begin[0]) {
+            // Possible marker start, pass on the data before it
+            uart_push(uart, data + start, i - start);
+            uart->mark_test_buf[uart->mark_test_idx++] = c;
+            start = i + 1;
         }
     }
+    uart_push(uart, data + start, len - start);
+}
+
+static size_t uart_drain(WifiMarauderUart* uart) {
+    size_t head = uart->rx_head;
+    size_t tail = uart->rx_tail;
+    size_t len = head - tail;
+    if(len == 0) return 0;
+
+    size_t offset = tail & RX_RING_MASK;
+    size_t first = MIN(len, RX_RING_SIZE - offset);
+    uart_scan(uart, uart->rx_ring + offset, first);
+    if(len > first) {
+        uart_scan(uart, uart->rx_ring, len - first);
+    }
+    // Release the space only now, pcap blocks were passed on in place
+    uart->rx_tail = head;
+
+    uart_flush_data(uart);
+    return len;
 }
 
 static int32_t uart_worker(void* context) {
     WifiMarauderUart* uart = (void*)context;
+    bool active = false;
 
     while(1) {
-        uint32_t events =
-            furi_thread_flags_wait(WORKER_ALL_RX_EVENTS, FuriFlagWaitAny, FuriWaitForever);
+        uint32_t events = furi_thread_flags_wait(
+            WORKER_ALL_RX_EVENTS,
+            FuriFlagWaitAny,
+            active ? furi_ms_to_ticks(RX_IDLE_MS) : FuriWaitForever);
+        if(events == (uint32_t)FuriFlagErrorTimeout) {
+            events = 0;
+        }
         furi_check((events & FuriFlagError) == 0);
-        if(events & WorkerEvtStop) break;
-        if(events & WorkerEvtRxDone) {
-            size_t len = furi_stream_buffer_receive(uart->rx_stream, uart->rx_buf, RX_BUF_SIZE, 0);
-            if(len > 0) {
-                if(uart->handle_rx_data_cb) uart->handle_rx_data_cb(uart->rx_buf, len, uart->app);
-            }
+        if(events & WorkerEvtStop) {
+            // Pass on everything received so far, including a partial marker held back
+            uart_drain(uart);
+            uart_push(uart, uart->mark_test_buf, uart->mark_test_idx);
+            uart->mark_test_idx = 0;
+            uart_flush_pcap(uart);
+            uart_flush_data(uart);
+            break;
         }
-        if(events & WorkerEvtPcapDone) {
-            size_t len =
-                furi_stream_buffer_receive(uart->pcap_stream, uart->rx_buf, RX_BUF_SIZE, 0);
-            if(len > 0) {
-                if(uart->handle_rx_pcap_cb) uart->handle_rx_pcap_cb(uart->rx_buf, len, uart->app);
-            }
+
+        if(uart_drain(uart) > 0) {
+            active = true;
+        } else if(active) {
+            // Line went idle, pass on the partial pcap block and wait for the next burst
+            uart_flush_pcap(uart);
+            uart->rx_pending = false;
+            active = uart->rx_head != uart->rx_tail;
         }
     }
 
-    furi_stream_buffer_free(uart->rx_stream);
-    furi_stream_buffer_free(uart->pcap_stream);
-
     return 0;
 }
 
@@ -141,8 +252,6 @@ WifiMarauderUart*
 
     uart->app = app;
     uart->channel = channel;
-    uart->rx_stream = furi_stream_buffer_alloc(RX_BUF_SIZE, 1);
-    uart->pcap_stream = furi_stream_buffer_alloc(RX_BUF_SIZE, 1);
     uart->rx_thread = furi_thread_alloc();
     furi_thread_set_name(uart->rx_thread, thread_name);
     furi_thread_set_stack_size(uart->rx_thread, 1024);